@@ -86,6 +86,23 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
 #endif // OB_EEPROM_SUPPORT == 0
 extern int numROMs;                 // Count of DS18B20 devices found
 
+#if DS18B20_INCREMENTAL == 1
+uint8_t DS18B20_step;               // Step of the temperature read in
+                                    // progress, DS_STEP_IDLE if none
+static uint8_t DS18B20_device;      // Device being read
+static uint8_t DS18B20_byte;        // Byte index within the current step
+static uint8_t DS18B20_rom[8];      // ROM code of the device being read
+#endif // DS18B20_INCREMENTAL == 1
+
+#if SENSOR_STRING_CACHE == 1
+char temperature_string[5][2][7];   // IOControl page (method 0) strings
+                                    // for each sensor, [x][0] degrees C
+                                    // and [x][1] degrees F, formatted
+                                    // when the sensors are read
+uint8_t temperature_string_valid;   // 1 if temperature_string[] matches
+                                    // DS18B20_scratch[]
+#endif // SENSOR_STRING_CACHE == 1
+
 
 
 //---------------------------------------------------------------------------//
@@ -116,6 +133,10 @@ void get_temperature()
   // will be ready the next time this function is called. Then the function
   // returns leaving the temperature values in the DS18B20_scratch array.
   //
+  // With DS18B20_SKIP_ROM_CONVERT the conversion is not started per device.
+  // Once all devices are read a single skip_ROM convert_temp starts the
+  // conversion in every device.
+  //
   // Note that the first time the temperature is read from the DS18B20s the
   // value will be indeterminate, but on the next read the value will be
   // correct. When the Network Module powers up it should run this routine
@@ -237,6 +258,7 @@ void get_temperature()
         }
       }
       
+#if DS18B20_SKIP_ROM_CONVERT == 0
       // Start new conversion
       reset_pulse();
       transmit_byte(0x55); // match_ROM command. match_ROM must be followed
@@ -244,9 +266,236 @@ void get_temperature()
       // FoundROM process, starting with bit 0 of byte 0.      
       for (i = 0; i < 8; i++) transmit_byte(FoundROM[device_num][i]);
       transmit_byte(0x44); // convert_temp command
+#endif // DS18B20_SKIP_ROM_CONVERT == 0
+    }
+  }
+
+#if DS18B20_SKIP_ROM_CONVERT == 1
+  // Start a new conversion in all devices at once. After a skip_ROM
+  // command the convert_temp command is performed by every DS18B20 on the
+  // bus, replacing a match_ROM and 8 ROM bytes per device.
+  if (numROMs >= 0) {
+    reset_pulse();
+    transmit_byte(0xcc); // skip_ROM command
+    transmit_byte(0x44); // convert_temp command
+  }
+#endif // DS18B20_SKIP_ROM_CONVERT == 1
+
+#if SENSOR_STRING_CACHE == 1
+  cache_temperature_strings();
+#endif // SENSOR_STRING_CACHE == 1
+}
+
+
+#if DS18B20_INCREMENTAL == 1
+static void slot_transmit_byte(uint8_t transmit_value)
+{
+  // Same as transmit_byte() except that in builds that run with interrupts
+  // enabled they are masked for each bit slot only, instead of for the
+  // whole read.
+  uint8_t j;
+  j = 0x01;
+
+  while ( 1 ) {
+#if INTERRUPTS_ENABLED == 1
+    sim();
+#endif // INTERRUPTS_ENABLED == 1
+    write_bit((uint8_t)(j & transmit_value));
+#if INTERRUPTS_ENABLED == 1
+    rim();
+#endif // INTERRUPTS_ENABLED == 1
+    if (j == 0x80) break;
+    j = (uint8_t)(j << 1);
+  }
+}
+
+
+static uint8_t slot_read_byte(void)
+{
+  // Reads one byte from the 1-Wire bus, bit 0 first, masking interrupts
+  // for each bit slot only in builds that run with interrupts enabled.
+  uint8_t j;
+  uint8_t value;
+  j = 0x01;
+  value = 0;
+
+  while ( 1 ) {
+#if INTERRUPTS_ENABLED == 1
+    sim();
+#endif // INTERRUPTS_ENABLED == 1
+    if (read_bit() == 1) value |= j;
+#if INTERRUPTS_ENABLED == 1
+    rim();
+#endif // INTERRUPTS_ENABLED == 1
+    if (j == 0x80) break;
+    j = (uint8_t)(j << 1);
+  }
+  return value;
+}
+
+
+static int slot_reset_pulse(void)
+{
+  // reset_pulse() with interrupts masked for the reset and presence slot
+  // only in builds that run with interrupts enabled.
+  int rtn;
+#if INTERRUPTS_ENABLED == 1
+  sim();
+#endif // INTERRUPTS_ENABLED == 1
+  rtn = reset_pulse();
+#if INTERRUPTS_ENABLED == 1
+  rim();
+#endif // INTERRUPTS_ENABLED == 1
+  return rtn;
+}
+
+
+void start_temperature(void)
+{
+  // This function starts the same read and convert sequence as
+  // get_temperature(). The sequence is then run by step_temperature() one
+  // step per pass of the main loop.
+  DS18B20_device = 0;
+  DS18B20_step = DS_STEP_READ_RESET;
+}
+
+
+uint8_t step_temperature(void)
+{
+  // This function performs one step of the temperature read started by
+  // start_temperature(). A step is one reset pulse, one command or ROM
+  // byte, or the two temperature bytes of the scratchpad (read together so
+  // a reader of DS18B20_scratch never sees half of a new value). The
+  // longest step is about 1.5ms instead of the tens of milliseconds that
+  // get_temperature() holds the main loop. The DS18B20 does not limit the
+  // time the bus may idle between bit slots, so the sequence can be spread
+  // over as many passes as needed.
+  //
+  // The address sequence sent after each reset pulse is byte 0 match_ROM,
+  // bytes 1 to 8 the ROM code, and byte 9 the function command
+  // (read_scratchpad or convert_temp). With DS18B20_SKIP_ROM_CONVERT the
+  // convert sequence is skip_ROM then convert_temp, sent once after all
+  // devices are read.
+  //
+  // Returns 1 while the read is in progress, 0 when it is complete.
+  uint8_t value;
+
+  switch (DS18B20_step) {
+  case DS_STEP_READ_RESET:
+  case DS_STEP_CONVERT_RESET:
+    if (DS18B20_step == DS_STEP_READ_RESET) {
+      // All found devices have been read
+      if ((int)DS18B20_device > numROMs) {
+#if DS18B20_SKIP_ROM_CONVERT == 0
+        DS18B20_step = DS_STEP_IDLE;
+#endif // DS18B20_SKIP_ROM_CONVERT == 0
+#if DS18B20_SKIP_ROM_CONVERT == 1
+        // Start the conversion in all devices (if any were found)
+        if (DS18B20_device == 0) DS18B20_step = DS_STEP_IDLE;
+        else DS18B20_step = DS_STEP_CONVERT_RESET;
+#endif // DS18B20_SKIP_ROM_CONVERT == 1
+        break;
+      }
+#if OB_EEPROM_SUPPORT == 0
+      memcpy(DS18B20_rom, &FoundROM[DS18B20_device][0], 8);
+#endif // OB_EEPROM_SUPPORT == 0
+#if OB_EEPROM_SUPPORT == 1
+      // The FoundROM table is in I2C EEPROM. Only the entry of the device
+      // being read is copied to RAM.
+      copy_I2C_EEPROM_bytes_to_RAM(DS18B20_rom, 8, I2C_EEPROM_R1_WRITE, I2C_EEPROM_R1_READ, (uint16_t)(I2C_EEPROM_R1_FOUNDROM + (DS18B20_device * 8)), 2);
+#endif // OB_EEPROM_SUPPORT == 1
+      if (slot_reset_pulse()) {
+        // No devices are present
+        DS18B20_step = DS_STEP_IDLE;
+        break;
+      }
+    }
+    else slot_reset_pulse();
+    DS18B20_byte = 0;
+    DS18B20_step++; // DS_STEP_READ_ADDRESS or DS_STEP_CONVERT_ADDRESS
+    break;
+
+  case DS_STEP_READ_ADDRESS:
+#if DS18B20_SKIP_ROM_CONVERT == 0
+  case DS_STEP_CONVERT_ADDRESS:
+#endif // DS18B20_SKIP_ROM_CONVERT == 0
+    if (DS18B20_byte == 0) value = 0x55;                          // match_ROM
+    else if (DS18B20_byte < 9) value = DS18B20_rom[DS18B20_byte - 1];
+    else if (DS18B20_step == DS_STEP_READ_ADDRESS) value = 0xbe;  // read_scratchpad
+    else value = 0x44;                                            // convert_temp
+    slot_transmit_byte(value);
+    DS18B20_byte++;
+    if (DS18B20_byte == 10) {
+      if (DS18B20_step == DS_STEP_READ_ADDRESS) DS18B20_step = DS_STEP_READ_DATA;
+      else {
+        // Conversion started. Go on to the next device.
+        DS18B20_device++;
+        DS18B20_step = DS_STEP_READ_RESET;
+      }
+    }
+    break;
+
+  case DS_STEP_READ_DATA:
+    // Read the first two scratchpad bytes (Temperature LSB and MSB)
+    value = slot_read_byte();
+    DS18B20_scratch[DS18B20_device][1] = slot_read_byte();
+    DS18B20_scratch[DS18B20_device][0] = value;
+#if DS18B20_SKIP_ROM_CONVERT == 0
+    DS18B20_step = DS_STEP_CONVERT_RESET;
+#endif // DS18B20_SKIP_ROM_CONVERT == 0
+#if DS18B20_SKIP_ROM_CONVERT == 1
+    // Go on to the next device. The conversion is started for all devices
+    // once every device is read.
+    DS18B20_device++;
+    DS18B20_step = DS_STEP_READ_RESET;
+#endif // DS18B20_SKIP_ROM_CONVERT == 1
+    break;
+
+#if DS18B20_SKIP_ROM_CONVERT == 1
+  case DS_STEP_CONVERT_ADDRESS:
+    // skip_ROM followed by convert_temp starts the conversion in every
+    // device on the bus
+    if (DS18B20_byte == 0) slot_transmit_byte(0xcc);
+    else {
+      slot_transmit_byte(0x44);
+      DS18B20_step = DS_STEP_IDLE;
     }
+    DS18B20_byte++;
+    break;
+#endif // DS18B20_SKIP_ROM_CONVERT == 1
+  }
+
+  if (DS18B20_step == DS_STEP_IDLE) {
+#if SENSOR_STRING_CACHE == 1
+    cache_temperature_strings();
+#endif // SENSOR_STRING_CACHE == 1
+    return 0;
   }
+  return 1;
 }
+#endif // DS18B20_INCREMENTAL == 1
+
+
+#if SENSOR_STRING_CACHE == 1
+void cache_temperature_strings(void)
+{
+  // Format the IOControl page (method 0) temperature strings of all five
+  // sensors once per read. The web pages and MQTT publishes then copy the
+  // cached string instead of repeating the C to F arithmetic and emb_itoa
+  // conversion for every sensor on every page refresh and publish.
+  uint8_t i;
+  uint8_t degCorF;
+
+  temperature_string_valid = 0;
+  for (i = 0; i < 5; i++) {
+    for (degCorF = 0; degCorF < 2; degCorF++) {
+      convert_temperature(i, degCorF, 0);
+      strcpy(temperature_string[i][degCorF], OctetArray);
+    }
+  }
+  temperature_string_valid = 1;
+}
+#endif // SENSOR_STRING_CACHE == 1
 
 
 
@@ -273,6 +522,14 @@ void convert_temperature(uint8_t device_num, uint8_t degCorF, uint8_t method)
   uint8_t decimal_temp;
   uint8_t sign_char;
   
+#if SENSOR_STRING_CACHE == 1
+  if (method == 0 && temperature_string_valid) {
+    // Use the string formatted when the sensors were last read
+    strcpy(OctetArray, temperature_string[device_num][degCorF]);
+    return;
+  }
+#endif // SENSOR_STRING_CACHE == 1
+
   // Convert temperature reading to string.
   // DS18B20_temp_xx is a 16 bit signed value. Bits are organized as
   // follows:
@@ -513,12 +770,62 @@ void convert_temperature(uint8_t device_num, uint8_t degCorF, uint8_t method)
 //   PC_IDR
 
 
+#if DS18B20_TIMED_SLOTS == 1
+static void slot_start(void)
+{
+  // Restart TIM3 (1us per count, see timer_init()) at the start of a 1-Wire
+  // slot. Every edge of the slot is placed with slot_wait() relative to this
+  // point, so the time spent in the code between the edges does not add to
+  // the slot timing.
+  TIM3_CR1 &= (uint8_t)(~0x01);		// Disable counter
+  TIM3_CNTRH = (uint8_t)0x00;		// Clear counter High
+  TIM3_CNTRL = (uint8_t)0x00;		// Clear counter Low
+  TIM3_CR1 |= (uint8_t)0x01;		// Enable counter
+}
+
+
+static void slot_wait(uint16_t slot_time)
+{
+  // Wait until slot_time us have passed since slot_start()
+  uint16_t counter;
+
+  do {
+    // Read the counter. Must assure that the MSByte is read first followed by
+    // the LSByte.
+    counter = (uint16_t)(TIM3_CNTRH << 8);
+    nop(); // nop placed here to make sure the compiler doesn't optimize the
+           // read sequence.
+    counter = counter | TIM3_CNTRL;
+  } while(counter < slot_time);
+}
+#endif // DS18B20_TIMED_SLOTS == 1
+
+
 int reset_pulse()
 {
   // Generates a master reset pulse on the specified IO
   // The pulse must be a minimum of 480us
   int rtn;
   
+#if DS18B20_TIMED_SLOTS == 1
+  // Drive low for 500us, sample the presence pulse 70us after release (the
+  // DS18B20 drives it from 15-60us to 60-240us after release), then wait
+  // out the 480us presence time.
+  slot_start();
+  one_wire_low(0);          // Drive one-wire low
+  slot_wait(500);
+  PC_DDR &= (uint8_t)~0x40; // write IO DDR to input (float high)
+  slot_wait(570);
+  
+  // Check for "presence" state on the 1-wire. 0 = device(s) present.
+  rtn = 0;
+  if (PC_IDR & 0x40) rtn = 1; // If IO pin is high there is no device
+
+  slot_wait(980);
+  return rtn; // rtn = 0 if device is present
+#endif // DS18B20_TIMED_SLOTS == 1
+
+#if DS18B20_TIMED_SLOTS == 0
   one_wire_low(100);        // Drive one-wire low, wait 50 us
   wait_timer(450);          // wait additional 450 us
   PC_DDR &= (uint8_t)~0x40; // write IO DDR to input (float high)
@@ -530,6 +837,7 @@ int reset_pulse()
 
   wait_timer(200);          // wait 200us
   return rtn; // rtn = 0 if device is present
+#endif // DS18B20_TIMED_SLOTS == 0
 }
 
 
@@ -572,11 +880,26 @@ int read_bit()
   // shows the pullup working in about 1/2us with a 12 inch wire lead. Longer
   // leads to the DS18B20 may result in a slower rise time.
   // After reading a bit code must wait 60us before reading the next bit.
+#if DS18B20_TIMED_SLOTS == 0
   int nop_cnt;
+#endif // DS18B20_TIMED_SLOTS == 0
   int bit;
 
   bit = 0;
 
+#if DS18B20_TIMED_SLOTS == 1
+  // Drive low for 2us, sample at 13us, end the slot at 70us (60us minimum
+  // slot plus recovery time).
+  slot_start();
+  one_wire_low(0);           // drive one-wire low
+  slot_wait(2);
+  PC_DDR &= (uint8_t)~0x40;  // write IO DDR to input (float high)
+  slot_wait(13);
+  if (PC_IDR & 0x40) bit = 1;
+  slot_wait(70);
+#endif // DS18B20_TIMED_SLOTS == 1
+
+#if DS18B20_TIMED_SLOTS == 0
   one_wire_low(4);           // drive one-wire low, wait 2us
   PC_DDR &= (uint8_t)~0x40;  // write IO DDR to input (float high)
   for (nop_cnt=0; nop_cnt<30; nop_cnt++) nop(); // Wait 15us
@@ -584,6 +907,7 @@ int read_bit()
   
   wait_timer(60); // This timer is not critical - but code must wait at
                   // least 60 us
+#endif // DS18B20_TIMED_SLOTS == 0
   return bit;
 }
 
@@ -601,6 +925,17 @@ void write_bit(uint8_t transmit_bit)
   //   of 15us before returning to the calling routine. To reduce code size it
   //   will wait 60us.
   
+#if DS18B20_TIMED_SLOTS == 1
+  // Drive low for 6us (1 bit) or 65us (0 bit), end the slot at 70us.
+  slot_start();
+  one_wire_low(0);             // drive one wire low
+  if (transmit_bit) slot_wait(6);
+  else slot_wait(65);
+  PC_DDR &= (uint8_t)~0x40;    // write IO DDR to input (float high)
+  slot_wait(70);
+#endif // DS18B20_TIMED_SLOTS == 1
+
+#if DS18B20_TIMED_SLOTS == 0
   one_wire_low(10);            // drive one wire low, wait 5us
   if (!(transmit_bit)) wait_timer(60); // If sending a 0 provide additional
                                        // 60us low time
@@ -608,6 +943,7 @@ void write_bit(uint8_t transmit_bit)
   
   wait_timer(60); // Wait 60us before returning. This is needed to provide a
                   // pause brfore sending the next bit.
+#endif // DS18B20_TIMED_SLOTS == 0
 }
 
 
@@ -628,6 +964,9 @@ void init_DS18B20(void)
 {
   // Initialize temperature sensor arrays
   memset(&DS18B20_scratch[0][0], 0, 10);
+#if DS18B20_INCREMENTAL == 1
+  DS18B20_step = DS_STEP_IDLE;
+#endif // DS18B20_INCREMENTAL == 1
 
 #if OB_EEPROM_SUPPORT == 0
   // If I2C EEPROM is not supported then the global FoundROM RAM array must
@@ -646,6 +985,9 @@ void init_DS18B20(void)
 #endif // OB_EEPROM_SUPPORT == 1
 
   numROMs = -1; // -1 indicates no devices. FindDevices will update this value.
+#if SENSOR_STRING_CACHE == 1
+  temperature_string_valid = 0;
+#endif // SENSOR_STRING_CACHE == 1
 }
 
 
@@ -22,8 +22,20 @@
 #ifndef __DS18B20_H__
 #define __DS18B20_H__
 
+// Steps of the incremental temperature read (see step_temperature()).
+// Each ADDRESS step must directly follow its RESET step.
+#define DS_STEP_IDLE		0
+#define DS_STEP_READ_RESET	1
+#define DS_STEP_READ_ADDRESS	2
+#define DS_STEP_READ_DATA	3
+#define DS_STEP_CONVERT_RESET	4
+#define DS_STEP_CONVERT_ADDRESS	5
+
 void get_temperature(void);
+void start_temperature(void);
+uint8_t step_temperature(void);
 void convert_temperature(uint8_t device_num, uint8_t degCorF, uint8_t method);
+void cache_temperature_strings(void);
 int reset_pulse(void);
 uint8_t check_CRC(void);
 void transmit_byte(uint8_t transmit_value);
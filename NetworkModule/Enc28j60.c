@@ -50,6 +50,9 @@
 extern uint8_t debug_bytes[10];
 
 extern uint32_t TRANSMIT_counter;      // Counts any transmit
+#if STACK_MONITOR == 1
+extern uint16_t uip_buf_peak;          // Largest frame held in the uip_buf
+#endif // STACK_MONITOR == 1
 extern uint8_t stored_config_settings; // Config settings stored in EEPROM
 extern uint8_t OctetArray[14];         // Used in emb_itoa conversions and to
                                        // transfer short strings globally
@@ -80,10 +83,14 @@ extern uint8_t OctetArray[14];         // Used in emb_itoa conversions and to
 
 // Registers in BankX: (means: available in each bank)
 #define BANKX_EIE			0x1B
+#define BANKX_EIE_RXERIE		0
+#define BANKX_EIE_PKTIE			6
+#define BANKX_EIE_INTIE			7
 #define BANKX_EIR			0x1C
 #define BANKX_EIR_RXERIF		0
 #define BANKX_EIR_TXERIF		1
 #define BANKX_EIR_TXIF			3
+#define BANKX_EIR_LINKIF		4
 #define BANKX_ESTAT			0x1D
 #define BANKX_ESTAT_CLKRDY		0
 #define BANKX_ESTAT_TXABRT		1
@@ -229,7 +236,10 @@ extern uint8_t OctetArray[14];         // Used in emb_itoa conversions and to
 #define PHY_PHCON2_TXDIS		13
 #define PHY_PHCON2_FRCLINK		14
 #define PHY_PHSTAT2			0x11
+#define PHY_PHSTAT2_LSTAT		10
 #define PHY_PHIE			0x12
+#define PHY_PHIE_PGEIE			1
+#define PHY_PHIE_PLNKIE			4
 #define PHY_PHIR			0x13
 #define PHY_PHLCON			0x14
 #define PHY_PHLCON_STRCH		1
@@ -252,9 +262,80 @@ extern uint8_t OctetArray[14];         // Used in emb_itoa conversions and to
 // MAC address ordered as defined in UIP modules ([0] is LSB, [5] is MSB)
 extern uint8_t stored_uip_ethaddr_oct[6];
 
+#if ENC28J60_HEADER_PEEK == 1
+// Number of bytes at the start of a received frame needed to decide if the
+// frame is of any interest: Ethernet header, IPv4 header (no options) and
+// the TCP or UDP source and destination ports.
+#define ENC28J60_PEEKLEN		(UIP_LLH_LEN + 24)
+
+extern uint16_t uip_listenports[UIP_LISTENPORTS];
+#if UDP_STATUS_SUPPORT == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+extern uint16_t Port_Httpd;            // UDP status service port
+#endif // UDP_STATUS_SUPPORT == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+#endif // ENC28J60_HEADER_PEEK == 1
+
+#if ENC28J60_RX_FILTER == 1
+// IP address ordered as stored in EEPROM ([0] is LSB, [3] is MSB)
+extern uint8_t stored_hostaddr[4];
+#endif // ENC28J60_RX_FILTER == 1
+
+#if HTTPD_PAGE_CACHE == 1
+// Last byte of the receive buffer. The page cache area and the park area
+// are above it.
+#define RX_BUFFER_END		(ENC28J60_CACHESTART - 1)
+#endif // HTTPD_PAGE_CACHE == 1
+#if HTTPD_PAGE_CACHE == 0 && ARP_MISS_QUEUE == 1
+// Last byte of the receive buffer. The area above it is the park area.
+#define RX_BUFFER_END		(ENC28J60_PARKSTART - 1)
+#endif // HTTPD_PAGE_CACHE == 0 && ARP_MISS_QUEUE == 1
+#if HTTPD_PAGE_CACHE == 0 && ARP_MISS_QUEUE == 0
+#define RX_BUFFER_END		ENC28J60_RXEND
+#endif // HTTPD_PAGE_CACHE == 0 && ARP_MISS_QUEUE == 0
+
 // Transmit Status Vector storage
 // uint8_t tsv_byte[7];
 
+#if ENC28J60_ASYNC_TX == 1
+// Set when Enc28j60Send() has started a transmission that has not yet been
+// completed by Enc28j60FinishSend()
+uint8_t tx_pending;
+#endif // ENC28J60_ASYNC_TX == 1
+
+#if ENC28J60_TX_DOUBLE_BUFFER == 1
+#if ENC28J60_ASYNC_TX == 0
+  #error "ENC28J60_TX_DOUBLE_BUFFER requires ENC28J60_ASYNC_TX"
+#endif // ENC28J60_ASYNC_TX == 0
+// Transmit slot used by the last frame: 0 = ENC28J60_TXSTART,
+// 1 = ENC28J60_TXSTART2
+uint8_t tx_slot;
+#endif // ENC28J60_TX_DOUBLE_BUFFER == 1
+
+#if ENC28J60_INT_RECEIVE == 1
+#if HW_SPI_SUPPORT == 1
+  #error "ENC28J60_INT_RECEIVE uses Port C Bit 5 and cannot be combined with HW_SPI_SUPPORT"
+#endif // HW_SPI_SUPPORT == 1
+// Count of receive checks skipped because -INT was high. When it rolls over
+// the ENC28J60 registers are read anyway.
+uint8_t rx_idle_count;
+#endif // ENC28J60_INT_RECEIVE == 1
+
+#if HTTPD_TX_WRITE_THROUGH == 1
+#if ENC28J60_DMA_CHECKSUM == 0
+  #error "HTTPD_TX_WRITE_THROUGH requires ENC28J60_DMA_CHECKSUM"
+#endif // ENC28J60_DMA_CHECKSUM == 0
+// Number of TCP data bytes written to the transmit buffer by
+// Enc28j60TxDataWrite() for the next frame
+uint16_t tx_data_bytes;
+// Transmit buffer address of the first TCP data byte of the next frame
+uint16_t tx_data_start;
+#endif // HTTPD_TX_WRITE_THROUGH == 1
+
+#if HTTPD_PAGE_CACHE == 1
+#if HTTPD_TX_WRITE_THROUGH == 0
+  #error "HTTPD_PAGE_CACHE requires HTTPD_TX_WRITE_THROUGH"
+#endif // HTTPD_TX_WRITE_THROUGH == 0
+#endif // HTTPD_PAGE_CACHE == 1
+
 
 void select(void)
 {
@@ -405,7 +486,12 @@ void Enc28j60Init(void)
   // hardware start-up time of 300us may expire before the device is ready
   // to operate. Work around: After issuing the Reset command, wait at
   // least 1 ms in firmware for the device to be ready.
+#if FAST_BOOT == 0
   wait_timer((uint16_t)10000); // delay 10 ms
+#endif // FAST_BOOT == 0
+#if FAST_BOOT == 1
+  wait_timer((uint16_t)2000); // delay 2 ms
+#endif // FAST_BOOT == 1
 
   // Reset ENC28J60 PHY
   Enc28j60WritePhy(PHY_PHCON1, (uint16_t)(1<<PHY_PHCON1_PRST)); // Reset command
@@ -428,15 +514,15 @@ void Enc28j60Init(void)
   // Errata: See .h file for errata applied
   Enc28j60WriteReg(BANK0_ERXSTL, (uint8_t) (ENC28J60_RXSTART >> 0));
   Enc28j60WriteReg(BANK0_ERXSTH, (uint8_t) (ENC28J60_RXSTART >> 8));
-  Enc28j60WriteReg(BANK0_ERXNDL, (uint8_t) (ENC28J60_RXEND >> 0));
-  Enc28j60WriteReg(BANK0_ERXNDH, (uint8_t) (ENC28J60_RXEND >> 8));
+  Enc28j60WriteReg(BANK0_ERXNDL, (uint8_t) (RX_BUFFER_END >> 0));
+  Enc28j60WriteReg(BANK0_ERXNDH, (uint8_t) (RX_BUFFER_END >> 8));
   // Receiver Pointer
   Enc28j60WriteReg(BANK0_ERDPTL, (uint8_t) (ENC28J60_RXSTART >> 0));
   Enc28j60WriteReg(BANK0_ERDPTH, (uint8_t) (ENC28J60_RXSTART >> 8));
   // Errata Workaround: ERXRDPT should not be programmed with an even address
   // so code chooses RXSTART-1 which is equal to RXEND 
-  Enc28j60WriteReg(BANK0_ERXRDPTL, (uint8_t) (ENC28J60_RXEND >> 0));
-  Enc28j60WriteReg(BANK0_ERXRDPTH, (uint8_t) (ENC28J60_RXEND >> 8));
+  Enc28j60WriteReg(BANK0_ERXRDPTL, (uint8_t) (RX_BUFFER_END >> 0));
+  Enc28j60WriteReg(BANK0_ERXRDPTH, (uint8_t) (RX_BUFFER_END >> 8));
   // and Transmit Pointer
   Enc28j60WriteReg(BANK0_ETXSTL, (uint8_t) (ENC28J60_TXSTART >> 0));
   Enc28j60WriteReg(BANK0_ETXSTH, (uint8_t) (ENC28J60_TXSTART >> 8));
@@ -491,6 +577,12 @@ void Enc28j60Init(void)
   //           FF-FF-FF-FF-FF-FF will be accepted
   //       0 = Filter disabled
   //
+#if ENC28J60_RX_FILTER == 1
+  // With ENC28J60_RX_FILTER the broadcast filter is replaced by the pattern
+  // match filter so that only ARP broadcasts for our IP address are
+  // accepted. See Enc28j60SetFilter().
+  Enc28j60SetFilter();
+#else // ENC28J60_RX_FILTER == 0
   Enc28j60WriteReg(BANK1_ERXFCON, (uint8_t)0xa1);    // Allows packets if MAC matches
 						     // CRC check ON
 						     // FF-FF Packets accepted
@@ -506,6 +598,7 @@ void Enc28j60Init(void)
   // Enc28j60WriteReg(BANK1_ERXFCON, (uint8_t)0x00);    // Allows packets even if MAC doesn't match
 						     // CRC check OFF
 						     // FF-FF Packets rejected
+#endif // ENC28J60_RX_FILTER == 1
 
 
   //---------------------------------------------------------------------------//
@@ -551,8 +644,15 @@ void Enc28j60Init(void)
 
   // Set the maximum frame-length to prevent host-controller from buffer overflows
   // frame-length + CRC (CRC will not occupy any host buffer-space)
+#if HTTPD_TX_WRITE_THROUGH == 1
+  // Transmitted frames can be as large as a transmit slot. Received frames
+  // larger than ENC28J60_MAXFRAME are still discarded by Enc28j60Receive().
+  Enc28j60WriteReg(BANK2_MAMXFLL, (uint8_t) ((ENC28J60_TX_MAXFRAME + 4) >> 0));
+  Enc28j60WriteReg(BANK2_MAMXFLH, (uint8_t) ((ENC28J60_TX_MAXFRAME + 4) >> 8));
+#else // HTTPD_TX_WRITE_THROUGH == 0
   Enc28j60WriteReg(BANK2_MAMXFLL, (uint8_t) ((ENC28J60_MAXFRAME + 4) >> 0));
   Enc28j60WriteReg(BANK2_MAMXFLH, (uint8_t) ((ENC28J60_MAXFRAME + 4) >> 8));
+#endif // HTTPD_TX_WRITE_THROUGH == 1
 
   // Non-back to back-Inter-Packet-Delay-Gap. (datasheet recommendation)
   Enc28j60WriteReg(BANK2_MAIPGL, 0x12);
@@ -604,6 +704,14 @@ void Enc28j60Init(void)
     // is ncleared anyway.
     Enc28j60WritePhy(PHY_PHCON1, 0x0000);
   }
+
+#if PHY_LINK_MONITOR == 1
+  // Let the PHY set LINKIF in EIR on every link change. LINKIE is not set in
+  // EIE so -INT is not driven by link changes. Reading PHIR clears any
+  // change latched before now.
+  Enc28j60WritePhy(PHY_PHIE, (uint16_t)((1<<PHY_PHIE_PGEIE)|(1<<PHY_PHIE_PLNKIE)));
+  Enc28j60ReadPhy(PHY_PHIR);
+#endif // PHY_LINK_MONITOR == 1
   
   // Read the ENC28J60 revision level and store for output to the UART and
   // EEPROM. Note: debug[2] also contains the stack overflow bit in the most
@@ -621,16 +729,125 @@ void Enc28j60Init(void)
   debug_bytes[2] = (uint8_t)(debug_bytes[2] | ((Enc28j60ReadReg(BANK3_EREVID)) & 0x07));
   update_debug_storage1(); // Only write the EEPROM if the byte changed.
 
+#if ENC28J60_ASYNC_TX == 1
+  tx_pending = 0;
+#endif // ENC28J60_ASYNC_TX == 1
+#if ENC28J60_TX_DOUBLE_BUFFER == 1
+  tx_slot = 0;
+#endif // ENC28J60_TX_DOUBLE_BUFFER == 1
+#if HTTPD_TX_WRITE_THROUGH == 1
+  tx_data_bytes = 0;
+#endif // HTTPD_TX_WRITE_THROUGH == 1
+
+#if ENC28J60_INT_RECEIVE == 1
+  // Drive -INT low while a received frame is waiting or on a receive buffer
+  // overflow. No other interrupt sources are enabled.
+  Enc28j60WriteReg(BANKX_EIE, (uint8_t)((1<<BANKX_EIE_INTIE)|(1<<BANKX_EIE_PKTIE)|(1<<BANKX_EIE_RXERIE)));
+  rx_idle_count = 0;
+#endif // ENC28J60_INT_RECEIVE == 1
+
   // Enable Packet Reception
   Enc28j60SetMaskReg(BANKX_ECON1, (1<<BANKX_ECON1_RXEN));
 }
 
 
+#if PHY_LINK_MONITOR == 1
+uint8_t Enc28j60LinkCheck(void)
+{
+  // Returns ENC28J60_LINK_NONE if the link has not changed since the last
+  // call, otherwise the current link state. LINKIF stays set until PHIR is
+  // read, so a link change between calls is never missed. Costs one SPI
+  // register read when there is no change.
+  if ((Enc28j60ReadReg(BANKX_EIR) & (1<<BANKX_EIR_LINKIF)) == 0) {
+    return ENC28J60_LINK_NONE;
+  }
+  // Reading PHIR clears PLNKIF and with it LINKIF
+  Enc28j60ReadPhy(PHY_PHIR);
+  if (Enc28j60ReadPhy(PHY_PHSTAT2) & (uint16_t)(1<<PHY_PHSTAT2_LSTAT)) {
+    return ENC28J60_LINK_UP;
+  }
+  return ENC28J60_LINK_DOWN;
+}
+#endif // PHY_LINK_MONITOR == 1
+
+
+#if ENC28J60_RX_FILTER == 1
+void Enc28j60SetFilter(void)
+{
+  // Program the ENC28J60 receive filters so that the only frames copied into
+  // the receive buffer are:
+  //   Unicast frames addressed to our MAC (Unicast filter)
+  //   ARP broadcasts asking for our IP address (Pattern Match filter)
+  // All other broadcast and all multicast frames are discarded by the
+  // ENC28J60 and never cross the SPI bus. The uip code has no use for them
+  // anyway since it only handles TCP and ARP.
+  //
+  // The Pattern Match filter computes an IP style checksum over up to 64
+  // selected bytes of the frame (starting at EPMO) and accepts the frame if
+  // the checksum equals EPMCS. The selected bytes are:
+  //   Bytes 0-5   Destination MAC     FF-FF-FF-FF-FF-FF
+  //   Bytes 12-13 Ethertype           08-06 (ARP)
+  //   Bytes 38-41 ARP Target IP       our IP address
+  // This is called from Enc28j60Init() and again from restart() as the IP
+  // address may have been changed by the user.
+  //
+  // ERXFCON = 0xb0 0b10110000
+  //   UCEN = 1  Packets with a destination address matching our MAC are
+  //             accepted
+  //   ANDOR = 0 OR: Packets are accepted unless all enabled filters reject
+  //   CRCEN = 1 Packets with an invalid CRC are discarded
+  //   PMEN = 1  Packets meeting the Pattern Match criteria are accepted
+  //   BCEN = 0  Broadcast filter disabled (the Pattern Match filter handles
+  //             the only broadcasts we care about)
+  //
+  // The filters should not be changed while a packet is being received, so
+  // reception is paused during the update if it was enabled.
+  uint32_t sum;
+  uint8_t rxen;
+
+  rxen = (uint8_t)(Enc28j60ReadReg(BANKX_ECON1) & (1<<BANKX_ECON1_RXEN));
+  if (rxen) Enc28j60ClearMaskReg(BANKX_ECON1, (1<<BANKX_ECON1_RXEN));
+
+  sum = (uint32_t)0xffff + 0xffff + 0xffff + 0x0806
+      + (uint16_t)(((uint16_t)stored_hostaddr[3] << 8) | stored_hostaddr[2])
+      + (uint16_t)(((uint16_t)stored_hostaddr[1] << 8) | stored_hostaddr[0]);
+  // Fold the carries back in and complement
+  sum = (sum & 0xffff) + (sum >> 16);
+  sum = (sum & 0xffff) + (sum >> 16);
+  sum = ~sum;
+
+  Enc28j60SwitchBank(BANK1);
+  Enc28j60WriteReg(BANK1_EPMOL, (uint8_t)0x00);
+  Enc28j60WriteReg(BANK1_EPMOH, (uint8_t)0x00);
+  Enc28j60WriteReg(BANK1_EPMM0, (uint8_t)0x3f);   // Bytes 0-5
+  Enc28j60WriteReg(BANK1_EPMM1, (uint8_t)0x30);   // Bytes 12-13
+  Enc28j60WriteReg(BANK1_EPMM2, (uint8_t)0x00);
+  Enc28j60WriteReg(BANK1_EPMM3, (uint8_t)0x00);
+  Enc28j60WriteReg(BANK1_EPMM4, (uint8_t)0xc0);   // Bytes 38-39
+  Enc28j60WriteReg(BANK1_EPMM5, (uint8_t)0x03);   // Bytes 40-41
+  Enc28j60WriteReg(BANK1_EPMM6, (uint8_t)0x00);
+  Enc28j60WriteReg(BANK1_EPMM7, (uint8_t)0x00);
+  Enc28j60WriteReg(BANK1_EPMCSL, (uint8_t)(sum >> 0));
+  Enc28j60WriteReg(BANK1_EPMCSH, (uint8_t)(sum >> 8));
+  Enc28j60WriteReg(BANK1_ERXFCON, (uint8_t)0xb0);
+
+  if (rxen) Enc28j60SetMaskReg(BANKX_ECON1, (1<<BANKX_ECON1_RXEN));
+}
+#endif // ENC28J60_RX_FILTER == 1
+
+
 uint16_t Enc28j60Receive(uint8_t* pBuffer)
 {
   uint16_t nBytes;
   uint16_t nNextPacket;
 
+#if ENC28J60_INT_RECEIVE == 1
+  // -INT (PC5) high means no frame is waiting and no overflow occurred, so
+  // skip the SPI register reads. Every 256th idle call falls through to the
+  // register reads in case PKTIF failed to assert -INT (ENC28J60 errata).
+  if ((PC_IDR & 0x20) && ++rx_idle_count) return 0;
+#endif // ENC28J60_INT_RECEIVE == 1
+
   // Check for buffer overflow - RXERIF (bit 0) of EIR register
   // If overflow increment the error counter
   if (Enc28j60ReadReg(BANKX_EIR) & 0x01) {
@@ -639,10 +856,11 @@ uint16_t Enc28j60Receive(uint8_t* pBuffer)
 // UARTPrintf("Enc28j60Receive OVERFLOW detected\r\n");
 #endif // DEBUG_SUPPORT == 15
 
-    // Increment the RXERIF counter
+    // Increment the RXERIF counter. The counter is written to EEPROM once
+    // a minute by the main loop. Writing it here would stall the recovery
+    // from the overflow for the EEPROM programming time.
     debug_bytes[4]++;
-    // Store result in EEPROM for display
-    update_debug_storage1();
+    UDP_LOG(UDP_LOG_RXERIF, debug_bytes[4]);
     
     // Clear RXERIF in the ENC28J60
     Enc28j60ClearMaskReg(BANKX_EIR, (1<<BANKX_EIR_RXERIF));
@@ -674,15 +892,31 @@ uint16_t Enc28j60Receive(uint8_t* pBuffer)
   // Frame-Data
   //   Comment: MAXFRAME is set larger than the MSS value communicated to any
   //   host or client that is connected. For this reason code knows it can
-  //   throw away any packet that exceeds MAXFRAME.
+  //   throw away any packet that exceeds MAXFRAME. A discarded frame is
+  //   reported to the caller as a zero length receive.
   //
   if (nBytes <= ENC28J60_MAXFRAME) {
+#if ENC28J60_HEADER_PEEK == 1
+    // Read only the headers first. If the frame is of no interest to uip
+    // the rest of the frame is skipped over in the ENC28J60 buffer by the
+    // read pointer update below without ever being read over SPI.
+    if (nBytes > ENC28J60_PEEKLEN) {
+      SpiReadChunk(pBuffer, ENC28J60_PEEKLEN);
+      if (Enc28j60FrameWanted(pBuffer)) {
+        SpiReadChunk(pBuffer + ENC28J60_PEEKLEN, (uint16_t)(nBytes - ENC28J60_PEEKLEN));
+      }
+      else nBytes = 0;
+    }
+    else SpiReadChunk(pBuffer, nBytes);
+#else // ENC28J60_HEADER_PEEK == 0
     SpiReadChunk(pBuffer, nBytes);
+#endif // ENC28J60_HEADER_PEEK == 1
   }
   else {
 #if DEBUG_SUPPORT == 15
 // UARTPrintf("Enc28j60Receive MAXFRAME exceeded\r\n");
 #endif // || DEBUG_SUPPORT == 15
+    nBytes = 0;
   }
 
   deselect();
@@ -699,7 +933,7 @@ uint16_t Enc28j60Receive(uint8_t* pBuffer)
   if (nNextPacket == ( ((uint16_t)ENC28J60_RXSTART) - 1 )) {
     // Underflow occured while subtracting 1? Use RXEND then. The ENC28J60 logic will
     // set the pointer to the next even address, which is RXSTART.
-    nNextPacket = ENC28J60_RXEND;
+    nNextPacket = RX_BUFFER_END;
   }
 
   Enc28j60WriteReg(BANK0_ERXRDPTL, (uint8_t)(nNextPacket >> 0));
@@ -721,12 +955,231 @@ uint16_t Enc28j60Receive(uint8_t* pBuffer)
 }
 
 
+#if ENC28J60_HEADER_PEEK == 1
+uint8_t Enc28j60FrameWanted(uint8_t* pBuffer)
+{
+  // Examine the first ENC28J60_PEEKLEN bytes of a received frame and decide
+  // if the rest of the frame needs to be read. The checks mirror the drop
+  // decisions that uip_input() would otherwise make after the whole frame
+  // was read over SPI. Returns 1 if the frame should be read, 0 if it can be
+  // discarded.
+  //   ARP frames are always wanted (uip_arp_arpin() sorts them out).
+  //   IP frames are wanted if they are IPv4 with no options addressed to our
+  //   IP address, and are either ICMP (ping), or TCP to a port we listen on
+  //   or to the local port of an open connection.
+  //   With UDP_STATUS_SUPPORT UDP datagrams to the HTTP Port number are also
+  //   wanted (the UDP ports sit at the same offset as the TCP ports).
+  //   Everything else is discarded.
+  // Note: A TCP SYN to a port that is not listened on is discarded without a
+  // RST being sent in reply. The sender will simply time out.
+  struct uip_tcpip_hdr *hdr;
+  uint8_t i;
+
+  hdr = (struct uip_tcpip_hdr *)&pBuffer[UIP_LLH_LEN];
+
+  // Removed "htons" code to reduce Flash usage. This can be done as the
+  // SMT8 is "Big Endian".
+  if (((struct uip_eth_hdr *)pBuffer)->type == UIP_ETHTYPE_ARP) return 1;
+  if (((struct uip_eth_hdr *)pBuffer)->type != UIP_ETHTYPE_IP) return 0;
+
+  if (hdr->vhl != 0x45) return 0;
+  if (!uip_ipaddr_cmp(hdr->destipaddr, uip_hostaddr)) return 0;
+  if (hdr->proto == UIP_PROTO_ICMP) return 1;
+#if UDP_STATUS_SUPPORT == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+  if (hdr->proto == UIP_PROTO_UDP) return (uint8_t)(hdr->destport == Port_Httpd);
+#endif // UDP_STATUS_SUPPORT == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+  if (hdr->proto != UIP_PROTO_TCP) return 0;
+
+  for (i = 0; i < UIP_LISTENPORTS; i++) {
+    if (uip_listenports[i] != 0 && hdr->destport == uip_listenports[i]) return 1;
+  }
+  for (i = 0; i < UIP_CONNS; i++) {
+    if (uip_conns[i].tcpstateflags != UIP_CLOSED
+     && hdr->destport == uip_conns[i].lport) return 1;
+  }
+  return 0;
+}
+#endif // ENC28J60_HEADER_PEEK == 1
+
+
+#if ENC28J60_ASYNC_TX == 1
+void Enc28j60PollSend(void)
+{
+  // Called from the main loop. If the last frame started by Enc28j60Send()
+  // has finished transmission (successfully or with an error) complete its
+  // handling now, so that the next Enc28j60Send() does not have to wait.
+  if (tx_pending) {
+    if (Enc28j60ReadReg(BANKX_EIR) & ((1<<BANKX_EIR_TXIF) | (1<<BANKX_EIR_TXERIF))) {
+      Enc28j60FinishSend();
+    }
+  }
+}
+#endif // ENC28J60_ASYNC_TX == 1
+
+
+#if HTTPD_TX_WRITE_THROUGH == 1
+void Enc28j60TxDataStart(void)
+{
+  // Called by the httpd before it generates the TCP data of a segment.
+  // Points the ENC28J60 write pointer at the location the TCP data will
+  // occupy in the frame the next Enc28j60Send() will transmit. The data is
+  // then written there with Enc28j60TxDataWrite(), and Enc28j60Send() only
+  // copies the headers from the uip_buf.
+  uint16_t TxData;
+
+#if ENC28J60_TX_DOUBLE_BUFFER == 1
+  // Enc28j60Send() will use the slot not used by the last frame
+  if (tx_slot) TxData = ENC28J60_TXSTART;
+  else TxData = ENC28J60_TXSTART2;
+#else // ENC28J60_TX_DOUBLE_BUFFER == 0
+#if ENC28J60_ASYNC_TX == 1
+  // The transmit buffer is still in use by the last frame if it has not
+  // been completed yet. Complete it before the buffer is over-written.
+  if (tx_pending) Enc28j60FinishSend();
+#endif // ENC28J60_ASYNC_TX == 1
+  TxData = ENC28J60_TXSTART;
+#endif // ENC28J60_TX_DOUBLE_BUFFER == 1
+
+  // Skip the per packet control byte and the LLH, IP and TCP headers
+  TxData += 1 + UIP_LLH_LEN + UIP_TCPIP_HLEN;
+
+  Enc28j60SwitchBank(BANK0);
+  Enc28j60WriteReg(BANK0_EWRPTL, (uint8_t) (TxData >> 0));
+  Enc28j60WriteReg(BANK0_EWRPTH, (uint8_t) (TxData >> 8));
+  tx_data_start = TxData;
+  tx_data_bytes = 0;
+}
+
+
+void Enc28j60TxDataWrite(uint8_t* pBuffer, uint16_t nBytes)
+{
+  // Append TCP data to the frame being built in the transmit buffer. The
+  // ENC28J60 write pointer increments as the data is written, so
+  // successive calls place the data one after the other.
+  if (nBytes == 0) return;
+  select();
+  SpiWriteByte(OPCODE_WBM);
+  SpiWriteChunk(pBuffer, nBytes);
+  deselect();
+  tx_data_bytes += nBytes;
+}
+
+
+void Enc28j60TxDataPatch(uint16_t nOffset, uint8_t* pBuffer, uint16_t nBytes)
+{
+  // Over-write TCP data already written with Enc28j60TxDataWrite(). nOffset
+  // is relative to the first TCP data byte. The write pointer is returned
+  // to the end of the data so that Enc28j60TxDataWrite() can continue.
+  uint16_t TxData;
+
+  TxData = tx_data_start + nOffset;
+  Enc28j60SwitchBank(BANK0);
+  Enc28j60WriteReg(BANK0_EWRPTL, (uint8_t) (TxData >> 0));
+  Enc28j60WriteReg(BANK0_EWRPTH, (uint8_t) (TxData >> 8));
+  select();
+  SpiWriteByte(OPCODE_WBM);
+  SpiWriteChunk(pBuffer, nBytes);
+  deselect();
+  TxData = tx_data_start + tx_data_bytes;
+  Enc28j60WriteReg(BANK0_EWRPTL, (uint8_t) (TxData >> 0));
+  Enc28j60WriteReg(BANK0_EWRPTH, (uint8_t) (TxData >> 8));
+}
+#endif // HTTPD_TX_WRITE_THROUGH == 1
+
+
+#if HTTPD_PAGE_CACHE == 1
+static void Enc28j60DmaCopy(uint16_t nSource, uint16_t nBytes, uint16_t nDest)
+{
+  // Copy nBytes of the ENC28J60 SRAM from nSource to nDest with the
+  // ENC28J60 DMA. Neither area may be inside the receive buffer.
+  uint16_t nEnd = nSource + nBytes - 1;
+
+  Enc28j60SwitchBank(BANK0);
+  Enc28j60WriteReg(BANK0_EDMASTL, (uint8_t) (nSource >> 0));
+  Enc28j60WriteReg(BANK0_EDMASTH, (uint8_t) (nSource >> 8));
+  Enc28j60WriteReg(BANK0_EDMANDL, (uint8_t) (nEnd >> 0));
+  Enc28j60WriteReg(BANK0_EDMANDH, (uint8_t) (nEnd >> 8));
+  Enc28j60WriteReg(BANK0_EDMADSTL, (uint8_t) (nDest >> 0));
+  Enc28j60WriteReg(BANK0_EDMADSTH, (uint8_t) (nDest >> 8));
+  // With CSUMEN clear the DMA copies instead of calculating a checksum
+  Enc28j60SetMaskReg(BANKX_ECON1, (1<<BANKX_ECON1_DMAST));
+  while (Enc28j60ReadReg(BANKX_ECON1) & (1<<BANKX_ECON1_DMAST)) nop();
+}
+
+
+void Enc28j60CacheStore(uint16_t nOffset)
+{
+  // Called by the httpd after CopyHttpData() has written a segment to the
+  // transmit buffer. The TCP data is copied to the page cache area at
+  // nOffset.
+  if (tx_data_bytes == 0) return;
+  Enc28j60DmaCopy(tx_data_start, tx_data_bytes, ENC28J60_CACHESTART + nOffset);
+}
+
+
+void Enc28j60CacheLoad(uint16_t nOffset, uint16_t nBytes)
+{
+  // Called by the httpd in place of CopyHttpData(). The segment at nOffset
+  // in the page cache area is copied to the TCP data area of the next
+  // frame, and Enc28j60Send() then only copies the headers as if the data
+  // had been written with Enc28j60TxDataWrite().
+  Enc28j60TxDataStart();
+  Enc28j60DmaCopy(ENC28J60_CACHESTART + nOffset, nBytes, tx_data_start);
+  tx_data_bytes = nBytes;
+}
+#endif // HTTPD_PAGE_CACHE == 1
+
+
 void Enc28j60Send(uint8_t* pBuffer, uint16_t nBytes)
 {
+#if ENC28J60_TX_DOUBLE_BUFFER == 1
+  uint16_t TxStart;
+  uint16_t TxEnd;
+
+  // Alternate between the two transmit slots. The new frame is written to
+  // the slot not used by the last frame, so the SPI copy can proceed while
+  // the last frame is still on the wire.
+  tx_slot ^= 1;
+  if (tx_slot) TxStart = ENC28J60_TXSTART2;
+  else TxStart = ENC28J60_TXSTART;
+  TxEnd = TxStart + nBytes;
+#else // ENC28J60_TX_DOUBLE_BUFFER == 0
   uint16_t TxEnd = ENC28J60_TXSTART + nBytes;
+#endif // ENC28J60_TX_DOUBLE_BUFFER == 1
+#if HTTPD_TX_WRITE_THROUGH == 1
+  uint16_t nCopy;
+
+  // If the TCP data of this frame was already written to the transmit
+  // buffer by Enc28j60TxDataWrite() only the headers are copied from the
+  // uip_buf. Any other frame (for instance an ARP request that replaced the
+  // TCP segment in uip_arp_out()) is copied in full.
+  nCopy = nBytes;
+  if (tx_data_bytes != 0
+   && nBytes == (uint16_t)(UIP_LLH_LEN + UIP_TCPIP_HLEN + tx_data_bytes)
+   && ((struct uip_eth_hdr *)pBuffer)->type == UIP_ETHTYPE_IP
+   && ((struct uip_tcpip_hdr *)&pBuffer[UIP_LLH_LEN])->proto == UIP_PROTO_TCP) {
+    nCopy = UIP_LLH_LEN + UIP_TCPIP_HLEN;
+  }
+  tx_data_bytes = 0;
+#endif // HTTPD_TX_WRITE_THROUGH == 1
+
+#if STACK_MONITOR == 1
+  // Only the part of the frame copied from the uip_buf counts
+#if HTTPD_TX_WRITE_THROUGH == 1
+  if (nCopy > uip_buf_peak) uip_buf_peak = nCopy;
+#else // HTTPD_TX_WRITE_THROUGH == 0
+  if (nBytes > uip_buf_peak) uip_buf_peak = nBytes;
+#endif // HTTPD_TX_WRITE_THROUGH == 1
+#endif // STACK_MONITOR == 1
+
+#if ENC28J60_ASYNC_TX == 1
+#if ENC28J60_TX_DOUBLE_BUFFER == 0
+  // The transmit buffer is still in use by the last frame if it has not
+  // been completed yet. Complete it before the buffer is over-written.
+  if (tx_pending) Enc28j60FinishSend();
+#endif // ENC28J60_TX_DOUBLE_BUFFER == 0
+#else // ENC28J60_ASYNC_TX == 0
   uint8_t i;
-  uint8_t txerif_temp;
-  uint8_t late_collision;
 
   // Wait for a previously buffered frame to be sent out completely
   // 
@@ -738,12 +1191,20 @@ void Enc28j60Send(uint8_t* pBuffer, uint16_t nBytes)
     if (!(Enc28j60ReadReg(BANKX_ECON1) & (1<<BANKX_ECON1_TXRTS))) break;
     wait_timer(500);  // Wait 500 uS
   }
+  // i only wraps to 0xff if the loop timed out
+  if (i == 0xff) UDP_LOG(UDP_LOG_TXRTS, 0);
+#endif // ENC28J60_ASYNC_TX == 1
 
   Enc28j60SwitchBank(BANK0);
+#if ENC28J60_TX_DOUBLE_BUFFER == 1
+  Enc28j60WriteReg(BANK0_EWRPTL, (uint8_t) (TxStart >> 0));
+  Enc28j60WriteReg(BANK0_EWRPTH, (uint8_t) (TxStart >> 8));
+#else // ENC28J60_TX_DOUBLE_BUFFER == 0
   Enc28j60WriteReg(BANK0_EWRPTL, (uint8_t) (ENC28J60_TXSTART >> 0));
   Enc28j60WriteReg(BANK0_EWRPTH, (uint8_t) (ENC28J60_TXSTART >> 8));
   Enc28j60WriteReg(BANK0_ETXNDL, (uint8_t) (TxEnd >> 0));
   Enc28j60WriteReg(BANK0_ETXNDH, (uint8_t) (TxEnd >> 8));	
+#endif // ENC28J60_TX_DOUBLE_BUFFER == 1
 
   select();
 
@@ -761,9 +1222,46 @@ void Enc28j60Send(uint8_t* pBuffer, uint16_t nBytes)
     // 	0 = The values in MACON3 will be used to determine how the packet
     //	will be transmitted
 
+#if HTTPD_TX_WRITE_THROUGH == 1
+  SpiWriteChunk(pBuffer, nCopy); // Copy data to the ENC28J60 transmit buffer
+#else // HTTPD_TX_WRITE_THROUGH == 0
   SpiWriteChunk(pBuffer, nBytes); // Copy data to the ENC28J60 transmit buffer
+#endif // HTTPD_TX_WRITE_THROUGH == 1
 
   deselect();
+
+#if ENC28J60_DMA_CHECKSUM == 1
+  // uip leaves the TCP checksum of outgoing segments seeded with the pseudo
+  // header sum (see uip_process()). Have the ENC28J60 DMA checksum engine
+  // complete it over the TCP header and data now in the transmit buffer and
+  // patch the result into the frame. The frame starts 1 byte into the
+  // transmit buffer (after the per packet control byte).
+  if (((struct uip_eth_hdr *)pBuffer)->type == UIP_ETHTYPE_IP
+   && ((struct uip_tcpip_hdr *)&pBuffer[UIP_LLH_LEN])->proto == UIP_PROTO_TCP) {
+    uint16_t tcp_offset;
+#if ENC28J60_TX_DOUBLE_BUFFER == 1
+    tcp_offset = (uint16_t)(TxStart - ENC28J60_TXSTART + 1 + UIP_LLH_LEN + UIP_IPH_LEN);
+#else // ENC28J60_TX_DOUBLE_BUFFER == 0
+    tcp_offset = (uint16_t)(1 + UIP_LLH_LEN + UIP_IPH_LEN);
+#endif // ENC28J60_TX_DOUBLE_BUFFER == 1
+    // The TCP checksum field is 16 bytes into the TCP header
+    Enc28j60CopyChecksum((uint16_t)(tcp_offset + 16),
+      Enc28j60ChecksumTx(tcp_offset, (uint16_t)(nBytes - UIP_LLH_LEN - UIP_IPH_LEN)));
+  }
+#endif // ENC28J60_DMA_CHECKSUM == 1
+
+#if ENC28J60_TX_DOUBLE_BUFFER == 1
+  // The last frame (in the other slot) must be complete before the transmit
+  // logic is pointed at the new slot. Any Late Collision re-transmit of the
+  // last frame is also done here, while ETXST and ETXND still point at it.
+  if (tx_pending) Enc28j60FinishSend();
+
+  Enc28j60SwitchBank(BANK0);
+  Enc28j60WriteReg(BANK0_ETXSTL, (uint8_t) (TxStart >> 0));
+  Enc28j60WriteReg(BANK0_ETXSTH, (uint8_t) (TxStart >> 8));
+  Enc28j60WriteReg(BANK0_ETXNDL, (uint8_t) (TxEnd >> 0));
+  Enc28j60WriteReg(BANK0_ETXNDH, (uint8_t) (TxEnd >> 8));
+#endif // ENC28J60_TX_DOUBLE_BUFFER == 1
   
   // Errata: In Half-Duplex mode, a hardware transmission abort caused by
   // excessive collisions, a late collision or excessive deferrals, may stall
@@ -859,6 +1357,32 @@ wait_timer(10);  // Wait 10 uS
     
   // Start transmission
   Enc28j60SetMaskReg(BANKX_ECON1, (1<<BANKX_ECON1_TXRTS));
+
+#if ENC28J60_ASYNC_TX == 1
+  // Return without waiting for the transmission to complete. The completion
+  // and any error handling is done by Enc28j60FinishSend(), called either
+  // from Enc28j60PollSend() in the main loop or at the start of the next
+  // Enc28j60Send().
+  tx_pending = 1;
+#else // ENC28J60_ASYNC_TX == 0
+  Enc28j60FinishSend();
+#endif // ENC28J60_ASYNC_TX == 1
+}
+
+
+void Enc28j60FinishSend(void)
+{
+  // Wait for the transmission started by Enc28j60Send() to complete and
+  // handle any transmit errors. If a Late Collision occurred the frame is
+  // still in the ENC28J60 transmit buffer and is re-transmitted from there.
+  uint8_t i;
+  uint8_t txerif_temp;
+  uint8_t late_collision;
+
+#if ENC28J60_ASYNC_TX == 1
+  tx_pending = 0;
+#endif // ENC28J60_ASYNC_TX == 1
+
   // Wait for transmission complete
   txerif_temp = wait_for_xmit_complete();
     
@@ -926,10 +1450,172 @@ wait_timer(10);  // Wait 10 uS
     }
   }
   
-  // Save debug_bytes[3] (TXERIF counter) in EEPROM for display in Link Error
-  // Statistics
-  update_debug_storage1();
+  // debug_bytes[3] (TXERIF counter) is written to EEPROM once a minute by the
+  // main loop
+}
+
+
+#if ENC28J60_DMA_CHECKSUM == 1
+uint16_t Enc28j60ChecksumTx(uint16_t Offset, uint16_t Length)
+{
+  // Use the ENC28J60 DMA checksum engine to calculate the IP style checksum
+  // over Length bytes of the transmit buffer starting at Offset. The result
+  // in EDMACS is already complemented, ready to be placed in a header.
+  uint16_t nStart = ENC28J60_TXSTART + Offset;
+  uint16_t nEnd = nStart + Length - 1;
+
+  Enc28j60SwitchBank(BANK0);
+  Enc28j60WriteReg(BANK0_EDMASTL, (uint8_t) (nStart >> 0));
+  Enc28j60WriteReg(BANK0_EDMASTH, (uint8_t) (nStart >> 8));
+  Enc28j60WriteReg(BANK0_EDMANDL, (uint8_t) (nEnd >> 0));
+  Enc28j60WriteReg(BANK0_EDMANDH, (uint8_t) (nEnd >> 8));
+
+  // Select checksum mode then start the DMA
+  Enc28j60SetMaskReg(BANKX_ECON1, (1<<BANKX_ECON1_CSUMEN));
+  Enc28j60SetMaskReg(BANKX_ECON1, (1<<BANKX_ECON1_DMAST));
+  // DMAST is cleared by the ENC28J60 when the checksum is complete. For a
+  // MAXFRAME frame this takes about 40us.
+  while (Enc28j60ReadReg(BANKX_ECON1) & (1<<BANKX_ECON1_DMAST)) nop();
+  Enc28j60ClearMaskReg(BANKX_ECON1, (1<<BANKX_ECON1_CSUMEN));
+
+  return (uint16_t)(((uint16_t)Enc28j60ReadReg(BANK0_EDMACSH) << 8)
+                   | Enc28j60ReadReg(BANK0_EDMACSL));
+}
+
+
+void Enc28j60CopyChecksum(uint16_t Offset, uint16_t Checksum)
+{
+  // Write a checksum (MSB first) into the transmit buffer at Offset
+  uint16_t nAddress = ENC28J60_TXSTART + Offset;
+
+  Enc28j60SwitchBank(BANK0);
+  Enc28j60WriteReg(BANK0_EWRPTL, (uint8_t) (nAddress >> 0));
+  Enc28j60WriteReg(BANK0_EWRPTH, (uint8_t) (nAddress >> 8));
+
+  select();
+  SpiWriteByte(OPCODE_WBM);
+  SpiWriteByte((uint8_t)(Checksum >> 8));
+  SpiWriteByte((uint8_t)(Checksum >> 0));
+  deselect();
+}
+#endif // ENC28J60_DMA_CHECKSUM == 1
+
+
+#if ARP_MISS_QUEUE == 1
+void Enc28j60ParkFrame(uint8_t* pBuffer, uint16_t nBytes)
+{
+  // Called by uip_arp_out() before the frame in the uip_buf is over-written
+  // with an ARP request. The frame is copied to the park area at the end of
+  // the ENC28J60 receive area, outside the receive buffer. The caller only
+  // parks frames of up to ENC28J60_PARKSIZE and UIP_BUFSIZE bytes so that the
+  // copy stays out of the transmit buffer and the frame fits the uip_buf when
+  // Enc28j60UnparkFrame() reads it back.
+  uint16_t nCopy;
+
+  nCopy = nBytes;
+#if HTTPD_TX_WRITE_THROUGH == 1
+  // If the TCP data of the frame was written directly to the transmit
+  // buffer by Enc28j60TxDataWrite() only the headers are in the uip_buf.
+  // The data is moved to the park area with the ENC28J60 DMA copy.
+  if (tx_data_bytes != 0
+   && nBytes == (uint16_t)(UIP_LLH_LEN + UIP_TCPIP_HLEN + tx_data_bytes)
+   && ((struct uip_tcpip_hdr *)&pBuffer[UIP_LLH_LEN])->proto == UIP_PROTO_TCP) {
+    uint16_t nEnd = tx_data_start + tx_data_bytes - 1;
+    uint16_t nDest = ENC28J60_PARKSTART + UIP_LLH_LEN + UIP_TCPIP_HLEN;
+
+    nCopy = UIP_LLH_LEN + UIP_TCPIP_HLEN;
+    Enc28j60SwitchBank(BANK0);
+    Enc28j60WriteReg(BANK0_EDMASTL, (uint8_t) (tx_data_start >> 0));
+    Enc28j60WriteReg(BANK0_EDMASTH, (uint8_t) (tx_data_start >> 8));
+    Enc28j60WriteReg(BANK0_EDMANDL, (uint8_t) (nEnd >> 0));
+    Enc28j60WriteReg(BANK0_EDMANDH, (uint8_t) (nEnd >> 8));
+    Enc28j60WriteReg(BANK0_EDMADSTL, (uint8_t) (nDest >> 0));
+    Enc28j60WriteReg(BANK0_EDMADSTH, (uint8_t) (nDest >> 8));
+    // With CSUMEN clear the DMA copies instead of calculating a checksum
+    Enc28j60SetMaskReg(BANKX_ECON1, (1<<BANKX_ECON1_DMAST));
+    while (Enc28j60ReadReg(BANKX_ECON1) & (1<<BANKX_ECON1_DMAST)) nop();
+  }
+#endif // HTTPD_TX_WRITE_THROUGH == 1
+
+  Enc28j60SwitchBank(BANK0);
+  Enc28j60WriteReg(BANK0_EWRPTL, (uint8_t) (ENC28J60_PARKSTART >> 0));
+  Enc28j60WriteReg(BANK0_EWRPTH, (uint8_t) (ENC28J60_PARKSTART >> 8));
+  select();
+  SpiWriteByte(OPCODE_WBM);
+  SpiWriteChunk(pBuffer, nCopy);
+  deselect();
+}
+
+
+void Enc28j60UnparkFrame(uint8_t* pBuffer, uint16_t nBytes)
+{
+  // Called by uip_arp_arpin() when the ARP reply for the parked frame
+  // arrives. The frame is read back in full so that Enc28j60Send() can
+  // transmit it like any other frame. The receive read pointer is saved
+  // and restored so Enc28j60Receive() is not disturbed.
+  uint8_t saved_ERDPTL;
+  uint8_t saved_ERDPTH;
+
+  Enc28j60SwitchBank(BANK0);
+  saved_ERDPTL = Enc28j60ReadReg(BANK0_ERDPTL);
+  saved_ERDPTH = Enc28j60ReadReg(BANK0_ERDPTH);
+  Enc28j60WriteReg(BANK0_ERDPTL, (uint8_t) (ENC28J60_PARKSTART >> 0));
+  Enc28j60WriteReg(BANK0_ERDPTH, (uint8_t) (ENC28J60_PARKSTART >> 8));
+  select();
+  SpiWriteByte(OPCODE_RBM);
+  SpiReadChunk(pBuffer, nBytes);
+  deselect();
+  Enc28j60WriteReg(BANK0_ERDPTL, saved_ERDPTL);
+  Enc28j60WriteReg(BANK0_ERDPTH, saved_ERDPTH);
+}
+#endif // ARP_MISS_QUEUE == 1
+
+
+#if DEVELOPMENT_TOOLS == 1 && BENCHMARK_SUPPORT == 1
+void Enc28j60BenchWrite(uint16_t nOffset, uint8_t* pBuffer, uint16_t nBytes)
+{
+  // Write nBytes at nOffset in the transmit buffer. Used only by the SPI
+  // benchmark in bench_run(). A frame still being transmitted is completed
+  // first so that it is not over-written.
+  uint16_t TxData;
+
+#if ENC28J60_ASYNC_TX == 1
+  if (tx_pending) Enc28j60FinishSend();
+#endif // ENC28J60_ASYNC_TX == 1
+  TxData = ENC28J60_TXSTART + nOffset;
+  Enc28j60SwitchBank(BANK0);
+  Enc28j60WriteReg(BANK0_EWRPTL, (uint8_t) (TxData >> 0));
+  Enc28j60WriteReg(BANK0_EWRPTH, (uint8_t) (TxData >> 8));
+  select();
+  SpiWriteByte(OPCODE_WBM);
+  SpiWriteChunk(pBuffer, nBytes);
+  deselect();
+}
+
+
+void Enc28j60BenchRead(uint16_t nOffset, uint8_t* pBuffer, uint16_t nBytes)
+{
+  // Read nBytes at nOffset in the transmit buffer. Used only by the SPI
+  // benchmark in bench_run(). The receive read pointer is saved and
+  // restored so Enc28j60Receive() is not disturbed.
+  uint16_t TxData;
+  uint8_t saved_ERDPTL;
+  uint8_t saved_ERDPTH;
+
+  TxData = ENC28J60_TXSTART + nOffset;
+  Enc28j60SwitchBank(BANK0);
+  saved_ERDPTL = Enc28j60ReadReg(BANK0_ERDPTL);
+  saved_ERDPTH = Enc28j60ReadReg(BANK0_ERDPTH);
+  Enc28j60WriteReg(BANK0_ERDPTL, (uint8_t) (TxData >> 0));
+  Enc28j60WriteReg(BANK0_ERDPTH, (uint8_t) (TxData >> 8));
+  select();
+  SpiWriteByte(OPCODE_RBM);
+  SpiReadChunk(pBuffer, nBytes);
+  deselect();
+  Enc28j60WriteReg(BANK0_ERDPTL, saved_ERDPTL);
+  Enc28j60WriteReg(BANK0_ERDPTH, saved_ERDPTH);
 }
+#endif // DEVELOPMENT_TOOLS == 1 && BENCHMARK_SUPPORT == 1
 
 
 void reset_transmit_logic(void)
@@ -969,6 +1655,7 @@ uint8_t wait_for_xmit_complete()
     timeout--;
     if (timeout == 0) {
       txerif_temp = 1; // If timeout set the error state
+      UDP_LOG(UDP_LOG_TXRTS, 1);
       break;
     }
   }
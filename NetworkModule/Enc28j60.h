@@ -68,8 +68,25 @@
 // Errata Workaround: RXEND should not be even!
 #define ENC28J60_RXSTART	0x0000	//6kb
 #define ENC28J60_RXEND		0x17FF
+// With ARP_MISS_QUEUE the last 576 bytes of the receive area hold the IP
+// packet parked by uip_arp_out() while its ARP request is outstanding, and
+// the receive buffer ends at ENC28J60_PARKSTART - 1.
+#define ENC28J60_PARKSTART	0x15C0
+#define ENC28J60_PARKSIZE	(ENC28J60_RXEND + 1 - ENC28J60_PARKSTART)
+// With HTTPD_PAGE_CACHE the 3kb below the park area hold the cached web page
+// segments, and the receive buffer ends at ENC28J60_CACHESTART - 1.
+#define ENC28J60_CACHESTART	0x0A00
+#define ENC28J60_CACHESIZE	(ENC28J60_PARKSTART - ENC28J60_CACHESTART)
 #define ENC28J60_TXSTART	0x1800	//2kb
 #define ENC28J60_TXEND		0x1FFF
+// Start of the second transmit slot when ENC28J60_TX_DOUBLE_BUFFER is used.
+// Each 1kb slot holds the control byte, a MAXFRAME frame and the 7 byte
+// Transmit Status Vector.
+#define ENC28J60_TXSTART2	0x1C00
+// Largest frame that fits in one 1kb transmit slot: the slot less the
+// control byte and the 7 byte Transmit Status Vector. This limits the
+// transmit segment size when HTTPD_TX_WRITE_THROUGH is used.
+#define ENC28J60_TX_MAXFRAME	1016
 
 // LED configuration bits:
 // LEDA: Transmit
@@ -82,8 +99,10 @@
 // a) The size of the largest Home Assistant Config message plus headers
 // b) The copy_I2C_EEPROM_to_Flash() function which requires the uip_buf to be
 //    at least 512 bytes. The uip_buf size is based on MAXFRAME.
+// ENC28J60_MAXFRAME is set by RAM_PROFILE in uipopt.h (550 by default) plus
+// the RAM freed by SCRATCH_ARENA.
 // #define ENC28J60_MAXFRAME	500
-#define ENC28J60_MAXFRAME	550
+#define ENC28J60_MAXFRAME	(RAM_MAXFRAME + RAM_SCRATCH_CREDIT)
 
 // Use this for function inlining within the ENC28J60 module
 #define ENC28J60_INLINE		static inline __attribute__ ((always_inline))
@@ -91,13 +110,67 @@
 // Initialize Chip (Initialize used SPI module before!)
 void Enc28j60Init(void);
 
+// Programs the ENC28J60 receive filters to accept only unicast frames for
+// our MAC plus ARP broadcasts for our IP address (ENC28J60_RX_FILTER)
+void Enc28j60SetFilter(void);
+
 // Receives an Ethernet-frame. If non available it returns zero
 // This function will never receive more than ENC28J60_MAXFRAME bytes
 uint16_t Enc28j60Receive(uint8_t* pBuffer);
 
+// Examines the headers at the start of a received frame and returns 1 if
+// the rest of the frame is of interest to uip (ENC28J60_HEADER_PEEK)
+uint8_t Enc28j60FrameWanted(uint8_t* pBuffer);
+
 // Copies a packet into ENC28J60's buffer and sends the ethernet frame
 void Enc28j60Send(uint8_t* pBuffer, uint16_t nBytes);
 
+// Waits for the frame started by Enc28j60Send() to complete and handles
+// transmit errors and Late Collision re-transmits
+void Enc28j60FinishSend(void);
+
+// Completes the last Enc28j60Send() if its transmission has finished
+// (ENC28J60_ASYNC_TX)
+void Enc28j60PollSend(void);
+
+// Points the ENC28J60 write pointer at the TCP data area of the frame the
+// next Enc28j60Send() will transmit (HTTPD_TX_WRITE_THROUGH)
+void Enc28j60TxDataStart(void);
+
+// Writes TCP data directly into the ENC28J60 transmit buffer at the write
+// pointer (HTTPD_TX_WRITE_THROUGH)
+void Enc28j60TxDataWrite(uint8_t* pBuffer, uint16_t nBytes);
+
+// Over-writes TCP data already written to the ENC28J60 transmit buffer for
+// the next frame (HTTPD_TX_WRITE_THROUGH)
+void Enc28j60TxDataPatch(uint16_t nOffset, uint8_t* pBuffer, uint16_t nBytes);
+
+// Copies the TCP data written for the next frame to the page cache area
+// (HTTPD_PAGE_CACHE)
+void Enc28j60CacheStore(uint16_t nOffset);
+
+// Copies a segment from the page cache area to the TCP data area of the
+// frame the next Enc28j60Send() will transmit (HTTPD_PAGE_CACHE)
+void Enc28j60CacheLoad(uint16_t nOffset, uint16_t nBytes);
+
+// Reports a change of the PHY link state (PHY_LINK_MONITOR)
+#define ENC28J60_LINK_NONE		0
+#define ENC28J60_LINK_UP		1
+#define ENC28J60_LINK_DOWN		2
+uint8_t Enc28j60LinkCheck(void);
+
+// Copies a frame waiting for an ARP reply to the ENC28J60 park area
+// (ARP_MISS_QUEUE)
+void Enc28j60ParkFrame(uint8_t* pBuffer, uint16_t nBytes);
+
+// Copies the parked frame back to the uip_buf (ARP_MISS_QUEUE)
+void Enc28j60UnparkFrame(uint8_t* pBuffer, uint16_t nBytes);
+
+// Writes to and reads from the transmit buffer for the SPI benchmark
+// (BENCHMARK_SUPPORT)
+void Enc28j60BenchWrite(uint16_t nOffset, uint8_t* pBuffer, uint16_t nBytes);
+void Enc28j60BenchRead(uint16_t nOffset, uint8_t* pBuffer, uint16_t nBytes);
+
 // Resets the transmit logic in the ENC28J60
 void reset_transmit_logic(void);
 
@@ -115,9 +188,10 @@ uint8_t wait_for_xmit_complete(void);
 
 // Generates a checksum over a given range in ENC28J60's TX buffer
 // using ENC28J60's own checksum generation function.
-// uint16_t Enc28j60ChecksumTx(uint16_t Offset, uint16_t Length);
+// Offset is from the start of the TX buffer (ENC28J60_TXSTART).
+uint16_t Enc28j60ChecksumTx(uint16_t Offset, uint16_t Length);
 
-// Copies data into ENC28J60's TX buffer at Offset
-// void Enc28j60CopyChecksum(uint16_t Offset, uint16_t Checksum);
+// Copies a checksum into ENC28J60's TX buffer at Offset
+void Enc28j60CopyChecksum(uint16_t Offset, uint16_t Checksum);
 
 #endif /*ENC28J60_H_*/
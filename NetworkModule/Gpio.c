@@ -29,6 +29,11 @@
 extern uint8_t stored_pin_control[16];  // STM8 per pin control settings
                                         // stored in EEPROM
 extern uint8_t stored_options1;         // Additional options stored in EEPROM
+#if LINKED_FAST_PATH == 1 && PIN_CAPTURE_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD && LINKED_SUPPORT == 1
+extern uint8_t pin_control[16];         // Per pin control settings
+extern uint8_t stored_config_settings;  // Config settings stored in EEPROM
+extern uint16_t ms_counter;             // Free running ms counter
+#endif // LINKED_FAST_PATH == 1 && PIN_CAPTURE_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD && LINKED_SUPPORT == 1
 
 
 // The following structs are used to direct the read_input_pins() and
@@ -249,8 +254,20 @@ void gpio_init(void)
   // PC Bit 1 - Pin 26 - Output PP - ENC28J60 -CS
 //  PC_DDR = 0x0e;
 //  PC_CR2 = 0x0e;
+#if HW_SPI_SUPPORT == 0
   PC_DDR |= 0x0e;
   PC_CR2 |= 0x0e;
+#endif // HW_SPI_SUPPORT == 0
+
+#if HW_SPI_SUPPORT == 1
+  // With HW_SPI_SUPPORT the ENC28J60 uses the SPI peripheral pins instead
+  // PC Bit 7 - Pin 34 - Input  PU - ENC28J60 SO (SPI MISO)
+  // PC Bit 6 - Pin 33 - Output PP - ENC28J60 SI (SPI MOSI) Fast
+  // PC Bit 5 - Pin 30 - Output PP - ENC28J60 SCK Fast
+  // PC Bit 1 - Pin 26 - Output PP - ENC28J60 -CS
+  PC_DDR |= 0x62;
+  PC_CR2 |= 0x62;
+#endif // HW_SPI_SUPPORT == 1
   
   // PE Bit 5 - Pin 25 - Output PP - ENC28J60 -RESET
 //  PE_DDR = 0x20;
@@ -313,7 +330,288 @@ void gpio_init(void)
 #endif // LINKED_SUPPORT == 1
     }
   }
+
+#if HW_SPI_SUPPORT == 1
+  // IO 8 and IO 16 share pins with the SPI peripheral. Make sure the IO
+  // loop above did not turn the SPI MISO pin into an output.
+  PC_DDR &= (uint8_t)(~0x80);
+  PC_DDR |= 0x62;
+#endif // HW_SPI_SUPPORT == 1
+
+#if PIN_CAPTURE_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD
+  pin_capture_init();
+#endif // PIN_CAPTURE_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD
+}
+
+
+#if PIN_CAPTURE_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD
+//---------------------------------------------------------------------------//
+// Input pin change capture
+//
+// The input pins on Ports A, C, D and E have their external interrupt
+// enabled for both edges. The Port ISR compares the port input register
+// with its last value and latches the changed bits in capture_edge[]. If the
+// ISR finds no change the pulse was shorter than the interrupt latency, so
+// all captured pins on that Port are latched. Port G has no external
+// interrupt, so IO 7 and IO 15 are only seen by read_input_pins().
+//
+// publish_outbound() collects the latched edges with pin_capture_take(). A
+// pulse that is over before read_input_pins() could see it is still
+// published, so its length no longer depends on the main loop speed.
+
+uint8_t capture_mask[PF];          // Captured input pin bits per Port
+uint8_t capture_last[PF];          // Port input bits at the last interrupt
+volatile uint8_t capture_edge[PF]; // Latched edges per Port
+
+#if LINKED_FAST_PATH == 1 && PIN_CAPTURE_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD && LINKED_SUPPORT == 1
+// Linked pin fast path, see linked_fast_init()
+uint8_t linked_fast_in[8];         // io_map index of each Linked Input
+uint8_t linked_fast_out[8];        // io_map index of each Linked Output
+uint8_t linked_fast_time[8];       // ms_counter at the last accepted edge
+uint8_t linked_fast_pins;          // Pairs with a fast path (bit 0 = IO 1)
+uint8_t linked_fast_lock;          // Pairs ignoring edges (debounce)
+uint8_t linked_fast_level;         // Input level at the last accepted edge
+volatile uint8_t linked_fast_edge; // Edges applied to the ODR but not yet
+                                   // to the pin_control
+#endif // LINKED_FAST_PATH == 1 && PIN_CAPTURE_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD && LINKED_SUPPORT == 1
+
+
+void pin_capture_init(void)
+{
+  // Enable the external interrupt on each Input pin. Must be called with
+  // interrupts masked as the EXTI_CRx registers can only be written then.
+  uint8_t i;
+  uint8_t j;
+  
+  memset(capture_mask, 0, sizeof(capture_mask));
+  for (i=0; i<16; i++) {
+#if PINOUT_OPTION_SUPPORT == 0
+    j = i;
+#endif // PINOUT_OPTION_SUPPORT == 0
+#if PINOUT_OPTION_SUPPORT == 1
+    j = calc_PORT_BIT_index(i);
+#endif // PINOUT_OPTION_SUPPORT == 1
+#if LINKED_SUPPORT == 0
+    if ((stored_pin_control[i] & 0x03) == 0x01 && io_map[j].port < PF) {
+#endif // LINKED_SUPPORT == 0
+#if LINKED_SUPPORT == 1
+    if (chk_iotype(stored_pin_control[i], i, 0x03) == 0x01 && io_map[j].port < PF) {
+#endif // LINKED_SUPPORT == 1
+      capture_mask[ io_map[j].port ] |= io_map[j].bit;
+    }
+  }
+  
+  for (i=PA; i<PF; i++) {
+    io_reg[ i ].cr2 |= capture_mask[i];
+    capture_last[i] = (uint8_t)(io_reg[ i ].idr & capture_mask[i]);
+    if (i == PC) capture_last[i] |= (uint8_t)(io_reg[ i ].idr & 0x20);
+    capture_edge[i] = 0;
+  }
+  
+  // Rising and falling edge sensitivity for Ports A, B, C, D and E
+  EXTI_CR1 = (uint8_t)0xff;
+  EXTI_CR2 |= (uint8_t)0x03;
+
+#if LINKED_FAST_PATH == 1 && PIN_CAPTURE_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD && LINKED_SUPPORT == 1
+  linked_fast_init();
+#endif // LINKED_FAST_PATH == 1 && PIN_CAPTURE_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD && LINKED_SUPPORT == 1
+}
+
+
+void pin_capture_port(uint8_t port)
+{
+  // Called from the Port ISRs to latch the changed input bits. On Port C
+  // the ENC28J60 -INT pin (PC5) is tracked too so that its edges (used by
+  // LOW_POWER_IDLE) are not mistaken for a short pulse on IO 8 or IO 16.
+  uint8_t track;
+  uint8_t now;
+  uint8_t changed;
+  
+  track = capture_mask[port];
+  if (port == PC) track |= 0x20;
+  now = (uint8_t)(io_reg[ port ].idr & track);
+  changed = (uint8_t)(now ^ capture_last[port]);
+#if LINKED_FAST_PATH == 1 && PIN_CAPTURE_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD && LINKED_SUPPORT == 1
+  if (linked_fast_pins) linked_fast_port(port, now, changed);
+#endif // LINKED_FAST_PATH == 1 && PIN_CAPTURE_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD && LINKED_SUPPORT == 1
+  if (changed == 0) changed = capture_mask[port];
+  capture_edge[port] |= (uint8_t)(changed & capture_mask[port]);
+  capture_last[port] = now;
+}
+
+
+uint16_t pin_capture_take(void)
+{
+  // Return the latched edges as a pin bitmap (bit 0 = IO 1) and clear them
+  uint8_t edge[PF];
+  uint16_t pins;
+  uint16_t mask;
+  uint8_t i;
+  uint8_t j;
+  
+  sim();
+  for (i=PA; i<PF; i++) {
+    edge[i] = capture_edge[i];
+    capture_edge[i] = 0;
+  }
+  rim();
+  
+  pins = 0;
+  for (i=0, mask=1; i<16; i++, mask<<=1) {
+#if PINOUT_OPTION_SUPPORT == 0
+    j = i;
+#endif // PINOUT_OPTION_SUPPORT == 0
+#if PINOUT_OPTION_SUPPORT == 1
+    j = calc_PORT_BIT_index(i);
+#endif // PINOUT_OPTION_SUPPORT == 1
+    if (io_map[j].port < PF && (edge[ io_map[j].port ] & io_map[j].bit)) pins |= mask;
+  }
+  return pins;
+}
+
+
+#if LINKED_FAST_PATH == 1 && PIN_CAPTURE_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD && LINKED_SUPPORT == 1
+//---------------------------------------------------------------------------//
+// Linked pin fast path
+//
+// linked_fast_in[] and linked_fast_out[] hold the io_map index of each
+// Linked Input (IO 1 to 8) and its Output (IO 9 to 16) for the pairs in
+// linked_fast_pins. The Port ISR toggles the Output ODR on the first edge
+// of the Input and locks the pair for LINKED_FAST_DEBOUNCE ms. The edge is
+// passed to check_runtime_changes() in linked_fast_edge, which toggles the
+// Output pin_control so that the ON_OFF_word and write_output_pins() agree
+// with the ODR. read_input_pins() edges on these Inputs are ignored.
+
+
+void linked_fast_init(void)
+{
+  // Build the table of Linked pairs whose Input has an external interrupt.
+  // Outputs that write_output_pins() leaves alone (UART, I2C and DS18B20
+  // pins) are left out.
+  uint8_t i;
+  uint8_t mask;
+  uint8_t j_in;
+  uint8_t j_out;
+  
+  linked_fast_pins = 0;
+  linked_fast_lock = 0;
+  linked_fast_level = 0;
+  linked_fast_edge = 0;
+  for (i=0, mask=1; i<8; i++, mask<<=1) {
+    if ((stored_pin_control[i] & 0x03) != 0x02) continue;
+    if ((stored_pin_control[i+8] & 0x03) != 0x02) continue;
+#if DEBUG_SUPPORT == 15
+    if (i+8 == 10) continue; // Output 11
+#endif // DEBUG_SUPPORT == 15
+#if I2C_SUPPORT == 1
+    if (i+8 == 13 || i+8 == 14) continue; // Output 14 and 15
+#endif // I2C_SUPPORT == 1
+#if DS18B20_SUPPORT == 1
+    if (i+8 == 15 && (stored_config_settings & 0x08)) continue; // Output 16
+#endif // DS18B20_SUPPORT == 1
+#if PINOUT_OPTION_SUPPORT == 0
+    j_in = i;
+    j_out = (uint8_t)(i+8);
+#endif // PINOUT_OPTION_SUPPORT == 0
+#if PINOUT_OPTION_SUPPORT == 1
+    j_in = calc_PORT_BIT_index(i);
+    j_out = calc_PORT_BIT_index((uint8_t)(i+8));
+#endif // PINOUT_OPTION_SUPPORT == 1
+    if ((capture_mask[ io_map[j_in].port ] & io_map[j_in].bit) == 0) continue;
+    linked_fast_in[i] = j_in;
+    linked_fast_out[i] = j_out;
+    if (io_reg[ io_map[j_in].port ].idr & io_map[j_in].bit) linked_fast_level |= mask;
+    linked_fast_pins |= mask;
+  }
+}
+
+
+void linked_fast_port(uint8_t port, uint8_t now, uint8_t changed)
+{
+  // Called from the Port ISRs with the input bits of the Port and the bits
+  // that changed since the last interrupt. The pin_control of both pins is
+  // checked so a pair that is no longer Linked is not toggled.
+  uint8_t i;
+  uint8_t mask;
+  uint8_t bit;
+  
+  for (i=0, mask=1; i<8; i++, mask<<=1) {
+    if ((linked_fast_pins & mask) == 0) continue;
+    if (linked_fast_lock & mask) continue;
+    if (io_map[ linked_fast_in[i] ].port != port) continue;
+    bit = io_map[ linked_fast_in[i] ].bit;
+    if ((changed & bit) == 0) continue;
+    if ((pin_control[i] & 0x03) != 0x02) continue;
+    if ((pin_control[i+8] & 0x03) != 0x02) continue;
+    io_reg[ io_map[ linked_fast_out[i] ].port ].odr ^= io_map[ linked_fast_out[i] ].bit;
+    if (now & bit) linked_fast_level |= mask;
+    else linked_fast_level &= (uint8_t)(~mask);
+    linked_fast_time[i] = (uint8_t)ms_counter;
+    linked_fast_lock |= mask;
+    linked_fast_edge |= mask;
+  }
+}
+
+
+uint8_t linked_fast_service(void)
+{
+  // Called by check_runtime_changes(). Ends the lock of each pair whose
+  // LINKED_FAST_DEBOUNCE time is up. If the Input changed again while the
+  // pair was locked (a pulse shorter than the debounce time) the Output is
+  // toggled again and the pair locked again. Returns the edges applied to
+  // the Outputs since the last call (bit 0 = IO 1).
+  uint8_t i;
+  uint8_t mask;
+  uint8_t level;
+  uint8_t edges;
+  
+  sim();
+  for (i=0, mask=1; i<8; i++, mask<<=1) {
+    if ((linked_fast_lock & mask) == 0) continue;
+    if ((uint8_t)((uint8_t)ms_counter - linked_fast_time[i]) < LINKED_FAST_DEBOUNCE) continue;
+    linked_fast_lock &= (uint8_t)(~mask);
+    level = 0;
+    if (io_reg[ io_map[ linked_fast_in[i] ].port ].idr & io_map[ linked_fast_in[i] ].bit) level = mask;
+    if (level != (uint8_t)(linked_fast_level & mask)) {
+      io_reg[ io_map[ linked_fast_out[i] ].port ].odr ^= io_map[ linked_fast_out[i] ].bit;
+      linked_fast_level ^= mask;
+      linked_fast_time[i] = (uint8_t)ms_counter;
+      linked_fast_lock |= mask;
+      linked_fast_edge |= mask;
+    }
+  }
+  edges = linked_fast_edge;
+  linked_fast_edge = 0;
+  rim();
+  return edges;
+}
+#endif // LINKED_FAST_PATH == 1 && PIN_CAPTURE_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD && LINKED_SUPPORT == 1
+
+
+@far @interrupt void pin_capture_porta_isr(void)
+{
+  pin_capture_port(PA);
+}
+
+
+@far @interrupt void pin_capture_portc_isr(void)
+{
+  // Also wakes the CPU from idle_wait() on the ENC28J60 -INT (PC5) edge
+  pin_capture_port(PC);
+}
+
+
+@far @interrupt void pin_capture_portd_isr(void)
+{
+  pin_capture_port(PD);
+}
+
+
+@far @interrupt void pin_capture_porte_isr(void)
+{
+  pin_capture_port(PE);
 }
+#endif // PIN_CAPTURE_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD
 
 
 #if PINOUT_OPTION_SUPPORT == 1
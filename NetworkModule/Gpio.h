@@ -48,6 +48,12 @@ extern volatile struct io_registers io_reg[ NUM_PORTS ];
 extern const struct io_mapping io_map[16];
 
 void gpio_init(void);
+void pin_capture_init(void);
+void pin_capture_port(uint8_t port);
+uint16_t pin_capture_take(void);
+void linked_fast_init(void);
+void linked_fast_port(uint8_t port, uint8_t now, uint8_t changed);
+uint8_t linked_fast_service(void);
 uint8_t calc_PORT_BIT_index(uint8_t IO_index);
 
 void LEDcontrol(uint8_t state);
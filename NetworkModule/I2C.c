@@ -35,6 +35,12 @@ char * ram_ptr;
 uint8_t eeprom_num_write;
 uint8_t eeprom_num_read;
 uint16_t eeprom_base;
+uint8_t flash_prg_mode;      // FLASH_CR2 program mode bit used by
+                             // copy_RAM_to_Flash()
+#if I2C_FAST_MODE == 1
+uint8_t I2C_fast;            // 1 if the device addressed by the last
+                             // I2C_control() supports Fast-mode
+#endif // I2C_FAST_MODE == 1
 
 
 
@@ -71,6 +77,19 @@ uint16_t eeprom_base;
 // b) The I2C devices attached have a local 3V or 5V power supply.
 //---------------------------------------------------------------------------//
 
+// Bus timing
+// Each bus phase ends with a wait of 10 nop loops (about 5us), giving a
+// clock of well under 100kHz. With I2C_FAST_MODE only 3 loops (about 1.5us)
+// are used for devices that support 400kHz Fast-mode. That is still longer
+// than the Fast-mode minimum SCL high (0.6us) and low (1.3us) times once the
+// function call overhead is added.
+#if I2C_FAST_MODE == 0
+#define I2C_DELAY() for (nop_cnt=0; nop_cnt<10; nop_cnt++) nop()
+#endif // I2C_FAST_MODE == 0
+#if I2C_FAST_MODE == 1
+#define I2C_DELAY() for (nop_cnt=(I2C_fast ? 7 : 0); nop_cnt<10; nop_cnt++) nop()
+#endif // I2C_FAST_MODE == 1
+
 // Typical use sequence:
 //  I2C_control(write ...)
 //  I2C_byte_address(...)
@@ -90,6 +109,13 @@ uint8_t I2C_control(uint8_t control_byte)
   
   uint8_t rtn;
   rtn = 0;
+
+#if I2C_FAST_MODE == 1
+  // The PCF8574 (control bytes 0x4n) and PCF8574A (0x7n) are limited to
+  // 100kHz. The I2C EEPROM, BME280 and INA226 all support Fast-mode.
+  if ((control_byte & 0xf0) == 0x40 || (control_byte & 0xf0) == 0x70) I2C_fast = 0;
+  else I2C_fast = 1;
+#endif // I2C_FAST_MODE == 1
   
   // Since the SDA and SCL pins are pulled high with a resistor to create a
   // "1" on the bus, the Output Data Register for the SDA and SCL pins is
@@ -169,7 +195,7 @@ uint8_t I2C_read_byte(uint8_t I2C_last_flag)
       I2C_data_field |= data_mask;
     }
     SCL_low();  // Drive SCL low, then no wait
-    for (nop_cnt=0; nop_cnt<10; nop_cnt++) nop(); // Wait 5us
+    I2C_DELAY(); // Wait 5us
     data_mask = (uint8_t)(data_mask >> 1);
     if (data_mask == 0) break;
   }
@@ -201,7 +227,7 @@ void SCL_high(void)
   int nop_cnt;
   
   PE_DDR &= (uint8_t)~0x08;; // write SCL DDR to 0 to float SCL high
-  for (nop_cnt=0; nop_cnt<10; nop_cnt++) nop(); // Wait 5us
+  I2C_DELAY(); // Wait 5us
 }
 
 
@@ -217,7 +243,7 @@ void SDA_high(void)
   int nop_cnt;
   
   PG_DDR &= (uint8_t)~0x01; // write SDA DDR to 0 to float SDA high
-  for (nop_cnt=0; nop_cnt<10; nop_cnt++) nop(); // Wait 5us
+  I2C_DELAY(); // Wait 5us
 }
 
 
@@ -226,7 +252,7 @@ void SDA_low(void)
   int nop_cnt;
   
   PG_DDR |= (uint8_t)0x01; // write SDA DDR to 1 to pull SDA low
-  for (nop_cnt=0; nop_cnt<10; nop_cnt++) nop(); // Wait 5us
+  I2C_DELAY(); // Wait 5us
 }
 
 
@@ -282,6 +308,7 @@ void I2C_stop(void)
   SDA_high(); // Fload SDA high, then wait 5us
 }
 
+
 #endif // I2C_SUPPORT == 1
 
 
@@ -292,6 +319,10 @@ void copy_I2C_EEPROM_to_Flash(uint8_t maxblocks)
   uint16_t eeprom_index;
 //  uint16_t blocks;
   uint8_t blocks;
+#if FLASH_PROGRAM_TIMING == 1
+  uint16_t start_time;
+  uint8_t programmed;
+#endif // FLASH_PROGRAM_TIMING == 1
 
 #if DEBUG_SUPPORT == 15
 // UARTPrintf("copy_I2C_EEPROM_to_Flash\r\n");
@@ -382,6 +413,23 @@ void copy_I2C_EEPROM_to_Flash(uint8_t maxblocks)
   //  Blocks 253-255 (3 blocks) are reserved for user data storage and are
   //    only written when the user makes GUI input changes.
   
+#if I2C_STREAM_READ == 1
+  // The whole image is read as one sequential read. The I2C EEPROM stays in
+  // sequential read mode while the Flash is written (the bus simply waits
+  // with SCL low), so the address phase is sent only once.
+  I2C_control(eeprom_num_write);     // Write control byte to establish address
+  I2C_byte_address(eeprom_index, 2); // Byte address of first byte
+  I2C_control(eeprom_num_read);      // Read control byte
+#endif // I2C_STREAM_READ == 1
+
+#if FLASH_PROGRAM_TIMING == 1
+  // Read TIM2 high byte first. This latches the low byte.
+  start_time = (uint16_t)(TIM2_CNTRH << 8);
+  start_time |= TIM2_CNTRL;
+  programmed = 0;
+#endif // FLASH_PROGRAM_TIMING == 1
+
+  flash_prg_mode = FLASH_CR2_PRG;
   blocks = 0;
   while (blocks < maxblocks ) {
     // In this application the main code area is always 249 blocks of 128
@@ -389,12 +437,14 @@ void copy_I2C_EEPROM_to_Flash(uint8_t maxblocks)
     // Note: This routine is only run to replace the code in Flash.
     
     ram_ptr = &uip_buf[0]; // Set ram_ptr to the start of the uip_buf
+#if I2C_STREAM_READ == 0
     // Enable sequential read from the I2C  EEPROM.
     // Read addressing sequence: Send Write Control byte, send Byte address,
     // send Read Control Byte
     I2C_control(eeprom_num_write);     // Write control byte to establish address
     I2C_byte_address(eeprom_index, 2); // Byte address of first byte
     I2C_control(eeprom_num_read);      // Read control byte
+#endif // I2C_STREAM_READ == 0
     
     // Copy 128 bytes from I2C EEPROM to RAM
     {
@@ -404,13 +454,54 @@ void copy_I2C_EEPROM_to_Flash(uint8_t maxblocks)
 	ram_ptr++;
       }
     }
+#if I2C_STREAM_READ == 1
+    *ram_ptr = I2C_read_byte(0); // The sequential read continues
+#else // I2C_STREAM_READ == 0
     *ram_ptr = I2C_read_byte(1); // Final read with I2C_last_flag set
+#endif // I2C_STREAM_READ == 1
 
     // Copy data from RAM to Flash
     ram_ptr = &uip_buf[0]; // Reset the ram_ptr to the start of the uip_buf
+#if FLASH_FAST_PROGRAM == 1
+    // If the Flash block is already erased (all 0x00) it does not need to
+    // be erased again and can be written with fast block programming.
+    {
+      uint8_t i;
+      flash_prg_mode = FLASH_CR2_FPRG;
+      for (i=0; i<128; i++) {
+        if (flash_ptr[i] != 0) {
+          flash_prg_mode = FLASH_CR2_PRG;
+          break;
+        }
+      }
+    }
+#endif // FLASH_FAST_PROGRAM == 1
+#if FLASH_SKIP_IDENTICAL == 1
+    // Compare the block with the current Flash content. If they are the same
+    // just advance the flash_ptr to the next block instead of programming it.
+    {
+      uint8_t i;
+      for (i=0; i<128; i++) {
+        if (ram_ptr[i] != flash_ptr[i]) break;
+      }
+      if (i == 128) flash_ptr += 128;
+      else {
+        copy_RAM_to_Flash(); // As part of the copy the flash_ptr will be
+                             // incremented to the start of the next 128
+                             // byte block.
+#if FLASH_PROGRAM_TIMING == 1
+        programmed++;
+#endif // FLASH_PROGRAM_TIMING == 1
+      }
+    }
+#else // FLASH_SKIP_IDENTICAL == 0
     copy_RAM_to_Flash(); // As part of the copy the flash_ptr will be
                          // incremented to the start of the next 128 byte
                          // block.
+#if FLASH_PROGRAM_TIMING == 1
+    programmed++;
+#endif // FLASH_PROGRAM_TIMING == 1
+#endif // FLASH_SKIP_IDENTICAL == 1
     eeprom_index += 128; // Increment the eeprom_index to the start of the
                          // next block.
     blocks++;
@@ -436,13 +527,42 @@ void copy_I2C_EEPROM_to_Flash(uint8_t maxblocks)
   // segment from RAM to Flash. Then, we just wait for an IWDG to reboot the
   // STM8.
   ram_ptr = &uip_buf[0]; // Set ram_ptr to the start of the uip_buf
+  flash_prg_mode = FLASH_CR2_PRG;
   
+#if FLASH_PROGRAM_TIMING == 1
+  // Store the main program area timing in I2C EEPROM Region 1 so that it
+  // can be reported after the reboot. The I2C functions are still usable
+  // here as the flash_update segment has not been over-written yet.
+  {
+    uint16_t elapsed;
+    elapsed = (uint16_t)(TIM2_CNTRH << 8);
+    elapsed |= TIM2_CNTRL;
+    elapsed -= start_time;
+#if I2C_STREAM_READ == 1
+    I2C_read_byte(1); // End the sequential read with a NACK
+#endif // I2C_STREAM_READ == 1
+    I2C_stop();
+    I2C_control(I2C_EEPROM_R1_WRITE);
+    I2C_byte_address(I2C_EEPROM_R1_FLASH_TIMING, 2);
+    I2C_write_byte((uint8_t)(elapsed >> 8));
+    I2C_write_byte((uint8_t)elapsed);
+    I2C_write_byte(programmed);
+    I2C_stop(); // Start the EEPROM internal write cycle
+    // wait_timer() is not in the flash_update segment, so poll the I2C
+    // EEPROM until it ACKs to detect the end of the write cycle.
+    while (I2C_control(I2C_EEPROM_R1_WRITE)) I2C_stop();
+    I2C_stop();
+  }
+#endif // FLASH_PROGRAM_TIMING == 1
+
+#if I2C_STREAM_READ == 0 || FLASH_PROGRAM_TIMING == 1
   // Enable sequential read from the I2C EEPROM.
   // Read addressing sequence: Send Write Control byte, send Byte address,
   // send Read Control Byte
   I2C_control(eeprom_num_write);     // Write control byte to establish address
   I2C_byte_address(eeprom_index, 2); // Byte address of first byte
   I2C_control(eeprom_num_read);      // Read control byte
+#endif // I2C_STREAM_READ == 0 || FLASH_PROGRAM_TIMING == 1
   
   {
     uint16_t j;
@@ -528,8 +648,17 @@ void copy_RAM_to_Flash(void)
   // written in 6ms. Note that the STM8 hardware design will stall program
   // execution while the Flash write completes, so there is no need for the
   // code to have a wait function or to poll for completion of the write.
+#if FLASH_FAST_PROGRAM == 1
+  // flash_prg_mode is set by the caller to FLASH_CR2_PRG for a standard
+  // block program, or to FLASH_CR2_FPRG for a fast block program of a block
+  // that is already erased. The FLASH_NCR2 complement bits are in the same
+  // positions.
+  FLASH_CR2 |= flash_prg_mode;
+  FLASH_NCR2 &= (uint8_t)(~flash_prg_mode);
+#else // FLASH_FAST_PROGRAM == 0
   FLASH_CR2 |= FLASH_CR2_PRG;
   FLASH_NCR2 &= (uint8_t)(~FLASH_NCR2_NPRG);
+#endif // FLASH_FAST_PROGRAM == 1
 
   // Copy 128 bytes from RAM to Flash
   for (i=0; i<128; i++) {
@@ -594,7 +723,7 @@ void I2C_reset(void)
   SCL_high(); // Make sure SCL is high (float)
   for (i=0; i<10; i++) {
     SCL_low();
-    for (nop_cnt=0; nop_cnt<10; nop_cnt++) nop(); // Wait 5us
+    I2C_DELAY(); // Wait 5us
     SCL_high();
   }
   SDA_low(); // Start condition
@@ -621,13 +750,95 @@ void copy_I2C_EEPROM_bytes_to_RAM(uint8_t *destination,
 
   prep_read(control_write, control_read, start_address, addr_size);
   for (i=0; i<(num_bytes-1); i++) {
+#if I2C_STREAM_READ == 1
+    *destination = I2C_stream_read();
+#else // I2C_STREAM_READ == 0
     *destination = I2C_read_byte(0);
+#endif // I2C_STREAM_READ == 1
     destination++;
   }
   *destination = I2C_read_byte(1);
 }
 
 
+#if I2C_STREAM_READ == 1
+// I2C EEPROM stream read
+// A stream keeps the I2C EEPROM in sequential read mode so that any number
+// of bytes can be read following a single address phase:
+//   I2C_stream_open(control_write, control_read, start_address)
+//   I2C_stream_read() for each byte
+//   I2C_stream_close()
+// No other I2C device may be accessed while a stream is open.
+//
+// I2C_stream_read() performs the same bus sequence as I2C_read_byte(0) with
+// the same 5us bus timing, but the bit loop is unrolled and the SCL / SDA
+// pin operations are done inline rather than through SCL_high(),
+// SCL_low(), etc. This removes about 20 function calls per byte. The
+// functions are not in the flash_update segment and cannot be used by
+// copy_I2C_EEPROM_to_Flash().
+
+// Wait 5us (or the Fast-mode wait, see I2C_DELAY())
+#define I2C_WAIT() I2C_DELAY()
+
+// Clock one data bit in from the slave. Equivalent to SCL_high(), read SDA,
+// SCL_low() and a 5us wait.
+#define I2C_READ_BIT(mask) \
+  PE_DDR &= (uint8_t)~0x08; \
+  I2C_WAIT(); \
+  if (PG_IDR & 0x01) I2C_data_field |= (mask); \
+  PE_DDR |= (uint8_t)0x08; \
+  I2C_WAIT()
+
+
+void I2C_stream_open(uint8_t control_write,
+                     uint8_t control_read,
+                     uint16_t start_address)
+{
+  // Start a sequential read from the I2C EEPROM at start_address
+  prep_read(control_write, control_read, start_address, 2);
+}
+
+
+uint8_t I2C_stream_read(void)
+{
+  // Read the next byte of the stream and ACK it so that the I2C EEPROM
+  // continues the sequential read.
+  uint8_t I2C_data_field;
+  int nop_cnt;
+  
+  I2C_data_field = 0;
+  I2C_READ_BIT(0x80);
+  I2C_READ_BIT(0x40);
+  I2C_READ_BIT(0x20);
+  I2C_READ_BIT(0x10);
+  I2C_READ_BIT(0x08);
+  I2C_READ_BIT(0x04);
+  I2C_READ_BIT(0x02);
+  I2C_READ_BIT(0x01);
+  
+  // ACK
+  PG_DDR |= (uint8_t)0x01;  // Drive SDA low
+  I2C_WAIT();
+  PE_DDR &= (uint8_t)~0x08; // Float SCL high
+  I2C_WAIT();
+  PE_DDR |= (uint8_t)0x08;  // Drive SCL low
+  PG_DDR &= (uint8_t)~0x01; // Float SDA high
+  I2C_WAIT();
+  
+  return I2C_data_field;
+}
+
+
+void I2C_stream_close(void)
+{
+  // End the sequential read. The I2C EEPROM has already started sending the
+  // next byte, so that byte is clocked in and discarded with a NACK,
+  // followed by the STOP condition.
+  I2C_read_byte(1);
+}
+#endif // I2C_STREAM_READ == 1
+
+
 /*
 void copy_I2C_EEPROM_words_to_RAM(uint16_t *destination,
                            uint8_t num_words,
@@ -656,6 +867,27 @@ void copy_I2C_EEPROM_words_to_RAM(uint16_t *destination,
 */
 
 
+void I2C_ack_poll(uint8_t control_write)
+{
+  // Wait for the I2C EEPROM internal write cycle started by I2C_stop() to
+  // complete. The I2C EEPROM will not ACK its Control Byte while the write
+  // cycle is in progress, so the Control Byte is re-sent until it is ACKed.
+  // The retry limit covers well over the 5ms maximum write cycle time. If
+  // the I2C EEPROM never ACKs the caller's verify step will catch it.
+#if I2C_ACK_POLL == 1
+  uint8_t i;
+  for (i=0; i<50; i++) {
+    if (I2C_control(control_write) == 0) break;
+    I2C_stop();
+    wait_timer(100); // Wait 100us
+  }
+  I2C_stop();
+#else // I2C_ACK_POLL == 0
+  wait_timer(5000); // Wait 5ms
+#endif // I2C_ACK_POLL == 1
+}
+
+
 void copy_STM8_bytes_to_I2C_EEPROM(uint8_t *source,
                            uint8_t num_bytes,
                            uint8_t control_write,
@@ -675,7 +907,7 @@ void copy_STM8_bytes_to_I2C_EEPROM(uint8_t *source,
     source++;
   }
   I2C_stop(); // Start the EEPROM internal write cycle
-  wait_timer(5000); // Wait 5ms
+  I2C_ack_poll(control_write); // Wait for the write cycle to complete
 }
 
 #endif // I2C_SUPPORT == 1
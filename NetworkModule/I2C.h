@@ -62,6 +62,7 @@ void SDA_low(void);
 void I2C_transmit_byte(uint8_t I2C_transmit_data);
 uint8_t Read_Slave_NACKACK(void);
 void I2C_stop(void);
+void I2C_ack_poll(uint8_t control_write);
 void I2C_reset(void);
 void copy_I2C_EEPROM_to_Flash(uint8_t maxblocks);
 void copy_RAM_to_Flash(void);
@@ -71,6 +72,11 @@ void copy_I2C_EEPROM_bytes_to_RAM(uint8_t *destination,
                            uint8_t control_read,
                            uint16_t start_address,
                            uint8_t addr_size);
+void I2C_stream_open(uint8_t control_write,
+                     uint8_t control_read,
+                     uint16_t start_address);
+uint8_t I2C_stream_read(void);
+void I2C_stream_close(void);
 //void copy_I2C_EEPROM_words_to_RAM(uint16_t *destination,
 //                           uint8_t num_words,
 //                           uint8_t control_write,
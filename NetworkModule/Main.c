@@ -209,8 +209,45 @@ uint8_t stack_limit2;
 // The "debug_bytes" EEPROM storage is used to retain specific debug information
 // across reboots and to make that information available for user viewing.
 // The RAM debug values provide temporary storage of the values as an aid in
-// reducing the number of EEPROM writes.
+// reducing the number of EEPROM writes. The TXERIF and RXERIF counters are
+// only counted in RAM by the ENC28J60 driver and are written to EEPROM once
+// a minute and before a reboot.
 uint8_t debug_bytes[10];
+uint32_t check_debug_ctr;     // Time counter to determine when to write the
+                              // debug_bytes to EEPROM
+
+#if UDP_LOG_SUPPORT == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+// UDP log event queue. Each event is a code and a value. The queue is
+// emptied once a second by udp_log_flush().
+struct udp_log_event {
+  uint8_t code;
+  uint16_t value;
+};
+struct udp_log_event udp_log_queue[UDP_LOG_EVENTS];
+uint8_t udp_log_count;              // Events in the queue
+uint8_t udp_log_dropped;            // Events lost since the last datagram
+uip_ipaddr_t udp_log_addr;          // Host the UDP log is sent to. Set by
+                                    // each UDP status request.
+uint32_t check_udp_log_ctr;         // Time counter for the once a second
+                                    // datagram
+uint16_t loop_start_ms;             // ms_counter at the start of the main
+                                    // loop pass
+uint16_t loop_max_ms;               // Longest main loop pass this second
+const char * const udp_log_name[] = { "mqtt", "rxerif", "txrts", "stack", "loop" };
+#endif // UDP_LOG_SUPPORT == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+
+#if PERIODIC_ROUND_ROBIN == 1
+uint8_t periodic_next;              // Connection periodic_service() starts
+                                    // the next sweep with
+#endif // PERIODIC_ROUND_ROBIN == 1
+#if BOOT_PROFILE == 1
+uint16_t boot_time[BOOT_STAGES];    // ms since clock_init() at the end of
+                                    // each boot stage
+#endif // BOOT_PROFILE == 1
+#if FAST_BOOT == 1
+uint8_t sensor_init_pending;        // Sensor discovery not yet run
+uint16_t sensor_init_ms;            // ms_counter when the main loop started
+#endif // FAST_BOOT == 1
 //---------------------------------------------------------------------------//
 
 
@@ -234,7 +271,9 @@ uint16_t Pending_IO_TIMER[16];
 #if PCF8574_SUPPORT == 1
 uint16_t Pending_IO_TIMER[24];
 #endif // PCF8574_SUPPORT == 1
+#if PIN_TIMER_WHEEL == 0
 uint8_t timer_flags; // Flags to aid in timer decrementing
+#endif // PIN_TIMER_WHEEL == 0
 
 // Define pin_timers
 #if PCF8574_SUPPORT == 0
@@ -254,6 +293,21 @@ uint16_t pin_timer[24]; // The pin_timers are 14 bit timers with the 2 most
 			//   10 = 1 minute
 			//   11 = 1 hour
 #endif // PCF8574_SUPPORT == 1
+
+#if PIN_TIMER_WHEEL == 1
+// Running pin_timers. There is one pin mask per pin_timer resolution
+// (indexed by the 2 resolution bits), bit 0 is Pin 1.
+#if PCF8574_SUPPORT == 0
+uint16_t pin_timer_wheel[4];
+#endif // PCF8574_SUPPORT == 0
+#if PCF8574_SUPPORT == 1
+uint32_t pin_timer_wheel[4];
+#endif // PCF8574_SUPPORT == 1
+uint8_t pin_timer_second;     // Low byte of the second_counter at the last
+                              // 1 second tick
+uint8_t pin_timer_seconds;    // Seconds since the last 1 minute tick
+uint8_t pin_timer_minutes;    // Minutes since the last 1 hour tick
+#endif // PIN_TIMER_WHEEL == 1
 #endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
 
 
@@ -295,6 +349,19 @@ uint32_t Invert_word;                   // Invert state of pins in single 32 bit
                                         // word
 #endif // PCF8574_SUPPORT == 1 || DOMOTICZ_SUPPORT == 1
 
+#if GPIO_PORT_BATCH == 1
+uint8_t port_set_mask[NUM_PORTS];       // ODR bits to set in each port, built
+                                        // by encode_port_masks()
+uint8_t port_write_mask[NUM_PORTS];     // ODR bits of each port that are
+                                        // written by write_output_pins()
+uint8_t port_idr[NUM_PORTS];            // IDR of each port sampled by
+                                        // read_port_idr()
+#if PINOUT_OPTION_SUPPORT == 1
+uint8_t io_index[16];                   // PORT:BIT index of each IO for the
+                                        // selected Pinout Option
+#endif // PINOUT_OPTION_SUPPORT == 1
+#endif // GPIO_PORT_BATCH == 1
+
 
 
 
@@ -313,6 +380,14 @@ uint8_t mqtt_close_tcp;                 // Signals the need to close the MQTT
                                         // TCP connection
 uint8_t parse_complete;                 // Signals completion of POST parsing
 uint8_t mqtt_parse_complete;            // Signals completion of MQTT parsing
+#if COMMAND_RATE_LIMIT == 1
+uint8_t command_rate_ticks;             // 100ms ticks since the last refill
+#if BUILD_SUPPORT == MQTT_BUILD
+uint8_t mqtt_rate_tokens;               // Tokens left in the MQTT bucket
+uint8_t mqtt_parse_deferred;            // An MQTT command is waiting for a
+                                        // token to be applied
+#endif // BUILD_SUPPORT == MQTT_BUILD
+#endif // COMMAND_RATE_LIMIT == 1
 uint8_t uart_init_complete;		// Signals completion of UART initial-
                                         // izaion. This is primarily used to
 					// allow use of debug statements in
@@ -367,6 +442,8 @@ extern uint16_t second_toggle;       // Used in developing a 1 second counter
 extern uint32_t second_counter;      // Counts seconds since boot
 extern uint16_t ms_counter;          // Free running ms counter
 
+extern uint16_t uip_slen;            // Length of the pending uip_buf output
+
 
 extern uint8_t OctetArray[14];  // Used in emb_itoa conversions and to
                                 // transfer short strings globally
@@ -416,6 +493,11 @@ extern uint8_t connack_received;      // Used to communicate CONNECT CONNACK
                                       // received from mqtt.c to main.c
 extern uint8_t suback_received;       // Used to communicate SUBSCRIBE SUBACK
                                       // received from mqtt.c to main.c
+#if MQTT_PERSISTENT_SESSION == 1
+extern uint8_t connack_session_present; // Used to communicate the CONNACK
+                                      // Session Present flag from mqtt.c to
+				      // main.c
+#endif // MQTT_PERSISTENT_SESSION == 1
 				      
 uint8_t connect_flags;                // Used in MQTT setup
 uint16_t mqtt_keep_alive;             // Ping interval
@@ -439,13 +521,32 @@ struct uip_conn *mqtt_conn;           // mqtt_conn points to the connection
 				      // structure table while setting up MQTT
 				      // operations.
 uint8_t mqtt_restart_step;            // Step tracker for restarting MQTT
+#if MQTT_RECONNECT_BACKOFF == 1
+uint8_t mqtt_backoff_count;           // Failed connection attempts since
+                                      // the last MQTT_START_COMPLETE
+uint16_t mqtt_backoff_lfsr;           // Pseudo random reconnect jitter
+uint32_t mqtt_backoff_until;          // second_counter value at which the
+                                      // next connection attempt starts
+#endif // MQTT_RECONNECT_BACKOFF == 1
 
 static const unsigned char devicetype[] = "NetworkModule/"; // Used in
                                       // building topic and client id names
 uint8_t auto_discovery;               // Used in the Auto Discovery state machine
+#if MQTT_TOPIC_PREFIX == 1
+char topic_prefix[TOPIC_PREFIX_SIZE]; // "NetworkModule/<devicename>" built
+                                      // once per MQTT connection
+uint8_t topic_prefix_len;             // strlen() of topic_prefix
+#endif // MQTT_TOPIC_PREFIX == 1
 uint8_t auto_discovery_step;          // Used in the Auto Discovery state machine
 uint8_t pin_ptr;                      // Used in the Auto Discovery state machine
 uint8_t sensor_number;                // Used in the Auto Discovery state machine
+#if HOME_ASSISTANT_SUPPORT == 1 && MQTT_DISCOVERY_FINGERPRINT == 1
+char discovery_fingerprint[5];        // Fingerprint of the current Auto
+                                      // Discovery config as 4 hex characters
+uint8_t discovery_match;              // Set by publish_callback when the
+                                      // fingerprint retained on the Broker
+				      // matches discovery_fingerprint
+#endif // HOME_ASSISTANT_SUPPORT == 1 && MQTT_DISCOVERY_FINGERPRINT == 1
 
 #if PCF8574_SUPPORT == 0 && DOMOTICZ_SUPPORT == 0
 uint16_t MQTT_transmit;               // Used to force a publish_pinstate
@@ -454,6 +555,24 @@ uint16_t MQTT_transmit;               // Used to force a publish_pinstate
 uint32_t MQTT_transmit;               // Used to force a publish_pinstate
 #endif // PCF8574_SUPPORT == 1 || DOMOTICZ_SUPPORT == 1
 
+#if MQTT_QOS1_PINSTATE == 1
+struct pinstate_pending pinstate_pending[PINSTATE_PENDING_SIZE];
+                                      // QOS 1 pin state PUBLISH messages
+				      // awaiting a PUBACK
+uint8_t pinstate_pending_count;       // Number of pinstate_pending entries
+                                      // in use
+#endif // MQTT_QOS1_PINSTATE == 1
+
+#if MQTT_DIRECT_PUBLISH == 1
+struct direct_publish direct_publish[DIRECT_PUBLISH_SIZE];
+                                      // Pin state PUBLISH messages waiting
+				      // to be packed into the uip_buf
+uint8_t direct_publish_head;          // Index of the oldest direct_publish
+                                      // entry
+uint8_t direct_publish_count;         // Number of direct_publish entries
+                                      // waiting
+#endif // MQTT_DIRECT_PUBLISH == 1
+
 
 // Define globals to communicate the idx and nvalue values from the
 // mqtt_sync() function to the publish_callback() function.
@@ -487,11 +606,23 @@ uint8_t MQTT_not_OK_counter;     // Counts MQTT != OK events in the
                                  // mqtt_sanity_check() function
 uint8_t MQTT_broker_dis_counter; // Counts broker disconnect events in
                                  // the mqtt_sanity_check() function
+#if UIP_CONN_RESERVE == 1
+uint8_t syn_drop_counter;        // Counts SYNs refused because no connection
+                                 // slot was available
+#endif // UIP_CONN_RESERVE == 1
 
 #if DS18B20_SUPPORT == 1
 // DS18B20 variables
 uint32_t check_DS18B20_ctr;      // Counter used to trigger temperature
                                  // measurements
+#if DS18B20_INCREMENTAL == 1
+extern uint8_t DS18B20_step;     // Step of the temperature read in progress
+#endif // DS18B20_INCREMENTAL == 1
+#if SENSOR_DEADBAND == 1 && BUILD_SUPPORT == MQTT_BUILD
+extern uint8_t DS18B20_scratch[5][2]; // Temperature measurements
+int16_t DS18B20_published[5];    // Temperature measurements last published
+uint32_t DS18B20_publish_time;   // second_counter at the last publish
+#endif // SENSOR_DEADBAND == 1 && BUILD_SUPPORT == MQTT_BUILD
 int8_t send_mqtt_temperature;    // Indicates if a new temperature measurement
                                  // is pending transmit on MQTT. In this
 				 // application there are 5 sensors, so setting
@@ -520,8 +651,16 @@ struct bme280_dev dev;        // Structure to store the device calibration
 // int8_t rslt;		      // Variable to report BME280 function results.
 uint32_t check_BME280_ctr;    // Time counter to determine when to collect the
                               // BME280 measurements.
+#if BME280_ASYNC_MEASURE == 1
+uint8_t BME280_measuring;     // 1 while a measurement started by
+                              // task_BME280() is running in the BME280
+#endif // BME280_ASYNC_MEASURE == 1
 struct bme280_data comp_data; // Structure to collect the compensated
                               // pressure, temperature and humidity data.
+#if SENSOR_DEADBAND == 1 && BUILD_SUPPORT == MQTT_BUILD
+struct bme280_data BME280_published; // Measurements last published
+uint32_t BME280_publish_time; // second_counter at the last publish
+#endif // SENSOR_DEADBAND == 1 && BUILD_SUPPORT == MQTT_BUILD
 uint8_t BME280_found;         // Used to indicate that that a BME280 device
                               // was found on the I2C bus.
 int8_t send_mqtt_BME280;      // Indicates if new BME280 sensor measurements
@@ -543,6 +682,70 @@ extern int32_t comp_data_humidity;    // Compensated humidity
 #endif // BME280_SUPPORT == 1
 
 
+#if PIN_CAPTURE_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD
+uint16_t pin_pulse;           // Input pins with a captured edge not yet
+                              // handled by publish_outbound()
+#endif // PIN_CAPTURE_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD
+#if LINKED_FAST_PATH == 1 && PIN_CAPTURE_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD && LINKED_SUPPORT == 1
+extern uint8_t linked_fast_pins; // Linked pairs toggled by the Port
+                              // interrupt (see Gpio.c)
+#endif // LINKED_FAST_PATH == 1 && PIN_CAPTURE_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD && LINKED_SUPPORT == 1
+
+
+#if MQTT_BATCH_PUBLISH == 1 && BUILD_SUPPORT == MQTT_BUILD
+uint8_t publish_scan_pin;     // Pin index where publish_outbound() resumes
+                              // its scan. 23 or more starts at the top pin.
+#endif // MQTT_BATCH_PUBLISH == 1 && BUILD_SUPPORT == MQTT_BUILD
+
+
+#if STACK_MONITOR == 1
+// Stack and buffer peak variables
+#define STACK_BOTTOM	0x0600 // Lowest stack address (see Stack overflow
+                               // detection above)
+#define STACK_TOP	0x07ff // Stack pointer initial value
+#define STACK_PAINT	0xc5   // Pattern painted on the unused stack
+uint16_t stack_peak;          // Most stack bytes used since boot
+uint16_t uip_buf_peak;        // Largest frame held in the uip_buf
+uint16_t mqtt_sendbuf_peak;   // Most mqtt_sendbuf message data in use
+#if BUILD_SUPPORT == MQTT_BUILD
+uint32_t check_stack_ctr;     // Time counter to determine when to publish
+                              // the peaks.
+uint8_t send_mqtt_stack;      // Indicates the peaks are pending transmit on
+                              // MQTT
+#endif // BUILD_SUPPORT == MQTT_BUILD
+#endif // STACK_MONITOR == 1
+
+
+#if DEVELOPMENT_TOOLS == 1 && BENCHMARK_SUPPORT == 1
+uint8_t bench_request;        // Set by the /d4 URL command to run the
+                              // benchmarks on the next main loop pass
+uint32_t bench_result[BENCH_NUM]; // Benchmark results in us (see BENCH_
+                              // defines in main.h)
+#endif // DEVELOPMENT_TOOLS == 1 && BENCHMARK_SUPPORT == 1
+
+
+#if PROFILE_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD
+// Profiling variables
+uint32_t check_profile_ctr;   // Time counter to determine when to publish
+                              // the profiling statistics.
+int8_t send_mqtt_profile;     // Indicates if profiling statistics are
+                              // pending transmit on MQTT. Setting to
+			      // PROF_NUM_STAGES - 1 will cause all stages to
+			      // transmit. -1 indicates nothing to transmit.
+#endif // PROFILE_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD
+
+
+#if PAGE_STATISTICS == 1 && BUILD_SUPPORT == MQTT_BUILD
+// Page statistics variables
+uint32_t check_pagestats_ctr; // Time counter to determine when to publish
+                              // the page statistics.
+int8_t send_mqtt_pagestats;   // Indicates if page statistics are pending
+                              // transmit on MQTT. Setting to PSTAT_NUM - 1
+			      // will cause all webpage groups to transmit.
+			      // -1 indicates nothing to transmit.
+#endif // PAGE_STATISTICS == 1 && BUILD_SUPPORT == MQTT_BUILD
+
+
 #if INA226_SUPPORT == 1;
 // INA226 variables
 extern int32_t voltage;       // Voltage value (x1000) reported by the INA226
@@ -551,10 +754,10 @@ extern int32_t power;         // Power value (x1000) reported by the INA226
 #endif // INA226_SUPPORT == 1;
 
 
-#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
+#if SREC_UPLOAD == 1
 extern uint8_t upgrade_failcode;     // Failure codes for Flash upgrade
                                      // process
-#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
+#endif // SREC_UPLOAD == 1
 
 
 #if OB_EEPROM_SUPPORT == 1
@@ -582,6 +785,29 @@ uint32_t login_update_timer;                  // Timer to update Login timers
 #endif // LOGIN_SUPPORT == 1
 
 
+#if TASK_SCHEDULER == 1
+// Task list for the main loop scheduler. Each task is run at the interval
+// (in ms) shown. The DS18B20, BME280 and login tasks check their own longer
+// intervals using the second_counter.
+const struct sched_task task_table[] = {
+  { periodic_service,      20 },
+#if BUILD_SUPPORT == MQTT_BUILD
+  { task_mqtt_timer,       50 },
+#endif // BUILD_SUPPORT == MQTT_BUILD
+  { task_100ms,           100 },
+  { task_runtime,           5 },
+  { task_arp,           10000 },
+#if DS18B20_SUPPORT == 1
+  { task_DS18B20,        1000 },
+#endif // DS18B20_SUPPORT == 1
+#if BME280_SUPPORT == 1
+  { task_BME280,         1000 },
+#endif // BME280_SUPPORT == 1
+#if LOGIN_SUPPORT == 1
+  { task_login,          1000 },
+#endif // LOGIN_SUPPORT == 1
+};
+#endif // TASK_SCHEDULER == 1
 
 
 
@@ -589,7 +815,7 @@ uint32_t login_update_timer;                  // Timer to update Login timers
 int main(void)
 {
   uip_ipaddr_t IpAddr;
-  extern uint16_t uip_slen;
+  uint8_t rx_frame_count;
 
   // Initialize and enable clocks and timers. This must be done first to let
   // the processor clock stabilize.
@@ -598,8 +824,14 @@ int main(void)
   // start running for a brief number of milliseconds (2 or 3 times!) before
   // reset is released. I placed a wait timer here to absorb that activity so
   // that no other code runs until the device is actually released from reset.
+#if FAST_BOOT == 0
   wait_timer(50000); // Wait 50ms
   wait_timer(50000); // Wait 50ms
+#endif // FAST_BOOT == 0
+#if FAST_BOOT == 1
+  // A single shorter wait still covers the brief runs seen with the ST-LINK
+  wait_timer(20000); // Wait 20ms
+#endif // FAST_BOOT == 1
 
   parse_complete = 1; // parse_complete is set to 1 so that the first time
                       // check_runtime_changes is called it will sync the
@@ -622,10 +854,18 @@ int main(void)
 #if BUILD_SUPPORT == MQTT_BUILD
   // Initialize MQTT variables
   mqtt_parse_complete = 0;
+#if COMMAND_RATE_LIMIT == 1
+  mqtt_rate_tokens = COMMAND_RATE_BURST;
+  mqtt_parse_deferred = 0;
+#endif // COMMAND_RATE_LIMIT == 1
   mqtt_close_tcp = 0;
   mqtt_enabled = 0;                      // Initialized to 'disabled'
   mqtt_start = MQTT_START_TCP_CONNECT;	 // Tracks the MQTT startup steps
-  mqtt_keep_alive = 60;                  // Ping interval in seconds
+  mqtt_keep_alive = MQTT_KEEP_ALIVE;     // Ping interval in seconds
+#if MQTT_RECONNECT_BACKOFF == 1
+  mqtt_backoff_count = 0;                // No failed connection attempts
+  mqtt_backoff_lfsr = 0;                 // Seeded on first use
+#endif // MQTT_RECONNECT_BACKOFF == 1
   mqtt_start_ctr1 = 0;			 // Tracks time for the MQTT startup
                                          // steps
   mqtt_sanity_ctr = 0;			 // Tracks time for the MQTT sanity
@@ -642,6 +882,11 @@ int main(void)
   // TCP connection TIME_WAIT issue in the MQTT server when reboot occurs.
   // Note: This is only needed for MQTT builds but is included in all builds
   // to simplify code.
+#if EEPROM_BATCH_COMMIT == 1
+  // The port is only used for the MQTT connection, so the EEPROM write is
+  // skipped if MQTT is not enabled.
+  if (mqtt_enabled)
+#endif // EEPROM_BATCH_COMMIT == 1
   {
     uint8_t i;
     unlock_eeprom();
@@ -668,10 +913,21 @@ int main(void)
                                          // counter
   MQTT_broker_dis_counter = 0;           // Initialize the MQTT broker
                                          // disconnect event counter
+#if UIP_CONN_RESERVE == 1
+  syn_drop_counter = 0;                  // Initialize the refused SYN counter
+#endif // UIP_CONN_RESERVE == 1
 
 
 #if BUILD_SUPPORT == BROWSER_ONLY_BUILD
+#if PIN_TIMER_WHEEL == 0
   timer_flags = 0x07; // Set all timer_flags to 1 to support IO_TIMER decrementing
+#endif // PIN_TIMER_WHEEL == 0
+#if PIN_TIMER_WHEEL == 1
+  memset(pin_timer_wheel, 0, sizeof(pin_timer_wheel));
+  pin_timer_second = (uint8_t)second_counter;
+  pin_timer_seconds = 0;
+  pin_timer_minutes = 0;
+#endif // PIN_TIMER_WHEEL == 1
 #endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
 
 
@@ -694,6 +950,7 @@ int main(void)
 			   
   // Apply the EEPROM settings to runtime variables
   apply_EEPROM_settings();
+  BOOT_MARK(BOOT_EEPROM);
 			   
   // Initialize and enable STM8 gpio pins. This must be done before attempting
   // access to the PCF8574.
@@ -707,23 +964,18 @@ int main(void)
   // Initialize pins and IO trackers for the first time after validation of
   // EEPROM contents. This operates on STM8 and PCF8574 pins.
   initialize_pins();
-  
-#if BME280_SUPPORT == 1
-  // Initialize the BME280
-  BME280_found = 0;
-//  rslt = bme280_init(&dev);
-//  if (rslt == BME280_OK) {
-  if (bme280_init(&dev) == BME280_OK) {
-    BME280_found = 1;
-  }
-#endif // BME280_SUPPORT == 1
-
+  BOOT_MARK(BOOT_PINS);
 
   // Initialize the TRANSMIT counter
   TRANSMIT_counter = 0;
   
   // Restore the saved debug statistics
   restore_eeprom_debug_bytes();
+  check_debug_ctr = second_counter;
+#if UDP_LOG_SUPPORT == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+  check_udp_log_ctr = second_counter;
+  loop_start_ms = ms_counter;
+#endif // UDP_LOG_SUPPORT == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
 
 
 
@@ -796,23 +1048,6 @@ int main(void)
 
 
 
-#if DS18B20_SUPPORT == 1
-  init_DS18B20();          // Initialize DS18B20 sensors
-  // Initialize DS18B20 control variables used in main.c 
-  if (stored_config_settings & 0x08) {
-    // Find all devices
-    FindDevices();
-    // Iniialize DS18B20 timer
-    check_DS18B20_ctr = second_counter;
-    // Initialize DS18B20 sensor add/delete check counter
-    // Collect initial temperature
-    get_temperature();
-    // Iniialize DS18B20 transmit control variable
-    send_mqtt_temperature = -1; // Indicates nothing to send on MQTT yet.
-  }
-#endif // DS18B20_SUPPORT == 1
-
-
 //#if BME280_SUPPORT == 1
 //  // Initialize the BME280
 //  BME280_found = 0;
@@ -837,35 +1072,6 @@ int main(void)
 //#endif // BME280_SUPPORT == 1
 
 
-#if BME280_SUPPORT == 1
-  if (BME280_found == 1) {
-    if (stored_config_settings & 0x20) {
-      // If a BME280 sensor was found and the config_settings show the sensor
-      // is enabled then collect the sensor data. This measurement at startup
-      // is needed so that sensor data is available for display when the
-      // IOControl page is shown at boot time.
-      stream_sensor_data_forced_mode(&dev, &comp_data);
-      send_mqtt_BME280 = 2; // Indicates we should send BME280 data as part of
-                        // boot. Even though only 1 BME280 is supported
-			// send_MQTT_BME280 is set to "2" so that all three
-			// sensors (Temp, Humidity, Pressure) within the
-			// BME280 are sent (2, 1, 0).
-      check_BME280_ctr = second_counter;
-    }
-  }
-  if (BME280_found == 0) {
-    // If BME280 sensor was not found then then force the BME280 Enable bit off.
-    // This will help reduce confusion on the part of the user that may think
-    // they can enable BME280 support on the Config Page but they have not
-    // connected a BME280 sensor.
-    Pending_config_settings &= (uint8_t)(~0x20);
-    // Note: parse_complete was set to 1 duriing main variable initialization.
-    // This will cause any change to the Pending_config_settings to update the
-    // EEPROM if needed.
-  }
-#endif // BME280_SUPPORT == 1
-
-
 #if PCF8574_SUPPORT == 1
   // Initialize the PCF8574 and update the stored_options1 byte to reflect the
   // presence or absence of the PCF8574
@@ -889,14 +1095,14 @@ int main(void)
 #endif // PCF8574_SUPPORT == 1
 
 
-#if INA226_SUPPORT == 1
-  // Initialize all INA226 devices
-  ina226_init_all();
-  //   Calibrate all INA226 devices
-  ina226_calibrate_all();
-  //   Configure all INA226 devices
-  ina226_configure_all();
-#endif // INA226_SUPPORT == 1
+#if FAST_BOOT == 0
+  sensor_init();
+#endif // FAST_BOOT == 0
+#if FAST_BOOT == 1
+  // Sensor discovery is left to the main loop so the web and MQTT
+  // interfaces are reachable sooner after a power up.
+  sensor_init_pending = 1;
+#endif // FAST_BOOT == 1
 
 
 #if LOGIN_SUPPORT == 1
@@ -922,6 +1128,24 @@ int main(void)
   // content).
   stack_limit1 = 0xaa;
   stack_limit2 = 0x55;
+#if STACK_MONITOR == 1
+  // Paint the stack below the main() frame so that stack_scan() can find
+  // how deep the stack has grown. A few bytes are left unpainted as a
+  // margin below the current stack pointer.
+  {
+    uint8_t *pStack;
+    for (pStack = (uint8_t *)STACK_BOTTOM; pStack < (uint8_t *)&IpAddr - 8; pStack++) {
+      *pStack = STACK_PAINT;
+    }
+  }
+  stack_peak = 0;
+  uip_buf_peak = 0;
+  mqtt_sendbuf_peak = 0;
+#if BUILD_SUPPORT == MQTT_BUILD
+  check_stack_ctr = second_counter;
+  send_mqtt_stack = 0;
+#endif // BUILD_SUPPORT == MQTT_BUILD
+#endif // STACK_MONITOR == 1
   // Initialize debug[2] to reflect the stack overflow condition stored in
   // EEPROM.
 
@@ -980,6 +1204,23 @@ int main(void)
 #endif // OB_EEPROM_SUPPORT == 1
 
 
+#if OB_EEPROM_SUPPORT == 1 && FLASH_PROGRAM_TIMING == 1 && DEBUG_SUPPORT == 15
+  // Report the timing of the last Flash programming by
+  // copy_I2C_EEPROM_to_Flash()
+  if (eeprom_detect == 1) {
+    uint8_t timing[3];
+    copy_I2C_EEPROM_bytes_to_RAM(&timing[0], 3, I2C_EEPROM_R1_WRITE, I2C_EEPROM_R1_READ, I2C_EEPROM_R1_FLASH_TIMING, 2);
+    UARTPrintf("Flash program time (ms): ");
+    emb_itoa((((uint16_t)timing[0] << 8) | timing[1]), OctetArray, 10, 5);
+    UARTPrintf(OctetArray);
+    UARTPrintf("  Blocks programmed: ");
+    emb_itoa(timing[2], OctetArray, 10, 3);
+    UARTPrintf(OctetArray);
+    UARTPrintf("\r\n");
+  }
+#endif // OB_EEPROM_SUPPORT == 1 && FLASH_PROGRAM_TIMING == 1 && DEBUG_SUPPORT == 15
+
+
 #if BUILD_SUPPORT == CODE_UPLOADER_BUILD
   // If a Code Uploader Build copy Flash to EEPROM Region 1. While this runs
   // with any Code Uploader boot, it is really only necessary if the Code
@@ -1023,6 +1264,40 @@ int main(void)
 #endif // HTTPD_DIAGNOSTIC_SUPPORT == 1
 
 
+#if TASK_SCHEDULER == 1
+  sched_init(task_table, (uint8_t)(sizeof(task_table) / sizeof(task_table[0])));
+#endif // TASK_SCHEDULER == 1
+
+#if LOW_POWER_IDLE == 1
+  idle_init();
+#endif // LOW_POWER_IDLE == 1
+
+#if PIN_CAPTURE_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD
+  // Enable interrupts for the Input pin capture ISRs. All interrupt sources
+  // must be configured before this point.
+  rim();
+#endif // PIN_CAPTURE_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD
+
+#if PROFILE_SUPPORT == 1
+  prof_init();
+#if BUILD_SUPPORT == MQTT_BUILD
+  check_profile_ctr = second_counter;
+  send_mqtt_profile = -1;
+#endif // BUILD_SUPPORT == MQTT_BUILD
+#endif // PROFILE_SUPPORT == 1
+
+#if PAGE_STATISTICS == 1 && BUILD_SUPPORT == MQTT_BUILD
+  check_pagestats_ctr = second_counter;
+  send_mqtt_pagestats = -1;
+#endif // PAGE_STATISTICS == 1 && BUILD_SUPPORT == MQTT_BUILD
+
+  BOOT_MARK(BOOT_NETWORK);
+#if FAST_BOOT == 1
+  timer_update();
+  sensor_init_ms = ms_counter;
+#endif // FAST_BOOT == 1
+
+
   //-------------------------------------------------------------------------//
   // MAIN LOOP
   //-------------------------------------------------------------------------//
@@ -1035,7 +1310,9 @@ int main(void)
     //   - Enc28j60Receive(uip_buf) is called to receive a single packet from
     //     the ENC28J60 and copy it to the uip_buf. Additional packets may be
     //     queued in the ENC28J60 hardware, but packets are read and
-    //     processed one at a time. When a packet is copied to the uip_buf
+    //     processed one at a time. Up to RX_DRAIN_BUDGET packets are read
+    //     and processed before the rest of the main loop runs. When a packet
+    //     is copied to the uip_buf
     //     the value uip_len is set to the size of the received data (total
     //     of LLH, IP and TCP headers plus the application data).
     //
@@ -1095,10 +1372,35 @@ int main(void)
     //
     // - If debug is enabled the update_debug_storage() function is called to
     //   store any debug information collected.
+    //
+    // - If TASK_SCHEDULER is enabled the timer driven functions above are
+    //   tasks in task_table[]. sched_run() runs the task with the nearest
+    //   deadline if it is due, so only one of them runs per pass.
 
     IWDG_KR = 0xaa; // Prevent the IWDG hardware watchdog from firing. If the
                     // processor hangs the IWDG will perform a hardware reset.
 
+#if UDP_LOG_SUPPORT == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+    // Track the longest main loop pass for the UDP log
+    {
+      uint16_t loop_ms;
+      loop_ms = (uint16_t)(ms_counter - loop_start_ms);
+      loop_start_ms = ms_counter;
+      if (loop_ms > loop_max_ms) loop_max_ms = loop_ms;
+    }
+#endif // UDP_LOG_SUPPORT == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+
+#if FAST_BOOT == 1
+    // Run the deferred sensor discovery once the main loop has been
+    // servicing the network for FAST_BOOT_DEFER ms. MQTT startup holds the
+    // CONNECT until this is done so Auto Discovery sees the sensors.
+    if (sensor_init_pending
+     && (uint16_t)(ms_counter - sensor_init_ms) >= FAST_BOOT_DEFER) {
+      sensor_init_pending = 0;
+      sensor_init();
+    }
+#endif // FAST_BOOT == 1
+
     // The ENC28J60 is set up for a receive buffer of 6KB (see ENC28J60.h).
     // The ENC28J60 buffer size should be more than enough to hold all
     // messages that are received in a burst (say from a Home Assistant
@@ -1122,9 +1424,25 @@ int main(void)
     // occupies processing and buffer memory in addition to the genuine
     // application traffic of interest.
 
-    uip_len = Enc28j60Receive(uip_buf); // Check for incoming packets
+    // Up to RX_DRAIN_BUDGET frames are pulled from the ENC28J60 and processed
+    // per pass of the main loop. Draining several frames at once keeps the
+    // ENC28J60 receive buffer from backing up during a burst (and reduces
+    // RXERIF overflows), while the budget makes sure the timers, MQTT and
+    // pin processing below still run at least once every few frames.
+    for (rx_frame_count = 0; rx_frame_count < RX_DRAIN_BUDGET; rx_frame_count++) {
+#if PROFILE_SUPPORT == 1
+      prof_begin(PROF_RECEIVE);
+#endif // PROFILE_SUPPORT == 1
+      uip_len = Enc28j60Receive(uip_buf); // Check for incoming packets
+      if (uip_len == 0) break;             // No more packets waiting
+#if STACK_MONITOR == 1
+      if (uip_len > uip_buf_peak) uip_buf_peak = uip_len;
+#endif // STACK_MONITOR == 1
+#if PROFILE_SUPPORT == 1
+      // Only frames actually received are counted
+      prof_end(PROF_RECEIVE);
+#endif // PROFILE_SUPPORT == 1
 
-    if (uip_len > 0) {
       // Removed "htons" code to reduce Flash usage. This can be done as the
       // SMT8 is "Big Endian". Keep the commented code in case the application
       // is ported to a "Little Endian" architecture.
@@ -1133,8 +1451,14 @@ int main(void)
         // This code is executed if incoming traffic is HTTP or MQTT (not ARP).
         // uip_len includes the headers, so it will be > 0 even if no TCP
         // payload.
+#if PROFILE_SUPPORT == 1
+        prof_begin(PROF_UIP_INPUT);
+#endif // PROFILE_SUPPORT == 1
         uip_input(); // Calls uip_process(UIP_DATA) to process a received
 	// packet.
+#if PROFILE_SUPPORT == 1
+        prof_end(PROF_UIP_INPUT);
+#endif // PROFILE_SUPPORT == 1
         // If the above process resulted in data that should be sent out on
 	// the network the global variable uip_len will have been set to a
 	// value > 0.
@@ -1146,6 +1470,16 @@ int main(void)
           // Enc28j60 transmit functions are called directly.
           Enc28j60Send(uip_buf, uip_len);
         }
+#if UIP_POLL_FAST_PATH == 1 && HTTPD_TX_WINDOW > 1
+        // If the packet acknowledged httpd data and left room in the
+        // transmit window send the next segment now.
+        if (uip_conn != NULL
+         && uip_conn->lport == Port_Httpd
+         && uip_conn->nseg != 0
+         && uip_conn->nseg < HTTPD_TX_WINDOW) {
+          poll_conn_now(uip_conn);
+        }
+#endif // UIP_POLL_FAST_PATH == 1 && HTTPD_TX_WINDOW > 1
       }
       // Removed "htons" code to reduce Flash usage. This can be done as the
       // SMT8 is "Big Endian". Keep the commented code in case the application
@@ -1166,6 +1500,12 @@ int main(void)
       }
     }
 
+#if ENC28J60_ASYNC_TX == 1
+    // Complete the handling of the last transmitted frame if the ENC28J60
+    // has finished sending it.
+    Enc28j60PollSend();
+#endif // ENC28J60_ASYNC_TX == 1
+
 #if BUILD_SUPPORT == MQTT_BUILD
     // Perform MQTT startup if 
     // a) MQTT is enabled
@@ -1181,6 +1521,13 @@ int main(void)
      && user_reboot_request == 0
      && user_restart_request == 0) {
       mqtt_startup();
+#if UIP_POLL_FAST_PATH == 1
+      // Send any CONNECT, SUBSCRIBE or discovery message just queued
+      if (mqtt_start > MQTT_START_QUEUE_CONNECT
+       && (mqtt_conn->tcpstateflags & UIP_TS_MASK) == UIP_ESTABLISHED) {
+        poll_conn_now(mqtt_conn);
+      }
+#endif // UIP_POLL_FAST_PATH == 1
     }
     
     // Perform MQTT sanity check if
@@ -1199,48 +1546,28 @@ int main(void)
     // Update the time keeping function
     timer_update();
 
+#if UDP_LOG_SUPPORT == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+    // Send the queued UDP log events once a second
+    if (second_counter != check_udp_log_ctr) {
+      check_udp_log_ctr = second_counter;
+      udp_log_flush();
+    }
+#endif // UDP_LOG_SUPPORT == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+
+#if DS18B20_SUPPORT == 1 && DS18B20_INCREMENTAL == 1
+    // Advance a DS18B20 temperature read by one 1-Wire step
+    if (DS18B20_step != DS_STEP_IDLE) task_DS18B20_step();
+#endif // DS18B20_SUPPORT == 1 && DS18B20_INCREMENTAL == 1
+
+#if TASK_SCHEDULER == 1
+    // Run the next scheduled task if it is due. Only one task is run per
+    // pass of the main loop so that received packets are processed between
+    // tasks. See task_table[] for the task list and intervals.
+    sched_run();
+#else // TASK_SCHEDULER == 0
 #if BUILD_SUPPORT == MQTT_BUILD
-    // If the MQTT timer expires (50ms)
-    //   And MQTT is enabled
-    //   And MQTT startup is complete
-    //     Then check for pin state change messages that need to be
-    //     published
-    // Also
-    //   Increment the MQTT timers every 50ms
-    if (mqtt_timer_expired()) {
-      if (mqtt_enabled) {
-        if (mqtt_start == MQTT_START_COMPLETE) {
-	  // publish_outbound() is called to check for any pending pin or
-	  // temperature state changes that need to be PUBLISHed via MQTT.
-	  // publish_outbound will place PUBLISH messages in the MQTT sendbuf
-	  // one per call, and only if the sendbuf is empty.
-	  publish_outbound();
-	  // Call the periodic_service() function to clear out the MQTT
-	  // traffic just now placed in the uip_buf. Even though there is
-	  // a periodic_service() call in the main loop we don't want to
-	  // wait for its timer to expire for MQTT service. Experience has
-	  // shown that failing to do the periodic_serivce() call here
-	  // causes loss of MQTT messages and in some cases MQTT errors
-	  // and TCP resets.
-	  periodic_service();
-	}
-        mqtt_start_ctr1++; // Increment the MQTT start loop timer 1. This is
-                           // used to:
-			   //   - Timeout the MQTT Server ARP request or the
-                           //     MQTT Server TCP connection request if the
-			   //     server is not responding.
-			   //   - Limit the rate at which timeouts occur in
-			   //     the MQTT Broker connection requests.
-			   //   - Govern the rate at which subscription and
-			   //     HA Auto Discovery messaging is placed in
-			   //     the transmit queue.
-			   // Note that uip_periodic() drives actual message
-			   // transmission at X ms intervals - see timer.c.
-        mqtt_sanity_ctr++; // Increment the MQTT sanity loop timer. This is
-                           // used to provide timing for the MQTT Sanity
-                           // Check function.			   
-      }
-    }
+    // If the MQTT timer expires (50ms) run the MQTT timer task
+    if (mqtt_timer_expired()) task_mqtt_timer();
 #endif // BUILD_SUPPORT == MQTT_BUILD
 
     if (periodic_timer_expired()) {
@@ -1250,23 +1577,16 @@ int main(void)
     }
 
     // 100ms timer
-    if (t100ms_timer_expired()) {
-      t100ms_ctr1++;     // Increment the 100ms counter. ctr1 is used in the
-                         // restart/reboot process. Normally the counter is
-			 // not used and will just roll over every 2^32
-			 // counts. Any code that uses ctr1 should reset it to
-			 // zero then compare to a value needed for a timeout.
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
-      decrement_pin_timers(); // Call the pin_timers function every 100ms
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
-    }
+    if (t100ms_timer_expired()) task_100ms();
+#endif // TASK_SCHEDULER == 1
 
-#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
+#if SREC_UPLOAD == 1
     // Check for a request to copy the I2C EEPROM Region 0 to Flash.
     // The request is automatically generated by the process that uploads the
     // user specified file after the file is copied to the I2C EEPROM.
     // The request is also generated if the user presses the Restore button
-    // (generating a /73 command) while in the Uploader GUI.
+    // (generating a /73 command) while in the Uploader GUI. In runtime
+    // builds with BACKGROUND_UPLOAD it is generated by the /87 install.
     if (eeprom_copy_to_flash_request == I2C_COPY_EEPROM_R0_REQUEST) {
       eeprom_copy_to_flash_request = I2C_COPY_EEPROM_R0_WAIT;
       check_I2C_EEPROM_ctr = t100ms_ctr1;
@@ -1274,6 +1594,17 @@ int main(void)
     // Give main loop 1000ms for browser update
     if ((eeprom_copy_to_flash_request == I2C_COPY_EEPROM_R0_WAIT) &&
         (t100ms_ctr1 > (check_I2C_EEPROM_ctr + 10))) {
+#if DEBUG_SUPPORT == 15
+      // Send any buffered debug output while the UART interrupt vector is
+      // still in place
+      UARTFlush();
+#endif // DEBUG_SUPPORT == 15
+#if INTERRUPTS_ENABLED == 1
+      // No interrupts while the Flash is being rewritten. The interrupt
+      // vectors are in the Flash being rewritten, and the module reboots
+      // when the copy completes.
+      sim();
+#endif // INTERRUPTS_ENABLED == 1
       unlock_flash();
       // copy_I2C_EEPROM_to_Flash() will cause a reboot on completion of the
       // function.
@@ -1314,7 +1645,7 @@ UARTPrintf("EEPROM Region 0 copy to Flash failed because upgrade_failcode != UPG
       }
       lock_flash();
     }
-#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
+#endif // SREC_UPLOAD == 1
 
 #if OB_EEPROM_SUPPORT == 1
     // Check for a request to copy the I2C EEPROM Region 1 to Flash. The
@@ -1327,6 +1658,17 @@ UARTPrintf("EEPROM Region 0 copy to Flash failed because upgrade_failcode != UPG
     // Give main loop 1000ms for browser update
     if ((eeprom_copy_to_flash_request == I2C_COPY_EEPROM_R1_WAIT) &&
         (t100ms_ctr1 > (check_I2C_EEPROM_ctr + 10))) {
+#if DEBUG_SUPPORT == 15
+      // Send any buffered debug output while the UART interrupt vector is
+      // still in place
+      UARTFlush();
+#endif // DEBUG_SUPPORT == 15
+#if INTERRUPTS_ENABLED == 1
+      // No interrupts while the Flash is being rewritten. The interrupt
+      // vectors are in the Flash being rewritten, and the module reboots
+      // when the copy completes.
+      sim();
+#endif // INTERRUPTS_ENABLED == 1
       unlock_flash();
       // copy_I2C_EEPROM_to_Flash() will cause a reboot on completion of the
       // function.
@@ -1350,170 +1692,722 @@ UARTPrintf("EEPROM Region 0 copy to Flash failed because upgrade_failcode != UPG
     }
 #endif // OB_EEPROM_SUPPORT == 1
 
+#if TASK_SCHEDULER == 0
     // Call the ARP timer function every 10 seconds.
-    if (arp_timer_expired()) {
-      uip_arp_timer(); // Clean out old ARP Table entries. Any entry that has
-                       // exceeded the UIP_ARP_MAXAGE without being accessed
-		       // is cleared. UIP_ARP_MAXAGE is typically 20 minutes.
-
-#if DEBUG_SUPPORT == 15
-// UARTPrintf("\r\n");
-// UARTPrintf("Stack Overflow Status = ");
-// if ((debug_bytes[2] & 0x80) == 0) UARTPrintf("GOOD\r\n");
-// if (debug_bytes[2] & 0x80) {
-// UARTPrintf("Stack Overflow ERROR!\r\n");
-// debug_bytes[2] = (uint8_t)(debug_bytes[2] & 0x7f); // clear stack overflow error
-// }
-#endif // DEBUG_SUPPORT == 15
-    }
+    if (arp_timer_expired()) task_arp();
 
+    // The sensor and login tasks check their own intervals.
 #if DS18B20_SUPPORT == 1
-    // Update temperature data
-    // If a DS18B20 sensor was found and the config_settings show the sensor
-    // is enabled then collect the sensor data every 30 seconds.
-    if ((stored_config_settings & 0x08) && (second_counter > (check_DS18B20_ctr + 30))) {
-      check_DS18B20_ctr = second_counter;
-      get_temperature();
-#if BUILD_SUPPORT == MQTT_BUILD
-      send_mqtt_temperature = 4; // Indicates that all 5 temperature sensors
-                                 // need to be transmitted via MQTT.
-#endif // BUILD_SUPPORT == MQTT_BUILD
-    }
+    task_DS18B20();
 #endif // DS18B20_SUPPORT == 1
-
 #if BME280_SUPPORT == 1
-    // If a BME280 sensor was found and the config_settings show the sensor
-    // is enabled then collect the sensor data every 300 seconds. Not sure of
-    // the best interval so 300 seconds (5 min) is used since the BME280 is
-    // best suited to weather monitoring.
-    if ((BME280_found == 1) && (stored_config_settings & 0x20)) {
-      if (second_counter > (check_BME280_ctr + 300)) {
-        check_BME280_ctr = second_counter;
-        stream_sensor_data_forced_mode(&dev, &comp_data);
-#if BUILD_SUPPORT == MQTT_BUILD
-        send_mqtt_BME280 = 2; // Indicates that the BME280 sensors need to be
-                              // transmitted via MQTT.
-			      // The value is set to 2 because the Home
-			      // Assistant implementation sends the
-			      // Temperature, Humidity, and Pressure valuse as
-			      // three separate sensors (so the
-			      // send_mqtt_BME280 index counts down 2, 1, 0 to
-			      // send all three sensors).
-			      // The Domoticz implementation sends the three
-			      // sensor values as a single message, so that
-			      // code will see the "2" as a "send now", and
-			      // will adjust the send_mqtt_BME280 count down
-			      // accordingly.
-#endif // BUILD_SUPPORT == MQTT_BUILD
-#if DEBUG_SUPPORT == 15
-        // Print sensor data on UART
-//        print_sensor_data(&comp_data);
-#endif // DEBUG_SUPPORT == 15
-      }
-    }
+    task_BME280();
 #endif // BME280_SUPPORT == 1
-    
-    
 #if LOGIN_SUPPORT == 1
-//    if ((second_counter > (login_update_timer + 60))) {
-    // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
-    // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
-    // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
-    // For development only the timer is reduced to 10 seconds to allow
-    // faster countdowns.
-    if ((second_counter > (login_update_timer + 10))) {
-    // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
-    // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
-    // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
-      login_update_timer = second_counter;
-      // Call function to update login timers and manage timeouts.
-      login_timer_management();
-    }
+    task_login();
 #endif // LOGIN_SUPPORT == 1
-    
-    
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-    // Check for changes in Output control states, IP address, IP gateway
-    // address, Netmask, MAC, and Port number.
-    // This functionality is not needed for the CODE_UPLOADER build.
-    check_runtime_changes();
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
 
-    // Check for the Reset button
-    check_reset_button();
+    // Check for GUI and pin changes and for the Reset button
+    task_runtime();
+#endif // TASK_SCHEDULER == 0
 
     // Check for Restart or Reboot request generated by the user pressing the
     // reset button or generated by the user making changes in the GUI that
     // require a restart or reboot.
     check_restart_reboot();
+
+#if LOW_POWER_IDLE == 1
+    // Wait for the next scheduled task or received frame
+    idle_wait();
+#endif // LOW_POWER_IDLE == 1
   }
   return 0;
 }
 
 
-void periodic_service(void)
+//---------------------------------------------------------------------------//
+void sensor_init(void)
 {
-  int i;
-  for(i = 0; i < UIP_CONNS; i++) {
-    uip_periodic(i);
-    // uip_periodic() calls uip_process(UIP_TIMER) for each connection.
-    // Every connection is checked in this loop one time. With each pass
-    // only one connection (one HTTP or one MQTT) will transmit unserviced
-    // outbound traffic one packet at a time.
-    //
-    //   HTTP connections (the webbrowser) will generate and place its
-    //   data in the uip_buf via a call to HttpDCall(). HTTP connections
-    //   can have pending transmissions which are continuations of a
-    //   series of packets because the web pages can be broken into
-    //   several packets.
-    //
-    //   MQTT will always use this function to transmit packets. MQTT
-    //   will have placed its outbound packets in the mqtt_sendbuf. MQTT
-    //   connections will consist of a complete message in one packet.
-    //
-    //   Additionally, there will be TCP handshake transactions such as SYN,
-    //   SYNACK, ACK and FIN that are processed as a result of a
-    //   uip_process(UIP_TIMER).
-    //
-    // If uip_periodic() resulted in data that should be sent out on
-    // the network the global variable uip_len will have been set to a
-    // value > 0 so that Enc28j60Send() will be called.
-    //
-    // Note that when the device first powers up and MQTT is enabled the
-    // MQTT processes will attempt to send a SYN to create a TCP
-    // connection. The uip_periodic() function discovers the SYN is
-    // pending to be sent, causing uip_len to be > 0. Below you'll see
-    // that uip_arp_out() is called first, and on the first pass it will
-    // find that an ARP request is needed. The SYN will be replaced with
-    // an ARP request, and on a future cycle through this routine the
-    // SYN will be sent IF the ARP request was successful.
-    
-    if (uip_len > 0) {
-      uip_arp_out(); // Verifies arp entry in the ARP table and builds
-                     // the LLH
-      Enc28j60Send(uip_buf, uip_len);
+  // Find and initialize the I2C and 1-Wire sensors and collect the first
+  // readings. With FAST_BOOT this runs from the main loop shortly after the
+  // network is up instead of before it.
+#if BME280_SUPPORT == 1
+  // Initialize the BME280
+  BME280_found = 0;
+#if BME280_ASYNC_MEASURE == 1
+  BME280_measuring = 0;
+#endif // BME280_ASYNC_MEASURE == 1
+#if SENSOR_DEADBAND == 1 && BUILD_SUPPORT == MQTT_BUILD
+  // Start with the maximum age expired so the first reading is published
+  BME280_publish_time = second_counter - SENSOR_MAX_AGE;
+#endif // SENSOR_DEADBAND == 1 && BUILD_SUPPORT == MQTT_BUILD
+//  rslt = bme280_init(&dev);
+//  if (rslt == BME280_OK) {
+  if (bme280_init(&dev) == BME280_OK) {
+    BME280_found = 1;
+#if BME280_NORMAL_SAMPLING == 1
+    // Write the settings once and leave the sensor measuring continuously
+    bme280_start_normal_mode(&dev);
+#endif // BME280_NORMAL_SAMPLING == 1
+  }
+#endif // BME280_SUPPORT == 1
+
+#if DS18B20_SUPPORT == 1
+  init_DS18B20();          // Initialize DS18B20 sensors
+  // Initialize DS18B20 control variables used in main.c 
+  if (stored_config_settings & 0x08) {
+    // Find all devices
+    FindDevices();
+    // Iniialize DS18B20 timer
+    check_DS18B20_ctr = second_counter;
+    // Initialize DS18B20 sensor add/delete check counter
+    // Collect initial temperature
+    get_temperature();
+    // Iniialize DS18B20 transmit control variable
+    send_mqtt_temperature = -1; // Indicates nothing to send on MQTT yet.
+#if SENSOR_DEADBAND == 1 && BUILD_SUPPORT == MQTT_BUILD
+    // Start with the maximum age expired so the first reading is published
+    DS18B20_publish_time = second_counter - SENSOR_MAX_AGE;
+#endif // SENSOR_DEADBAND == 1 && BUILD_SUPPORT == MQTT_BUILD
+  }
+#endif // DS18B20_SUPPORT == 1
+
+#if BME280_SUPPORT == 1
+  if (BME280_found == 1) {
+    if (stored_config_settings & 0x20) {
+      // If a BME280 sensor was found and the config_settings show the sensor
+      // is enabled then collect the sensor data. This measurement at startup
+      // is needed so that sensor data is available for display when the
+      // IOControl page is shown at boot time.
+#if BME280_NORMAL_SAMPLING == 0
+      stream_sensor_data_forced_mode(&dev, &comp_data);
+#endif // BME280_NORMAL_SAMPLING == 0
+#if BME280_NORMAL_SAMPLING == 1
+      bme280_get_sensor_data(&comp_data, &dev);
+#endif // BME280_NORMAL_SAMPLING == 1
+      send_mqtt_BME280 = 2; // Indicates we should send BME280 data as part of
+                        // boot. Even though only 1 BME280 is supported
+			// send_MQTT_BME280 is set to "2" so that all three
+			// sensors (Temp, Humidity, Pressure) within the
+			// BME280 are sent (2, 1, 0).
+      check_BME280_ctr = second_counter;
     }
   }
+  if (BME280_found == 0) {
+    // If BME280 sensor was not found then then force the BME280 Enable bit off.
+    // This will help reduce confusion on the part of the user that may think
+    // they can enable BME280 support on the Config Page but they have not
+    // connected a BME280 sensor.
+    Pending_config_settings &= (uint8_t)(~0x20);
+    // Setting parse_complete will cause any change to the
+    // Pending_config_settings to update the EEPROM if needed. At boot it was
+    // already set during main variable initialization.
+    parse_complete = 1;
+  }
+#endif // BME280_SUPPORT == 1
+
+#if INA226_SUPPORT == 1
+  // Initialize all INA226 devices
+  ina226_init_all();
+  //   Calibrate all INA226 devices
+  ina226_calibrate_all();
+  //   Configure all INA226 devices
+  ina226_configure_all();
+#endif // INA226_SUPPORT == 1
+
+#if HTTPD_PAGE_CACHE == 1
+  // The sensor IDs shown on the Configuration page may have changed
+  page_cache_invalidate();
+#endif // HTTPD_PAGE_CACHE == 1
+
+  BOOT_MARK(BOOT_SENSORS);
 }
 
 
-#if OB_EEPROM_SUPPORT == 1
-uint8_t off_board_EEPROM_detect(void)
+#if BOOT_PROFILE == 1
+void boot_mark(uint8_t stage)
 {
-  // Verify that an I2C EEPROM exists. This routine is directed at
-  // detecting a 256KB I2C EEPROM.
-  //
-  // Presence verification is performed by:
-  //   Reading the first byte of the I2C EEPROM, inverting the byte,
-  //   writing the inverted byte to the I2C EEPROM, and verifying that
-  //   the inversion occurred. If the inversion occurred then eeprom_detect is
-  //   set to 1 and the original byte is restored.
-  //
-  // If detection fails I2C EEPROM support is turned off.
-  
-  uint8_t eeprom_detect;
-  uint8_t byte;
-  
+  // Record the ms since TIM1 was started in clock_init() for a boot stage.
+  // timer_update() is called here to fold the clock into ms_counter.
+  timer_update();
+  boot_time[stage] = ms_counter;
+}
+#endif // BOOT_PROFILE == 1
+
+
+#if BUILD_SUPPORT == MQTT_BUILD
+void task_mqtt_timer(void)
+{
+  // Runs when the MQTT timer expires (50ms)
+  //   And MQTT is enabled
+  //   And MQTT startup is complete
+  //     Then check for pin state change messages that need to be
+  //     published
+  // Also
+  //   Increment the MQTT timers every 50ms
+  if (mqtt_enabled) {
+    if (mqtt_start == MQTT_START_COMPLETE) {
+      // publish_outbound() is called to check for any pending pin or
+      // temperature state changes that need to be PUBLISHed via MQTT.
+      // publish_outbound will place PUBLISH messages in the MQTT sendbuf
+      // one per call, and only if the sendbuf is empty.
+#if PROFILE_SUPPORT == 1
+      prof_begin(PROF_PUBLISH);
+#endif // PROFILE_SUPPORT == 1
+      publish_outbound();
+#if PROFILE_SUPPORT == 1
+      prof_end(PROF_PUBLISH);
+#endif // PROFILE_SUPPORT == 1
+      // Call the periodic_service() function to clear out the MQTT
+      // traffic just now placed in the uip_buf. Even though there is
+      // a periodic_service() call in the main loop we don't want to
+      // wait for its timer to expire for MQTT service. Experience has
+      // shown that failing to do the periodic_serivce() call here
+      // causes loss of MQTT messages and in some cases MQTT errors
+      // and TCP resets.
+#if UIP_POLL_FAST_PATH == 0
+      periodic_service();
+#endif // UIP_POLL_FAST_PATH == 0
+#if UIP_POLL_FAST_PATH == 1
+      // Only the MQTT connection needs to be served here, so it is polled
+      // instead of sweeping all connections.
+      poll_conn_now(mqtt_conn);
+#endif // UIP_POLL_FAST_PATH == 1
+#if PROFILE_SUPPORT == 1
+      // Queue the profiling statistics for MQTT transmit once a minute
+      if (second_counter > (check_profile_ctr + 60)) {
+        check_profile_ctr = second_counter;
+        send_mqtt_profile = PROF_NUM_STAGES - 1;
+      }
+#endif // PROFILE_SUPPORT == 1
+#if PAGE_STATISTICS == 1
+      // Queue the page statistics for MQTT transmit once a minute
+      if (second_counter > (check_pagestats_ctr + 60)) {
+        check_pagestats_ctr = second_counter;
+        send_mqtt_pagestats = PSTAT_NUM - 1;
+      }
+#endif // PAGE_STATISTICS == 1
+#if STACK_MONITOR == 1
+      // Queue the stack and buffer peaks for MQTT transmit once a minute
+      if (second_counter > (check_stack_ctr + 60)) {
+        check_stack_ctr = second_counter;
+        send_mqtt_stack = 1;
+      }
+#endif // STACK_MONITOR == 1
+    }
+    mqtt_start_ctr1++; // Increment the MQTT start loop timer 1. This is
+                       // used to:
+                       //   - Timeout the MQTT Server ARP request or the
+                       //     MQTT Server TCP connection request if the
+                       //     server is not responding.
+                       //   - Limit the rate at which timeouts occur in
+                       //     the MQTT Broker connection requests.
+                       //   - Govern the rate at which subscription and
+                       //     HA Auto Discovery messaging is placed in
+                       //     the transmit queue.
+                       // Note that uip_periodic() drives actual message
+                       // transmission at X ms intervals - see timer.c.
+    mqtt_sanity_ctr++; // Increment the MQTT sanity loop timer. This is
+                       // used to provide timing for the MQTT Sanity
+                       // Check function.			   
+  }
+}
+#endif // BUILD_SUPPORT == MQTT_BUILD
+
+
+void task_100ms(void)
+{
+  // 100ms timer task
+  t100ms_ctr1++;     // Increment the 100ms counter. ctr1 is used in the
+                     // restart/reboot process. Normally the counter is
+                     // not used and will just roll over every 2^32
+                     // counts. Any code that uses ctr1 should reset it to
+                     // zero then compare to a value needed for a timeout.
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
+  decrement_pin_timers(); // Call the pin_timers function every 100ms
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
+#if PHY_LINK_MONITOR == 1
+  link_check();
+#endif // PHY_LINK_MONITOR == 1
+#if COMMAND_RATE_LIMIT == 1
+  command_rate_tick();
+#endif // COMMAND_RATE_LIMIT == 1
+#if STACK_MONITOR == 1
+  // The painted stack stays painted until it is written, so a scan every
+  // 100ms still finds the deepest use since boot.
+  stack_scan();
+#endif // STACK_MONITOR == 1
+}
+
+
+#if COMMAND_RATE_LIMIT == 1
+void command_rate_tick(void)
+{
+  // Refill the command rate limit buckets by one token every
+  // COMMAND_RATE_REFILL x 100ms. If an MQTT command is waiting for a token
+  // the token is used right away to apply the latest requested pin states.
+  command_rate_ticks++;
+  if (command_rate_ticks < COMMAND_RATE_REFILL) return;
+  command_rate_ticks = 0;
+
+  http_rate_refill();
+#if BUILD_SUPPORT == MQTT_BUILD
+  if (mqtt_rate_tokens < COMMAND_RATE_BURST) mqtt_rate_tokens++;
+  if (mqtt_parse_deferred) {
+    mqtt_parse_deferred = 0;
+    mqtt_rate_tokens--;
+    mqtt_parse_complete = 1;
+  }
+#endif // BUILD_SUPPORT == MQTT_BUILD
+}
+
+
+#if BUILD_SUPPORT == MQTT_BUILD
+void mqtt_command_complete(void)
+{
+  // Called by publish_callback() when an MQTT command has updated the
+  // Pending_pin_control bytes. The command is applied now if the MQTT
+  // bucket has a token. Otherwise it waits for command_rate_tick(), and any
+  // commands received in the meantime only update the Pending_pin_control
+  // bytes, so they are applied together.
+  if (mqtt_rate_tokens) {
+    mqtt_rate_tokens--;
+    mqtt_parse_complete = 1;
+  }
+  else mqtt_parse_deferred = 1;
+}
+#endif // BUILD_SUPPORT == MQTT_BUILD
+#endif // COMMAND_RATE_LIMIT == 1
+
+
+#if PHY_LINK_MONITOR == 1
+void link_check(void)
+{
+  // Act on a PHY link change latched by the ENC28J60. Runs every 100ms so a
+  // switch reboot is acted on right away instead of after the MQTT response
+  // timeouts run out.
+  uint8_t link;
+
+  link = Enc28j60LinkCheck();
+
+  if (link == ENC28J60_LINK_DOWN) {
+#if BUILD_SUPPORT == MQTT_BUILD
+    // The MQTT connection is stale. Start the restart steps now so they are
+    // done and the connection attempt is waiting when the link returns.
+    if (mqtt_enabled == 1
+     && mqtt_start == MQTT_START_COMPLETE
+     && mqtt_restart_step == MQTT_RESTART_IDLE) {
+      mqtt_restart_step = MQTT_RESTART_BEGIN;
+    }
+#endif // BUILD_SUPPORT == MQTT_BUILD
+  }
+
+  if (link == ENC28J60_LINK_UP) {
+    // Announce our MAC address so traffic reaches us without waiting for
+    // the peers' ARP entries to age out
+    uip_arp_announce();
+    Enc28j60Send(uip_buf, uip_len);
+    uip_len = 0;
+#if BUILD_SUPPORT == MQTT_BUILD
+    if (mqtt_enabled == 1) {
+#if MQTT_RECONNECT_BACKOFF == 1
+      // Connect again at once rather than at the end of the backoff window
+      mqtt_backoff_count = 0;
+      if (mqtt_start == MQTT_START_RECONNECT_WAIT) mqtt_start = MQTT_START_TCP_CONNECT;
+#endif // MQTT_RECONNECT_BACKOFF == 1
+      // An ARP request or SYN sent while the link was down was lost. Start
+      // the connection attempt over instead of waiting for it to time out.
+      if (mqtt_start == MQTT_START_VERIFY_ARP
+       || mqtt_start == MQTT_START_VERIFY_TCP) {
+        mqtt_start = MQTT_START_TCP_CONNECT;
+      }
+    }
+#endif // BUILD_SUPPORT == MQTT_BUILD
+  }
+}
+#endif // PHY_LINK_MONITOR == 1
+
+
+void task_arp(void)
+{
+  // ARP timer task. Runs every 10 seconds.
+  uip_arp_timer(); // Clean out old ARP Table entries. Any entry that has
+                   // exceeded the UIP_ARP_MAXAGE without being accessed
+                   // is cleared. UIP_ARP_MAXAGE is typically 20 minutes.
+#if ARP_PINNED_ENTRIES == 1
+  // Send the unicast ARP request refreshing a pinned router or MQTT Server
+  // entry if the timer built one.
+  if (uip_len > 0) Enc28j60Send(uip_buf, uip_len);
+#endif // ARP_PINNED_ENTRIES == 1
+
+#if DEBUG_SUPPORT == 15
+// UARTPrintf("\r\n");
+// UARTPrintf("Stack Overflow Status = ");
+// if ((debug_bytes[2] & 0x80) == 0) UARTPrintf("GOOD\r\n");
+// if (debug_bytes[2] & 0x80) {
+// UARTPrintf("Stack Overflow ERROR!\r\n");
+// debug_bytes[2] = (uint8_t)(debug_bytes[2] & 0x7f); // clear stack overflow error
+// }
+#endif // DEBUG_SUPPORT == 15
+}
+
+
+#if DS18B20_SUPPORT == 1
+void task_DS18B20(void)
+{
+  // Update temperature data
+  // If a DS18B20 sensor was found and the config_settings show the sensor
+  // is enabled then collect the sensor data every DS18B20_SAMPLE_INTERVAL
+  // seconds (30 seconds by default).
+  if ((stored_config_settings & 0x08) && (second_counter > (check_DS18B20_ctr + DS18B20_SAMPLE_INTERVAL))) {
+    check_DS18B20_ctr = second_counter;
+#if DS18B20_INCREMENTAL == 1
+    // Start the read. The main loop runs it one step per pass via
+    // task_DS18B20_step().
+    start_temperature();
+#endif // DS18B20_INCREMENTAL == 1
+#if DS18B20_INCREMENTAL == 0
+#if PROFILE_SUPPORT == 1
+    prof_begin(PROF_TEMPERATURE);
+#endif // PROFILE_SUPPORT == 1
+#if INTERRUPTS_ENABLED == 1
+    // Mask interrupts during the DS18B20 bit timing. Pin capture edges
+    // that occur meanwhile stay pending and are captured afterwards.
+    sim();
+#endif // INTERRUPTS_ENABLED == 1
+    get_temperature();
+#if INTERRUPTS_ENABLED == 1
+    rim();
+#endif // INTERRUPTS_ENABLED == 1
+#if PROFILE_SUPPORT == 1
+    prof_end(PROF_TEMPERATURE);
+#endif // PROFILE_SUPPORT == 1
+#if BUILD_SUPPORT == MQTT_BUILD
+#if SENSOR_DEADBAND == 1
+    if (DS18B20_changed())
+#endif // SENSOR_DEADBAND == 1
+    send_mqtt_temperature = 4; // Indicates that all 5 temperature sensors
+                               // need to be transmitted via MQTT.
+#endif // BUILD_SUPPORT == MQTT_BUILD
+#endif // DS18B20_INCREMENTAL == 0
+  }
+}
+
+
+#if DS18B20_INCREMENTAL == 1
+void task_DS18B20_step(void)
+{
+  // Run one step of the temperature read started by task_DS18B20(). This
+  // is called on every pass of the main loop while a read is in progress.
+#if PROFILE_SUPPORT == 1
+  prof_begin(PROF_TEMPERATURE);
+#endif // PROFILE_SUPPORT == 1
+  if (step_temperature() == 0) {
+#if BUILD_SUPPORT == MQTT_BUILD
+#if SENSOR_DEADBAND == 1
+    if (DS18B20_changed())
+#endif // SENSOR_DEADBAND == 1
+    send_mqtt_temperature = 4; // Indicates that all 5 temperature sensors
+                               // need to be transmitted via MQTT.
+#endif // BUILD_SUPPORT == MQTT_BUILD
+  }
+#if PROFILE_SUPPORT == 1
+  prof_end(PROF_TEMPERATURE);
+#endif // PROFILE_SUPPORT == 1
+}
+#endif // DS18B20_INCREMENTAL == 1
+
+
+#if SENSOR_DEADBAND == 1 && BUILD_SUPPORT == MQTT_BUILD
+uint8_t DS18B20_changed(void)
+{
+  // Returns 1 if the new temperature readings should be published. This is
+  // the case if any found sensor moved by DS18B20_DEADBAND or more (in the
+  // 1/16 degree C units of the DS18B20) since the last publish, or if
+  // SENSOR_MAX_AGE seconds have passed since the last publish. The readings
+  // are recorded as published when 1 is returned.
+  int i;
+  int16_t delta;
+  uint8_t changed;
+  
+  changed = 0;
+  if ((second_counter - DS18B20_publish_time) >= SENSOR_MAX_AGE) changed = 1;
+  for (i = 0; i <= numROMs; i++) {
+    delta = (int16_t)((DS18B20_scratch[i][1] << 8) | DS18B20_scratch[i][0]) - DS18B20_published[i];
+    if (delta < 0) delta = -delta;
+    if (delta >= DS18B20_DEADBAND) changed = 1;
+  }
+  
+  if (changed) {
+    for (i = 0; i <= numROMs; i++) {
+      DS18B20_published[i] = (int16_t)((DS18B20_scratch[i][1] << 8) | DS18B20_scratch[i][0]);
+    }
+    DS18B20_publish_time = second_counter;
+  }
+  return changed;
+}
+#endif // SENSOR_DEADBAND == 1 && BUILD_SUPPORT == MQTT_BUILD
+#endif // DS18B20_SUPPORT == 1
+
+
+#if BME280_SUPPORT == 1
+void task_BME280(void)
+{
+  // If a BME280 sensor was found and the config_settings show the sensor
+  // is enabled then collect the sensor data every BME280_SAMPLE_INTERVAL
+  // seconds. Not sure of the best interval so 300 seconds (5 min) is the
+  // default since the BME280 is best suited to weather monitoring.
+  //
+  // With BME280_ASYNC_MEASURE the measurement is started on one call and
+  // collected on a later call at least a second later, so the 30 to 46ms
+  // measurement time is not spent waiting with network processing stopped.
+  // If the status register never shows the measurement complete the data
+  // is collected anyway after 2 seconds, as the blocking version did after
+  // its 200ms timeout.
+  //
+  // With BME280_NORMAL_SAMPLING the sensor is always measuring, so the
+  // data is read with a single burst read and there is nothing to wait for.
+  if ((BME280_found == 1) && (stored_config_settings & 0x20)) {
+#if BME280_NORMAL_SAMPLING == 1
+    if (second_counter > (check_BME280_ctr + BME280_SAMPLE_INTERVAL)) {
+      check_BME280_ctr = second_counter;
+      bme280_get_sensor_data(&comp_data, &dev);
+#endif // BME280_NORMAL_SAMPLING == 1
+#if BME280_NORMAL_SAMPLING == 0 && BME280_ASYNC_MEASURE == 0
+    if (second_counter > (check_BME280_ctr + BME280_SAMPLE_INTERVAL)) {
+      check_BME280_ctr = second_counter;
+      stream_sensor_data_forced_mode(&dev, &comp_data);
+#endif // BME280_NORMAL_SAMPLING == 0 && BME280_ASYNC_MEASURE == 0
+#if BME280_NORMAL_SAMPLING == 0 && BME280_ASYNC_MEASURE == 1
+    if (BME280_measuring == 0) {
+      if (second_counter > (check_BME280_ctr + BME280_SAMPLE_INTERVAL)) {
+        check_BME280_ctr = second_counter;
+        bme280_start_forced_measurement(&dev);
+        BME280_measuring = 1;
+      }
+    }
+    else if (second_counter != check_BME280_ctr
+          && (bme280_measurement_done() || second_counter > (check_BME280_ctr + 1))) {
+      BME280_measuring = 0;
+      bme280_get_sensor_data(&comp_data, &dev);
+#endif // BME280_NORMAL_SAMPLING == 0 && BME280_ASYNC_MEASURE == 1
+#if BUILD_SUPPORT == MQTT_BUILD
+#if SENSOR_DEADBAND == 1
+      if (BME280_changed())
+#endif // SENSOR_DEADBAND == 1
+      send_mqtt_BME280 = 2; // Indicates that the BME280 sensors need to be
+                            // transmitted via MQTT.
+                            // The value is set to 2 because the Home
+                            // Assistant implementation sends the
+                            // Temperature, Humidity, and Pressure valuse as
+                            // three separate sensors (so the
+                            // send_mqtt_BME280 index counts down 2, 1, 0 to
+                            // send all three sensors).
+                            // The Domoticz implementation sends the three
+                            // sensor values as a single message, so that
+                            // code will see the "2" as a "send now", and
+                            // will adjust the send_mqtt_BME280 count down
+                            // accordingly.
+#endif // BUILD_SUPPORT == MQTT_BUILD
+#if DEBUG_SUPPORT == 15
+      // Print sensor data on UART
+//        print_sensor_data(&comp_data);
+#endif // DEBUG_SUPPORT == 15
+    }
+  }
+}
+
+
+#if SENSOR_DEADBAND == 1 && BUILD_SUPPORT == MQTT_BUILD
+static uint32_t abs_delta(uint32_t a, uint32_t b)
+{
+  // Returns the distance between two unsigned readings
+  if (a > b) return a - b;
+  return b - a;
+}
+
+
+static uint32_t abs_delta_signed(int32_t a, int32_t b)
+{
+  // Returns the distance between two signed readings, such as temperatures
+  // on either side of 0 degrees C
+  if (a > b) return (uint32_t)a - (uint32_t)b;
+  return (uint32_t)b - (uint32_t)a;
+}
+
+
+uint8_t BME280_changed(void)
+{
+  // Returns 1 if the new BME280 readings should be published. This is the
+  // case if the temperature (0.01 degree C units), pressure (Pa units) or
+  // humidity (1/1024 % units) moved by its BME280_DEADBAND_x value or more
+  // since the last publish, or if SENSOR_MAX_AGE seconds have passed since
+  // the last publish. The readings are recorded as published when 1 is
+  // returned.
+  if (((second_counter - BME280_publish_time) >= SENSOR_MAX_AGE)
+   || (abs_delta_signed(comp_data.temperature, BME280_published.temperature) >= BME280_DEADBAND_TEMP)
+   || (abs_delta(comp_data.pressure, BME280_published.pressure) >= BME280_DEADBAND_PRES)
+   || (abs_delta(comp_data.humidity, BME280_published.humidity) >= BME280_DEADBAND_HUM)) {
+    BME280_published = comp_data;
+    BME280_publish_time = second_counter;
+    return 1;
+  }
+  return 0;
+}
+#endif // SENSOR_DEADBAND == 1 && BUILD_SUPPORT == MQTT_BUILD
+#endif // BME280_SUPPORT == 1
+
+
+#if LOGIN_SUPPORT == 1
+void task_login(void)
+{
+//    if ((second_counter > (login_update_timer + 60))) {
+  // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+  // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+  // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+  // For development only the timer is reduced to 10 seconds to allow
+  // faster countdowns.
+  if ((second_counter > (login_update_timer + 10))) {
+  // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+  // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+  // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+    login_update_timer = second_counter;
+    // Call function to update login timers and manage timeouts.
+    login_timer_management();
+  }
+}
+#endif // LOGIN_SUPPORT == 1
+
+
+void task_runtime(void)
+{
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+  // Check for changes in Output control states, IP address, IP gateway
+  // address, Netmask, MAC, and Port number.
+  // This functionality is not needed for the CODE_UPLOADER build.
+#if PROFILE_SUPPORT == 1
+  prof_begin(PROF_RUNTIME);
+#endif // PROFILE_SUPPORT == 1
+  check_runtime_changes();
+#if PROFILE_SUPPORT == 1
+  prof_end(PROF_RUNTIME);
+#endif // PROFILE_SUPPORT == 1
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+
+  // Check for the Reset button
+  check_reset_button();
+}
+
+
+#if UIP_POLL_FAST_PATH == 1
+void poll_conn_now(struct uip_conn *conn)
+{
+  // Poll the application of one connection for data to send and transmit
+  // it now instead of waiting for the next periodic_service() sweep. uip
+  // only polls an ESTABLISHED connection with no unacknowledged data, or an
+  // httpd connection with room in the HTTPD_TX_WINDOW.
+  uip_poll_conn(conn);
+  if (uip_len > 0) {
+    uip_arp_out(); // Verifies arp entry in the ARP table and builds
+                   // the LLH
+    Enc28j60Send(uip_buf, uip_len);
+  }
+}
+#endif // UIP_POLL_FAST_PATH == 1
+
+
+void periodic_service(void)
+{
+  int i;
+#if PERIODIC_ROUND_ROBIN == 0
+  for(i = 0; i < UIP_CONNS; i++) periodic_conn(i);
+#endif // PERIODIC_ROUND_ROBIN == 0
+#if PERIODIC_ROUND_ROBIN == 1
+  int n;
+  int first;
+
+  // The MQTT connection is serviced first so that a state publish never
+  // waits behind page segments on the other connections. The others are
+  // serviced starting one connection further along on each call so that a
+  // long page download on a low numbered connection does not always
+  // transmit ahead of the rest.
+  first = UIP_CONNS;
+#if BUILD_SUPPORT == MQTT_BUILD
+  if (mqtt_conn != NULL) {
+    first = (int)(mqtt_conn - uip_conns);
+    periodic_conn(first);
+  }
+#endif // BUILD_SUPPORT == MQTT_BUILD
+  i = periodic_next;
+  for (n = 0; n < UIP_CONNS; n++) {
+    if (i != first) periodic_conn(i);
+    if (++i == UIP_CONNS) i = 0;
+  }
+  if (++periodic_next == UIP_CONNS) periodic_next = 0;
+#endif // PERIODIC_ROUND_ROBIN == 1
+}
+
+
+void periodic_conn(int i)
+{
+  uip_periodic(i);
+  // uip_periodic() calls uip_process(UIP_TIMER) for each connection.
+  // Every connection is checked by periodic_service() one time. With each pass
+  // only one connection (one HTTP or one MQTT) will transmit unserviced
+  // outbound traffic one packet at a time.
+  //
+  //   HTTP connections (the webbrowser) will generate and place its
+  //   data in the uip_buf via a call to HttpDCall(). HTTP connections
+  //   can have pending transmissions which are continuations of a
+  //   series of packets because the web pages can be broken into
+  //   several packets.
+  //
+  //   MQTT will always use this function to transmit packets. MQTT
+  //   will have placed its outbound packets in the mqtt_sendbuf. MQTT
+  //   connections will consist of a complete message in one packet.
+  //
+  //   Additionally, there will be TCP handshake transactions such as SYN,
+  //   SYNACK, ACK and FIN that are processed as a result of a
+  //   uip_process(UIP_TIMER).
+  //
+  // If uip_periodic() resulted in data that should be sent out on
+  // the network the global variable uip_len will have been set to a
+  // value > 0 so that Enc28j60Send() will be called.
+  //
+  // Note that when the device first powers up and MQTT is enabled the
+  // MQTT processes will attempt to send a SYN to create a TCP
+  // connection. The uip_periodic() function discovers the SYN is
+  // pending to be sent, causing uip_len to be > 0. Below you'll see
+  // that uip_arp_out() is called first, and on the first pass it will
+  // find that an ARP request is needed. The SYN will be replaced with
+  // an ARP request, and on a future cycle through this routine the
+  // SYN will be sent IF the ARP request was successful.
+  
+  if (uip_len > 0) {
+    uip_arp_out(); // Verifies arp entry in the ARP table and builds
+                   // the LLH
+    Enc28j60Send(uip_buf, uip_len);
+  }
+}
+
+
+#if OB_EEPROM_SUPPORT == 1
+uint8_t off_board_EEPROM_detect(void)
+{
+  // Verify that an I2C EEPROM exists. This routine is directed at
+  // detecting a 256KB I2C EEPROM.
+  //
+  // Presence verification is performed by:
+  //   Reading the first byte of the I2C EEPROM, inverting the byte,
+  //   writing the inverted byte to the I2C EEPROM, and verifying that
+  //   the inversion occurred. If the inversion occurred then eeprom_detect is
+  //   set to 1 and the original byte is restored.
+  //
+  // If detection fails I2C EEPROM support is turned off.
+  
+  uint8_t eeprom_detect;
+  uint8_t byte;
+  
   eeprom_detect = 0;
     
   // Make sure the I2C bus is in a sane condition.
@@ -1750,6 +2644,14 @@ void mqtt_startup(void)
 
   switch(mqtt_start)
   {
+#if MQTT_RECONNECT_BACKOFF == 1
+  case MQTT_START_RECONNECT_WAIT:
+    // Hold off the next connection attempt until the backoff delay chosen
+    // by mqtt_reconnect_backoff() has passed.
+    if (second_counter >= mqtt_backoff_until) mqtt_start = MQTT_START_TCP_CONNECT;
+    break;
+#endif // MQTT_RECONNECT_BACKOFF == 1
+
   case MQTT_START_TCP_CONNECT:
     // When first powering up or on a reboot we need to initialize the MQTT
     // processes.
@@ -1847,7 +2749,12 @@ void mqtt_startup(void)
         // Reply. If timeout occurs we probably have an error in the MQTT
         // Server IP Address or there is a network problem. If we timeout
         // we start over and retry the ARP request.
+#if MQTT_RECONNECT_BACKOFF == 0
         mqtt_start = MQTT_START_TCP_CONNECT;
+#endif // MQTT_RECONNECT_BACKOFF == 0
+#if MQTT_RECONNECT_BACKOFF == 1
+        mqtt_reconnect_backoff();
+#endif // MQTT_RECONNECT_BACKOFF == 1
         // Clear the error indicator flags
         mqtt_start_status = MQTT_START_NOT_STARTED;
       }
@@ -1880,7 +2787,12 @@ void mqtt_startup(void)
 	// seconds before a connection abort occurs.
         // If the connection does not complete we probably have a network
 	// problem.  Try again with a new uip_connect().
+#if MQTT_RECONNECT_BACKOFF == 0
         mqtt_start = MQTT_START_TCP_CONNECT;
+#endif // MQTT_RECONNECT_BACKOFF == 0
+#if MQTT_RECONNECT_BACKOFF == 1
+        mqtt_reconnect_backoff();
+#endif // MQTT_RECONNECT_BACKOFF == 1
         // Clear the error indicator flags
         mqtt_start_status = MQTT_START_NOT_STARTED;
       }
@@ -1927,11 +2839,17 @@ void mqtt_startup(void)
 
 
   case MQTT_START_QUEUE_CONNECT:
+#if FAST_BOOT == 0
     if (mqtt_start_ctr1 > 4) {
+#endif // FAST_BOOT == 0
+#if FAST_BOOT == 1
+    if (mqtt_start_ctr1 > 4 && sensor_init_pending == 0) {
+#endif // FAST_BOOT == 1
       // ARP Reply received from the MQTT Server and TCP Connection
       // established.
       // We should now be able to message the MQTT Broker, but will wait
-      // 200ms to give some start time.
+      // 200ms to give some start time. With FAST_BOOT the wait also covers
+      // the deferred sensor discovery so Auto Discovery sees the sensors.
 
       // Queue the mqtt_connect message for transmission to the MQTT Broker. 
       // The mqtt_connect function will create the message and put it in the
@@ -1947,13 +2865,24 @@ void mqtt_startup(void)
       strcat(client_id_text, mac_string);
       client_id = client_id_text;
   
+#if MQTT_PERSISTENT_SESSION == 0
       // Ensure we have a clean session
       connect_flags = MQTT_CONNECT_CLEAN_SESSION;
+#endif // MQTT_PERSISTENT_SESSION == 0
+#if MQTT_PERSISTENT_SESSION == 1
+      // Ask the Broker to keep the session between connections
+      connect_flags = 0;
+      connack_session_present = 0;
+#endif // MQTT_PERSISTENT_SESSION == 1
  
+#if MQTT_TOPIC_PREFIX == 1
+      // Build the topic prefix used by every topic of this connection. A
+      // devicename change always restarts MQTT so the prefix stays current.
+      topic_prefix_len = (uint8_t)(stpcpy(stpcpy(topic_prefix, (char *)devicetype), (char *)stored_devicename) - topic_prefix);
+#endif // MQTT_TOPIC_PREFIX == 1
+
       // Create will_topic
-      strcpy(topic_base, devicetype);
-      strcat(topic_base, stored_devicename);
-      strcat(topic_base, "/availability");
+      stpcpy(topic_prefix_copy(topic_base), "/availability");
 
       // When a CONNECT is sent to the broker it should respond with a
       // CONNACK.
@@ -1994,6 +2923,15 @@ void mqtt_startup(void)
         mqtt_start_ctr1 = 0; // Clear 50ms counter
         mqtt_start_status |= MQTT_START_MQTT_CONNECT_GOOD;
         mqtt_start = MQTT_START_QUEUE_SUBSCRIBE1;
+#if HOME_ASSISTANT_SUPPORT == 1 && MQTT_PERSISTENT_SESSION == 1
+        if (connack_session_present) {
+          // The Broker kept the session so the device wildcard subscription
+          // is still in place. Go directly to the step that follows the
+          // last SUBACK.
+          suback_received = 1;
+          mqtt_start = MQTT_START_VERIFY_SUBSCRIBE3;
+        }
+#endif // HOME_ASSISTANT_SUPPORT == 1 && MQTT_PERSISTENT_SESSION == 1
 #if DEBUG_SUPPORT == 15
 // UARTPrintf("\r\n");
 // UARTPrintf("connack_received\r\n");
@@ -2001,7 +2939,12 @@ void mqtt_startup(void)
       }
     }
     else {
+#if MQTT_RECONNECT_BACKOFF == 0
       mqtt_start = MQTT_START_TCP_CONNECT;
+#endif // MQTT_RECONNECT_BACKOFF == 0
+#if MQTT_RECONNECT_BACKOFF == 1
+      mqtt_reconnect_backoff();
+#endif // MQTT_RECONNECT_BACKOFF == 1
       // Clear the error indicator flags
       mqtt_start_status = MQTT_START_NOT_STARTED;
     }
@@ -2012,6 +2955,9 @@ void mqtt_startup(void)
   case MQTT_START_QUEUE_SUBSCRIBE1:
   case MQTT_START_QUEUE_SUBSCRIBE2:
   case MQTT_START_QUEUE_SUBSCRIBE3:
+#if MQTT_DISCOVERY_FINGERPRINT == 1
+  case MQTT_START_QUEUE_SUBSCRIBE4:
+#endif // MQTT_DISCOVERY_FINGERPRINT == 1
     if (mqtt_start_ctr1 > 4) {
       // Queue the mqtt_subscribe messages for transmission to the MQTT
       // Broker.
@@ -2035,14 +2981,36 @@ void mqtt_startup(void)
       //   case MQTT_START_QUEUE_SUBSCRIBE3:
       //   Subscribe to the state-req24 messages
       //
+      // With MQTT_DISCOVERY_FINGERPRINT a fourth SUBSCRIBE is run if Auto
+      // Discovery is enabled:
+      //   case MQTT_START_QUEUE_SUBSCRIBE4:
+      //   Subscribe to the retained Auto Discovery fingerprint
+      //
+      // With MQTT_PERSISTENT_SESSION only SUBSCRIBE1 is run, with the device
+      // wildcard topic that covers all three of the above.
+      //
 	
       suback_received = 0;
-      strcpy(topic_base, devicetype);
-      strcat(topic_base, stored_devicename);
+      topic_prefix_copy(topic_base);
       
+#if MQTT_PERSISTENT_SESSION == 0
       if (mqtt_start == MQTT_START_QUEUE_SUBSCRIBE1) strcat(topic_base, "/output/+/set");
+#endif // MQTT_PERSISTENT_SESSION == 0
+#if MQTT_PERSISTENT_SESSION == 1
+      if (mqtt_start == MQTT_START_QUEUE_SUBSCRIBE1) strcat(topic_base, "/#");
+#endif // MQTT_PERSISTENT_SESSION == 1
       if (mqtt_start == MQTT_START_QUEUE_SUBSCRIBE2) strcat(topic_base, "/state-req");
       if (mqtt_start == MQTT_START_QUEUE_SUBSCRIBE3) strcat(topic_base, "/state-req24");
+#if MQTT_DISCOVERY_FINGERPRINT == 1
+      if (mqtt_start == MQTT_START_QUEUE_SUBSCRIBE4) {
+        strcat(topic_base, "/discovery");
+        // The Broker sends the retained fingerprint right after the SUBACK,
+        // possibly in the same TCP segment, so the fingerprint to compare
+        // against must be ready before subscribing.
+        calc_discovery_fingerprint();
+        discovery_match = 0;
+      }
+#endif // MQTT_DISCOVERY_FINGERPRINT == 1
       
       // In the mqtt_subscribe call the maximum QOS level spedified (0 in this
       // case) is the max QOS level supported for the topic messages being
@@ -2054,6 +3022,9 @@ void mqtt_startup(void)
       if (mqtt_start == MQTT_START_QUEUE_SUBSCRIBE1) mqtt_start = MQTT_START_VERIFY_SUBSCRIBE1;
       if (mqtt_start == MQTT_START_QUEUE_SUBSCRIBE2) mqtt_start = MQTT_START_VERIFY_SUBSCRIBE2;
       if (mqtt_start == MQTT_START_QUEUE_SUBSCRIBE3) mqtt_start = MQTT_START_VERIFY_SUBSCRIBE3;
+#if MQTT_DISCOVERY_FINGERPRINT == 1
+      if (mqtt_start == MQTT_START_QUEUE_SUBSCRIBE4) mqtt_start = MQTT_START_VERIFY_SUBSCRIBE4;
+#endif // MQTT_DISCOVERY_FINGERPRINT == 1
     }
     break;
 
@@ -2061,6 +3032,9 @@ void mqtt_startup(void)
   case MQTT_START_VERIFY_SUBSCRIBE1:
   case MQTT_START_VERIFY_SUBSCRIBE2:
   case MQTT_START_VERIFY_SUBSCRIBE3:
+#if MQTT_DISCOVERY_FINGERPRINT == 1
+  case MQTT_START_VERIFY_SUBSCRIBE4:
+#endif // MQTT_DISCOVERY_FINGERPRINT == 1
     // Verify that the SUBSCRIBE SUBACK was received.
     // When a SUBSCRIBE is sent to the broker it should respond with a SUBACK.
     // The SUBACK will occur very quickly but we will allow up to 10 seconds
@@ -2069,18 +3043,31 @@ void mqtt_startup(void)
     // that the mqtt.c code can tell the main.c code that the SUBSCRIBE SUBACK
     // was received.
     //
-    // VERIFY_SUBSCRIBE is run three times
+    // VERIFY_SUBSCRIBE is run three times (four times with
+    // MQTT_DISCOVERY_FINGERPRINT if Auto Discovery is enabled)
 
     if (mqtt_start_ctr1 < 200) {
       // Allow up to 10 seconds for SUBACK
       if (suback_received == 1) {
         mqtt_start_ctr1 = 0; // Clear 50ms counter
+#if MQTT_PERSISTENT_SESSION == 0
         if (mqtt_start == MQTT_START_VERIFY_SUBSCRIBE1) mqtt_start = MQTT_START_QUEUE_SUBSCRIBE2;
+#endif // MQTT_PERSISTENT_SESSION == 0
+#if MQTT_PERSISTENT_SESSION == 1
+        // The wildcard SUBACK completes the subscriptions
+        if (mqtt_start == MQTT_START_VERIFY_SUBSCRIBE1) mqtt_start = MQTT_START_VERIFY_SUBSCRIBE3;
+#endif // MQTT_PERSISTENT_SESSION == 1
         if (mqtt_start == MQTT_START_VERIFY_SUBSCRIBE2) mqtt_start = MQTT_START_QUEUE_SUBSCRIBE3;
         if (mqtt_start == MQTT_START_VERIFY_SUBSCRIBE3) {
           if (stored_config_settings & 0x02) {
             // Home Assistant Auto Discovery enabled
+#if MQTT_DISCOVERY_FINGERPRINT == 0
             mqtt_start = MQTT_START_QUEUE_PUBLISH_AUTO;
+#endif // MQTT_DISCOVERY_FINGERPRINT == 0
+#if MQTT_DISCOVERY_FINGERPRINT == 1
+            // Check the retained fingerprint before publishing
+            mqtt_start = MQTT_START_QUEUE_SUBSCRIBE4;
+#endif // MQTT_DISCOVERY_FINGERPRINT == 1
             auto_discovery = DEFINE_INPUTS;
             auto_discovery_step = SEND_OUTPUT_DELETE;
             pin_ptr = 1;
@@ -2091,10 +3078,18 @@ void mqtt_startup(void)
             mqtt_start = MQTT_START_QUEUE_PUBLISH_ON;
           }
 	}
+#if MQTT_DISCOVERY_FINGERPRINT == 1
+        if (mqtt_start == MQTT_START_VERIFY_SUBSCRIBE4) mqtt_start = MQTT_START_VERIFY_FINGERPRINT;
+#endif // MQTT_DISCOVERY_FINGERPRINT == 1
       }
     }
     else {
+#if MQTT_RECONNECT_BACKOFF == 0
       mqtt_start = MQTT_START_TCP_CONNECT;
+#endif // MQTT_RECONNECT_BACKOFF == 0
+#if MQTT_RECONNECT_BACKOFF == 1
+      mqtt_reconnect_backoff();
+#endif // MQTT_RECONNECT_BACKOFF == 1
       // Clear the error indicator flags
       mqtt_start_status = MQTT_START_NOT_STARTED; 
     }
@@ -2180,7 +3175,12 @@ void mqtt_startup(void)
       }
     }
     else {
+#if MQTT_RECONNECT_BACKOFF == 0
       mqtt_start = MQTT_START_TCP_CONNECT;
+#endif // MQTT_RECONNECT_BACKOFF == 0
+#if MQTT_RECONNECT_BACKOFF == 1
+      mqtt_reconnect_backoff();
+#endif // MQTT_RECONNECT_BACKOFF == 1
       // Clear the error indicator flags
       mqtt_start_status = MQTT_START_NOT_STARTED; 
     }
@@ -2188,15 +3188,46 @@ void mqtt_startup(void)
 #endif // DOMOTICZ_SUPPORT == 1
 
 
+#if HOME_ASSISTANT_SUPPORT == 1 && MQTT_DISCOVERY_FINGERPRINT == 1
+  case MQTT_START_VERIFY_FINGERPRINT:
+    // Wait up to 1 second for the retained Auto Discovery fingerprint. If
+    // publish_callback found that it matches the current config the Home
+    // Assistant config messages retained on the Broker are still valid and
+    // Auto Discovery is skipped. If nothing arrives (first startup, or the
+    // Broker lost its retained messages) or the config changed, all Auto
+    // Discovery messages are published. A PCF8574 "force pin delete"
+    // request always runs Auto Discovery.
+    if ((discovery_match == 1) && ((stored_options1 & 0x20) == 0x00)) {
+      mqtt_start_ctr1 = 0; // Clear 50ms counter
+      mqtt_start = MQTT_START_QUEUE_PUBLISH_ON;
+    }
+    else if (mqtt_start_ctr1 > 20) {
+      mqtt_start = MQTT_START_QUEUE_PUBLISH_AUTO;
+    }
+    break;
+#endif // HOME_ASSISTANT_SUPPORT == 1 && MQTT_DISCOVERY_FINGERPRINT == 1
+
+
 #if HOME_ASSISTANT_SUPPORT == 1
   case MQTT_START_QUEUE_PUBLISH_AUTO:
+#if MQTT_DISCOVERY_BURST == 0
     if (mqtt_start_ctr1 > 2) {
+#endif // MQTT_DISCOVERY_BURST == 0
+#if MQTT_DISCOVERY_BURST == 1
+    // Queue the next message as soon as its placeholder fits in the
+    // mqtt_sendbuf. The placeholders for a pin's delete and define messages
+    // fit together and are expanded into one TCP segment by
+    // mqtt_pal_sendall().
+    if (mqtt_check_sendbuf(&mqttclient) >=
+      ((auto_discovery == DEFINE_TEMP_SENSORS) ? AUTO_SENSOR_MSG_SIZE : AUTO_PIN_MSG_SIZE)) {
+#endif // MQTT_DISCOVERY_BURST == 1
       // Publish Home Assistant Auto Discovery messages
       // This part of the state machine runs only if Home Assistant Auto
       // Discovery is enabled.
-      // This step of the state machine is executed every 100 to 200 ms and is
-      // entered multiple times until all Home Assistant Auto Discovery
-      // Config PUBLISH messages are sent.
+      // This step of the state machine is executed every 100 to 200 ms (or
+      // with MQTT_DISCOVERY_BURST whenever there is room in the
+      // mqtt_sendbuf) and is entered multiple times until all Home
+      // Assistant Auto Discovery Config PUBLISH messages are sent.
       //
       //---------------------------------------------------------------------//
       // This function will create a "placeholder" PUBLISH message. The
@@ -2484,6 +3515,12 @@ void mqtt_startup(void)
       }
 
       else if (auto_discovery == DEFINE_TEMP_SENSORS) {
+#if MQTT_BULK_STATE == 1
+        // Sensor values are only published in the bulk state message, so
+        // no sensor config messages are sent.
+        auto_discovery = AUTO_COMPLETE;
+#endif // MQTT_BULK_STATE == 1
+#if MQTT_BULK_STATE == 0
 #if DS18B20_SUPPORT == 1
         define_temp_sensors();    // define_temp_sensors will be called
 	                          // repeatedly until all temp sensors are
@@ -2499,13 +3536,19 @@ void mqtt_startup(void)
 				  // auto_discovery = AUTO_COMPLETE when
 	                          // all BME280 sensors are defined.
 #endif // BME280_SUPPORT == 1
+#endif // MQTT_BULK_STATE == 0
       }
 
       mqtt_start_ctr1 = 0; // Clear the 50ms counter
       if (auto_discovery == AUTO_COMPLETE) {
         uint8_t j;
         auto_discovery_step = STEP_NULL;
+#if MQTT_DISCOVERY_FINGERPRINT == 0
         mqtt_start = MQTT_START_QUEUE_PUBLISH_ON;
+#endif // MQTT_DISCOVERY_FINGERPRINT == 0
+#if MQTT_DISCOVERY_FINGERPRINT == 1
+        mqtt_start = MQTT_START_QUEUE_PUBLISH_FINGERPRINT;
+#endif // MQTT_DISCOVERY_FINGERPRINT == 1
 	// Clear the PCF8574 "force pin delete" indicator if it is set
 	if ((stored_options1 & 0x20) == 0x20) {
 	  j = stored_options1;
@@ -2518,14 +3561,32 @@ void mqtt_startup(void)
 #endif // HOME_ASSISTANT_SUPPORT == 1
 
 
+#if HOME_ASSISTANT_SUPPORT == 1 && MQTT_DISCOVERY_FINGERPRINT == 1
+  case MQTT_START_QUEUE_PUBLISH_FINGERPRINT:
+    if (mqtt_start_ctr1 > 4) {
+      // Wait 200ms before queuing the Auto Discovery fingerprint PUBLISH
+      // message. It is retained so that the next MQTT startup can tell if
+      // the config messages just published are still current.
+      // This message is always published with QOS 0.
+      stpcpy(topic_prefix_copy(topic_base), "/discovery");
+      mqtt_publish(&mqttclient,
+                   topic_base,
+                   discovery_fingerprint,
+                   4,
+                   MQTT_PUBLISH_QOS_0 | MQTT_PUBLISH_RETAIN);
+      mqtt_start_ctr1 = 0; // Clear the 50ms counter
+      mqtt_start = MQTT_START_QUEUE_PUBLISH_ON;
+    }
+    break;
+#endif // HOME_ASSISTANT_SUPPORT == 1 && MQTT_DISCOVERY_FINGERPRINT == 1
+
+
 #if HOME_ASSISTANT_SUPPORT == 1
   case MQTT_START_QUEUE_PUBLISH_ON:
     if (mqtt_start_ctr1 > 4) {
       // Wait 200ms before queuing the "availability online" PUBLISH message.
       // This message is always published with QOS 0.
-      strcpy(topic_base, devicetype);
-      strcat(topic_base, stored_devicename);
-      strcat(topic_base, "/availability");
+      stpcpy(topic_prefix_copy(topic_base), "/availability");
       mqtt_publish(&mqttclient,
                    topic_base,
                    "online",
@@ -2562,6 +3623,23 @@ void mqtt_startup(void)
 #if PCF8574_SUPPORT == 1 || DOMOTICZ_SUPPORT == 1
       ON_OFF_word_sent = (uint32_t)(~ON_OFF_word);
 #endif // PCF8574_SUPPORT == 1 || DOMOTICZ_SUPPORT == 1
+#if MQTT_QOS1_PINSTATE == 1
+      // Every pin is published again so PUBACKs outstanding from the
+      // previous connection are no longer needed.
+      memset(pinstate_pending, 0, sizeof(pinstate_pending));
+      pinstate_pending_count = 0;
+#endif // MQTT_QOS1_PINSTATE == 1
+#if MQTT_DIRECT_PUBLISH == 1
+      // Pin states waiting from the previous connection are published
+      // again anyway.
+      direct_publish_head = 0;
+      direct_publish_count = 0;
+#endif // MQTT_DIRECT_PUBLISH == 1
+#if MQTT_RECONNECT_BACKOFF == 1
+      // The connection is good so the next reconnect starts with the
+      // shortest backoff window.
+      mqtt_backoff_count = 0;
+#endif // MQTT_RECONNECT_BACKOFF == 1
       // Indicate succesful completion
 #if DEBUG_SUPPORT == 15
 // UARTPrintf("MQTT Startup Complete\r\n");
@@ -2574,6 +3652,57 @@ void mqtt_startup(void)
 #endif // BUILD_SUPPORT == MQTT_BUILD
 
 
+#if BUILD_SUPPORT == MQTT_BUILD
+char *topic_prefix_copy(unsigned char *topic)
+{
+  // This function places "NetworkModule/<devicename>" at the start of a
+  // topic string and returns a pointer to the terminating '\0' so the
+  // caller can append the rest of the topic with stpcpy(). With
+  // MQTT_TOPIC_PREFIX the prefix is copied from the RAM table built at
+  // MQTT startup instead of being rebuilt from flash and EEPROM.
+#if MQTT_TOPIC_PREFIX == 1
+  memcpy(topic, topic_prefix, topic_prefix_len + 1);
+  return (char *)topic + topic_prefix_len;
+#endif // MQTT_TOPIC_PREFIX == 1
+#if MQTT_TOPIC_PREFIX == 0
+  return stpcpy(stpcpy((char *)topic, (char *)devicetype), (char *)stored_devicename);
+#endif // MQTT_TOPIC_PREFIX == 0
+}
+#endif // BUILD_SUPPORT == MQTT_BUILD
+
+
+#if BUILD_SUPPORT == MQTT_BUILD && MQTT_RECONNECT_BACKOFF == 1
+void mqtt_reconnect_backoff(void)
+{
+  // This function schedules the next MQTT connection attempt after a failed
+  // attempt or a lost connection. The delay is a random number of seconds
+  // within a window that doubles with each failed attempt, from
+  // MQTT_BACKOFF_BASE seconds up to MQTT_BACKOFF_BASE << MQTT_BACKOFF_STEPS
+  // seconds. The random number generator is seeded from the MAC address
+  // and the uptime so that modules that all lost the same Broker spread
+  // their reconnects across the window instead of retrying in lockstep.
+  uint16_t window;
+  uint16_t lsb;
+
+  if (mqtt_backoff_lfsr == 0) {
+    mqtt_backoff_lfsr = (uint16_t)((stored_uip_ethaddr_oct[1] << 8) | stored_uip_ethaddr_oct[0]);
+    mqtt_backoff_lfsr ^= (uint16_t)second_counter;
+    if (mqtt_backoff_lfsr == 0) mqtt_backoff_lfsr = 163u;
+  }
+  // Same LFSR taps as mqtt_next_pid()
+  lsb = mqtt_backoff_lfsr & 1;
+  mqtt_backoff_lfsr >>= 1;
+  if (lsb) mqtt_backoff_lfsr ^= 0xB400u;
+
+  window = (uint16_t)(MQTT_BACKOFF_BASE << mqtt_backoff_count);
+  if (mqtt_backoff_count < MQTT_BACKOFF_STEPS) mqtt_backoff_count++;
+
+  mqtt_backoff_until = second_counter + 1 + (mqtt_backoff_lfsr % window);
+  mqtt_start = MQTT_START_RECONNECT_WAIT;
+}
+#endif // BUILD_SUPPORT == MQTT_BUILD && MQTT_RECONNECT_BACKOFF == 1
+
+
 #if BUILD_SUPPORT == MQTT_BUILD && HOME_ASSISTANT_SUPPORT == 1
 #if DS18B20_SUPPORT == 1
 void define_temp_sensors(void)
@@ -2680,35 +3809,121 @@ void define_BME280_sensors(void)
 
 
 #if BUILD_SUPPORT == MQTT_BUILD && HOME_ASSISTANT_SUPPORT == 1
-void send_IOT_msg(uint8_t IOT_ptr, uint8_t IOT, uint8_t DefOrDel)
+#if MQTT_DISCOVERY_FINGERPRINT == 1
+static uint16_t fingerprint_add(uint16_t fp, const uint8_t *p, uint8_t len)
 {
-  // Format and send IO delete/define messages and sensor delete/define
-  // messages.
+  // Add len bytes to the fingerprint (16 bit version of the djb2 hash)
+  while (len--) fp = (uint16_t)((fp << 5) + fp + *p++);
+  return fp;
+}
+
+
+void calc_discovery_fingerprint(void)
+{
+  // This function is called from the mqtt_startup function before the
+  // retained Auto Discovery fingerprint is subscribed to.
   // This function is applicable only to Home Assistant Auto Discovery.
-  // For IOT == INPUTMSG or OUTPUTMSG the IOT_ptr indicates the pin number
-  //   (1 to 16) that is being messaged.
-  // For IOT == TMPRMSG the IOT_PTR indicates the sensor number (0 to 4) that
-  //   is being messaged.
-  unsigned char app_message[16]; // Stores the application message (the
-                                 // payload) that will be sent in an MQTT
-				 // message.
-				 // For Input or Output IO messages
-				 //   app_message[2] to [5] contains the pin
-				 //   number allowing app_message to be used
-				 //   in creating the topic part of the
-				 //   message
-				 // For Temperature Sensor messages
-				 //   app_message[2] to [14] contains the
-				 //   sensor ID allowing app_message to be
-				 //   used in creating the topic part of the
-				 //   message.
-  unsigned char topic_base[55]; // Used for building connect, subscribe,
-                                // and publish topic strings.
-				// Publish string content:
-                                //  NetworkModule/DeviceName123456789/input/xx
-                                //  NetworkModule/DeviceName123456789/output/xx
-                                //  NetworkModule/DeviceName123456789/temp/xxxxxxxxxxxx
-                                //  NetworkModule/DeviceName123456789/temp/BME280-0xxxx
+  //
+  // The fingerprint covers everything that goes into the Auto Discovery
+  // config messages: the type of each pin, the number of pins, the
+  // enabled sensors and their IDs, the device name, the MAC and the code
+  // revision. The result is stored in discovery_fingerprint as 4 hex
+  // characters, which is also the payload of the retained PUBLISH.
+  uint16_t fp;
+  uint8_t i;
+  uint8_t k;
+  uint8_t iotype;
+#if OB_EEPROM_SUPPORT == 1 && DS18B20_SUPPORT == 1
+  // If I2C EEPROM is supported the FoundROM[][] table is located in I2C
+  // EEPROM and is copied to a stack based FoundROM[][] array for use here.
+  uint8_t FoundROM[5][8];           // Table of ROM codes
+#endif // OB_EEPROM_SUPPORT == 1 && DS18B20_SUPPORT == 1
+
+  fp = 5381;
+
+#if PCF8574_SUPPORT == 0
+  k = 16;
+#endif // PCF8574_SUPPORT == 0
+#if PCF8574_SUPPORT == 1
+  if ((stored_options1 & 0x08)) k = 24;
+  else k = 16;
+#endif // PCF8574_SUPPORT == 1
+  fp = fingerprint_add(fp, &k, 1);
+  for (i=0; i<k; i++) {
+#if LINKED_SUPPORT == 0
+    iotype = (uint8_t)(pin_control[i] & 0x03);
+#endif // LINKED_SUPPORT == 0
+#if LINKED_SUPPORT == 1
+    iotype = chk_iotype(pin_control[i], i, 0x03);
+#endif // LINKED_SUPPORT == 1
+    fp = fingerprint_add(fp, &iotype, 1);
+  }
+
+  // DS18B20 and BME280 enable bits
+  iotype = (uint8_t)(stored_config_settings & 0x28);
+  fp = fingerprint_add(fp, &iotype, 1);
+
+#if DS18B20_SUPPORT == 1
+  if (stored_config_settings & 0x08) {
+#if OB_EEPROM_SUPPORT == 1
+    copy_I2C_EEPROM_bytes_to_RAM(&FoundROM[0][0], 40, I2C_EEPROM_R1_WRITE, I2C_EEPROM_R1_READ, I2C_EEPROM_R1_FOUNDROM, 2);
+#endif // OB_EEPROM_SUPPORT == 1
+    // Add the serial number of each sensor found (numROMs is -1 if no
+    // sensor was found)
+    for (i=0; i<=numROMs; i++) fp = fingerprint_add(fp, &FoundROM[i][1], 6);
+  }
+#endif // DS18B20_SUPPORT == 1
+
+#if BME280_SUPPORT == 1
+  fp = fingerprint_add(fp, &BME280_found, 1);
+#endif // BME280_SUPPORT == 1
+
+  fp = fingerprint_add(fp, stored_devicename, (uint8_t)strlen(stored_devicename));
+  fp = fingerprint_add(fp, (const uint8_t *)mac_string, 12);
+  fp = fingerprint_add(fp, (const uint8_t *)code_revision, (uint8_t)strlen(code_revision));
+
+  int2hex((uint8_t)(fp >> 8));
+  discovery_fingerprint[0] = OctetArray[0];
+  discovery_fingerprint[1] = OctetArray[1];
+  int2hex((uint8_t)fp);
+  discovery_fingerprint[2] = OctetArray[0];
+  discovery_fingerprint[3] = OctetArray[1];
+  discovery_fingerprint[4] = '\0';
+}
+#endif // MQTT_DISCOVERY_FINGERPRINT == 1
+#endif // BUILD_SUPPORT == MQTT_BUILD && HOME_ASSISTANT_SUPPORT == 1
+
+
+#if BUILD_SUPPORT == MQTT_BUILD && HOME_ASSISTANT_SUPPORT == 1
+void send_IOT_msg(uint8_t IOT_ptr, uint8_t IOT, uint8_t DefOrDel)
+{
+  // Format and send IO delete/define messages and sensor delete/define
+  // messages.
+  // This function is applicable only to Home Assistant Auto Discovery.
+  // For IOT == INPUTMSG or OUTPUTMSG the IOT_ptr indicates the pin number
+  //   (1 to 16) that is being messaged.
+  // For IOT == TMPRMSG the IOT_PTR indicates the sensor number (0 to 4) that
+  //   is being messaged.
+  unsigned char app_message[16]; // Stores the application message (the
+                                 // payload) that will be sent in an MQTT
+				 // message.
+				 // For Input or Output IO messages
+				 //   app_message[2] to [5] contains the pin
+				 //   number allowing app_message to be used
+				 //   in creating the topic part of the
+				 //   message
+				 // For Temperature Sensor messages
+				 //   app_message[2] to [14] contains the
+				 //   sensor ID allowing app_message to be
+				 //   used in creating the topic part of the
+				 //   message.
+  unsigned char topic_base[55]; // Used for building connect, subscribe,
+                                // and publish topic strings.
+				// Publish string content:
+                                //  NetworkModule/DeviceName123456789/input/xx
+                                //  NetworkModule/DeviceName123456789/output/xx
+                                //  NetworkModule/DeviceName123456789/temp/xxxxxxxxxxxx
+                                //  NetworkModule/DeviceName123456789/temp/BME280-0xxxx
                                 //  NetworkModule/DeviceName123456789/state
                                 //  NetworkModule/DeviceName123456789/state24
 				//  NetworkModule/DeviceName123456789/state-req
@@ -2857,6 +4072,11 @@ void mqtt_sanity_check(struct mqtt_client *client)
   // This is similar to a firmware restart except it is focused on restarting
   // only the MQTT components.  The process is triggered every XX seconds IF
   // we don't have an MQTT connection.
+#if UDP_LOG_SUPPORT == 1
+  uint8_t prior_step;
+
+  prior_step = mqtt_restart_step;
+#endif // UDP_LOG_SUPPORT == 1
   //
   // Check the MQTT connection. This is limited to once every X seconds to
   // reduce the processing consumed by restart attempts.
@@ -2997,10 +4217,21 @@ void mqtt_sanity_check(struct mqtt_client *client)
     // Set mqtt_restart_step and mqtt_start to re-run the MQTT connection
     // steps in the main loop
     mqtt_restart_step = MQTT_RESTART_IDLE;
+#if MQTT_RECONNECT_BACKOFF == 0
     mqtt_start = MQTT_START_TCP_CONNECT;
+#endif // MQTT_RECONNECT_BACKOFF == 0
+#if MQTT_RECONNECT_BACKOFF == 1
+    // Wait a random part of the backoff window so that modules that lost
+    // the Broker at the same moment do not all reconnect at once.
+    mqtt_reconnect_backoff();
+#endif // MQTT_RECONNECT_BACKOFF == 1
     break;
     
   } // end switch
+
+#if UDP_LOG_SUPPORT == 1
+  if (mqtt_restart_step != prior_step) UDP_LOG(UDP_LOG_MQTT, mqtt_restart_step);
+#endif // UDP_LOG_SUPPORT == 1
 }
 #endif // BUILD_SUPPORT == MQTT_BUILD
 
@@ -3180,18 +4411,32 @@ void publish_callback(void** unused, struct mqtt_response_publish *published)
   //   OR
   // - Set the state_request variable
   
-  // Set the pBuffer pointer to the start of the MQTT packet
+  // Set the pBuffer pointer to the start of the topic name. The message
+  // may be in the MQTT Partial Buffer or still in place in the uip_buf, so
+  // the topic pointer from mqtt_unpack_publish_response() is used rather
+  // than a fixed uip_buf offset.
   
-  pBuffer = &uip_buf[MQTT_PBUF];
+  pBuffer = (char *)published->topic_name;
 
-  // Skip the Fixed Header Control Byte (1 byte)
-  // Skip the Fixed Header Remaining Length Byte (1 byte)
-  // Skip the Topic name length bytes (2 bytes)
   // Skip the NetworkModule/ text (14 bytes)
-  pBuffer += 18;
+  pBuffer += 14;
+#if MQTT_PERSISTENT_SESSION == 1
+  // A kept session may still hold the wildcard subscription of a previous
+  // devicename. Ignore messages that are not for this devicename.
+  i = strlen(stored_devicename);
+  if (strncmp(pBuffer, stored_devicename, i) != 0 || pBuffer[i] != '/') return;
+  i = 0;
+#endif // MQTT_PERSISTENT_SESSION == 1
   // Skip the Devicename/ text
   pBuffer += strlen(stored_devicename) + 1;
   
+#if MQTT_PERSISTENT_SESSION == 1
+  // The device wildcard subscription also returns this device's own
+  // output/xx state publishes. Only the output commands end with "set".
+  if (*pBuffer == 'o'
+   && memcmp(published->topic_name + published->topic_name_size - 3, "set", 3) != 0) return;
+#endif // MQTT_PERSISTENT_SESSION == 1
+  
   // Determine if the sub-topic is "output" or "state-req"
   if (*pBuffer == 'o') {
     // "output" detected
@@ -3321,8 +4566,26 @@ void publish_callback(void** unused, struct mqtt_response_publish *published)
     // HTML, ie, changed the pin_control byte. So we need to set the 
     // mqtt_parse_complete value so that the check_runtime_changes() function
     // will perform the necessary IO actions.
+#if COMMAND_RATE_LIMIT == 0
     mqtt_parse_complete = 1;
+#endif // COMMAND_RATE_LIMIT == 0
+#if COMMAND_RATE_LIMIT == 1
+    mqtt_command_complete();
+#endif // COMMAND_RATE_LIMIT == 1
+  }
+  
+#if MQTT_DISCOVERY_FINGERPRINT == 1
+  // Determine if the sub-topic is "discovery". The payload is the retained
+  // Auto Discovery fingerprint. It is only checked during MQTT startup in
+  // MQTT_START_VERIFY_FINGERPRINT, so the copy the Broker echoes back after
+  // this device publishes it is harmless.
+  else if (*pBuffer == 'd') {
+    if ((published->application_message_size == 4)
+     && (memcmp(published->application_message, discovery_fingerprint, 4) == 0)) {
+      discovery_match = 1;
+    }
   }
+#endif // MQTT_DISCOVERY_FINGERPRINT == 1
   
   // Determine if the sub-topic is "state-req" or "state_req24".
   // This Topic should always be received at QOS 0.
@@ -3377,11 +4640,60 @@ void publish_callback(void** unused, struct mqtt_response_publish *published)
 
 
 #if BUILD_SUPPORT == MQTT_BUILD && DOMOTICZ_SUPPORT == 1
+// Domoticz IDX lookup table. An inbound domoticz/out command is matched to a
+// pin by comparing a 16 bit hash of its idx with the hash of each pin IDX
+// value, and only the pin with the same hash has its IDX string compared.
+// This replaces a strcmp against every IO_NAME in Flash and, with the
+// PCF8574, 8 reads of the IDX values from the I2C EEPROM for each command.
+// The table is built on the first command after boot or after the IDX
+// values are changed (idx_hash_valid is cleared by the POST parser).
+#if PCF8574_SUPPORT == 0
+#define IDX_HASH_PINS	16
+#endif // PCF8574_SUPPORT == 0
+#if PCF8574_SUPPORT == 1
+#define IDX_HASH_PINS	24
+#endif // PCF8574_SUPPORT == 1
+uint16_t idx_hash[IDX_HASH_PINS];    // Hash of the IDX value of each pin
+uint8_t idx_hash_valid;              // 1 if idx_hash[] is up to date
+
+
+static uint16_t idx_hash_string(const char* pString)
+{
+  // Hash of an IDX string (h = h * 31 + c over the characters)
+  uint16_t h;
+
+  h = 0;
+  while (*pString) h = (uint16_t)((h << 5) - h + (uint8_t)*pString++);
+  return h;
+}
+
+
+static void idx_hash_build(void)
+{
+  int i;
+#if PCF8574_SUPPORT == 1
+  char temp_byte[16];
+#endif // PCF8574_SUPPORT == 1
+
+  for (i=0; i<16; i++) idx_hash[i] = idx_hash_string(IO_NAME[i]);
+#if PCF8574_SUPPORT == 1
+  for (i=16; i<24; i++) {
+    // Read a PCF8574_IO_NAME value from I2C EEPROM
+    copy_I2C_EEPROM_bytes_to_RAM(&temp_byte[0], 16, I2C_EEPROM_R2_WRITE, I2C_EEPROM_R2_READ, PCF8574_I2C_EEPROM_R2_START_IO_NAMES + ((i - 16) * 16), 2);
+    temp_byte[15] = '\0';
+    idx_hash[i] = idx_hash_string(temp_byte);
+  }
+#endif // PCF8574_SUPPORT == 1
+  idx_hash_valid = 1;
+}
+
+
 void publish_callback(void** unused, struct mqtt_response_publish *published)
 {
   uint8_t ParseNum;
   uint8_t error;
   uint8_t match_found;
+  uint16_t h;
   int i;
 
   ParseNum = 0;
@@ -3439,43 +4751,30 @@ void publish_callback(void** unused, struct mqtt_response_publish *published)
     
     // Assumption is that the idx value is never greater than 6 digits and
     // there are no leading zeroes.
+    if (idx_hash_valid == 0) idx_hash_build();
+    h = idx_hash_string(idx_string);
     match_found = 0;
-    for (i=0; i<16; i++) {
-#if DEBUG_SUPPORT == 15
-// UARTPrintf("IO_NAME = ");
-// UARTPrintf(IO_NAME[i]);
-// UARTPrintf("\r\n");
-#endif // DEBUG_SUPPORT == 15
-      if (strcmp(idx_string, IO_NAME[i]) == 0) {
-        // Found a match
-	match_found = 1;
-	ParseNum = (uint8_t)i;
-	break;
+    for (i=0; i<IDX_HASH_PINS; i++) {
+      if (idx_hash[i] != h) continue;
+      // The hash matches. Confirm with the IDX string in case two IDX
+      // values have the same hash.
+      if (i < 16) {
+        if (strcmp(idx_string, IO_NAME[i]) == 0) match_found = 1;
       }
-    }
-    
 #if PCF8574_SUPPORT == 1
-    {
-      int j;
-      char temp_byte[16];
-      for (i=16; i<24; i++) {
+      else {
+        char temp_byte[16];
         // Read a PCF8574_IO_NAME value from I2C EEPROM
         copy_I2C_EEPROM_bytes_to_RAM(&temp_byte[0], 16, I2C_EEPROM_R2_WRITE, I2C_EEPROM_R2_READ, PCF8574_I2C_EEPROM_R2_START_IO_NAMES + ((i - 16) * 16), 2);
-
-#if DEBUG_SUPPORT == 15
-// UARTPrintf("IO_NAME = ");
-// UARTPrintf(temp_byte);
-// UARTPrintf("\r\n");
-#endif // DEBUG_SUPPORT == 15
-        if (strcmp(idx_string, temp_byte) == 0) {
-          // Found a match
-	  match_found = 1;
-	  ParseNum = (uint8_t)i;
-	  break;
-        }
+        temp_byte[15] = '\0';
+        if (strcmp(idx_string, temp_byte) == 0) match_found = 1;
       }
-    }
 #endif // PCF8574_SUPPORT == 1
+      if (match_found) {
+	ParseNum = (uint8_t)i;
+	break;
+      }
+    }
     
     if (match_found == 0) {
       // Do nothing. The idx value is bogus.
@@ -3548,7 +4847,12 @@ void publish_callback(void** unused, struct mqtt_response_publish *published)
   // HTML, ie, changed the pin_control byte. So we need to set the 
   // mqtt_parse_complete value so that the check_runtime_changes() function
   // will perform the necessary IO actions.
+#if COMMAND_RATE_LIMIT == 0
   mqtt_parse_complete = 1;
+#endif // COMMAND_RATE_LIMIT == 0
+#if COMMAND_RATE_LIMIT == 1
+  mqtt_command_complete();
+#endif // COMMAND_RATE_LIMIT == 1
   // Note: if none of the above matched the parsing we just exit without
   // executing any functionality (the message is effectively ignored).
 }
@@ -3563,15 +4867,16 @@ void publish_outbound(void)
   // function also checks for a state_request and sends the 2 byte "all pin
   // states" message as a response.
   //
-  // Something I don't understand and have mentioned elsewhere: Queueing
-  // multiple PUBLISH messages doesn't work. I have to get any PUBLISH
-  // message placed in the queue completely transmitted before I can queue
-  // another. On the other hand we are so constrained by lack of RAM that we
-  // couldn't queue more than 3 or 4 publish messages anyway, so an
-  // alternative is necessary.
+  // Queueing multiple PUBLISH messages originally didn't work. mqtt_send()
+  // copied one queued message per call to the start of the uip_buf, and the
+  // calls made while mqtt_sync() was reading a received TCP packet could
+  // overwrite data that had not been read yet. mqtt_send() now appends queued
+  // messages to the uip_buf until the TCP segment is full and holds off
+  // while received data is being read. We are still so constrained by lack
+  // of RAM that we couldn't queue more than 3 or 4 publish messages anyway.
   //
-  // The workaround implemented is to queue one message, return to the main
-  // loop to let it transmit, then come back here and queue the next message.
+  // The approach implemented is to queue messages, return to the main
+  // loop to let them transmit, then come back here and queue the next ones.
   // But this means we need to track the input pin changes differently. For
   // instance, if more than one pin changes at a time, but we can only send
   // the message for one pin at a time, we need to track what was sent.
@@ -3587,6 +4892,12 @@ void publish_outbound(void)
   // a message at the periodic_timer_expired(), thus it takes at least 16
   // expirations to get all bits sent, and frequent changes in higher order
   // bits will supersede the processing of lower order bits.
+  //
+  // With MQTT_BATCH_PUBLISH the pin state PUBLISH packets are appended to
+  // one queued message (see mqtt_publish_append()) until the mqtt_sendbuf
+  // is full, so several pins are sent per call in one TCP segment. When the
+  // mqtt_sendbuf fills the scan position is saved in publish_scan_pin and
+  // the next call resumes there, so every changed pin is reached in turn.
 
 #if PCF8574_SUPPORT == 0 && DOMOTICZ_SUPPORT == 0
   uint16_t xor_tmp;
@@ -3599,24 +4910,39 @@ void publish_outbound(void)
 
   int i;
   int signal_break;
+#if MQTT_BATCH_PUBLISH == 1
+  int top;
+  int scan_count;
+#endif // MQTT_BATCH_PUBLISH == 1
 
   signal_break = 0;
 
+#if MQTT_QOS1_PINSTATE == 1
+  // Schedule a new PUBLISH for any pin state that was not acknowledged
+  pinstate_check_pending();
+#endif // MQTT_QOS1_PINSTATE == 1
+
   // Check the mqtt_sendbuf to make sure it is emptied before PUBLISHing a
   // pin_state message. This is to prevent overflow of the mqtt_sendbuf when
   // Home Assistant pushes a large number of PUBLISH request messages.
   // This check effectively acts aa a throttle on the publish_outbound
   // process.
-  if (!(mqtt_check_sendbuf(&mqttclient) > (MQTT_SENDBUF_SIZE - 15))) {
+  if (!(mqtt_check_sendbuf(&mqttclient) > (MQTT_MQ_DATA_SIZE - 1))) {
     // mqtt_check_sendbuf() returns the amount of space left in the
-    // mqtt_sendbuf. We want to make sure it is empty except for the
-    // 12 byte Message Queue, so we check that only 15 bytes are used.
+    // mqtt_sendbuf. We want to make sure it is empty, so we check that
+    // the whole message data area is free.
     // If mqtt_sendbuf is not empty we exit but wlll come back later and
     // check again. It should empty quickly as the main loop will be
     // calling the MQTT routines to transmit whatever is there.
     return;
   }
 
+#if MQTT_DIRECT_PUBLISH == 1
+  // Pin state PUBLISH messages wait in the direct publish queue instead of
+  // the mqtt_sendbuf. Wait until there is room for at least one.
+  if (PINSTATE_QUEUE_FULL()) return;
+#endif // MQTT_DIRECT_PUBLISH == 1
+
   if (state_request == STATE_REQUEST_IDLE) {
     // STATE_REQUEST_IDLE is the normal state indicating that a state-req
     // message has not been received thus pin states can be transmitted if
@@ -3632,6 +4958,11 @@ void publish_outbound(void)
     xor_tmp = (uint32_t)(ON_OFF_word ^ ON_OFF_word_sent);
 #endif // PCF8574_SUPPORT == 1 || DOMOTICZ_SUPPORT == 1
 
+#if PIN_CAPTURE_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD
+    // Collect the Input pin edges captured since the last call
+    pin_pulse |= pin_capture_take();
+#endif // PIN_CAPTURE_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD
+
 #if PCF8574_SUPPORT == 0 && DOMOTICZ_SUPPORT == 0
     i = 15;
     j = 0x8000;
@@ -3647,13 +4978,43 @@ void publish_outbound(void)
     }
 #endif // PCF8574_SUPPORT == 1 || DOMOTICZ_SUPPORT == 1
 
+#if MQTT_BATCH_PUBLISH == 1
+    // Resume the scan where the previous call ran out of mqtt_sendbuf space
+    // and scan each pin once, wrapping from pin 0 back to the top pin.
+    top = i;
+    scan_count = i + 1;
+    if (publish_scan_pin < top) {
+      i = publish_scan_pin;
+      j = 1;
+      j <<= i;
+    }
+#endif // MQTT_BATCH_PUBLISH == 1
+
     while ( 1 ) {
 
-#if DS18B20_SUPPORT == 1
+#if MQTT_BATCH_PUBLISH == 1
+      // Stop if there is no room for another pin state PUBLISH. The pin
+      // being examined is the first one checked on the next call.
+      if (PINSTATE_QUEUE_FULL()) {
+        publish_scan_pin = (uint8_t)i;
+        break;
+      }
+#endif // MQTT_BATCH_PUBLISH == 1
+
+#if HOME_ASSISTANT_SUPPORT == 1 && MQTT_BULK_STATE == 1
+      // Check if a new sensor sample needs to be Published. All sensor
+      // values go out in one bulk state PUBLISH. It is only queued while no
+      // pin state PUBLISH is queued in this pass so it has the whole
+      // mqtt_sendbuf.
+      if (signal_break == 0 && publish_bulk_state()) break;
+#endif // HOME_ASSISTANT_SUPPORT == 1 && MQTT_BULK_STATE == 1
+
+#if DS18B20_SUPPORT == 1 && (HOME_ASSISTANT_SUPPORT == 0 || MQTT_BULK_STATE == 0)
       // Check if DS18B20 is enabled, and if yes check if a Temperature
       // Publish needs to occur.
       if (stored_config_settings & 0x08) { // DS18B20 enabled?
-        if (j == 0x8000) { // Servicing IO 16?
+        if (j == 0x8000 && signal_break == 0) {
+	  // Servicing IO 16 and no pin state PUBLISH queued in this pass?
 	  if (send_mqtt_temperature >= 0) {
 	    publish_temperature(send_mqtt_temperature);
 	    send_mqtt_temperature--;
@@ -3661,9 +5022,9 @@ void publish_outbound(void)
 	  }
 	}
       }
-#endif // DS18B20_SUPPORT == 1
+#endif // DS18B20_SUPPORT == 1 && (HOME_ASSISTANT_SUPPORT == 0 || MQTT_BULK_STATE == 0)
 
-#if BME280_SUPPORT == 1 && HOME_ASSISTANT_SUPPORT == 1
+#if BME280_SUPPORT == 1 && HOME_ASSISTANT_SUPPORT == 1 && MQTT_BULK_STATE == 0
       // Check if BME280 is enabled, and if yes check if a Sensor
       // Publish needs to occur.
       if (stored_config_settings & 0x20) { // BME280 enabled?
@@ -3673,7 +5034,34 @@ void publish_outbound(void)
 	  break;
 	}
       }
-#endif // BME280_SUPPORT == 1 && HOME_ASSISTANT_SUPPORT == 1
+#endif // BME280_SUPPORT == 1 && HOME_ASSISTANT_SUPPORT == 1 && MQTT_BULK_STATE == 0
+
+#if PROFILE_SUPPORT == 1
+      // Check if a profiling statistics Publish needs to occur.
+      if (send_mqtt_profile >= 0) {
+        publish_profile((uint8_t)send_mqtt_profile);
+        send_mqtt_profile--;
+        break;
+      }
+#endif // PROFILE_SUPPORT == 1
+
+#if PAGE_STATISTICS == 1
+      // Check if a page statistics Publish needs to occur.
+      if (send_mqtt_pagestats >= 0) {
+        publish_pagestats((uint8_t)send_mqtt_pagestats);
+        send_mqtt_pagestats--;
+        break;
+      }
+#endif // PAGE_STATISTICS == 1
+
+#if STACK_MONITOR == 1
+      // Check if a stack and buffer peaks Publish needs to occur.
+      if (send_mqtt_stack) {
+        publish_stack();
+        send_mqtt_stack = 0;
+        break;
+      }
+#endif // STACK_MONITOR == 1
 
 #if BME280_SUPPORT == 1 && DOMOTICZ_SUPPORT == 1
       // Check if BME280 is enabled, and if yes check if a Sensor
@@ -3692,6 +5080,54 @@ void publish_outbound(void)
       }
 #endif // BME280_SUPPORT == 1 && DOMOTICZ_SUPPORT == 1
 
+#if MQTT_QOS1_PINSTATE == 1
+      // Stop if the pending table has no room to track another pin state
+      // PUBLISH. The pin being examined is the first one checked once a
+      // PUBACK frees an entry.
+      if (pinstate_pending_count >= PINSTATE_PENDING_SIZE) {
+#if MQTT_BATCH_PUBLISH == 1
+        publish_scan_pin = (uint8_t)i;
+#endif // MQTT_BATCH_PUBLISH == 1
+        break;
+      }
+#endif // MQTT_QOS1_PINSTATE == 1
+
+#if PIN_CAPTURE_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD
+      if (i < 16 && (pin_pulse & (uint16_t)j)) {
+        pin_pulse &= (uint16_t)~j;
+	// An edge was captured on this pin. If the debounced state is still
+	// the state last published the pin pulsed and returned before
+	// read_input_pins() saw it. Publish the opposite state now and leave
+	// ON_OFF_word_sent at that state, so the xor_tmp check publishes the
+	// current state on the next call. If the debounced state did change
+	// the normal publish below handles it.
+        if (!(xor_tmp & j)) {
+#if LINKED_SUPPORT == 0
+          if ((pin_control[i] & 0x03) == 0x01) { // Enabled Input
+#endif // LINKED_SUPPORT == 0
+#if LINKED_SUPPORT == 1
+          if (chk_iotype(pin_control[i], i, 0x03) == 0x01) {
+	    // Enabled input or Linked Input
+#endif // LINKED_SUPPORT == 1
+            publish_pinstate('I', (uint8_t)(i+1), (ON_OFF_word ^ j), j);
+            ON_OFF_word_sent ^= j;
+#if MQTT_BATCH_PUBLISH == 0
+            break;
+#endif // MQTT_BATCH_PUBLISH == 0
+#if MQTT_BATCH_PUBLISH == 1
+            signal_break = 1;
+	    // If the mqtt_sendbuf is now full resume at this pin on the next
+	    // call so an MQTT_transmit request for it is not lost.
+            if (PINSTATE_QUEUE_FULL()) {
+              publish_scan_pin = (uint8_t)i;
+              break;
+            }
+#endif // MQTT_BATCH_PUBLISH == 1
+	  }
+	}
+      }
+#endif // PIN_CAPTURE_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD
+
       // Perform a publish_pinstate for each pin that has changed OR if an
       // MQTT PUBLISH attempts to change a pin state.
       // xor_temp is used to detect pin changes generated by the IOControl
@@ -3710,7 +5146,14 @@ void publish_outbound(void)
       // sync, so the Network Module will generate a PUBLISH Response to get
       // the Client back into sync.
 //      if ((xor_tmp & j) || (MQTT_transmit & j)) {
+#if COMMAND_RATE_LIMIT == 0
       if ((xor_tmp & j) || (MQTT_transmit & j && mqtt_parse_complete == 0)) {
+#endif // COMMAND_RATE_LIMIT == 0
+#if COMMAND_RATE_LIMIT == 1
+      // A deferred command has not been applied yet, so its pin state
+      // PUBLISH waits as well.
+      if ((xor_tmp & j) || (MQTT_transmit & j && mqtt_parse_complete == 0 && mqtt_parse_deferred == 0)) {
+#endif // COMMAND_RATE_LIMIT == 1
 	// A publish_pinstate needs to occur if:
 	//   A pin is Enabled (either Input or Output) and its ON/OFF state
 	//   changed as indicated by xor_temp
@@ -3758,15 +5201,36 @@ void publish_outbound(void)
 	// transmit was satisfied.
 	MQTT_transmit &= ~j;
 
+#if MQTT_BATCH_PUBLISH == 0
 	// Break out of the while() loop only if a PUBLISH Response was sent.
 	if (signal_break == 1) break;
+#endif // MQTT_BATCH_PUBLISH == 0
       }
       
+#if MQTT_BATCH_PUBLISH == 0
       // If no Publish was sent check the next one. Note: If any Publish
       // WAS sent we would have broken out of the while() loop.
       if (i == 0) break;
       j = j >> 1;
       i--;
+#endif // MQTT_BATCH_PUBLISH == 0
+#if MQTT_BATCH_PUBLISH == 1
+      // Check the next pin. When every pin has been checked start the next
+      // call at the top pin again.
+      if (--scan_count == 0) {
+        publish_scan_pin = 23;
+        break;
+      }
+      if (i == 0) {
+        i = top;
+        j = 1;
+        j <<= i;
+      }
+      else {
+        j = j >> 1;
+        i--;
+      }
+#endif // MQTT_BATCH_PUBLISH == 1
     }
   }
 
@@ -3788,7 +5252,114 @@ void publish_outbound(void)
 #endif // BUILD_SUPPORT == MQTT_BUILD
 
 
+#if BUILD_SUPPORT == MQTT_BUILD && MQTT_QOS1_PINSTATE == 1
+void pinstate_track(uint8_t pin)
+{
+  // This function records a QOS 1 pin state PUBLISH that was just queued
+  // so it can be published again if the Broker does not return a PUBACK.
+  // The packet id is the last one generated by mqtt_next_pid(). An entry
+  // already waiting for the same pin is reused since only the newest state
+  // of a pin matters. If the table is full the PUBLISH is not tracked
+  // (publish_outbound() stops queueing pin states before that happens).
+  uint8_t i;
+  uint8_t free_entry;
+
+  free_entry = PINSTATE_PENDING_SIZE;
+  for (i = 0; i < PINSTATE_PENDING_SIZE; i++) {
+    if (pinstate_pending[i].pin == pin) {
+      free_entry = i;
+      break;
+    }
+    if (pinstate_pending[i].pin == 0 && free_entry == PINSTATE_PENDING_SIZE) {
+      free_entry = i;
+    }
+  }
+  if (free_entry == PINSTATE_PENDING_SIZE) return;
+
+  if (pinstate_pending[free_entry].pin == 0) pinstate_pending_count++;
+  pinstate_pending[free_entry].packet_id = mqttclient.pid_lfsr;
+  pinstate_pending[free_entry].pin = pin;
+  pinstate_pending[free_entry].time_sent = (uint8_t)second_counter;
+}
+
+
+void pinstate_puback(uint16_t packet_id)
+{
+  // This function is called by mqtt_recv() when a PUBACK is received. The
+  // matching pending table entry is freed. A PUBACK for an entry that was
+  // replaced by a newer PUBLISH of the same pin is ignored.
+  uint8_t i;
+
+  for (i = 0; i < PINSTATE_PENDING_SIZE; i++) {
+    if (pinstate_pending[i].pin != 0 && pinstate_pending[i].packet_id == packet_id) {
+      pinstate_pending[i].pin = 0;
+      pinstate_pending_count--;
+      break;
+    }
+  }
+}
+
+
+void pinstate_check_pending(void)
+{
+  // This function frees any pending table entry that has waited more than
+  // PINSTATE_ACK_TIMEOUT seconds for its PUBACK and sets the MQTT_transmit
+  // bit for that pin. publish_outbound() then publishes the current state
+  // of the pin with a new packet id, so the original message bytes never
+  // need to be held in the mqtt_sendbuf.
+  uint8_t i;
+#if PCF8574_SUPPORT == 0 && DOMOTICZ_SUPPORT == 0
+  uint16_t j;
+#endif // PCF8574_SUPPORT == 0 && DOMOTICZ_SUPPORT == 0
+#if PCF8574_SUPPORT == 1 || DOMOTICZ_SUPPORT == 1
+  uint32_t j;
+#endif // PCF8574_SUPPORT == 1 || DOMOTICZ_SUPPORT == 1
+
+  if (pinstate_pending_count == 0) return;
+
+  for (i = 0; i < PINSTATE_PENDING_SIZE; i++) {
+    if (pinstate_pending[i].pin != 0
+     && (uint8_t)((uint8_t)second_counter - pinstate_pending[i].time_sent) > PINSTATE_ACK_TIMEOUT) {
+      j = 1;
+      j = (j << (pinstate_pending[i].pin - 1));
+      MQTT_transmit = (MQTT_transmit | j);
+      pinstate_pending[i].pin = 0;
+      pinstate_pending_count--;
+    }
+  }
+}
+#endif // BUILD_SUPPORT == MQTT_BUILD && MQTT_QOS1_PINSTATE == 1
+
+
 #if BUILD_SUPPORT == MQTT_BUILD && HOME_ASSISTANT_SUPPORT == 1
+int pinstate_message(unsigned char *topic_base, unsigned char *app_message, uint8_t direction, uint8_t pin, uint8_t on)
+{
+  // This function builds the topic and the application message of a pin
+  // state PUBLISH. The size of the application message is returned.
+  char *pBuffer;
+
+  pBuffer = topic_prefix_copy(topic_base);
+
+  // Build the first part of the topic message
+  if (direction == 'I') pBuffer = stpcpy(pBuffer, "/input/");
+  else pBuffer = stpcpy(pBuffer, "/output/");
+    
+  // Add pin number to the topic message
+  emb_itoa(pin, OctetArray, 10, 2);
+  *pBuffer++ = OctetArray[0];
+  *pBuffer++ = OctetArray[1];
+  *pBuffer = '\0';
+  
+  // Build the application message
+  if (on) {
+    strcpy(app_message, "ON");
+    return 2;
+  }
+  strcpy(app_message, "OFF");
+  return 3;
+}
+
+
 #if PCF8574_SUPPORT == 0
 void publish_pinstate(uint8_t direction, uint8_t pin, uint16_t value, uint16_t mask)
 #endif // PCF8574_SUPPORT == 0
@@ -3797,9 +5368,13 @@ void publish_pinstate(uint8_t direction, uint8_t pin, uint32_t value, uint32_t m
 #endif // PCF8574_SUPPORT == 1
 {
   // This function transmits a change in pin state for a single pin.
+  // With MQTT_DIRECT_PUBLISH the PUBLISH is only described in the direct
+  // publish queue, and direct_publish_send() packs it into the uip_buf.
   
+  uint8_t on;
+#if MQTT_DIRECT_PUBLISH == 0
   int size;
-  int i;
+  int16_t rv;
   unsigned char app_message[4];       // Stores the application message (the
                                       // payload) that will be sent in an
 				      // MQTT message.
@@ -3827,12 +5402,8 @@ void publish_pinstate(uint8_t direction, uint8_t pin, uint32_t value, uint32_t m
 				//  homeassistant/sensor/macaddressxx/BME280-0xxxx/config
 				//  homeassistant/sensor/macaddressxx/BME280-1xxxx/config
 				//  homeassistant/sensor/macaddressxx/BME280-2xxxx/config
+#endif // MQTT_DIRECT_PUBLISH == 0
   
-  app_message[0] = '\0';
-  
-  strcpy(topic_base, devicetype);
-  strcat(topic_base, stored_devicename);
-
   // If we are sending an Input message invert the value if the Invert_word
   // bit associated with the pin is 1
   if (direction == 'I') {
@@ -3842,79 +5413,54 @@ void publish_pinstate(uint8_t direction, uint8_t pin, uint32_t value, uint32_t m
 #if PCF8574_SUPPORT == 1
     if ((Invert_word & mask)) value = (uint32_t)(~value);
 #endif // PCF8574_SUPPORT == 1
-    // Build first part of the topic message
-    strcat(topic_base, "/input/");
-  }
-  // Else this is an Output message. Build the first part of the topic message
-  else {
-    strcat(topic_base, "/output/");
-  }
-    
-  // Add pin number to the topic message
-  emb_itoa(pin, OctetArray, 10, 2);
-  i = (uint8_t)strlen(topic_base);
-  topic_base[i] = OctetArray[0];
-  i++;
-  topic_base[i] = OctetArray[1];
-  i++;
-  topic_base[i] = '\0';
-  
-  // Build the application message
-  if (value & mask) {
-    strcpy(app_message, "ON");
-    size = 2;
-  }
-  else {
-    strcpy(app_message, "OFF");
-    size = 3;
   }
+  if (value & mask) on = 1;
+  else on = 0;
+
+#if MQTT_DIRECT_PUBLISH == 1
+  direct_publish_queue(direction, pin, on);
+#endif // MQTT_DIRECT_PUBLISH == 1
+
+#if MQTT_DIRECT_PUBLISH == 0
+  size = pinstate_message(topic_base, app_message, direction, pin, on);
 
   // Queue publish message
-  // This message is always published with QOS 0
-  mqtt_publish(&mqttclient,
-               topic_base,
-	       app_message,
-	       size,
-	       MQTT_PUBLISH_QOS_0 | MQTT_PUBLISH_RETAIN);
+  // This message is published with QOS 1 if MQTT_QOS1_PINSTATE is enabled,
+  // otherwise with QOS 0
+#if MQTT_BATCH_PUBLISH == 0
+  rv = mqtt_publish(&mqttclient,
+                    topic_base,
+	            app_message,
+	            size,
+	            PINSTATE_PUBLISH_FLAGS);
+#endif // MQTT_BATCH_PUBLISH == 0
+#if MQTT_BATCH_PUBLISH == 1
+  // Pack the message with any other pin states queued in this pass
+  rv = mqtt_publish_append(&mqttclient,
+                           topic_base,
+		           app_message,
+		           size,
+		           PINSTATE_PUBLISH_FLAGS);
+#endif // MQTT_BATCH_PUBLISH == 1
+#if MQTT_QOS1_PINSTATE == 1
+  // Wait for the PUBACK of the queued message
+  if (rv == MQTT_OK) pinstate_track(pin);
+#endif // MQTT_QOS1_PINSTATE == 1
+#endif // MQTT_DIRECT_PUBLISH == 0
 }
 #endif // BUILD_SUPPORT == MQTT_BUILD && HOME_ASSISTANT_SUPPORT == 1
 
 
 #if BUILD_SUPPORT == MQTT_BUILD && DOMOTICZ_SUPPORT == 1
-// #if PCF8574_SUPPORT == 0
-// void publish_pinstate(uint8_t direction, uint8_t pin, uint16_t value, uint16_t mask)
-// #endif // PCF8574_SUPPORT == 0
-// #if PCF8574_SUPPORT == 1
-void publish_pinstate(uint8_t direction, uint8_t pin, uint32_t value, uint32_t mask)
-// #endif // PCF8574_SUPPORT == 1
+int pinstate_message(unsigned char *topic_base, unsigned char *app_message, uint8_t direction, uint8_t pin, uint8_t on)
 {
-  // This function transmits a change in pin state for a single pin.
-  
-  int size;
-  int i;
-  int j;
-  unsigned char app_message[60]; // app_message (payload) is always of the form
-                                 // {"command":"switchlight","idx":xxxx,"switchcmd":"on"}
-				 // or
-                                 // {"command":"switchlight", "idx": xxxx, "switchcmd":"off"}
-  unsigned char topic_base[12];  // topic_base for Domoticz is always
-                                 //   domoticz/in
+  // This function builds the topic and the application message of a pin
+  // state PUBLISH. The size of the application message is returned. The
+  // topic is the same for inputs and outputs.
   unsigned char temp_idx[8];     // temp storage for idx value when read from I2C EEPROM
-  
-  
+
   strcpy(topic_base, "domoticz/in");
 
-  // If we are sending an Input message invert the value if the Invert_word
-  // bit associated with the pin is 1
-  if (direction == 'I') {
-// #if PCF8574_SUPPORT == 0
-//     if ((Invert_word & mask)) value = (uint16_t)(~value);
-// #endif // PCF8574_SUPPORT == 0
-// #if PCF8574_SUPPORT == 1
-    if ((Invert_word & mask)) value = (uint32_t)(~value);
-// #endif // PCF8574_SUPPORT == 1
-  }
-  
   // Determine idx from table
   pin--; // Subtract 1 from the pin number to use it as an index
   app_message[0] = '\0';
@@ -3937,25 +5483,150 @@ void publish_pinstate(uint8_t direction, uint8_t pin, uint32_t value, uint32_t m
   
   // Place the on/off state in the payload
   strcat(app_message, ",\"switchcmd\":\"");
-  if (value & mask) {
+  if (on) {
     strcat(app_message, "On\"}");
   }
   else {
     strcat(app_message, "Off\"}");
   }
-  size = strlen(app_message);
+  return strlen(app_message);
+}
+
+
+// #if PCF8574_SUPPORT == 0
+// void publish_pinstate(uint8_t direction, uint8_t pin, uint16_t value, uint16_t mask)
+// #endif // PCF8574_SUPPORT == 0
+// #if PCF8574_SUPPORT == 1
+void publish_pinstate(uint8_t direction, uint8_t pin, uint32_t value, uint32_t mask)
+// #endif // PCF8574_SUPPORT == 1
+{
+  // This function transmits a change in pin state for a single pin.
+  // With MQTT_DIRECT_PUBLISH the PUBLISH is only described in the direct
+  // publish queue, and direct_publish_send() packs it into the uip_buf.
+  
+  uint8_t on;
+#if MQTT_DIRECT_PUBLISH == 0
+  int size;
+  int16_t rv;
+  unsigned char app_message[60]; // app_message (payload) is always of the form
+                                 // {"command":"switchlight","idx":xxxx,"switchcmd":"on"}
+				 // or
+                                 // {"command":"switchlight", "idx": xxxx, "switchcmd":"off"}
+  unsigned char topic_base[12];  // topic_base for Domoticz is always
+                                 //   domoticz/in
+#endif // MQTT_DIRECT_PUBLISH == 0
+  
+  // If we are sending an Input message invert the value if the Invert_word
+  // bit associated with the pin is 1
+  if (direction == 'I') {
+// #if PCF8574_SUPPORT == 0
+//     if ((Invert_word & mask)) value = (uint16_t)(~value);
+// #endif // PCF8574_SUPPORT == 0
+// #if PCF8574_SUPPORT == 1
+    if ((Invert_word & mask)) value = (uint32_t)(~value);
+// #endif // PCF8574_SUPPORT == 1
+  }
+  if (value & mask) on = 1;
+  else on = 0;
+
+#if MQTT_DIRECT_PUBLISH == 1
+  direct_publish_queue(direction, pin, on);
+#endif // MQTT_DIRECT_PUBLISH == 1
+
+#if MQTT_DIRECT_PUBLISH == 0
+  size = pinstate_message(topic_base, app_message, direction, pin, on);
 
   // Queue publish message
-  // This message is always published with QOS 0
-  mqtt_publish(&mqttclient,
-               topic_base,
-	       app_message,
-	       size,
-	       MQTT_PUBLISH_QOS_0 | MQTT_PUBLISH_RETAIN);
+  // This message is published with QOS 1 if MQTT_QOS1_PINSTATE is enabled,
+  // otherwise with QOS 0
+#if MQTT_BATCH_PUBLISH == 0
+  rv = mqtt_publish(&mqttclient,
+                    topic_base,
+	            app_message,
+	            size,
+	            PINSTATE_PUBLISH_FLAGS);
+#endif // MQTT_BATCH_PUBLISH == 0
+#if MQTT_BATCH_PUBLISH == 1
+  // Pack the message with any other pin states queued in this pass
+  rv = mqtt_publish_append(&mqttclient,
+                           topic_base,
+		           app_message,
+		           size,
+		           PINSTATE_PUBLISH_FLAGS);
+#endif // MQTT_BATCH_PUBLISH == 1
+#if MQTT_QOS1_PINSTATE == 1
+  // Wait for the PUBACK of the queued message
+  if (rv == MQTT_OK) pinstate_track(pin);
+#endif // MQTT_QOS1_PINSTATE == 1
+#endif // MQTT_DIRECT_PUBLISH == 0
 }
 #endif // BUILD_SUPPORT == MQTT_BUILD && DOMOTICZ_SUPPORT == 1
 
 
+#if BUILD_SUPPORT == MQTT_BUILD && MQTT_DIRECT_PUBLISH == 1
+void direct_publish_queue(uint8_t direction, uint8_t pin, uint8_t on)
+{
+  // This function adds a pin state PUBLISH descriptor to the direct
+  // publish queue. publish_outbound() checks for room before it publishes a
+  // pin state, so the descriptor is only dropped if the queue is full.
+  struct direct_publish *pDesc;
+
+  if (direct_publish_count >= DIRECT_PUBLISH_SIZE) return;
+  pDesc = &direct_publish[(direct_publish_head + direct_publish_count) % DIRECT_PUBLISH_SIZE];
+  pDesc->direction = direction;
+  pDesc->pin = pin;
+  pDesc->on = on;
+  direct_publish_count++;
+}
+
+
+void direct_publish_send(struct mqtt_client *client)
+{
+  // This function is called by mqtt_send() during the uip poll of the MQTT
+  // connection, after the messages queued in the mqtt_sendbuf have been
+  // copied to the uip_buf. Each waiting pin state PUBLISH is packed
+  // straight into the uip_buf after them until the TCP segment is full.
+  // The rest are packed on the next poll.
+  unsigned char topic_base[PINSTATE_TOPIC_SIZE];
+  unsigned char app_message[PINSTATE_MESSAGE_SIZE];
+  struct direct_publish *pDesc;
+  uint16_t segment_size;
+  uint16_t packet_id;
+  int size;
+  int16_t rv;
+
+  segment_size = uip_mss();
+  if (segment_size > UIP_TX_RAM_MSS) segment_size = UIP_TX_RAM_MSS;
+
+  while (direct_publish_count != 0 && uip_slen < segment_size) {
+    pDesc = &direct_publish[direct_publish_head];
+    size = pinstate_message(topic_base, app_message, pDesc->direction, pDesc->pin, pDesc->on);
+    packet_id = 0;
+#if MQTT_QOS1_PINSTATE == 1
+    packet_id = mqtt_next_pid(client);
+#endif // MQTT_QOS1_PINSTATE == 1
+    rv = mqtt_pack_publish_request((uint8_t *)uip_appdata + uip_slen,
+                                   (uint16_t)(segment_size - uip_slen),
+				   topic_base,
+				   packet_id,
+				   app_message,
+				   (uint16_t)size,
+				   PINSTATE_PUBLISH_FLAGS);
+    // mqtt_pack_publish_request() returns 0 if the PUBLISH does not fit
+    if (rv <= 0) break;
+    uip_slen += rv;
+#if MQTT_QOS1_PINSTATE == 1
+    // Wait for the PUBACK of the PUBLISH
+    pinstate_track(pDesc->pin);
+#endif // MQTT_QOS1_PINSTATE == 1
+    client->time_of_last_send = second_counter;
+    direct_publish_head = (uint8_t)((direct_publish_head + 1) % DIRECT_PUBLISH_SIZE);
+    direct_publish_count--;
+  }
+}
+#endif // BUILD_SUPPORT == MQTT_BUILD && MQTT_DIRECT_PUBLISH == 1
+
+
 
 
 #if BUILD_SUPPORT == MQTT_BUILD && HOME_ASSISTANT_SUPPORT == 1
@@ -4040,8 +5711,7 @@ void publish_pinstate_all(uint8_t type)
   }
 #endif // PCF8574_SUPPORT == 1
 
-  strcpy(topic_base, devicetype);
-  strcat(topic_base, stored_devicename);
+  topic_prefix_copy(topic_base);
   
   if (type == STATE_REQUEST_RCVD) {
     strcat(topic_base, "/state");
@@ -4133,21 +5803,17 @@ void publish_temperature(uint8_t sensor)
     // The "numROMs" value is also a value from 0 to 4 (for the five sensors).
     
     // Build the topic string
-    strcpy(topic_base, devicetype);
-    strcat(topic_base, stored_devicename);
-    strcat(topic_base, "/temp/");
-    
     // Add sensor number to the topic message.
     {
       int i;
-      int j;
-      j = (uint8_t)strlen(topic_base);
+      char *pBuffer;
+      pBuffer = stpcpy(topic_prefix_copy(topic_base), "/temp/");
       for (i=6; i>0; i--) {
         int2hex(FoundROM[sensor][i]);
-        topic_base[j++] = OctetArray[0];
-        topic_base[j++] = OctetArray[1];
+        *pBuffer++ = OctetArray[0];
+        *pBuffer++ = OctetArray[1];
       }
-      topic_base[j] = '\0';
+      *pBuffer = '\0';
     }
     
     // Build the application message
@@ -4255,8 +5921,7 @@ void publish_BME280(int8_t sensor)
 //  if (BME280_found == 1) {
   if (stored_config_settings & 0x20) { // BME280 enabled?
     // Build the topic string
-    strcpy(topic_base, devicetype);
-    strcat(topic_base, stored_devicename);
+    topic_prefix_copy(topic_base);
     
     if (sensor == 0) strcat(topic_base, "/temp/");
     if (sensor == 1) strcat(topic_base, "/pres/");
@@ -4299,6 +5964,111 @@ void publish_BME280(int8_t sensor)
 #endif // BUILD_SUPPORT == MQTT_BUILD && HOME_ASSISTANT_SUPPORT == 1
 
 
+#if BUILD_SUPPORT == MQTT_BUILD && HOME_ASSISTANT_SUPPORT == 1
+#if MQTT_BULK_STATE == 1
+static char *bulk_number(char *pBuffer)
+{
+  // Copy the number in OctetArray to pBuffer as a JSON number. The sensor
+  // string conversions pad with a leading space and leading zeros, which
+  // JSON does not allow, so they are dropped. A minus sign is kept.
+  char *pNum;
+
+  pNum = (char *)OctetArray;
+  if (*pNum == ' ') pNum++;
+  if (*pNum == '-') *pBuffer++ = *pNum++;
+  while (*pNum == '0' && pNum[1] >= '0' && pNum[1] <= '9') pNum++;
+  return stpcpy(pBuffer, pNum);
+}
+
+
+uint8_t publish_bulk_state(void)
+{
+  // This function is called from publish_outbound to Publish the bulk
+  // state message when a new sensor sample is ready. All sensor values
+  // and the pin states are sent in one JSON payload instead of one
+  // PUBLISH per sensor value:
+  //   DS18B20: {"p":1234,"t0":21.5,"t1":-3.1}
+  //   BME280:  {"p":1234,"t":21.52,"pr":1013,"rh":45}
+  // "p" is the ON_OFF_word as a decimal number (IO 1 is bit 0). "t0" to
+  // "t4" are the DS18B20 sensors found by FindDevices in FoundROM order.
+  //
+  // The largest payload is 69 bytes (24 pins, 5 sensors at 125.0 C). With
+  // a 19 character devicename the PUBLISH is 111 bytes, so it fits in the
+  // empty mqtt_sendbuf.
+  //
+  // Returns 1 if the message was queued, 0 if no sample was pending.
+  char *pBuffer;
+  uint8_t pending;
+#if DS18B20_SUPPORT == 1
+  uint8_t i;
+#endif // DS18B20_SUPPORT == 1
+  char app_message[72];          // Stores the application message (the
+                                 // payload) that will be sent in an MQTT
+				 // message.
+  unsigned char topic_base[55]; // Used for building the publish topic
+                                //  NetworkModule/DeviceName123456789/bulk
+
+  pending = 0;
+#if DS18B20_SUPPORT == 1
+  if ((stored_config_settings & 0x08) && (send_mqtt_temperature >= 0)) pending = 1;
+  send_mqtt_temperature = -1;
+#endif // DS18B20_SUPPORT == 1
+#if BME280_SUPPORT == 1
+  if ((stored_config_settings & 0x20) && (send_mqtt_BME280 >= 0)) pending = 1;
+  send_mqtt_BME280 = -1;
+#endif // BME280_SUPPORT == 1
+  if (pending == 0) return 0;
+
+  // Build the application message
+  pBuffer = stpcpy(app_message, "{\"p\":");
+  emb_itoa((uint32_t)ON_OFF_word, OctetArray, 10, 8);
+  pBuffer = bulk_number(pBuffer);
+
+#if DS18B20_SUPPORT == 1
+  if (stored_config_settings & 0x08) {
+    // Only the sensors found by FindDevices as indicated by numROMs
+    for (i=0; i<=numROMs; i++) {
+      pBuffer = stpcpy(pBuffer, ",\"t");
+      *pBuffer++ = (char)('0' + i);
+      pBuffer = stpcpy(pBuffer, "\":");
+      convert_temperature(i, 0, 0); // Convert to degress C in OctetArray
+      pBuffer = bulk_number(pBuffer);
+    }
+  }
+#endif // DS18B20_SUPPORT == 1
+
+#if BME280_SUPPORT == 1
+  if (stored_config_settings & 0x20) {
+    BME280_temperature_string_C();
+    pBuffer = stpcpy(pBuffer, ",\"t\":");
+    pBuffer = bulk_number(pBuffer);
+    BME280_pressure_string();
+    pBuffer = stpcpy(pBuffer, ",\"pr\":");
+    pBuffer = bulk_number(pBuffer);
+    BME280_humidity_string();
+    pBuffer = stpcpy(pBuffer, ",\"rh\":");
+    pBuffer = bulk_number(pBuffer);
+  }
+#endif // BME280_SUPPORT == 1
+
+  stpcpy(pBuffer, "}");
+
+  // Build the topic string
+  stpcpy(topic_prefix_copy(topic_base), "/bulk");
+
+  // Queue publish message
+  // This message is always published with QOS 0
+  mqtt_publish(&mqttclient,
+               topic_base,
+               app_message,
+               strlen(app_message),
+               MQTT_PUBLISH_QOS_0 | MQTT_PUBLISH_RETAIN);
+  return 1;
+}
+#endif // MQTT_BULK_STATE == 1
+#endif // BUILD_SUPPORT == MQTT_BUILD && HOME_ASSISTANT_SUPPORT == 1
+
+
 #if BUILD_SUPPORT == MQTT_BUILD && DOMOTICZ_SUPPORT == 1
 #if BME280_SUPPORT == 1
 void publish_BME280(int8_t sensor)
@@ -4441,21 +6211,119 @@ void publish_BME280(int8_t sensor)
     strcat(app_message, OctetArray);
     strcat(app_message, ";");
 
-    // Add sensor pressure prediciton value. Use Default of 0 and add payload
-    // termination.
-    strcat(app_message, "0\"}");
+    // Add sensor pressure prediciton value. Use Default of 0 and add payload
+    // termination.
+    strcat(app_message, "0\"}");
+
+    // Queue publish message
+    // This message is always published with QOS 0
+    mqtt_publish(&mqttclient,
+                 topic_base,
+                 app_message,
+                 strlen(app_message),
+                 MQTT_PUBLISH_QOS_0 | MQTT_PUBLISH_RETAIN);
+  }
+}
+#endif // BME280_SUPPORT == 1
+#endif // BUILD_SUPPORT == MQTT_BUILD && DOMOTICZ_SUPPORT == 1
+
+
+#if BUILD_SUPPORT == MQTT_BUILD && PROFILE_SUPPORT == 1
+void publish_profile(uint8_t stage)
+{
+  // This function is called to Publish the profiling statistics of one
+  // main loop stage (see the PROF_ defines in timer.h).
+  // Topic: NetworkModule/DeviceName123456789/profile/x
+  // Message: "count min avg max" with run times in 10us units
+  
+  unsigned char topic_base[45]; // Used for building the publish topic
+  unsigned char app_message[24]; // Used for building the publish message
+  char *pBuffer;
+  
+  // Build the topic string
+  pBuffer = stpcpy(topic_prefix_copy(topic_base), "/profile/");
+  *pBuffer++ = (char)(stage + '0');
+  *pBuffer = '\0';
+  
+  // Build the application message
+  prof_format(stage, app_message);
+  
+  // Queue publish message
+  // This message is always published with QOS 0
+  mqtt_publish(&mqttclient,
+               topic_base,
+               app_message,
+               strlen(app_message),
+               MQTT_PUBLISH_QOS_0);
+}
+#endif // BUILD_SUPPORT == MQTT_BUILD && PROFILE_SUPPORT == 1
+
+
+#if BUILD_SUPPORT == MQTT_BUILD && PAGE_STATISTICS == 1
+void publish_pagestats(uint8_t slot)
+{
+  // This function is called to Publish the load statistics of one webpage
+  // group (see the PSTAT_ defines in httpd.h).
+  // Topic: NetworkModule/DeviceName123456789/pages/x
+  // Message: "requests loads segments rexmits bytes avg max" with load
+  //          times in ms
+  
+  unsigned char topic_base[45]; // Used for building the publish topic
+  unsigned char app_message[45]; // Used for building the publish message
+  char *pBuffer;
+  
+  // Build the topic string
+  pBuffer = stpcpy(topic_prefix_copy(topic_base), "/pages/");
+  *pBuffer++ = (char)(slot + '0');
+  *pBuffer = '\0';
+  
+  // Build the application message
+  page_stats_format(slot, (char *)app_message);
+  
+  // Queue publish message
+  // This message is always published with QOS 0
+  mqtt_publish(&mqttclient,
+               topic_base,
+               app_message,
+               strlen(app_message),
+               MQTT_PUBLISH_QOS_0);
+}
+#endif // BUILD_SUPPORT == MQTT_BUILD && PAGE_STATISTICS == 1
+
 
-    // Queue publish message
-    // This message is always published with QOS 0
-    mqtt_publish(&mqttclient,
-                 topic_base,
-                 app_message,
-                 strlen(app_message),
-                 MQTT_PUBLISH_QOS_0 | MQTT_PUBLISH_RETAIN);
-  }
+#if BUILD_SUPPORT == MQTT_BUILD && STACK_MONITOR == 1
+void publish_stack(void)
+{
+  // This function is called to Publish the stack and buffer peaks.
+  // Topic: NetworkModule/DeviceName123456789/stack
+  // Message: "stack uip_buf sendbuf" peak bytes used since boot
+  
+  unsigned char topic_base[45]; // Used for building the publish topic
+  unsigned char app_message[18]; // Used for building the publish message
+  char *pBuffer;
+  
+  // Build the topic string
+  stpcpy(topic_prefix_copy(topic_base), "/stack");
+  
+  // Build the application message
+  emb_itoa(stack_peak, OctetArray, 10, 5);
+  pBuffer = stpcpy((char *)app_message, OctetArray);
+  *pBuffer++ = ' ';
+  emb_itoa(uip_buf_peak, OctetArray, 10, 5);
+  pBuffer = stpcpy(pBuffer, OctetArray);
+  *pBuffer++ = ' ';
+  emb_itoa(mqtt_sendbuf_peak, OctetArray, 10, 5);
+  stpcpy(pBuffer, OctetArray);
+  
+  // Queue publish message
+  // This message is always published with QOS 0
+  mqtt_publish(&mqttclient,
+               topic_base,
+               app_message,
+               strlen(app_message),
+               MQTT_PUBLISH_QOS_0);
 }
-#endif // BME280_SUPPORT == 1
-#endif // BUILD_SUPPORT == MQTT_BUILD && DOMOTICZ_SUPPORT == 1
+#endif // BUILD_SUPPORT == MQTT_BUILD && STACK_MONITOR == 1
 
 
 void unlock_eeprom(void)
@@ -4483,6 +6351,60 @@ void lock_eeprom(void)
 }
 
 
+#if EEPROM_BATCH_COMMIT == 1
+void commit_stored_pin_control(uint16_t dirty)
+{
+  // Copy pin_control[i] to stored_pin_control[i] for each STM8 pin with
+  // its bit set in dirty.
+  //
+  // The EEPROM is programmed a 4 byte word at a time so that up to four
+  // changed bytes cost a single programming time. stored_pin_control[] is
+  // not word aligned, so the words covering it can include bytes of the
+  // neighbouring variables. Those bytes, and the bytes of pins that are not
+  // dirty, are rewritten with their current value. Words where no byte
+  // changes are not programmed.
+  uint8_t *word;
+  uint8_t *first;
+  uint8_t *last;
+  uint8_t buf[4];
+  uint8_t changed;
+  uint8_t k;
+  int i;
+  
+  first = (uint8_t *)&stored_pin_control[0];
+  last = (uint8_t *)&stored_pin_control[15];
+  
+  unlock_eeprom();
+  for (word = (uint8_t *)((uint16_t)first & 0xfffc); word <= last; word += 4) {
+    changed = 0;
+    for (k = 0; k < 4; k++) {
+      buf[k] = word[k];
+      if ((word + k) >= first && (word + k) <= last) {
+        i = (int)((word + k) - first);
+        if ((dirty & (uint16_t)(1 << i)) && (buf[k] != pin_control[i])) {
+          buf[k] = pin_control[i];
+          changed = 1;
+        }
+      }
+    }
+    if (changed) {
+      // Enable Word programming
+      FLASH_CR2 |= FLASH_CR2_WPRG;
+      FLASH_NCR2 &= (uint8_t)(~FLASH_NCR2_NWPRG);
+      // Write word to EEPROM
+      word[0] = buf[0];
+      word[1] = buf[1];
+      word[2] = buf[2];
+      word[3] = buf[3];
+      // Wait for the end of the programming operation
+      while (!(FLASH_IAPSR & FLASH_IAPSR_EOP));
+    }
+  }
+  lock_eeprom();
+}
+#endif // EEPROM_BATCH_COMMIT == 1
+
+
 void update_settings_options(uint8_t select, uint8_t value)
 {
   // Unlock the EEPROM, update the stored_config_settings or stored_options1
@@ -5909,6 +7831,12 @@ void initialize_pins(void) {
   // Initialize IO ON/OFF state tracking. ON_OFF_WORD was initialized in
   // encode_bit_registers().
   ON_OFF_word_new1 = ON_OFF_word_new2 = ON_OFF_word_sent = ON_OFF_word;
+#if PIN_CAPTURE_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD
+  pin_pulse = 0;
+#endif // PIN_CAPTURE_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD
+#if MQTT_BATCH_PUBLISH == 1 && BUILD_SUPPORT == MQTT_BUILD
+  publish_scan_pin = 23;
+#endif // MQTT_BATCH_PUBLISH == 1 && BUILD_SUPPORT == MQTT_BUILD
     
   // Set Output pins
   write_output_pins();
@@ -6024,11 +7952,30 @@ void check_runtime_changes(void)
   // Address, Gateway Address, Netmask, Port, or MAC. If a change occurred
   // update the appropriate variables and output controls, and store the new
   // values in EEPROM.
+  //
+  // With RUNTIME_CHANGES_DIRTY Steps 2 to 6 only run when parse_complete or
+  // mqtt_parse_complete shows that a parser changed the Pending_ values.
 
   uint8_t update_EEPROM;
+#if EEPROM_BATCH_COMMIT == 1
+  uint16_t eeprom_dirty;        // STM8 pins to be saved to EEPROM
+#endif // EEPROM_BATCH_COMMIT == 1
 
   read_input_pins(0);
 
+#if HTTPD_PAGE_CACHE == 1
+  // Settings shown on the cached pages may have been changed
+  if (parse_complete || mqtt_parse_complete) page_cache_invalidate();
+#endif // HTTPD_PAGE_CACHE == 1
+
+#if BME280_SUPPORT == 1 && SENSOR_STRING_CACHE == 1
+  // The pressure string depends on the altitude setting
+  if (parse_complete && BME280_found) cache_BME280_strings();
+#endif // BME280_SUPPORT == 1 && SENSOR_STRING_CACHE == 1
+
+#if RUNTIME_CHANGES_DIRTY == 1
+  if (parse_complete || mqtt_parse_complete) {
+#endif // RUNTIME_CHANGES_DIRTY == 1
 
 #if PINOUT_OPTION_SUPPORT == 1
   // Only pinout Option 1 is allowed if any reserved pins are in use. There
@@ -6175,6 +8122,10 @@ void check_runtime_changes(void)
   }
 #endif // LINKED_SUPPORT == 1
 
+#if RUNTIME_CHANGES_DIRTY == 1
+  }
+#endif // RUNTIME_CHANGES_DIRTY == 1
+
 
 #if LINKED_SUPPORT == 1
   {
@@ -6209,6 +8160,14 @@ void check_runtime_changes(void)
     //    one will win. And it probably doesn't matter. So I won't put
     //    any effort into resolving such a case.
     
+#if LINKED_FAST_PATH == 1 && PIN_CAPTURE_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD && LINKED_SUPPORT == 1
+    // The edges on Linked Inputs with a fast path were already applied to
+    // the ODR by the Port interrupt. Use those in place of the edges found
+    // by read_input_pins() so each edge toggles the Output pin_control once.
+    linked_edge ^= (linked_edge & linked_fast_pins);
+    linked_edge |= linked_fast_service();
+#endif // LINKED_FAST_PATH == 1 && PIN_CAPTURE_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD && LINKED_SUPPORT == 1
+    
     if (linked_edge & 0x0fff) {
       // There is an edge on at least one pin
       // Check the STM8 pins
@@ -6335,7 +8294,10 @@ void check_runtime_changes(void)
         if ((pin_control[i] & 0x0b) == 0x03) {
           // Pin is an Output AND Retain is not set
           if (IO_TIMER[i] != Pending_IO_TIMER[i]) {
-            pin_timer[i] = Pending_IO_TIMER[i];
+#if HW_PULSE_SUPPORT == 1
+            hw_pulse_stop((uint8_t)i);
+#endif // HW_PULSE_SUPPORT == 1
+            pin_timer_set(i, Pending_IO_TIMER[i]);
           }
         }
       }
@@ -6357,7 +8319,10 @@ void check_runtime_changes(void)
           prep_read(I2C_EEPROM_R2_WRITE, I2C_EEPROM_R2_READ, PCF8574_I2C_EEPROM_R2_START_IO_TIMERS + ((i - 16) * 2), 2);
           IO_timer_value = read_two_bytes();
           if (IO_timer_value != Pending_IO_TIMER[i]) {
-            pin_timer[i] = Pending_IO_TIMER[i];
+#if HW_PULSE_SUPPORT == 1
+            hw_pulse_stop((uint8_t)i);
+#endif // HW_PULSE_SUPPORT == 1
+            pin_timer_set(i, Pending_IO_TIMER[i]);
           }
         }
       }
@@ -6372,7 +8337,10 @@ void check_runtime_changes(void)
         if (chk_iotype(pin_control[i], i, 0x0b) == 0x03) {
 	  // Pin is an Output and Retain is not set
           if (IO_TIMER[i] != Pending_IO_TIMER[i]) {
-            pin_timer[i] = Pending_IO_TIMER[i];
+#if HW_PULSE_SUPPORT == 1
+            hw_pulse_stop((uint8_t)i);
+#endif // HW_PULSE_SUPPORT == 1
+            pin_timer_set(i, Pending_IO_TIMER[i]);
 	  }
         }
       }
@@ -6394,7 +8362,10 @@ void check_runtime_changes(void)
           prep_read(I2C_EEPROM_R2_WRITE, I2C_EEPROM_R2_READ, PCF8574_I2C_EEPROM_R2_START_IO_TIMERS + ((i - 16) * 2), 2);
           IO_timer_value = read_two_bytes();
           if (IO_timer_value != Pending_IO_TIMER[i]) {
-            pin_timer[i] = Pending_IO_TIMER[i];
+#if HW_PULSE_SUPPORT == 1
+            hw_pulse_stop((uint8_t)i);
+#endif // HW_PULSE_SUPPORT == 1
+            pin_timer_set(i, Pending_IO_TIMER[i]);
           }
         }
       }
@@ -6427,7 +8398,11 @@ void check_runtime_changes(void)
     for (i=0; i<16; i++) {
       if ((pin_control[i] & 0x0b) == 0x03) {
         // Pin is an Output and Retain is not set
-        if (((IO_TIMER[i] & 0x3fff) != 0) && ((pin_timer[i] & 0x3fff) == 0)) {
+        if (((IO_TIMER[i] & 0x3fff) != 0) && ((pin_timer[i] & 0x3fff) == 0)
+#if HW_PULSE_SUPPORT == 1
+         && (hw_pulse_running((uint8_t)i) == 0)
+#endif // HW_PULSE_SUPPORT == 1
+         ) {
           // Pin has a non-zero TIMER value AND the timer countdown is zero
 	  if ((pin_control[i] & 0x90) == 0x80) {
 	    // Pin is ON and the idle state is OFF
@@ -6463,6 +8438,10 @@ void check_runtime_changes(void)
 
 
           write_output_pins();
+#if HW_PULSE_SUPPORT == 1
+          // The ODR now holds the idle state, release the TIM2 channel
+          hw_pulse_stop((uint8_t)i);
+#endif // HW_PULSE_SUPPORT == 1
         }
       }
     }
@@ -6534,7 +8513,11 @@ void check_runtime_changes(void)
     for (i=0; i<16; i++) {
       if (chk_iotype(pin_control[i], i, 0x0b) == 0x03) {
         // Pin is an Output and Retain is not set
-        if (((IO_TIMER[i] & 0x3fff) != 0) && ((pin_timer[i] & 0x3fff) == 0)) {
+        if (((IO_TIMER[i] & 0x3fff) != 0) && ((pin_timer[i] & 0x3fff) == 0)
+#if HW_PULSE_SUPPORT == 1
+         && (hw_pulse_running((uint8_t)i) == 0)
+#endif // HW_PULSE_SUPPORT == 1
+         ) {
           // Pin has a non-zero TIMER value AND the timer countdown is zero
 	  if ((pin_control[i] & 0x90) == 0x80) {
 	    // The above: If the pin is ON and the idle state is OFF
@@ -6570,6 +8553,10 @@ void check_runtime_changes(void)
 
 
           write_output_pins();
+#if HW_PULSE_SUPPORT == 1
+          // The ODR now holds the idle state, release the TIM2 channel
+          hw_pulse_stop((uint8_t)i);
+#endif // HW_PULSE_SUPPORT == 1
 	}
       }
     }
@@ -6714,15 +8701,24 @@ void check_runtime_changes(void)
           if ((IO_TIMER[i] & 0x3fff) != 0) {
             if ((Pending_pin_control[i] & 0x80) != (pin_control[i] & 0x80)) {
               // The user changed the pin ON/OFF state
+#if HW_PULSE_SUPPORT == 1
+              hw_pulse_stop((uint8_t)i);
+#endif // HW_PULSE_SUPPORT == 1
               if (((Pending_pin_control[i] & 0x80) == 0x80) && ((pin_control[i] & 0x10) == 0x00)) {
                 // The user turned the pin ON and the idle state is OFF
                 // Set the pin timer
-                pin_timer[i] = IO_TIMER[i];
+                pin_timer_set(i, IO_TIMER[i]);
+#if HW_PULSE_SUPPORT == 1
+                hw_pulse_start((uint8_t)i, IO_TIMER[i], Pending_pin_control[i]);
+#endif // HW_PULSE_SUPPORT == 1
               }
               if (((Pending_pin_control[i] & 0x80) == 0x00) && ((pin_control[i] & 0x10) == 0x10)) {
                 // The user turned the pin OFF and the idle state is ON
                 // Set the pin timer
-                pin_timer[i] = IO_TIMER[i];
+                pin_timer_set(i, IO_TIMER[i]);
+#if HW_PULSE_SUPPORT == 1
+                hw_pulse_start((uint8_t)i, IO_TIMER[i], Pending_pin_control[i]);
+#endif // HW_PULSE_SUPPORT == 1
               }
             }
           }
@@ -6751,12 +8747,12 @@ void check_runtime_changes(void)
               if (((Pending_pin_control[i] & 0x80) == 0x80) && ((pin_control[i] & 0x10) == 0x00)) {
                 // The user turned the pin ON and the idle state is OFF
                 // Set the pin timer
-                pin_timer[i] = IO_timer_value;
+                pin_timer_set(i, IO_timer_value);
               }
               if (((Pending_pin_control[i] & 0x80) == 0x00) && ((pin_control[i] & 0x10) == 0x10)) {
                 // The user turned the pin OFF and the idle state is ON
                 // Set the pin timer
-                pin_timer[i] = IO_timer_value;
+                pin_timer_set(i, IO_timer_value);
               }
             }
           }
@@ -6775,15 +8771,24 @@ void check_runtime_changes(void)
           if ((IO_TIMER[i] & 0x3fff) != 0) {
             if ((Pending_pin_control[i] & 0x80) != (pin_control[i] & 0x80)) {
               // The user changed the pin ON/OFF state
+#if HW_PULSE_SUPPORT == 1
+              hw_pulse_stop((uint8_t)i);
+#endif // HW_PULSE_SUPPORT == 1
               if (((Pending_pin_control[i] & 0x80) == 0x80) && ((pin_control[i] & 0x10) == 0x00)) {
                 // The user turned the pin ON and the idle state is OFF
                 // Set the pin timer
-                pin_timer[i] = IO_TIMER[i];
+                pin_timer_set(i, IO_TIMER[i]);
+#if HW_PULSE_SUPPORT == 1
+                hw_pulse_start((uint8_t)i, IO_TIMER[i], Pending_pin_control[i]);
+#endif // HW_PULSE_SUPPORT == 1
               }
               if (((Pending_pin_control[i] & 0x80) == 0x00) && ((pin_control[i] & 0x10) == 0x10)) {
                 // The user turned the pin OFF and the idle state is ON
                 // Set the pin timer
-                pin_timer[i] = IO_TIMER[i];
+                pin_timer_set(i, IO_TIMER[i]);
+#if HW_PULSE_SUPPORT == 1
+                hw_pulse_start((uint8_t)i, IO_TIMER[i], Pending_pin_control[i]);
+#endif // HW_PULSE_SUPPORT == 1
 	      }
             }
           }
@@ -6812,12 +8817,12 @@ void check_runtime_changes(void)
               if (((Pending_pin_control[i] & 0x80) == 0x80) && ((pin_control[i] & 0x10) == 0x00)) {
                 // The user turned the pin ON and the idle state is OFF
                 // Set the pin timer
-                pin_timer[i] = IO_timer_value;
+                pin_timer_set(i, IO_timer_value);
               }
               if (((Pending_pin_control[i] & 0x80) == 0x00) && ((pin_control[i] & 0x10) == 0x10)) {
                 // The user turned the pin OFF and the idle state is ON
                 // Set the pin timer
-                pin_timer[i] = IO_timer_value;
+                pin_timer_set(i, IO_timer_value);
 	      }
             }
           }
@@ -6872,6 +8877,9 @@ void check_runtime_changes(void)
     //   bits are only used if the device reboots due to an external event.
     
     update_EEPROM = 0;
+#if EEPROM_BATCH_COMMIT == 1
+    eeprom_dirty = 0;
+#endif // EEPROM_BATCH_COMMIT == 1
     {
       int i;
 #if PCF8574_SUPPORT == 0
@@ -6982,11 +8990,17 @@ void check_runtime_changes(void)
             // Update the stored_pin_control[] variables
 	    
 	    if (i < 16) {
+#if EEPROM_BATCH_COMMIT == 0
 	      unlock_eeprom();
               if (stored_pin_control[i] != pin_control[i]) {
 	        stored_pin_control[i] = pin_control[i];
 	      }
 	      lock_eeprom();
+#endif // EEPROM_BATCH_COMMIT == 0
+#if EEPROM_BATCH_COMMIT == 1
+              // Saved after the loop by commit_stored_pin_control()
+              eeprom_dirty |= (uint16_t)(1 << i);
+#endif // EEPROM_BATCH_COMMIT == 1
 	    }
 	    
 #if PCF8574_SUPPORT == 1
@@ -7014,6 +9028,10 @@ void check_runtime_changes(void)
       }
     }
 
+#if EEPROM_BATCH_COMMIT == 1
+    if (eeprom_dirty) commit_stored_pin_control(eeprom_dirty);
+#endif // EEPROM_BATCH_COMMIT == 1
+
     // Update the bit registers with the changed Output pin states
     encode_bit_registers(0);
     
@@ -7208,8 +9226,19 @@ void check_runtime_changes(void)
   parse_complete = 0;
   mqtt_parse_complete = 0;
 
+#if DEVELOPMENT_TOOLS == 1 && BENCHMARK_SUPPORT == 1
+  if (bench_request) bench_run();
+#endif // DEVELOPMENT_TOOLS == 1 && BENCHMARK_SUPPORT == 1
+
+  // Write the Link Error counters to EEPROM once a minute
+  if (second_counter > (check_debug_ctr + 60)) {
+    check_debug_ctr = second_counter;
+    update_debug_storage1();
+  }
+
   // Periodic check of the stack overflow guardband
   if (stack_limit1 != 0xaa || stack_limit2 != 0x55) {
+    if (stack_error == 0) UDP_LOG(UDP_LOG_STACK, 0);
     stack_error = 1;
     fastflash();
     fastflash();
@@ -7224,6 +9253,120 @@ void check_runtime_changes(void)
   }
 }
 
+#if STACK_MONITOR == 1
+void stack_scan(void)
+{
+  // Find the lowest stack address that no longer holds the STACK_PAINT
+  // pattern painted at boot and update the stack high water mark. A
+  // function that reserved stack space without writing all of it may be
+  // under-counted by the bytes it did not write.
+  uint8_t *pStack;
+  uint16_t used;
+  
+  pStack = (uint8_t *)STACK_BOTTOM;
+  while (pStack < (uint8_t *)STACK_TOP && *pStack == STACK_PAINT) pStack++;
+  used = (uint16_t)((uint8_t *)STACK_TOP + 1 - pStack);
+  if (used > stack_peak) stack_peak = used;
+}
+#endif // STACK_MONITOR == 1
+
+
+#if DEVELOPMENT_TOOLS == 1 && BENCHMARK_SUPPORT == 1
+uint32_t bench_us(uint32_t start)
+{
+  // Return the time in us since start was read with clock_us()
+  return clock_us() - start;
+}
+
+
+void bench_run(void)
+{
+  // Run the benchmarks requested with the /d4 URL command and save the
+  // results in bench_result[]. Each benchmark is timed with clock_us()
+  // (10us resolution). The uip_buf is used as the data buffer as it is not
+  // in use between main loop passes. Results for hardware not in the build
+  // or not enabled are 0.
+  uint32_t start;
+  uint16_t i;
+  uint32_t *pResult;
+  char temp[11];
+
+  bench_request = 0;
+  pResult = bench_result;
+  memset(bench_result, 0, sizeof(bench_result));
+  for (i = 0; i < 256; i++) uip_buf[i] = (uint8_t)i;
+
+  // ENC28J60 SPI transfers, 1KB in 256 byte chunks
+  start = clock_us();
+  for (i = 0; i < 1024; i += 256) Enc28j60BenchWrite(i, uip_buf, 256);
+  pResult[BENCH_SPI_WRITE] = bench_us(start);
+  start = clock_us();
+  for (i = 0; i < 1024; i += 256) Enc28j60BenchRead(i, uip_buf, 256);
+  pResult[BENCH_SPI_READ] = bench_us(start);
+  IWDG_KR = 0xaa; // Prevent the IWDG hardware watchdog from firing.
+
+  // Checksum of 500 bytes. The uip_buf may be smaller than 500 bytes, so
+  // each pass is two checksums of 250 bytes.
+  start = clock_us();
+  for (i = 0; i < 100; i++) {
+    uip_chksum((uint16_t *)uip_buf, 250);
+    uip_chksum((uint16_t *)uip_buf, 250);
+  }
+  pResult[BENCH_CHKSUM] = bench_us(start);
+  IWDG_KR = 0xaa; // Prevent the IWDG hardware watchdog from firing.
+
+  // Decimal conversions as used in the webpages
+  start = clock_us();
+  for (i = 0; i < 1000; i++) emb_itoa((uint32_t)(100000 + i), temp, 10, 6);
+  pResult[BENCH_ITOA] = bench_us(start);
+  IWDG_KR = 0xaa; // Prevent the IWDG hardware watchdog from firing.
+
+#if OB_EEPROM_SUPPORT == 0
+  // IOControl page generation without the TCP/IP processing. Upgradeable
+  // builds are not measured as their templates are read from the I2C
+  // EEPROM with a read ahead that is shared with page transmission.
+  start = clock_us();
+  bench_render();
+  pResult[BENCH_RENDER] = bench_us(start);
+  IWDG_KR = 0xaa; // Prevent the IWDG hardware watchdog from firing.
+#endif // OB_EEPROM_SUPPORT == 0
+
+#if I2C_SUPPORT == 1
+  // I2C EEPROM read of 256 bytes from the start of Region 2
+  start = clock_us();
+  copy_I2C_EEPROM_bytes_to_RAM(uip_buf, 128, I2C_EEPROM_R2_WRITE, I2C_EEPROM_R2_READ, 0, 2);
+  copy_I2C_EEPROM_bytes_to_RAM(uip_buf, 128, I2C_EEPROM_R2_WRITE, I2C_EEPROM_R2_READ, 128, 2);
+  pResult[BENCH_I2C_READ] = bench_us(start);
+  IWDG_KR = 0xaa; // Prevent the IWDG hardware watchdog from firing.
+#endif // I2C_SUPPORT == 1
+
+#if DS18B20_SUPPORT == 1
+  // A full read of all DS18B20 sensors followed by the start of the next
+  // conversion, the same sequence task_DS18B20() runs. A read already in
+  // progress is restarted.
+  if (stored_config_settings & 0x08) {
+    start = clock_us();
+#if DS18B20_INCREMENTAL == 1
+    start_temperature();
+    while (step_temperature()) ;
+#endif // DS18B20_INCREMENTAL == 1
+#if DS18B20_INCREMENTAL == 0
+#if INTERRUPTS_ENABLED == 1
+    sim();
+#endif // INTERRUPTS_ENABLED == 1
+    get_temperature();
+#if INTERRUPTS_ENABLED == 1
+    rim();
+#endif // INTERRUPTS_ENABLED == 1
+#endif // DS18B20_INCREMENTAL == 0
+    pResult[BENCH_DS18B20] = bench_us(start);
+    IWDG_KR = 0xaa; // Prevent the IWDG hardware watchdog from firing.
+  }
+#endif // DS18B20_SUPPORT == 1
+}
+#endif // DEVELOPMENT_TOOLS == 1 && BENCHMARK_SUPPORT == 1
+
+
 #if LINKED_SUPPORT == 1
 uint8_t chk_iotype(uint8_t pin_byte, int pin_index, uint8_t chk_mask)
 {
@@ -7385,9 +9528,7 @@ void check_restart_reboot(void)
        // This message is always published with QOS 0
        if (mqtt_start == MQTT_START_COMPLETE) {
           // Publish the availability "offline" message
-          strcpy(topic_base, devicetype);
-          strcat(topic_base, stored_devicename);
-          strcat(topic_base, "/availability");
+          stpcpy(topic_prefix_copy(topic_base), "/availability");
           mqtt_publish(&mqttclient,
                        topic_base,
                        "offline",
@@ -7502,6 +9643,9 @@ void restart(void)
   MQTT_error_status = 0;
   mqtt_restart_step = MQTT_RESTART_IDLE;
   state_request = STATE_REQUEST_IDLE;
+#if MQTT_RECONNECT_BACKOFF == 1
+  mqtt_backoff_count = 0;
+#endif // MQTT_RECONNECT_BACKOFF == 1
 #endif // BUILD_SUPPORT == MQTT_BUILD
   
   apply_EEPROM_settings(); // Applies the EEPROM settings to runtime variables
@@ -7509,6 +9653,11 @@ void restart(void)
 			   // Port number, etc. Needed in a restart to make
 			   // sure all changes made on the Configuration page
 			   // are applied.
+
+#if ENC28J60_RX_FILTER == 1
+  Enc28j60SetFilter();     // Re-program the ENC28J60 receive filter as the
+                           // IP Address may have changed.
+#endif // ENC28J60_RX_FILTER == 1
 			   
   initialize_pins();       // Initialize pins and IO state trackers for the
                            // STM8 and PCF8574 pins. This is done here because
@@ -7540,12 +9689,18 @@ void reboot(void)
   // retain their values and get used in code at runtime if not properly set
   // by startup initialization.
   
+  // Save the Link Error counters counted since the last once a minute
+  // EEPROM write
+  update_debug_storage1();
+
   // Flicker LED for 1 second to indicate deliberate reboot
   fastflash();
   LEDcontrol(0);  // turn LED off
 
 #if DEBUG_SUPPORT == 15
 // UARTPrintf("Hardware reboot in reboot()\r\n");
+  // Let any buffered debug output reach the terminal before the reset
+  UARTFlush();
 #endif // DEBUG_SUPPORT == 15
 
   // Set the Window Watchdog to reboot the module
@@ -7587,6 +9742,26 @@ void init_IWDG(void)
 
 
 
+#if GPIO_PORT_BATCH == 1
+// Test the bit of IO i in the port IDR sample taken by read_port_idr()
+#if PINOUT_OPTION_SUPPORT == 0
+#define PIN_IDR(i) (port_idr[ io_map[i].port ] & io_map[i].bit)
+#endif // PINOUT_OPTION_SUPPORT == 0
+#if PINOUT_OPTION_SUPPORT == 1
+#define PIN_IDR(i) (port_idr[ io_map[io_index[i]].port ] & io_map[io_index[i]].bit)
+#endif // PINOUT_OPTION_SUPPORT == 1
+
+
+void read_port_idr(void)
+{
+  // Sample the IDR of every port so that read_input_pins() sees all input
+  // pins at the same instant and reads each IDR only once.
+  uint8_t p;
+  for (p = 0; p < NUM_PORTS; p++) port_idr[p] = io_reg[p].idr;
+}
+#endif // GPIO_PORT_BATCH == 1
+
+
 #if LINKED_SUPPORT == 0
 #if PCF8574_SUPPORT == 0 && DOMOTICZ_SUPPORT == 0
 void read_input_pins(uint8_t init_flag)
@@ -7614,8 +9789,12 @@ void read_input_pins(uint8_t init_flag)
   // the bits in the ON_OFF_word where the corresponding bits match in _new1
   // and _new2 (ie, a debounced change occurred).
 
+#if GPIO_PORT_BATCH == 1
+  read_port_idr(); // Sample all input ports at once
+#endif // GPIO_PORT_BATCH == 1
   for (i=0, mask=1; i<16; i++, mask<<=1) {
     // Is the corresponding bit of the input port register set?
+#if GPIO_PORT_BATCH == 0
 #if PINOUT_OPTION_SUPPORT == 0
     if ( io_reg[ io_map[i].port ].idr & io_map[i].bit)
 #endif // PINOUT_OPTION_SUPPORT == 0
@@ -7623,6 +9802,10 @@ void read_input_pins(uint8_t init_flag)
     j = calc_PORT_BIT_index((uint8_t)i);
     if ( io_reg[ io_map[j].port ].idr & io_map[j].bit)
 #endif // PINOUT_OPTION_SUPPORT == 1
+#endif // GPIO_PORT_BATCH == 0
+#if GPIO_PORT_BATCH == 1
+    if (PIN_IDR(i))
+#endif // GPIO_PORT_BATCH == 1
       ON_OFF_word_new1 |= (uint16_t)mask;
     else
       ON_OFF_word_new1 &= (uint16_t)(~mask);
@@ -7655,6 +9838,7 @@ void read_input_pins(uint8_t init_flag)
 
 #if LINKED_SUPPORT == 0
 #if PCF8574_SUPPORT == 1 || DOMOTICZ_SUPPORT == 1
+#if IO_BYTE_LANES == 0
 // When the PCH8574 is present the ON_OFF words need to be 32 bit to
 // accommodate 24 pins of IO. But pins 1 to 16 need to be mapped to hardware
 // using the io.map, whereas pins 17 to 24 are directly read via the I2C bus.
@@ -7690,8 +9874,12 @@ void read_input_pins(uint8_t init_flag)
   // the bits in the ON_OFF_word where the corresponding bits match in _new1
   // and _new2 (ie, a debounced change occurred).
 
+#if GPIO_PORT_BATCH == 1
+  read_port_idr(); // Sample all input ports at once
+#endif // GPIO_PORT_BATCH == 1
   for (i=0, mask=1; i<16; i++, mask<<=1) {
     // Is the corresponding bit of the input port register set?
+#if GPIO_PORT_BATCH == 0
 #if PINOUT_OPTION_SUPPORT == 0
     if ( io_reg[ io_map[i].port ].idr & io_map[i].bit)
 #endif // PINOUT_OPTION_SUPPORT == 0
@@ -7699,6 +9887,10 @@ void read_input_pins(uint8_t init_flag)
     j = calc_PORT_BIT_index((uint8_t)i);
     if ( io_reg[ io_map[j].port ].idr & io_map[j].bit)
 #endif // PINOUT_OPTION_SUPPORT == 1
+#endif // GPIO_PORT_BATCH == 0
+#if GPIO_PORT_BATCH == 1
+    if (PIN_IDR(i))
+#endif // GPIO_PORT_BATCH == 1
       ON_OFF_word_new1 |= (uint32_t)mask;
     else
       ON_OFF_word_new1 &= (uint32_t)(~mask);
@@ -7718,7 +9910,15 @@ void read_input_pins(uint8_t init_flag)
   // Read the pin states on the PCF8574
   // Note: the non-upgradeable Domoticz build uses this code section, but the
   // non-upgradeable build does not support the PCF8574.
+#if PCF8574_READ_GATE == 0
   byte = PCF8574_read();
+#endif // PCF8574_READ_GATE == 0
+#if PCF8574_READ_GATE == 1
+  // Skip the I2C read if no PCF8574 pin uses it. The loop below then leaves
+  // the PCF8574 bits of ON_OFF_word_new1 as they are.
+  if (PCF8574_read_needed()) byte = PCF8574_read();
+  else byte = (uint8_t)(ON_OFF_word_new1 >> 16);
+#endif // PCF8574_READ_GATE == 1
   for (i=16, mask = 0x00010000, byte_mask=1; i<24; i++, mask<<=1, byte_mask<<=1) {
     // Is the corresponding bit of the PCF8574 pin set?
     if (byte & byte_mask)
@@ -7751,6 +9951,7 @@ void read_input_pins(uint8_t init_flag)
     }
   }
 }
+#endif // IO_BYTE_LANES == 0
 #endif // PCF8574_SUPPORT == 1 || DOMOTICZ_SUPPORT == 1
 #endif // LINKED_SUPPORT == 0
 
@@ -7779,8 +9980,12 @@ void read_input_pins(uint8_t init_flag)
   // Compare the _new1 and _new2 samples then, for Input pins only, update
   // the bits in the ON_OFF_word where the corresponding bits match in _new1
   // and _new2 (ie, a debounced change occurred).
+#if GPIO_PORT_BATCH == 1
+  read_port_idr(); // Sample all input ports at once
+#endif // GPIO_PORT_BATCH == 1
   for (i=0, mask=1; i<16; i++, mask<<=1) {
     // Is the corresponding bit of the input port register set?
+#if GPIO_PORT_BATCH == 0
 #if PINOUT_OPTION_SUPPORT == 0
     if ( io_reg[ io_map[i].port ].idr & io_map[i].bit) {
 #endif // PINOUT_OPTION_SUPPORT == 0
@@ -7788,6 +9993,10 @@ void read_input_pins(uint8_t init_flag)
     j = calc_PORT_BIT_index((uint8_t)i);
     if ( io_reg[ io_map[j].port ].idr & io_map[j].bit) {
 #endif // PINOUT_OPTION_SUPPORT == 1
+#endif // GPIO_PORT_BATCH == 0
+#if GPIO_PORT_BATCH == 1
+    if (PIN_IDR(i)) {
+#endif // GPIO_PORT_BATCH == 1
       ON_OFF_word_new1 |= (uint16_t)mask;
     }
     else {
@@ -7840,6 +10049,7 @@ void read_input_pins(uint8_t init_flag)
 
 #if LINKED_SUPPORT == 1
 #if PCF8574_SUPPORT == 1 || DOMOTICZ_SUPPORT == 1
+#if IO_BYTE_LANES == 0
 void read_input_pins(uint8_t init_flag)
 {
   // This function reads and debounces the Input pins. It is called from the
@@ -7868,8 +10078,12 @@ void read_input_pins(uint8_t init_flag)
   // Compare the _new1 and _new2 samples then, for Input pins only, update
   // the bits in the ON_OFF_word where the corresponding bits match in _new1
   // and _new2 (ie, a debounced change occurred).
+#if GPIO_PORT_BATCH == 1
+  read_port_idr(); // Sample all input ports at once
+#endif // GPIO_PORT_BATCH == 1
   for (i=0, mask=1; i<16; i++, mask<<=1) {
     // Is the corresponding bit of the input port register set?
+#if GPIO_PORT_BATCH == 0
 #if PINOUT_OPTION_SUPPORT == 0
     if ( io_reg[ io_map[i].port ].idr & io_map[i].bit) {
 #endif // PINOUT_OPTION_SUPPORT == 0
@@ -7877,6 +10091,10 @@ void read_input_pins(uint8_t init_flag)
     j = calc_PORT_BIT_index((uint8_t)i);
     if ( io_reg[ io_map[j].port ].idr & io_map[j].bit) {
 #endif // PINOUT_OPTION_SUPPORT == 1
+#endif // GPIO_PORT_BATCH == 0
+#if GPIO_PORT_BATCH == 1
+    if (PIN_IDR(i)) {
+#endif // GPIO_PORT_BATCH == 1
       ON_OFF_word_new1 |= (uint32_t)mask;
     }
     else {
@@ -7912,7 +10130,15 @@ void read_input_pins(uint8_t init_flag)
   // Read the pin states on the PCF8574
   // Note: the non-upgradeable Domoticz build uses this code section, but the
   // non-upgradeable build does not support the PCF8574.
+#if PCF8574_READ_GATE == 0
   byte = PCF8574_read();
+#endif // PCF8574_READ_GATE == 0
+#if PCF8574_READ_GATE == 1
+  // Skip the I2C read if no PCF8574 pin uses it. The loop below then leaves
+  // the PCF8574 bits of ON_OFF_word_new1 as they are.
+  if (PCF8574_read_needed()) byte = PCF8574_read();
+  else byte = (uint8_t)(ON_OFF_word_new1 >> 16);
+#endif // PCF8574_READ_GATE == 1
   for (i=16, mask = 0x00010000, byte_mask=1, linked_mask=0x0100; i<24; i++, mask<<=1, byte_mask<<=1, linked_mask<<=1) {
     // Is the corresponding bit of the PCF8574 pin set?
     if (byte & byte_mask)
@@ -7962,10 +10188,121 @@ void read_input_pins(uint8_t init_flag)
   // Copy _new1 to _new2 for the next round
   ON_OFF_word_new2 = ON_OFF_word_new1;  
 }
+#endif // IO_BYTE_LANES == 0
 #endif // PCF8574_SUPPORT == 1 || DOMOTICZ_SUPPORT == 1
 #endif // LINKED_SUPPORT == 1
 
 
+#if PCF8574_SUPPORT == 1 || DOMOTICZ_SUPPORT == 1
+#if IO_BYTE_LANES == 1
+void read_input_pins(uint8_t init_flag)
+{
+  // This function reads and debounces the Input pins in the same way as
+  // the 32 bit read_input_pins() functions above, but accesses the IO state
+  // words one byte (8 pins) at a time with IO_LANE(). The STM8 pins are
+  // sampled into bytes 0 and 1 of the ON_OFF_word_new1 and the PCF8574 pins
+  // into byte 2. For each byte the pins that read the same in _new1 and
+  // _new2 but differ from the ON_OFF_word are found with one 8 bit
+  // calculation, and a byte with no such pins is skipped.
+  //
+  // Note: init_flag is not used when LINKED_SUPPORT == 0
+  uint8_t byte;
+  uint8_t byte_mask;
+  uint8_t changed;
+  int i;
+  int j;
+
+#if GPIO_PORT_BATCH == 1
+  read_port_idr(); // Sample all input ports at once
+#endif // GPIO_PORT_BATCH == 1
+  // Sample the STM8 pins into bytes 0 and 1 of the ON_OFF_word_new1
+  for (i=0; i<16; ) {
+    byte = 0;
+    for (byte_mask=1; byte_mask; byte_mask<<=1, i++) {
+      // Is the corresponding bit of the input port register set?
+#if GPIO_PORT_BATCH == 0
+#if PINOUT_OPTION_SUPPORT == 0
+      if ( io_reg[ io_map[i].port ].idr & io_map[i].bit) byte |= byte_mask;
+#endif // PINOUT_OPTION_SUPPORT == 0
+#if PINOUT_OPTION_SUPPORT == 1
+      j = calc_PORT_BIT_index((uint8_t)i);
+      if ( io_reg[ io_map[j].port ].idr & io_map[j].bit) byte |= byte_mask;
+#endif // PINOUT_OPTION_SUPPORT == 1
+#endif // GPIO_PORT_BATCH == 0
+#if GPIO_PORT_BATCH == 1
+      if (PIN_IDR(i)) byte |= byte_mask;
+#endif // GPIO_PORT_BATCH == 1
+    }
+    IO_LANE(ON_OFF_word_new1, i - 8) = byte;
+  }
+
+#if PCF8574_SUPPORT == 1
+  // Read the pin states on the PCF8574 into byte 2 of the ON_OFF_word_new1
+#if PCF8574_READ_GATE == 0
+  IO_LANE(ON_OFF_word_new1, 16) = PCF8574_read();
+#endif // PCF8574_READ_GATE == 0
+#if PCF8574_READ_GATE == 1
+  // Skip the I2C read if no PCF8574 pin uses it. The PCF8574 bits of
+  // ON_OFF_word_new1 are then left as they are.
+  if (PCF8574_read_needed()) IO_LANE(ON_OFF_word_new1, 16) = PCF8574_read();
+#endif // PCF8574_READ_GATE == 1
+#endif // PCF8574_SUPPORT == 1
+
+  for (i=0; i<24; ) {
+    // A debounced change occurred on the pins that read the same in _new1
+    // and _new2 but differ from the ON_OFF_word.
+    byte = IO_LANE(ON_OFF_word_new1, i);
+    changed = (uint8_t)(~(byte ^ IO_LANE(ON_OFF_word_new2, i)) & (byte ^ IO_LANE(ON_OFF_word, i)));
+    if (changed == 0) {
+      i += 8;
+      continue;
+    }
+    for (byte_mask=1; byte_mask; byte_mask<<=1, i++) {
+      if (changed & byte_mask) {
+#if LINKED_SUPPORT == 0
+        if ((pin_control[i] & 0x03) == 0x01) { // input?
+#endif // LINKED_SUPPORT == 0
+#if LINKED_SUPPORT == 1
+        // A debounced edge on a Linked pin is recorded in the linked_edge
+        // word for STM8 pins 1 to 8 and PCF8574 pins 17 to 20, unless the
+        // init_flag is set (see the 32 bit read_input_pins() above).
+        if (((pin_control[i] & 0x03) == 0x02) && (init_flag == 0)) {
+          if (i<8) linked_edge |= byte_mask;
+          if (i>15 && i<20) linked_edge |= (uint16_t)(byte_mask << 8);
+        }
+        if (chk_iotype(pin_control[i], i, 0x03) == 0x01) { // input?
+#endif // LINKED_SUPPORT == 1
+          // Flip the ON_OFF_word bit to the debounced state
+          IO_LANE(ON_OFF_word, i) ^= byte_mask;
+        }
+      }
+    }
+  }
+
+  // Copy _new1 to _new2 for the next round
+  ON_OFF_word_new2 = ON_OFF_word_new1;
+
+  // Update the pin_control bytes to match the debounced ON_OFF_word.
+  // Only input pin_control bytes are updated.
+  for (i=0; i<24; ) {
+    byte = IO_LANE(ON_OFF_word, i);
+    for (byte_mask=1; byte_mask; byte_mask<<=1, i++) {
+#if LINKED_SUPPORT == 0
+      if ((pin_control[i] & 0x03) == 0x01) { // input?
+#endif // LINKED_SUPPORT == 0
+#if LINKED_SUPPORT == 1
+      if (chk_iotype(pin_control[i], i, 0x03) == 0x01) { // input?
+#endif // LINKED_SUPPORT == 1
+        if (byte & byte_mask) pin_control[i] |= 0x80;
+        else                  pin_control[i] &= 0x7f;
+      }
+    }
+  }
+}
+#endif // IO_BYTE_LANES == 1
+#endif // PCF8574_SUPPORT == 1 || DOMOTICZ_SUPPORT == 1
+
+
 
 void encode_bit_registers(uint8_t sort_init)
 {
@@ -8035,7 +10372,38 @@ void encode_bit_registers(uint8_t sort_init)
 #endif // PCF8574_SUPPORT == 0 && DOMOTICZ_SUPPORT == 0
 
 
-#if PCF8574_SUPPORT == 1 || DOMOTICZ_SUPPORT == 1
+#if (PCF8574_SUPPORT == 1 || DOMOTICZ_SUPPORT == 1) && IO_BYTE_LANES == 1
+  {
+    // As the 32 bit sort below, but each pin is sorted into its byte of the
+    // Invert_word and ON_OFF_word with an 8 bit mask (see IO_LANE()).
+    int i;
+    uint8_t j;
+    i = 0;
+    j = 0x01;
+    while( i<24 ) {
+      // Update the Invert_word
+      if (pin_control[i] & 0x04) IO_LANE(Invert_word, i) |= j;
+      else                       IO_LANE(Invert_word, i) &= (uint8_t)~j;
+
+      // Update the ON_OFF_word. During initialization all pins are sorted
+      // into the ON_OFF_word, during runtime only the Output pins.
+#if LINKED_SUPPORT == 0
+      if ((sort_init == 1) || ((pin_control[i] & 0x03) == 0x03)) {
+#endif // LINKED_SUPPORT == 0
+#if LINKED_SUPPORT == 1
+      if ((sort_init == 1) || (chk_iotype(pin_control[i], i, 0x03) == 0x03)) {
+#endif // LINKED_SUPPORT == 1
+        if (pin_control[i] & 0x80) IO_LANE(ON_OFF_word, i) |= j;
+        else                       IO_LANE(ON_OFF_word, i) &= (uint8_t)~j;
+      }
+      i++;
+      j = (uint8_t)(j << 1);
+      if (j == 0) j = 0x01;
+    }
+  }
+#endif // (PCF8574_SUPPORT == 1 || DOMOTICZ_SUPPORT == 1) && IO_BYTE_LANES == 1
+
+#if (PCF8574_SUPPORT == 1 || DOMOTICZ_SUPPORT == 1) && IO_BYTE_LANES == 0
   {
     int i;
     uint32_t j;
@@ -8088,8 +10456,71 @@ void encode_bit_registers(uint8_t sort_init)
       j = j << 1;
     }
   }
-#endif // PCF8574_SUPPORT == 1 || DOMOTICZ_SUPPORT == 1
+#endif // (PCF8574_SUPPORT == 1 || DOMOTICZ_SUPPORT == 1) && IO_BYTE_LANES == 0
+
+#if GPIO_PORT_BATCH == 1
+  encode_port_masks();
+#endif // GPIO_PORT_BATCH == 1
+}
+
+
+#if GPIO_PORT_BATCH == 1
+void encode_port_masks(void)
+{
+  // Sort the Invert_word and ON_OFF_word states of the 16 STM8 IO pins into
+  // per port masks for write_output_pins(). port_write_mask[] holds the ODR
+  // bits of each port that are written and port_set_mask[] the bits that
+  // are written to 1. IO pins in use for UART, I2C or DS18B20 are left out
+  // of port_write_mask[] so their ODR bits are never changed. As with the
+  // per pin writes all other pins are written, since writing the ODR of an
+  // Input pin has no effect.
+  uint16_t xor_tmp;
+  uint16_t xor_tmp_mask;
+  int i;
+  uint8_t j;
+  
+  for (i = 0; i < NUM_PORTS; i++) {
+    port_set_mask[i] = 0;
+    port_write_mask[i] = 0;
+  }
+
+  // Invert the output if the Invert_word has the corresponding bit set.
+  xor_tmp = (uint16_t)(Invert_word ^ ON_OFF_word);
+
+  for (i=0, xor_tmp_mask=1; i<16; i++, xor_tmp_mask<<=1) {
+#if DEBUG_SUPPORT == 15
+    // If UART support is enabled do not write Output 11
+    if (i == 10) continue; // Output 11
+#endif // DEBUG_SUPPORT == 15
+
+#if I2C_SUPPORT == 1
+    // If I2C support is enabled do not write Output 14 and 15
+    if (i == 13) continue; // Output 14
+    if (i == 14) continue; // Output 15
+#endif // I2C_SUPPORT == 1
+
+#if DS18B20_SUPPORT == 1
+    // If DS18B20 mode is enabled do not write Output 16
+    if ((i == 15) && (stored_config_settings & 0x08)) break;
+#endif // DS18B20_SUPPORT == 1
+
+#if PINOUT_OPTION_SUPPORT == 0
+    j = (uint8_t)i;
+#endif // PINOUT_OPTION_SUPPORT == 0
+#if PINOUT_OPTION_SUPPORT == 1
+    j = calc_PORT_BIT_index((uint8_t)i);
+#endif // PINOUT_OPTION_SUPPORT == 1
+    port_write_mask[io_map[j].port] |= io_map[j].bit;
+    if (xor_tmp & xor_tmp_mask) port_set_mask[io_map[j].port] |= io_map[j].bit;
+  }
+
+#if PINOUT_OPTION_SUPPORT == 1
+  // Save the PORT:BIT index of every IO for read_input_pins(), including
+  // any skipped above.
+  for (i=0; i<16; i++) io_index[i] = calc_PORT_BIT_index((uint8_t)i);
+#endif // PINOUT_OPTION_SUPPORT == 1
 }
+#endif // GPIO_PORT_BATCH == 1
 
 
 
@@ -8115,6 +10546,18 @@ void write_output_pins(void)
   // 32 bit level.
   
 #if PCF8574_SUPPORT == 0 && DOMOTICZ_SUPPORT == 0
+#if GPIO_PORT_BATCH == 1
+  {
+    // Write the masks built by encode_port_masks(), one ODR write per port.
+    uint8_t p;
+    for (p = 0; p < NUM_PORTS; p++) {
+      if (port_write_mask[p]) {
+        io_reg[p].odr = (uint8_t)((io_reg[p].odr & ~port_write_mask[p]) | port_set_mask[p]);
+      }
+    }
+  }
+#endif // GPIO_PORT_BATCH == 1
+#if GPIO_PORT_BATCH == 0
   {
     uint16_t xor_tmp;
     uint16_t xor_tmp_mask;
@@ -8183,6 +10626,7 @@ void write_output_pins(void)
 #endif // PINOUT_OPTION_SUPPORT == 1
     }
   }
+#endif // GPIO_PORT_BATCH == 0
 #endif // PCF8574_SUPPORT == 0 && DOMOTICZ_SUPPORT == 0
 
 
@@ -8227,6 +10671,17 @@ void write_output_pins(void)
     // Invert the output if the Invert_word has the corresponding bit set.
     xor_tmp = (uint32_t)(Invert_word ^ ON_OFF_word);
 
+#if GPIO_PORT_BATCH == 1
+    // Write the STM8 pins from the masks built by encode_port_masks(), one
+    // ODR write per port.
+    for (i = 0; i < NUM_PORTS; i++) {
+      if (port_write_mask[i]) {
+        io_reg[i].odr = (uint8_t)((io_reg[i].odr & ~port_write_mask[i]) | port_set_mask[i]);
+      }
+    }
+#endif // GPIO_PORT_BATCH == 1
+
+#if GPIO_PORT_BATCH == 0
     // Loop across all IO and set or clear them according to the mask.
     // Skip IO pins that are being used for UART, I2C or DS18B20.
 //    for (i=0; i<16; i++) {
@@ -8294,6 +10749,7 @@ void write_output_pins(void)
       }
 #endif // PINOUT_OPTION_SUPPORT == 1
     }
+#endif // GPIO_PORT_BATCH == 0
 
 
 #if DEBUG_SUPPORT == 15
@@ -8414,6 +10870,82 @@ uint32_t calculate_timer(uint16_t timer_value)
 
 
 #if BUILD_SUPPORT == BROWSER_ONLY_BUILD
+void pin_timer_set(uint8_t pin, uint16_t value)
+{
+  // Load a pin_timer. With PIN_TIMER_WHEEL a running timer is also moved
+  // to the pin mask of its resolution.
+#if PIN_TIMER_WHEEL == 1
+  uint8_t level;
+#if PCF8574_SUPPORT == 0
+  uint16_t bit;
+  bit = (uint16_t)(1 << pin);
+#endif // PCF8574_SUPPORT == 0
+#if PCF8574_SUPPORT == 1
+  uint32_t bit;
+  bit = (uint32_t)1 << pin;
+#endif // PCF8574_SUPPORT == 1
+  for (level = 0; level < 4; level++) pin_timer_wheel[level] &= ~bit;
+  if (value & 0x3fff) pin_timer_wheel[value >> 14] |= bit;
+#endif // PIN_TIMER_WHEEL == 1
+  pin_timer[pin] = value;
+}
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
+
+
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD && PIN_TIMER_WHEEL == 1
+void pin_timer_tick(uint8_t level)
+{
+  // Decrement the running pin_timers of one resolution (0 = 0.1 second,
+  // 1 = 1 second, 2 = 1 minute, 3 = 1 hour). A timer that reaches zero, or
+  // was zeroed without pin_timer_set(), is removed from the pin mask.
+  uint8_t i;
+#if PCF8574_SUPPORT == 0
+  uint16_t mask;
+  uint16_t bit;
+#endif // PCF8574_SUPPORT == 0
+#if PCF8574_SUPPORT == 1
+  uint32_t mask;
+  uint32_t bit;
+#endif // PCF8574_SUPPORT == 1
+
+  mask = pin_timer_wheel[level];
+  bit = 1;
+  for (i = 0; mask != 0; i++, bit <<= 1) {
+    if (mask & bit) {
+      mask &= ~bit;
+      if ((pin_timer[i] & 0x3fff) != 0) pin_timer[i]--;
+      if ((pin_timer[i] & 0x3fff) == 0) pin_timer_wheel[level] &= ~bit;
+    }
+  }
+}
+
+
+void decrement_pin_timers(void)
+{
+  // This function decrements the pin_timers as needed. It is called once
+  // per 100ms. Only the pin masks of the resolutions that have a tick due
+  // are processed, so the cost follows the number of running timers. The
+  // 1 second tick follows the second_counter, and the 1 minute and 1 hour
+  // ticks are counted from it. If the call was delayed past more than one
+  // second the missed ticks are caught up.
+  pin_timer_tick(0);
+  while ((uint8_t)second_counter != pin_timer_second) {
+    pin_timer_second++;
+    pin_timer_tick(1);
+    if (++pin_timer_seconds == 60) {
+      pin_timer_seconds = 0;
+      pin_timer_tick(2);
+      if (++pin_timer_minutes == 60) {
+        pin_timer_minutes = 0;
+        pin_timer_tick(3);
+      }
+    }
+  }
+}
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD && PIN_TIMER_WHEEL == 1
+
+
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD && PIN_TIMER_WHEEL == 0
 void decrement_pin_timers(void)
 {
   int i;
@@ -8477,7 +11009,7 @@ void decrement_pin_timers(void)
     }
   }
 }
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD && PIN_TIMER_WHEEL == 0
 
 
 void check_reset_button(void)
@@ -8632,7 +11164,8 @@ void update_debug_storage1() {
   
   // This function writes the debug[] values to EEPROM. The write occurs only
   // if the debug[] value differs from what is in EEPROM to prevent excessive
-  // EEPROM writes.
+  // EEPROM writes. The EEPROM is not unlocked at all if nothing changed.
+  if (memcmp(stored_debug_bytes, debug_bytes, 10) == 0) return;
   unlock_eeprom();
   for (i = 0; i < 10; i++) {
     if (stored_debug_bytes[i] != debug_bytes[i]) {
@@ -8643,6 +11176,64 @@ void update_debug_storage1() {
 }
 
 
+#if UDP_LOG_SUPPORT == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+void udp_log(uint8_t code, uint16_t value)
+{
+  // Queue an event for the UDP log. This only stores the event so it can
+  // be called from time critical code such as the ENC28J60 driver.
+  if (udp_log_count < UDP_LOG_EVENTS) {
+    udp_log_queue[udp_log_count].code = code;
+    udp_log_queue[udp_log_count].value = value;
+    udp_log_count++;
+  }
+  else if (udp_log_dropped < 0xff) udp_log_dropped++;
+}
+
+
+void udp_log_flush(void)
+{
+  // Called once a second from the main loop while the uip_buf is free.
+  // Sends the queued events in one syslog datagram to the host that made
+  // the last UDP status request. Nothing is sent until a status request
+  // has been received.
+  char* pBuffer;
+  char* pStart;
+  uint8_t i;
+
+  if (loop_max_ms >= UDP_LOG_SLOW_LOOP) udp_log(UDP_LOG_LOOP, loop_max_ms);
+  loop_max_ms = 0;
+
+  if (udp_log_count == 0) return;
+  if (udp_log_addr[0] == 0 && udp_log_addr[1] == 0) return;
+
+  pStart = pBuffer = (char*)&uip_buf[UIP_LLH_LEN + UIP_IPUDPH_LEN];
+  // Facility local0, severity informational
+  pBuffer = stpcpy(pBuffer, "<134>");
+  pBuffer = stpcpy(pBuffer, (char *)stored_devicename);
+  *pBuffer++ = ':';
+  for (i = 0; i < udp_log_count; i++) {
+    *pBuffer++ = ' ';
+    pBuffer = stpcpy(pBuffer, udp_log_name[udp_log_queue[i].code]);
+    *pBuffer++ = '=';
+    emb_itoa(udp_log_queue[i].value, OctetArray, 16, 4);
+    pBuffer = stpcpy(pBuffer, OctetArray);
+  }
+  if (udp_log_dropped) {
+    pBuffer = stpcpy(pBuffer, " drop=");
+    emb_itoa(udp_log_dropped, OctetArray, 16, 4);
+    pBuffer = stpcpy(pBuffer, OctetArray);
+  }
+  udp_log_count = 0;
+  udp_log_dropped = 0;
+
+  uip_udp_send(udp_log_addr, UDP_LOG_PORT, Port_Httpd, (uint16_t)(pBuffer - pStart));
+  uip_arp_out(); // Verifies arp entry in the ARP table and builds the LLH
+  Enc28j60Send(uip_buf, uip_len);
+  uip_len = 0;
+}
+#endif // UDP_LOG_SUPPORT == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+
+
 #if DEBUG_SUPPORT == 15
 void check_rst_sr(void)
 {
@@ -47,6 +47,10 @@
 // All includes are in main.h
 #include "main.h"
 
+#if HW_SPI_SUPPORT == 1 && DS18B20_SUPPORT == 1
+  #error "HW_SPI_SUPPORT uses Port C Bit 6 and cannot be combined with DS18B20_SUPPORT"
+#endif
+
 
 void spi_init(void)
 {
@@ -57,7 +61,7 @@ void spi_init(void)
   
   // The GPIO pins used for SPI bit bang are:
   // Port C
-  //   Bit 5 - Pin 30 - Input  - ENC28J60 -INT (not used)
+  //   Bit 5 - Pin 30 - Input  - ENC28J60 -INT (used by ENC28J60_INT_RECEIVE)
   //   Bit 4 - Pin 29 - Input  - ENC28J60 SO
   //   Bit 3 - Pin 28 - Output - ENC28J60 SI
   //   Bit 2 - Pin 27 - Output - ENC28J60 SCK
@@ -80,8 +84,23 @@ void spi_init(void)
   // wait 50ms
   wait_timer((uint16_t)50000); // Wait 50ms
 
-  // From this point forward the -RESET output and -INT input should 
-  // not be needed.
+#if HW_SPI_SUPPORT == 1
+  // Configure the SPI peripheral. The GPIO pins were placed in their SPI
+  // alternate function state by gpio_init() and the SPI clock was left
+  // enabled by clock_init().
+  //   Full duplex, software slave management (NSS held high internally so
+  //   the peripheral stays in master mode)
+  //   MSB first, Master, fMASTER/2 (8MHz), CPOL = 0, CPHA = 0 (SPI mode 0
+  //   as required by the ENC28J60)
+  SPI_CR2 = (uint8_t)(SPI_CR2_SSM | SPI_CR2_SSI);
+  SPI_ICR = (uint8_t)0x00;
+  SPI_CR1 = (uint8_t)(SPI_CR1_MSTR);
+  SPI_CR1 |= (uint8_t)SPI_CR1_SPE;
+#endif // HW_SPI_SUPPORT == 1
+
+  // From this point forward the -RESET output should not be needed. The
+  // -INT input is only read by Enc28j60Receive() if ENC28J60_INT_RECEIVE is
+  // enabled.
   // Use the following functions to work with the SPI output pins
   // PC_ODR |= (uint8_t)0x02;    // -CS high
   // PC_ODR &= (uint8_t)(~0x02); // -CS low
@@ -96,6 +115,58 @@ void spi_init(void)
 }
 
 
+#if HW_SPI_SUPPORT == 1
+// SPI peripheral versions of the SPI functions. Each byte is written to
+// SPI_DR and the function waits for RXNE before continuing. Since the
+// peripheral is full duplex the received byte is always read from SPI_DR,
+// even when only writing, so that RXNE is cleared and no overrun occurs.
+// Waiting for RXNE also guarantees the last byte is completely clocked out
+// before the caller deselects the ENC28J60.
+
+void SpiWriteByte(uint8_t nByte)
+{
+  SPI_DR = nByte;
+  while (!(SPI_SR & SPI_SR_RXNE));
+  (void)SPI_DR; // Discard the received byte (SPI_DR is volatile)
+}
+
+
+void SpiWriteChunk(const uint8_t* pChunk, uint16_t nBytes)
+{
+  while (nBytes--) {
+    SPI_DR = *pChunk++;
+    while (!(SPI_SR & SPI_SR_RXNE));
+    (void)SPI_DR; // Discard the received byte
+  }
+}
+
+
+uint8_t SpiReadByte(void)
+{
+  // Reading a byte works by sending a dummy byte. The ENC28J60 will
+  // ignore the dummy byte, and the clocks used to send the dummy byte
+  // are used to transfer the read byte.
+  SPI_DR = (uint8_t)0x00;
+  while (!(SPI_SR & SPI_SR_RXNE));
+  return SPI_DR;
+}
+
+
+void SpiReadChunk(uint8_t* pChunk, uint16_t nBytes)
+{
+  // Reading data works by sending dummy bytes. The ENC28J60 will
+  // ignore the dummy bytes, and the clocks used to send the dummy bytes
+  // are used to collect the read bytes.
+  while (nBytes--) {
+    SPI_DR = (uint8_t)0x00;
+    while (!(SPI_SR & SPI_SR_RXNE));
+    *pChunk++ = SPI_DR;
+  }
+}
+#endif // HW_SPI_SUPPORT == 1
+
+
+#if HW_SPI_SUPPORT == 0
 void SpiWriteByte(uint8_t nByte)
 {
   // nByte is the data to be sent
@@ -217,3 +288,4 @@ void SPI_clock_pulse(void)
   nop();
   PC_ODR &= (uint8_t)(~0x04);      // SCK low
 }
+#endif // HW_SPI_SUPPORT == 0
@@ -47,6 +47,21 @@ extern uint8_t Pending_pin_control[24];   // Per pin configuration byte when
 					  // hardware configuration
 #endif // PCF8574_SUPPORT == 1
 
+#if DEBUG_SUPPORT == 15 && UART_TX_BUFFERED == 1
+// Transmit ring buffer. The size must be a power of 2 so the indices can
+// wrap with a mask. uart_tx_head is only written by UARTPrintf() and
+// uart_tx_tail is only written by the TX interrupt (or by UARTFlush() after
+// it disables the TX interrupt), so neither side needs to mask interrupts
+// to update its own index.
+#define UART_TX_BUF_SIZE	32
+#define UART_TX_BUF_MASK	(UART_TX_BUF_SIZE - 1)
+static uint8_t uart_tx_buf[UART_TX_BUF_SIZE];
+static volatile uint8_t uart_tx_head;     // Next free slot
+static volatile uint8_t uart_tx_tail;     // Next character to send
+uint8_t uart_tx_drop_counter;             // Characters discarded because
+                                          // the ring buffer was full
+#endif // DEBUG_SUPPORT == 15 && UART_TX_BUFFERED == 1
+
 //---------------------------------------------------------------------------//
 // This function enables the use of the STM8S UART to output characters to a
 // terminal.
@@ -182,6 +197,21 @@ void InitializeUART(void)
   
   // Set the Transmitter Enable bit
   UART2_CR2 |= (uint8_t)UART2_CR2_TEN;
+
+#if UART_TX_BUFFERED == 1
+  uart_tx_head = 0;
+  uart_tx_tail = 0;
+  uart_tx_drop_counter = 0;
+  // The TX interrupt is only enabled while the ring buffer holds
+  // characters, but interrupts must be globally enabled for it to run.
+  // This makes the build run with interrupts enabled (INTERRUPTS_ENABLED in
+  // uipopt.h). That is safe because the code that can't be interrupted
+  // masks them itself when INTERRUPTS_ENABLED is set: the copy to Flash in
+  // main(), the DS18B20 bit slots and the EXTI_CR1 write in idle_init().
+  // idle_wait() leaves interrupts enabled. The other ISRs only clear a flag
+  // or latch a pin edge.
+  rim();
+#endif // UART_TX_BUFFERED == 1
 }
 
 // A simple method of sending a string to the serial port.
@@ -193,6 +223,7 @@ void InitializeUART(void)
 //
 //  Send a message to the debug port (UART2).
 //
+#if UART_TX_BUFFERED == 0
 void UARTPrintf(char *message)
 {
   char *ch = message;
@@ -205,6 +236,78 @@ void UARTPrintf(char *message)
     ch++;
   }
 }
+
+
+void UARTFlush(void)
+{
+  // Output is not buffered so there is nothing to wait for.
+}
+#endif // UART_TX_BUFFERED == 0
+
+
+#if UART_TX_BUFFERED == 1
+// The buffered version of UARTPrintf() copies the message into the ring
+// buffer and enables the TX interrupt. The interrupt fires whenever the
+// UART data register is empty and moves one character per interrupt, so the
+// main loop only pays for the copy. If the buffer fills the rest of the
+// message is dropped rather than waiting, and the number of dropped
+// characters is counted in uart_tx_drop_counter.
+//
+void UARTPrintf(char *message)
+{
+  char *ch = message;
+  uint8_t next;
+
+  while (*ch) {
+    next = (uint8_t)((uart_tx_head + 1) & UART_TX_BUF_MASK);
+    if (next == uart_tx_tail) {
+      // Buffer full. Count the characters that are lost.
+      while (*ch) {
+        if (uart_tx_drop_counter < 0xff) uart_tx_drop_counter++;
+        ch++;
+      }
+      break;
+    }
+    uart_tx_buf[uart_tx_head] = (uint8_t)*ch;
+    uart_tx_head = next;
+    ch++;
+  }
+  // Start (or keep running) the transmit interrupt
+  UART2_CR2 |= (uint8_t)UART2_CR2_TIEN;
+}
+
+
+void UARTFlush(void)
+{
+  // Send whatever is left in the ring buffer and wait for the last
+  // character to leave the UART. Used before a reboot or the copy to Flash
+  // so the final messages are not lost. The TX interrupt is disabled and
+  // the characters are written to the data register directly, so this also
+  // works when it is called with interrupts masked.
+  UART2_CR2 &= (uint8_t)(~UART2_CR2_TIEN);
+  while (uart_tx_tail != uart_tx_head) {
+    while ((UART2_SR & UART2_SR_TXE) == 0);
+    UART2_DR = uart_tx_buf[uart_tx_tail];
+    uart_tx_tail = (uint8_t)((uart_tx_tail + 1) & UART_TX_BUF_MASK);
+  }
+  while ((UART2_SR & UART2_SR_TC) == 0);
+}
+
+
+@far @interrupt void uart2_tx_isr(void)
+{
+  // UART2 TX data register empty interrupt. Send the next character, or
+  // disable the interrupt if the ring buffer is empty. UARTPrintf()
+  // re-enables it when more characters are queued.
+  if (uart_tx_tail != uart_tx_head) {
+    UART2_DR = uart_tx_buf[uart_tx_tail];
+    uart_tx_tail = (uint8_t)((uart_tx_tail + 1) & UART_TX_BUF_MASK);
+  }
+  else {
+    UART2_CR2 &= (uint8_t)(~UART2_CR2_TIEN);
+  }
+}
+#endif // UART_TX_BUFFERED == 1
 #endif // DEBUG_SUPPORT == 15
 
 
@@ -25,6 +25,7 @@
 
 void InitializeUART(void);
 void UARTPrintf(char *message);
+void UARTFlush(void);
 
 
 
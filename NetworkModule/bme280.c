@@ -315,6 +315,10 @@ void bme280_compensate_data(const struct bme280_uncomp_data *uncomp_data,
   comp_data_temperature = comp_data->temperature;
   comp_data_pressure = comp_data->pressure;
   comp_data_humidity = comp_data->humidity;
+
+#if SENSOR_STRING_CACHE == 1
+  cache_BME280_strings();
+#endif // SENSOR_STRING_CACHE == 1
 }
 
 
@@ -819,14 +823,12 @@ int32_t altitude_adjustment(void)
 }
 
 
-void stream_sensor_data_forced_mode(struct bme280_dev *dev, struct bme280_data *comp_data)
+void bme280_start_forced_measurement(struct bme280_dev *dev)
 {
-  // This API reads the sensor temperature, pressure and humidity data in forced mode.
-    
-  uint8_t status_reg;       // Variable to contain status_reg
-  uint32_t status_reg_TO;   // Variable to contain status_reg timeout
-  uint8_t settings_sel;     // Variable to define the selecting sensors
+  // This API applies the forced mode settings and starts one measurement.
+  // The measurement is complete when bme280_measurement_done() returns 1.
 
+  uint8_t settings_sel;     // Variable to define the selecting sensors
 
   // Recommended mode of operation: Indoor navigation
   dev->settings.osr_h = BME280_OVERSAMPLING_1X;
@@ -838,11 +840,36 @@ void stream_sensor_data_forced_mode(struct bme280_dev *dev, struct bme280_data *
   settings_sel = BME280_FMODE_SETTINGS_SEL;
   bme280_set_sensor_settings(settings_sel, dev);
 
+  // Set the sensor to forced mode. This starts a measurement.
+  bme280_set_sensor_mode(BME280_FORCED_MODE, dev);
+}
+
+
+uint8_t bme280_measurement_done(void)
+{
+  // This API reads the status register and returns 1 if the measurement
+  // started by bme280_start_forced_measurement() is complete.
+
+  uint8_t status_reg;       // Variable to contain status_reg
+
+  bme280_get_regs(BME280_STATUS_REG_ADDR, &status_reg, 1);
+  if ((status_reg & 0x08) == 0) return 1;
+  return 0;
+}
+
+
+void stream_sensor_data_forced_mode(struct bme280_dev *dev, struct bme280_data *comp_data)
+{
+  // This API reads the sensor temperature, pressure and humidity data in
+  // forced mode. It waits for the measurement to complete, so it is only
+  // used where a short pause in network processing does not matter.
+    
+  uint32_t status_reg_TO;   // Variable to contain status_reg timeout
+
   // Collect one set of data
   while (1)
   {
-    // Set the sensor to forced mode. This starts a measurement.
-    bme280_set_sensor_mode(BME280_FORCED_MODE, dev);
+    bme280_start_forced_measurement(dev);
 
     // Wait for the measurement to complete then collect data.
     status_reg_TO = 0;
@@ -858,8 +885,7 @@ void stream_sensor_data_forced_mode(struct bme280_dev *dev, struct bme280_data *
       IWDG_KR = 0xaa;   // Prevent the IWDG hardware watchdog from firing.
       status_reg_TO += 2000; // Keep track of wait time
       // Read the status_reg to determine if measurement is complete.
-      bme280_get_regs(BME280_STATUS_REG_ADDR, &status_reg, 1);
-      if ((status_reg & 0x08) == 0) {
+      if (bme280_measurement_done()) {
         // Conversion complete
         break;
       }
@@ -874,4 +900,46 @@ void stream_sensor_data_forced_mode(struct bme280_dev *dev, struct bme280_data *
   } // end of while loop
 }
 
+
+#if BME280_NORMAL_SAMPLING == 1
+void bme280_start_normal_mode(struct bme280_dev *dev)
+{
+  // This API writes the oversampling, filter and standby settings once and
+  // puts the sensor in normal mode. The sensor then measures every second
+  // on its own and the data registers always hold the latest filtered
+  // result, so a sample is just bme280_get_sensor_data(). The function
+  // waits for the first measurement so the data registers are valid when
+  // it returns.
+
+  uint8_t reg_addr;
+  uint8_t reg_data;
+  uint8_t i;
+
+  // Same oversampling and filter settings as the forced mode measurement
+  dev->settings.osr_h = BME280_OVERSAMPLING_1X;
+  dev->settings.osr_p = BME280_OVERSAMPLING_16X;
+  dev->settings.osr_t = BME280_OVERSAMPLING_2X;
+  dev->settings.filter = BME280_FILTER_COEFF_16;
+  bme280_set_sensor_settings(BME280_FMODE_SETTINGS_SEL, dev);
+
+  // Set the standby time between measurements. The config register is
+  // written while the sensor is still in sleep mode because writes in
+  // normal mode may be ignored.
+  reg_addr = BME280_CONFIG_ADDR;
+  bme280_get_regs(reg_addr, &reg_data, 1);
+  reg_data = (uint8_t)(BME280_SET_BITS(reg_data, BME280_STANDBY, BME280_STANDBY_TIME_1000_MS));
+  bme280_set_regs(&reg_addr, &reg_data);
+
+  // Start continuous measurements
+  bme280_set_sensor_mode(BME280_NORMAL_MODE, dev);
+
+  // Wait up to 100ms for the first measurement (30 to 46ms)
+  for (i = 0; i < 50; i++) {
+    wait_timer(2000);
+    IWDG_KR = 0xaa;   // Prevent the IWDG hardware watchdog from firing.
+    if (bme280_measurement_done()) break;
+  }
+}
+#endif // BME280_NORMAL_SAMPLING == 1
+
 #endif // BME280_SUPPORT == 1
@@ -324,6 +324,16 @@ void user_i2c_read(uint8_t reg_addr, uint8_t *data, uint32_t len);
 void user_i2c_write(uint8_t reg_addr, const uint8_t *data, uint32_t len);
 
 
+// Function to apply the forced mode settings and start one measurement.
+// dev       : Structure instance of bme280_dev.
+void bme280_start_forced_measurement(struct bme280_dev *dev);
+
+
+// Function to check if a forced mode measurement is complete.
+// return 1 if complete, 0 if the measurement is still running
+uint8_t bme280_measurement_done(void);
+
+
 // Function to read temperature, humidity and pressure data in forced mode.
 // dev       : Structure instance of bme280_dev.
 // comp_data : Contains the compensated pressure and/or temperature and/or
@@ -331,6 +341,11 @@ void user_i2c_write(uint8_t reg_addr, const uint8_t *data, uint32_t len);
 void stream_sensor_data_forced_mode(struct bme280_dev *dev, struct bme280_data *comp_data);
 
 
+// Function to write the settings once and start normal mode measurements.
+// dev       : Structure instance of bme280_dev.
+void bme280_start_normal_mode(struct bme280_dev *dev);
+
+
 // Function to combine altitude with the BME280 pressure measurment to arrive
 // at barometric pressure.
 // return Barometric Pressure
@@ -348,8 +363,10 @@ void copy_I2C_calib_data_to_RAM(struct bme280_dev *dev);
 
 
 void BME280_temperature_string_C(void);
+void BME280_temperature_string_F(void);
 void BME280_pressure_string(void);
 void BME280_humidity_string(void);
+void cache_BME280_strings(void);
 
 
 #endif // BME280_H_
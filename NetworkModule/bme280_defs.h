@@ -147,7 +147,7 @@
 // Sensor power modes
 #define BME280_SLEEP_MODE                         UINT8_C(0x00)
 #define BME280_FORCED_MODE                        UINT8_C(0x01)
-// #define BME280_NORMAL_MODE                        UINT8_C(0x03)
+#define BME280_NORMAL_MODE                        UINT8_C(0x03)
 
 // Macro to combine two 8 bit data's to form a 16 bit data
 #define BME280_CONCAT_BYTES(msb, lsb)             (((uint16_t)msb << 8) | (uint16_t)lsb)
@@ -196,8 +196,8 @@
 #define BME280_FILTER_MSK                         UINT8_C(0x1C)
 #define BME280_FILTER_POS                         UINT8_C(0x02)
 
-// #define BME280_STANDBY_MSK                        UINT8_C(0xE0)
-// #define BME280_STANDBY_POS                        UINT8_C(0x05)
+#define BME280_STANDBY_MSK                        UINT8_C(0xE0)
+#define BME280_STANDBY_POS                        UINT8_C(0x05)
 
 // Sensor component selection macros
 // These values are internal for API implementation. Don't relate this to
@@ -232,13 +232,13 @@
 // #define BME280_MEAS_SCALING_FACTOR                UINT16_C(1000)
 
 // Standby duration selection macros
-// These aren't used in this application
+// Only BME280_STANDBY_TIME_1000_MS is used (BME280_NORMAL_SAMPLING)
 // #define BME280_STANDBY_TIME_0_5_MS                (0x00)
 // #define BME280_STANDBY_TIME_62_5_MS               (0x01)
 // #define BME280_STANDBY_TIME_125_MS                (0x02)
 // #define BME280_STANDBY_TIME_250_MS                (0x03)
 // #define BME280_STANDBY_TIME_500_MS                (0x04)
-// #define BME280_STANDBY_TIME_1000_MS               (0x05)
+#define BME280_STANDBY_TIME_1000_MS               (0x05)
 // #define BME280_STANDBY_TIME_10_MS                 (0x06)
 // #define BME280_STANDBY_TIME_20_MS                 (0x07)
 
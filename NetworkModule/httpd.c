@@ -51,6 +51,14 @@
 #define STATE_GOTGET		1	// Client just sent a GET request
 #define STATE_GOTGET2		2	// Client just sent a GET request
 #define STATE_GOTPOST		3	// Client just sent a POST request
+#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
+#define STATE_GOTFILE		STATE_GOTPOST // Every Code Uploader POST is
+                                        //   a file POST
+#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+#define STATE_GOTFILE		4	// Client just sent a firmware file
+                                        //   POST to /86 (BACKGROUND_UPLOAD)
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
 #define STATE_PARSEPOST		10	// Code is currently parsing the
                                         //   client's POST-data
 #define STATE_PARSEFILE		11	// Code is currently parsing the
@@ -62,6 +70,8 @@
 #define STATE_SENDHEADER429	14	// Or code sends the HTTP 429 header
                                         //   with Content-Length = 0 and
 					//   Retry-After of 10 seconds
+#define STATE_LONGPOLL		15	// Or code holds the Status Record
+                                        //   until a pin or sensor changes
 #define STATE_SENDDATA		20	// ... followed by data
 #define STATE_PARSEGET		21	// Code is currently parsing the
                                         //   client's GET-request
@@ -70,6 +80,11 @@
 #define HEADER200		1       // Generate HTTP/1.1 200 header
 #define HEADER204		2       // Generate HTTP/1.1 200 header
 #define HEADER429		3       // Generate HTTP/1.1 429 header
+#define HEADER200CHUNKED	4       // Generate HTTP/1.1 200 header with
+                                        //   chunked transfer encoding
+#define HEADER200SCRIPT		5       // Generate HTTP/1.1 200 header for a
+                                        //   page script with an ETag
+#define HEADER304		6       // Generate HTTP/1.1 304 header
 
 
 #define PARSE_CMD		0       // Parsing the command byte in a POST
@@ -198,12 +213,18 @@ extern uint8_t restart_reboot_step;       // Indicates whether restart or
                                           // reboot are underway.
 
 extern const char code_revision[];        // Code Revision
+
+#if HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0
+// The ETag of the page scripts is the code_revision in quotes with spaces
+// replaced by '.'
+#define ETAG_SIZE	15
+#endif // HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0
        
 uint8_t OctetArray[14];		          // Used in emb_itoa conversions and
                                           // to transfer short strings globally
 
 
-#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
+#if SREC_UPLOAD == 1
 uint8_t find_content_info;    // Used to manage steps in determining whether
                               // a file is "Content-Type: m" and in finding
 			      // a files "Content-Length".
@@ -240,7 +261,32 @@ uint8_t SREC_start;           // Used to determine if a file upload is an SREC
                               // file.
 uint8_t search_limit;         // Used to limit the time spent searching for
                               // the start of the SREC data
-#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
+
+// Hex digit values indexed by the low 5 bits of the character. '0' to '9'
+// are 0x30 to 0x39, 'a' to 'f' are 0x61 to 0x66 and 'A' to 'F' are 0x41 to
+// 0x46, so the low 5 bits are unique for all of them. This replaces the
+// range compares of hex2int() for every character of an SREC file. Any
+// other character decodes to some value and is caught by the SREC checksum.
+const uint8_t srec_hex_table[32] = {
+  0x0, 0xa, 0xb, 0xc, 0xd, 0xe, 0xf, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+  0x0, 0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7, 0x8, 0x9, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0
+};
+#define SREC_HEX2BYTE(msd, lsd) \
+  ((uint8_t)((srec_hex_table[(msd) & 0x1f] << 4) | srec_hex_table[(lsd) & 0x1f]))
+#endif // SREC_UPLOAD == 1
+
+#if RUNTIME_UPLOAD == 1
+struct tHttpD* upload_owner;  // Connection parsing a firmware file POST. The
+                              // parse_tail and the SREC parser variables
+			      // belong to it while upload_busy() is 1.
+uint32_t upload_time_last;    // second_counter when the file POST last
+                              // received a segment
+uint16_t upload_crc;          // CRC-16 CCITT of the S3 data bytes
+uint32_t upload_crc_expected; // CRC-16 carried by the file POST, or 0x10000
+                              // if the POST did not carry one
+uint8_t upload_staged;        // 1 if a complete program file is in I2C
+                              // EEPROM Region 0 waiting for the /87 install
+#endif // RUNTIME_UPLOAD == 1
 
 #if OB_EEPROM_SUPPORT == 1
 uint8_t eeprom_copy_to_flash_request;
@@ -249,8 +295,35 @@ uint8_t eeprom_copy_to_flash_request;
 uint16_t off_board_eeprom_index; // Used as an index into the I2C EEPROM
                                // when reading webpage templates
 extern uint8_t eeprom_detect;  // Used in code update routines
+#if HTTPD_EEPROM_CACHE == 1
+#define PRE_BUF_SIZE	230
+#if SCRATCH_ARENA_SHARED == 1
+// The pre_buf and the provision_buf are overlaid in the scratch_arena. The
+// scratch_owner is the one that may use it, see scratch_claim().
+#define SCRATCH_FREE		0
+#define SCRATCH_PRE_BUF		1
+#define SCRATCH_PROVISION	2
+uint8_t scratch_arena[PRE_BUF_SIZE]; // Shared by pre_buf and provision_buf
+uint8_t scratch_owner;         // SCRATCH_ owner of the scratch_arena
+#define pre_buf		((char *)scratch_arena)
+#define provision_buf	scratch_arena
+#endif // SCRATCH_ARENA_SHARED == 1
+#if SCRATCH_ARENA_SHARED == 0
+char pre_buf[PRE_BUF_SIZE];    // Read-ahead buffer for I2C EEPROM webpage
+                               // templates. Kept between CopyHttpData()
+                               // calls.
+#endif // SCRATCH_ARENA_SHARED == 0
+uint16_t pre_buf_base;         // I2C EEPROM address of pre_buf[0]
+uint8_t pre_buf_valid;         // 1 if pre_buf holds the data read from
+                               // pre_buf_base
+#endif // HTTPD_EEPROM_CACHE == 1
 #endif // OB_EEPROM_SUPPORT == 1
 
+#if PAGE_STATISTICS == 1
+struct tPageStats page_stats[PSTAT_NUM]; // Load statistics of each webpage
+                               // group (see PSTAT_ defines in httpd.h)
+#endif // PAGE_STATISTICS == 1
+
 
 // ************************************************************************ //
 // The "parse_tail" variable is used to collect each component of a POST
@@ -260,15 +333,15 @@ extern uint8_t eeprom_detect;  // Used in code update routines
 //
 // In Browser Only builds and MQTT Home Assistant builds the longest POST
 // component is the &h00 POST reply of 37 bytes.
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || HOME_ASSISTANT_SUPPORT == 1
+#if (BUILD_SUPPORT == BROWSER_ONLY_BUILD || HOME_ASSISTANT_SUPPORT == 1) && SREC_UPLOAD == 0
 uint8_t parse_tail[40];
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || HOME_ASSISTANT_SUPPORT == 1
+#endif // (BUILD_SUPPORT == BROWSER_ONLY_BUILD || HOME_ASSISTANT_SUPPORT == 1) && SREC_UPLOAD == 0
 //
 // In Domoticz builds the longest POST component is the &h00 POST reply of 53
 // bytes.
-#if DOMOTICZ_SUPPORT == 1
+#if DOMOTICZ_SUPPORT == 1 && SREC_UPLOAD == 0
 uint8_t parse_tail[54];
-#endif // DOMOTICZ_SUPPORT == 1
+#endif // DOMOTICZ_SUPPORT == 1 && SREC_UPLOAD == 0
 //
 // IMPORTANT POST NOTES:
 // Since parse_tail is a single global variable there is a high probablility
@@ -285,8 +358,9 @@ uint8_t parse_tail[54];
 // ************************************************************************ //
 
 
-#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
-uint8_t parse_tail[66];       // In the Code Uploader build the parse_tail is
+#if SREC_UPLOAD == 1
+uint8_t parse_tail[66];       // In the Code Uploader build (and runtime
+                              // builds with BACKGROUND_UPLOAD) the parse_tail is
                               // used as described above, but it is also 
 			      // enlarged and repurposed for buffering data
 			      // received in a program update file. That data
@@ -295,7 +369,7 @@ uint8_t parse_tail[66];       // In the Code Uploader build the parse_tail is
 			      // bytes.
 uint32_t file_length;         // Length of the body (the file data) in a
                               // firmware update POST.
-#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
+#endif // SREC_UPLOAD == 1
 
 
 uint8_t parse_GETcmd[11];     // Holds the GET cmd until the entire GET
@@ -316,6 +390,44 @@ uint8_t parse_GETcmd[11];     // Holds the GET cmd until the entire GET
 			      // maximum size of a GET command that can be
 			      // received.
 
+struct tHttpDCheckpoint tx_checkpoint[UIP_CONNS][HTTPD_TX_WINDOW];
+                              // Checkpoints of the segments each connection
+			      // has in flight, used to regenerate a segment
+			      // for a retransmit. They are indexed the same
+			      // way as the seglen array of the connection.
+#if HTTPD_TX_WINDOW > 1
+#define next_checkpoint() (&tx_checkpoint[uip_conn - uip_conns][(uip_oldest_segment() + uip_segments()) % HTTPD_TX_WINDOW])
+#define oldest_checkpoint() (&tx_checkpoint[uip_conn - uip_conns][uip_oldest_segment()])
+#else // HTTPD_TX_WINDOW == 1
+#define next_checkpoint() (&tx_checkpoint[uip_conn - uip_conns][0])
+#define oldest_checkpoint() next_checkpoint()
+#endif // HTTPD_TX_WINDOW > 1
+
+#if HTTPD_PAGE_CACHE == 1
+#define PAGE_CACHE_SEGMENTS	6
+uint8_t page_cache_page;      // Webpage whose segments are in the page
+                              // cache, or WEBPAGE_NULL if it is empty
+uint16_t page_cache_mss;      // uip_mss() the cached segments were cut for
+uint8_t page_cache_status;    // mqtt_start_status when the page was cached
+uint8_t page_cache_error;     // MQTT_error_status when the page was cached
+uint8_t page_cache_count;     // Number of cached segments
+uint16_t page_cache_used;     // Bytes of the ENC28J60 cache area in use
+struct tHttpDCheckpoint page_cache_at[PAGE_CACHE_SEGMENTS + 1];
+                              // CopyHttpData() state at the start of each
+			      // cached segment. The entry after the last
+			      // segment is the state at its end.
+uint16_t page_cache_len[PAGE_CACHE_SEGMENTS];
+                              // Length of each cached segment. The segments
+			      // are stored one after the other from the
+			      // start of the cache area.
+#endif // HTTPD_PAGE_CACHE == 1
+
+#if COMMAND_RATE_LIMIT == 1
+#define RATE_SOURCES	4
+uip_ipaddr_t rate_ipaddr[RATE_SOURCES]; // Browser IP address of each bucket
+uint8_t rate_tokens[RATE_SOURCES];      // Tokens left in each bucket
+#endif // COMMAND_RATE_LIMIT == 1
+
 uint16_t HtmlPageIOControl_size;     // Size of the IOControl template
 uint16_t HtmlPageConfiguration_size; // Size of the Configuration template
 uint16_t HtmlPageLoadUploader_size;  // Size of the Load Uploader template
@@ -385,6 +497,29 @@ extern uint8_t MQTT_resp_tout_counter;    // Counts response timeout events
 extern uint8_t MQTT_not_OK_counter;       // Counts MQTT != OK events
 extern uint8_t MQTT_broker_dis_counter;   // Counts broker disconnect events
 extern uint32_t second_counter;           // Counts seconds since boot
+#if STACK_MONITOR == 1
+extern uint16_t stack_peak;               // Most stack bytes used since boot
+extern uint16_t uip_buf_peak;             // Largest frame held in the uip_buf
+extern uint16_t mqtt_sendbuf_peak;        // Most mqtt_sendbuf data in use
+#endif // STACK_MONITOR == 1
+#if BOOT_PROFILE == 1
+extern uint16_t boot_time[BOOT_STAGES];   // ms at the end of each boot stage
+#endif // BOOT_PROFILE == 1
+#if UIP_CONN_RESERVE == 1
+extern uint8_t syn_drop_counter;          // Counts SYNs refused for lack of
+                                          // a connection slot
+#endif // UIP_CONN_RESERVE == 1
+#if DEVELOPMENT_TOOLS == 1 && BENCHMARK_SUPPORT == 1
+extern uint8_t bench_request;             // Runs the benchmarks on the next
+                                          // main loop pass
+extern uint32_t bench_result[BENCH_NUM];  // Benchmark results in us
+#endif // DEVELOPMENT_TOOLS == 1 && BENCHMARK_SUPPORT == 1
+#if PAGE_STATISTICS == 1 || UDP_STATUS_SUPPORT == 1
+extern uint16_t ms_counter;               // Free running ms counter
+#endif // PAGE_STATISTICS == 1 || UDP_STATUS_SUPPORT == 1
+#if UDP_STATUS_SUPPORT == 1
+extern uint16_t uip_slen;                 // Length of the UDP status reply
+#endif // UDP_STATUS_SUPPORT == 1
 
 
 #if DS18B20_SUPPORT == 1
@@ -402,6 +537,7 @@ extern uint8_t FoundROM[5][8];            // Table of found ROM codes
                                           // [x][7] = CRC
 #endif // OB_EEPROM_SUPPORT == 0
 extern int numROMs;                       // Count of DS18B20 devices found
+extern uint8_t DS18B20_scratch[5][2];     // Temperature measurements
 #endif // DS18B20_SUPPORT == 1
 
 
@@ -412,6 +548,14 @@ extern int16_t stored_altitude; // User entered altitude used for BME280
 extern int32_t comp_data_temperature; // Compensated temperature
 extern int32_t comp_data_pressure;    // Compensated pressure
 extern int32_t comp_data_humidity;    // Compensated humidity
+
+#if SENSOR_STRING_CACHE == 1
+char BME280_string[4][8];       // BME280 value strings formatted when the
+                                // sensor data is compensated:
+                                // [0] temperature C, [1] temperature F,
+                                // [2] pressure, [3] humidity
+uint8_t BME280_string_valid;    // 1 if BME280_string[] matches comp_data
+#endif // SENSOR_STRING_CACHE == 1
 #endif // BME280_SUPPORT == 1
 
 
@@ -426,6 +570,10 @@ extern uint8_t Sensor_IDX[6][8] @FLASH_START_SENSOR_IDX;
 // is still defined for all builds.
 extern uint16_t IO_TIMER[16] @FLASH_START_IO_TIMERS;
 extern char IO_NAME[16][16] @FLASH_START_IO_NAMES;
+#if BUILD_SUPPORT == MQTT_BUILD && DOMOTICZ_SUPPORT == 1
+extern uint8_t idx_hash_valid;            // 1 if the Domoticz IDX lookup
+                                          // table is up to date
+#endif // BUILD_SUPPORT == MQTT_BUILD && DOMOTICZ_SUPPORT == 1
 
 // Define RAM addresses for Pending timers
 #if PCF8574_SUPPORT == 0
@@ -623,7 +771,9 @@ static const char g_HtmlPageIOControl[] =
                "<td colspan=2 style='text-align: left'>%a00</td>"
             "</tr>"
             "<script>"
-"const m=(t=>{let e=document,r=location,$=e.querySelector.bind(e),h=$('form'),n=(Object."
+"%S00"
+#if HTTPD_SCRIPT_GZIP == 0 || HTTPD_SCRIPT_CACHE == 0
+"(t=>{let e=document,r=location,$=e.querySelector.bind(e),h=$('form'),n=(Object."
 "entries,parseInt),a=t=>e.write(t),s=(t,e)=>n(t).toString(16).padStart(e,'0'),l=t=>t.map"
 "(t=>s(t,2)).join(''),d=t=>t.match(/.{2}/g).map(t=>n(t,16)),o=t=>encodeURIComponent(t),p"
 "=[],c=[],u=(t,e,r)=>{var $;return`<label><input type=radio name=o${e} value=${t} ${r==t"
@@ -638,7 +788,9 @@ static const char g_HtmlPageIOControl[] =
 ",t>>7)}</td></tr>`):(3&t)==1&&p.push(`<tr><td>Input #${e+1}</td><td class='s${t>>7} t3'"
 "></td><td/></tr>`)}),a(p.join('')),a(`<tr><th></th><th></th>${c.length>0?'<th class=c>S"
 "ET</th>':''}</tr>`),a(c.join('')),{s:submit_form,l:reload_page,c:cfg_page,j:ioc_page_pc"
-"f}})({h00:'%h00',g00:'%g00'});"
+"f}})"
+#endif // HTTPD_SCRIPT_GZIP == 0 || HTTPD_SCRIPT_CACHE == 0
+"%S99({h00:'%h00',g00:'%g00'});"
       "%y01"
       "%y02'm.l()'>Refresh</button>"
       "<br><br>"
@@ -930,7 +1082,9 @@ static const char g_HtmlPageConfiguration[] =
               "<th>Boot state</th>"
             "</tr>"
          "<script>"
-"const m=(e=>{let t=['b00','b04','b08','b12'],$=['c00','c01'],r={'Full Duplex':1,'HA Aut"
+"%S01"
+#if HTTPD_SCRIPT_GZIP == 0 || HTTPD_SCRIPT_CACHE == 0
+"(e=>{let t=['b00','b04','b08','b12'],$=['c00','c01'],r={'Full Duplex':1,'HA Aut"
 "o':6,MQTT:4,DS18B20:8,BME280:32,'Disable Cfg Button':16},n={disabled:0,input:1,output:3"
 ",linked:2},o={retain:8,on:16,off:0},l=document,a=location,p=l.querySelector.bind(l),i=p"
 "('form'),c=Object.entries,d=parseInt,_=e=>l.write(e),s=(e,t)=>d(e).toString(16).padStar"
@@ -955,7 +1109,9 @@ static const char g_HtmlPageConfiguration[] =
 ")/g,'$&:')),f(e.h00).forEach((e,t)=>{let $=(3&e)!=0?S('p'+t,4,e):'',r=(3&e)==3||(3&e)=="
 "2&&t>7?`<select name='p${t}'>${y(o,24&e)}</select>`:'';_(`<tr><td>#${t+1}</td><td><sele"
 "ct name='p${t}'>${y(n,3&e)}</select></td><td>${$}</td><td>${r}</td></tr>`)}),p('.f').in"
-"nerHTML=Array.from(c(r),([e,t])=>S('g00',t,q,e)).join('</br>'),{r:B,s:D,l:k,i:w,p:A}})("
+"nerHTML=Array.from(c(r),([e,t])=>S('g00',t,q,e)).join('</br>'),{r:B,s:D,l:k,i:w,p:A}})"
+#endif // HTTPD_SCRIPT_GZIP == 0 || HTTPD_SCRIPT_CACHE == 0
+"%S99("
 "{b00:'%b00',b04:'%b04',b08:'%b08',c00:'%c00',d00:'%d00',b12:'%b12',c01:'%c01',h00:'%h00"
 "',g00:'%g00'});"
       "%y01"
@@ -1198,7 +1354,9 @@ static const char g_HtmlPageIOControl[] =
                "<td colspan=2 style='text-align: left'>%a00</td>"
             "</tr>"
             "<script>"
-"const m=(t=>{let e=document,r=location,$=e.querySelector.bind(e),n=$('form'),a=(Object."
+"%S00"
+#if HTTPD_SCRIPT_GZIP == 0 || HTTPD_SCRIPT_CACHE == 0
+"(t=>{let e=document,r=location,$=e.querySelector.bind(e),n=$('form'),a=(Object."
 "entries,parseInt),h=t=>e.write(t),l=(t,e)=>a(t).toString(16).padStart(e,'0'),s=t=>t.map"
 "(t=>l(t,2)).join(''),d=t=>t.match(/.{2}/g).map(t=>a(t,16)),o=t=>encodeURIComponent(t),p"
 "=[],c=[],u=(t,e,r)=>{var $;return`<label><input type=radio name=o${e} value=${t} ${r==t"
@@ -1211,7 +1369,9 @@ static const char g_HtmlPageIOControl[] =
 "e+1}</td><td class='s${t>>7} t3'></td><td class=c>${u(1,e,t>>7)}${u(0,e,t>>7)}</td></tr"
 ">`):(3&t)==1&&p.push(`<tr><td>Input #${e+1}</td><td class='s${t>>7} t3'></td><td/></tr>"
 "`)}),h(p.join('')),h(`<tr><th></th><th></th>${c.length>0?'<th class=c>SET</th>':''}</tr"
-">`),h(c.join('')),h('</table>'),{s:submit_form,l:reload_page,c:cfg_page}})({h00:'%h00',"
+">`),h(c.join('')),h('</table>'),{s:submit_form,l:reload_page,c:cfg_page}})"
+#endif // HTTPD_SCRIPT_GZIP == 0 || HTTPD_SCRIPT_CACHE == 0
+"%S99({h00:'%h00',"
 "g00:'%g00'});"
       "%y00"
       "%y02'm.l()'>Refresh</button>"
@@ -1507,7 +1667,9 @@ static const char g_HtmlPageConfiguration[] =
             "<tr class='hs'/>"
          "</table>"
          "<script>"
-"const m=(t=>{let $=['b00','b04','b08','b12'],e=['c00','c01'],r={'Full Duplex':1,MQTT:4,"
+"%S01"
+#if HTTPD_SCRIPT_GZIP == 0 || HTTPD_SCRIPT_CACHE == 0
+"(t=>{let $=['b00','b04','b08','b12'],e=['c00','c01'],r={'Full Duplex':1,MQTT:4,"
 "DS18B20:8,BME280:32,'Disable Cfg Button':16},_={disabled:0,input:1,output:3,linked:2},n"
 "={retain:8,on:16,off:0},a=document,o=location,l=a.querySelector.bind(a),d=l('form'),i=O"
 "bject.entries,p=parseInt,T=t=>a.write(t),h=(t,$)=>p(t).toString(16).padStart($,'0'),u=t"
@@ -1539,7 +1701,9 @@ static const char g_HtmlPageConfiguration[] =
 "sor Ser #</th><th>IDX</th></tr>');for(var C=0;C<6;C++){let M=(''+C).padStart(2,'0');inp"
 "ut_nr=(''+(j=C+20)).padStart(2,'0'),T(`<tr><td>${t['T'+M]}</td><td><input name='T${inpu"
 "t_nr}' value='${t['T'+input_nr]}' pattern='[0-9]{1,6}' required title='1 to 6 numbers'/"
-"></td></tr>`)}return T('</table>'),{r:B,s:I,l:q,i:E}})({b00:'%b00',b04:'%b04',b08:'%b08"
+"></td></tr>`)}return T('</table>'),{r:B,s:I,l:q,i:E}})"
+#endif // HTTPD_SCRIPT_GZIP == 0 || HTTPD_SCRIPT_CACHE == 0
+"%S99({b00:'%b00',b04:'%b04',b08:'%b08"
 "',c00:'%c00',d00:'%d00',b12:'%b12',c01:'%c01',h00:'%h00',g00:'%g00',j00:'%j00',j01:'%j0"
 "1',j02:'%j02',j03:'%j03',j04:'%j04',j05:'%j05',j06:'%j06',j07:'%j07',j08:'%j08',j09:'%j"
 "09',j10:'%j10',j11:'%j11',j12:'%j12',j13:'%j13',j14:'%j14',j15:'%j15',j16:'%j16',j17:'%"
@@ -1816,7 +1980,12 @@ static const char g_HtmlPageIOControl[] =
                "<td colspan=2 style='text-align: left'>%a00</td>"
             "</tr>"
             "<script>"
-"const m=(t=>{let $=document,e=location,j=$.querySelector.bind($),r=j('form'),h=(Object."
+"%S00"
+#if HTTPD_SCRIPT_GZIP == 0 || HTTPD_SCRIPT_CACHE == 0
+"(t=>{"
+"for(let k in t)if(!k[1]){let s=t[k],n=k<'a'?16:0,f=/[iI]/.test(k);for(;s;n++){let l="
+"f?4:1+parseInt(s[0],16);t[k+(''+n).padStart(2,'0')]=s.slice(f?0:1,l);s=s.slice(l)}}"
+"let $=document,e=location,j=$.querySelector.bind($),r=j('form'),h=(Object."
 "entries,parseInt),_=t=>$.write(t),a=(t,$)=>h(t).toString(16).padStart($,'0'),n=t=>t.map"
 "(t=>a(t,2)).join(''),s=t=>t.match(/.{2}/g).map(t=>h(t,16)),d=t=>encodeURIComponent(t),l"
 "=[],o=[],c=(t,$,e)=>{var j;return`<label><input type=radio name=o${$} value=${t} ${e==t"
@@ -1831,9 +2000,10 @@ static const char g_HtmlPageIOControl[] =
 "ss=c>${c(1,e,$>>7)}${c(0,e,$>>7)}</td></tr>`):(3&$)==1&&l.push(`<tr><td>${j}</td><td cl"
 "ass='s${$>>7} t3'></td><td/></tr>`)}),_(l.join('')),_(`<tr><th></th><th></th>${o.length"
 ">0?'<th class=c>SET</th>':''}</tr>`),_(o.join('')),{s:submit_form,l:reload_page,c:cfg_p"
-"age,j:ioc_page_pcf}})({h00:'%h00',g00:'%g00',j00:'%j00',j01:'%j01',j02:'%j02',j03:'%j03"
-"',j04:'%j04',j05:'%j05',j06:'%j06',j07:'%j07',j08:'%j08',j09:'%j09',j10:'%j10',j11:'%j1"
-"1',j12:'%j12',j13:'%j13',j14:'%j14',j15:'%j15'});"
+"age,j:ioc_page_pcf}})"
+#endif // HTTPD_SCRIPT_GZIP == 0 || HTTPD_SCRIPT_CACHE == 0
+"%S99({h00:'%h00',g00:'%g00',j:'"
+"%k00%k01%k02%k03%k04%k05%k06%k07%k08%k09%k10%k11%k12%k13%k14%k15'});"
       "%y01"
       "%y02'm.l()'>Refresh</button> "
       "<br><br>"
@@ -1883,6 +2053,19 @@ static const char g_HtmlPageIOControl[] = " ";
 //    removed from the minified script.
 
 const m = (data => {
+    // Unpack the IO Names (each preceded by its length in one hex digit)
+    // and the IO Timers (4 hex digits each) into the data[] fields the
+    // rest of the script uses. Upper case keys start at IO 17.
+    for (let key in data) if (!key[1]) {
+        let packed = data[key],
+            n = key < 'a' ? 16 : 0,
+            timer = /[iI]/.test(key);
+        for (; packed; n++) {
+            let len = timer ? 4 : 1 + parseInt(packed[0], 16);
+            data[key + ('' + n).padStart(2, '0')] = packed.slice(timer ? 0 : 1, len);
+            packed = packed.slice(len);
+        }
+    }
     const doc = document,
         loc = location,
         selector = doc.querySelector.bind(doc),
@@ -1952,22 +2135,7 @@ const m = (data => {
 ({
   h00: '01010305070b0f131781018303000000',
   g00: '14',
-  j00: 'LivingRoom12345',
-  j01: 'LivingRoom67890',
-  j02: 'IO_3',
-  j03: 'IO_4',
-  j04: 'IO_5',
-  j05: 'IO_6',
-  j06: 'IO_7',
-  j07: 'IO_8',
-  j08: 'IO_9',
-  j09: 'IO_10',
-  j10: 'IO_11',
-  j11: 'IO_12',
-  j12: 'IO_13',
-  j13: 'IO_14',
-  j14: 'Driveway_01',
-  j15: 'Garden-01',
+  j: 'fLivingRoom12345fLivingRoom678904IO_34IO_44IO_54IO_64IO_74IO_84IO_95IO_105IO_115IO_125IO_135IO_14bDriveway_019Garden-01',
 });
 
 */
@@ -2130,7 +2298,12 @@ static const char g_HtmlPageConfiguration[] =
               "<th>Timer</th>"
             "</tr>"
          "<script>"
-"const m=($=>{let e=['b00','b04','b08'],t=['c00'],i={'Full Duplex':1,DS18B20:8,BME280:32"
+"%S01"
+#if HTTPD_SCRIPT_GZIP == 0 || HTTPD_SCRIPT_CACHE == 0
+"($=>{"
+"for(let k in $)if(!k[1]){let s=$[k],n=k<'a'?16:0,f=/[iI]/.test(k);for(;s;n++){let l="
+"f?4:1+parseInt(s[0],16);$[k+(''+n).padStart(2,'0')]=s.slice(f?0:1,l);s=s.slice(l)}}"
+"let e=['b00','b04','b08'],t=['c00'],i={'Full Duplex':1,DS18B20:8,BME280:32"
 ",'Disable Cfg Button':16},_={disabled:0,input:1,output:3,linked:2},r={retain:8,on:16,of"
 "f:0},n={'0.1s':0,'1s':16384,'1m':32768,'1h':49152},a=document,l=location,j=a.querySelec"
 "tor.bind(a),o=j('form'),d=Object.entries,p=parseInt,s=$=>a.write($),c=($,e)=>p($).toStr"
@@ -2160,12 +2333,11 @@ static const char g_HtmlPageConfiguration[] =
 "e)}</select></td><td><input name='j${j}' value='${$['j'+j]}' pattern='[w*.-]{1,15}' req"
 "uired title='1 to 15 letters, numbers, and -*_. no spaces' maxlength=15/></td><td>${i}<"
 "/td><td>${d}</td><td>${c}</td>${p}</tr>`)}),j('.f').innerHTML=Array.from(d(i),([$,e])=>"
-"v('g00',e,C,$)).join('</br>'),{r:B,s:z,l:T,i:w,p:D,q:k}})({b00:'%b00',b04:'%b04',b08:'%"
-"b08',c00:'%c00',d00:'%d00',h00:'%h00',g00:'%g00',j00:'%j00',j01:'%j01',j02:'%j02',j03:'"
-"%j03',j04:'%j04',j05:'%j05',j06:'%j06',j07:'%j07',j08:'%j08',j09:'%j09',j10:'%j10',j11:"
-"'%j11',j12:'%j12',j13:'%j13',j14:'%j14',j15:'%j15',i00:'%i00',i01:'%i01',i02:'%i02',i03"
-":'%i03',i04:'%i04',i05:'%i05',i06:'%i06',i07:'%i07',i08:'%i08',i09:'%i09',i10:'%i10',i1"
-"1:'%i11',i12:'%i12',i13:'%i13',i14:'%i14',i15:'%i15'});"
+"v('g00',e,C,$)).join('</br>'),{r:B,s:z,l:T,i:w,p:D,q:k}})"
+#endif // HTTPD_SCRIPT_GZIP == 0 || HTTPD_SCRIPT_CACHE == 0
+"%S99({b00:'%b00',b04:'%b04',b08:'%b08',c00:'%c00',d00:'%d00',h00:'%h00',g00:'%g00',j:'"
+"%k00%k01%k02%k03%k04%k05%k06%k07%k08%k09%k10%k11%k12%k13%k14%k15',i:'"
+"%i00%i01%i02%i03%i04%i05%i06%i07%i08%i09%i10%i11%i12%i13%i14%i15'});"
       "%y01"
       "<p>"
       "Pinout Option %w01<br/>"
@@ -2225,6 +2397,19 @@ static const char g_HtmlPageConfiguration[] = " ";
 //    removed from the minified script.
 
 const m = (data => {
+    // Unpack the IO Names (each preceded by its length in one hex digit)
+    // and the IO Timers (4 hex digits each) into the data[] fields the
+    // rest of the script uses. Upper case keys start at IO 17.
+    for (let key in data) if (!key[1]) {
+        let packed = data[key],
+            n = key < 'a' ? 16 : 0,
+            timer = /[iI]/.test(key);
+        for (; packed; n++) {
+            let len = timer ? 4 : 1 + parseInt(packed[0], 16);
+            data[key + ('' + n).padStart(2, '0')] = packed.slice(timer ? 0 : 1, len);
+            packed = packed.slice(len);
+        }
+    }
     const ip_input_names = ['b00', 'b04', 'b08'],
         port_input_names = ['c00'],
         features = { "Full Duplex": 1, "DS18B20": 8, "BME280": 32, "Disable Cfg Button": 16 },
@@ -2328,38 +2513,8 @@ const m = (data => {
     d00: "aabbccddeeff",
     h00: "00020305070b0f131617010000000000",
     g00: "04",
-    j00: "LivingRoom12345",
-    j01: "LivingRoom67890",
-    j02: "IO_3",
-    j03: "IO_4",
-    j04: "IO_5",
-    j05: "IO_6",
-    j06: "IO_7",
-    j07: "IO_8",
-    j08: "IO_9",
-    j09: "IO_10",
-    j10: "IO_11",
-    j11: "IO_12",
-    j12: "IO_13",
-    j13: "IO_14",
-    j14: "Driveway_01",
-    j15: "Garden-01",
-    i00: "0000",
-    i01: "0000",
-    i02: "0000",
-    i03: "0000",
-    i04: "30ff",
-    i05: "7f0f",
-    i06: "bff0",
-    i07: "ffff",
-    i08: "0001",
-    i09: "0000",
-    i10: "0000",
-    i11: "0000",
-    i12: "0000",
-    i13: "0000",
-    i14: "0000",
-    i15: "0000",
+    j: "fLivingRoom12345fLivingRoom678904IO_34IO_44IO_54IO_64IO_74IO_84IO_95IO_105IO_115IO_125IO_135IO_14bDriveway_019Garden-01",
+    i: "000000000000000030ff7f0fbff0ffff00010000000000000000000000000000",
 });
 
 */
@@ -2444,7 +2599,9 @@ static const char g_HtmlPagePCFIOControl[] =
                "<td colspan=2 style='text-align: left'>%A00</td>"
             "</tr>"
             "<script>"
-"const m=(t=>{let e=document,r=location,$=e.querySelector.bind(e),n=$('form'),a=(Object."
+"%S02"
+#if HTTPD_SCRIPT_GZIP == 0 || HTTPD_SCRIPT_CACHE == 0
+"(t=>{let e=document,r=location,$=e.querySelector.bind(e),n=$('form'),a=(Object."
 "entries,parseInt),s=t=>e.write(t),h=(t,e)=>a(t).toString(16).padStart(e,'0'),l=t=>t.map"
 "(t=>h(t,2)).join(''),d=t=>t.match(/.{2}/g).map(t=>a(t,16)),o=t=>encodeURIComponent(t),p"
 "=[],c=[],u=(t,e,r)=>{var $;return`<label><input type=radio name=o${e} value=${t} ${r==t"
@@ -2459,7 +2616,9 @@ static const char g_HtmlPagePCFIOControl[] =
 ">7)}</td></tr>`):(3&t)==1&&p.push(`<tr><td>Input #${e+17}</td><td class='s${t>>7} t3'><"
 "/td><td/></tr>`)}),s(p.join('')),s(`<tr><th></th><th></th>${c.length>0?'<th class=c>SET"
 "</th>':''}</tr>`),s(c.join('')),{s:submit_form,l:reload_page,c:cfg_page,p:cfg_page_pcf,"
-"i:ioc_page}})({H00:'%H00',g00:'%g00'});"
+"i:ioc_page}})"
+#endif // HTTPD_SCRIPT_GZIP == 0 || HTTPD_SCRIPT_CACHE == 0
+"%S99({H00:'%H00',g00:'%g00'});"
       "%y01"
       "<p>"
       "%y02'm.l()'>Refresh</button>"
@@ -2672,7 +2831,9 @@ static const char g_HtmlPagePCFConfiguration[] =
               "<th>Boot state</th>"
             "</tr>"
          "<script>"
-"const m=(e=>{let t={disabled:0,input:1,output:3,linked:2},n={retain:8,on:16,off:0},r=do"
+"%S03"
+#if HTTPD_SCRIPT_GZIP == 0 || HTTPD_SCRIPT_CACHE == 0
+"(e=>{let t={disabled:0,input:1,output:3,linked:2},n={retain:8,on:16,off:0},r=do"
 "cument,$=location,d=r.querySelector.bind(r),l=d('form'),a=Object.entries,o=parseInt,i=e"
 "=>r.write(e),p=(e,t)=>o(e).toString(16).padStart(t,'0'),c=e=>e.map(e=>p(e,2)).join(''),"
 "s=e=>e.match(/.{2}/g).map(e=>o(e,16)),u=e=>encodeURIComponent(e),f=(e,t)=>a(e).map(e=>`"
@@ -2687,7 +2848,9 @@ static const char g_HtmlPagePCFConfiguration[] =
 "00).forEach((e,r)=>{let d=(3&e)!=0?h('p'+r,4,e):'',l=(3&e)==3||(3&e)==2&&r>3?`<select n"
 "ame='p${r}'>${f(n,24&e)}</select>`:'',a='#d'==$.hash?`<td>${e}</td>`:'';i(`<tr><td>#${r"
 "+17}</td><td><select name='p${r}'>${f(t,3&e)}</select></td><td>${d}</td><td>${l}</td>${"
-"a}</tr>`)}),{r:v,s:w,l:g,c:j,i:b,j:S}})({H00:'%H00'});"
+"a}</tr>`)}),{r:v,s:w,l:g,c:j,i:b,j:S}})"
+#endif // HTTPD_SCRIPT_GZIP == 0 || HTTPD_SCRIPT_CACHE == 0
+"%S99({H00:'%H00'});"
       "%y01"
       "<p>"
       "%y02'm.r()'>Reboot</button>"
@@ -2899,7 +3062,12 @@ static const char g_HtmlPagePCFIOControl[] =
                "<td colspan=2 style='text-align: left'>%A00</td>"
             "</tr>"
             "<script>"
-"const m=(t=>{let e=document,r=location,$=e.querySelector.bind(e),a=$('form'),n=(Object."
+"%S02"
+#if HTTPD_SCRIPT_GZIP == 0 || HTTPD_SCRIPT_CACHE == 0
+"(t=>{"
+"for(let k in t)if(!k[1]){let s=t[k],n=k<'a'?16:0,f=/[iI]/.test(k);for(;s;n++){let l="
+"f?4:1+parseInt(s[0],16);t[k+(''+n).padStart(2,'0')]=s.slice(f?0:1,l);s=s.slice(l)}}"
+"let e=document,r=location,$=e.querySelector.bind(e),a=$('form'),n=(Object."
 "entries,parseInt),s=t=>e.write(t),d=(t,e)=>n(t).toString(16).padStart(e,'0'),h=t=>t.map"
 "(t=>d(t,2)).join(''),l=t=>t.match(/.{2}/g).map(t=>n(t,16)),_=t=>encodeURIComponent(t),o"
 "=[],J=[],p=(t,e,r)=>{var $;return`<label><input type=radio name=o${e} value=${t} ${r==t"
@@ -2914,8 +3082,9 @@ static const char g_HtmlPagePCFIOControl[] =
 "s=c>${p(1,r,e>>7)}${p(0,r,e>>7)}</td></tr>`):(3&e)==1&&o.push(`<tr><td>${$}</td><td cla"
 "ss='s${e>>7} t3'></td><td/></tr>`)}),s(o.join('')),s(`<tr><th></th><th></th>${J.length>"
 "0?'<th class=c>SET</th>':''}</tr>`),s(J.join('')),{s:submit_form,l:reload_page,c:cfg_pa"
-"ge,p:cfg_page_pcf,i:ioc_page}})({H00:'%H00',g00:'%g00',J16:'%J16',J17:'%J17',J18:'%J18'"
-",J19:'%J19',J20:'%J20',J21:'%J21',J22:'%J22',J23:'%J23'});"
+"ge,p:cfg_page_pcf,i:ioc_page}})"
+#endif // HTTPD_SCRIPT_GZIP == 0 || HTTPD_SCRIPT_CACHE == 0
+"%S99({H00:'%H00',g00:'%g00',J:'%K16%K17%K18%K19%K20%K21%K22%K23'});"
       "%y01"
       "%y02'm.l()'>Refresh</button> "
       "<br><br>"
@@ -2969,6 +3138,19 @@ static const char g_HtmlPagePCFIOControl[] = " ";
 //    removed from the minified script.
 
 const m = (data => {
+    // Unpack the IO Names (each preceded by its length in one hex digit)
+    // and the IO Timers (4 hex digits each) into the data[] fields the
+    // rest of the script uses. Upper case keys start at IO 17.
+    for (let key in data) if (!key[1]) {
+        let packed = data[key],
+            n = key < 'a' ? 16 : 0,
+            timer = /[iI]/.test(key);
+        for (; packed; n++) {
+            let len = timer ? 4 : 1 + parseInt(packed[0], 16);
+            data[key + ('' + n).padStart(2, '0')] = packed.slice(timer ? 0 : 1, len);
+            packed = packed.slice(len);
+        }
+    }
     const doc = document,
         loc = location,
         selector = doc.querySelector.bind(doc),
@@ -3039,14 +3221,7 @@ const m = (data => {
 ({
   H00: '01010305070b0f13',
   g00: '14',
-  J16: 'LivingRoom12345',
-  J17: 'LivingRoom67890',
-  J18: 'IO_19',
-  J19: 'IO_20',
-  J20: 'IO_21',
-  J21: 'IO_22',
-  J22: 'IO_23',
-  J23: 'IO_24',
+  J: 'fLivingRoom12345fLivingRoom678905IO_195IO_205IO_215IO_225IO_235IO_24',
 });
 
 */
@@ -3155,7 +3330,12 @@ static const char g_HtmlPagePCFConfiguration[] =
               "<th>Timer</th>"
             "</tr>"
          "<script>"
-"const m=(e=>{let t={disabled:0,input:1,output:3,linked:2},$={retain:8,on:16,off:0},_={'"
+"%S03"
+#if HTTPD_SCRIPT_GZIP == 0 || HTTPD_SCRIPT_CACHE == 0
+"(e=>{"
+"for(let k in e)if(!k[1]){let s=e[k],n=k<'a'?16:0,f=/[iI]/.test(k);for(;s;n++){let l="
+"f?4:1+parseInt(s[0],16);e[k+(''+n).padStart(2,'0')]=s.slice(f?0:1,l);s=s.slice(l)}}"
+"let t={disabled:0,input:1,output:3,linked:2},$={retain:8,on:16,off:0},_={'"
 "0.1s':0,'1s':16384,'1m':32768,'1h':49152},n=document,r=location,a=n.querySelector.bind("
 "n),d=a('form'),l=Object.entries,p=parseInt,s=e=>n.write(e),i=(e,t)=>p(e).toString(16).p"
 "adStart(t,'0'),c=e=>e.map(e=>i(e,2)).join(''),o=e=>e.match(/.{2}/g).map(e=>p(e,16)),I=e"
@@ -3176,9 +3356,10 @@ static const char g_HtmlPagePCFConfiguration[] =
 "d>#${d+1}</td><td><select name='p${a}'>${u(t,3&n)}</select></td><td><input name='J${i}'"
 " value='${e['J'+i]}' pattern='[w*.-]{1,15}' required title='1 to 15 letters, numbers, a"
 "nd -*_. no spaces' maxlength=15/></td><td>${l}</td><td>${I}</td><td>${h}</td>${J}</tr>`"
-")}),{r:g,s:j,l:v,c:b,i:x,j:S}})({H00:'%H00',J16:'%J16',J17:'%J17',J18:'%J18',J19:'%J19'"
-",J20:'%J20',J21:'%J21',J22:'%J22',J23:'%J23',I16:'%I16',I17:'%I17',I18:'%I18',I19:'%I19"
-"',I20:'%I20',I21:'%I21',I22:'%I22',I23:'%I23'});"
+")}),{r:g,s:j,l:v,c:b,i:x,j:S}})"
+#endif // HTTPD_SCRIPT_GZIP == 0 || HTTPD_SCRIPT_CACHE == 0
+"%S99({H00:'%H00',J:'%K16%K17%K18%K19%K20%K21%K22%K23',I:'"
+"%I16%I17%I18%I19%I20%I21%I22%I23'});"
       "%y01"
       "%y02'm.r()'>Reboot</button>"
       "<br><br>"
@@ -3235,6 +3416,19 @@ static const char g_HtmlPagePCFConfiguration[] = " ";
 //    removed from the minified script.
 
 const m = (data => {
+    // Unpack the IO Names (each preceded by its length in one hex digit)
+    // and the IO Timers (4 hex digits each) into the data[] fields the
+    // rest of the script uses. Upper case keys start at IO 17.
+    for (let key in data) if (!key[1]) {
+        let packed = data[key],
+            n = key < 'a' ? 16 : 0,
+            timer = /[iI]/.test(key);
+        for (; packed; n++) {
+            let len = timer ? 4 : 1 + parseInt(packed[0], 16);
+            data[key + ('' + n).padStart(2, '0')] = packed.slice(timer ? 0 : 1, len);
+            packed = packed.slice(len);
+        }
+    }
     const
         pin_types = { "disabled": 0, "input": 1, "output": 3, "linked": 2 },
         boot_state = { "retain": 8, "on": 16, "off": 0 },
@@ -3311,22 +3505,8 @@ const m = (data => {
 })
 ({
     H00: "00020305070b0f13",
-    J16: "LivingRoom12345",
-    J17: "LivingRoom67890",
-    J18: "IO_19",
-    J19: "IO_20",
-    J20: "IO_21",
-    J21: "IO_22",
-    J22: "IO_23",
-    J23: "IO_24",
-    I16: "0000",
-    I17: "0000",
-    I18: "0000",
-    I19: "0000",
-    I20: "30ff",
-    I21: "7f0f",
-    I22: "bff0",
-    I23: "ffff",
+    J: "fLivingRoom12345fLivingRoom678905IO_195IO_205IO_215IO_225IO_235IO_24",
+    I: "000000000000000030ff7f0fbff0ffff",
 });
 
 */
@@ -3842,7 +4022,46 @@ static const char g_HtmlPageStats2[] =
   "<br>"
   "34 %e34"
   "<br>"
-  "35 %e35";
+  "35 %e35"
+#if STACK_MONITOR == 1
+  "<br>"
+  "36 %e36"
+#endif // STACK_MONITOR == 1
+#if BOOT_PROFILE == 1
+  "<br>"
+  "37 %e37"
+#endif // BOOT_PROFILE == 1
+#if PROFILE_SUPPORT == 1
+  "<br>"
+  "Profile count min avg max (10us)"
+  "<br>"
+  "Rx %p00"
+  "<br>"
+  "uip %p01"
+  "<br>"
+  "httpd %p02"
+  "<br>"
+  "publish %p03"
+  "<br>"
+  "temp %p04"
+  "<br>"
+  "runtime %p05"
+#endif // PROFILE_SUPPORT == 1
+#if PAGE_STATISTICS == 1
+  "<br>"
+  "Pages req done seg rexmit bytes avg max (ms)"
+  "<br>"
+  "IOControl %p10"
+  "<br>"
+  "Config %p11"
+  "<br>"
+  "script %p12"
+  "<br>"
+  "short %p13"
+  "<br>"
+  "other %p14"
+#endif // PAGE_STATISTICS == 1
+  ;
 #endif // LINK_STATISTICS == 1
 
 
@@ -3881,6 +4100,74 @@ static const char g_HtmlPageSstate[] =
   "%f00";
 
 
+#if HTTPD_STATUS_RECORD == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+// Status Record
+// Responds to URL /96 with a fixed layout record for machine polling. There
+// is no template. The record is built by CopyHttpStatus() and sent in the
+// same TCP segment as the header, so a poll costs a single round trip. All
+// fields are lower case hex with the MSByte first, separated by commas.
+// Fields for hardware not supported by the build are all zeros so the
+// layout is the same in every build.
+//   pppppp    IO pin states, bit 0 is Pin 1 (inputs after Invert)
+//   tttt      DS18B20 readings for sensors 0 to 4 (5 fields, 1/16 deg C)
+//   tttttttt  BME280 temperature, pressure, humidity (3 fields, as read)
+//   vvvvvvvv  INA226 voltage, current, power x1000 (3 fields, last read)
+//   ss        MQTT start status, MQTT error status (2 fields)
+//   cc        MQTT response timeout, not OK, broker disconnect counts (3
+//             fields)
+//   dd        Link error statistics debug_bytes (10 fields)
+//   xxxxxxxx  Transmit counter
+//   xxxxxxxx  Seconds since boot
+//   cc        SYNs refused for lack of a connection slot (UIP_CONN_RESERVE)
+#define WEBPAGE_STATUS		24
+#define STATUS_RECORD_SIZE	151
+#endif // HTTPD_STATUS_RECORD == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+
+
+#if DEVELOPMENT_TOOLS == 1 && BENCHMARK_SUPPORT == 1
+// Benchmark Record
+// Responds to URL /d5 with the results of the last benchmark run started
+// with URL /d4. There is no template. The record is built by
+// CopyHttpBench() and sent in the same TCP segment as the header. The
+// fields are the times in us in the order of the BENCH_ defines in main.h,
+// as 8 digit decimal numbers separated by commas. A benchmark not in the
+// build, or not run yet, reports 00000000.
+#define WEBPAGE_BENCHMARK	11
+#define BENCH_RECORD_SIZE	((BENCH_NUM * 9) - 1)
+#endif // DEVELOPMENT_TOOLS == 1 && BENCHMARK_SUPPORT == 1
+
+
+#if HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0
+// Page Scripts
+// The script in the IOControl, Configuration, PCF8574 IOControl and PCF8574
+// Configuration templates is delimited by %S00 to %S03 and %S99. With
+// HTTPD_SCRIPT_CACHE the script is sent as a separate resource at URL /9c
+// to /9f so that the Browser can cache it, and the page only contains the
+// call of the script with the page data. The script resource is sent with
+// an ETag, and is answered with a 304 if the Browser already has it.
+// WEBPAGE_SCRIPT to WEBPAGE_SCRIPT + 3 identify the script resources.
+#define WEBPAGE_SCRIPT		25
+// Text replacing %S0x in a page: a link to the script resource (with the
+// URL letter inserted between SCRIPT_LINK1 and SCRIPT_LINK2). Text
+// replacing %S99 in a page: the call of the script.
+#define SCRIPT_LINK1		"</script><script src=/9"
+#define SCRIPT_LINK2		"></script>"
+#define SCRIPT_CALL		"<script>const m=s"
+#define SCRIPT_LINK_SIZE	(sizeof(SCRIPT_LINK1) + sizeof(SCRIPT_LINK2) - 1 + sizeof(SCRIPT_CALL) - 1)
+#endif // HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0
+
+
+#if HTTPD_SCRIPT_GZIP == 1 && HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0
+// Compressed Page Scripts
+// With HTTPD_SCRIPT_GZIP the text between %S0x and %S99 is not compiled
+// into the templates above. The script resources are instead sent from
+// gzip compressed copies generated from the templates by mkscriptgz.py.
+// The compressed copies already start with "var s=". They are only
+// included here as they are only used by httpd.c.
+#include "httpd_script_gz.h"
+#endif // HTTPD_SCRIPT_GZIP == 1 && HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0
+
+
 // Load Uploader page Template
 // This web page is shown when the user requests the Code Uploader with the
 // /72 command. It is stored in the I2C EEPROM and used only in upgradeable
@@ -4040,7 +4327,7 @@ static const char g_HtmlPageExistingImage[] =
 #endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
 
 
-#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
+#if SREC_UPLOAD == 1
 // Timer page Template
 // This web page is shown when uploaded code is being written to the Flash.
 // The page displays a wait timer to help prevent the user from taking
@@ -4075,7 +4362,30 @@ static const char g_HtmlPageTimer[] =
   "<button onclick='location=`/`'>Continue</button>"
   "</body>"
   "</html>";
-#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
+#endif // SREC_UPLOAD == 1
+
+
+#if RUNTIME_UPLOAD == 1
+// Upload Staged page Template
+// This web page is shown when a program file POSTed to /86 is in I2C
+// EEPROM Region 0. The running code is not changed until Install (/87).
+#define WEBPAGE_UPLOAD_STAGED	15
+static const char g_HtmlPageUploadStaged[] =
+  "%y04%y05"
+  "<title>Upload Staged</title>"
+  "</head>"
+  "<body>"
+  "<h1>Upload Staged</h1>"
+  "<p>"
+  "The new firmware is stored in the I2C EEPROM.<br>"
+  "Image CRC %s03 verified<br><br>"
+  "Click Install to write it to Flash and reboot.<br><br>"
+  "</p>"
+  "<button onclick='location=`/87`'>Install</button> "
+  "<button onclick='location=`/`'>Continue</button>"
+  "</body>"
+  "</html>";
+#endif // RUNTIME_UPLOAD == 1
 
 
 #if BUILD_SUPPORT == CODE_UPLOADER_BUILD
@@ -4098,7 +4408,7 @@ static const char g_HtmlPageUploadComplete[] =
 #endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
 
 
-#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
+#if SREC_UPLOAD == 1
 // Parse Fail page Template
 // This web page is shown when uploaded code had a parsing failure.
 #define WEBPAGE_PARSEFAIL	16
@@ -4117,7 +4427,7 @@ static const char g_HtmlPageParseFail[] =
   "<button onclick='location=`/`'>Continue</button>"
   "</body>"
   "</html>";
-#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
+#endif // SREC_UPLOAD == 1
 
 /*
 #if OB_EEPROM_SUPPORT == 1
@@ -4148,6 +4458,78 @@ static const char g_HtmlPageEEPROMMissing[] =
   "I2C EEPROM Missing";
 #endif // OB_EEPROM_SUPPORT == 1
 
+#if OB_EEPROM_SUPPORT == 1 && STRING_INDEX_CACHE == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+#define STRING_INDEX	1
+#else
+#define STRING_INDEX	0
+#endif
+
+#if STRING_INDEX == 1
+// Strings Invalid webpage
+// This is shown in place of every webpage when the webpage index read from
+// the I2C EEPROM at boot failed its check. It uses the same page number as
+// the EEPROM Missing webpage.
+static const char g_HtmlPageStringsInvalid[] =
+  "I2C EEPROM Strings Invalid";
+
+// Webpages of the string index. string_index_location[] holds the offset
+// of the address and size of each one in the I2C EEPROM tables (see the
+// _ADDRESS_LOCATION and _SIZE_LOCATION defines in httpd.h), or
+// STRING_INDEX_UNUSED if the build does not have the webpage.
+#define STRING_PAGE_IOCONTROL			0
+#define STRING_PAGE_CONFIGURATION		1
+#define STRING_PAGE_PCF8574_IOCONTROL		2
+#define STRING_PAGE_PCF8574_CONFIGURATION	3
+#define STRING_PAGE_LOGIN			4
+#define STRING_PAGE_SET_PASSPHRASE		5
+#define STRING_PAGE_LOADUPLOADER		6
+#define STRING_PAGES				7
+#define STRING_INDEX_UNUSED			0xff
+#define STRING_INDEX_TABLE_SIZE			26
+#define STRING_INDEX_OFFSET(location) \
+  (uint8_t)((location) - MQTT_WEBPAGE_IOCONTROL_ADDRESS_LOCATION)
+
+static const uint8_t string_index_location[STRING_PAGES] = {
+#if BUILD_SUPPORT == MQTT_BUILD && HOME_ASSISTANT_SUPPORT == 1
+  STRING_INDEX_OFFSET(MQTT_WEBPAGE_IOCONTROL_ADDRESS_LOCATION),
+  STRING_INDEX_OFFSET(MQTT_WEBPAGE_CONFIGURATION_ADDRESS_LOCATION),
+#endif // BUILD_SUPPORT == MQTT_BUILD && HOME_ASSISTANT_SUPPORT == 1
+#if BUILD_SUPPORT == MQTT_BUILD && DOMOTICZ_SUPPORT == 1
+  STRING_INDEX_OFFSET(MQTT_DOMO_WEBPAGE_IOCONTROL_ADDRESS_LOCATION),
+  STRING_INDEX_OFFSET(MQTT_DOMO_WEBPAGE_CONFIGURATION_ADDRESS_LOCATION),
+#endif // BUILD_SUPPORT == MQTT_BUILD && DOMOTICZ_SUPPORT == 1
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
+  STRING_INDEX_OFFSET(BROWSER_ONLY_WEBPAGE_IOCONTROL_ADDRESS_LOCATION),
+  STRING_INDEX_OFFSET(BROWSER_ONLY_WEBPAGE_CONFIGURATION_ADDRESS_LOCATION),
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
+#if PCF8574_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD && HOME_ASSISTANT_SUPPORT == 1
+  STRING_INDEX_OFFSET(MQTT_WEBPAGE_PCF8574_IOCONTROL_ADDRESS_LOCATION),
+  STRING_INDEX_OFFSET(MQTT_WEBPAGE_PCF8574_CONFIGURATION_ADDRESS_LOCATION),
+#endif // PCF8574_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD && HOME_ASSISTANT_SUPPORT == 1
+#if PCF8574_SUPPORT == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+  STRING_INDEX_OFFSET(BROWSER_ONLY_WEBPAGE_PCF8574_IOCONTROL_ADDRESS_LOCATION),
+  STRING_INDEX_OFFSET(BROWSER_ONLY_WEBPAGE_PCF8574_CONFIGURATION_ADDRESS_LOCATION),
+#endif // PCF8574_SUPPORT == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+#if PCF8574_SUPPORT == 0 || DOMOTICZ_SUPPORT == 1
+  STRING_INDEX_UNUSED,
+  STRING_INDEX_UNUSED,
+#endif // PCF8574_SUPPORT == 0 || DOMOTICZ_SUPPORT == 1
+#if LOGIN_SUPPORT == 1
+  STRING_INDEX_OFFSET(WEBPAGE_LOGIN_ADDRESS_LOCATION),
+  STRING_INDEX_OFFSET(WEBPAGE_SET_PASSPHRASE_ADDRESS_LOCATION),
+#endif // LOGIN_SUPPORT == 1
+#if LOGIN_SUPPORT == 0
+  STRING_INDEX_UNUSED,
+  STRING_INDEX_UNUSED,
+#endif // LOGIN_SUPPORT == 0
+  STRING_INDEX_OFFSET(WEBPAGE_LOADUPLOADER_ADDRESS_LOCATION)
+};
+
+uint16_t string_page_address[STRING_PAGES]; // I2C EEPROM address of each
+                               // webpage in the string index
+uint8_t string_index_valid;    // 1 if the string index passed its check
+#endif // STRING_INDEX == 1
+
 
 
 //---------------------------------------------------------------------------//
@@ -4351,7 +4733,59 @@ void HttpDStringInit() {
 #endif // OB_EEPROM_SUPPORT == 0
 
 
-#if OB_EEPROM_SUPPORT == 1
+#if STRING_INDEX == 1
+  {
+    // ---------------------------------------------------------------------- //
+    // Read the string index from the I2C EEPROM
+    // ---------------------------------------------------------------------- //
+    // The webpage address table and the webpage size table are each read
+    // with one block read. The addresses of the webpages of this build are
+    // kept for init_off_board_string_pointers() and the sizes are stored as
+    // below. A webpage must start after the tables (at 0x0100) and end
+    // before the PCF8574 variables, otherwise the Strings in the I2C EEPROM
+    // are not the ones for this build and the index is marked invalid.
+    uint8_t string_index[2][STRING_INDEX_TABLE_SIZE];
+    uint16_t size[STRING_PAGES];
+    uint16_t address;
+    uint8_t i;
+    uint8_t k;
+    
+    copy_I2C_EEPROM_bytes_to_RAM(&string_index[0][0], STRING_INDEX_TABLE_SIZE, I2C_EEPROM_R2_WRITE, I2C_EEPROM_R2_READ, MQTT_WEBPAGE_IOCONTROL_ADDRESS_LOCATION, 2);
+    copy_I2C_EEPROM_bytes_to_RAM(&string_index[1][0], STRING_INDEX_TABLE_SIZE, I2C_EEPROM_R2_WRITE, I2C_EEPROM_R2_READ, MQTT_WEBPAGE_IOCONTROL_SIZE_LOCATION, 2);
+    
+    string_index_valid = 1;
+    for (i = 0; i < STRING_PAGES; i++) {
+      string_page_address[i] = 0;
+      size[i] = 0;
+      k = string_index_location[i];
+      if (k == STRING_INDEX_UNUSED) continue;
+      address = (uint16_t)((string_index[0][k] << 8) | string_index[0][k + 1]);
+      address -= 0x8000;
+      size[i] = (uint16_t)((string_index[1][k] << 8) | string_index[1][k + 1]);
+      if ((address < 0x0100)
+       || (address > PCF8574_I2C_EEPROM_R2_START_IO_TIMERS)
+       || (size[i] > (uint16_t)(PCF8574_I2C_EEPROM_R2_START_IO_TIMERS - address))) {
+        string_index_valid = 0;
+      }
+      string_page_address[i] = address;
+    }
+    
+    HtmlPageIOControl_size = size[STRING_PAGE_IOCONTROL];
+    HtmlPageConfiguration_size = size[STRING_PAGE_CONFIGURATION];
+#if PCF8574_SUPPORT == 1
+    HtmlPagePCFIOControl_size = size[STRING_PAGE_PCF8574_IOCONTROL];
+    HtmlPagePCFConfiguration_size = size[STRING_PAGE_PCF8574_CONFIGURATION];
+#endif // PCF8574_SUPPORT == 1
+#if LOGIN_SUPPORT == 1
+    HtmlPageLogin_size = size[STRING_PAGE_LOGIN];
+    HtmlPageSetPassphrase_size = size[STRING_PAGE_SET_PASSPHRASE];
+#endif // LOGIN_SUPPORT == 1
+    HtmlPageLoadUploader_size = size[STRING_PAGE_LOADUPLOADER];
+  }
+#endif // STRING_INDEX == 1
+
+
+#if OB_EEPROM_SUPPORT == 1 && STRING_INDEX == 0
   // ---------------------------------------------------------------------- //
   // Initialize size for I2C EEPROM based IOControl and Configuration pages
   // ---------------------------------------------------------------------- //
@@ -4450,7 +4884,7 @@ void HttpDStringInit() {
   // Read 2 bytes from I2C EEPROM and convert to uint16_t.
   prep_read(I2C_EEPROM_R2_WRITE, I2C_EEPROM_R2_READ, WEBPAGE_LOADUPLOADER_SIZE_LOCATION, 2);
   HtmlPageLoadUploader_size = read_two_bytes();
-#endif // OB_EEPROM_SUPPORT == 1
+#endif // OB_EEPROM_SUPPORT == 1 && STRING_INDEX == 0
 }
 
 
@@ -4477,6 +4911,43 @@ void init_off_board_string_pointers(struct tHttpD* pSocket) {
   // address for Strings is 0x0000. This initialization will compensate for
   // that disparity.
   
+#if HTTPD_EEPROM_CACHE == 1
+  // A new page is starting. Make the next CopyHttpData() call read the
+  // I2C EEPROM rather than trust data read for an earlier page.
+  pre_buf_valid = 0;
+#endif // HTTPD_EEPROM_CACHE == 1
+
+#if STRING_INDEX == 1
+  {
+    // Take the webpage address from the string index read at boot by
+    // HttpDStringInit(). If the index failed its check the Strings Invalid
+    // message is sent instead of the webpage.
+    uint8_t slot;
+    
+    if (string_index_valid == 0) {
+      pSocket->current_webpage = WEBPAGE_EEPROM_MISSING;
+      pSocket->pData = g_HtmlPageStringsInvalid;
+      pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageStringsInvalid) - 1);
+      return;
+    }
+    
+    slot = STRING_PAGES;
+    if (pSocket->current_webpage == WEBPAGE_IOCONTROL) slot = STRING_PAGE_IOCONTROL;
+    if (pSocket->current_webpage == WEBPAGE_CONFIGURATION) slot = STRING_PAGE_CONFIGURATION;
+#if PCF8574_SUPPORT == 1 && DOMOTICZ_SUPPORT == 0
+    if (pSocket->current_webpage == WEBPAGE_PCF8574_IOCONTROL) slot = STRING_PAGE_PCF8574_IOCONTROL;
+    if (pSocket->current_webpage == WEBPAGE_PCF8574_CONFIGURATION) slot = STRING_PAGE_PCF8574_CONFIGURATION;
+#endif // PCF8574_SUPPORT == 1 && DOMOTICZ_SUPPORT == 0
+#if LOGIN_SUPPORT == 1
+    if (pSocket->current_webpage == WEBPAGE_LOGIN) slot = STRING_PAGE_LOGIN;
+    if (pSocket->current_webpage == WEBPAGE_SET_PASSPHRASE) slot = STRING_PAGE_SET_PASSPHRASE;
+#endif // LOGIN_SUPPORT == 1
+    if (pSocket->current_webpage == WEBPAGE_LOADUPLOADER) slot = STRING_PAGE_LOADUPLOADER;
+    if (slot < STRING_PAGES) off_board_eeprom_index = string_page_address[slot];
+  }
+#endif // STRING_INDEX == 1
+
+#if STRING_INDEX == 0
   // ********************************************************************** //
   if (pSocket->current_webpage == WEBPAGE_IOCONTROL) {
 
@@ -4606,6 +5077,7 @@ void init_off_board_string_pointers(struct tHttpD* pSocket) {
     off_board_eeprom_index = read_two_bytes() - 0x8000;
   }
 #endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+#endif // STRING_INDEX == 0
 }
 #endif // OB_EEPROM_SUPPORT == 1
 
@@ -4775,1225 +5247,557 @@ void read_httpd_diagnostic_bytes(void)
 #endif // DEBUG_SUPPORT == 15
 
 
+#if HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0
+static const char* find_script_marker(const char* pTemplate, char nDigit1, char nDigit2)
+{
+  // Returns a pointer to the %Sxx marker with the given digits in a Flash
+  // template, or 0 if there is none.
+  while (*pTemplate != '\0') {
+    if (pTemplate[0] == '%' && pTemplate[1] == 'S'
+     && pTemplate[2] == nDigit1 && pTemplate[3] == nDigit2) return pTemplate;
+    pTemplate++;
+  }
+  return 0;
+}
+
+
+static const char* find_script(uint8_t nScript)
+{
+  // Returns a pointer to the %S0x marker that starts page script nScript,
+  // or 0 if the page is not part of this build.
+  const char* pTemplate;
+  switch (nScript)
+  {
+    case 0:  pTemplate = g_HtmlPageIOControl; break;
+    case 1:  pTemplate = g_HtmlPageConfiguration; break;
+#if PCF8574_SUPPORT == 1 && (BUILD_TYPE_BROWSER_UPGRADEABLE == 1 || HOME_ASSISTANT_SUPPORT == 1)
+    case 2:  pTemplate = g_HtmlPagePCFIOControl; break;
+    case 3:  pTemplate = g_HtmlPagePCFConfiguration; break;
+#endif // PCF8574_SUPPORT == 1 && (BUILD_TYPE_BROWSER_UPGRADEABLE == 1 || HOME_ASSISTANT_SUPPORT == 1)
+    default: return 0;
+  }
+  return find_script_marker(pTemplate, '0', (char)('0' + nScript));
+}
+
+
+static uint16_t script_size(uint8_t nScript)
+{
+  // Returns the template size of page script nScript from its %S0x marker
+  // up to its %S99 marker.
+  const char* pStart;
+  pStart = find_script(nScript);
+  if (pStart == 0) return 0;
+  return (uint16_t)(find_script_marker(pStart, '9', '9') - pStart);
+}
+
+
+static uint8_t page_script(uint8_t webpage)
+{
+  // Returns the number of the script in a webpage, or 0xff if there is
+  // none.
+  if (webpage == WEBPAGE_IOCONTROL) return 0;
+  if (webpage == WEBPAGE_CONFIGURATION) return 1;
+#if PCF8574_SUPPORT == 1 && (BUILD_TYPE_BROWSER_UPGRADEABLE == 1 || HOME_ASSISTANT_SUPPORT == 1)
+  if (webpage == WEBPAGE_PCF8574_IOCONTROL) return 2;
+  if (webpage == WEBPAGE_PCF8574_CONFIGURATION) return 3;
+#endif // PCF8574_SUPPORT == 1 && (BUILD_TYPE_BROWSER_UPGRADEABLE == 1 || HOME_ASSISTANT_SUPPORT == 1)
+  return 0xff;
+}
+
+
+#if HTTPD_SCRIPT_GZIP == 1
+static const char* script_gz(uint8_t nScript, uint16_t* pSize)
+{
+  // Returns a pointer to the gzip compressed copy of page script nScript
+  // and its size in *pSize. find_script() must already have confirmed that
+  // the page is part of this build.
+  switch (nScript)
+  {
+    case 0:  *pSize = sizeof(g_ScriptGzIOControl);
+             return (const char*)g_ScriptGzIOControl;
+    case 1:  *pSize = sizeof(g_ScriptGzConfiguration);
+             return (const char*)g_ScriptGzConfiguration;
+#if PCF8574_SUPPORT == 1 && (BUILD_TYPE_BROWSER_UPGRADEABLE == 1 || HOME_ASSISTANT_SUPPORT == 1)
+    case 2:  *pSize = sizeof(g_ScriptGzPCFIOControl);
+             return (const char*)g_ScriptGzPCFIOControl;
+    case 3:  *pSize = sizeof(g_ScriptGzPCFConfiguration);
+             return (const char*)g_ScriptGzPCFConfiguration;
+#endif // PCF8574_SUPPORT == 1 && (BUILD_TYPE_BROWSER_UPGRADEABLE == 1 || HOME_ASSISTANT_SUPPORT == 1)
+    default: *pSize = 0;
+             return 0;
+  }
+}
+#endif // HTTPD_SCRIPT_GZIP == 1
+
+
+static char etag_char(uint8_t i)
+{
+  // Returns character i of the ETag of the page scripts
+  if (i == 0 || i == ETAG_SIZE - 1) return '"';
+  if (code_revision[i - 1] == ' ') return '.';
+  return code_revision[i - 1];
+}
+
+
+static char* copy_etag(char* pBuffer)
+{
+  // Copy the ETag of the page scripts to the pBuffer
+  uint8_t i;
+  for (i = 0; i < ETAG_SIZE; i++) *pBuffer++ = etag_char(i);
+  *pBuffer = '\0';
+  return pBuffer;
+}
+#endif // HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0
+
+
+#if HTTPD_CHUNKED_TRANSFER == 0
+// The following table provides the size information the adjust_template_size
+// function needs for each webpage. The size of the webpage that will be
+// transmitted is the size of the webpage template plus adjustments for the
+// text strings that replace markers in the template. Each table entry has:
+//   webpage - The webpage the entry applies to.
+//   strings - Counts of the marker strings whose replacement size is only
+//             known at run time, packed with the PAGE_STRINGS macro:
+//               header     - 1 if the page has the %y04 %y05 header strings
+//               devicename - Number of Device Name fields %a00
+//               y00        - Number of %y00 strings
+//               y01        - Number of %y01 strings
+//               y02        - Number of %y02 strings
+//   delta   - Sum of the adjustments for all markers whose replacement size
+//             is fixed. For each marker type this is
+//             (#instances x (value_size - marker_field_size))
+//             The derivation of each sum is in the comment above the entry.
+//   size    - Size of a template stored in Flash, or 0 if the size is in a
+//             RAM variable
+//   pSize   - Pointer to the RAM variable holding the template size for
+//             templates that can be stored in I2C EEPROM, else 0
+// Adjustments that depend on settings or user entered text (for instance
+// IO Names and the temperature sensor display) are made in the
+// adjust_template_size function after the table lookup.
+struct page_size {
+    uint8_t webpage;
+    uint8_t strings;
+    int16_t delta;
+    uint16_t size;
+    uint16_t* pSize;
+};
+
+#define PAGE_STRINGS(header, devicename, y00, y01, y02) \
+  ((header) | ((devicename) << 1) | ((y00) << 3) | ((y01) << 4) | ((y02) << 5))
+
+const struct page_size page_size_table[] = {
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+  // WEBPAGE_IOCONTROL
+  //   %g00 Config string         1 x (2 - 4)  = -2
+  //   %h00 Pin control           1 x (32 - 4) = 28
+  //        (Domoticz builds)     1 x (48 - 4) = 44
+  //   %y01 Save and Undo All buttons (%y00 in Domoticz builds)
+  //   %y02 Refresh, Configuration and PCF8574 IOControl buttons (no
+  //        PCF8574 IOControl button in Domoticz builds)
+  //   The TIMER fields are equal in size to the placeholder.
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || HOME_ASSISTANT_SUPPORT == 1
+  { WEBPAGE_IOCONTROL, PAGE_STRINGS(1, 2, 0, 1, 3), -2 + 28, 0, &HtmlPageIOControl_size },
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || HOME_ASSISTANT_SUPPORT == 1
+#if DOMOTICZ_SUPPORT == 1
+  { WEBPAGE_IOCONTROL, PAGE_STRINGS(1, 2, 1, 0, 2), -2 + 44, 0, &HtmlPageIOControl_size },
+#endif // DOMOTICZ_SUPPORT == 1
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+#if DOMOTICZ_SUPPORT == 0
+#if PCF8574_SUPPORT == 1
+  // WEBPAGE_PCF8574_IOCONTROL
+  //   %g00 Config string         1 x (2 - 4)  = -2
+  //   %H00 Pin control           1 x (16 - 4) = 12
+  //   %y01 Save and Undo All buttons
+  //   %y02 Refresh, Configuration PCF8574, Configuration and IO Control
+  //        buttons
+  //   The Timer fields %I16 to %I23 are equal in size to the placeholder.
+  { WEBPAGE_PCF8574_IOCONTROL, PAGE_STRINGS(1, 2, 0, 1, 4), -2 + 12, 0, &HtmlPagePCFIOControl_size },
+#endif // PCF8574_SUPPORT == 1
+#endif // DOMOTICZ_SUPPORT == 0
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+  // WEBPAGE_CONFIGURATION
+  //   %b00 %b04 %b08 IP Address, Gateway, Netmask
+  //                              3 x (8 - 4)  = 12
+  //   %c00 Port                  1 x (5 - 4)  = 1
+  //   %d00 MAC                   1 x (12 - 4) = 8
+  //   %g00 Config string         1 x (2 - 4)  = -2
+  //   %w00 Code Revision + Type  1 x (36 - 4) = 32
+  //   %w01 Pinout Option digit   1 x (1 - 4)  = -3
+  //   %w02 PCF8574 Presence      1 x (1 - 4)  = -3
+  //   Sum of the above                        = 45
+  //   %h00 Pin control           1 x (32 - 4) = 28
+  //        (Domoticz builds)     1 x (48 - 4) = 44
+  //   MQTT builds:
+  //     %b12 MQTT IP Address     1 x (8 - 4)  = 4
+  //     %c01 MQTT Port           1 x (5 - 4)  = 1
+  //     %n00 to %n04 State boxes 5 x (1 - 4)  = -15
+  //   Domoticz builds:
+  //     %T00 to %T05 Sensor Names
+  //                              6 x (12 - 4) = 48
+  //     %j16 to %j23 IDX fields if PCF8574 is not supported
+  //                              8 x (1 - 4)  = -24
+  //   %y01 Save and Undo All buttons (%y00 in Domoticz builds)
+  //   %y02 Reboot, Refresh, IOControl, PCF8574 Configuration and Login
+  //        Configuration buttons (no Login Configuration button in Home
+  //        Assistant builds, only the first three in Domoticz builds)
+  //   The Timer fields %i00 to %i15 are equal in size to the placeholder.
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
+  { WEBPAGE_CONFIGURATION, PAGE_STRINGS(1, 2, 0, 1, 5), 45 + 28, 0, &HtmlPageConfiguration_size },
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
+#if HOME_ASSISTANT_SUPPORT == 1
+  { WEBPAGE_CONFIGURATION, PAGE_STRINGS(1, 2, 0, 1, 4), 45 + 28 + 4 + 1 - 15, 0, &HtmlPageConfiguration_size },
+#endif // HOME_ASSISTANT_SUPPORT == 1
+#if DOMOTICZ_SUPPORT == 1
+#if PCF8574_SUPPORT == 1
+  { WEBPAGE_CONFIGURATION, PAGE_STRINGS(1, 2, 1, 0, 3), 45 + 44 + 4 + 1 - 15 + 48, 0, &HtmlPageConfiguration_size },
+#endif // PCF8574_SUPPORT == 1
+#if PCF8574_SUPPORT == 0
+  { WEBPAGE_CONFIGURATION, PAGE_STRINGS(1, 2, 1, 0, 3), 45 + 44 + 4 + 1 - 15 + 48 - 24, 0, &HtmlPageConfiguration_size },
+#endif // PCF8574_SUPPORT == 0
+#endif // DOMOTICZ_SUPPORT == 1
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || HOME_ASSISTANT_SUPPORT == 1
+#if PCF8574_SUPPORT == 1
+  // WEBPAGE_PCF8574_CONFIGURATION
+  //   %g00 Config string         1 x (2 - 4)  = -2
+  //   %H00 Pin control           1 x (16 - 4) = 12
+  //   %y01 Save and Undo All buttons
+  //   %y02 Reboot, Refresh, PCF8574 IO Control, Configuration and IO
+  //        Control buttons
+  //   The Timer fields %I16 to %I23 are equal in size to the placeholder.
+  { WEBPAGE_PCF8574_CONFIGURATION, PAGE_STRINGS(1, 2, 0, 1, 5), -2 + 12, 0, &HtmlPagePCFConfiguration_size },
+#endif // PCF8574_SUPPORT == 1
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || HOME_ASSISTANT_SUPPORT == 1
+
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD && SHORT_TEMPERATURE_SUPPORT == 1
+  // WEBPAGE_SHORT_TEMPERATURE
+  //   The Temperature Sensor insertions depend on settings.
+  { WEBPAGE_SHORT_TEMPERATURE, PAGE_STRINGS(0, 0, 0, 0, 0), 0, (uint16_t)(sizeof(g_HtmlPageShortTemperature) - 1), 0 },
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD && SHORT_TEMPERATURE_SUPPORT == 1
+
+#if LOGIN_SUPPORT == 1
+  // WEBPAGE_LOGIN
+  //   The Passphrase field %l02 is always empty when sent to the Browser so
+  //   the placeholder has no effect on size.
+  { WEBPAGE_LOGIN, PAGE_STRINGS(1, 0, 0, 0, 0), 0, 0, &HtmlPageLogin_size },
+  // WEBPAGE_SET_PASSPHRASE
+  //   The Passphrase field %l01 is read from I2C EEPROM at run time.
+  { WEBPAGE_SET_PASSPHRASE, PAGE_STRINGS(1, 0, 0, 0, 0), 0, 0, &HtmlPageSetPassphrase_size },
+#endif // LOGIN_SUPPORT == 1
+
+#if NETWORK_STATISTICS == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+  // WEBPAGE_STATS1 (Network Statistics)
+  //   %e00 to %e21 Statistics    22 x (10 - 4) = 132
+  { WEBPAGE_STATS1, PAGE_STRINGS(1, 1, 0, 0, 0), 132, (uint16_t)(sizeof(g_HtmlPageStats1) - 1), 0 },
+#endif // NETWORK_STATISTICS == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+
+#if LINK_STATISTICS == 1
+  // WEBPAGE_STATS2 (Link Error Statistics)
+  //   %e31 to %e35 Statistics    5 x (10 - 4) = 30
+  //   %e36 Stack and buffer peaks 1 x (12 - 4) = 8 (STACK_MONITOR)
+  //   %e37 Boot profile          1 x (16 - 4) = 12 (BOOT_PROFILE)
+  //   %p10 to %p14 Page statistics 5 x (44 - 4) = 200 (PAGE_STATISTICS)
+#if PROFILE_SUPPORT == 0
+  { WEBPAGE_STATS2, PAGE_STRINGS(0, 0, 0, 0, 0), 30 + (STACK_MONITOR * 8) + (BOOT_PROFILE * 12) + (PAGE_STATISTICS * 200), (uint16_t)(sizeof(g_HtmlPageStats2) - 1), 0 },
+#endif // PROFILE_SUPPORT == 0
+#if PROFILE_SUPPORT == 1
+  //   %p00 to %p05 Profile       6 x (23 - 4) = 114
+  { WEBPAGE_STATS2, PAGE_STRINGS(0, 0, 0, 0, 0), 144 + (STACK_MONITOR * 8) + (BOOT_PROFILE * 12) + (PAGE_STATISTICS * 200), (uint16_t)(sizeof(g_HtmlPageStats2) - 1), 0 },
+#endif // PROFILE_SUPPORT == 1
+#endif // LINK_STATISTICS == 1
+
+#if RF_ATTEN_SUPPORT == 1
+  // WEBPAGE_RF_ATTEN (special RF Attenuator page)
+  //   %f01 Current Decibel setting
+  //                              1 x (2 - 4)   = -2
+  //   %y06 <button onclick='location=`/51003f00
+  //                              32 x (36 - 4) = 1024
+  //   %y07 </button>&emsp;&ensp;
+  //                              32 x (21 - 4) = 544
+  { WEBPAGE_RF_ATTEN, PAGE_STRINGS(1, 1, 0, 0, 0), -2 + 1024 + 544, (uint16_t)(sizeof(g_HtmlPageRFAtten) - 1), 0 },
+#endif // RF_ATTEN_SUPPORT == 1
+
+#if SDR_POWER_RELAY_SUPPORT == 1
+  // WEBPAGE_SDR_POWER_RELAY (special SDR Power Relay page)
+  //   %n10 to %n17 Green / Red relay status
+  //                              8 x (3 - 4)   = -8
+  { WEBPAGE_SDR_POWER_RELAY, PAGE_STRINGS(1, 1, 0, 0, 0), -8, (uint16_t)(sizeof(g_HtmlPageSDRPowerRelay) - 1), 0 },
+#endif // SDR_POWER_RELAY_SUPPORT == 1
+
+#if INA226_SUPPORT == 1
+  // WEBPAGE_INA226 (special Current, Voltage, Wattage page)
+  //   %t06 Current, Voltage, Wattage string
+  //                              5 x (63 - 4)  = 295
+  { WEBPAGE_INA226, PAGE_STRINGS(1, 1, 0, 0, 0), 295, (uint16_t)(sizeof(g_HtmlPageINA226) - 1), 0 },
+#endif // INA226_SUPPORT == 1
+
+#if DEBUG_SENSOR_SERIAL == 1
+  // WEBPAGE_SENSOR_SERIAL
+  { WEBPAGE_SENSOR_SERIAL, PAGE_STRINGS(1, 1, 0, 0, 0), 0, (uint16_t)(sizeof(g_HtmlPageTmpSerialNum) - 1), 0 },
+#endif // DEBUG_SENSOR_SERIAL
+
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+  // WEBPAGE_SSTATE
+  //   %f00 Short Form IO Settings for 16 pins
+  //                              1 x (16 - 4)  = 12
+  //   8 more pins are added at run time if a PCF8574 is present.
+  { WEBPAGE_SSTATE, PAGE_STRINGS(0, 0, 0, 0, 0), 12, (uint16_t)(sizeof(g_HtmlPageSstate) - 1), 0 },
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+
+#if OB_EEPROM_SUPPORT == 1
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+  // WEBPAGE_LOADUPLOADER
+  //   This template is always stored in I2C EEPROM.
+  { WEBPAGE_LOADUPLOADER, PAGE_STRINGS(1, 0, 0, 0, 0), 0, 0, &HtmlPageLoadUploader_size },
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+#endif // OB_EEPROM_SUPPORT == 1
+
+#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
+  // WEBPAGE_UPLOADER
+  //   %w00 Code Revision + Type  1 x (36 - 4)  = 32
+  { WEBPAGE_UPLOADER, PAGE_STRINGS(1, 0, 0, 0, 0), 32, (uint16_t)(sizeof(g_HtmlPageUploader) - 1), 0 },
+  { WEBPAGE_EXISTING_IMAGE, PAGE_STRINGS(1, 0, 0, 0, 0), 0, (uint16_t)(sizeof(g_HtmlPageExistingImage) - 1), 0 },
+  { WEBPAGE_TIMER, PAGE_STRINGS(1, 0, 0, 0, 0), 0, (uint16_t)(sizeof(g_HtmlPageTimer) - 1), 0 },
+  { WEBPAGE_UPLOAD_COMPLETE, PAGE_STRINGS(1, 0, 0, 0, 0), 0, (uint16_t)(sizeof(g_HtmlPageUploadComplete) - 1), 0 },
+  // WEBPAGE_PARSEFAIL
+  //   %s02 I2C EEPROM status     1 x (40 - 4)  = 36
+  { WEBPAGE_PARSEFAIL, PAGE_STRINGS(1, 0, 0, 0, 0), 36, (uint16_t)(sizeof(g_HtmlPageParseFail) - 1), 0 },
+#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
+
+#if RUNTIME_UPLOAD == 1
+  { WEBPAGE_TIMER, PAGE_STRINGS(1, 0, 0, 0, 0), 0, (uint16_t)(sizeof(g_HtmlPageTimer) - 1), 0 },
+  // WEBPAGE_UPLOAD_STAGED
+  //   %s03 Image CRC             1 x (4 - 4)   = 0
+  { WEBPAGE_UPLOAD_STAGED, PAGE_STRINGS(1, 0, 0, 0, 0), 0, (uint16_t)(sizeof(g_HtmlPageUploadStaged) - 1), 0 },
+  // WEBPAGE_PARSEFAIL
+  //   %s02 I2C EEPROM status     1 x (40 - 4)  = 36
+  { WEBPAGE_PARSEFAIL, PAGE_STRINGS(1, 0, 0, 0, 0), 36, (uint16_t)(sizeof(g_HtmlPageParseFail) - 1), 0 },
+#endif // RUNTIME_UPLOAD == 1
+
+#if OB_EEPROM_SUPPORT == 1
+  // WEBPAGE_EEPROM_MISSING
+  { WEBPAGE_EEPROM_MISSING, PAGE_STRINGS(0, 0, 0, 0, 0), 0, (uint16_t)(sizeof(g_HtmlPageEEPROMMissing) - 1), 0 },
+#endif // OB_EEPROM_SUPPORT == 1
+};
+
+
 uint16_t adjust_template_size(struct tHttpD* pSocket)
 {
   uint16_t size;
-  // declare and pre-calculate repeatedly used values
-  int strlen_devicename_adjusted = (strlen(stored_devicename) - 4);
+  uint8_t strings;
+  const struct page_size* pEntry;
+  int i;
   
   // This function calculates the size of the HTML page that will be
   // transmitted based on the size of the web page template plus adjustments
   // needed to account for text strings that replace markers in the web page
   // template. The purpose of this methodology is to reduce the amount of
   // Flash consumed by the webpages, and it works well for that purpose.
-  // Unfortunately it also makes the HTML hard to read and maintain.
-  // 
-  // Note to self: This code is crap from the perspective of readability and
-  // being error prone. Walking through the web page templates to verify that
-  // this code properly adjusts the reported web page size is tedious,
-  // particularly when it comes to the #if inclusions/exclusions. Need to
-  // work on a better methodology.
   //
-  // Most of the size calculations end up being constants, so a lot of this
-  // function is comments explaining where the constants come from, then
-  // simply adding the result to the template size.
+  // The fixed adjustments for each page are summed in the page_size_table
+  // so the run time work is a table lookup, a few multiplies by the sizes
+  // of the ps[] strings and the Device Name, and the settings dependent
+  // adjustments below.
   
   size = 0;
 
+  pEntry = 0;
+  for (i = 0; i < (int)(sizeof(page_size_table) / sizeof(page_size_table[0])); i++) {
+    if (page_size_table[i].webpage == pSocket->current_webpage) {
+      pEntry = &page_size_table[i];
+      break;
+    }
+  }
+  if (pEntry == 0) return 0;
 
-  //-------------------------------------------------------------------------//
-  // A no-function check for current_webpage that allows the various options
-  // to compile as "else if" statements.
-  //-------------------------------------------------------------------------//
-  if (pSocket->current_webpage == WEBPAGE_NULL) { }
+  size = (uint16_t)(pEntry->size + pEntry->delta);
+  if (pEntry->pSize) size += *pEntry->pSize;
 
+  strings = pEntry->strings;
+  // Account for header replacement strings %y04 %y05
+  if (strings & 0x01) size += ps[4].size_less4 + ps[5].size_less4;
+  // Account for Device Name fields %a00. These can be variable in size
+  // during run time.
+  size += ((strings >> 1) & 0x03) * (int)(strlen(stored_devicename) - 4);
+  // Account for Text Replacement strings %y00, %y01 and %y02
+  if (strings & 0x08) size += ps[0].size_less4;
+  if (strings & 0x10) size += ps[1].size_less4;
+  size += (strings >> 5) * ps[2].size_less4;
 
 
   //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  // Adjust the size reported by the WEBPAGE_IOCONTROL template
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
+  // Settings dependent and user entered text adjustments
   //-------------------------------------------------------------------------//
 #if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-  else if (pSocket->current_webpage == WEBPAGE_IOCONTROL) {
-    size = HtmlPageIOControl_size;
-
-    // Account for header replacement strings %y04 %y05
-    size = size + ps[4].size_less4
-                + ps[5].size_less4;
-
-    // Account for Device Name field %a00 in <title> and in body.
-    // This can be variable in size during run time so code has to calculate
-    // it each time the webpage is displayed.
-    size = size + (2 * strlen_devicename_adjusted);
-
-    // Account for Config string %g00
-    // There is 1 instance
-    // value_size is 2 (2 characters)
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (#instances x (2 - 4));
-    // size = size + (1 x (-2));
-    size = size - 2;
-
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || HOME_ASSISTANT_SUPPORT == 1
-    // Account for pin control field %h00
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (#instances x (32 - 4));
-    // size = size + (1 x 28);
-    size = size + 28;
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || HOME_ASSISTANT_SUPPORT == 1
-
-#if DOMOTICZ_SUPPORT == 1
-    // Account for pin control field %h00
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (#instances x (48 - 4));
-    // size = size + (1 x 44);
-    size = size + 44;
-#endif // DOMOTICZ_SUPPORT == 1
-
+  if (pSocket->current_webpage == WEBPAGE_IOCONTROL) {
     // Account for Temperature Sensor insertion %t00 to %t04
     // Each of these insertions can have a different length due to the
     // text around them. If DS18B20 is NOT enabled code only needs to
     // subtract the size of the 5 placeholders.
-    //
     if (stored_config_settings & 0x08) {
       //  %t00 "<p>Temperature Sensors<br> xxxxxxxxxxxx "
       //      plus 13 bytes of data and degC characters (-000.0&#8451;)
       //      plus 14 bytes of data and degF characters ( -000.0&#8457;)
-      //    40 bytes of text plus 27 bytes of data = 67
-      //    size = size + 67 - 4
-      size = size + 63;
-
-// TRYING TO FIGURE OUT HOW TO GIVE A "HEADER" LOOK TO THE TEMPERATURE SENSORS
-// DISPLAY IN IOCONTROL
-//      //  %t00 "<p style='{height:32px;}'>Temperature Sensors</p><p><br> xxxxxxxxxxxx "
-//      //      plus 13 bytes of data and degC characters (-000.0&#8451;)
-//      //      plus 14 bytes of data and degF characters ( -000.0&#8457;)
-//      //    69 bytes of text plus 27 bytes of data = 96
-//      //    size = size + 96 - 4
-//      size = size + 92;
-      
-      //
-      //  %t01 "<br> xxxxxxxxxxxx " 
-      //      plus 13 bytes of data and degC characters (-000.0&#8451;)
-      //      plus 14 bytes of data and degF characters ( -000.0&#8457;)
-      //    18 bytes of text plus 27 bytes of data = 45
-      //    size = size + 45 - 4
-      size = size + 41;
-      //
-      //  %t02 "<br> xxxxxxxxxxxx "
-      //      plus 13 bytes of data and degC characters (-000.0&#8451;)
-      //      plus 14 bytes of data and degF characters ( -000.0&#8457;)
-      //    18 bytes of text plus 27 bytes of data = 45
-      //    size = size + 45 - 4
-      size = size + 41;
-      //
-      //  %t03 "<br> xxxxxxxxxxxx "
-      //      plus 13 bytes of data and degC characters (-000.0&#8451;)
-      //      plus 14 bytes of data and degF characters ( -000.0&#8457;)
-      //    18 bytes of text plus 27 bytes of data = 45
-      //    size = size + 45 - 4
-      size = size + 41;
-      //
-      //  %t04 "<br> xxxxxxxxxxxx "
-      //      plus 13 bytes of data and degC characters (-000.0&#8451;)
-      //      plus 14 bytes of data and degF characters ( -000.0&#8457;)
-      //      plus "<br></p>"
-      //    18 bytes of text plus 27 bytes of data = 45
-      //    plus 8 bytes of text = 53
-      //    size = size + 53 - 4
-      size = size + 49;
+      //    40 bytes of text plus 27 bytes of data = 67, less 4 = 63
+      //  %t01 to %t03 "<br> xxxxxxxxxxxx " plus the same 27 bytes of data
+      //    18 bytes of text plus 27 bytes of data = 45, less 4 = 41
+      //  %t04 as %t01 plus "<br></p>" = 53, less 4 = 49
+      size = size + 63 + (3 * 41) + 49;
     }
     else {
-      // Subtract the size of the placeholders as they won't be used
       // size = size - (5 x 4)
       size = size - 20;
     }
     
     // Account for BME280 Sensor insertion %t05
-    // If BME280 is NOT enabled code only needs to subtract the size of the
-    // placeholder.
-    //
     if (stored_config_settings & 0x20) {
       // Output string looks like:
       // <p>BME280 Sensor<br>BME280-0xxxx Temp -000.00C -000.00F<br>BME280-1xxxx Pressure 0000 hPa<br>BME280-2xxxx Humidity 000%<br>Altitude -00000 meters -00000 feet<p>
-      // 0        1         2         3         4         5         6         7         8         9         0         1         2         3         4         5         6         7
-      // 12345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890
-      // 160 characters      
-      // plus
-      //   degC character (&#8451;) adds 6 characters over the above
-      //   degF character (&#8457;) adds 6 characters over the above
-      // 160 + 12 = 172
-      // size = size + 172 - 4
+      // 160 characters plus 6 characters each for the degC (&#8451;) and
+      // degF (&#8457;) characters = 172, less 4 = 168
       size = size + 168;
     }
     else {
-      // Subtract the size of the placeholder as it won't be used
-      // size = size - (1 x 4)
       size = size - 4;
     }
-    
-    // Account for Text Replacement insertion
-    // Some strings appear frequently in the templates - things like the
-    // button titles which appear when hovering over a button. These strings
-    // are inserted on the fly when the web page is sent to the browser, so
-    // they have to be accounted for in the size of the web page.
-    
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || HOME_ASSISTANT_SUPPORT == 1
-    // String for %y01 in web page template
-    // There is 1 instance for the Save and Undo All buttons
-    // size = size + (#instances) x (ps[1].size - marker_field_size);
-    // size = size + ps[1].size_less4;
-    size = size + ps[1].size_less4;
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || HOME_ASSISTANT_SUPPORT == 1
+  }
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
 
+  // Account for IO Name fields %j00 to %j15 (Domoticz builds) or %k00 to
+  // %k15 (Browser Only builds). The %kxx fields add a length character.
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
+  if (pSocket->current_webpage == WEBPAGE_IOCONTROL
+   || pSocket->current_webpage == WEBPAGE_CONFIGURATION) {
+    for (i=0; i<16; i++) {
+      size = size + (strlen(IO_NAME[i]) - 3);
+    }
+  }
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
 #if DOMOTICZ_SUPPORT == 1
-    // String for %y00 in web page template
-    // There is 1 instance for the Save and Undo All buttons
-    // size = size + (#instances) x (ps[1].size - marker_field_size);
-    // size = size + ps[0].size_less4;
-    size = size + ps[0].size_less4;
-#endif // DOMOTICZ_SUPPORT == 1
-
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || HOME_ASSISTANT_SUPPORT == 1
-    // String for %y02 in web page template
-    // There 3 instances:
-    //   Refresh button
-    //   Configuration button
-    //   PCF8574 IOControl button
-    // size = size + (#instances) x (ps[2].size - marker_field_size);
-    // size = size + (3 x ps[2].size_less4);
-    size = size + (3 * ps[2].size_less4);
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || HOME_ASSISTANT_SUPPORT == 1
-
-#if DOMOTICZ_SUPPORT == 1
-    // String for %y02 in web page template
-    // There 2 instances:
-    //   Refresh button
-    //   Configuration button
-    // size = size + (#instances) x (ps[2].size - marker_field_size);
-    // size = size + (3 x ps[2].size_less4);
-    size = size + (2 * ps[2].size_less4);
-#endif // DOMOTICZ_SUPPORT == 1
-
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
-    // Account for IO Name fields %j00 to %j15
-    // This can be variable in size during run time so code has to calculate
-    // them each time a web page is displayed.
-    {
-      int i;
-      for (i=0; i<16; i++) {
-        size = size + (strlen(IO_NAME[i]) - 4);
-      }
-    }
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
-
-    // The TIMER fields have no size change impact as the value displayed is
-    // equal in size to the placeholder.
-  }
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-
-
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  // Adjust the size reported by the WEBPAGE_PCF8574_IOCONTROL template
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-#if DOMOTICZ_SUPPORT == 0
-#if PCF8574_SUPPORT == 1
-  else if (pSocket->current_webpage == WEBPAGE_PCF8574_IOCONTROL) {
-    size = HtmlPagePCFIOControl_size;
-
-    // Account for header replacement strings %y04 %y05
-    size = size + ps[4].size_less4
-                + ps[5].size_less4;
-
-    // Account for Device Name field %A00 in <title> and in body
-    // This can be variable in size during run time so code has to calculate
-    // it each time a web page is displayed.
-    size = size + (2 * strlen_devicename_adjusted);
-
-    // Account for Config string %g00
-    // There is 1 instance
-    // value_size is 2 (2 characters)
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (#instances x (2 - 4));
-    // size = size + (1 x (-2));
-    size = size - 2;
-
-    // Account for pin control field %H00
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (#instances x (16 - 4));
-    // size = size + (1 x 12);
-    size = size + 12;
- 
-    // Account for Text Replacement insertion
-    // Some strings appear frequently in the templates - things like the
-    // button titles which appear when hovering over a button. These strings
-    // are inserted on the fly when the web page is sent to the browser, so
-    // they have to be accounted for in the size of the web page.
-    
-    // String for %y01 in web page template
-    // There 1 instance (Save and Undo All buttons)
-    // size = size + (#instances) x (ps[1].size - marker_field_size);
-    // size = size + ps[1].size_less4;
-    size = size + ps[1].size_less4;
-
-    // String for %y02 in web page template
-    // There 4 instances
-    //   Refresh button
-    //   Configuration PCF8574 button
-    //   Configuration button
-    //   IO Control button
-    // size = size + (#instances) x (ps[2].size - marker_field_size);
-    // size = size + (4 x ps[2].size_less4);
-    size = size + (4 * ps[2].size_less4);
-
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
-    // Account for IO Name fields %J16 to %J23
-    // This can be variable in size during run time so code has to calculate
-    // them each time the web page is displayed.
-    // For the PCF8574 these names are stored in I2C EEPROM and must be read
-    // from there to determine their size.
-    {
-      int i;
-      int j;
-      char temp_string[16];
-      for (i=16; i<24; i++) {
-        // Read a PCF8574_IO_NAMES value from I2C EEPROM
-        copy_I2C_EEPROM_bytes_to_RAM(&temp_string[0], 16, I2C_EEPROM_R2_WRITE, I2C_EEPROM_R2_READ, PCF8574_I2C_EEPROM_R2_START_IO_NAMES, 2);
-        size = size + (strlen(temp_string) - 4);
-      }
+  if (pSocket->current_webpage == WEBPAGE_CONFIGURATION) {
+    for (i=0; i<16; i++) {
+      size = size + (strlen(IO_NAME[i]) - 4);
     }
-    // Account for IO Timer field %I16 to %I23
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (#instances x (4 - 4));
-    // size = size + (8 x 0);
-    // size = size + 0;
-    // The Timer fields have no size change impact    
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
   }
-#endif // PCF8574_SUPPORT == 1
-#endif // DOMOTICZ_SUPPORT == 0
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-
-
-
-
-
-
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  // Adjust the size reported by the WEBPAGE_CONFIGURATION template
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-  else if (pSocket->current_webpage == WEBPAGE_CONFIGURATION) {
-    size = HtmlPageConfiguration_size;
-
-    // Account for header replacement strings %y04 %y05
-    size = size + ps[4].size_less4
-                + ps[5].size_less4;
-
-    // Account for Device Name field %a00 in <title> and in body
-    // This can be variable in size during run time so code has to calculate
-    // it each time the web page is displayed.
-    size = size + (2 * strlen_devicename_adjusted);
-
-    // Account for HTML IP Address, Gateway Address, and
-    // Netmask fields %b00, %b04, %b08
-    // There are 3 instances of these fields
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (3 x (8 - 4));
-    // size = size + (3 x (4));
-    size = size + 12;
-
-    // Account for HTML Port field %c00
-    // There is 1 instance
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (1 x (5 - 4));
-    // size = size + (1 x (1));
-    // size = size + 1;
-    size = size + 1;
-
-    // Account for MAC field %d00
-    // There is 1 instance of this field
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (1 x (12 - 4));
-    // size = size + (1 x (8));
-    size = size + 8;
-
-    // Account for Config string %g00
-    // There is 1 instance
-    // value_size is 2 (2 characters)
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (#instances x (2 - 4));
-    // size = size + (1 x (-2));
-    size = size - 2;
-
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || HOME_ASSISTANT_SUPPORT == 1
-    // Account for pin control field %h00
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (#instances x (32 - 4));
-    // size = size + (1 x 28);
-    size = size + 28;
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || HOME_ASSISTANT_SUPPORT == 1
-
-#if DOMOTICZ_SUPPORT == 1
-    // Account for pin control field %h00
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (#instances x (48 - 4));
-    // size = size + (1 x 44);
-    size = size + 44;
-#endif // DOMOTICZ_SUPPORT == 1
-
-    // Account for Code Revision + Code Type insertion %w00
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (#instances x (36 - 4));
-    // size = size + (1 x 32);
-    size = size + 32;
-    
-    // Account for Pinout Option field %w01
-    // Looks like "Pinout Option 1" but only the digit is inserted
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (#instances x (1 - 4));
-    // size = size + (1 x -3);
-    size = size - 3;
-
-    // Account for PCF8574 Presence indicator %w02
-    // Looks like "PCF8574 0" or "PCF8574 1" but only the digit is inserted
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (#instances x (1 - 4));
-    // size = size + (1 x -3);
-    size = size - 3;
-
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || HOME_ASSISTANT_SUPPORT == 1
-    // Account for Text Replacement insertion
-    // Some strings appear frequently in the templates - things like the
-    // button titles which appear when hovering over a button. These strings
-    // are inserted on the fly when the web page is sent to the browser, so
-    // they have to be accounted for in the size of the web page.
-    
-    // String for %y01 in web page template
-    // There is 1 instance for the Save and Undo All buttons
-    // size = size + (#instances) x (ps[1].size - marker_field_size);
-    // size = size + ps[1].size_less4;
-    size = size + ps[1].size_less4;
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || HOME_ASSISTANT_SUPPORT == 1
-
-#if DOMOTICZ_SUPPORT == 1
-    // Account for Text Replacement insertion
-    // Some strings appear frequently in the templates - things like the
-    // button titles which appear when hovering over a button. These strings
-    // are inserted on the fly when the web page is sent to the browser, so
-    // they have to be accounted for in the size of the web page.
-    
-    // String for %y00 in web page template
-    // There is 1 instance for the Save and Undo All buttons
-    // size = size + (#instances) x (ps[1].size - marker_field_size);
-    // size = size + ps[1].size_less4;
-    size = size + ps[0].size_less4;
 #endif // DOMOTICZ_SUPPORT == 1
 
+  // Account for IO Name fields %K16 to %K23 (Browser Only builds, with a
+  // length character) or %j16 to %j23 (repurposed as IDX fields in Domoticz
+  // builds). For the PCF8574 these names are stored in I2C EEPROM and must
+  // be read from there to determine their size.
+#if PCF8574_SUPPORT == 1
 #if BUILD_SUPPORT == BROWSER_ONLY_BUILD
-    // String for %y02 in web page templates
-    // There are 4 instances:
-    //   Reboot button
-    //   Refresh button
-    //   IOControl button
-    //   PCF8574 Configuration button
-    //   Login Configuration button
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (#instances) x (ps[2].size - 4);
-    // size = size + (5) x ps[2].size_less4;
-    size = size + (5 * ps[2].size_less4);
+  if (pSocket->current_webpage == WEBPAGE_PCF8574_IOCONTROL
+   || pSocket->current_webpage == WEBPAGE_PCF8574_CONFIGURATION) {
 #endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
-
-#if HOME_ASSISTANT_SUPPORT == 1
-    // String for %y02 in web page templates
-    // There are 4 instances:
-    //   Reboot button
-    //   Refresh button
-    //   IOControl button
-    //   PCF8574 Configuration button
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (#instances) x (ps[2].size - 4);
-    // size = size + (4) x ps[2].size_less4;
-    size = size + (4 * ps[2].size_less4);
-#endif // HOME_ASSISTANT_SUPPORT == 1
-    
 #if DOMOTICZ_SUPPORT == 1
-    // String for %y02 in web page templates
-    // There are 3 instances:
-    //   Reboot button
-    //   Refresh button
-    //   IOControl button
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (#instances) x (ps[2].size - 4);
-    // size = size + (4) x ps[2].size_less4;
-    size = size + (3 * ps[2].size_less4);
+  if (pSocket->current_webpage == WEBPAGE_CONFIGURATION) {
 #endif // DOMOTICZ_SUPPORT == 1
-
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
-    // Account for IO Timer field %i00 to %i15
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (#instances x (4 - 4));
-    // size = size + (16 x 0);
-    // size = size + 0;
-    // The Timer fields have no size change impact
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
-
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
-    // Account for IO Name fields %j00 to %j15
-    // This can be variable in size during run time so code has to calculate
-    // them  each time the web page is displayed.
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || DOMOTICZ_SUPPORT == 1
     {
-      int i;
-      for (i=0; i<16; i++) {
-        size = size + (strlen(IO_NAME[i]) - 4);
-      }
-    }
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
-
-#if DOMOTICZ_SUPPORT == 1
-    // Account for IO Name fields %j00 to %j15
-    // This can be variable in size during run time so code has to calculate
-    // them  each time the web page is displayed.
-    {
-      int i;
-      for (i=0; i<16; i++) {
-        size = size + (strlen(IO_NAME[i]) - 4);
-      }
-    }
-
-#if PCF8574_SUPPORT == 1
-    // Account for IO Name fields %j16 to %j23 (repurposed as IDX fields).
-    // This can be variable in size during run time so code has to calculate
-    // them  each time the web page is displayed.
-    // For the PCF8574 these names are stored in I2C EEPROM and must be read
-    // from there to determine their size.
-    {
-      int i;
-      int j;
       char temp_string[16];
       for (i=16; i<24; i++) {
         // Read a PCF8574_IO_NAMES value from I2C EEPROM
-        copy_I2C_EEPROM_bytes_to_RAM(&temp_string[0], 16, I2C_EEPROM_R2_WRITE, I2C_EEPROM_R2_READ, PCF8574_I2C_EEPROM_R2_START_IO_NAMES, 2);
+        copy_I2C_EEPROM_bytes_to_RAM(&temp_string[0], 16, I2C_EEPROM_R2_WRITE, I2C_EEPROM_R2_READ, PCF8574_I2C_EEPROM_R2_START_IO_NAMES + ((i - 16) * 16), 2);
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
+        size = size + (strlen(temp_string) - 3);
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
+#if DOMOTICZ_SUPPORT == 1
         size = size + (strlen(temp_string) - 4);
+#endif // DOMOTICZ_SUPPORT == 1
       }
     }
+  }
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || DOMOTICZ_SUPPORT == 1
 #endif // PCF8574_SUPPORT == 1
 
-#if PCF8574_SUPPORT == 0
-    // Account for IO Name fields %j16 to %j23
-    // If PCF8574 is not supported the Configuration page will still display
-    // the IDX configuration fields, however they will all contain "0".
-    // There are 8 instances
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (8) x (1 - 4);
-    // size = size + (8) x (-3);
-    // size = size - 24
-    size = size - 24;
-#endif // PCF8574_SUPPORT == 0
-#endif // DOMOTICZ_SUPPORT == 1
-
-#if DOMOTICZ_SUPPORT == 1
-    // Account for Sensor Name fields %T00 to %T05
-    // These fields are displayed even if no sensors are present.
-    // There are 6 instances, each 12 characters in size.
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (6) x (12 - 4);
-    // size = size + (6) x (8);
-    // size = 48
-    size += 48;
-#endif // DOMOTICZ_SUPPORT == 1
-
 #if DOMOTICZ_SUPPORT == 1
+  if (pSocket->current_webpage == WEBPAGE_CONFIGURATION) {
     // Account for Sensor IDX fields %T20 to %T25
-    // These fields are displayed even if no sensors are present.
-    // There are 6 instances.
-    // This can be variable in size during run time so code has to calculate
-    // them  each time the web page is displayed.
-    {
-      int i;
-      for (i=0; i<6; i++) {
-        size = size + (strlen(Sensor_IDX[i]) - 4);
-      }
+    for (i=0; i<6; i++) {
+      size = size + (strlen(Sensor_IDX[i]) - 4);
     }
+  }
 #endif // DOMOTICZ_SUPPORT == 1
  
 #if BUILD_SUPPORT == MQTT_BUILD
-    // Account for MQTT IP Address field %b12
-    // There is 1 instance
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (1 x (8 - 4));
-    // size = size + (1 x (4));
-    size = size + 4;
-    
-    // Account for MQTT Port field %c01
-    // There is 1 instance
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (1 x (5 - 4));
-    // size = size + (1 x (1));
-    // size = size + 1;
-    size = size + 1;
-
-    // Account for Username field %l00
-    // This can be variable in size during run time so code has to calculate
-    // them  each time the web page is displayed.
+  if (pSocket->current_webpage == WEBPAGE_CONFIGURATION) {
+    // Account for Username field %l00 and Password field %m00
     size = size + (strlen(stored_mqtt_username) - 4);
-
-    // Account for Password field %m00
-    // This can be variable in size during run time so code has to calculate
-    // them  each time the web page is displayed.
     size = size + (strlen(stored_mqtt_password) - 4);
-    
-    // Account for red/green State Progress boxes %n00, %n01, %n02, %n03, %n04 
-    // There are always 5 boxes, one for each State progress indicator
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (#instances x (1 - 4));
-    // size = size + (5 x (-3));
-    size = size - 15;
-#endif // BUILD_SUPPORT == MQTT_BUILD
   }
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-
-
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  // Adjust the size reported by the WEBPAGE_PCF8574_CONFIGURATION template
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || HOME_ASSISTANT_SUPPORT == 1
-#if PCF8574_SUPPORT == 1
-  else if (pSocket->current_webpage == WEBPAGE_PCF8574_CONFIGURATION) {
-    size = HtmlPagePCFConfiguration_size;
-
-    // Account for header replacement strings %y04 %y05
-    size = size + ps[4].size_less4
-                + ps[5].size_less4;
-
-    // Account for Device Name field %A00 in <title> and in body
-    // This can be variable in size during run time so code has to calculate
-    // them  each time the web page is displayed.
-    size = size + (2 * strlen_devicename_adjusted);
-
-    // Account for Config string %g00
-    // There is 1 instance
-    // value_size is 2 (2 characters)
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (#instances x (2 - 4));
-    // size = size + (1 x (-2));
-    size = size - 2;
-
-    // Account for pin control field %H00
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (#instances x (16 - 4));
-    // size = size + (1 x 12);
-    size = size + 12;
-
-    // Account for Text Replacement insertion
-    // Some strings appear frequently in the templates - things like the
-    // button titles which appear when hovering over a button. These strings
-    // are inserted on the fly when the web page is sent to the browser, so
-    // they have to be accounted for in the size of the web page.
-    
-    // String for %y01 in web page template
-    // There 1 instance (Save and Undo All buttons)
-    // size = size + (#instances) x (ps[1].size - marker_field_size);
-    // size = size + ps[1].size_less4;
-    size = size + ps[1].size_less4;
-
-    // String for %y02 in web page templates
-    // There are 5 instances:
-    //   Reboot button
-    //   Refresh button
-    //   PCF8574 IO Control button
-    //   Configuration button
-    //   IO Control button
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (#instances) x (ps[2].size - 4);
-    // size = size + (5) x ps[2].size_less4;
-    size = size + (5 * ps[2].size_less4);
-    
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
-    // Account for IO Name fields %J16 to %J23
-    // This can be variable in size during run time so code has to calculate
-    // them  each time the web page is displayed.
-    // For the PCF8574 these names are stored in I2C EEPROM and must be read
-    // from there to determine their size.
-    // Note: Domoticz support re-uses the "%Jxx" values to store IDX values
-    // unique to Domoticz.
-    {
-      int i;
-      char temp_string[16];
-      for (i=16; i<24; i++) {
-        // Read a PCF8574_IO_NAMES value from I2C EEPROM
-        copy_I2C_EEPROM_bytes_to_RAM(&temp_string[0], 16, I2C_EEPROM_R2_WRITE, I2C_EEPROM_R2_READ, PCF8574_I2C_EEPROM_R2_START_IO_NAMES, 2);
-        size = size + (strlen(temp_string) - 4);
-      }
-    }
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
-
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
-    // Account for IO Timer field %I16 to %I23
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (#instances x (4 - 4));
-    // size = size + (8 x 0);
-    // size = size + 0;
-    // The Timer fields have no size change impact
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
-
-#if DEBUG_SUPPORT == 15
-// UARTPrintf("Adjusted size of WEBPAGE_PCF8574_CONFIGURATION = ");
-// emb_itoa(size, OctetArray, 16, 4);
-// UARTPrintf(OctetArray);
-// UARTPrintf("\r\n");
-#endif // DEBUG_SUPPORT == 15
-
-  }
-#endif // PCF8574_SUPPORT == 1
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || HOME_ASSISTANT_SUPPORT == 1
-
-
-
-
-
+#endif // BUILD_SUPPORT == MQTT_BUILD
 
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  // Adjust the size reported by the WEBPAGE_SHORT_TEMPERATURE template
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
 #if BUILD_SUPPORT == BROWSER_ONLY_BUILD && SHORT_TEMPERATURE_SUPPORT == 1
-  else if (pSocket->current_webpage == WEBPAGE_SHORT_TEMPERATURE) {
-    size = (uint16_t)(sizeof(g_HtmlPageShortTemperature) -1);
+  if (pSocket->current_webpage == WEBPAGE_SHORT_TEMPERATURE) {
     // Account for Temperature Sensor insertion %t00 to %t04
-    // If DS18B20 is NOT enabled code only needs to subtract the size of the
-    // 5 placeholders.
-    //
     if (stored_config_settings & 0x08) {
-      //  %t00 "xxxxxxxxxxxx"
-      //      plus 7 bytes of data (,-000.0)
-      //      plus 7 bytes of data (,-000.0)
-      //    12 bytes of text plus 14 bytes of data = 26
-      //    size = size + 26 - 4
-      size = size + 22;
-      //
-      //  %t01 ",xxxxxxxxxxxx"
-      //      plus 7 bytes of data (,-000.0)
-      //      plus 7 bytes of data (,-000.0)
-      //    13 bytes of text plus 14 bytes of data = 27
-      //    size = size + 27 - 4
-      size = size + 23;
-      //
-      //  %t02 ",xxxxxxxxxxxx"
-      //      plus 7 bytes of data (,-000.0)
-      //      plus 7 bytes of data (,-000.0)
-      //    13 bytes of text plus 14 bytes of data = 27
-      //    size = size + 27 - 4
-      size = size + 23;
-      //
-      //  %t03 ",xxxxxxxxxxxx"
-      //      plus 7 bytes of data (,-000.0)
-      //      plus 7 bytes of data (,-000.0)
-      //    13 bytes of text plus 14 bytes of data = 27
-      //    size = size + 27 - 4
-      size = size + 23;
-      //
-      //  %t04 ",xxxxxxxxxxxx"
-      //      plus 7 bytes of data (,-000.0)
-      //      plus 7 bytes of data (,-000.0)
-      //    13 bytes of text plus 14 bytes of data = 27
-      //    size = size + 27 - 4
-      size = size + 23;
+      //  %t00 "xxxxxxxxxxxx" plus 14 bytes of data (,-000.0,-000.0)
+      //    12 bytes of text plus 14 bytes of data = 26, less 4 = 22
+      //  %t01 to %t04 ",xxxxxxxxxxxx" plus 14 bytes of data
+      //    13 bytes of text plus 14 bytes of data = 27, less 4 = 23
+      size = size + 22 + (4 * 23);
     }
     else {
-      // Subtract the size of the placeholders as they won't be used
-      // size = size - (5 x 4)
       size = size - 20;
     }
   }
 #endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD && SHORT_TEMPERATURE_SUPPORT == 1
 
-
-
-
-
-
-
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  // Adjust the size reported by the WEBPAGE_LOGIN template
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
 #if LOGIN_SUPPORT == 1
-  else if (pSocket->current_webpage == WEBPAGE_LOGIN) {
-//    size = (uint16_t)(sizeof(g_HtmlPageLogin) - 1);
-    size = HtmlPageLogin_size;
-
-    // Account for header replacement strings %y04 %y05
-    size = size + ps[4].size_less4
-                + ps[5].size_less4;
-
-    // Account for Passphrase field %l02
-    // This field is always empty when sent to the Browser so the placeholder
-    // has no effect on size.
-  }
-#endif // LOGIN_SUPPORT == 1
-
-
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  // Adjust the size reported by the WEBPAGE_SET_PASSPHRASE template
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-#if LOGIN_SUPPORT == 1
-  else if (pSocket->current_webpage == WEBPAGE_SET_PASSPHRASE) {
-//    size = (uint16_t)(sizeof(g_HtmlPageSetPassphrase) - 1);
-    size = HtmlPageSetPassphrase_size;
-
-    // Account for header replacement strings %y04 %y05
-    size = size + ps[4].size_less4
-                + ps[5].size_less4;
-
+  if (pSocket->current_webpage == WEBPAGE_SET_PASSPHRASE) {
     // Account for Passphrase field %l01
-    // This can be variable in size during run time so code has to calculate
-    // them  each time the web page is displayed.
     // The Passphrase is stored in I2C EEPROM and must be read from there to
     // determine the size.
-    {
-      int i;
-      char temp_string[16];
-      // Read the Passphrase I2C EEPROM
-      copy_I2C_EEPROM_bytes_to_RAM(&temp_string[0], 16, I2C_EEPROM_R1_WRITE, I2C_EEPROM_R1_READ, I2C_EEPROM_R1_LOGIN_PASSPHRASE, 2);
-      size = size + (strlen(temp_string) - 4);
-    }
+    char temp_string[16];
+    copy_I2C_EEPROM_bytes_to_RAM(&temp_string[0], 16, I2C_EEPROM_R1_WRITE, I2C_EEPROM_R1_READ, I2C_EEPROM_R1_LOGIN_PASSPHRASE, 2);
+    size = size + (strlen(temp_string) - 4);
   }
 #endif // LOGIN_SUPPORT == 1
 
-
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  // Adjust the size reported by the WEBPAGE_STATS1 template (Network
-  // Statistics)
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-#if NETWORK_STATISTICS == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
-  else if (pSocket->current_webpage == WEBPAGE_STATS1) {
-    size = (uint16_t)(sizeof(g_HtmlPageStats1) - 1);
-
-    // Account for header replacement strings %y04 %y05
-    size = size + ps[4].size_less4
-                + ps[5].size_less4;
-
-    // Account for Device Name field %a00 in <title>
-    // This can be variable in size during run time so code has to calculate
-    // them  each time the web page is displayed.
-    size = size + strlen_devicename_adjusted;
-    
-    // Account for Statistics fields %e00 to %e21
-    // There are 22 instances of these fields
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (22 x (10 - 4));
-    // size = size + (22 x (6));
-    size = size + 132;
-  }
-#endif // NETWORK_STATISTICS == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
-
-
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  // Adjust the size reported by the WEBPAGE_STATS2 template (Link Error
-  // Statistics)
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-#if LINK_STATISTICS == 1
-  else if (pSocket->current_webpage == WEBPAGE_STATS2) {
-    size = (uint16_t)(sizeof(g_HtmlPageStats2) - 1);
-    // Account for Statistics fields %e31, %e32, %e33, %e34, %e35
-    // There are 5 instances of these fields
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (5 x (10 - 4));
-    // size = size + (5 x (6));
-    size = size + 30;
-  }
-#endif // LINK_STATISTICS == 1
-
-
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  // Adjust the size reported by the WEBPAGE_RF_ATTEN template (special RF
-  // Attenuator page)
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-#if RF_ATTEN_SUPPORT == 1
-  else if (pSocket->current_webpage == WEBPAGE_RF_ATTEN) {
-    size = (uint16_t)(sizeof(g_HtmlPageRFAtten) - 1);
-
-    // Account for header replacement strings %y04 %y05
-    size = size + ps[4].size_less4
-                + ps[5].size_less4;
-
-    // Account for Device Name field %a00
-    // This can be variable in size during run time so code has to calculate
-    // them  each time the web page is displayed.
-    size = size + strlen_devicename_adjusted;
-
-    // Account for Current Decibel setting string %f01
-    // There is 1 instance of this field
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (1 x (2 - 4));
-    // size = size + (1 x -2);
-    size = size - 2;
-
-    // Account for button strings %y06
-    // There are 32 instances of these fields
-    // <button onclick='location=`/51003f00     (36 bytes)
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (32 x (36 - 4));
-    // size = size + (32 x (32));
-    size = size + 1024;
-
-    // Account for button strings %y07
-    // There are 32 instances of these fields
-    // </button>&emsp;&ensp;      (21 bytes)
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (32 x (21 - 4));
-    // size = size + (32 x (17));
-    size = size + 544;
-  }
-#endif // RF_ATTEN_SUPPORT == 1
-
-
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  // Adjust the size reported by the WEBPAGE_SDR_POWER_RELAY template (special
-  // SDR Power Relay page)
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
 #if SDR_POWER_RELAY_SUPPORT == 1
-  else if (pSocket->current_webpage == WEBPAGE_SDR_POWER_RELAY) {
-    size = (uint16_t)(sizeof(g_HtmlPageSDRPowerRelay) - 1);
-
-    // Account for header replacement strings %y04 %y05
-    size = size + ps[4].size_less4
-                + ps[5].size_less4;
-
-    // Account for Device Name field %a00
-    // This can be variable in size during run time so code has to calculate
-    // them  each time the web page is displayed.
-    size = size + strlen_devicename_adjusted;
-
-    // Account for Green / Red relay status field %n10 to %n17
-    // There are 8 instances of this field
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (8 x (3 - 4));
-    // size = size + (8 x -1);
-    size = size - 8;
-    
-    // Account for IO Name fields %j00, %j02, %j04, %j06, %j08, %j10, %j12, %j14
-    // This can be variable in size during run time so code has to calculate
-    // them  each time the web page is displayed.
-    {
-      int i;
-      for (i=0; i<16; i += 2) {
-        size = size + (strlen(IO_NAME[i]) - 4);
-      }
+  if (pSocket->current_webpage == WEBPAGE_SDR_POWER_RELAY) {
+    // Account for IO Name fields %j00, %j02, %j04, %j06, %j08, %j10, %j12,
+    // %j14
+    for (i=0; i<16; i += 2) {
+      size = size + (strlen(IO_NAME[i]) - 4);
     }
   }
 #endif // SDR_POWER_RELAY_SUPPORT == 1
 
-
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  // Adjust the size reported by the WEBPAGE_INA226 template (special Current,
-  // Voltage, Wattage page)
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-#if INA226_SUPPORT == 1
-  else if (pSocket->current_webpage == WEBPAGE_INA226) {
-    size = (uint16_t)(sizeof(g_HtmlPageINA226) - 1);
-
-    // Account for Device Name field %a00
-    // This can be variable in size during run time so code has to calculate
-    // them  each time the web page is displayed.
-    size = size + strlen_devicename_adjusted;
-
-    // Account for header replacement strings %y04 %y05
-    size = size + ps[4].size_less4
-                + ps[5].size_less4;
-
-    // Account for Current, Voltage, Wattage string %t06
-    // There are 5 instances of this field
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (5 x (63 - 4));
-    // size = size + (5 x 59);
-    size = size + 295;
-  }
-#endif // INA226_SUPPORT == 1
-
-
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  // Adjust the size reported by the DEBUG_SENSOR_SERIAL template
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-#if DEBUG_SENSOR_SERIAL == 1
-  else if (pSocket->current_webpage == WEBPAGE_SENSOR_SERIAL) {
-    size = (uint16_t)(sizeof(g_HtmlPageTmpSerialNum) - 1);
-
-    // Account for header replacement strings %y04 %y05
-    size = size + ps[4].size_less4
-                + ps[5].size_less4;
-
-    // Account for Device Name field %a00 in <title>
-    // This can be variable in size during run time so code has to calculate
-    // them  each time the web page is displayed.
-    size = size + strlen_devicename_adjusted;
-  }
-#endif // DEBUG_SENSOR_SERIAL
-
-
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  // Adjust the size reported by the WEBPAGE_SSTATE template
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
 #if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-  else if (pSocket->current_webpage == WEBPAGE_SSTATE) {
-    size = (uint16_t)(sizeof(g_HtmlPageSstate) - 1);
-
-#if PCF8574_SUPPORT == 0
-    // Account for Short Form IO Settings field (%f00)
-    // size = size + (value size - marker_field_size)
-    // size = size + (16 - 4);
-    size = size + 12;
-#endif // PCF8574_SUPPORT == 0
-
 #if PCF8574_SUPPORT == 1
-    // Account for Short Form IO Settings field (%f00)
+  if (pSocket->current_webpage == WEBPAGE_SSTATE) {
     // Even though PCF8574 support may be enabled there may not be a device
-    // physically present. Return 16 pins if no PCF8574, otherwise return
-    // 24 pins.
-    // If PCF8574 is present
-    // size = size + (value size - marker_field_size)
-    // size = size + (24 - 4);
-    // If PCF8574 is NOT present
-    // size = size + (value size - marker_field_size)
-    // size = size + (16 - 4);
-    if (stored_options1 & 0x08) {
-      size = size + 20;
-    }
-    else {
-      size = size + 12;
-    }
-#endif // PCF8574_SUPPORT == 1
-  }
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-
-
-#if OB_EEPROM_SUPPORT == 1
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  // Adjust the size reported by the WEBPAGE_LOADUPLOADER template
-  // This template is always stored in I2C EEPROM
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  else if (pSocket->current_webpage == WEBPAGE_LOADUPLOADER) {
-    size = HtmlPageLoadUploader_size;
-    
-    // Account for header replacement strings %y04 %y05
-    size = size + ps[4].size_less4
-                + ps[5].size_less4;
-  }
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-#endif // OB_EEPROM_SUPPORT == 1
-
-
-#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  // Adjust the size reported by the WEBPAGE_UPLOADER template
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  else if (pSocket->current_webpage == WEBPAGE_UPLOADER) {
-    size = (uint16_t)(sizeof(g_HtmlPageUploader) - 1);
-    
-    // Account for header replacement strings %y04 %y05
-    size = size + ps[4].size_less4
-                + ps[5].size_less4;
-    
-    // Account for Code Revision + Code Type insertion %w00
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (#instances x (36 - 4));
-    // size = size + (1 x 32);
-    size = size + 32;
-  }
-
-
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  // Adjust the size reported by the WEBPAGE_EXISTING_IMAGE template
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  else if (pSocket->current_webpage == WEBPAGE_EXISTING_IMAGE) {
-    size = (uint16_t)(sizeof(g_HtmlPageExistingImage) - 1);
-    
-    // Account for header replacement strings %y04 %y05
-    size = size + ps[4].size_less4
-                + ps[5].size_less4;
-  }
-
-
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  // Adjust the size reported by the WEBPAGE_TIMER template
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  else if (pSocket->current_webpage == WEBPAGE_TIMER) {
-    size = (uint16_t)(sizeof(g_HtmlPageTimer) - 1);
-    
-    // Account for header replacement strings %y04 %y05
-    size = size + ps[4].size_less4
-                + ps[5].size_less4;
-  }
-
-
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  // Adjust the size reported by the WEBPAGE_UPLOAD_COMPLETE template
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  else if (pSocket->current_webpage == WEBPAGE_UPLOAD_COMPLETE) {
-    size = (uint16_t)(sizeof(g_HtmlPageUploadComplete) - 1);
-    
-    // Account for header replacement strings %y04 %y05
-    size = size + ps[4].size_less4
-                + ps[5].size_less4;
-  }
-
-
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  // Adjust the size reported by the WEBPAGE_PARSEFAIL template
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  else if (pSocket->current_webpage == WEBPAGE_PARSEFAIL) {
-    size = (uint16_t)(sizeof(g_HtmlPageParseFail) - 1);
-    
-    // Account for header replacement strings %y04 %y05
-    size = size + ps[4].size_less4
-                + ps[5].size_less4;
-    
-    // Account for I2C EEPROM status string %s02
-    // size = size + (value size - marker_field_size)
-    // size = size + (40 - 4);
-    size = size + 36;
+    // physically present. The Short Form IO Settings field (%f00) returns
+    // 24 pins if a PCF8574 is present.
+    if (stored_options1 & 0x08) {
+      size = size + 8;
+    }
   }
+#endif // PCF8574_SUPPORT == 1
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
 
-#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
-
-
-#if OB_EEPROM_SUPPORT == 1
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  // Adjust the size reported by the WEBPAGE_EEPROM_MISSING template
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  //-------------------------------------------------------------------------//
-  else if (pSocket->current_webpage == WEBPAGE_EEPROM_MISSING) {
-    size = (uint16_t)(sizeof(g_HtmlPageEEPROMMissing) - 1);
+#if HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0
+  {
+    // The page script (%S0x up to and including %S99) is replaced by the
+    // link to the script resource and the call of the script.
+    uint8_t nScript;
+    nScript = page_script(pSocket->current_webpage);
+    if (nScript != 0xff) {
+      size = (uint16_t)(size + SCRIPT_LINK_SIZE - (script_size(nScript) + 4));
+    }
   }
-#endif // OB_EEPROM_SUPPORT == 1
+#endif // HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0
 
   return size;
 }
+#endif // HTTPD_CHUNKED_TRANSFER == 0
 
 
 void emb_itoa(uint32_t num, char* str, uint8_t base, uint8_t pad)
@@ -6152,7 +5956,7 @@ uint8_t int2nibble(uint8_t j)
 }
 
 
-static uint16_t CopyHttpHeader(uint8_t* pBuffer, uint16_t nDataLen, uint8_t header_type)
+static uint16_t CopyHttpHeader(uint8_t* pBuffer, struct tHttpD* pSocket, uint16_t nDataLen, uint8_t header_type)
 {
   uint16_t nBytes;
   int i;
@@ -6161,16 +5965,30 @@ static uint16_t CopyHttpHeader(uint8_t* pBuffer, uint16_t nDataLen, uint8_t head
     "\r\n"
     "Cache-Control: no-cache, no-store\r\n"
     "Content-Type: text/html; charset=utf-8\r\n";
+#if HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0
+  // Page scripts may be cached but must be revalidated with their ETag
+  static const char http_string_script[] = 
+    "\r\n"
+    "Cache-Control: no-cache\r\n"
+#if HTTPD_SCRIPT_GZIP == 1
+    "Content-Encoding: gzip\r\n"
+#endif // HTTPD_SCRIPT_GZIP == 1
+    "Content-Type: text/javascript\r\n";
+#endif // HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0
 
   nBytes = 0;
   
   pBuffer = stpcpy(pBuffer, "HTTP/1.1 ");
   nBytes += 9;
 
-  if (header_type == HEADER200) {
+  if (header_type == HEADER200 || header_type == HEADER200CHUNKED || header_type == HEADER200SCRIPT) {
     pBuffer = stpcpy(pBuffer, "200 OK\r\n");
     nBytes += 8;
   }
+  if (header_type == HEADER304) {
+    pBuffer = stpcpy(pBuffer, "304 Not Modified\r\n");
+    nBytes += 18;
+  }
 //  if (header_type == HEADER204) {
 //    pBuffer = stpcpy(pBuffer, "204 No Content\r\n");
 //    nBytes += 16;
@@ -6180,30 +5998,519 @@ static uint16_t CopyHttpHeader(uint8_t* pBuffer, uint16_t nDataLen, uint8_t head
     nBytes += 23;
   }
 
-  pBuffer = stpcpy(pBuffer, "Content-Length:");
-  nBytes += 15;
-
-  // This creates the "xxxxx" part of a 5 character "Content-Length:xxxxx"
-  // field in the pBuffer.
-  emb_itoa(nDataLen, OctetArray, 10, 5);
-  pBuffer = stpcpy(pBuffer, OctetArray);
-  nBytes += 5;
+  if (header_type == HEADER200CHUNKED
+#if HTTPD_CHUNKED_TRANSFER == 1
+   || header_type == HEADER200SCRIPT
+#endif // HTTPD_CHUNKED_TRANSFER == 1
+  ) {
+    // The page length is not sent. CopyHttpData() sends the page as a
+    // series of chunks instead.
+    pBuffer = stpcpy(pBuffer, "Transfer-Encoding:chunked");
+    nBytes += 25;
+  }
+  else if (header_type != HEADER304) {
+    pBuffer = stpcpy(pBuffer, "Content-Length:");
+    nBytes += 15;
+
+    // This creates the "xxxxx" part of a 5 character "Content-Length:xxxxx"
+    // field in the pBuffer.
+    emb_itoa(nDataLen, OctetArray, 10, 5);
+    pBuffer = stpcpy(pBuffer, OctetArray);
+    nBytes += 5;
+  }
 
-  pBuffer = stpcpy(pBuffer, http_string1);
-  nBytes += strlen(http_string1);
+#if HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0
+  if (header_type == HEADER200SCRIPT || header_type == HEADER304) {
+    // A 304 has no body so it has no Content-Length or Content-Type
+    if (header_type == HEADER200SCRIPT) {
+      pBuffer = stpcpy(pBuffer, http_string_script);
+      nBytes += strlen(http_string_script);
+    }
+    pBuffer = stpcpy(pBuffer, "ETag:");
+    pBuffer = copy_etag(pBuffer);
+    pBuffer = stpcpy(pBuffer, "\r\n");
+    nBytes += 5 + ETAG_SIZE + 2;
+  }
+  else
+#endif // HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0
+  {
+    pBuffer = stpcpy(pBuffer, http_string1);
+    nBytes += strlen(http_string1);
+  }
   
   if (header_type == HEADER429) {
     pBuffer = stpcpy(pBuffer, "Retry-After: 10\r\n");
     nBytes += 17;
   }
   
-  pBuffer = stpcpy(pBuffer, "Connection:close\r\n\r\n");
-  nBytes += 20;
+#if HTTPD_KEEP_ALIVE > 0
+  // A GET that will change settings or cause a reboot is answered on a
+  // connection that closes. KeepAlive is cleared here so that the same
+  // header is generated if it is retransmitted.
+  if (user_reboot_request || parse_complete) pSocket->KeepAlive = 0;
+  if (pSocket->KeepAlive) {
+    pBuffer = stpcpy(pBuffer, "Connection:keep-alive\r\n\r\n");
+    nBytes += 25;
+  }
+  else
+#endif // HTTPD_KEEP_ALIVE > 0
+  {
+    pBuffer = stpcpy(pBuffer, "Connection:close\r\n\r\n");
+    nBytes += 20;
+  }
   
   return nBytes;
 }
 
 
+#if (HTTPD_STATUS_RECORD == 1 || UDP_STATUS_SUPPORT == 1) && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+static uint32_t status_pins(void)
+{
+  // Returns the IO pin states as one bit per pin. Same rules as the %f00
+  // Short Form IO state field.
+  uint32_t pins;
+  int i;
+  int npins;
+
+  npins = 16;
+#if PCF8574_SUPPORT == 1
+  if (stored_options1 & 0x08) npins = 24;
+#endif // PCF8574_SUPPORT == 1
+  pins = 0;
+  for (i = 0; i < npins; i++) {
+    if (pin_control[i] & 0x80) pins |= ((uint32_t)1 << i);
+#if LINKED_SUPPORT == 0
+    if ((pin_control[i] & 0x02) == 0) {
+#endif // LINKED_SUPPORT == 0
+#if LINKED_SUPPORT == 1
+    if (chk_iotype(pin_control[i], i, 0x03) != 0x03) {
+#endif // LINKED_SUPPORT == 1
+      // This is an input, invert if needed
+      if (pin_control[i] & 0x04) pins ^= ((uint32_t)1 << i);
+    }
+  }
+  return pins;
+}
+#endif // (HTTPD_STATUS_RECORD == 1 || UDP_STATUS_SUPPORT == 1) && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+
+
+#if HTTPD_STATUS_RECORD == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+static char* status_field(char* pBuffer, uint32_t value, uint8_t digits)
+{
+  // Append a comma delimiter and a hex field to the status record
+  *pBuffer++ = ',';
+  emb_itoa(value, OctetArray, 16, digits);
+  return stpcpy(pBuffer, OctetArray);
+}
+
+
+static uint16_t CopyHttpStatus(uint8_t* pBuffer, struct tHttpD* pSocket)
+{
+  // Copy the 200 header and the Status Record (see WEBPAGE_STATUS) to the
+  // pBuffer. Returns the number of bytes copied.
+  uint16_t nBytes;
+  uint32_t pins;
+  char* pRecord;
+  int i;
+
+  nBytes = CopyHttpHeader(pBuffer, pSocket, STATUS_RECORD_SIZE, HEADER200);
+  pRecord = (char*)(pBuffer + nBytes);
+
+  // IO pin states
+  pins = status_pins();
+  emb_itoa(pins, OctetArray, 16, 6);
+  pRecord = stpcpy(pRecord, OctetArray);
+
+  // DS18B20 readings
+  for (i = 0; i < 5; i++) {
+    pins = 0;
+#if DS18B20_SUPPORT == 1
+    if ((stored_config_settings & 0x08) && i <= numROMs) {
+      pins = (uint16_t)((DS18B20_scratch[i][1] << 8) | DS18B20_scratch[i][0]);
+    }
+#endif // DS18B20_SUPPORT == 1
+    pRecord = status_field(pRecord, pins, 4);
+  }
+
+  // BME280 readings
+#if BME280_SUPPORT == 1
+  if (stored_config_settings & 0x20) {
+    pRecord = status_field(pRecord, (uint32_t)comp_data_temperature, 8);
+    pRecord = status_field(pRecord, (uint32_t)comp_data_pressure, 8);
+    pRecord = status_field(pRecord, (uint32_t)comp_data_humidity, 8);
+  }
+  else
+#endif // BME280_SUPPORT == 1
+  {
+    for (i = 0; i < 3; i++) pRecord = status_field(pRecord, 0, 8);
+  }
+
+  // INA226 readings
+#if INA226_SUPPORT == 1
+  pRecord = status_field(pRecord, (uint32_t)voltage, 8);
+  pRecord = status_field(pRecord, (uint32_t)current, 8);
+  pRecord = status_field(pRecord, (uint32_t)power, 8);
+#else // INA226_SUPPORT == 0
+  for (i = 0; i < 3; i++) pRecord = status_field(pRecord, 0, 8);
+#endif // INA226_SUPPORT == 1
+
+  // MQTT status
+  pRecord = status_field(pRecord, mqtt_start_status, 2);
+  pRecord = status_field(pRecord, MQTT_error_status, 2);
+  pRecord = status_field(pRecord, MQTT_resp_tout_counter, 2);
+  pRecord = status_field(pRecord, MQTT_not_OK_counter, 2);
+  pRecord = status_field(pRecord, MQTT_broker_dis_counter, 2);
+
+  // Link error statistics
+  for (i = 0; i < 10; i++) {
+    pRecord = status_field(pRecord, debug_bytes[i], 2);
+  }
+  pRecord = status_field(pRecord, TRANSMIT_counter, 8);
+  pRecord = status_field(pRecord, second_counter, 8);
+#if UIP_CONN_RESERVE == 1
+  pRecord = status_field(pRecord, syn_drop_counter, 2);
+#else // UIP_CONN_RESERVE == 0
+  pRecord = status_field(pRecord, 0, 2);
+#endif // UIP_CONN_RESERVE == 1
+
+  return (uint16_t)(nBytes + STATUS_RECORD_SIZE);
+}
+#endif // HTTPD_STATUS_RECORD == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+
+
+#if HTTPD_LONG_POLL > 0 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+#if HTTPD_STATUS_RECORD == 0
+  #error "HTTPD_LONG_POLL requires HTTPD_STATUS_RECORD"
+#endif // HTTPD_STATUS_RECORD == 0
+static uint16_t live_mix(uint16_t sig, uint32_t value)
+{
+  // Fold a value into a live_signature()
+  sig = (uint16_t)((sig << 3) | (sig >> 13));
+  return (uint16_t)(sig ^ (uint16_t)value ^ (uint16_t)(value >> 16));
+}
+
+
+static uint16_t live_signature(void)
+{
+  // Returns a signature of the IO pin states and sensor readings in the
+  // Status Record. A /95 request is answered when the signature differs
+  // from the one taken when the request arrived.
+  uint16_t sig;
+
+  sig = live_mix(0, status_pins());
+#if DS18B20_SUPPORT == 1
+  if (stored_config_settings & 0x08) {
+    int i;
+    for (i = 0; i <= numROMs; i++) {
+      sig = live_mix(sig, (uint16_t)((DS18B20_scratch[i][1] << 8) | DS18B20_scratch[i][0]));
+    }
+  }
+#endif // DS18B20_SUPPORT == 1
+#if BME280_SUPPORT == 1
+  if (stored_config_settings & 0x20) {
+    sig = live_mix(sig, (uint32_t)comp_data_temperature);
+    sig = live_mix(sig, (uint32_t)comp_data_pressure);
+    sig = live_mix(sig, (uint32_t)comp_data_humidity);
+  }
+#endif // BME280_SUPPORT == 1
+#if INA226_SUPPORT == 1
+  sig = live_mix(sig, (uint32_t)voltage);
+  sig = live_mix(sig, (uint32_t)current);
+  sig = live_mix(sig, (uint32_t)power);
+#endif // INA226_SUPPORT == 1
+  return sig;
+}
+#endif // HTTPD_LONG_POLL > 0 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+
+
+#if UDP_STATUS_SUPPORT == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+// UDP status service. See UDP_STATUS_SUPPORT in uipopt.h for the request
+// and reply formats.
+#define UDP_CMD_SIZE	19   // Size of a 'C' request
+#define UDP_REPLY_SIZE	66   // Size of an 'R' reply
+#define UDP_TAG_SIZE	8    // Size of the 'C' request auth tag
+
+uint16_t udp_nonce;           // Nonce a 'C' request must carry
+uint32_t udp_hold_until;      // 'C' requests refused until second_counter
+                              // reaches this value
+
+
+static uint8_t* udp_put(uint8_t* pBuffer, uint32_t value, uint8_t nBytes)
+{
+  // Append the nBytes least significant bytes of value to the reply, most
+  // significant byte first
+  while (nBytes--) *pBuffer++ = (uint8_t)(value >> (nBytes * 8));
+  return pBuffer;
+}
+
+
+#define udp_rotl(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+static void udp_times2(uint32_t* pKey)
+{
+  // Chaskey subkey derivation: multiply the 128 bit value by x in GF(2^128)
+  uint32_t carry;
+  carry = (pKey[3] & 0x80000000) ? 0x87 : 0;
+  pKey[3] = (pKey[3] << 1) | (pKey[2] >> 31);
+  pKey[2] = (pKey[2] << 1) | (pKey[1] >> 31);
+  pKey[1] = (pKey[1] << 1) | (pKey[0] >> 31);
+  pKey[0] = (pKey[0] << 1) ^ carry;
+}
+
+
+static uint8_t udp_auth_ok(const uint8_t* pRequest)
+{
+  // Returns 1 if the auth tag of a 'C' request is the Chaskey-12 MAC of
+  // the first 11 bytes of the request. The 128 bit key is the MQTT
+  // Password padded with zero bytes. 11 bytes is less than one 16 byte
+  // block, so the message is padded with 0x01 and zero bytes and the
+  // second subkey is used. The tag is the first 8 bytes of the result.
+  uint32_t k[4];
+  uint32_t l[4];
+  uint32_t v[4];
+  uint8_t block[16];
+  uint8_t diff;
+  int i;
+
+  memset(block, 0, 16);
+  for (i = 0; i < 10 && stored_mqtt_password[i] != '\0'; i++) {
+    block[i] = (uint8_t)stored_mqtt_password[i];
+  }
+  for (i = 0; i < 4; i++) {
+    k[i] = (uint32_t)block[i*4] | ((uint32_t)block[i*4+1] << 8)
+         | ((uint32_t)block[i*4+2] << 16) | ((uint32_t)block[i*4+3] << 24);
+    l[i] = k[i];
+  }
+  udp_times2(l);
+  udp_times2(l);
+
+  memcpy(block, pRequest, 11);
+  block[11] = 0x01;
+  memset(&block[12], 0, 4);
+  for (i = 0; i < 4; i++) {
+    v[i] = k[i] ^ l[i]
+         ^ ((uint32_t)block[i*4] | ((uint32_t)block[i*4+1] << 8)
+         | ((uint32_t)block[i*4+2] << 16) | ((uint32_t)block[i*4+3] << 24));
+  }
+  for (i = 0; i < 12; i++) {
+    v[0] += v[1]; v[1] = udp_rotl(v[1], 5); v[1] ^= v[0]; v[0] = udp_rotl(v[0], 16);
+    v[2] += v[3]; v[3] = udp_rotl(v[3], 8); v[3] ^= v[2];
+    v[0] += v[3]; v[3] = udp_rotl(v[3], 13); v[3] ^= v[0];
+    v[2] += v[1]; v[1] = udp_rotl(v[1], 7); v[1] ^= v[2]; v[2] = udp_rotl(v[2], 16);
+  }
+  v[0] ^= l[0];
+  v[1] ^= l[1];
+
+  // Compare all of the tag so the time taken does not depend on where the
+  // first wrong byte is
+  diff = 0;
+  for (i = 0; i < UDP_TAG_SIZE; i++) {
+    diff |= (uint8_t)(pRequest[11 + i] ^ (uint8_t)(v[i >> 2] >> ((i & 3) * 8)));
+  }
+  return (uint8_t)(diff == 0);
+}
+
+
+void udp_status_call(void)
+{
+  // Called by uip_process() with a UDP status service request at
+  // uip_appdata and its length in uip_len. The reply is built in place of
+  // the request. uip_slen is set to the reply length.
+  uint8_t* pBuffer;
+  uint8_t result;
+  uint32_t mask;
+  uint32_t states;
+  int i;
+
+  pBuffer = (uint8_t*)uip_appdata;
+
+  // The nonce is seeded on the first request after boot so that it does not
+  // restart at the same value
+  if (udp_nonce == 0) udp_nonce = (uint16_t)(TRANSMIT_counter ^ ms_counter) | 0x0001;
+
+  result = 2;
+  if (uip_len >= 1 && pBuffer[0] == 'S') result = 0;
+  if (uip_len >= UDP_CMD_SIZE && pBuffer[0] == 'C') {
+    // Commands are refused if no MQTT Password is set, and for 2 seconds
+    // after a rejected command so the tag can not be brute forced
+    if (stored_mqtt_password[0] == '\0'
+     || second_counter < udp_hold_until) {
+      result = 3;
+    }
+    else if ((uint16_t)((pBuffer[1] << 8) | pBuffer[2]) == udp_nonce
+     && udp_auth_ok(pBuffer)) {
+      mask = ((uint32_t)pBuffer[3] << 24) | ((uint32_t)pBuffer[4] << 16) | ((uint16_t)pBuffer[5] << 8) | pBuffer[6];
+      states = ((uint32_t)pBuffer[7] << 24) | ((uint32_t)pBuffer[8] << 16) | ((uint16_t)pBuffer[9] << 8) | pBuffer[10];
+      for (i = 0; i < 24; i++) {
+#if PCF8574_SUPPORT == 0
+        if (i > 15) break;
+#endif // PCF8574_SUPPORT == 0
+        if (mask & ((uint32_t)1 << i)) {
+          update_ON_OFF((uint8_t)i, (uint8_t)((states >> i) & 1));
+        }
+      }
+      result = 0;
+    }
+    else {
+      result = 1;
+      udp_hold_until = second_counter + 2;
+    }
+    // The nonce changes after every command whether it was accepted or not
+    udp_nonce = crc_ccitt((uint16_t)(udp_nonce ^ ms_counter), &pBuffer[11], UDP_TAG_SIZE) | 0x0001;
+  }
+
+  *pBuffer++ = 'R';
+  *pBuffer++ = result;
+  pBuffer = udp_put(pBuffer, udp_nonce, 2);
+  pBuffer = udp_put(pBuffer, status_pins(), 4);
+
+  // DS18B20 readings
+  for (i = 0; i < 5; i++) {
+    states = 0;
+#if DS18B20_SUPPORT == 1
+    if ((stored_config_settings & 0x08) && i <= numROMs) {
+      states = (uint16_t)((DS18B20_scratch[i][1] << 8) | DS18B20_scratch[i][0]);
+    }
+#endif // DS18B20_SUPPORT == 1
+    pBuffer = udp_put(pBuffer, states, 2);
+  }
+
+  // BME280 readings
+#if BME280_SUPPORT == 1
+  if (stored_config_settings & 0x20) {
+    pBuffer = udp_put(pBuffer, (uint32_t)comp_data_temperature, 4);
+    pBuffer = udp_put(pBuffer, (uint32_t)comp_data_pressure, 4);
+    pBuffer = udp_put(pBuffer, (uint32_t)comp_data_humidity, 4);
+  }
+  else
+#endif // BME280_SUPPORT == 1
+  {
+    for (i = 0; i < 3; i++) pBuffer = udp_put(pBuffer, 0, 4);
+  }
+
+  // INA226 readings
+#if INA226_SUPPORT == 1
+  pBuffer = udp_put(pBuffer, (uint32_t)voltage, 4);
+  pBuffer = udp_put(pBuffer, (uint32_t)current, 4);
+  pBuffer = udp_put(pBuffer, (uint32_t)power, 4);
+#else // INA226_SUPPORT == 0
+  for (i = 0; i < 3; i++) pBuffer = udp_put(pBuffer, 0, 4);
+#endif // INA226_SUPPORT == 1
+
+  // MQTT status
+  *pBuffer++ = mqtt_start_status;
+  *pBuffer++ = MQTT_error_status;
+  *pBuffer++ = MQTT_resp_tout_counter;
+  *pBuffer++ = MQTT_not_OK_counter;
+  *pBuffer++ = MQTT_broker_dis_counter;
+
+  // Link error statistics
+  for (i = 0; i < 10; i++) *pBuffer++ = debug_bytes[i];
+  pBuffer = udp_put(pBuffer, TRANSMIT_counter, 4);
+  pBuffer = udp_put(pBuffer, second_counter, 4);
+#if UIP_CONN_RESERVE == 1
+  *pBuffer = syn_drop_counter;
+#else // UIP_CONN_RESERVE == 0
+  *pBuffer = 0;
+#endif // UIP_CONN_RESERVE == 1
+
+  uip_slen = UDP_REPLY_SIZE;
+}
+#endif // UDP_STATUS_SUPPORT == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+
+
+#if DEVELOPMENT_TOOLS == 1 && BENCHMARK_SUPPORT == 1
+static uint16_t CopyHttpBench(uint8_t* pBuffer, struct tHttpD* pSocket)
+{
+  // Copy the 200 header and the Benchmark Record (see WEBPAGE_BENCHMARK)
+  // to the pBuffer. Returns the number of bytes copied.
+  uint16_t nBytes;
+  char* pRecord;
+  int i;
+
+  nBytes = CopyHttpHeader(pBuffer, pSocket, BENCH_RECORD_SIZE, HEADER200);
+  pRecord = (char*)(pBuffer + nBytes);
+  for (i = 0; i < BENCH_NUM; i++) {
+    if (i > 0) *pRecord++ = ',';
+    emb_itoa(bench_result[i], OctetArray, 10, 8);
+    memcpy(pRecord, OctetArray, 8);
+    pRecord += 8;
+  }
+  return (uint16_t)(nBytes + BENCH_RECORD_SIZE);
+}
+
+
+#if OB_EEPROM_SUPPORT == 0
+uint16_t bench_render(void)
+{
+  // Generate the complete IOControl page into the uip_buf the same way
+  // HttpDCall() does for a connection, but without transmitting it. Used
+  // by the page generation benchmark in bench_run(). Returns the number of
+  // segments the page was generated in.
+  struct tHttpD s;
+  uint16_t segments;
+
+  memset(&s, 0, sizeof(s));
+  s.current_webpage = WEBPAGE_IOCONTROL;
+  s.pData = g_HtmlPageIOControl;
+  s.nDataLeft = HtmlPageIOControl_size;
+  segments = 0;
+  while (s.nDataLeft > 0) {
+    CopyHttpData(&uip_buf[UIP_LLH_LEN + UIP_TCPIP_HLEN], &s.pData, &s.nDataLeft, UIP_TX_MSS, &s);
+    segments++;
+  }
+  return segments;
+}
+#endif // OB_EEPROM_SUPPORT == 0
+#endif // DEVELOPMENT_TOOLS == 1 && BENCHMARK_SUPPORT == 1
+
+
+static uint16_t CopyHttpPageHeader(uint8_t* pBuffer, struct tHttpD* pSocket)
+{
+  // Copy the header of the response selected by GET or POST processing to
+  // the pBuffer. Used for the first transmission and for a retransmit of
+  // the header. Returns the number of bytes copied.
+#if HTTPD_STATUS_RECORD == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+  if (pSocket->current_webpage == WEBPAGE_STATUS) {
+    // The Status Record is sent in the same segment as the header. If it
+    // is retransmitted it is regenerated with current values. Its length
+    // does not change.
+    return CopyHttpStatus(pBuffer, pSocket);
+  }
+#endif // HTTPD_STATUS_RECORD == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+#if DEVELOPMENT_TOOLS == 1 && BENCHMARK_SUPPORT == 1
+  if (pSocket->current_webpage == WEBPAGE_BENCHMARK) {
+    // The Benchmark Record is sent in the same segment as the header
+    return CopyHttpBench(pBuffer, pSocket);
+  }
+#endif // DEVELOPMENT_TOOLS == 1 && BENCHMARK_SUPPORT == 1
+#if HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0
+  if (pSocket->current_webpage >= WEBPAGE_SCRIPT) {
+    // A page script. If the Browser sent the ETag of the scripts it
+    // already has the script.
+    if (pSocket->nEtagMatch == ETAG_SIZE) {
+      return CopyHttpHeader(pBuffer, pSocket, 0, HEADER304);
+    }
+#if HTTPD_SCRIPT_GZIP == 1
+    // The script is sent as its gzip compressed copy
+    {
+      uint16_t nSize;
+      script_gz((uint8_t)(pSocket->current_webpage - WEBPAGE_SCRIPT), &nSize);
+      return CopyHttpHeader(pBuffer, pSocket, nSize, HEADER200SCRIPT);
+    }
+#endif // HTTPD_SCRIPT_GZIP == 1
+    // The script is sent as "var s=" followed by the script
+    return CopyHttpHeader(pBuffer, pSocket, (uint16_t)(script_size((uint8_t)(pSocket->current_webpage - WEBPAGE_SCRIPT)) + 2), HEADER200SCRIPT);
+  }
+#endif // HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0
+#if HTTPD_CHUNKED_TRANSFER == 1
+  return CopyHttpHeader(pBuffer, pSocket, 0, HEADER200CHUNKED);
+#else // HTTPD_CHUNKED_TRANSFER == 0
+  return CopyHttpHeader(pBuffer, pSocket, adjust_template_size(pSocket), HEADER200);
+#endif // HTTPD_CHUNKED_TRANSFER == 1
+}
+
+
 static uint16_t CopyHttpData(uint8_t* pBuffer,
                              const char** ppData,
 			     uint16_t* pDataLeft,
@@ -6229,10 +6536,24 @@ static uint16_t CopyHttpData(uint8_t* pBuffer,
   int no_err;
   unsigned char temp_octet[3];
   uint8_t* pBuffer_start;
+#if HTTPD_TX_WRITE_THROUGH == 1
+  uint16_t nFlushed;
+#if HTTPD_COALESCE_HEADER == 1
+  uint16_t nPrefix;
+#endif // HTTPD_COALESCE_HEADER == 1
+#endif // HTTPD_TX_WRITE_THROUGH == 1
+#if HTTPD_CHUNKED_TRANSFER == 1
+  uint8_t nChunkEnd;
+  uint16_t nChunkSize;
+  // CRLF that ends a chunk followed by the last-chunk that ends the page
+  static const char chunk_end[] = "\r\n0\r\n\r\n";
+#endif // HTTPD_CHUNKED_TRANSFER == 1
   
   // For use only in upgradeable builds:
+#if OB_EEPROM_SUPPORT == 0 || HTTPD_EEPROM_CACHE == 0
   #define PRE_BUF_SIZE	230
   char pre_buf[PRE_BUF_SIZE];
+#endif // OB_EEPROM_SUPPORT == 0 || HTTPD_EEPROM_CACHE == 0
   uint16_t pre_buf_ptr = 0;
 
 #if OB_EEPROM_SUPPORT == 1 && DS18B20_SUPPORT == 1
@@ -6263,23 +6584,19 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
   nParsedMode = 0;
   pBuffer_start =  pBuffer;
 
-  // The input value "nMaxBytes" provided by the calling routine is based on
-  // the MSS (Maximum Segment Size) defined in UIP_TCP_MSS.
+  // The input value "nMaxBytes" provided by the calling routine is the
+  // transmit MSS (Maximum Segment Size) of the connection, uip_mss().
   //
   // In this "transmit" routine MSS indicates the maximum number of TCP
   // datagram bytes that the remote host will accept in a TCP segment (the
-  // TCP datagram part of an IP frame). The MSS value is defined in the
-  // uipopt.h file. Later the MSS should be updated with a value obtained from
-  // the browser that is accessing the web server during setup of a connection.
-  // However, I don't think this actually happens, and for simplification I
-  // think UIP is using a single MSS value for transmit and receive. Receive
-  // is the critical direction because there is limited memory to store
-  // incoming packets ... and it is OK to transmit less than the MSS that a
-  // remote host tells us it can receive. The problem that this causes is that
-  // as code reduces the value of MSS for receive, it also reduces the size of
-  // MSS for transmit, and that causes the web page transmission to take a
-  // very long time (I'm seeing 2 seconds for a simple web page). May have to
-  // work on this some more.
+  // TCP datagram part of an IP frame). uip sets the transmit MSS to the
+  // smaller of the MSS the Browser sends during setup of the connection and
+  // UIP_TX_MSS (see uipopt.h). The receive MSS is kept separately in
+  // UIP_TCP_MSS. Receive is the critical direction because there is limited
+  // memory to store incoming packets. Previously a single MSS value was used
+  // for transmit and receive, so reducing the receive MSS also reduced the
+  // size of every transmitted web page segment, and web page transmission
+  // took a very long time (2 seconds for a simple web page).
   //
   // In the original UIP code there was a "uip_split" function that would
   // reduce the size of transmitted packets. I think that code was interacting
@@ -6305,20 +6622,46 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
   // about 4000 bytes.
   //
   //-------------------------------------------------------------------------//
-  // nMaxbytes must be smaller than UIP_TCP_MSS due to the need to allow for
+  // nMaxbytes must be smaller than the transmit MSS due to the need to allow for
   // the largest string insertion that is NOT a %yxx replacement (as %yxx
   // replacements can be interrupted if the buffer fills and can be continued
   // at the next call of this routine).
   //
-  // nMaxBytes should not cause a TCP datagram formation larger than 536
-  // bytes.
+  // nMaxBytes should not cause a TCP datagram formation larger than the
+  // transmit MSS.
   //
-  // The following statement over-rides the nMaxBytes value passed to the
+  // The following statement reduces the nMaxBytes value passed to the
   // function to account for extra bytes that might be sent in a single pass
   // of the loop below. This causes most packet transmissions to be smaller,
   // but accomodates those that have the extra bytes inserted.
-  nMaxBytes = UIP_TCP_MSS - 40;
-  //-------------------------------------------------------------------------//
+  nMaxBytes = nMaxBytes - 40;
+  //-------------------------------------------------------------------------//
+
+#if HTTPD_TX_WRITE_THROUGH == 1
+  // The uip_buf is only used as a staging area. Each time it holds
+  // UIP_TX_RAM_MSS - 40 bytes or more it is written to the ENC28J60 transmit
+  // buffer and refilled from the start. nFlushed counts the bytes already
+  // written so that the segment can be larger than the uip_buf.
+  Enc28j60TxDataStart();
+  nFlushed = 0;
+#if HTTPD_COALESCE_HEADER == 1
+  // A header the caller placed in the uip_buf ahead of pBuffer is written
+  // to the ENC28J60 first. The staging area then starts over at the start
+  // of the uip_buf data.
+  nPrefix = (uint16_t)(pBuffer - (uint8_t *)uip_appdata);
+  Enc28j60TxDataWrite((uint8_t *)uip_appdata, nPrefix);
+  pBuffer = pBuffer_start = (uint8_t *)uip_appdata;
+#endif // HTTPD_COALESCE_HEADER == 1
+#endif // HTTPD_TX_WRITE_THROUGH == 1
+
+#if HTTPD_CHUNKED_TRANSFER == 1
+  // Each segment is sent as one chunk. The first 5 bytes are left for the
+  // "xxx\r\n" chunk-size line, which is filled in once the size of the
+  // chunk is known. The loop limit also leaves room for the CRLF that ends
+  // the chunk and the "0\r\n\r\n" last-chunk that ends the page.
+  pBuffer = pBuffer + 5;
+  nMaxBytes = nMaxBytes - 7;
+#endif // HTTPD_CHUNKED_TRANSFER == 1
 
 
 
@@ -6344,9 +6687,12 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
     // read template data from the I2C EEPROM to improve code speed. The
     // pre_buf is then used to provide data to the webpage transmission code.
     // Optimization:
-    //  - Packet transmission size will never exceed 440 bytes
-    //  - There isn't enough RAM to have a 440 byte buffer so later in the
-    //    process the pre_buf gets re-loaded
+    //  - Packet transmission size will never exceed UIP_TX_MSS. That is
+    //    UIP_TX_RAM_MSS (about 440 bytes), or with HTTPD_TX_WRITE_THROUGH
+    //    up to the size of an ENC28J60 transmit slot (about 960 bytes).
+    //  - There isn't enough RAM for a pre_buf that large so later in the
+    //    process the pre_buf gets re-loaded as often as needed. The refill
+    //    code does not depend on the segment size.
     //  - Thus the pre_buf only needs to be about 230 bytes (to minimize the
     //    amount of data read from the I2C EEPROM per packet, thus minimizing
     //    time spent reading the data).
@@ -6359,15 +6705,47 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
     //  - "off_board_eeprom_index" is a global value that was filled in prior
     //    to the call to CopyHttpData() by the init_off_board_string_pointers()
     //    function (which was called when determining which page to display).
+    //  - With HTTPD_EEPROM_CACHE the pre_buf is kept from the previous call.
+    //    The previous segment usually stopped part way through the pre_buf,
+    //    so the next segment continues from the data already read and the
+    //    I2C read is skipped. This also covers a retransmit that restarts
+    //    from a checkpoint inside the pre_buf.
     
-    copy_I2C_EEPROM_bytes_to_RAM(&pre_buf[0], PRE_BUF_SIZE, I2C_EEPROM_R2_WRITE, I2C_EEPROM_R2_READ, off_board_eeprom_index, 2);
-    pre_buf_ptr = 0;
+#if SCRATCH_ARENA_SHARED == 1
+    scratch_claim(SCRATCH_PRE_BUF);
+#endif // SCRATCH_ARENA_SHARED == 1
+#if HTTPD_EEPROM_CACHE == 1
+    if (pre_buf_valid
+     && off_board_eeprom_index >= pre_buf_base
+     && (uint16_t)(off_board_eeprom_index - pre_buf_base) <= (PRE_BUF_SIZE - 6)) {
+      pre_buf_ptr = (uint16_t)(off_board_eeprom_index - pre_buf_base);
+    }
+    else
+#endif // HTTPD_EEPROM_CACHE == 1
+    {
+      copy_I2C_EEPROM_bytes_to_RAM(&pre_buf[0], PRE_BUF_SIZE, I2C_EEPROM_R2_WRITE, I2C_EEPROM_R2_READ, off_board_eeprom_index, 2);
+      pre_buf_ptr = 0;
+#if HTTPD_EEPROM_CACHE == 1
+      pre_buf_base = off_board_eeprom_index;
+      pre_buf_valid = 1;
+#endif // HTTPD_EEPROM_CACHE == 1
+    }
   }
 #endif // OB_EEPROM_SUPPORT == 1
   //-------------------------------------------------------------------------//
 
 
+#if HTTPD_TX_WRITE_THROUGH == 1
+  while ((uint16_t)(nFlushed + (pBuffer - pBuffer_start)) < nMaxBytes) {
+    if ((uint16_t)(pBuffer - pBuffer_start) >= (UIP_TX_RAM_MSS - 40)) {
+      // Staging area is full. Write it to the ENC28J60.
+      Enc28j60TxDataWrite(pBuffer_start, (uint16_t)(pBuffer - pBuffer_start));
+      nFlushed += (uint16_t)(pBuffer - pBuffer_start);
+      pBuffer = pBuffer_start;
+    }
+#else // HTTPD_TX_WRITE_THROUGH == 0
   while ((uint16_t)(pBuffer - pBuffer_start) < nMaxBytes) {
+#endif // HTTPD_TX_WRITE_THROUGH == 1
     // This is the main loop for processing the page templates stored in
     // Flash and inserting variable data as the webpage is copied to the
     // transmission buffer.
@@ -6454,6 +6832,9 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
             if (pre_buf_ptr > (PRE_BUF_SIZE - 6)) {
               copy_I2C_EEPROM_bytes_to_RAM(&pre_buf[0], PRE_BUF_SIZE, I2C_EEPROM_R2_WRITE, I2C_EEPROM_R2_READ, off_board_eeprom_index, 2);
               pre_buf_ptr = 0;
+#if HTTPD_EEPROM_CACHE == 1
+              pre_buf_base = off_board_eeprom_index;
+#endif // HTTPD_EEPROM_CACHE == 1
             }
           }
 	  
@@ -6463,6 +6844,17 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
 	else nByte = **ppData;
 #endif // OB_EEPROM_SUPPORT == 1
 
+#if HTTPD_SCRIPT_GZIP == 1 && HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0
+        if (pSocket->current_webpage >= WEBPAGE_SCRIPT) {
+          // A compressed page script is binary data that may contain '%'
+          // bytes. It is copied as-is without looking for markers.
+          *pBuffer = nByte;
+          *ppData = *ppData + 1;
+          *pDataLeft = *pDataLeft - 1;
+          pBuffer++;
+          continue;
+        }
+#endif // HTTPD_SCRIPT_GZIP == 1 && HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0
 
         // Search for '%' symbol in the data stream. The symbol indicates the
 	// start of one of these special fields:
@@ -6497,9 +6889,14 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
 	//      information in text format. Each byte is the pin_control
 	//      character for each PCF8574 IO pin. Input and Output.
 	// %i - IO Timer values
-	// %j - IO Names
+	// %j - IO Names. In Domoticz builds the fields hold the IDX values
+	//      and %j16 to %j23 are those of the PCF8574 device.
 	// %I - IO Timer values for PCF8574 device
-	// %J - IO Names for PCF8574 device
+	// %k - IO Names sent to the page scripts (Browser Only builds). Each
+	//      name is preceded by its length as one hex character so that
+	//      all names can be sent as one packed string.
+	// %K - IO Names for PCF8574 device sent to the page scripts, in the
+	//      same format as %k.
         // %l - Username strings
 	//        00 - MQTT Username - This is a user entered text field with
 	//             a Username. Used in MQTT communication. Input and
@@ -6521,6 +6918,8 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
 	//      10 to 17 - Displays red or green boxes to indicate the
 	//        last known ON / OFF status of latching relays. Applies
 	//        only to special Software Defined Radio builds.
+	// %S - Page script delimiters. %S00 to %S03 start the script of a
+	//      page and %S99 ends it (see HTTPD_SCRIPT_CACHE).
 	// %s - Code Uploader failure codes. Output only.
 	// %t - I2C Sensor data
 	//        00 - DS18B20 Temperature Sensor 1 data. Output only.
@@ -6685,19 +7084,27 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
 	// and nParsedNum just collected. Anything inserted in the transmit stream
 	// is in ascii / UTF-8 form.
 
+        // The marker letter selects the code that fills in the field. A
+        // switch is used (rather than a chain of comparisons) so that the
+        // compiler can dispatch through a jump table indexed by the letter.
+        // This matters most for the %y strings, which pass through here
+        // once for every character inserted.
+        switch (nParsedMode) {
 #if PCF8574_SUPPORT == 0
-        if (nParsedMode == 'a') {
+        case 'a': {
 #endif // PCF8574_SUPPORT == 0
 #if PCF8574_SUPPORT == 1
-        if ((nParsedMode == 'a') || (nParsedMode == 'A')) {
+        case 'a':
+        case 'A': {
 #endif // PCF8574_SUPPORT == 1
 	  // This displays the device name (up to 19 characters)
 	  // %axx %Axx
           pBuffer = stpcpy(pBuffer, stored_devicename);
 	}
+        break;
 
 	
-        else if (nParsedMode == 'b') {
+        case 'b': {
 	  // This displays the IP Address, Gateway Address, and Netmask information.
 	  // We need to get the 32 bit values for IP Address, Gateway Address, and
 	  // Netmask and send them as text strings of hex characters (8 characters
@@ -6737,8 +7144,9 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
             pBuffer = stpcpy(pBuffer, OctetArray);
 	  }
 	}
+        break;
 	
-        else if (nParsedMode == 'c') {
+        case 'c': {
 	  // If nParsedNum == 0 this is the HTML Port number (5 characters)
 	  // If nParsedNum == 1 this is the MQTT Host Port number (5 characters)
 	  // In both cases we need to get a single 16 bit integer from storage
@@ -6753,8 +7161,9 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
 	  // Copy OctetArray characters to output. Advance pointers.
           pBuffer = stpcpy(pBuffer, OctetArray);
         }
+        break;
 	
-        else if (nParsedMode == 'd') {
+        case 'd': {
 	  // This displays the MAC adddress information (2 characters per
 	  // octet). We send the 12 characters in the mac_string (rather
 	  // than from the uip_ethaddr bytes) as the mac_string is already
@@ -6762,10 +7171,13 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
 	  // %dxx
           pBuffer = stpcpy(pBuffer, mac_string);
 	}
+        break;
 	
 
+#if (NETWORK_STATISTICS == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD) || LINK_STATISTICS == 1 || DEBUG_SENSOR_SERIAL == 1
+        case 'e':
 #if NETWORK_STATISTICS == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
-        else if ((nParsedMode == 'e') && (nParsedNum < 22)) {
+        if (nParsedNum < 22) {
 	  // This displays the statistics information (10 characters per
 	  // data item). We need to get a single uint32_t from storage but
 	  // put it in the output stream as a character representation of
@@ -6821,13 +7233,14 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
 	    case 21: emb_itoa(uip_stat.tcp.synrst,   OctetArray, 10, 10); break;
 	  }
         pBuffer = stpcpy(pBuffer, OctetArray);
+	  break;
 	}
 #endif // NETWORK_STATISTICS == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
 
 
 #if LINK_STATISTICS == 1
 //        else if ((nParsedMode == 'e') && (nParsedNum >= 30) && (nParsedNum < 40)) {
-        else if (nParsedMode == 'e') {
+        {
 	  // This displays the Link Error Statistics
 	  // %exx
 	  // This code is surprisingly large (about 284 bytes)
@@ -6854,14 +7267,14 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
 	      // Display Stack Overflow Error, ENC28J60 revision, TXERIF Error
 	      // Count and RXERIF Error Count
 	      for (i=0; i<5; i++) {
-                int2hex(stored_debug_bytes[i]);
+                int2hex(debug_bytes[i]);
                 pBuffer = stpcpy(pBuffer, OctetArray);
 	      }
 	    }
             else if (nParsedNum == 34) {
 	      for (i=5; i<10; i++) {
 	        // Display EMCF, SWIMF, ILLOPF,IWDGF and WWDGF Counters
-                int2hex(stored_debug_bytes[i]);
+                int2hex(debug_bytes[i]);
                 pBuffer = stpcpy(pBuffer, OctetArray);
 	      }
 	    }
@@ -6876,13 +7289,35 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
               int2hex(MQTT_broker_dis_counter);
               pBuffer = stpcpy(pBuffer, OctetArray);
 	    }
+#if STACK_MONITOR == 1
+            else if (nParsedNum == 36) {
+	      // Display the stack, uip_buf and mqtt_sendbuf peaks in bytes
+	      // (4 hex digits each)
+	      emb_itoa(stack_peak, OctetArray, 16, 4);
+              pBuffer = stpcpy(pBuffer, OctetArray);
+	      emb_itoa(uip_buf_peak, OctetArray, 16, 4);
+              pBuffer = stpcpy(pBuffer, OctetArray);
+	      emb_itoa(mqtt_sendbuf_peak, OctetArray, 16, 4);
+              pBuffer = stpcpy(pBuffer, OctetArray);
+	    }
+#endif // STACK_MONITOR == 1
+#if BOOT_PROFILE == 1
+            else if (nParsedNum == 37) {
+	      // Display the boot stage times in ms (4 hex digits each)
+	      for (i = 0; i < BOOT_STAGES; i++) {
+	        emb_itoa(boot_time[i], OctetArray, 16, 4);
+                pBuffer = stpcpy(pBuffer, OctetArray);
+	      }
+	    }
+#endif // BOOT_PROFILE == 1
 	  }
+	  break;
 	}
 #endif // LINK_STATISTICS == 1
 
 
 #if DEBUG_SENSOR_SERIAL == 1
-        else if ((nParsedMode == 'e') && (nParsedNum >= 40)) {
+        if (nParsedNum >= 40) {
 	  // This is for diagnostic use only and is NOT normally enabled
 	  // in the compile options. This displays the Temperature Sensor
 	  // Serial Numbers and was made necessary due to some suppliers
@@ -6901,11 +7336,15 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
 	  else {
 	    pBuffer = stpcpy(pBuffer, "------------");
 	  }
+	  break;
 	}
 #endif // DEBUG_SENSOR_SERIAL
+        break;
+#endif // (NETWORK_STATISTICS == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD) || LINK_STATISTICS == 1 || DEBUG_SENSOR_SERIAL == 1
 
 
-        else if ((nParsedMode == 'f') && (nParsedNum == 0)) {
+        case 'f':
+        if (nParsedNum == 0) {
 	  // Display the pin state information in the format used by the "98"
 	  // and "99" command. "99" is the command used in the original
 	  // Network Module.
@@ -6971,7 +7410,7 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
 	
 
 #if RF_ATTEN_SUPPORT == 1
-        else if ((nParsedMode == 'f') && (nParsedNum == 1)) {
+        else if (nParsedNum == 1) {
 	  // This is a special case utilized only for the RF Attenuator
 	  // special build. This will display IO bits 6 to 2 (5 bits) as a
 	  // decimal number.
@@ -6986,9 +7425,10 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
 	  }
 	}
 #endif // RF_ATTEN_SUPPORT == 1
+        break;
 	
 
-        else if (nParsedMode == 'g') {
+        case 'g': {
 	  // This displays the Config string, currently defined as follows:
 	  // Communicated to and from the web pages as 2 characters making
 	  // a hex encoded byte. Stored in memory as a single byte.
@@ -7013,11 +7453,12 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
           int2hex(stored_config_settings);
 	  pBuffer = stpcpy(pBuffer, OctetArray);
 	}
+        break;
 	
 	
 #if LINKED_SUPPORT == 0
 #if BUILD_SUPPORT == BROWSER_ONLY_BUILD || HOME_ASSISTANT_SUPPORT == 1
-        else if (nParsedMode == 'h') {
+        case 'h': {
 	  // This sends the Pin Control String for non-Domoticz builds,
 	  // defined as follows:
 	  // 32 characters
@@ -7048,9 +7489,10 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
             }
 	  }
 	}
+        break;
 
 #if PCF8574_SUPPORT == 1
-        else if (nParsedMode == 'H') {
+        case 'H': {
 	  // This sends the Pin Control String to the PCF8574 Configuration
 	  // and IOControl pages (note: these separate pages are not part of
 	  // the Domoticz builds).
@@ -7088,11 +7530,12 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
             }
 	  }
 	}
+        break;
 #endif // PCF8574_SUPPORT == 1
 #endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || HOME_ASSISTANT_SUPPORT == 1
 
 #if DOMOTICZ_SUPPORT == 1
-        else if (nParsedMode == 'h') {
+        case 'h': {
 	  // This sends the Pin Control String for Domoticz builds, defined as
 	  // follows:
 	  // 48 characters
@@ -7145,13 +7588,14 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
             }
 	  }
 	}
+        break;
 #endif // DOMOTICZ_SUPPORT == 1
 #endif // LINKED_SUPPORT == 0
 
 
 #if LINKED_SUPPORT == 1
 #if BUILD_SUPPORT == BROWSER_ONLY_BUILD || HOME_ASSISTANT_SUPPORT == 1
-        else if (nParsedMode == 'h') {
+        case 'h': {
 	  // This sends the Pin Control String for non-Domoticz builds,
 	  // defined as follows:
 	  // 32 characters
@@ -7203,9 +7647,10 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
             }
 	  }
 	}
+        break;
 	
 #if PCF8574_SUPPORT == 1
-        else if (nParsedMode == 'H') {
+        case 'H': {
 	  // This sends the Pin Control String to the PCF8574 Configuration
 	  // and IOControl pages (note: these separate pages are not part of
 	  // the Domoticz builds).
@@ -7264,11 +7709,12 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
             }
 	  }
 	}
+        break;
 #endif // PCF8574_SUPPORT == 1
 #endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || HOME_ASSISTANT_SUPPORT == 1
 
 #if DOMOTICZ_SUPPORT == 1
-        else if (nParsedMode == 'h') {
+        case 'h': {
 	  // This sends the Pin Control String for Domoticz builds,
 	  // defined as follows:
 	  // 48 characters
@@ -7346,13 +7792,14 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
             }
 	  }
 	}
+        break;
 #endif // DOMOTICZ_SUPPORT == 1
 
 #endif // LINKED_SUPPORT == 1
 
 
 #if BUILD_SUPPORT == BROWSER_ONLY_BUILD
-        else if (nParsedMode == 'i') {
+        case 'i': {
 	  // This sends the IO 1 to 16 IO Timer units and IO Timer values to
 	  // the Browser Configuration page.
 	  // Defined as follows:
@@ -7370,8 +7817,9 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
             pBuffer = stpcpy(pBuffer, OctetArray);
           }
 	}
+        break;
 #if PCF8574_SUPPORT == 1
-        else if (nParsedMode == 'I') {
+        case 'I': {
 	  // This sends the PCF8574 IO Timer units and IO Timer values to the
 	  // PCF8574 Browser Configuration page.
 	  // Defined as follows:
@@ -7393,6 +7841,7 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
             pBuffer = stpcpy(pBuffer, OctetArray);
           }
 	}
+        break;
 #endif // PCF8574_SUPPORT == 1
 #endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
 
@@ -7403,32 +7852,48 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
 
 	
 #if BUILD_SUPPORT == BROWSER_ONLY_BUILD
-        else if (nParsedMode == 'j') {
+        case 'j': {
 	  // This displays IO Names in user friendly format (1 to 15
 	  // characters)
           // These names are for IO 1 to 16 (nParsedNum 0 to 15)
 	  // %jxx
           pBuffer = stpcpy(pBuffer, IO_NAME[nParsedNum]);
 	}
+        break;
+        case 'k': {
+	  // This sends an IO Name to the IOControl and Configuration page
+	  // scripts. The name is preceded by its length as a single hex
+	  // character so that all 16 names can be sent in one packed string
+	  // without a key for each name. The page script unpacks them.
+          // These names are for IO 1 to 16 (nParsedNum 0 to 15)
+	  // %kxx
+          *pBuffer++ = int2nibble((uint8_t)strlen(IO_NAME[nParsedNum]));
+          pBuffer = stpcpy(pBuffer, IO_NAME[nParsedNum]);
+	}
+        break;
 #if PCF8574_SUPPORT == 1
-        else if (nParsedMode == 'J') {
-          // This displays PCF8574 IO Names in user friendly format (1 to 15
-          // characters)
+        case 'K': {
+          // This sends a PCF8574 IO Name to the PCF8574 IOControl and
+          // Configuration page scripts, preceded by its length as a single
+          // hex character (see %kxx).
           // These names are for IO 17 to 24 (nParsedNum 16 to 23)
-	  // %Jxx
+	  // %Kxx
 	  {
 	    char temp_string[16];
             // Read a PCF8574_IO_NAMES value from I2C EEPROM
             copy_I2C_EEPROM_bytes_to_RAM(&temp_string[0], 16, I2C_EEPROM_R2_WRITE, I2C_EEPROM_R2_READ, PCF8574_I2C_EEPROM_R2_START_IO_NAMES + ((nParsedNum - 16) * 16), 2);
+            *pBuffer++ = int2nibble((uint8_t)strlen(temp_string));
             pBuffer = stpcpy(pBuffer, temp_string);
           }
 	}
+        break;
 #endif // PCF8574_SUPPORT == 1
 #endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
 
 
 #if DOMOTICZ_SUPPORT == 1
-        else if (nParsedMode == 'j' && nParsedNum < 16) {
+        case 'j':
+        if (nParsedNum < 16) {
 	  // This displays IO Names in user friendly format (1 to 15
 	  // characters). These fields have been repurposed to contain the
 	  // IDX values for the IO pins.
@@ -7437,7 +7902,7 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
           pBuffer = stpcpy(pBuffer, IO_NAME[nParsedNum]);
 	}
 #if PCF8574_SUPPORT == 1
-        else if (nParsedMode == 'j' && nParsedNum > 15) {
+        else if (nParsedNum > 15) {
           // This displays PCF8574 IO Names in user friendly format (1 to 15
 	  // characters). These fields have been repurposed to contain the
 	  // IDX values for the IO pins.
@@ -7452,7 +7917,7 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
 	}
 #endif // PCF8574_SUPPORT == 1
 #if PCF8574_SUPPORT == 0
-        else if (nParsedMode == 'j' && nParsedNum > 15) {
+        else if (nParsedNum > 15) {
           // This is a special case where Domoticz is supported but the
 	  // PCF8574 is not. The Domoticz Configuration page still needs to
 	  // receive and display 'j' values. In this special case the values
@@ -7464,20 +7929,22 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
           }
 	}
 #endif // PCF8574_SUPPORT == 0
+        break;
 #endif // DOMOTICZ_SUPPORT == 1
 
 
 
 
 #if LOGIN_SUPPORT == 0
-        else if (nParsedMode == 'l') {
+        case 'l': {
 	  // %lxx
 	  // This displays MQTT Username information (0 to 10 characters)
           pBuffer = stpcpy(pBuffer, stored_mqtt_username);
 	}
+        break;
 #endif // LOGIN_SUPPORT == 0
 #if LOGIN_SUPPORT == 1
-        else if (nParsedMode == 'l') {
+        case 'l': {
           if (nParsedNum == 00) {
 	    // %l00
 	    // This displays MQTT Username information (0 to 10 characters)
@@ -7494,16 +7961,19 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
             }
 	  }
 	}
+        break;
 #endif // LOGIN_SUPPORT == 1
 
 
-        else if (nParsedMode == 'm') {
+        case 'm': {
 	  // %mxx
 	  // This displays MQTT Password information (0 to 10 characters)
           pBuffer = stpcpy(pBuffer, stored_mqtt_password);
 	}
+        break;
 
-        else if ((nParsedMode == 'n') && (nParsedNum < 10)) {
+        case 'n':
+        if (nParsedNum < 10) {
 	  // This displays the MQTT Start Status information as five
 	  // red/green boxes showing Connections available, ARP status,
 	  // TCP status, MQTT Connect status, and MQTT Error status.
@@ -7542,7 +8012,7 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
 
 
 #if SDR_POWER_RELAY_SUPPORT == 1
-        else if ((nParsedMode == 'n') && (nParsedNum > 9) && (nParsedNum < 20)) {
+        else if ((nParsedNum > 9) && (nParsedNum < 20)) {
 	  // This displays the last know state of the Latching Relays. Applies
 	  // only to Software Defined Radio builds. If a relay is indicated as
 	  // ON a green box is displaed. If a relay is indicated as OFF a red
@@ -7596,12 +8066,34 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
 	  }
 	}
 #endif // SDR_POWER_RELAY_SUPPORT == 1
+        break;
+
+
+#if LINK_STATISTICS == 1 && (PROFILE_SUPPORT == 1 || PAGE_STATISTICS == 1)
+        case 'p': {
+#if PROFILE_SUPPORT == 1
+	  // This displays the main loop profiling statistics for one stage
+	  // as "count min avg max" (23 characters).
+	  // %p00 to %p05
+          if (nParsedNum < PROF_NUM_STAGES) pBuffer = prof_format(nParsedNum, pBuffer);
+#endif // PROFILE_SUPPORT == 1
+#if PAGE_STATISTICS == 1
+	  // This displays the load statistics for one webpage group as
+	  // "req done seg rexmit bytes avg max" (44 characters).
+	  // %p10 to %p14
+          if (nParsedNum >= 10 && nParsedNum < (10 + PSTAT_NUM)) {
+	    pBuffer = page_stats_format((uint8_t)(nParsedNum - 10), pBuffer);
+	  }
+#endif // PAGE_STATISTICS == 1
+	}
+        break;
+#endif // LINK_STATISTICS == 1 && (PROFILE_SUPPORT == 1 || PAGE_STATISTICS == 1)
 
 
 #if OB_EEPROM_SUPPORT == 1
-        else if (nParsedMode == 's') {
+        case 's': {
 	  // %sxx
-#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
+#if SREC_UPLOAD == 1
 	  if (nParsedNum == 2) {
 	    // This sends the Parse Fail reason code. %s02
 	    // Note: String copied to the pBuffer must be 40 characters
@@ -7617,16 +8109,63 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
 	      pBuffer = stpcpy(pBuffer, "Invalid File Type.......................");
 	    else if (upgrade_failcode == UPGRADE_FAIL_TRUNCATED_FILE)
 	      pBuffer = stpcpy(pBuffer, "Truncated File..........................");
+#if RUNTIME_UPLOAD == 1
+	    else if (upgrade_failcode == UPGRADE_FAIL_CRC)
+	      pBuffer = stpcpy(pBuffer, "Image CRC does not match the POST.......");
+#endif // RUNTIME_UPLOAD == 1
 	    else
 	      pBuffer = stpcpy(pBuffer, "Unknown Error...........................");
 	  }
-#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
+#endif // SREC_UPLOAD == 1
+#if RUNTIME_UPLOAD == 1
+	  if (nParsedNum == 3) {
+	    // This sends the CRC of the staged firmware image. %s03
+	    emb_itoa(upload_crc, OctetArray, 16, 4);
+	    pBuffer = stpcpy(pBuffer, OctetArray);
+	  }
+#endif // RUNTIME_UPLOAD == 1
 	}
+        break;
 #endif // OB_EEPROM_SUPPORT == 1
 
 
+        case 'S': {
+	  // This marks the start (%S00 to %S03) and end (%S99) of the
+	  // script in a page.
+	  if (nParsedNum != 99) {
+#if HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0
+            if (pSocket->current_webpage >= WEBPAGE_SCRIPT) {
+	      // Sending the script resource
+              pBuffer = stpcpy(pBuffer, "var s=");
+	    }
+	    else {
+	      // Sending the page. Link to the script resource in its place
+	      // and skip the template to the %S99 marker.
+              const char* pEnd;
+              pBuffer = stpcpy(pBuffer, SCRIPT_LINK1);
+              *pBuffer++ = (uint8_t)('c' + nParsedNum);
+              pBuffer = stpcpy(pBuffer, SCRIPT_LINK2);
+              pEnd = find_script_marker(*ppData, '9', '9');
+              *pDataLeft -= (uint16_t)(pEnd - *ppData);
+              *ppData = pEnd;
+	    }
+#else // HTTPD_SCRIPT_CACHE == 0 || OB_EEPROM_SUPPORT == 1
+            pBuffer = stpcpy(pBuffer, "const m=");
+#endif // HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0
+	  }
+#if HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0
+	  else if (pSocket->current_webpage < WEBPAGE_SCRIPT) {
+	    // Call the script with the page data
+            pBuffer = stpcpy(pBuffer, SCRIPT_CALL);
+	  }
+#endif // HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0
+	}
+        break;
+
+#if DS18B20_SUPPORT == 1 || BME280_SUPPORT == 1 || INA226_SUPPORT == 1
+        case 't':
 #if DS18B20_SUPPORT == 1
-        else if ((nParsedMode == 't') && (nParsedNum < 5) && (stored_config_settings & 0x08)) {
+        if ((nParsedNum < 5) && (stored_config_settings & 0x08)) {
 	  // This displays temperature sensor data on the IOControl page for 5
 	  // sensors and the text fields around that data if DS18B20 mode is
 	  // enabled. The  possible nParsedNum values for DS18B20 sensors are
@@ -7676,7 +8215,7 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
 
 
 #if SHORT_TEMPERATURE_SUPPORT == 1
-        else if ((nParsedMode == 't') && (nParsedNum >= 20) && (nParsedNum < 25) && (stored_config_settings & 0x08)) {
+        else if ((nParsedNum >= 20) && (nParsedNum < 25) && (stored_config_settings & 0x08)) {
 	  // This displays temperature sensor data on the Short Form
 	  // Temperature page for 5 sensors plus the comma delimiters for
 	  // the if DS18B20 mode is enabled. The  possible nParsedNum values
@@ -7714,7 +8253,7 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
 
 
 #if BME280_SUPPORT == 1
-        else if ((nParsedMode == 't') && (nParsedNum == 5) && (stored_config_settings & 0x20)) {
+        if ((nParsedNum == 5) && (stored_config_settings & 0x20)) {
 	  // This displays temperature, pressure, and humidity data from the
 	  // BME280 sensor and the text fields around that data IF BME280
 	  // mode is enabled. It also shows the user entered altitude.
@@ -7728,7 +8267,7 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
 
 
 #if INA226_SUPPORT == 1
-        else if ((nParsedMode == 't') && (nParsedNum > 5) && (nParsedNum < 11)) {
+        if ((nParsedNum > 5) && (nParsedNum < 11)) {
 	  // This displays Current, Voltage, and Wattage data from the
 	  // INA226-1 sensor. Also shows the text fields around that data.
 	  // %txx
@@ -7746,10 +8285,12 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
           pBuffer = show_INA226_CVW_string(pBuffer);
 	}
 #endif // INA226_SUPPORT == 1
+        break;
+#endif // DS18B20_SUPPORT == 1 || BME280_SUPPORT == 1 || INA226_SUPPORT == 1
 
 
 #if DOMOTICZ_SUPPORT == 1
-        else if (nParsedMode == 'T') {
+        case 'T': {
 	  // For DS18B20 this displays the Serial Number (MAC) of up to 5
 	  // devices. If a device does not exist "------------" is displayed.
 	  // For BME280 there is no serial number so this simply displays
@@ -7796,10 +8337,11 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
 	    pBuffer = stpcpy(pBuffer, Sensor_IDX[nParsedNum - 20]);
 	  }
         }
+        break;
 #endif // DOMOTICZ_SUPPORT == 1
 
 
-        else if (nParsedMode == 'w') {
+        case 'w': {
 	  // This displays Code Revision information (13 characters) plus Code
 	  // Type (23 characters, '.' characters are added to make sure the
 	  // length is always 23)
@@ -7866,9 +8408,10 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
             else pBuffer = stpcpy(pBuffer, "0");
 	  }
 	}
+        break;
 
 
-        else if (nParsedMode == 'y') {
+        case 'y': {
           // Indicates the need to insert one of several commonly occuring HTML
           // strings. These strings were created to aid in compressing the web
 	  // page templates stored in flash memory by storing the strings once,
@@ -7941,6 +8484,8 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
 	  if (pSocket->insertion_index == ps[nParsedNum].size) pSocket->insertion_index = 0;
           pBuffer++;
 	}
+        break;
+        }
       }
 
 
@@ -7974,8 +8519,85 @@ uint8_t FoundROM[5][8];             // Table of ROM codes
     }
     else break;
   }
-  return (pBuffer - pBuffer_start);
+#if HTTPD_CHUNKED_TRANSFER == 1
+  // Fill in the chunk-size line as 3 hex digits. The chunk data is
+  // everything after the 5 byte chunk-size line.
+#if HTTPD_TX_WRITE_THROUGH == 1
+  nChunkSize = (uint16_t)(nFlushed + (pBuffer - pBuffer_start) - 5);
+#else // HTTPD_TX_WRITE_THROUGH == 0
+  nChunkSize = (uint16_t)((pBuffer - pBuffer_start) - 5);
+#endif // HTTPD_TX_WRITE_THROUGH == 1
+  emb_itoa(nChunkSize, OctetArray, 16, 3);
+  OctetArray[3] = '\r';
+  OctetArray[4] = '\n';
+  // End the chunk, and end the page if the template is complete. This is
+  // regenerated the same way if the segment is retransmitted.
+  if (*pDataLeft == 0) nChunkEnd = 7;
+  else nChunkEnd = 2;
+  if (nChunkSize == 0) {
+    // A chunk of size 0 is the last-chunk, so an empty chunk is never sent
+    // before the end of the page. If the page is complete the chunk-size
+    // line is replaced by the "0\r\n\r\n" last-chunk. Otherwise the chunk
+    // is dropped and the segment carries no data.
+    nChunkEnd = 0;
+    if (*pDataLeft == 0) memcpy(OctetArray, &chunk_end[2], 5);
+    else pBuffer = pBuffer_start;
+  }
+#if HTTPD_TX_WRITE_THROUGH == 1
+  // If the start of the chunk was already written to the ENC28J60 the
+  // chunk-size line is patched in the transmit buffer.
+  if (nFlushed == 0) {
+    if (pBuffer != pBuffer_start) memcpy(pBuffer_start, OctetArray, 5);
+  }
+#if HTTPD_COALESCE_HEADER == 1
+  else Enc28j60TxDataPatch(nPrefix, (uint8_t*)OctetArray, 5);
+#else // HTTPD_COALESCE_HEADER == 0
+  else Enc28j60TxDataPatch(0, (uint8_t*)OctetArray, 5);
+#endif // HTTPD_COALESCE_HEADER == 1
+#else // HTTPD_TX_WRITE_THROUGH == 0
+  if (pBuffer != pBuffer_start) memcpy(pBuffer_start, OctetArray, 5);
+#endif // HTTPD_TX_WRITE_THROUGH == 1
+
+#if HTTPD_TX_WRITE_THROUGH == 0
+  memcpy(pBuffer, chunk_end, nChunkEnd);
+  pBuffer = pBuffer + nChunkEnd;
+#endif // HTTPD_TX_WRITE_THROUGH == 0
+#endif // HTTPD_CHUNKED_TRANSFER == 1
+
+#if HTTPD_TX_WRITE_THROUGH == 1
+  // Write whatever remains in the staging area to the ENC28J60
+  Enc28j60TxDataWrite(pBuffer_start, (uint16_t)(pBuffer - pBuffer_start));
+#if HTTPD_CHUNKED_TRANSFER == 1
+  // The chunk end is written separately so it can not overrun the staging
+  // area
+  Enc28j60TxDataWrite((uint8_t*)chunk_end, nChunkEnd);
+  nFlushed = nFlushed + nChunkEnd;
+#endif // HTTPD_CHUNKED_TRANSFER == 1
+  return (nFlushed + (pBuffer - pBuffer_start));
+#else // HTTPD_TX_WRITE_THROUGH == 0
+  return (pBuffer - pBuffer_start);
+#endif // HTTPD_TX_WRITE_THROUGH == 1
+}
+
+
+#if HTTPD_COALESCE_HEADER == 1
+static uint16_t CopyHttpHeaderData(struct tHttpD* pSocket)
+{
+  // Copy the header of the response to the uip_buf followed by as much of
+  // the page as fits in the rest of the segment. Used for the first
+  // segment of a response and for a retransmit of it. CopyHttpData()
+  // reserves 40 bytes (more with HTTPD_CHUNKED_TRANSFER) of the space it is
+  // given, so no data is added if the header leaves less than 100 bytes.
+  // Returns the number of bytes copied.
+  uint16_t nBytes;
+  
+  nBytes = CopyHttpPageHeader(uip_appdata, pSocket);
+  if (pSocket->nDataLeft != 0 && uip_mss() > (uint16_t)(nBytes + 100)) {
+    nBytes += CopyHttpData((uint8_t *)uip_appdata + nBytes, &pSocket->pData, &pSocket->nDataLeft, (uint16_t)(uip_mss() - nBytes), pSocket);
+  }
+  return nBytes;
 }
+#endif // HTTPD_COALESCE_HEADER == 1
 
 
 #if DS18B20_SUPPORT == 1
@@ -8031,7 +8653,6 @@ char *show_BME280_PTH_string(char *pBuffer)
 {
   int32_t temp_whole;
   int32_t temp_dec;
-  int32_t temp_F;
   
   pBuffer = stpcpy(pBuffer, "<p>BME280 Sensor<br>");
   
@@ -8057,27 +8678,10 @@ char *show_BME280_PTH_string(char *pBuffer)
   pBuffer = stpcpy(pBuffer, TEMPTEXT);     // Display degress C symbol plus space
   #undef TEMPTEXT
 
-  // Convert C to F
-  // Note: Value directly out of the sensor is temperature in Degree C times
-  // 100.
-  temp_F = (int32_t)((comp_data_temperature * 9) / 5) + 3200;
-  // Calculate the whole number part of number
-  temp_whole = (temp_F / 100);
-  // Calculate decimal part of number
-  temp_dec = temp_F - (temp_whole * 100);
-  
-  if (temp_F < 0) {
-    pBuffer = stpcpy(pBuffer, "-");        // Insert minus sign
-  }
-  else {
-    pBuffer = stpcpy(pBuffer, " ");        // Insert space
-  }
-
-  emb_itoa((uint32_t)temp_whole, OctetArray, 10, 3);
-  pBuffer = stpcpy(pBuffer, OctetArray);   // Display sensor value
-  pBuffer = stpcpy(pBuffer, ".");          // Insert decimal dot
-  emb_itoa((uint32_t)temp_dec, OctetArray, 10, 2);
-  pBuffer = stpcpy(pBuffer, OctetArray);   // Display sensor value
+  // Display temperature in degrees F
+  // Convert BME280 temperature to string in OctetArray
+  BME280_temperature_string_F();
+  pBuffer = stpcpy(pBuffer, OctetArray);   // Copy temperature string to Browser
   #define TEMPTEXT "&#8457;<br>"
   pBuffer = stpcpy(pBuffer, TEMPTEXT);     // Display degress F symbol plus newline
   #undef TEMPTEXT
@@ -8268,6 +8872,13 @@ void BME280_temperature_string_C(void)
   int32_t temp_dec;
   char temp_string[11];
   
+#if SENSOR_STRING_CACHE == 1
+  if (BME280_string_valid) {
+    strcpy(OctetArray, BME280_string[0]);
+    return;
+  }
+#endif // SENSOR_STRING_CACHE == 1
+
   // Calculate the whole number part of number
   temp_whole = (comp_data_temperature / 100);
   // Calculate decimal part of number
@@ -8299,6 +8910,52 @@ void BME280_temperature_string_C(void)
 #endif // BME280_SUPPORT == 1
 
 
+#if BME280_SUPPORT == 1
+void BME280_temperature_string_F(void)
+{
+  // Convert the BME280 temperature into a string in OctetArray in
+  // degrees F.
+  
+  int32_t temp_whole;
+  int32_t temp_dec;
+  int32_t temp_F;
+  char temp_string[11];
+  
+#if SENSOR_STRING_CACHE == 1
+  if (BME280_string_valid) {
+    strcpy(OctetArray, BME280_string[1]);
+    return;
+  }
+#endif // SENSOR_STRING_CACHE == 1
+
+  // Convert C to F
+  // Note: Value directly out of the sensor is temperature in Degree C times
+  // 100.
+  temp_F = (int32_t)((comp_data_temperature * 9) / 5) + 3200;
+  // Calculate the whole number part of number
+  temp_whole = (temp_F / 100);
+  // Calculate decimal part of number
+  temp_dec = temp_F - (temp_whole * 100);
+  
+  if (temp_F < 0) temp_string[0] = '-';    // Insert minus sign
+  else temp_string[0] = ' ';               // Insert space
+
+  emb_itoa((uint32_t)temp_whole, OctetArray, 10, 3);
+  temp_string[1] = OctetArray[0];
+  temp_string[2] = OctetArray[1];
+  temp_string[3] = OctetArray[2];
+  temp_string[4] = '.';
+  
+  emb_itoa((uint32_t)temp_dec, OctetArray, 10, 2);
+  temp_string[5] = OctetArray[0];
+  temp_string[6] = OctetArray[1];
+  temp_string[7] = '\0';
+  
+  strcpy(OctetArray, temp_string);
+}
+#endif // BME280_SUPPORT == 1
+
+
 #if BME280_SUPPORT == 1
 void BME280_pressure_string(void)
 {
@@ -8306,6 +8963,13 @@ void BME280_pressure_string(void)
   
   int32_t press_whole;
   
+#if SENSOR_STRING_CACHE == 1
+  if (BME280_string_valid) {
+    strcpy(OctetArray, BME280_string[2]);
+    return;
+  }
+#endif // SENSOR_STRING_CACHE == 1
+
   // Pressure range is 300 to 1100 hPa.
   press_whole = altitude_adjustment();
   emb_itoa((uint32_t)press_whole, OctetArray, 10, 4);
@@ -8320,6 +8984,13 @@ void BME280_humidity_string(void)
   
   int32_t hum_whole;
   
+#if SENSOR_STRING_CACHE == 1
+  if (BME280_string_valid) {
+    strcpy(OctetArray, BME280_string[3]);
+    return;
+  }
+#endif // SENSOR_STRING_CACHE == 1
+
   // Pressure range is 300 to 1100 hPa.
   hum_whole = (int32_t)(comp_data_humidity / 1024);
   emb_itoa((uint32_t)hum_whole, OctetArray, 10, 3);
@@ -8327,6 +8998,27 @@ void BME280_humidity_string(void)
 #endif // BME280_SUPPORT == 1
 
 
+#if BME280_SUPPORT == 1 && SENSOR_STRING_CACHE == 1
+void cache_BME280_strings(void)
+{
+  // Format the BME280 value strings once after the sensor data is
+  // compensated (and after the altitude used for the pressure string
+  // changes). The web pages and MQTT publishes then copy the cached
+  // strings.
+  BME280_string_valid = 0;
+  BME280_temperature_string_C();
+  strcpy(BME280_string[0], OctetArray);
+  BME280_temperature_string_F();
+  strcpy(BME280_string[1], OctetArray);
+  BME280_pressure_string();
+  strcpy(BME280_string[2], OctetArray);
+  BME280_humidity_string();
+  strcpy(BME280_string[3], OctetArray);
+  BME280_string_valid = 1;
+}
+#endif // BME280_SUPPORT == 1 && SENSOR_STRING_CACHE == 1
+
+
 #if BME280_SUPPORT == 1
 char *show_space_or_minus(int32_t value, char *pBuffer)
 {
@@ -8353,6 +9045,19 @@ void HttpDInit(void)
   // Initialize storage for the GET command
   parse_GETcmd[0] = '\0';
 
+#if PAGE_STATISTICS == 1
+  page_stats_init();
+#endif // PAGE_STATISTICS == 1
+
+#if HTTPD_PAGE_CACHE == 1
+  page_cache_invalidate();
+#endif // HTTPD_PAGE_CACHE == 1
+
+#if COMMAND_RATE_LIMIT == 1
+  // Unused buckets are full so they are the first to be reused
+  for (i = 0; i < RATE_SOURCES; i++) rate_tokens[i] = COMMAND_RATE_BURST;
+#endif // COMMAND_RATE_LIMIT == 1
+
   // Start listening on our port
   // Removed "htons" code to reduce Flash usage. This can be done as the SMT8
   // is "Big Endian". Keep the commented code in case the application is
@@ -8362,6 +9067,44 @@ void HttpDInit(void)
 }
 
 
+#if COMMAND_RATE_LIMIT == 1
+uint8_t http_rate_take(void)
+{
+  // Take a token from the bucket of the Browser that sent the current
+  // request. Returns 1 if the request may be processed, 0 if the bucket is
+  // empty. A Browser without a bucket gets the fullest bucket, which is
+  // the one of the Browser that has been quiet the longest.
+  uint8_t i;
+  uint8_t slot;
+
+  slot = 0;
+  for (i = 0; i < RATE_SOURCES; i++) {
+    if (uip_ipaddr_cmp(rate_ipaddr[i], uip_conn->ripaddr)) break;
+    if (rate_tokens[i] > rate_tokens[slot]) slot = i;
+  }
+  if (i == RATE_SOURCES) {
+    i = slot;
+    uip_ipaddr_copy(rate_ipaddr[i], uip_conn->ripaddr);
+    rate_tokens[i] = COMMAND_RATE_BURST;
+  }
+  if (rate_tokens[i] == 0) return 0;
+  rate_tokens[i]--;
+  return 1;
+}
+
+
+void http_rate_refill(void)
+{
+  // Add one token to each Browser bucket. Called by command_rate_tick().
+  uint8_t i;
+
+  for (i = 0; i < RATE_SOURCES; i++) {
+    if (rate_tokens[i] < COMMAND_RATE_BURST) rate_tokens[i]++;
+  }
+}
+#endif // COMMAND_RATE_LIMIT == 1
+
+
 // void init_tHttpD_struct(struct tHttpD* pSocket, int i) {
 void init_tHttpD_struct(struct tHttpD* pSocket) {
   // Initialize the contents of the struct tHttpD
@@ -8372,9 +9115,273 @@ void init_tHttpD_struct(struct tHttpD* pSocket) {
   pSocket->ParseState = PARSE_NULL;
   pSocket->nNewlines = 0;
   pSocket->insertion_index = 0;
+#if HTTPD_KEEP_ALIVE > 0
+  pSocket->KeepAlive = 0;
+#endif // HTTPD_KEEP_ALIVE > 0
+#if PAGE_STATISTICS == 1
+  pSocket->StatSlot = PSTAT_NONE;
+#endif // PAGE_STATISTICS == 1
+}
+
+
+void save_checkpoint(struct tHttpD* pSocket, struct tHttpDCheckpoint* pCheckpoint)
+{
+  // Save the CopyHttpData() state before a segment is generated so that the
+  // same segment can be generated again for a retransmit.
+  pCheckpoint->pData = pSocket->pData;
+  pCheckpoint->nDataLeft = pSocket->nDataLeft;
+#if OB_EEPROM_SUPPORT == 1
+  pCheckpoint->eeprom_index = off_board_eeprom_index;
+#endif // OB_EEPROM_SUPPORT == 1
+  pCheckpoint->insertion_index = pSocket->insertion_index;
+  pCheckpoint->ParseCmd = pSocket->ParseCmd;
+  pCheckpoint->ParseNum = pSocket->ParseNum;
+#if HTTPD_COALESCE_HEADER == 1
+  pCheckpoint->Header = 0;
+#endif // HTTPD_COALESCE_HEADER == 1
+}
+
+
+void restore_checkpoint(struct tHttpD* pSocket, struct tHttpDCheckpoint* pCheckpoint)
+{
+  // Return the CopyHttpData() state to a saved checkpoint.
+  pSocket->pData = pCheckpoint->pData;
+  pSocket->nDataLeft = pCheckpoint->nDataLeft;
+#if OB_EEPROM_SUPPORT == 1
+  off_board_eeprom_index = pCheckpoint->eeprom_index;
+#endif // OB_EEPROM_SUPPORT == 1
+  pSocket->insertion_index = pCheckpoint->insertion_index;
+  pSocket->ParseCmd = pCheckpoint->ParseCmd;
+  pSocket->ParseNum = pCheckpoint->ParseNum;
+}
+
+
+#if HTTPD_PAGE_CACHE == 1
+void page_cache_invalidate(void)
+{
+  // Empty the page cache. Called when the settings shown on the cached pages
+  // may have changed.
+  page_cache_page = WEBPAGE_NULL;
+  page_cache_count = 0;
+  page_cache_used = 0;
+}
+
+
+static uint8_t page_cacheable(uint8_t webpage)
+{
+  // Returns 1 if the webpage only shows settings and status that invalidate
+  // the page cache when they change. Pages with pin states and sensor
+  // readings are always rendered.
+  if (webpage == WEBPAGE_CONFIGURATION) return 1;
+#if PCF8574_SUPPORT == 1
+#if DOMOTICZ_SUPPORT == 0
+  if (webpage == WEBPAGE_PCF8574_CONFIGURATION) return 1;
+#endif // DOMOTICZ_SUPPORT == 0
+#endif // PCF8574_SUPPORT == 1
+  return 0;
+}
+
+
+static uint8_t page_cache_key(struct tHttpD* pSocket)
+{
+  // Returns 1 if the page cache holds segments of the page the connection
+  // is sending, cut to the same size and showing the same MQTT status.
+  return (uint8_t)(page_cache_page == pSocket->current_webpage
+                && page_cache_mss == uip_mss()
+		&& page_cache_status == mqtt_start_status
+		&& page_cache_error == MQTT_error_status);
+}
+
+
+static uint8_t page_cache_same(struct tHttpDCheckpoint* pCheckpoint1, struct tHttpDCheckpoint* pCheckpoint2)
+{
+  // Returns 1 if the two checkpoints are the same template position,
+  // including the position in an interrupted insertion.
+  return (uint8_t)(pCheckpoint1->pData == pCheckpoint2->pData
+                && pCheckpoint1->nDataLeft == pCheckpoint2->nDataLeft
+#if OB_EEPROM_SUPPORT == 1
+                && pCheckpoint1->eeprom_index == pCheckpoint2->eeprom_index
+#endif // OB_EEPROM_SUPPORT == 1
+                && pCheckpoint1->insertion_index == pCheckpoint2->insertion_index);
+}
+
+
+static uint16_t page_cache_load(struct tHttpD* pSocket, struct tHttpDCheckpoint* pCheckpoint)
+{
+  // If the segment that starts at pCheckpoint is in the page cache it is
+  // copied to the transmit buffer and the CopyHttpData() state is moved to
+  // the end of the segment. Returns the length of the segment, or 0 if it
+  // has to be rendered.
+  uint8_t i;
+  uint16_t nOffset;
+
+  if (!page_cache_key(pSocket)) return 0;
+  nOffset = 0;
+  for (i = 0; i < page_cache_count; i++) {
+    if (page_cache_same(pCheckpoint, &page_cache_at[i])) {
+      Enc28j60CacheLoad(nOffset, page_cache_len[i]);
+      restore_checkpoint(pSocket, &page_cache_at[i + 1]);
+      return page_cache_len[i];
+    }
+    nOffset += page_cache_len[i];
+  }
+  return 0;
+}
+
+
+static void page_cache_store(struct tHttpD* pSocket, struct tHttpDCheckpoint* pCheckpoint, uint16_t nBytes)
+{
+  // Add the segment just rendered from pCheckpoint to the page cache if it
+  // follows the last cached segment. A different page, a changed MQTT
+  // status, or a segment from earlier in the page than the first cached
+  // one starts the cache over, so the cache fills from the start of the
+  // page. Segments that do not fit are rendered on every load.
+  if (nBytes == 0 || !page_cacheable(pSocket->current_webpage)) return;
+  if (!page_cache_key(pSocket)
+   || (page_cache_count != 0 && pCheckpoint->nDataLeft > page_cache_at[0].nDataLeft)) {
+    page_cache_invalidate();
+    page_cache_page = pSocket->current_webpage;
+    page_cache_mss = uip_mss();
+    page_cache_status = mqtt_start_status;
+    page_cache_error = MQTT_error_status;
+  }
+  if (page_cache_count == 0) page_cache_at[0] = *pCheckpoint;
+  else if (!page_cache_same(pCheckpoint, &page_cache_at[page_cache_count])) return;
+  if (page_cache_count >= PAGE_CACHE_SEGMENTS) return;
+  if (page_cache_used + nBytes > ENC28J60_CACHESIZE) return;
+
+  Enc28j60CacheStore(page_cache_used);
+  page_cache_len[page_cache_count] = nBytes;
+  page_cache_used += nBytes;
+  page_cache_count++;
+  save_checkpoint(pSocket, &page_cache_at[page_cache_count]);
+}
+#endif // HTTPD_PAGE_CACHE == 1
+
+
+#if PAGE_STATISTICS == 1
+void page_stats_init(void)
+{
+  // Clear the page statistics
+  memset(page_stats, 0, sizeof(page_stats));
+}
+
+
+void page_stats_begin(struct tHttpD* pSocket)
+{
+  // Start counting a response. Called when the 200 header is sent. The
+  // webpage group is found from the current_webpage.
+  uint8_t slot;
+
+  slot = PSTAT_OTHER;
+  if (pSocket->current_webpage == WEBPAGE_IOCONTROL) {
+    slot = PSTAT_IOCONTROL;
+  }
+  else if (pSocket->current_webpage == WEBPAGE_CONFIGURATION) {
+    slot = PSTAT_CONFIGURATION;
+  }
+#if PCF8574_SUPPORT == 1 && DOMOTICZ_SUPPORT == 0
+  else if (pSocket->current_webpage == WEBPAGE_PCF8574_IOCONTROL) {
+    slot = PSTAT_IOCONTROL;
+  }
+  else if (pSocket->current_webpage == WEBPAGE_PCF8574_CONFIGURATION) {
+    slot = PSTAT_CONFIGURATION;
+  }
+#endif // PCF8574_SUPPORT == 1 && DOMOTICZ_SUPPORT == 0
+#if HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0
+  else if (pSocket->current_webpage >= WEBPAGE_SCRIPT) {
+    slot = PSTAT_SCRIPT;
+  }
+#endif // HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0
+  else if (pSocket->current_webpage == WEBPAGE_SSTATE) {
+    slot = PSTAT_SHORT;
+  }
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD && SHORT_TEMPERATURE_SUPPORT == 1
+  else if (pSocket->current_webpage == WEBPAGE_SHORT_TEMPERATURE) {
+    slot = PSTAT_SHORT;
+  }
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD && SHORT_TEMPERATURE_SUPPORT == 1
+#if HTTPD_STATUS_RECORD == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+  else if (pSocket->current_webpage == WEBPAGE_STATUS) {
+    slot = PSTAT_SHORT;
+  }
+#endif // HTTPD_STATUS_RECORD == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+
+  pSocket->StatSlot = slot;
+  pSocket->StatStart = ms_counter;
+  page_stats[slot].requests++;
+}
+
+
+void page_stats_send(struct tHttpD* pSocket, uint16_t nBytes)
+{
+  // Count a segment of the response, first transmission only. If the
+  // segment count reaches its limit all counts and sums of the group are
+  // halved so the averages and ratios keep following recent behavior.
+  struct tPageStats* pStats;
+
+  if (pSocket->StatSlot == PSTAT_NONE) return;
+  pStats = &page_stats[pSocket->StatSlot];
+  if (pStats->segments >= 0xff00) {
+    pStats->requests >>= 1;
+    pStats->loads >>= 1;
+    pStats->segments >>= 1;
+    pStats->rexmits >>= 1;
+    pStats->bytes >>= 1;
+    pStats->time_sum >>= 1;
+  }
+  pStats->segments++;
+  pStats->bytes += nBytes;
+}
+
+
+void page_stats_end(struct tHttpD* pSocket)
+{
+  // Complete a response. Called when the last data has been acknowledged.
+  struct tPageStats* pStats;
+  uint16_t load_time;
+
+  if (pSocket->StatSlot == PSTAT_NONE) return;
+  pStats = &page_stats[pSocket->StatSlot];
+  load_time = (uint16_t)(ms_counter - pSocket->StatStart);
+  pStats->loads++;
+  pStats->time_sum += load_time;
+  if (load_time > pStats->time_max) pStats->time_max = load_time;
+  pSocket->StatSlot = PSTAT_NONE;
 }
 
 
+char *page_stats_format(uint8_t slot, char *pBuffer)
+{
+  // Write the statistics of a webpage group to pBuffer as "requests loads
+  // segments rexmits bytes avg max", the bytes as 8 decimal digits and the
+  // other values as 5 decimal digits (44 characters). Returns a pointer to
+  // the terminating NULL.
+  struct tPageStats* pStats;
+  uint16_t avg;
+
+  pStats = &page_stats[slot];
+  avg = 0;
+  if (pStats->loads) avg = (uint16_t)(pStats->time_sum / pStats->loads);
+
+  emb_itoa(pStats->requests, pBuffer, 10, 5);
+  pBuffer[5] = ' ';
+  emb_itoa(pStats->loads, pBuffer + 6, 10, 5);
+  pBuffer[11] = ' ';
+  emb_itoa(pStats->segments, pBuffer + 12, 10, 5);
+  pBuffer[17] = ' ';
+  emb_itoa(pStats->rexmits, pBuffer + 18, 10, 5);
+  pBuffer[23] = ' ';
+  emb_itoa(pStats->bytes, pBuffer + 24, 10, 8);
+  pBuffer[32] = ' ';
+  emb_itoa(avg, pBuffer + 33, 10, 5);
+  pBuffer[38] = ' ';
+  emb_itoa(pStats->time_max, pBuffer + 39, 10, 5);
+  return pBuffer + 44;
+}
+#endif // PAGE_STATISTICS == 1
+
+
 void HttpDCall(uint8_t* pBuffer, uint16_t nBytes, struct tHttpD* pSocket)
 {
   uint16_t nBufSize;
@@ -8445,6 +9452,12 @@ rexmit_count = 0; // Used only for sending the rexmit count via UART
 #endif // DEBUG_SUPPORT == 15
 
     pSocket->nState = STATE_CONNECTED;
+#if HTTPD_KEEP_ALIVE > 0
+    pSocket->KeepAlive = 0;
+#endif // HTTPD_KEEP_ALIVE > 0
+#if PAGE_STATISTICS == 1
+    pSocket->StatSlot = PSTAT_NONE;
+#endif // PAGE_STATISTICS == 1
   }
 
   else if (uip_acked()) {
@@ -8472,6 +9485,40 @@ rexmit_count = 0; // Used only for sending the rexmit count via UART
     goto senddata;
   }
   
+#if HTTPD_TX_WINDOW > 1
+  else if (uip_poll() && uip_segments() != 0) {
+    // uip polls with segments in flight when the transmit window has room
+    // for another segment. Send the next segment without waiting for the
+    // earlier segments to be acknowledged.
+    goto senddata;
+  }
+#endif // HTTPD_TX_WINDOW > 1
+
+#if HTTPD_KEEP_ALIVE > 0
+  else if (uip_poll() && pSocket->nState == STATE_CONNECTED && pSocket->KeepAlive) {
+    // A persistent connection is waiting for the next request. Close it if
+    // it has been idle for HTTPD_KEEP_ALIVE seconds so that it does not hold
+    // one of the UIP_CONNS connections indefinitely.
+    if ((uint8_t)((uint8_t)second_counter - pSocket->IdleStart) >= HTTPD_KEEP_ALIVE) {
+      pSocket->KeepAlive = 0;
+      uip_close();
+    }
+  }
+#endif // HTTPD_KEEP_ALIVE > 0
+
+#if HTTPD_LONG_POLL > 0 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+  else if (uip_poll() && pSocket->nState == STATE_LONGPOLL) {
+    // A /95 request is being held. Send the Status Record as soon as a pin
+    // or sensor reading changes, or after HTTPD_LONG_POLL seconds so that
+    // the client knows the connection is still alive.
+    if (live_signature() != pSocket->LongPollSig
+     || (uint8_t)((uint8_t)second_counter - pSocket->IdleStart) >= HTTPD_LONG_POLL) {
+      pSocket->nState = STATE_SENDHEADER200;
+      goto sendheader;
+    }
+  }
+#endif // HTTPD_LONG_POLL > 0 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+
   else if (uip_newdata()) {
     // This is a "receive data from the Browser" function, including the
     // receipt of the very first connection request.
@@ -8485,6 +9532,12 @@ rexmit_count = 0; // Used only for sending the rexmit count via UART
 // }
 #endif // DEBUG_SUPPORT == 15
 
+#if RUNTIME_UPLOAD == 1
+    // Every segment the file POST receives keeps its ownership of the
+    // parse_tail alive (see upload_busy()).
+    if (pSocket == upload_owner) upload_time_last = second_counter;
+#endif // RUNTIME_UPLOAD == 1
+
     //
     // This is the start of a new Browser session, or it is additional packets
     // received to complete a transmission from the Browser.
@@ -8571,21 +9624,63 @@ rexmit_count = 0; // Used only for sending the rexmit count via UART
     if (pSocket->nState == STATE_CONNECTED) {
       if (memcmp("POST", &pBuffer[0], 4) == 0) pSocket->nState = STATE_GOTPOST;
       if (memcmp("GET", &pBuffer[0], 3) == 0)  pSocket->nState = STATE_GOTGET;
+#if RUNTIME_UPLOAD == 1
+      // A POST to /86 carries a firmware file. While a file POST owns the
+      // parse_tail every other POST is thrown away with a 429 response.
+      if (pSocket->nState == STATE_GOTPOST) {
+        if (upload_busy()) {
+          pSocket->nState = STATE_SENDHEADER429;
+          pSocket->nDataLeft = 0;
+        }
+        else if (memcmp("POST /86", &pBuffer[0], 8) == 0
+              && (pBuffer[8] == ' ' || pBuffer[8] == '?')) {
+          pSocket->nState = STATE_GOTFILE;
+          upload_owner = pSocket;
+          upload_time_last = second_counter;
+          upload_staged = 0;
+          // The expected CRC of the S3 data bytes is carried in the URL as
+          // /86?XXXX (4 hex digits, see mkprovision.py --sx-crc). The image
+          // is only staged if it matches.
+          upload_crc_expected = 0x10000;
+          if (pBuffer[8] == '?'
+           && isxdigit(pBuffer[9]) && isxdigit(pBuffer[10])
+           && isxdigit(pBuffer[11]) && isxdigit(pBuffer[12])
+           && pBuffer[13] == ' ') {
+            upload_crc_expected = ((uint16_t)SREC_HEX2BYTE(pBuffer[9], pBuffer[10]) << 8)
+                                | SREC_HEX2BYTE(pBuffer[11], pBuffer[12]);
+          }
+        }
+      }
+#endif // RUNTIME_UPLOAD == 1
+#if HTTPD_KEEP_ALIVE > 0
+      // Only a GET leaves the connection open after the response. A POST
+      // changes settings, so its connection is always closed.
+      pSocket->KeepAlive = (uint8_t)(pSocket->nState == STATE_GOTGET);
+#endif // HTTPD_KEEP_ALIVE > 0
       pBuffer += 4;
       nBytes -= 4;
       // We are collecting the first packet. Clear parse_tail so it will be
       // ready if there is a TCP Fragment.
+#if RUNTIME_UPLOAD == 0
       parse_tail[0] = '\0';
+#endif // RUNTIME_UPLOAD == 0
+#if RUNTIME_UPLOAD == 1
+      // But not while a file POST on another connection is using it.
+      if (upload_busy() == 0 || upload_owner == pSocket) parse_tail[0] = '\0';
+#endif // RUNTIME_UPLOAD == 1
 
 #if BUILD_SUPPORT == CODE_UPLOADER_BUILD
       // Initialize the find_content_info state. It is used to manage the
       // search for the Content-Type and Content-Length phrases.
       find_content_info = SEEK_CONTENT_INFO;
 #endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
+#if RUNTIME_UPLOAD == 1
+      if (pSocket->nState == STATE_GOTFILE) find_content_info = SEEK_CONTENT_INFO;
+#endif // RUNTIME_UPLOAD == 1
     }
     
 
-    if (pSocket->nState == STATE_GOTPOST) {
+    if (pSocket->nState == STATE_GOTPOST || pSocket->nState == STATE_GOTFILE) {
       // If this is a BROWSER_ONLY_BUILD or a MQTT_BUILD then the only kind of
       // POST we can receive is a "normal" POST consisting of values the user
       // entered in the GUI. If that is the case the data we want follows the
@@ -8595,7 +9690,8 @@ rexmit_count = 0; // Used only for sending the rexmit count via UART
       // file. If that is the case the data we want follows the second
       // \r\n\r\n sequence in the html body. Note that we need to search the
       // html pre-amble for the "Content-Length" when running a Code Uploader
-      // build.
+      // build. A runtime build with BACKGROUND_UPLOAD receives file POSTs
+      // too, in STATE_GOTFILE.
       if (nBytes == 0) {
         // If we enter the search at end of fragment we exit and will come
 	// back to this point with the next fragment.
@@ -8604,7 +9700,7 @@ rexmit_count = 0; // Used only for sending the rexmit count via UART
 
 
 #if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-      while (nBytes != 0) {
+      while ((nBytes != 0) && (pSocket->nState == STATE_GOTPOST)) {
 	// The following searches for the \r\n\r\n sequence
 	if (pSocket->nNewlines == 2) {
 	  // This handles the case where a TCP Fragmentation occured in the
@@ -8664,8 +9760,8 @@ rexmit_count = 0; // Used only for sending the rexmit count via UART
 #endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
 	
 
-#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
-      while (nBytes != 0) {
+#if SREC_UPLOAD == 1
+      while ((nBytes != 0) && (pSocket->nState == STATE_GOTFILE)) {
 	// Search for the "Content-Length: " phrase. We're processing the first
 	// packet but haven't found the phrase yet.
         if ((*pBuffer == 'C') && (find_content_info == SEEK_CONTENT_INFO)) {
@@ -8780,6 +9876,9 @@ rexmit_count = 0; // Used only for sending the rexmit count via UART
 	  non_sequential_detect = 0;
 	  SREC_start = 1;
           search_limit = 0;
+#if RUNTIME_UPLOAD == 1
+	  upload_crc = 0xffff;
+#endif // RUNTIME_UPLOAD == 1
 	  for (i=0; i<30; i++) {
 	    // Initialize the search compare buffer
 	    compare_buf[i] = 'z';
@@ -8805,12 +9904,21 @@ rexmit_count = 0; // Used only for sending the rexmit count via UART
           break;
 	}
       }
-#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
+#endif // SREC_UPLOAD == 1
 
     }
 
 
 
+#if COMMAND_RATE_LIMIT == 1
+    if (pSocket->nState == STATE_GOTGET && http_rate_take() == 0) {
+      // This Browser is sending requests faster than the rate limit. Throw
+      // the request away and return a 429 response.
+      pSocket->nState = STATE_SENDHEADER429;
+      pSocket->nDataLeft = 0;
+    }
+#endif // COMMAND_RATE_LIMIT == 1
+
     if (pSocket->nState == STATE_GOTGET && parse_GETcmd[0] != '\0') {
       // If we are in state GOTGET but we are already processing a GET Request
       // we need to throw away the new request and return a 429 response.
@@ -8840,6 +9948,9 @@ rexmit_count = 0; // Used only for sending the rexmit count via UART
       // already set properly for that location.
 //      pBuffer -= 19;
       pBuffer -= 11;
+#if HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0
+      pSocket->nEtagMatch = 0;
+#endif // HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0
       pSocket->nState = STATE_GOTGET2;
     }
 
@@ -8885,6 +9996,15 @@ rexmit_count = 0; // Used only for sending the rexmit count via UART
 	  }
           else if (*pBuffer == '\r') { }
           else pSocket->nNewlines = 0;
+#if HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0
+          // Look for the ETag of the page scripts. The Browser sends it in
+	  // an If-None-Match header line if it has the script cached.
+          if (pSocket->nEtagMatch < ETAG_SIZE) {
+            if (*pBuffer == etag_char(pSocket->nEtagMatch)) pSocket->nEtagMatch++;
+            else if (*pBuffer == '"') pSocket->nEtagMatch = 1;
+            else pSocket->nEtagMatch = 0;
+          }
+#endif // HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0
           pBuffer++;
           nBytes--;
           if (pSocket->nNewlines != 2 && nBytes == 0) {
@@ -8993,7 +10113,7 @@ rexmit_count = 0; // Used only for sending the rexmit count via UART
 
 
     
-#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
+#if SREC_UPLOAD == 1
     if (pSocket->nState == STATE_PARSEFILE) {
       // This step is entered if a POST containing a firmware file was
       // detected. The file contents will be copied to the I2C EEPROM,
@@ -9294,7 +10414,13 @@ rexmit_count = 0; // Used only for sending the rexmit count via UART
 		        I2C_write_byte(parse_tail[i]);
 		      }
                       I2C_stop();
-                      wait_timer(5000); // Wait 5ms
+                      // Wait for the write cycle to complete
+                      if (file_type == FILETYPE_PROGRAM) {
+                        I2C_ack_poll(I2C_EEPROM_R0_WRITE);
+                      }
+                      if (file_type == FILETYPE_STRING) {
+                        I2C_ack_poll(I2C_EEPROM_R2_WRITE);
+                      }
                       IWDG_KR = 0xaa; // Prevent the IWDG from firing.
                       // Validate data in I2C EEPROM
 	              if (file_type == FILETYPE_PROGRAM) {
@@ -9337,7 +10463,7 @@ rexmit_count = 0; // Used only for sending the rexmit count via UART
 	    
 	      if (byte_index == 2) {
 	        // Read the data count value
-                data_count = two_hex2int(byte_tail[0], byte_tail[1]);
+                data_count = SREC_HEX2BYTE(byte_tail[0], byte_tail[1]);
 	        // Start checksum
 	        checksum = data_count;
 	        byte_index = 4;
@@ -9373,7 +10499,7 @@ rexmit_count = 0; // Used only for sending the rexmit count via UART
 	    
 	      if (byte_index == 8 && file_type != FILETYPE_SEARCH) {
 	        // Capture the high order byte of the address value
-                temp_address = two_hex2int(byte_tail[0], byte_tail[1]);
+                temp_address = SREC_HEX2BYTE(byte_tail[0], byte_tail[1]);
 	        data_count--;
 	        checksum += (uint8_t)temp_address;
 	        temp_address = temp_address << 8;
@@ -9390,18 +10516,22 @@ rexmit_count = 0; // Used only for sending the rexmit count via UART
 	        // Capture the first byte of the file type
 	        // 'N' (0x4E) is a NetworkModule program file
 	        // 'S' (0x53) is a String File
-                if (two_hex2int(byte_tail[0], byte_tail[1]) == 0x4E) {
+                if (SREC_HEX2BYTE(byte_tail[0], byte_tail[1]) == 0x4E) {
 	          file_type = FILETYPE_PROGRAM;
 
 // UARTPrintf("file_type = FILETYPE_PROGRAM\r\n");
 	      
 	        }
-	        else if (two_hex2int(byte_tail[0], byte_tail[1]) == 0x53) {
+#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
+	        // A runtime build does not accept a String File as it would
+		// overwrite the webpage templates the runtime is using.
+	        else if (SREC_HEX2BYTE(byte_tail[0], byte_tail[1]) == 0x53) {
 	          file_type = FILETYPE_STRING;
 
 // UARTPrintf("file_type = FILETYPE_STRING\r\n");
 	      
                 }
+#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
 		else {
                   upgrade_failcode = UPGRADE_FAIL_INVALID_FILETYPE;
 #if DEBUG_SUPPORT == 15
@@ -9421,7 +10551,7 @@ rexmit_count = 0; // Used only for sending the rexmit count via UART
 	    
 	      if (byte_index == 10) {
 	        // Capture the low order byte of the address value
-                temp_address_low = two_hex2int(byte_tail[0], byte_tail[1]);
+                temp_address_low = SREC_HEX2BYTE(byte_tail[0], byte_tail[1]);
 	        data_count--;
 	        checksum += (uint8_t)temp_address_low;
 	        temp_address |= temp_address_low;
@@ -9504,7 +10634,13 @@ rexmit_count = 0; // Used only for sending the rexmit count via UART
 		          I2C_write_byte(parse_tail[i]);
 		        }
                         I2C_stop();
-                        wait_timer(5000); // Wait 5ms
+                        // Wait for the write cycle to complete
+                        if (file_type == FILETYPE_PROGRAM) {
+                          I2C_ack_poll(I2C_EEPROM_R0_WRITE);
+                        }
+                        if (file_type == FILETYPE_STRING) {
+                          I2C_ack_poll(I2C_EEPROM_R2_WRITE);
+                        }
                         IWDG_KR = 0xaa; // Prevent the IWDG from firing.
 			
                         // Validate data in I2C EEPROM
@@ -9572,35 +10708,53 @@ rexmit_count = 0; // Used only for sending the rexmit count via UART
 	    // This parse is entered knowing that the next two characters are a
 	    // data byte.
 	    while (1) {
-              // Read two characters from the SREC
-              pBuffer = read_two_characters(pBuffer);
-              if (byte_tail[0] == '\0') {
-	        // No characters were found. This can occur when an end of
-	        // packet occurs during a CRLF sequence. The read attempt will
-	        // have set file_nBytes to zero. Break out of the local while
-	        // loop so that the next packet will be read.
-	        break;
-	      }
-              if (byte_tail[1] == '\0') {
-                // We only found 1 character so we just read the last character
-	        // in this packet. The read_two_characters() function will have
-	        // set file_nBytes to zero. Break out of the local while loop so
-	        // the next packet will be read.
-                break;
+              if ((byte_tail[0] == '\0')
+               && (file_nBytes > 1)
+               && (pBuffer[0] > '\r')
+               && (pBuffer[1] > '\r')) {
+                // Both characters of the data byte are in this packet and
+                // neither is a CR or LF. Decode them directly from the
+                // packet.
+                data_value = SREC_HEX2BYTE(pBuffer[0], pBuffer[1]);
+                pBuffer += 2;
+                file_nBytes -= 2;
+                file_length -= 2;
               }
+              else {
+                // Read two characters from the SREC
+                pBuffer = read_two_characters(pBuffer);
+                if (byte_tail[0] == '\0') {
+                  // No characters were found. This can occur when an end of
+                  // packet occurs during a CRLF sequence. The read attempt will
+                  // have set file_nBytes to zero. Break out of the local while
+                  // loop so that the next packet will be read.
+                  break;
+                }
+                if (byte_tail[1] == '\0') {
+                  // We only found 1 character so we just read the last character
+                  // in this packet. The read_two_characters() function will have
+                  // set file_nBytes to zero. Break out of the local while loop so
+                  // the next packet will be read.
+                  break;
+                }
 	    
-	      // If we didn't break out then we successfully read two characters
-              data_value = two_hex2int(byte_tail[0], byte_tail[1]);
+	        // If we didn't break out then we successfully read two
+	        // characters
+                data_value = SREC_HEX2BYTE(byte_tail[0], byte_tail[1]);
+                // Clear byte_tail for subsequent reads
+                byte_tail[0] = '\0';
+                byte_tail[1] = '\0';
+              }
               checksum += data_value;
               data_count--;
-              // Clear byte_tail for subsequent reads
-              byte_tail[0] = '\0';
-              byte_tail[1] = '\0';
 	      
 	      if (data_count > 0) {
 	        // Copy data to parse_tail
 	        parse_tail[parse_index++] = data_value;
 	        address++; // Increment the incoming address counter
+#if RUNTIME_UPLOAD == 1
+	        upload_crc = crc_ccitt(upload_crc, &data_value, 1);
+#endif // RUNTIME_UPLOAD == 1
 	      }
 	      
 	      if (data_count == 0) {
@@ -9633,7 +10787,7 @@ rexmit_count = 0; // Used only for sending the rexmit count via UART
                     I2C_write_byte(parse_tail[i]);
                   }
                   I2C_stop();
-                  wait_timer(5000); // Wait 5ms
+                  I2C_ack_poll(I2C_EEPROM_R0_WRITE); // Wait for the write cycle to complete
                   IWDG_KR = 0xaa; // Prevent the IWDG from firing.
                   // Validate data in I2C EEPROM
                   prep_read(I2C_EEPROM_R0_WRITE, I2C_EEPROM_R0_READ, eeprom_address_index, 2);
@@ -9670,7 +10824,7 @@ rexmit_count = 0; // Used only for sending the rexmit count via UART
                     I2C_write_byte(parse_tail[i]);
                   }
                   I2C_stop();
-                  wait_timer(5000); // Wait 5ms
+                  I2C_ack_poll(I2C_EEPROM_R2_WRITE); // Wait for the write cycle to complete
                   IWDG_KR = 0xaa; // Prevent the IWDG from firing.
                   // Validate data in I2C EEPROM
                   prep_read(I2C_EEPROM_R2_WRITE, I2C_EEPROM_R2_READ, eeprom_address_index, 2);
@@ -9813,35 +10967,53 @@ rexmit_count = 0; // Used only for sending the rexmit count via UART
 	    // single incoming SREC.
 	    
 	    while (1) {
-              // Read two characters from the data line
-              pBuffer = read_two_characters(pBuffer);
-              if (byte_tail[0] == '\0') {
-	        // No characters were found. This can occur when an end of
-	        // packet occurs during a CRLF sequence. The read attempt will
-	        // have set file_nBytes to zero. Break out of the local while
-	        // loop so that the next packet will be read.
-	        break;
-	      }
-              if (byte_tail[1] == '\0') {
-                // We only found 1 character so we just read the last character
-	        // in this packet. The read_two_characters() function will have
-	        // set file_nBytes to zero. Break out of the local while loop so
-	        // the next packet will be read.
-                break;
+              if ((byte_tail[0] == '\0')
+               && (file_nBytes > 1)
+               && (pBuffer[0] > '\r')
+               && (pBuffer[1] > '\r')) {
+                // Both characters of the data byte are in this packet and
+                // neither is a CR or LF. Decode them directly from the
+                // packet.
+                data_value = SREC_HEX2BYTE(pBuffer[0], pBuffer[1]);
+                pBuffer += 2;
+                file_nBytes -= 2;
+                file_length -= 2;
+              }
+              else {
+                // Read two characters from the data line
+                pBuffer = read_two_characters(pBuffer);
+                if (byte_tail[0] == '\0') {
+                  // No characters were found. This can occur when an end of
+                  // packet occurs during a CRLF sequence. The read attempt will
+                  // have set file_nBytes to zero. Break out of the local while
+                  // loop so that the next packet will be read.
+                  break;
+                }
+                if (byte_tail[1] == '\0') {
+                  // We only found 1 character so we just read the last character
+                  // in this packet. The read_two_characters() function will have
+                  // set file_nBytes to zero. Break out of the local while loop so
+                  // the next packet will be read.
+                  break;
+                }
+	    
+	        // If we didn't break out then we successfully read two
+	        // characters
+                data_value = SREC_HEX2BYTE(byte_tail[0], byte_tail[1]);
+                // Clear byte_tail for subsequent reads
+                byte_tail[0] = '\0';
+                byte_tail[1] = '\0';
               }
-	    
-	      // If we didn't break out then we successfully read two characters
-              data_value = two_hex2int(byte_tail[0], byte_tail[1]);
               checksum += data_value;
 	      data_count--;
-              // Clear byte_tail for subsequent reads
-              byte_tail[0] = '\0';
-              byte_tail[1] = '\0';
 	      
 	      if (data_count > 0) {
 	        // Copy data to parse_tail
 	        parse_tail[parse_index++] = data_value;
 	        address++; // Increment the incoming address counter
+#if RUNTIME_UPLOAD == 1
+	        upload_crc = crc_ccitt(upload_crc, &data_value, 1);
+#endif // RUNTIME_UPLOAD == 1
 	      }
 	      
 	      if (data_count == 0) {
@@ -9882,7 +11054,13 @@ rexmit_count = 0; // Used only for sending the rexmit count via UART
                     I2C_write_byte(parse_tail[i]);
                   }
                   I2C_stop();
-                  wait_timer(5000); // Wait 5ms
+                  // Wait for the write cycle to complete
+                  if (file_type == FILETYPE_PROGRAM) {
+                    I2C_ack_poll(I2C_EEPROM_R0_WRITE);
+                  }
+                  if (file_type == FILETYPE_STRING) {
+                    I2C_ack_poll(I2C_EEPROM_R2_WRITE);
+                  }
                   IWDG_KR = 0xaa; // Prevent the IWDG from firing.
 		  
                   // Validate data in I2C EEPROM
@@ -10046,6 +11224,38 @@ rexmit_count = 0; // Used only for sending the rexmit count via UART
         } // End of main while loop
       }
     
+#if RUNTIME_UPLOAD == 1
+      if (pSocket->ParseState == PARSE_FILE_COMPLETE && upgrade_failcode != UPGRADE_OK) {
+        // A miscompare of the last block found while processing the S7
+	// record. The image is not staged.
+        pSocket->ParseState = PARSE_FILE_FAIL_EXIT;
+      }
+
+      if (pSocket->ParseState == PARSE_FILE_COMPLETE && file_type == FILETYPE_PROGRAM
+       && (uint32_t)upload_crc != upload_crc_expected) {
+        // The S3 data does not match the CRC the POST carried (or the POST
+	// carried none). The image is not staged.
+        upgrade_failcode = UPGRADE_FAIL_CRC;
+        pSocket->ParseState = PARSE_FILE_FAIL_EXIT;
+      }
+
+      if (pSocket->ParseState == PARSE_FILE_COMPLETE && file_type == FILETYPE_PROGRAM) {
+        // All data is now in I2C EEPROM Region 0. The running code is left
+	// alone until the user asks for the install with /87.
+	upload_staged = 1;
+        pSocket->nParseLeft = 0;
+	
+	pSocket->current_webpage = WEBPAGE_UPLOAD_STAGED;
+        pSocket->pData = g_HtmlPageUploadStaged;
+        pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageUploadStaged) - 1);
+	
+	// Send the response
+        pSocket->nState = STATE_SENDHEADER200;
+      }
+#endif // RUNTIME_UPLOAD == 1
+
+
+#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
       if (pSocket->ParseState == PARSE_FILE_COMPLETE && file_type == FILETYPE_PROGRAM) {
         // All data is now in I2C EEPROM Region 0. Signal the main.c loop to
 	// copy the data to Flash and display a Timer window to have the
@@ -10063,7 +11273,6 @@ rexmit_count = 0; // Used only for sending the rexmit count via UART
         pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageTimer) - 1);
 	
 	// Send the response
-        pSocket->nPrevBytes = 0xFFFF;
         pSocket->nState = STATE_SENDHEADER200;
       }
 
@@ -10079,9 +11288,9 @@ rexmit_count = 0; // Used only for sending the rexmit count via UART
         pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageUploadComplete) - 1);
 	
         // Send the response
-        pSocket->nPrevBytes = 0xFFFF;
         pSocket->nState = STATE_SENDHEADER200;
       }
+#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
 
 
       if ((file_length < 2)
@@ -10115,11 +11324,10 @@ rexmit_count = 0; // Used only for sending the rexmit count via UART
         pSocket->pData = g_HtmlPageParseFail;
         pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageParseFail) - 1);
 	// Send the response
-        pSocket->nPrevBytes = 0xFFFF;
         pSocket->nState = STATE_SENDHEADER200;
       }
     }
-#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
+#endif // SREC_UPLOAD == 1
 
 
 
@@ -10129,6 +11337,9 @@ rexmit_count = 0; // Used only for sending the rexmit count via UART
 
 
 
+#if HTTPD_LONG_POLL > 0 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+    sendheader:
+#endif // HTTPD_LONG_POLL > 0 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
     if (pSocket->nState == STATE_SENDHEADER200) {
       // This step is entered after HTTP request processing is complete in
       // order to copy an appropriate web page into the body of the reply
@@ -10153,7 +11364,30 @@ rexmit_count = 0; // Used only for sending the rexmit count via UART
       // Some GET requests do not send a webpage response (just a 200 header
       // with Content-Length = 0). In those cases STATE_SENDHEADER204 will
       // have been entered from GET processing (see below).
-      uip_send(uip_appdata, CopyHttpHeader(uip_appdata, adjust_template_size(pSocket), HEADER200));
+#if HTTPD_COALESCE_HEADER == 0
+      nBufSize = CopyHttpPageHeader(uip_appdata, pSocket);
+#endif // HTTPD_COALESCE_HEADER == 0
+#if HTTPD_COALESCE_HEADER == 1
+      // The segment is the header followed by the start of the page. It is
+      // checkpointed like a data segment and marked as starting with the
+      // header in case it is retransmitted.
+      {
+        struct tHttpDCheckpoint* pCheckpoint;
+        pCheckpoint = next_checkpoint();
+        save_checkpoint(pSocket, pCheckpoint);
+        pCheckpoint->Header = 1;
+      }
+      nBufSize = CopyHttpHeaderData(pSocket);
+#endif // HTTPD_COALESCE_HEADER == 1
+      uip_send(uip_appdata, nBufSize);
+#if PAGE_STATISTICS == 1
+      page_stats_begin(pSocket);
+      page_stats_send(pSocket, nBufSize);
+#endif // PAGE_STATISTICS == 1
+#if HTTPD_COALESCE_HEADER == 0
+      // Mark the segment as the header in case it is retransmitted.
+      next_checkpoint()->nDataLeft = 0xFFFF;
+#endif // HTTPD_COALESCE_HEADER == 0
       pSocket->nState = STATE_SENDDATA;
       return;
     }
@@ -10197,7 +11431,8 @@ rexmit_count = 0; // Used only for sending the rexmit count via UART
       else {
 #endif // RESPONSE_LOCK_SUPPORT == 1
       // Send a 200 response with length 0
-      uip_send(uip_appdata, CopyHttpHeader(uip_appdata, 0, HEADER200));
+      uip_send(uip_appdata, CopyHttpHeader(uip_appdata, pSocket, 0, HEADER200));
+      next_checkpoint()->nDataLeft = 0xFFFF;
       // Clear nDataLeft and go to STATE_SENDDATA, but only to close
       // connection.
       pSocket->nDataLeft = 0;
@@ -10214,7 +11449,8 @@ rexmit_count = 0; // Used only for sending the rexmit count via UART
       // at a time, so the second arrival is rejected with a 429 response.
       // The 429 response has no webpage response (just a 429 header with
       // Content-Length = 0 and Retry-After set to 10 seconds).
-      uip_send(uip_appdata, CopyHttpHeader(uip_appdata, 0, HEADER429));
+      uip_send(uip_appdata, CopyHttpHeader(uip_appdata, pSocket, 0, HEADER429));
+      next_checkpoint()->nDataLeft = 0xFFFF;
       pSocket->nState = STATE_SENDDATA;
       return;
     }
@@ -10241,19 +11477,60 @@ rexmit_count = 0; // Used only for sending the rexmit count via UART
         nBufSize = 0;
       }
       else {
+#if HTTPD_TX_WINDOW > 1
+        // A segment can only be added if the transmit window has room.
+        if (uip_segments() >= HTTPD_TX_WINDOW) return;
+#endif // HTTPD_TX_WINDOW > 1
+        // The CopyHttpData() state is checkpointed so that the segment can
+	// be regenerated if it is retransmitted.
+        save_checkpoint(pSocket, next_checkpoint());
+#if HTTPD_PAGE_CACHE == 1
+        // A segment already in the page cache is copied to the transmit
+	// buffer by the ENC28J60 DMA. Otherwise it is rendered and added to
+	// the cache.
+        nBufSize = page_cache_load(pSocket, next_checkpoint());
+        if (nBufSize == 0) {
+          nBufSize = CopyHttpData(uip_appdata, &pSocket->pData, &pSocket->nDataLeft, uip_mss(), pSocket);
+          page_cache_store(pSocket, next_checkpoint(), nBufSize);
+        }
+#else // HTTPD_PAGE_CACHE == 0
         // Copy data to buffer
-        pSocket->nPrevBytes = pSocket->nDataLeft;
         nBufSize = CopyHttpData(uip_appdata, &pSocket->pData, &pSocket->nDataLeft, uip_mss(), pSocket);
-        pSocket->nPrevBytes -= pSocket->nDataLeft;
+#endif // HTTPD_PAGE_CACHE == 1
       }
 
+#if HTTPD_CHUNKED_TRANSFER == 1
+      // CopyHttpData() drops an empty chunk before the end of the page. The
+      // page is continued on the next poll.
+      if (nBufSize == 0 && pSocket->nDataLeft != 0) return;
+#endif // HTTPD_CHUNKED_TRANSFER == 1
       if (nBufSize == 0) {
+#if HTTPD_TX_WINDOW > 1
+        // Segments still in flight must be acknowledged before the
+	// connection is closed.
+        if (uip_outstanding(uip_conn)) return;
+#endif // HTTPD_TX_WINDOW > 1
+#if PAGE_STATISTICS == 1
+        page_stats_end(pSocket);
+#endif // PAGE_STATISTICS == 1
+#if HTTPD_KEEP_ALIVE > 0
+        if (pSocket->KeepAlive) {
+          // The response is complete. Leave the connection open and wait
+	  // for the next request on it.
+          pSocket->nState = STATE_CONNECTED;
+          pSocket->IdleStart = (uint8_t)second_counter;
+          return;
+        }
+#endif // HTTPD_KEEP_ALIVE > 0
         //No Data has been copied (or there was none to send). Close connection
         uip_close();
       }
       else {
         //Else send copied data
         uip_send(uip_appdata, nBufSize);
+#if PAGE_STATISTICS == 1
+        page_stats_send(pSocket, nBufSize);
+#endif // PAGE_STATISTICS == 1
       }
       
       return;
@@ -10274,32 +11551,32 @@ UARTPrintf(OctetArray);
 UARTPrintf("\r\n");
 #endif // DEBUG_SUPPORT == 15
 
-    if (pSocket->nPrevBytes == 0xFFFF) {
-      // Send header again
-      uip_send(uip_appdata, CopyHttpHeader(uip_appdata, adjust_template_size(pSocket), HEADER200));
-    }
-    else {
-      // The pData pointer needs to be moved back by the number of bytes
-      // consumed from the webpage template.
-      pSocket->pData -= pSocket->nPrevBytes;
-      
-#if OB_EEPROM_SUPPORT == 1
-      // A similar adjustment is required for off_board_eeprom_index when
-      // the webpage is sourced from I2C EEPROM.
-      off_board_eeprom_index -= pSocket->nPrevBytes;
-#endif // OB_EEPROM_SUPPORT == 1
-      
-      pSocket->nDataLeft += pSocket->nPrevBytes;
-      pSocket->nPrevBytes = pSocket->nDataLeft;
-      nBufSize = CopyHttpData(uip_appdata, &pSocket->pData, &pSocket->nDataLeft, uip_mss(), pSocket);
-      pSocket->nPrevBytes -= pSocket->nDataLeft;
-      
-      if (nBufSize == 0) {
-        //No Data has been copied. Close connection
-        uip_close();
+    {
+      // uip only retransmits the oldest segment in flight. It is regenerated
+      // from its checkpoint, which restores the template position and any
+      // interrupted insertion exactly as they were when the segment was
+      // first generated. Then the CopyHttpData() state is put back to where
+      // it was after the newest segment in flight.
+      struct tHttpDCheckpoint live;
+      struct tHttpDCheckpoint* pCheckpoint;
+
+#if PAGE_STATISTICS == 1
+      if (pSocket->StatSlot != PSTAT_NONE) page_stats[pSocket->StatSlot].rexmits++;
+#endif // PAGE_STATISTICS == 1
+      pCheckpoint = oldest_checkpoint();
+      if (pCheckpoint->nDataLeft == 0xFFFF) {
+        // Send header again
+        uip_send(uip_appdata, CopyHttpPageHeader(uip_appdata, pSocket));
       }
       else {
-        //Else send copied data
+        save_checkpoint(pSocket, &live);
+        restore_checkpoint(pSocket, pCheckpoint);
+#if HTTPD_COALESCE_HEADER == 1
+        if (pCheckpoint->Header) nBufSize = CopyHttpHeaderData(pSocket);
+        else
+#endif // HTTPD_COALESCE_HEADER == 1
+        nBufSize = CopyHttpData(uip_appdata, &pSocket->pData, &pSocket->nDataLeft, uip_mss(), pSocket);
+        restore_checkpoint(pSocket, &live);
         uip_send(uip_appdata, nBufSize);
       }
     }
@@ -10310,6 +11587,92 @@ UARTPrintf("\r\n");
 
 
 #if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+#if HTTPD_ZERO_COPY_POST == 1
+void parsepost(struct tHttpD* pSocket, char *pBuffer, uint16_t nBytes) {
+  // This function parses data the user entered in the GUI.
+  
+  // Parse pre-process
+  // The POST data is parsed in place in the uip_buf. Each packet is split
+  // at the last '&' it contains:
+  // a) Everything up to and including that '&' is a series of complete
+  //    POST components and is handed directly to parse_local_buf().
+  // b) Everything after that '&' is a partial POST component (a TCP
+  //    Fragment) and is copied to the parse_tail. The parse_tail is global
+  //    so that it will retain the partial POST data when leaving the
+  //    function to collect additional packets.
+  // The last POST component ("z00=0") has no '&' after it, so if the
+  // packet ends with it the whole packet is handed to parse_local_buf().
+  //
+  // When the next packet arrives the characters up to and including the
+  // '&' that ends the partial POST component are appended to the
+  // parse_tail one at a time, and the completed POST component is parsed
+  // where it is. parse_local_buf() only reads the buffer it is given, so
+  // the parse_tail needs no copy on the stack, and a POST component that
+  // is split over more than two packets keeps growing in the parse_tail
+  // without being rescanned.
+
+  uint16_t i;
+  uint16_t j;
+
+  i = strlen((char *)parse_tail);
+  
+  if (i != 0) {
+    // Complete the POST component that was split by the previous packet.
+    while ((nBytes != 0) && (i < (sizeof(parse_tail) - 1))) {
+      parse_tail[i] = *pBuffer;
+      pBuffer++;
+      nBytes--;
+      i++;
+      if (parse_tail[i - 1] == '&') break;
+    }
+    parse_tail[i] = '\0';
+    
+    if ((nBytes == 0)
+     && (parse_tail[i - 1] != '&')
+     && (strcmp((char *)parse_tail, "z00=0") != 0)) {
+      // The POST component is still not complete. Keep collecting it with
+      // the next packet.
+      return;
+    }
+    
+    parse_local_buf(pSocket, (char *)parse_tail, i);
+    parse_tail[0] = '\0';
+    
+    if ((pSocket->nState != STATE_PARSEPOST) || (nBytes == 0)) return;
+  }
+  
+  // Find the last '&' in the packet. j is left pointing at the first
+  // character after it.
+  j = nBytes;
+  while ((j != 0) && (pBuffer[j - 1] != '&')) j--;
+  
+  if (((nBytes - j) == 5) && (strncmp(&pBuffer[j], "z00=0", 5) == 0)) {
+    // The packet ends with the end of the POST. Parse all of it.
+    j = nBytes;
+  }
+  else {
+    // Save the partial POST component at the end of the packet (if any)
+    // for completion when the next packet arrives.
+    i = nBytes - j;
+    if (i > (sizeof(parse_tail) - 1)) i = sizeof(parse_tail) - 1;
+    memcpy(parse_tail, &pBuffer[j], i);
+    parse_tail[i] = '\0';
+  }
+
+#if DEBUG_SUPPORT == 15
+// UARTPrintf("\r\n");
+// UARTPrintf("parsepost in place. j = ");
+// emb_itoa(j, OctetArray, 10, 3);
+// UARTPrintf(OctetArray);
+// UARTPrintf("   parse_tail = ");
+// UARTPrintf(parse_tail);
+// UARTPrintf("\r\n");
+#endif // DEBUG_SUPPORT == 15
+
+  if (j != 0) parse_local_buf(pSocket, pBuffer, j);
+  return;
+}
+#else // HTTPD_ZERO_COPY_POST == 0
 void parsepost(struct tHttpD* pSocket, char *pBuffer, uint16_t nBytes) {
   // This function parses data the user entered in the GUI.
   
@@ -10563,7 +11926,166 @@ void parsepost(struct tHttpD* pSocket, char *pBuffer, uint16_t nBytes) {
   }
   return;
 }
+#endif // HTTPD_ZERO_COPY_POST == 1
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+
+
+#if PROVISION_SUPPORT == 1 || UDP_STATUS_SUPPORT == 1 || RUNTIME_UPLOAD == 1
+uint16_t crc_ccitt(uint16_t crc, const uint8_t* pData, uint16_t nBytes)
+{
+  // CRC-16 CCITT (polynomial 0x1021) of nBytes at pData continuing from
+  // crc. Start with crc = 0xffff.
+  uint8_t j;
+
+  while (nBytes--) {
+    crc ^= (uint16_t)(*pData++ << 8);
+    for (j = 0; j < 8; j++) {
+      if (crc & 0x8000) crc = (uint16_t)((crc << 1) ^ 0x1021);
+      else crc = (uint16_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+#endif // PROVISION_SUPPORT == 1 || UDP_STATUS_SUPPORT == 1 || RUNTIME_UPLOAD == 1
+
+
+#if PROVISION_SUPPORT == 1
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+// Provisioning POST
+// The blob is collected from the x00 to x07 records of the POST and only
+// applied when the x99 record with the CRC is parsed.
+#define PROVISION_VERSION	1
+#define PROVISION_RECORDS	8
+#define PROVISION_SIZE		(PROVISION_RECORDS * 16)
+// x00= to x07= records plus the x99= CRC record and the z00=0 component
+#define PARSEBYTES_PROVISION	((PROVISION_RECORDS * (4 + 32 + 1)) + (4 + 4 + 1) + 5)
+
+#if SCRATCH_ARENA_SHARED == 0
+uint8_t provision_buf[PROVISION_SIZE]; // Blob collected from the records
+#endif // SCRATCH_ARENA_SHARED == 0
+uint8_t provision_records;             // One bit per record received
+
+
+#if SCRATCH_ARENA_SHARED == 1
+void scratch_claim(uint8_t owner)
+{
+  // Make "owner" the user of the scratch_arena. The previous owner is told
+  // that its data is gone: the pre_buf is marked invalid so the next
+  // CopyHttpData() call re-reads the I2C EEPROM, and the provisioning
+  // records are marked not received so the x99 record is rejected.
+  if (scratch_owner == owner) return;
+  if (scratch_owner == SCRATCH_PRE_BUF) pre_buf_valid = 0;
+  if (scratch_owner == SCRATCH_PROVISION) {
+#if DEBUG_SUPPORT == 15
+    // A page read from the I2C EEPROM was sent while a provisioning POST
+    // was being collected. The two overlap in the scratch_arena.
+    if (provision_records != 0) UARTPrintf("scratch_arena overlap, provisioning rejected\r\n");
+#endif // DEBUG_SUPPORT == 15
+    provision_records = 0;
+  }
+  scratch_owner = owner;
+}
+#endif // SCRATCH_ARENA_SHARED == 1
+
+
+void provision_apply(void)
+{
+  // Apply a validated blob. The blob has the following layout. Multi-byte
+  // numbers are most significant byte first and addresses are in the order
+  // they are written (192.168.1.4 is c0 a8 01 04).
+  //   0       Version (PROVISION_VERSION)
+  //   1-4     IP Address
+  //   5-8     Gateway
+  //   9-12    Netmask
+  //   13-14   HTTP Port
+  //   15-20   MAC
+  //   21-40   Device Name, NULL padded (19 characters max)
+  //   41      Config settings (as the g00 field)
+  //   42-45   MQTT Host IP Address
+  //   46-47   MQTT Port
+  //   48-58   MQTT Username, NULL padded (10 characters max)
+  //   59-69   MQTT Password, NULL padded (10 characters max)
+  //   70-85   pin_control for IO1 to IO16 (the ON/OFF bit is ignored)
+  //   86-117  IO_TIMER for IO1 to IO16 (Browser Only builds)
+  //   118-127 Reserved, 0
+  // As with the Configuration page the EEPROM is only written, and a
+  // restart or reboot only requested, for the values that changed.
+  uint8_t i;
+  uint16_t temp;
+
+  unlock_eeprom();
+
+  for (i = 0; i < 4; i++) {
+    if (stored_hostaddr[3 - i] != provision_buf[1 + i]) {
+      stored_hostaddr[3 - i] = provision_buf[1 + i];
+      user_restart_request = 1;
+    }
+    if (stored_draddr[3 - i] != provision_buf[5 + i]) {
+      stored_draddr[3 - i] = provision_buf[5 + i];
+      user_restart_request = 1;
+    }
+    if (stored_netmask[3 - i] != provision_buf[9 + i]) {
+      stored_netmask[3 - i] = provision_buf[9 + i];
+      user_restart_request = 1;
+    }
+    if (stored_mqttserveraddr[3 - i] != provision_buf[42 + i]) {
+      stored_mqttserveraddr[3 - i] = provision_buf[42 + i];
+      user_restart_request = 1;
+    }
+  }
+
+  temp = (uint16_t)((provision_buf[13] << 8) | provision_buf[14]);
+  if ((temp > 9) && (stored_port != temp)) {
+    stored_port = temp;
+    user_restart_request = 1;
+  }
+  temp = (uint16_t)((provision_buf[46] << 8) | provision_buf[47]);
+  if ((temp > 9) && (stored_mqttport != temp)) {
+    stored_mqttport = temp;
+    user_restart_request = 1;
+  }
+
+  for (i = 0; i < 6; i++) {
+    // stored_uip_ethaddr_oct[] is in reverse order
+    if (stored_uip_ethaddr_oct[5 - i] != provision_buf[15 + i]) {
+      stored_uip_ethaddr_oct[5 - i] = provision_buf[15 + i];
+      // Reboot will update the ENC28J60.
+      user_reboot_request = 1;
+    }
+  }
+
+  // Force the string terminators
+  provision_buf[40] = '\0';
+  provision_buf[58] = '\0';
+  provision_buf[69] = '\0';
+  if (memcmp(stored_devicename, &provision_buf[21], 20) != 0) {
+    memcpy(stored_devicename, &provision_buf[21], 20);
+    user_restart_request = 1;
+  }
+  if (memcmp(stored_mqtt_username, &provision_buf[48], 11) != 0) {
+    memcpy(stored_mqtt_username, &provision_buf[48], 11);
+    user_restart_request = 1;
+  }
+  if (memcmp(stored_mqtt_password, &provision_buf[59], 11) != 0) {
+    memcpy(stored_mqtt_password, &provision_buf[59], 11);
+    user_restart_request = 1;
+  }
+
+  lock_eeprom();
+
+  // The remaining values are handed to check_runtime_changes() the same
+  // way as the Configuration page values.
+  Pending_config_settings = provision_buf[41];
+  for (i = 0; i < 16; i++) {
+    // Keep the ON/OFF bit as-is
+    Pending_pin_control[i] = (uint8_t)((pin_control[i] & 0x80) | (provision_buf[70 + i] & 0x7f));
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
+    Pending_IO_TIMER[i] = (uint16_t)((provision_buf[86 + (i * 2)] << 8) | provision_buf[87 + (i * 2)]);
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
+  }
+}
 #endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+#endif // PROVISION_SUPPORT == 1
 
 
 
@@ -11259,6 +12781,9 @@ UARTPrintf("<\r\n");
 	      // if the value did not change.
 	      // Note that even though an IDX value is only 6 bytes the full
 	      // 16 bytes reserved for the IO_NAME is written.
+	      // The IDX lookup table used by publish_callback() is rebuilt
+	      // on the next command.
+	      idx_hash_valid = 0;
 	      if (pSocket->ParseNum < 16) {
 	        if (strcmp(IO_NAME[pSocket->ParseNum], tmp_Pending) != 0) {
 	          // The write to Flash will occur 4 bytes at a time to
@@ -11837,6 +13362,63 @@ UARTPrintf("<\r\n");
 #endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
 
 
+#if PROVISION_SUPPORT == 1
+      // Parse 'x' ------------------------------------------------------//
+      else if (pSocket->ParseCmd == 'x') {
+        // This code collects the records of a provisioning POST. x00 to x07
+        // each carry 16 bytes of the blob as 32 hex characters. x99 carries
+        // the CRC of the blob as 4 hex characters and applies the blob if
+        // all records were received and the version and CRC are valid.
+        //
+	// Notes on the "current_webpage" logic.
+	// If current_webpage == WEBPAGE_NULL this is the first component of
+	// the POST. The page shown after the POST is the Configuration page.
+	if (pSocket->current_webpage == WEBPAGE_NULL) {
+          pSocket->current_webpage = WEBPAGE_CONFIGURATION;
+	  pSocket->nParseLeft = PARSEBYTES_PROVISION - 4;
+	  provision_records = 0;
+	}
+
+#if SCRATCH_ARENA_SHARED == 1
+        scratch_claim(SCRATCH_PROVISION);
+#endif // SCRATCH_ARENA_SHARED == 1
+
+        if (pSocket->ParseNum < PROVISION_RECORDS) {
+          uint8_t i;
+          uint8_t* pRecord;
+          pRecord = &provision_buf[pSocket->ParseNum * 16];
+          for (i = 0; i < 16; i++) {
+            pRecord[i] = two_hex2int(local_buf[lbi], local_buf[lbi+1]);
+	    lbi += 2;
+          }
+          pSocket->nParseLeft -= 32;
+          provision_records |= (uint8_t)(1 << pSocket->ParseNum);
+        }
+        else if (pSocket->ParseNum == 99) {
+          uint16_t crc;
+          crc = (uint16_t)(two_hex2int(local_buf[lbi], local_buf[lbi+1]) << 8);
+          crc |= two_hex2int(local_buf[lbi+2], local_buf[lbi+3]);
+	  lbi += 4;
+          pSocket->nParseLeft -= 4;
+          if ((provision_records != 0xff)
+           || (provision_buf[0] != PROVISION_VERSION)
+           || (crc_ccitt(0xffff, provision_buf, PROVISION_SIZE) != crc)) {
+	    // Incomplete or corrupted blob. Nothing has been changed.
+	    parse_error = 1;
+            pSocket->nParseLeft = 0;
+	    break; // Break out of the while() loop
+          }
+          provision_apply();
+        }
+        else {
+	  parse_error = 1;
+          pSocket->nParseLeft = 0;
+	  break; // Break out of the while() loop
+        }
+      }
+#endif // PROVISION_SUPPORT == 1
+
+
       // Parse 'z' ------------------------------------------------------//
       else if (pSocket->ParseCmd == 'z') {
         // This POST value signals that the "hidden" post was received. This
@@ -12042,7 +13624,6 @@ UARTPrintf("<\r\n");
     }
     // Set nState to copy a 200 header with Content-Length = 0 into the body
     // of the reply to the POST. This will also close the connection.
-    pSocket->nPrevBytes = 0xFFFF;
     pSocket->nState = STATE_SENDHEADER204;
     
     
@@ -12060,7 +13641,6 @@ UARTPrintf("<\r\n");
       pSocket->pData = g_HtmlPageIOControl;
       pSocket->nDataLeft = HtmlPageIOControl_size;
       init_off_board_string_pointers(pSocket);
-      pSocket->nPrevBytes = 0xFFFF;
       pSocket->nState = STATE_SENDHEADER200;
     }
     if (login_successful == 2) {
@@ -12074,7 +13654,6 @@ UARTPrintf("<\r\n");
       pSocket->pData = g_HtmlPageLogin;
       pSocket->nDataLeft = HtmlPageLogin_size;
       init_off_board_string_pointers(pSocket);
-      pSocket->nPrevBytes = 0xFFFF;
       pSocket->nState = STATE_SENDHEADER200;
     }
     if (login_successful == 3) {
@@ -12085,7 +13664,6 @@ UARTPrintf("<\r\n");
       pSocket->pData = g_HtmlPageConfiguration;
       pSocket->nDataLeft = HtmlPageConfiguration_size;
       init_off_board_string_pointers(pSocket);
-      pSocket->nPrevBytes = 0xFFFF;
       pSocket->nState = STATE_SENDHEADER200;
     }
 #endif // LOGIN_SUPPORT == 1
@@ -12136,6 +13714,100 @@ void update_ON_OFF(uint8_t i, uint8_t j)
 
 
 
+// The following table lists the URL commands that only select a webpage.
+// Commands that are not handled by the parseget() switch, and are not
+// Output ON/OFF commands, are looked up here by select_page_cmd(). Keeping
+// these commands out of the switch keeps the switch to the commands that
+// change settings, and a new page command only needs a table entry. Each
+// entry has:
+//   cmd     - The URL command
+//   flags   - PAGE_CMD_PCF8574 if the page is only available when the
+//             PCF8574 is present
+//   webpage - The webpage the command selects
+//   pData   - The webpage template
+//   size    - Size of a template stored in Flash, or 0 if the size is in a
+//             RAM variable
+//   pSize   - Pointer to the RAM variable holding the template size for
+//             templates that can be stored in I2C EEPROM, else 0
+// The table ends with a cmd 0x00 entry. 0x00 is an Output OFF command so it
+// never needs a table entry.
+struct page_cmd {
+    uint8_t cmd;
+    uint8_t flags;
+    uint8_t webpage;
+    const char* pData;
+    uint16_t size;
+    uint16_t* pSize;
+};
+
+#define PAGE_CMD_PCF8574	0x01
+
+const struct page_cmd page_cmd_table[] = {
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+  { 0x61, 0, WEBPAGE_CONFIGURATION, g_HtmlPageConfiguration, 0, &HtmlPageConfiguration_size },
+#if PCF8574_SUPPORT == 1
+#if BUILD_TYPE_BROWSER_UPGRADEABLE == 1 || HOME_ASSISTANT_SUPPORT == 1
+  { 0x62, PAGE_CMD_PCF8574, WEBPAGE_PCF8574_IOCONTROL, g_HtmlPagePCFIOControl, 0, &HtmlPagePCFIOControl_size },
+  { 0x63, PAGE_CMD_PCF8574, WEBPAGE_PCF8574_CONFIGURATION, g_HtmlPagePCFConfiguration, 0, &HtmlPagePCFConfiguration_size },
+#endif // BUILD_TYPE_BROWSER_UPGRADEABLE == 1 || HOME_ASSISTANT_SUPPORT == 1
+#endif // PCF8574_SUPPORT == 1
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+#if LINK_STATISTICS == 1
+  { 0x66, 0, WEBPAGE_STATS2, g_HtmlPageStats2, (uint16_t)(sizeof(g_HtmlPageStats2) - 1), 0 },
+#endif // LINK_STATISTICS == 1
+#if NETWORK_STATISTICS == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+  { 0x68, 0, WEBPAGE_STATS1, g_HtmlPageStats1, (uint16_t)(sizeof(g_HtmlPageStats1) - 1), 0 },
+#endif // NETWORK_STATISTICS == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+#if LOGIN_SUPPORT == 1
+  { 0x6a, 0, WEBPAGE_LOGIN, g_HtmlPageLogin, 0, &HtmlPageLogin_size },
+  { 0x6b, 0, WEBPAGE_SET_PASSPHRASE, g_HtmlPageSetPassphrase, 0, &HtmlPageSetPassphrase_size },
+#endif // LOGIN_SUPPORT == 1
+#if RF_ATTEN_SUPPORT == 1
+  { 0x75, 0, WEBPAGE_RF_ATTEN, g_HtmlPageRFAtten, (uint16_t)(sizeof(g_HtmlPageRFAtten) - 1), 0 },
+#endif // RF_ATTEN_SUPPORT == 1
+#if INA226_SUPPORT == 1
+  { 0x76, 0, WEBPAGE_INA226, g_HtmlPageINA226, (uint16_t)(sizeof(g_HtmlPageINA226) - 1), 0 },
+#endif // INA226_SUPPORT == 1
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD && SHORT_TEMPERATURE_SUPPORT == 1
+  { 0x97, 0, WEBPAGE_SHORT_TEMPERATURE, g_HtmlPageShortTemperature, (uint16_t)(sizeof(g_HtmlPageShortTemperature) - 1), 0 },
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD && SHORT_TEMPERATURE_SUPPORT == 1
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+  { 0x98, 0, WEBPAGE_SSTATE, g_HtmlPageSstate, (uint16_t)(sizeof(g_HtmlPageSstate) - 1), 0 },
+  { 0x99, 0, WEBPAGE_SSTATE, g_HtmlPageSstate, (uint16_t)(sizeof(g_HtmlPageSstate) - 1), 0 },
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+  { 0x00, 0, 0, 0, 0, 0 }
+};
+
+
+uint8_t select_page_cmd(struct tHttpD* pSocket, uint8_t cmd)
+{
+  // Look up a URL command in the page_cmd_table and set up the connection
+  // to send the webpage the command selects. Returns 1 if the page was
+  // selected, or 0 if the command is not in the table or the page is not
+  // available.
+  const struct page_cmd* pCmd;
+
+  for (pCmd = page_cmd_table; pCmd->cmd != 0x00; pCmd++) {
+    if (pCmd->cmd == cmd) {
+#if PCF8574_SUPPORT == 1
+      if ((pCmd->flags & PAGE_CMD_PCF8574) && ((stored_options1 & 0x08) == 0)) return 0;
+#endif // PCF8574_SUPPORT == 1
+      pSocket->current_webpage = pCmd->webpage;
+      pSocket->pData = (const uint8_t*)pCmd->pData;
+      if (pCmd->pSize) {
+        pSocket->nDataLeft = *pCmd->pSize;
+#if OB_EEPROM_SUPPORT == 1
+        init_off_board_string_pointers(pSocket);
+#endif // OB_EEPROM_SUPPORT == 1
+      }
+      else pSocket->nDataLeft = pCmd->size;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+
 void parseget(struct tHttpD* pSocket, char *pBuffer)
 {
   uint8_t GET_response_type;
@@ -12553,6 +14225,8 @@ UARTPrintf("\r\n");
       // http://IP/83  Force all PCF8574 pins to NULL (default, disabled)
       // http://IP/84  Short Form Option
       // http://IP/85  Force HA Delete Msgs for PCF8574 pins
+      // http://IP/86  Firmware file POST (BACKGROUND_UPLOAD only)
+      // http://IP/87  Install the staged firmware (BACKGROUND_UPLOAD only)
       //
       // http://IP/91  Reboot
       // http://IP/98  Show Very Short Form IO States page
@@ -12561,6 +14235,9 @@ UARTPrintf("\r\n");
       // http://IP/a0  Turn Response Lock on or off
       // http://IP/a1  NULL command. Used when Response Lock is ON.
       //
+      // http://IP/d4  Run the benchmarks (DEVELOPMENT_TOOLS only)
+      // http://IP/d5  Show the Benchmark Record (DEVELOPMENT_TOOLS only)
+      //
       // http://IP/fa  Reserved to avoid "favicon.ico" issue
 
 
@@ -12767,43 +14444,6 @@ UARTPrintf("\r\n");
 	  // IO_Control page.
 	  pSocket->ParseState = PARSE_FAIL;
 	  break;
-	  
-	case 0x61: // Show Configuration page
-	  pSocket->current_webpage = WEBPAGE_CONFIGURATION;
-          pSocket->pData = g_HtmlPageConfiguration;
-          pSocket->nDataLeft = HtmlPageConfiguration_size;          
-#if OB_EEPROM_SUPPORT == 1
-          init_off_board_string_pointers(pSocket);
-#endif // OB_EEPROM_SUPPORT == 1
-	  break;
-
-
-#if PCF8574_SUPPORT == 1
-#if BUILD_TYPE_BROWSER_UPGRADEABLE == 1 || HOME_ASSISTANT_SUPPORT == 1
-	case 0x62: // Show PCF8574 IO Control page
-	  if (stored_options1 & 0x08) {
-	    pSocket->current_webpage = WEBPAGE_PCF8574_IOCONTROL;
-            pSocket->pData = g_HtmlPagePCFIOControl;
-            pSocket->nDataLeft = HtmlPagePCFIOControl_size;
-            init_off_board_string_pointers(pSocket);
-	  }
-	  else pSocket->ParseState = PARSE_FAIL;
-	  break;
-
-	case 0x63: // Show PCF8574 Configuration page
-	  if (stored_options1 & 0x08) {
-	    pSocket->current_webpage = WEBPAGE_PCF8574_CONFIGURATION;
-            pSocket->pData = g_HtmlPagePCFConfiguration;
-            pSocket->nDataLeft = HtmlPagePCFConfiguration_size;
-            init_off_board_string_pointers(pSocket);
-	  }
-	  else {
-	    pSocket->ParseState = PARSE_FAIL;
-	  }
-	  break;
-#endif // BUILD_TYPE_BROWSER_UPGRADEABLE == 1 || HOME_ASSISTANT_SUPPORT == 1
-
-#endif // PCF8574_SUPPORT == 1
 #endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
 
 
@@ -12820,12 +14460,6 @@ UARTPrintf("\r\n");
 	  break;
 
 #if LINK_STATISTICS == 1
-        case 0x66: // Show Link Error Statistics page
-	  pSocket->current_webpage = WEBPAGE_STATS2;
-          pSocket->pData = g_HtmlPageStats2;
-          pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageStats2) - 1);
-	  break;
-	  
         case 0x67: // Clear Link Error Statistics
 	  // Clear the the Link Error Statistics bytes and Stack Overflow
 	  {
@@ -12839,43 +14473,28 @@ UARTPrintf("\r\n");
 	  MQTT_resp_tout_counter = 0;
 	  MQTT_not_OK_counter = 0;
 	  MQTT_broker_dis_counter = 0;
+#if UIP_CONN_RESERVE == 1
+	  syn_drop_counter = 0;
+#endif // UIP_CONN_RESERVE == 1
+#if PROFILE_SUPPORT == 1
+	  prof_init();
+#endif // PROFILE_SUPPORT == 1
+#if PAGE_STATISTICS == 1
+	  page_stats_init();
+#endif // PAGE_STATISTICS == 1
 	  
-	  pSocket->current_webpage = WEBPAGE_STATS2;
-          pSocket->pData = g_HtmlPageStats2;
-          pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageStats2) - 1);
+          select_page_cmd(pSocket, 0x66);
 	  break;
 #endif // LINK_STATISTICS == 1
 
 #if NETWORK_STATISTICS == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
-        case 0x68: // Show Network Statistics page
-	  pSocket->current_webpage = WEBPAGE_STATS1;
-          pSocket->pData = g_HtmlPageStats1;
-          pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageStats1) - 1);
-	  break;
-	  
         case 0x69: // Clear Network Statistics and refresh page
 	  uip_init_stats();
-	  pSocket->current_webpage = WEBPAGE_STATS1;
-          pSocket->pData = g_HtmlPageStats1;
-          pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageStats1) - 1);
+          select_page_cmd(pSocket, 0x68);
 	  break;
 #endif // NETWORK_STATISTICS == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
 
 #if LOGIN_SUPPORT == 1
-        case 0x6a: // Show Login page
-	  pSocket->current_webpage = WEBPAGE_LOGIN;
-          pSocket->pData = g_HtmlPageLogin;
-          pSocket->nDataLeft = HtmlPageLogin_size;
-          init_off_board_string_pointers(pSocket);
-	  break;
-
-
-        case 0x6b: // Show Set Passphrase page
-	  pSocket->current_webpage = WEBPAGE_SET_PASSPHRASE;
-          pSocket->pData = g_HtmlPageSetPassphrase;
-          pSocket->nDataLeft = HtmlPageSetPassphrase_size;
-          init_off_board_string_pointers(pSocket);
-	  break;
 
 
 #if DEVELOPMENT_TOOLS == 1 && LOGIN_SUPPORT == 1
@@ -12971,6 +14590,24 @@ UARTPrintf("\r\n");
 	  break;
 #endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
 #endif // OB_EEPROM_SUPPORT == 1
+
+#if RUNTIME_UPLOAD == 1
+        case 0x87: // Install the firmware staged by a /86 file POST
+	  if (upload_staged == 1 && upload_busy() == 0) {
+	    // Display the Timer page and signal the main.c loop to copy I2C
+	    // EEPROM Region 0 to Flash. The module reboots when the copy
+	    // completes.
+	    pSocket->current_webpage = WEBPAGE_TIMER;
+            pSocket->pData = g_HtmlPageTimer;
+            pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageTimer) - 1);
+            eeprom_copy_to_flash_request = I2C_COPY_EEPROM_R0_REQUEST;
+	  }
+	  else {
+	    // Nothing staged, or another upload is in progress
+	    pSocket->ParseState = PARSE_FAIL;
+	  }
+	  break;
+#endif // RUNTIME_UPLOAD == 1
 	  
 #if OB_EEPROM_SUPPORT == 1
 #if BUILD_SUPPORT == CODE_UPLOADER_BUILD
@@ -13032,24 +14669,6 @@ UARTPrintf("\r\n");
 #endif // OB_EEPROM_SUPPORT == 1
           
           
-#if RF_ATTEN_SUPPORT == 1
-	case 0x75: // Show RF Attenuator Settings page
-	  pSocket->current_webpage = WEBPAGE_RF_ATTEN;
-          pSocket->pData = g_HtmlPageRFAtten;
-          pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageRFAtten) - 1);
-	  break;
-#endif // RF_ATTEN_SUPPORT == 1
-          
-          
-#if INA226_SUPPORT == 1
-	case 0x76: // Show INA226 measurements page
-	  pSocket->current_webpage = WEBPAGE_INA226;
-          pSocket->pData = g_HtmlPageINA226;
-          pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageINA226) - 1);
-	  break;
-#endif // INA226_SUPPORT == 1
-          
-          
 #if SDR_POWER_RELAY_SUPPORT == 1
 	case 0x77: // Show SDR Power Relay page
 	  pSocket->current_webpage = WEBPAGE_SDR_POWER_RELAY;
@@ -13419,23 +15038,57 @@ UARTPrintf("\r\n");
 	  break;
         
 	
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD && SHORT_TEMPERATURE_SUPPORT ==1
-        case 0x97: // Show Short Form Temperature sensor page
-	  pSocket->current_webpage = WEBPAGE_SHORT_TEMPERATURE;
-          pSocket->pData = g_HtmlPageShortTemperature;
-          pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageShortTemperature) - 1);
+#if HTTPD_STATUS_RECORD == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+        case 0x96: // Send the Status Record
+	  pSocket->current_webpage = WEBPAGE_STATUS;
+          pSocket->nDataLeft = 0;
 	  break;
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD && SHORT_TEMPERATURE_SUPPORT ==1
-        
-	
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-        case 0x98: // Show Very Short Form IO state page
-        case 0x99: // Show Short Form IO state page
-	  pSocket->current_webpage = WEBPAGE_SSTATE;
-          pSocket->pData = g_HtmlPageSstate;
-          pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageSstate) - 1);
+#endif // HTTPD_STATUS_RECORD == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+
+
+#if HTTPD_LONG_POLL > 0 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+        case 0x95: // Send the Status Record when a pin or sensor changes
+	  pSocket->current_webpage = WEBPAGE_STATUS;
+          pSocket->nDataLeft = 0;
+          pSocket->LongPollSig = live_signature();
+          pSocket->IdleStart = (uint8_t)second_counter;
+          GET_response_type = 0; // Hold the response (STATE_LONGPOLL)
 	  break;
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+#endif // HTTPD_LONG_POLL > 0 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+
+
+#if HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0
+        case 0x9c: // Send the IOControl page script
+        case 0x9d: // Send the Configuration page script
+        case 0x9e: // Send the PCF8574 IOControl page script
+        case 0x9f: // Send the PCF8574 Configuration page script
+          {
+            uint8_t nScript;
+            nScript = (uint8_t)(pSocket->ParseNum - 0x9c);
+            if (find_script(nScript) == 0) {
+              // The page is not part of this build
+              GET_response_type = 204; // Send header but no webpage
+              break;
+            }
+            pSocket->current_webpage = (uint8_t)(WEBPAGE_SCRIPT + nScript);
+            if (pSocket->nEtagMatch == ETAG_SIZE) {
+              // The Browser has the script. Send a 304 with no data.
+              pSocket->nDataLeft = 0;
+            }
+            else {
+#if HTTPD_SCRIPT_GZIP == 1
+              // The compressed copy of the script is sent
+              pSocket->pData = script_gz(nScript, &pSocket->nDataLeft);
+#else // HTTPD_SCRIPT_GZIP == 0
+              // The template is sent from the %S0x marker up to the %S99
+              // marker
+              pSocket->pData = find_script(nScript);
+              pSocket->nDataLeft = script_size(nScript);
+#endif // HTTPD_SCRIPT_GZIP == 1
+            }
+          }
+	  break;
+#endif // HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0
 
 
 #if RESPONSE_LOCK_SUPPORT == 1
@@ -13566,7 +15219,7 @@ UARTPrintf("\r\n");
             }
           }
           I2C_stop(); // Start the EEPROM internal write cycle
-          wait_timer(5000); // Wait 5ms
+          I2C_ack_poll(I2C_EEPROM_R2_WRITE); // Wait for the write cycle to complete
 	  
 	  user_reboot_request = 1;
           // Display the IOControl page. The PARSE_FAIL state will cause
@@ -13657,6 +15310,20 @@ UARTPrintf("\r\n");
 	  user_reboot_request = 1;
           GET_response_type = 204; // Send header but no webpage
 	  break;
+
+#if BENCHMARK_SUPPORT == 1
+	case 0xd4:
+	  // Run the benchmarks. They run from the main loop after this
+	  // request completes. The results are read with /d5.
+	  bench_request = 1;
+          GET_response_type = 204; // Send header but no webpage
+	  break;
+
+	case 0xd5: // Send the Benchmark Record
+	  pSocket->current_webpage = WEBPAGE_BENCHMARK;
+          pSocket->nDataLeft = 0;
+	  break;
+#endif // BENCHMARK_SUPPORT == 1
 #endif // DEVELOPMENT_TOOLS == 1
 
 
@@ -13869,8 +15536,8 @@ UARTPrintf("\r\n");
 #endif // PCF8574_SUPPORT == 1
           else
 #endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-          {
-	    // Show default page
+          if (select_page_cmd(pSocket, pSocket->ParseNum) == 0) {
+	    // Not a command in the page_cmd_table either. Show default page
 	    // While NOT a PARSE_FAIL, going through the PARSE_FAIL logic
             // will accomplish what we want.
 	    pSocket->ParseState = PARSE_FAIL;
@@ -13932,8 +15599,6 @@ UARTPrintf("\r\n");
     if (pSocket->nParseLeft == 0) {
       // Finished parsing
       // Send the response
-      pSocket->nPrevBytes = 0xFFFF;
-
       if (GET_response_type == 200) {
         // Update GUI with appropriate webpage
 
@@ -13941,7 +15606,6 @@ UARTPrintf("\r\n");
 // UARTPrintf("STATE_SENDHEADER200\r\n");
 #endif // DEBUG_SUPPORT == 15
 
-        pSocket->nPrevBytes = 0xFFFF;
         pSocket->nState = STATE_SENDHEADER200;
       }
       if (GET_response_type == 204) {
@@ -13951,9 +15615,14 @@ UARTPrintf("\r\n");
 // UARTPrintf("STATE_SENDHEADER204\r\n");
 #endif // DEBUG_SUPPORT == 15
 
-        pSocket->nPrevBytes = 0xFFFF;
         pSocket->nState = STATE_SENDHEADER204;
       }
+#if HTTPD_LONG_POLL > 0 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+      if (GET_response_type == 0) {
+        // Wait for a change before sending the Status Record
+        pSocket->nState = STATE_LONGPOLL;
+      }
+#endif // HTTPD_LONG_POLL > 0 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
       break; // Break out of while loop
     }
   } // end of while loop
@@ -14033,7 +15702,7 @@ void parse_command_exception(struct tHttpD* pSocket)
 }
 
 
-#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
+#if SREC_UPLOAD == 1
 char *read_two_characters(char *pBuffer)
 {
   // This function attempts to read two bytes from the SREC file.
@@ -14130,7 +15799,32 @@ char *read_two_characters(char *pBuffer)
     return pBuffer;
   }
 }
-#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
+#endif // SREC_UPLOAD == 1
+
+
+#if RUNTIME_UPLOAD == 1
+uint8_t upload_busy(void)
+{
+  // Returns 1 while a firmware file POST owns the parse_tail and the SREC
+  // parser variables. A connection that was closed or reused is no longer
+  // in a file state. A file POST that has received nothing for 60 seconds
+  // is aborted: it is moved to STATE_SENDHEADER429 so that segments that
+  // arrive later are answered with a 429 and not parsed into a parse_tail
+  // another POST may be using by then.
+  if (upload_owner == NULL) return 0;
+  if (upload_owner->nState != STATE_GOTFILE && upload_owner->nState != STATE_PARSEFILE) {
+    upload_owner = NULL;
+    return 0;
+  }
+  if (second_counter > (upload_time_last + 60)) {
+    upload_owner->nState = STATE_SENDHEADER429;
+    upload_owner->nDataLeft = 0;
+    upload_owner = NULL;
+    return 0;
+  }
+  return 1;
+}
+#endif // RUNTIME_UPLOAD == 1
 
 
 #if LOGIN_SUPPORT == 1
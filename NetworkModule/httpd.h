@@ -62,6 +62,7 @@
 #define UPGRADE_FAIL_NOT_SREC			5
 #define UPGRADE_FAIL_INVALID_FILETYPE		6
 #define UPGRADE_FAIL_TRUNCATED_FILE		7
+#define UPGRADE_FAIL_CRC			8
 
 #define FILETYPE_SEARCH		0
 #define FILETYPE_PROGRAM	1
@@ -126,9 +127,24 @@ struct tHttpD
   uint8_t ParseCmd;
   uint8_t ParseNum;
   uint8_t ParseState;
-  uint16_t nPrevBytes;
   uint8_t current_webpage;
   uint8_t insertion_index;
+#if HTTPD_KEEP_ALIVE > 0
+  uint8_t KeepAlive;
+#endif // HTTPD_KEEP_ALIVE > 0
+#if HTTPD_KEEP_ALIVE > 0 || HTTPD_LONG_POLL > 0
+  uint8_t IdleStart;
+#endif // HTTPD_KEEP_ALIVE > 0 || HTTPD_LONG_POLL > 0
+#if HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0
+  uint8_t nEtagMatch;
+#endif // HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0
+#if PAGE_STATISTICS == 1
+  uint8_t StatSlot;
+  uint16_t StatStart;
+#endif // PAGE_STATISTICS == 1
+#if HTTPD_LONG_POLL > 0
+  uint16_t LongPollSig;
+#endif // HTTPD_LONG_POLL > 0
   int structID;
   
 // nState		Tracks the parsing state of a POST and subsequent
@@ -149,12 +165,23 @@ struct tHttpD
 //			when transmitting a webpage.
 // ParseState		Tracks the state of a POST parsing process to allow
 //			bridging of TCP Fragmentation.
-// nPrevBytes		Used in the case of uip_rexmit to determine if the
-//			header needs to be retransmitted.
 // current_webpage	Tracks the current webpage being displayed in the GUI.
 // insertion_index	Tracks the position in a "long string" being trans-
 //			mitted in a webpage to allow bridging of TCP Frag-
 //			mentation.
+// KeepAlive		1 if the connection is left open for another request
+//			after the response is sent (HTTPD_KEEP_ALIVE)
+// IdleStart		Low byte of the second_counter when the connection
+//			started waiting for another request, or when a /95
+//			request started waiting for a change (HTTPD_LONG_POLL)
+// nEtagMatch		Number of characters of the page script ETag matched
+//			in the GET request headers (HTTPD_SCRIPT_CACHE)
+// StatSlot		page_stats[] entry of the response being sent, or
+//			PSTAT_NONE (PAGE_STATISTICS)
+// StatStart		ms_counter when the response header was sent
+//			(PAGE_STATISTICS)
+// LongPollSig		Pin and sensor signature when a /95 request arrived
+//			(HTTPD_LONG_POLL)
 // structID		This was meant to be a temporary debug value to help
 //                      sort out when connections were being used. It will be
 //                      left in the code for now as it proved to be very
@@ -162,6 +189,66 @@ struct tHttpD
 };
 
 
+struct tHttpDCheckpoint
+{
+  const uint8_t* pData;
+  uint16_t nDataLeft;
+  uint16_t eeprom_index;
+  uint8_t insertion_index;
+  uint8_t ParseCmd;
+  uint8_t ParseNum;
+#if HTTPD_COALESCE_HEADER == 1
+  uint8_t Header;
+#endif // HTTPD_COALESCE_HEADER == 1
+  
+// A tHttpDCheckpoint holds the CopyHttpData() state at the start of a
+// transmitted segment so that the segment can be regenerated if it has to
+// be retransmitted.
+// pData		Saved tHttpD pData
+// nDataLeft		Saved tHttpD nDataLeft, or 0xFFFF if the segment is
+//			the HTTP header
+// eeprom_index		Saved off_board_eeprom_index (upgradeable builds)
+// insertion_index	Saved tHttpD insertion_index
+// ParseCmd		Saved tHttpD ParseCmd (the Mode of an interrupted
+//			insertion)
+// ParseNum		Saved tHttpD ParseNum (the Num of an interrupted
+//			insertion)
+// Header		1 if the segment starts with the HTTP header followed
+//			by the data (only used with HTTPD_COALESCE_HEADER)
+};
+
+
+// Webpage groups counted by the page statistics (PAGE_STATISTICS)
+#define PSTAT_IOCONTROL		0 // IOControl pages
+#define PSTAT_CONFIGURATION	1 // Configuration pages
+#define PSTAT_SCRIPT		2 // Page scripts
+#define PSTAT_SHORT		3 // Short form pages and the Status Record
+#define PSTAT_OTHER		4 // All other pages
+#define PSTAT_NUM		5
+#define PSTAT_NONE		0xff // Response not counted
+
+struct tPageStats
+{
+  uint16_t requests;
+  uint16_t loads;
+  uint16_t segments;
+  uint16_t rexmits;
+  uint16_t time_max;
+  uint32_t bytes;
+  uint32_t time_sum;
+
+// requests		Responses started (200 header sent)
+// loads		Responses completed (last data acknowledged)
+// segments		Segments sent, including the header, not counting
+//			retransmits
+// rexmits		Segments retransmitted
+// time_max		Longest load time in ms
+// bytes		Bytes sent, including the header, not counting
+//			retransmits
+// time_sum		Sum of the load times in ms
+};
+
+
 void httpd_diagnostic(void);
 
 void HttpDStringInit(void);
@@ -170,7 +257,7 @@ uint16_t read_two_bytes(void);
 void read_httpd_diagnostic_bytes(void);
 uint16_t adjust_template_size(struct tHttpD* pSocket);
 
-static uint16_t CopyHttpHeader(uint8_t* pBuffer, uint16_t nDataLen, uint8_t header_type);
+static uint16_t CopyHttpHeader(uint8_t* pBuffer, struct tHttpD* pSocket, uint16_t nDataLen, uint8_t header_type);
 static uint16_t CopyHttpData(uint8_t* pBuffer,
                              const char** ppData,
 			     uint16_t* pDataLeft,
@@ -193,12 +280,28 @@ void int16to4hex(uint16_t i);
 
 void HttpDInit(void);
 void init_tHttpD_struct(struct tHttpD* pSocket);
+void save_checkpoint(struct tHttpD* pSocket, struct tHttpDCheckpoint* pCheckpoint);
+void restore_checkpoint(struct tHttpD* pSocket, struct tHttpDCheckpoint* pCheckpoint);
+void page_cache_invalidate(void);
+uint8_t http_rate_take(void);
+void http_rate_refill(void);
+void page_stats_init(void);
+void page_stats_begin(struct tHttpD* pSocket);
+void page_stats_send(struct tHttpD* pSocket, uint16_t nBytes);
+void page_stats_end(struct tHttpD* pSocket);
+char *page_stats_format(uint8_t slot, char *pBuffer);
 void HttpDCall(uint8_t* pBuffer, uint16_t nBytes, struct tHttpD* pSocket);
 
 char *read_two_characters(char *pBuffer);
+uint8_t upload_busy(void);
 void parsepost(struct tHttpD* pSocket, char *pBuffer, uint16_t nBytes);
 void parse_local_buf(struct tHttpD* pSocket, char* local_buf, uint16_t lbi_max);
 void update_ON_OFF(uint8_t i, uint8_t j);
+void udp_status_call(void);
+uint8_t select_page_cmd(struct tHttpD* pSocket, uint8_t cmd);
+uint16_t crc_ccitt(uint16_t crc, const uint8_t* pData, uint16_t nBytes);
+void provision_apply(void);
+void scratch_claim(uint8_t owner);
 void parseget(struct tHttpD* pSocket, char *pBuffer);
 // void parse_val_case_0x55(void);
 // void parse_val_case_0x56(void);
@@ -207,4 +310,6 @@ void parse_command_exception(struct tHttpD* pSocket);
 void login_timer_management(void);
 int8_t check_login_status(void);
 
+uint16_t bench_render(void);
+
 #endif /*HTTPD_H_*/
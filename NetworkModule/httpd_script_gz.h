@@ -0,0 +1,743 @@
+/*
+ * Pre-compressed page scripts
+ *
+ * Generated by mkscriptgz.py from the webpage templates in httpd.c.
+ * Do not edit. Run mkscriptgz.py after any change to a page script.
+ */
+
+#if HTTPD_SCRIPT_GZIP == 1 && HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0
+
+#if BUILD_SUPPORT == MQTT_BUILD && HOME_ASSISTANT_SUPPORT == 1
+#if OB_EEPROM_SUPPORT == 0
+// g_HtmlPageIOControl: 1307 bytes compressed to 726
+static const unsigned char g_ScriptGzIOControl[] = {
+  0x1f,0x8b,0x08,0x00,0x00,0x00,0x00,0x00,0x02,0xff,0x95,0x54,0x7f,0x6b,0xdb,0x30,
+  0x10,0xfd,0x2a,0x1e,0x33,0x91,0x44,0x85,0x92,0xb4,0xd0,0x42,0x1a,0xb9,0x8c,0xb5,
+  0x63,0x85,0x8d,0x8e,0x66,0x83,0x41,0x29,0x8d,0x2a,0x9f,0x63,0x77,0x8e,0xa4,0xc9,
+  0x72,0x4b,0x67,0xfc,0xdd,0x77,0x4a,0xeb,0x34,0x6c,0x74,0xb0,0x7f,0x12,0x9d,0xee,
+  0xee,0xdd,0x8f,0xf7,0xe4,0x7b,0xe5,0x93,0x46,0xd2,0x20,0xb3,0xae,0x86,0x90,0x80,
+  0xcc,0xad,0x6e,0xd7,0x60,0x02,0xf7,0xb2,0xb6,0x5a,0x85,0xca,0x1a,0x9e,0x4a,0x10,
+  0x3f,0x5b,0xf0,0x8f,0x0b,0xa8,0x41,0x07,0xeb,0xc5,0x6d,0x65,0x72,0x0a,0x8c,0x97,
+  0x32,0xa5,0xa4,0xb0,0x7e,0x4d,0x18,0x37,0x92,0x5e,0xdc,0xde,0xa1,0x5f,0x60,0xba,
+  0xaf,0xa0,0xe1,0x4e,0xf9,0x06,0xce,0x4d,0x60,0x5c,0x49,0xac,0x00,0xe2,0xc1,0x57,
+  0x01,0x28,0xda,0xb1,0x24,0x07,0x26,0x33,0x83,0x96,0x08,0x76,0x81,0x09,0x66,0x45,
+  0xa7,0x87,0x4c,0x38,0x95,0x2f,0x82,0xf2,0x81,0x02,0x27,0x13,0x84,0xad,0x63,0x6a,
+  0x10,0x6b,0xe5,0x62,0x97,0x0d,0xe6,0xed,0x33,0x26,0xee,0x6c,0x65,0x28,0x41,0x77,
+  0x3e,0xb8,0x83,0x2e,0xe9,0x58,0x74,0xfb,0xfd,0x78,0xc5,0x86,0x68,0x44,0xe7,0x88,
+  0xc9,0xb8,0xdd,0xd4,0x37,0xda,0xe6,0xf0,0xed,0xf2,0xfc,0xbd,0x5d,0x3b,0x6b,0xb0,
+  0xcb,0xd8,0x8a,0x93,0x57,0xd7,0x5c,0xc7,0x9f,0x76,0xd3,0x14,0xf7,0xd8,0x56,0x77,
+  0x8f,0x7b,0x49,0x8f,0x3d,0x84,0xd6,0x9b,0xe5,0xbc,0x56,0xb7,0x50,0x67,0xf3,0xca,
+  0xb8,0x36,0x24,0xe1,0xd1,0x81,0xf4,0x2a,0xaf,0x6c,0x62,0xd4,0x1a,0xa4,0x4d,0x3b,
+  0xe8,0x93,0x7b,0x55,0xb7,0x20,0xd3,0x2e,0xf4,0x49,0xda,0x79,0x29,0xc3,0x09,0xd1,
+  0x25,0xe8,0x1f,0x90,0x93,0x19,0x21,0xfd,0x38,0x4b,0x3b,0x8a,0x77,0xd6,0xa0,0x69,
+  0x8b,0x82,0xc4,0xa9,0xbf,0x39,0x07,0xfe,0xbd,0x6a,0x80,0xb2,0x7e,0x3e,0x7e,0x2a,
+  0xb2,0xec,0x79,0x21,0x29,0xdb,0xf2,0x61,0xe0,0x21,0xf9,0x80,0x0b,0x3e,0x55,0x41,
+  0xd1,0x92,0x3d,0xb7,0x94,0x80,0x68,0x20,0x50,0x52,0x4e,0x26,0x84,0xd7,0x34,0xa7,
+  0x41,0xe0,0xf1,0x69,0x6e,0x1c,0xc2,0x0f,0xf9,0xa9,0x24,0x96,0xec,0x79,0xe4,0x09,
+  0xc4,0x0a,0x13,0x52,0x36,0x9f,0x1f,0xbd,0x60,0xe4,0xc8,0x27,0x12,0x92,0x22,0x91,
+  0x3d,0xc3,0x35,0x41,0xcf,0x2b,0x19,0xc1,0x56,0x08,0x76,0x35,0xb9,0x1e,0x22,0xa7,
+  0x87,0xa3,0xea,0x84,0xea,0x62,0x75,0xe3,0xd4,0x0a,0x36,0xed,0x79,0x51,0x7a,0x28,
+  0x24,0x19,0x1f,0x62,0x07,0x83,0xe7,0xc6,0xe9,0xe2,0x2f,0x2f,0x9b,0xbd,0x96,0x39,
+  0xfd,0x67,0xe6,0x01,0xb2,0x5b,0x59,0xfd,0x9a,0x7b,0x9f,0x70,0x0f,0xb5,0x55,0xf9,
+  0x2b,0x3d,0x35,0xed,0xed,0xba,0x0a,0x37,0x51,0x9c,0x91,0xfc,0x2e,0x08,0xe7,0xe1,
+  0x1e,0x49,0x3f,0x85,0x42,0xb5,0x75,0xa0,0xec,0xf8,0x65,0xc3,0xdf,0x3f,0x7f,0xfa,
+  0x18,0x82,0xbb,0x04,0x94,0x79,0x13,0xb5,0xff,0xce,0x7b,0xf5,0x28,0x0a,0x6f,0xd7,
+  0xb4,0xa0,0x6c,0x50,0x34,0x65,0x9c,0x5e,0xa1,0x46,0xae,0xb1,0xd8,0x32,0xed,0x2c,
+  0xea,0xa7,0x97,0xf1,0x1f,0x58,0xbf,0x1c,0x44,0x39,0x22,0xec,0x18,0x84,0x75,0x80,
+  0xe7,0x2f,0x17,0x8b,0xaf,0x84,0x93,0x31,0xe1,0x6f,0xa6,0xb8,0x5e,0x24,0x0d,0xdf,
+  0x8d,0xdf,0x23,0xa3,0x5f,0x93,0x89,0x8c,0xea,0xde,0x19,0x01,0x45,0xc0,0xb7,0x44,
+  0x62,0xdb,0x67,0x0a,0x15,0xfd,0xfc,0x4c,0x3a,0x7a,0x30,0x0a,0x4c,0xca,0x83,0x13,
+  0x2d,0x5c,0xdb,0x94,0x74,0x39,0x0f,0x3e,0x9b,0x87,0x3c,0xbb,0x68,0x43,0x14,0xe5,
+  0x5b,0x14,0xe1,0xde,0x14,0x55,0x84,0x57,0x78,0x9d,0xe8,0x5a,0x35,0x8d,0x24,0x0d,
+  0x0a,0x32,0xcb,0x8e,0xfa,0x24,0x1c,0x90,0xec,0x0f,0xa7,0x46,0x49,0xb6,0x74,0x8a,
+  0x8a,0x8f,0x21,0xac,0x8f,0xd6,0x64,0x6b,0x3d,0x05,0x8f,0xb1,0xca,0x12,0x09,0x7c,
+  0xaa,0x3e,0x1d,0x8d,0xdc,0x1f,0xe5,0xcf,0xcd,0xff,0x56,0x1f,0x0f,0xa8,0x3d,0x7e,
+  0x16,0xa8,0xdb,0xbe,0xe4,0x68,0x3d,0xc3,0x96,0x31,0xa4,0x7c,0x39,0xa4,0x9d,0x16,
+  0x35,0x98,0x15,0x1e,0x27,0x27,0x04,0xaf,0xb7,0x13,0x2c,0xce,0xbe,0x6e,0x22,0x36,
+  0x6f,0xec,0x19,0x17,0x71,0xf4,0x0e,0x6a,0xd7,0xcc,0x76,0xa4,0xc0,0xeb,0xd9,0xce,
+  0xca,0xb9,0x9e,0x0d,0x02,0xe4,0x77,0xb3,0x5d,0xb1,0xf5,0x3d,0xfb,0x0d,0x46,0x64,
+  0x1b,0x0e,0x1b,0x05,0x00,0x00,
+};
+#endif // OB_EEPROM_SUPPORT == 0
+#endif // BUILD_SUPPORT == MQTT_BUILD && HOME_ASSISTANT_SUPPORT == 1
+
+#if BUILD_SUPPORT == MQTT_BUILD && HOME_ASSISTANT_SUPPORT == 1
+#if OB_EEPROM_SUPPORT == 0
+// g_HtmlPageConfiguration: 2259 bytes compressed to 1297
+static const unsigned char g_ScriptGzConfiguration[] = {
+  0x1f,0x8b,0x08,0x00,0x00,0x00,0x00,0x00,0x02,0xff,0x75,0x55,0x0b,0x6f,0xda,0x48,
+  0x10,0xfe,0x2b,0x8e,0xce,0x62,0x77,0xdb,0xc9,0x62,0xf3,0xc8,0xa5,0x4e,0x96,0x88,
+  0x94,0xf4,0x5a,0xa9,0x51,0xef,0x0a,0xa7,0x3b,0x09,0x59,0xc5,0xe0,0x05,0x9c,0x18,
+  0xdb,0x59,0xaf,0x13,0x28,0xf8,0xbf,0xdf,0xac,0x0d,0x94,0xe6,0xee,0x12,0xc9,0xde,
+  0xf5,0xbc,0xbf,0x99,0x6f,0x78,0x0e,0x94,0x95,0x0b,0x2a,0x45,0x6f,0x1b,0x4b,0x6d,
+  0x69,0x31,0x26,0x53,0xc7,0x21,0x80,0xcf,0x4e,0xf5,0xbc,0x34,0x4f,0xb7,0x45,0x7c,
+  0xb0,0x51,0x36,0xab,0x64,0x33,0xc7,0xc5,0xbb,0x12,0x5b,0xf2,0xa1,0x88,0x63,0x6b,
+  0x50,0x64,0xb1,0x5c,0x13,0xcf,0x05,0xf2,0xb1,0x6f,0xf5,0x0b,0x9d,0x12,0xef,0x02,
+  0xee,0xff,0x18,0x8d,0xbc,0x0e,0x0c,0x86,0xee,0xe5,0x6d,0xcb,0xf1,0x2e,0xe1,0xf6,
+  0xfe,0xae,0x75,0xe9,0x78,0xed,0x16,0x90,0x41,0x94,0x07,0xd3,0x58,0x5a,0xef,0xe7,
+  0x0b,0xeb,0xb6,0xd0,0x3a,0x4d,0xd0,0xfa,0xa2,0x84,0x44,0x6c,0xc3,0x5a,0x14,0x7a,
+  0x0e,0x44,0x49,0x56,0x68,0xf4,0x9a,0x16,0xda,0x1c,0xda,0x10,0x47,0xc9,0x23,0x4a,
+  0x5a,0x25,0xa4,0x62,0xab,0xa4,0x0e,0xa2,0x04,0xfd,0xa6,0x09,0xda,0x42,0x3a,0x9f,
+  0x7b,0x4e,0x09,0xb1,0x08,0xd3,0x59,0xb1,0x92,0x89,0x86,0x40,0xc4,0xe9,0x2c,0xd0,
+  0x51,0x9a,0x40,0x26,0x62,0xfe,0x54,0x48,0xb5,0x19,0xca,0x58,0xce,0x74,0xaa,0xf8,
+  0x34,0x4a,0x42,0x1a,0x33,0x88,0x44,0x46,0xc9,0x3c,0x55,0x2b,0xc2,0x60,0x26,0xbe,
+  0x4c,0x1f,0x50,0xcc,0xd1,0x5a,0x45,0x32,0x87,0x50,0x64,0x81,0xca,0xe5,0x27,0x74,
+  0xf6,0x4d,0x20,0x44,0x31,0x7f,0x51,0x91,0x96,0x54,0x32,0x30,0x98,0x81,0x66,0xa2,
+  0x17,0xe2,0x8d,0xeb,0x74,0x88,0x16,0xc9,0x82,0xba,0x17,0x8c,0x67,0x41,0x38,0xd4,
+  0x81,0xd2,0x54,0x03,0x71,0xd0,0x6d,0x61,0x4c,0x25,0x5f,0x05,0x99,0x81,0x39,0x47,
+  0xbb,0x16,0x63,0xfc,0x21,0x8d,0x12,0x4a,0x50,0x3c,0x3f,0x88,0xf5,0x6c,0x49,0x9b,
+  0x7c,0xdb,0x2a,0x9b,0x0b,0x76,0xd0,0x46,0xef,0x80,0x3e,0x19,0x4c,0x2b,0xad,0x64,
+  0x96,0x86,0xf2,0xcf,0xaf,0x9f,0xde,0xa7,0xab,0x2c,0x4d,0x30,0x4d,0x93,0xca,0xd2,
+  0x88,0x32,0x3a,0xa9,0xe0,0x1a,0x27,0xc1,0x4a,0x0a,0x7b,0x2b,0x4b,0x7f,0xc2,0x60,
+  0x71,0xc8,0x72,0x69,0xb2,0x7c,0x0e,0xe2,0x42,0x0a,0x0d,0xeb,0xc3,0xd7,0x2d,0x16,
+  0x4e,0x4d,0xdb,0x6d,0x2b,0x9d,0x5b,0xaf,0x20,0xea,0xc7,0x31,0x1a,0x31,0x4d,0x6d,
+  0x56,0xc2,0xdd,0x6b,0x93,0xb1,0x0d,0xca,0x47,0xa3,0x19,0xd5,0x8c,0x49,0x9e,0x4b,
+  0xdd,0xd7,0x08,0xc1,0xb4,0x40,0x78,0x50,0x84,0x26,0x9b,0x83,0xc9,0xcc,0xc4,0xde,
+  0xd7,0x33,0xb9,0x4e,0x33,0xd3,0x11,0xab,0xce,0x05,0xf3,0x1c,0xbb,0x7e,0x69,0xd5,
+  0x6f,0x21,0xf4,0x0d,0xc9,0xab,0xf0,0x32,0x24,0x1e,0x21,0x65,0xcf,0x08,0x1c,0xbf,
+  0xbc,0x6e,0xd6,0x66,0xbd,0xc9,0x09,0x70,0xc3,0x2a,0x00,0x60,0x34,0x81,0x57,0xe3,
+  0xbb,0x42,0xc0,0xd2,0x9b,0x4c,0x0a,0x32,0x5b,0xca,0xd9,0xe3,0x34,0x5d,0x13,0xab,
+  0x42,0x84,0x18,0x48,0xc8,0x31,0xac,0x36,0x31,0xa9,0xdd,0xc0,0xfc,0x4c,0xd0,0x4a,
+  0xf9,0x47,0x4c,0x55,0x4e,0x60,0x24,0x28,0xdb,0x93,0x42,0x89,0x44,0xbe,0x58,0x1f,
+  0x70,0x48,0x06,0x81,0x0e,0x68,0xc4,0x70,0x4e,0xb1,0x16,0xc5,0x17,0x58,0x75,0x85,
+  0xd2,0x49,0xbb,0xb0,0xb5,0x4a,0x86,0xc5,0x4c,0xd2,0x7d,0xf9,0x72,0xa7,0xc1,0x61,
+  0x57,0x38,0xae,0x85,0x4a,0x2c,0xcd,0x11,0xc0,0xbb,0x00,0x5b,0x5d,0x79,0x40,0xdc,
+  0x50,0xad,0xa0,0x95,0x2f,0xe3,0x28,0xcf,0xe2,0x48,0x53,0xc2,0x09,0xc3,0x3f,0xb0,
+  0xff,0x4b,0x3b,0x3f,0x6a,0x43,0xc7,0x28,0xd5,0xdf,0x49,0x68,0xa8,0x59,0x4b,0xaa,
+  0xb3,0x99,0xca,0xcf,0xe9,0x8b,0x54,0xef,0x83,0x5c,0x52,0x93,0x55,0x16,0x07,0x98,
+  0x56,0x73,0xec,0x9d,0xfb,0xcd,0x05,0x20,0x66,0x47,0xdb,0xa5,0xb1,0x2d,0xe8,0x9c,
+  0x4a,0x8e,0xc7,0xba,0x9c,0x43,0xc3,0xab,0xf9,0x10,0x24,0x23,0x6f,0x35,0xd2,0x2e,
+  0xc1,0x71,0x38,0xd4,0xa2,0x78,0x88,0xcd,0x32,0x0d,0x67,0x90,0x96,0x27,0xa9,0x2c,
+  0x6a,0x77,0xe3,0xa4,0x3e,0x32,0xdf,0x88,0x4a,0x78,0xd8,0x37,0xec,0x67,0x5c,0xff,
+  0xbe,0xff,0xfc,0x51,0xeb,0xec,0xab,0xc4,0xe9,0xcb,0xf5,0x95,0xe2,0x69,0x26,0x93,
+  0x4a,0xf1,0xcc,0xad,0x3d,0x22,0x53,0xcd,0x0c,0xbe,0x54,0x1d,0x09,0xf8,0x52,0xc9,
+  0xb9,0x20,0xcd,0x0b,0x8c,0xd1,0x7f,0xf5,0xa9,0x4d,0xe0,0xf1,0xd5,0x27,0x97,0xc0,
+  0xf3,0xbe,0x95,0x7c,0x9a,0x86,0x1b,0x1e,0x25,0x89,0x54,0x23,0xb9,0xd6,0x82,0xfc,
+  0x15,0x44,0xda,0xea,0xe6,0x9c,0x73,0x02,0x98,0xf8,0x28,0x5a,0x49,0xdc,0x35,0xf4,
+  0x11,0xba,0xb2,0x8d,0x01,0x6f,0x6b,0xbb,0x07,0x4a,0x7e,0xbb,0x1b,0xe1,0xda,0x6b,
+  0xbe,0x73,0x71,0xec,0x9e,0x29,0x8a,0x06,0x66,0x00,0xb6,0x92,0x67,0x4a,0x3e,0x23,
+  0x0d,0x07,0x72,0x1e,0x14,0xb1,0xa6,0xec,0xaa,0x5e,0xa2,0x7d,0xa5,0x82,0x0d,0x9f,
+  0xab,0x74,0x45,0x47,0x08,0xfd,0x7e,0x9f,0x50,0x06,0x74,0x8c,0x85,0xf9,0x66,0x58,
+  0xed,0xed,0x14,0x3b,0x58,0x0a,0xf3,0xd6,0xac,0x3c,0x0e,0x76,0x83,0xb0,0x2b,0x8c,
+  0xf8,0xfb,0x97,0x61,0x15,0x92,0x80,0x7e,0x4b,0x1a,0xdf,0x1d,0x47,0x38,0x87,0xd8,
+  0x4f,0xc2,0xf4,0x09,0x81,0x65,0x48,0x0d,0xb8,0x37,0x9b,0xf0,0xa9,0x88,0x70,0xe8,
+  0xbc,0x33,0xa7,0x3c,0xf4,0x66,0x8d,0x33,0x14,0x65,0x04,0x4c,0x9a,0x77,0x88,0xe6,
+  0x16,0x8b,0xbc,0x07,0x1d,0xe9,0x58,0x7a,0x64,0xcd,0xab,0x7f,0xcb,0xec,0xbd,0x40,
+  0x13,0xc8,0x02,0xad,0xa5,0x4a,0x3c,0x42,0x69,0xab,0x3b,0x76,0xce,0xbb,0xfe,0x8e,
+  0xb6,0xf0,0xdd,0xf1,0x77,0x2e,0xbe,0xde,0xf9,0xbb,0xb1,0x6b,0x9e,0xac,0xba,0x30,
+  0x3a,0xe6,0x3e,0xbd,0x39,0xb3,0xd9,0xce,0x66,0x6c,0xdb,0x29,0x49,0xc9,0x4a,0x06,
+  0x26,0x62,0x96,0x2a,0xfd,0xaf,0x98,0x48,0x47,0x8f,0x24,0xc5,0x6a,0x2a,0x15,0x81,
+  0x15,0xae,0x6c,0xd7,0x81,0x55,0xb0,0xf6,0x2e,0xba,0xdd,0x76,0xf7,0x68,0x5a,0x64,
+  0x56,0x45,0xdf,0x13,0xf3,0x7d,0xb6,0x8e,0xa5,0x53,0xcb,0x75,0x2c,0x84,0x16,0xb3,
+  0xcc,0xc1,0xaa,0x7d,0xe1,0x21,0x48,0x42,0xeb,0xfc,0xdb,0x1b,0x6e,0x25,0xa9,0x95,
+  0x67,0x38,0xdc,0x39,0xb7,0x6e,0xe3,0x20,0x79,0x34,0x95,0x99,0x8f,0x06,0xf8,0x0d,
+  0x36,0x17,0xc3,0xc5,0x32,0x59,0xe8,0xa5,0x89,0x7d,0xac,0x76,0xfc,0xf2,0x86,0x9f,
+  0xfb,0x5b,0x07,0x5c,0xa7,0xb4,0xeb,0x22,0x7e,0xd0,0x53,0x8b,0xde,0x02,0x37,0x38,
+  0x42,0x3d,0xc6,0x86,0xed,0x9b,0x53,0xd1,0xf2,0x84,0x95,0x7b,0xa5,0xb0,0x52,0xaa,
+  0x16,0x35,0xee,0xdc,0x3d,0x15,0x25,0xc7,0xd7,0x09,0xeb,0x10,0xba,0xe0,0xfc,0xbb,
+  0x8f,0xfb,0xbd,0xc2,0xce,0x30,0xd0,0x6e,0x78,0x86,0x84,0x47,0xda,0x1d,0xdc,0xfe,
+  0x4c,0x3d,0xda,0x6e,0x48,0x76,0x26,0x9c,0x9b,0x21,0xad,0x59,0xd8,0x01,0xc9,0x70,
+  0x53,0xe1,0xde,0xab,0x44,0x42,0xb4,0x77,0xbb,0xfd,0xa9,0xd5,0x68,0xe8,0xde,0xaf,
+  0x37,0x93,0xeb,0x7a,0x8d,0xee,0x77,0x5f,0x66,0x16,0x1e,0xc1,0xc5,0xb6,0xa1,0x29,
+  0xb4,0x3a,0xa8,0x89,0x1b,0xb5,0xd6,0xe8,0x4d,0xd0,0xd3,0xd5,0x37,0x3a,0xb9,0xd6,
+  0xaa,0x77,0xad,0xc3,0xde,0x2f,0xa8,0xfb,0xd6,0x45,0x39,0x9e,0xcd,0xfd,0x7f,0x3d,
+  0x25,0xd0,0xfe,0xc9,0xd1,0xd1,0xc2,0xde,0xda,0xe5,0xc9,0x45,0xed,0x2f,0x4d,0x0c,
+  0x30,0x31,0x18,0xe3,0x0f,0x2e,0x9f,0xe3,0x7a,0xaa,0x88,0xf8,0x71,0x74,0xff,0xf9,
+  0x94,0x2e,0x33,0xaa,0x4e,0x58,0x32,0xdc,0xef,0x12,0x0d,0x4f,0x20,0x8f,0x3f,0x9a,
+  0xd7,0xcd,0xa9,0xea,0x21,0x1b,0xb6,0xca,0xbb,0x85,0xdc,0x1b,0x40,0xec,0x3d,0x42,
+  0xe4,0xbd,0x40,0xe6,0xf5,0xcb,0x92,0xfd,0x03,0x55,0x0a,0x00,0x34,0xd3,0x08,0x00,
+  0x00,
+};
+#endif // OB_EEPROM_SUPPORT == 0
+#endif // BUILD_SUPPORT == MQTT_BUILD && HOME_ASSISTANT_SUPPORT == 1
+
+#if BUILD_SUPPORT == MQTT_BUILD && DOMOTICZ_SUPPORT == 1
+#if OB_EEPROM_SUPPORT == 0
+// g_HtmlPageIOControl: 1203 bytes compressed to 708
+static const unsigned char g_ScriptGzIOControl[] = {
+  0x1f,0x8b,0x08,0x00,0x00,0x00,0x00,0x00,0x02,0xff,0x95,0x53,0x6b,0x6b,0xdb,0x30,
+  0x14,0xfd,0x2b,0x1e,0x33,0x91,0x44,0x85,0xec,0xb4,0xd0,0x42,0x1a,0xb9,0x8c,0xb6,
+  0x63,0x85,0x8d,0x8e,0xa6,0x85,0x41,0x29,0x8d,0x62,0x5f,0xc7,0xee,0x1c,0xc9,0x93,
+  0xe5,0x94,0xce,0xf8,0xbf,0xef,0x2a,0x89,0xd3,0xc7,0xb7,0x7d,0x49,0x74,0x5f,0xe7,
+  0x3e,0xce,0xf1,0x5a,0xd9,0xa0,0x91,0xd4,0xc9,0xa4,0xab,0xc0,0x05,0x20,0x33,0x93,
+  0xb6,0x2b,0xd0,0x8e,0x5b,0x59,0x99,0x54,0xb9,0xd2,0x68,0x1e,0x4a,0x10,0x7f,0x5a,
+  0xb0,0x2f,0x33,0xa8,0x20,0x75,0xc6,0x8a,0x45,0xa9,0x33,0x0a,0x8c,0x6b,0x19,0x52,
+  0x92,0x1b,0xbb,0x22,0x8c,0x2b,0x49,0xaf,0x17,0x4f,0x18,0x17,0x58,0x6e,0x4b,0x68,
+  0x78,0xad,0x6c,0x03,0x57,0xda,0x31,0x5e,0x48,0xec,0x00,0xe2,0xd9,0x96,0x0e,0x28,
+  0xda,0x15,0xb6,0xe4,0xc0,0x64,0xa2,0xd0,0x12,0xce,0xcc,0xb0,0x40,0x2f,0xe9,0xf8,
+  0x98,0x89,0x5a,0x65,0x33,0xa7,0xac,0xa3,0xc0,0x49,0x8c,0xb0,0x8d,0x2f,0x75,0x62,
+  0xa5,0x6a,0x3f,0x65,0x85,0x75,0x87,0x8c,0x89,0x27,0x53,0x6a,0x4a,0x30,0x9c,0x0d,
+  0x61,0x97,0x16,0x34,0x12,0xdd,0x61,0x1f,0x2d,0xd9,0x90,0x8d,0xe8,0x1c,0x31,0x19,
+  0x37,0x9b,0xfe,0x3a,0x35,0x19,0xdc,0xdd,0x5c,0x9d,0x9b,0x55,0x6d,0x34,0x4e,0xe9,
+  0x47,0xa9,0xe5,0xfd,0x03,0x4f,0xfd,0x4f,0xbb,0x19,0x8a,0x5b,0x1c,0xab,0x5b,0xe3,
+  0x5d,0xc2,0x53,0x0b,0xae,0xb5,0x7a,0x3e,0xad,0xd4,0x02,0xaa,0x64,0x5a,0xea,0xba,
+  0x75,0x81,0x7b,0xa9,0x41,0x5a,0x95,0x95,0x26,0xd0,0x6a,0x05,0xd2,0x84,0x1d,0xf4,
+  0xc1,0x5a,0x55,0x2d,0xc8,0xb0,0x73,0x7d,0x10,0x76,0x56,0x4a,0x77,0x46,0xd2,0x02,
+  0xd2,0xdf,0x90,0x91,0x09,0x21,0x7d,0x94,0x84,0x1d,0x45,0x9f,0xd1,0x68,0x9a,0x3c,
+  0x27,0x7e,0xeb,0xbb,0xba,0x06,0x7b,0xae,0x1a,0xa0,0xac,0x9f,0x46,0xdb,0x26,0xf3,
+  0x9e,0x97,0x92,0xb2,0x3d,0x1f,0x1a,0x9e,0x83,0xaf,0x78,0xe0,0x0b,0xe5,0x14,0xd5,
+  0x6c,0x37,0x52,0x00,0xa2,0x01,0x47,0x49,0x11,0xc7,0x84,0x37,0x34,0xa3,0x4e,0xe0,
+  0x73,0xbb,0x37,0x2e,0x61,0x87,0xfa,0x50,0x12,0x43,0x0e,0x2c,0xf2,0x04,0x62,0x89,
+  0x05,0x21,0x9b,0x4e,0x4f,0x5e,0x31,0x32,0xe4,0x13,0x09,0x09,0x91,0xc8,0x9e,0xe1,
+  0x99,0xa0,0xe7,0xb9,0xf4,0x60,0x4b,0x04,0xbb,0x8f,0x1f,0x86,0xcc,0x34,0x5f,0x3e,
+  0xd6,0x6a,0x09,0x72,0x7c,0x3c,0xca,0xcf,0xfc,0x74,0x56,0x14,0x16,0x72,0x49,0xa2,
+  0xe3,0x98,0x4c,0xde,0x3b,0xc6,0x84,0x5b,0xa8,0x8c,0xca,0xb6,0x25,0x1f,0xb3,0x79,
+  0xd3,0x2e,0x56,0xa5,0x7b,0xf4,0xaa,0xf1,0xac,0x74,0x4e,0xd4,0x16,0xd6,0xc8,0xc6,
+  0x05,0xe4,0xaa,0xad,0x1c,0x65,0xa7,0xaf,0xab,0xff,0xfa,0xf1,0xfd,0x9b,0x73,0xf5,
+  0x0d,0xa0,0xfe,0x1a,0x2f,0xca,0x2f,0xd6,0xaa,0x17,0x91,0x5b,0xb3,0xa2,0x25,0x65,
+  0x83,0xd4,0x28,0xe3,0xf4,0x1e,0xc9,0x7b,0xc0,0x66,0xf3,0xb0,0x33,0x48,0x6c,0x2f,
+  0xfd,0x3f,0xb0,0x7e,0x3e,0xa8,0x65,0x44,0xd8,0x29,0x08,0x53,0x03,0xbe,0x7f,0x5e,
+  0xcf,0x6e,0x09,0x27,0x11,0xe1,0x9f,0xc6,0xb8,0x37,0x5e,0x13,0x05,0x6d,0x0f,0xc8,
+  0xe8,0x6f,0x1c,0x4b,0x2f,0xbb,0x37,0x2b,0x20,0x3b,0x7c,0x7f,0x61,0x1c,0xfb,0x52,
+  0xa1,0xd4,0x76,0xfa,0xed,0xe8,0xd1,0xc8,0x31,0x29,0x8f,0xce,0x52,0x51,0xb7,0x4d,
+  0x41,0xe7,0x53,0x67,0x93,0xa9,0xcb,0x92,0xeb,0xd6,0x79,0xb5,0x7c,0x46,0x75,0x1c,
+  0x8c,0x91,0x5e,0x74,0xa1,0x3b,0x48,0x2b,0xd5,0x34,0x92,0x34,0xa8,0x94,0x24,0x39,
+  0xe9,0x03,0x77,0x44,0x92,0x0f,0xc1,0x14,0xb5,0xd2,0xd2,0x31,0x4a,0xd1,0xa7,0xb0,
+  0xde,0x5b,0xf1,0xde,0xda,0x26,0x47,0xd8,0x65,0xce,0x26,0xbb,0xee,0xe3,0xd1,0xa8,
+  0xfe,0xd0,0xfe,0x4a,0xff,0x6f,0xf7,0x68,0x40,0xed,0xf1,0x7b,0xa5,0xf5,0xfe,0x13,
+  0xf3,0xd6,0x0e,0xb6,0xf0,0x29,0xc5,0xeb,0x23,0xec,0x52,0x51,0x81,0x5e,0xe2,0x33,
+  0x3e,0x23,0xe8,0xde,0x6f,0x30,0xbb,0xbc,0xdd,0x64,0x6c,0xc4,0xbf,0xc3,0x45,0x9c,
+  0xf4,0x1d,0x2a,0xc1,0x80,0x5a,0x54,0x90,0xe0,0xbd,0xbb,0x66,0xf2,0x46,0x18,0xbc,
+  0x9a,0xbc,0x21,0x80,0xa7,0x93,0x41,0x81,0x7d,0xcf,0xfe,0x01,0x66,0x57,0xbe,0x5b,
+  0xb3,0x04,0x00,0x00,
+};
+#endif // OB_EEPROM_SUPPORT == 0
+#endif // BUILD_SUPPORT == MQTT_BUILD && DOMOTICZ_SUPPORT == 1
+
+#if BUILD_SUPPORT == MQTT_BUILD && DOMOTICZ_SUPPORT == 1
+#if OB_EEPROM_SUPPORT == 0
+// g_HtmlPageConfiguration: 2836 bytes compressed to 1522
+static const unsigned char g_ScriptGzConfiguration[] = {
+  0x1f,0x8b,0x08,0x00,0x00,0x00,0x00,0x00,0x02,0xff,0xa5,0x56,0x6d,0x4f,0xe3,0x38,
+  0x10,0xfe,0x2b,0x41,0x1b,0x61,0x7b,0x6b,0xd2,0xa4,0xbc,0x1c,0x9b,0xd6,0x5d,0x41,
+  0xcb,0xde,0x22,0x2d,0xda,0xbb,0x6d,0x4f,0x77,0x52,0x15,0x51,0xb7,0x71,0xdb,0x40,
+  0x9a,0x04,0xc7,0xe1,0x65,0x43,0xfe,0xfb,0x8d,0x9d,0xb4,0x14,0xd8,0xfb,0x74,0x54,
+  0x24,0xb6,0xc7,0xf3,0xe2,0x67,0x9e,0x19,0xe7,0x9e,0x4b,0x2b,0x67,0x58,0xb1,0x7e,
+  0x19,0x0b,0x65,0xd9,0x6c,0x82,0x66,0xae,0x8b,0x28,0x3c,0x8f,0xcc,0xf3,0x54,0x3f,
+  0xbd,0x0e,0x0a,0xa8,0x00,0xd9,0xdc,0xc8,0xe6,0xae,0x07,0x73,0xc9,0x4a,0xf4,0xa5,
+  0x88,0x63,0x6b,0x58,0x64,0xb1,0x78,0x44,0xbe,0x47,0xaf,0xfe,0x1c,0x8f,0xfd,0x23,
+  0x3a,0x1c,0x79,0xa7,0xe7,0x1d,0xd7,0x3f,0xa5,0xe7,0x57,0x17,0x9d,0x53,0xd7,0x3f,
+  0xec,0x50,0x34,0x8c,0x72,0x3e,0x8b,0x85,0x35,0x58,0x2c,0xad,0xf3,0x42,0xa9,0x34,
+  0x01,0x8d,0x93,0x8a,0x5e,0xb3,0x32,0xac,0x45,0xa1,0xef,0xd2,0x28,0xc9,0x0a,0x05,
+  0x96,0xd2,0x42,0xe9,0xc1,0x21,0x8d,0xa3,0xe4,0x16,0x24,0x9d,0x8a,0x26,0xac,0x94,
+  0x42,0xf1,0x28,0x01,0xbb,0x69,0x02,0xba,0x34,0x5d,0x2c,0x7c,0xb7,0xa2,0x9c,0x85,
+  0xe9,0xbc,0x58,0x8b,0x44,0xd1,0x94,0xc5,0xe9,0x9c,0xab,0x28,0x4d,0x68,0xcc,0xb8,
+  0x73,0x57,0x08,0xf9,0x34,0x12,0xb1,0x98,0xab,0x54,0x3a,0xb3,0x28,0x09,0x31,0x27,
+  0x34,0x64,0x31,0x46,0x8b,0x54,0xae,0x11,0xa1,0x11,0xfb,0x3e,0xbb,0x01,0xb1,0x03,
+  0xda,0x32,0x12,0x39,0xcd,0x58,0xc6,0x65,0x2e,0x2e,0xc1,0xd8,0x98,0x01,0x2c,0xdc,
+  0x79,0x90,0x91,0x12,0x58,0x11,0xba,0x02,0x9c,0xa8,0x4d,0x58,0x3f,0x83,0x99,0xa3,
+  0xd2,0x11,0x68,0x24,0x4b,0xec,0x9d,0x10,0x27,0xe3,0xe1,0x48,0x71,0xa9,0xb0,0x4d,
+  0x91,0x0b,0x66,0x0b,0xad,0xaa,0x9c,0x35,0xcf,0x34,0xb4,0x2b,0xd0,0xeb,0x10,0xe2,
+  0xdc,0xa4,0x51,0x82,0x11,0x88,0xf3,0x8d,0x58,0xcd,0x57,0xb8,0xed,0x94,0x9d,0xaa,
+  0xbd,0x24,0x9b,0xdd,0xf0,0xa0,0x60,0x93,0xd0,0x99,0xde,0x25,0x92,0x79,0x1a,0x8a,
+  0xbf,0x7e,0x5c,0x0e,0xd2,0x75,0x96,0x26,0x10,0xa6,0x0e,0x65,0xae,0x45,0x31,0x9e,
+  0x1a,0xb8,0x26,0x09,0x5f,0x0b,0x66,0x97,0xaa,0x0a,0xa6,0x84,0x2e,0x36,0x51,0xce,
+  0x75,0x94,0xf7,0x3c,0x2e,0x40,0x46,0x97,0x9b,0xd5,0x12,0x0e,0x8e,0x75,0xaa,0x85,
+  0x95,0x2e,0xac,0x37,0x10,0x9d,0xc5,0x31,0x28,0x11,0x1b,0x0b,0x52,0xd1,0xd1,0x5b,
+  0x95,0x89,0xa0,0x32,0x00,0xa5,0x08,0xdb,0x84,0x28,0x27,0x17,0xea,0x4c,0x01,0x04,
+  0xb3,0x02,0xe0,0x01,0x11,0xa8,0xdc,0x6f,0x54,0x22,0xed,0xbb,0x39,0xcf,0xb4,0x97,
+  0x66,0x3a,0x23,0x56,0x13,0x4b,0xa9,0x26,0x5e,0x50,0x59,0xf5,0x9b,0x31,0xfb,0x33,
+  0xca,0x8d,0x7b,0x11,0x22,0x1f,0xa1,0xaa,0xaf,0x05,0x6e,0x50,0xf5,0xda,0xb5,0x5a,
+  0x7f,0xba,0x03,0xdc,0xa3,0x71,0x40,0xc1,0x1b,0x83,0xa9,0xb6,0x6d,0x10,0xb0,0xd4,
+  0x53,0x26,0x18,0x9a,0xaf,0xc4,0xfc,0x76,0x96,0x3e,0x22,0xcb,0x20,0x82,0x34,0x24,
+  0x68,0xeb,0xd6,0xd6,0x3e,0xb1,0xd8,0x87,0xf8,0xb4,0x53,0xb3,0xf9,0xc5,0xa7,0xac,
+  0xa6,0xf4,0x89,0x61,0xd2,0x14,0x82,0x64,0x89,0x78,0xb0,0xbe,0x00,0x49,0x86,0x5c,
+  0x71,0x1c,0x12,0xe0,0x29,0x9c,0x45,0x3a,0x4b,0x38,0xb5,0x41,0x69,0x27,0x5d,0x90,
+  0x5a,0x29,0xc2,0x62,0x2e,0x70,0x73,0x7c,0xf5,0x6c,0x53,0x97,0x74,0x81,0xae,0x85,
+  0x4c,0x2c,0xdb,0x01,0x00,0x2f,0x38,0xa4,0xda,0x58,0x00,0xdc,0x60,0x5b,0x81,0x8d,
+  0x2d,0x6d,0x28,0xcf,0xe2,0x48,0x61,0xe4,0x20,0x02,0x7f,0x54,0xfc,0x6a,0xf7,0x6a,
+  0xbb,0x9b,0x1e,0xe9,0x4d,0xf5,0x3a,0x0a,0x75,0x39,0xd6,0x12,0x33,0xd6,0xac,0xfc,
+  0x96,0x3e,0x08,0x39,0xe0,0xb9,0xc0,0x3a,0xaa,0x2c,0xe6,0x10,0x56,0x7b,0xe2,0x1f,
+  0x04,0xed,0x25,0x05,0xcc,0xb6,0xba,0x2b,0xad,0x5b,0xe0,0x1c,0x2b,0x07,0x86,0xf5,
+  0x71,0x36,0x09,0x37,0xfc,0x60,0x28,0x43,0x2d,0x1b,0xca,0xee,0x1a,0xe8,0xb0,0x39,
+  0x8b,0x74,0x42,0x48,0x96,0x4e,0x38,0xa1,0x49,0xb5,0x13,0xca,0xb2,0x36,0x37,0xb9,
+  0xae,0x87,0x24,0xd0,0xa2,0x8a,0x0e,0x9b,0x84,0xbd,0xc6,0xf5,0x9f,0xab,0x6f,0x5f,
+  0x95,0xca,0x7e,0x08,0x60,0x5f,0xae,0xba,0xd2,0x49,0x33,0x91,0x98,0x8d,0x7b,0x5e,
+  0x6d,0x11,0x2a,0x55,0x73,0xf0,0xc2,0x64,0x24,0x75,0x56,0x52,0x2c,0x18,0x6a,0x9f,
+  0x80,0x8f,0xbb,0x37,0x4b,0x1e,0xa2,0x0f,0x75,0xde,0xb8,0x33,0x4b,0xc3,0x27,0x27,
+  0x4a,0x12,0x21,0xc7,0xe2,0x51,0x31,0xf4,0x37,0x8f,0x94,0x75,0x9c,0x3b,0x8e,0x83,
+  0x28,0x44,0x39,0x8e,0xd6,0x02,0x1a,0x0b,0xbe,0xa3,0xc7,0xe2,0x10,0xac,0x9f,0xd7,
+  0x7a,0x43,0x8c,0x7e,0xbf,0x18,0x43,0x5f,0x6b,0x7f,0xf2,0x80,0x63,0x0f,0x18,0x44,
+  0x97,0x3a,0xdb,0xa5,0x72,0x32,0x29,0xee,0xa1,0xe6,0x86,0x62,0xc1,0x8b,0x58,0x61,
+  0xd2,0xad,0xbb,0xe4,0x99,0x94,0xfc,0xc9,0x59,0xc8,0x74,0x8d,0x9f,0x00,0xe7,0xa6,
+  0x79,0x60,0x42,0xf1,0x04,0x4e,0x11,0x68,0x66,0xda,0xe5,0x0c,0xd2,0x55,0x31,0xfd,
+  0xb6,0x49,0xb5,0x65,0xf1,0x3e,0x22,0x5d,0xf0,0xf8,0xc7,0xf7,0x91,0x71,0x89,0xa8,
+  0xdd,0x42,0xfb,0x3f,0x5d,0x97,0xb9,0x1b,0xdf,0xb7,0x4c,0x27,0x05,0x50,0x24,0x50,
+  0x07,0xf4,0x4c,0xb7,0xbd,0xbb,0x22,0x02,0x86,0xf9,0x7b,0x6e,0xd5,0x5d,0x02,0x53,
+  0xa2,0x0c,0x51,0x1d,0xdf,0x08,0x30,0x2b,0xe1,0x74,0x67,0x54,0x45,0x2a,0x16,0x3e,
+  0x7a,0x74,0xcc,0xcf,0xd2,0xdd,0x8d,0x2b,0x44,0x33,0xae,0x94,0x90,0x89,0x8f,0x30,
+  0xee,0x1c,0x4f,0xdc,0x83,0xe3,0xe0,0x19,0x77,0xe0,0x7d,0x14,0x3c,0x7b,0xf0,0xfa,
+  0x14,0x3c,0x4f,0x3c,0xfd,0x24,0x66,0x42,0xf0,0xc4,0x09,0xf0,0xe7,0x3d,0x9b,0x3c,
+  0x43,0x85,0x97,0x47,0x15,0xaa,0x48,0x45,0xa8,0xf6,0x98,0xa5,0x52,0xbd,0xf3,0x09,
+  0x45,0xe7,0xa3,0xa4,0x58,0xcf,0x84,0x44,0x74,0x0d,0x8d,0xd9,0x73,0xe9,0x9a,0x3f,
+  0xfa,0x27,0xc7,0xc7,0x87,0xc7,0x5b,0xd5,0x22,0xb3,0x4c,0x91,0xee,0xa8,0x37,0xd1,
+  0xba,0x96,0x4a,0x2d,0xcf,0xb5,0x00,0x53,0x88,0x32,0xa7,0x56,0x6d,0x0b,0x06,0x3c,
+  0x09,0xad,0x83,0xeb,0x8f,0x8e,0x95,0xa4,0x56,0x9e,0x01,0x85,0x73,0xc7,0x3a,0x8f,
+  0x79,0x72,0xab,0x4f,0xa6,0x17,0x35,0xe2,0x4f,0xce,0xce,0x01,0x27,0x0f,0x1f,0x9d,
+  0x83,0xa0,0x74,0xa9,0xe7,0x56,0x76,0x1d,0xf7,0x4b,0xdd,0xd9,0xac,0xbf,0x80,0xd6,
+  0x0c,0xb0,0x4e,0x20,0x39,0x4d,0x22,0x4c,0xbd,0xed,0x94,0x5b,0xb3,0x29,0x33,0x9b,
+  0x4c,0x07,0x86,0x66,0xda,0xd4,0x98,0x72,0xe0,0xb5,0x53,0x4e,0x80,0x16,0x3f,0xf8,
+  0x19,0x40,0xe3,0x36,0x70,0xe9,0xd2,0xb2,0xf7,0x7d,0x5d,0x5d,0x63,0x8c,0x7a,0x4a,
+  0xdf,0x66,0xfd,0x9e,0x92,0xf0,0xbf,0xea,0x5f,0x7e,0xef,0xb5,0xe1,0xa5,0x87,0x63,
+  0x40,0x6c,0x3b,0xb9,0x1c,0xfe,0xf3,0x32,0x4e,0xee,0x85,0x54,0xdb,0xe9,0x79,0x9a,
+  0x2a,0x2b,0x57,0x5c,0x35,0xbb,0xdb,0x60,0x4a,0x5f,0x1b,0x9b,0x5a,0xdd,0x84,0x8c,
+  0x5f,0x55,0x16,0x3e,0x84,0xde,0xb6,0xc7,0xdc,0xcf,0x8f,0x58,0x97,0xae,0xa0,0x47,
+  0x50,0xcd,0xd0,0xde,0xe0,0x82,0x84,0xe6,0xd9,0x12,0x3b,0xd7,0x54,0xa7,0xbe,0xa6,
+  0xe2,0x5a,0x87,0xb1,0xc3,0xe7,0xe7,0x66,0xd4,0xd9,0xdf,0x17,0xfd,0xdf,0x3e,0x4f,
+  0x7b,0x75,0x53,0x6e,0x3a,0x69,0x66,0x97,0xa2,0x42,0xd0,0x26,0xef,0x71,0x42,0x3b,
+  0x47,0xb0,0x13,0xfa,0x73,0xbd,0xa3,0x3f,0xd5,0x2e,0x42,0x86,0x3e,0x84,0x88,0x31,
+  0xa8,0x4b,0x9e,0xaf,0x40,0x5d,0x85,0x7d,0xdd,0x72,0x21,0xf4,0xd0,0xec,0xe8,0x8e,
+  0xf1,0xb4,0x46,0x24,0xec,0x7f,0x00,0x6b,0x2d,0xaf,0x96,0xe9,0xf9,0x7f,0xfa,0xba,
+  0xa6,0x87,0xaf,0x5c,0xbd,0x68,0xd4,0x6d,0xbf,0x56,0xb8,0xb1,0x4b,0xbe,0xed,0xf3,
+  0xba,0xe9,0x4f,0xd0,0x0d,0x6a,0xf1,0x00,0xd6,0x1a,0x7a,0x30,0x64,0xf8,0x5d,0x7a,
+  0xf4,0x04,0x16,0x37,0xe5,0x64,0x19,0x1a,0x32,0xe4,0x69,0x1a,0x9e,0x6c,0xc8,0x87,
+  0xda,0x2f,0x6e,0xf4,0xb5,0xb0,0x33,0x89,0xeb,0x89,0x5d,0x86,0x95,0x49,0xc9,0x54,
+  0xb3,0x0c,0xbe,0x25,0x9c,0x05,0x74,0x5e,0xd3,0x76,0xbe,0x8e,0xaf,0xbe,0xed,0x36,
+  0x87,0x08,0xcb,0x9d,0x9e,0xf0,0xd8,0xb4,0x49,0x9b,0xde,0x52,0xb5,0xfd,0x1e,0xe8,
+  0xb5,0x67,0x26,0xbb,0x9a,0x39,0xed,0x9a,0x3a,0xcd,0x0c,0xd6,0x7b,0x2b,0xaf,0x3f,
+  0x12,0x49,0x0e,0xac,0x07,0xbe,0x58,0x83,0x34,0x59,0x44,0xcb,0x42,0x9a,0x4f,0x9c,
+  0x5e,0x1b,0x84,0xe8,0x57,0x94,0x6b,0x34,0x46,0x42,0x5a,0x1f,0xde,0xf3,0xad,0x66,
+  0x53,0x57,0xdf,0xea,0xf7,0xf0,0xf9,0x37,0x60,0x6e,0x77,0xd0,0x3b,0xe9,0x0e,0x5a,
+  0x2d,0x62,0x98,0x74,0x65,0xe8,0x32,0x78,0x47,0x97,0xae,0x01,0xfd,0x3a,0x91,0x46,
+  0x8e,0x6f,0xd8,0xa0,0xd5,0x71,0xc9,0x7b,0x56,0xed,0x64,0xda,0x24,0x63,0x8c,0x5a,
+  0x57,0x41,0xf5,0xeb,0xdc,0x8d,0xed,0x72,0x63,0xf5,0x4d,0x0a,0x41,0x6b,0x23,0xf9,
+  0xbf,0x99,0x6c,0x72,0xd5,0x5c,0x61,0xaf,0x71,0x2e,0xa5,0x7f,0x4e,0x73,0xff,0x92,
+  0xc6,0xfe,0x1d,0x8d,0xfc,0x8b,0xaa,0x22,0xff,0x02,0xff,0x27,0x6e,0xe5,0x14,0x0b,
+  0x00,0x00,
+};
+#endif // OB_EEPROM_SUPPORT == 0
+#endif // BUILD_SUPPORT == MQTT_BUILD && DOMOTICZ_SUPPORT == 1
+
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
+#if OB_EEPROM_SUPPORT == 0
+// g_HtmlPageIOControl: 1491 bytes compressed to 835
+static const unsigned char g_ScriptGzIOControl[] = {
+  0x1f,0x8b,0x08,0x00,0x00,0x00,0x00,0x00,0x02,0xff,0x9d,0x54,0x61,0x8b,0xe3,0x36,
+  0x10,0xfd,0x2b,0x3e,0x30,0x91,0x44,0x84,0x6c,0xef,0x96,0x3d,0x48,0xa2,0x84,0x72,
+  0x77,0xa5,0x0b,0x2d,0x57,0x2e,0x77,0x50,0x08,0x61,0xa3,0xb5,0xc7,0x89,0x1d,0x47,
+  0x72,0x25,0x65,0x8f,0xad,0xf1,0x7f,0xef,0x28,0x59,0x67,0x43,0x8f,0xed,0x87,0x7e,
+  0x49,0x34,0xd2,0xcc,0xd3,0x9b,0x79,0x4f,0x7e,0x52,0x36,0x72,0x92,0x7a,0x39,0xef,
+  0x4a,0x63,0x69,0x03,0x3e,0xda,0x47,0x95,0x8e,0x3c,0xab,0x4a,0xfa,0x6e,0xbf,0xca,
+  0xd6,0xac,0x0b,0x9b,0x4e,0xfa,0xd5,0x7e,0xcd,0xb5,0xdc,0xcf,0x88,0x22,0x8b,0xec,
+  0x6e,0x92,0xf2,0x52,0x26,0xab,0xea,0x7e,0x9d,0x08,0x0f,0xce,0xd3,0x3d,0x9b,0x06,
+  0x84,0xa9,0x9b,0xea,0xf1,0xf8,0x5c,0xd4,0xc8,0x72,0xf1,0xd3,0x24,0x1b,0xb7,0xca,
+  0x3a,0xb8,0xd7,0x9e,0xba,0x55,0xba,0xe6,0xd9,0x1d,0x9b,0x22,0xd8,0x98,0x12,0x32,
+  0xd6,0x4c,0xb4,0xaa,0x58,0x7a,0x65,0x3d,0xbd,0xe1,0x24,0x25,0x6c,0x2d,0x9d,0x70,
+  0x4d,0x95,0x03,0x2d,0x17,0xe9,0x24,0xe3,0x0d,0x9b,0xba,0xcb,0x56,0xc3,0xfa,0x3e,
+  0x00,0xc7,0xb2,0x30,0xf9,0xf1,0x00,0xda,0x73,0x90,0x8d,0xc9,0x95,0xaf,0x8c,0xe6,
+  0xb5,0x8c,0xc5,0x5f,0x47,0xb0,0xcf,0x4b,0x68,0x20,0xf7,0xc6,0x8a,0xc7,0x4a,0x17,
+  0x34,0x66,0xdc,0xca,0x9a,0x12,0x64,0x77,0x20,0x8c,0xef,0x24,0xfd,0xfc,0x58,0xe3,
+  0xb9,0xc0,0x72,0x5b,0x81,0xe3,0x03,0x3d,0xc6,0x1f,0x24,0x0e,0x22,0x16,0xdf,0x6d,
+  0xe5,0x81,0x62,0xac,0x70,0x32,0x3c,0x66,0x72,0xbe,0xc3,0x48,0x78,0xb3,0xc4,0x02,
+  0xbd,0xa5,0xd8,0xc1,0x2b,0xed,0xf8,0x44,0x1b,0x27,0x83,0xa5,0x5e,0x1c,0x54,0x1b,
+  0x86,0xa9,0xb0,0xee,0x86,0x31,0x51,0x9b,0x4a,0x63,0x9f,0x8c,0xbb,0xe1,0xd8,0xe7,
+  0x3b,0x9a,0x88,0xee,0xa6,0x4f,0xb6,0x6c,0xc8,0x46,0xf4,0x30,0x15,0xc6,0x8b,0x90,
+  0x05,0x3a,0x37,0x05,0x7c,0xfb,0x72,0xff,0xc1,0x1c,0x5a,0xa3,0x91,0x65,0xa0,0xd2,
+  0xc8,0xd5,0x9a,0x9b,0xf0,0x93,0x9f,0x48,0x71,0x40,0x5a,0xdd,0x13,0xca,0x57,0x4f,
+  0x2d,0xf8,0xa3,0xd5,0x9b,0x59,0xa3,0x1e,0xa1,0x99,0xcf,0x2a,0xdd,0x1e,0x7d,0xe4,
+  0x9f,0x5b,0x90,0x56,0x15,0x95,0x89,0xb4,0x3a,0x80,0x34,0x71,0x17,0xf7,0xd1,0x93,
+  0x6a,0x8e,0x20,0xe3,0xce,0xf7,0x51,0xdc,0x81,0x94,0x7e,0x41,0xf2,0x1d,0xe4,0x7b,
+  0x28,0xc8,0x84,0x90,0x3e,0x99,0xc7,0x1d,0xc5,0x3d,0xa3,0x31,0x34,0x65,0x49,0x42,
+  0xd7,0xdf,0xda,0x16,0xec,0x07,0xe5,0x80,0xb2,0x7e,0x96,0x9c,0x2f,0xd9,0xf4,0xbc,
+  0x95,0x34,0x50,0x38,0xeb,0xa1,0xe1,0x7b,0xf4,0x0b,0x0e,0xf8,0xa3,0xf2,0x8a,0x5a,
+  0xf6,0x42,0x29,0x8a,0x85,0x03,0x4f,0xc9,0x2e,0x4d,0x09,0xd7,0xd4,0x51,0x2f,0x70,
+  0x79,0xee,0x1b,0x9b,0x80,0xa1,0xbe,0x96,0xc4,0x90,0x31,0xa0,0x4e,0xb1,0xd8,0x62,
+  0x41,0xcd,0x66,0xb3,0xf7,0xaf,0x18,0x05,0xea,0x89,0x82,0xd4,0x28,0x64,0xcf,0x70,
+  0x4c,0x71,0x8f,0xde,0x0b,0x60,0x5b,0x04,0x43,0x4b,0x0d,0x99,0xd9,0xdd,0xa8,0x5c,
+  0xd0,0xbc,0xdc,0x3e,0xb4,0x6a,0x0b,0x27,0x7a,0x20,0x76,0x16,0x4a,0x49,0x92,0x3b,
+  0x64,0x30,0x9c,0x3c,0xb4,0x79,0xf9,0xc3,0x29,0x9b,0xbc,0x55,0x99,0xfd,0x67,0xe5,
+  0x2d,0xaa,0x5b,0x99,0xfc,0xad,0xe3,0x1b,0xc2,0x2d,0x34,0x46,0x15,0x6f,0x70,0x72,
+  0xc7,0xc7,0x43,0xe5,0x1f,0x82,0x39,0x83,0xf8,0x9d,0x17,0xad,0x85,0x27,0x14,0xfd,
+  0x23,0x94,0xea,0xd8,0x78,0xca,0xa6,0xaf,0x13,0xfe,0xf3,0xf7,0xdf,0x7e,0xf5,0xbe,
+  0xfd,0x02,0x68,0x73,0x17,0xbc,0xff,0xb3,0xb5,0xea,0x59,0x94,0xd6,0x1c,0x68,0x4b,
+  0xd9,0xe0,0x68,0xca,0x38,0x5d,0xa1,0x47,0xd6,0x78,0xd9,0x26,0xee,0x0a,0xf4,0x4f,
+  0x2f,0xc3,0x7f,0xcc,0xfa,0xcd,0x60,0xca,0x11,0x61,0xd3,0x58,0x98,0x16,0x70,0xfd,
+  0xc7,0xe7,0xe5,0x57,0xc2,0x49,0x42,0xf8,0xbb,0x0c,0xc7,0x8b,0xa2,0xe1,0xbb,0x81,
+  0x31,0x19,0xfd,0x9d,0xa6,0x32,0xb8,0xfb,0xaa,0x05,0x34,0x01,0xbf,0x08,0x89,0xb4,
+  0x3f,0x29,0x74,0x34,0xbd,0xf6,0x23,0x7e,0x2a,0x48,0x4d,0xc6,0x01,0x80,0xfc,0xf8,
+  0xbe,0xa7,0xf4,0x76,0x84,0x4f,0x4a,0xde,0x2e,0x8c,0x68,0x8f,0x6e,0x47,0x37,0x33,
+  0x6f,0xe7,0x33,0x5f,0xa0,0xf5,0x6a,0xf4,0x17,0x2e,0x30,0x88,0xf2,0x46,0x39,0x27,
+  0x89,0x43,0xd7,0xce,0xe7,0xef,0xfb,0xc8,0xdf,0x92,0xf9,0xbf,0x0e,0x73,0xac,0xc8,
+  0x69,0xc6,0x81,0x87,0x14,0xd6,0x87,0x28,0xbd,0x44,0xe7,0xe4,0x04,0xb1,0x37,0x28,
+  0xed,0xf9,0xce,0x6c,0x34,0x6a,0xfe,0xef,0xa5,0xc9,0x00,0xd6,0xe3,0x77,0x82,0x36,
+  0x97,0xa7,0x1d,0xa2,0x17,0xb4,0x5d,0x48,0xd9,0xbd,0x2e,0xe2,0xce,0x88,0x06,0xf4,
+  0x16,0x97,0xe9,0x82,0xe0,0xf6,0x85,0xf8,0xf2,0xd3,0xd7,0x53,0xc6,0xe9,0xd1,0xbd,
+  0xe0,0x22,0x8e,0xb9,0x42,0xed,0xdc,0xe4,0xca,0x1b,0xbc,0x99,0x5c,0x69,0xc0,0xf3,
+  0xc9,0xe0,0x48,0x5e,0x4f,0xae,0xdd,0xd7,0xf7,0xec,0x1f,0x6f,0x6b,0x2b,0xe3,0xd3,
+  0x05,0x00,0x00,
+};
+#endif // OB_EEPROM_SUPPORT == 0
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
+
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
+#if OB_EEPROM_SUPPORT == 0
+// g_HtmlPageConfiguration: 2832 bytes compressed to 1587
+static const unsigned char g_ScriptGzConfiguration[] = {
+  0x1f,0x8b,0x08,0x00,0x00,0x00,0x00,0x00,0x02,0xff,0x75,0x56,0x8b,0x6e,0xda,0x48,
+  0x14,0xfd,0x15,0x47,0xb5,0x98,0x99,0x32,0x31,0x36,0x8f,0x34,0x35,0x0c,0x51,0x5e,
+  0xdd,0x56,0x4a,0xd5,0x55,0x93,0xd5,0xae,0x84,0xac,0x60,0xf0,0x40,0x0c,0xc6,0x76,
+  0xec,0x21,0x2f,0xc7,0xff,0xbe,0x67,0x6c,0x20,0x34,0xdd,0x4d,0x24,0xcf,0xeb,0xde,
+  0xb9,0xcf,0x73,0x86,0x07,0x3f,0x33,0x72,0x41,0x4d,0x31,0x2c,0x66,0x49,0x46,0x23,
+  0xa9,0x8c,0xa5,0x11,0xc6,0x86,0xc9,0xc2,0x19,0x3d,0x58,0x8e,0x1c,0x8f,0x15,0x7a,
+  0x33,0x17,0xe6,0x68,0xe9,0xf1,0x58,0x2c,0x07,0xc4,0x27,0x27,0xce,0x91,0x6b,0xf3,
+  0x99,0x68,0x8d,0xc2,0x6f,0x5e,0xcb,0x52,0x32,0x57,0x74,0xc9,0xfa,0xfa,0x86,0x7e,
+  0xde,0x8f,0x9b,0xcd,0x5a,0x29,0x12,0xb3,0x93,0xae,0xeb,0x34,0x53,0x3f,0xcb,0xe5,
+  0xb7,0x58,0xd1,0x7c,0x64,0x7b,0xdc,0x39,0x62,0x7d,0x5c,0xd6,0xa4,0x84,0x34,0x63,
+  0x66,0xa5,0x7e,0x70,0xad,0xfc,0x4c,0xd1,0x36,0x27,0x36,0x61,0x9e,0xc8,0xad,0x3c,
+  0x0a,0xa7,0x92,0xce,0x4e,0x6c,0xd7,0xe1,0x11,0xeb,0xe7,0xbb,0xad,0x88,0x95,0xa5,
+  0xbe,0x58,0x8a,0x11,0x99,0xd8,0x36,0xe1,0xf8,0x76,0xab,0xef,0x31,0xf1,0xb8,0xc2,
+  0xee,0x14,0xbb,0x1e,0x0f,0x45,0x41,0xbe,0xac,0xa3,0xc8,0xb8,0x58,0xa7,0x91,0x7c,
+  0x22,0xb8,0xe7,0xe2,0xda,0x39,0x3e,0x6b,0xdb,0xee,0x31,0x3f,0xfb,0x7e,0xd9,0x3e,
+  0xb6,0xdd,0x0e,0xec,0x5d,0x84,0xb9,0x3f,0x89,0xa4,0x71,0x3e,0x9b,0x1b,0x67,0x6b,
+  0xa5,0x92,0x18,0xa2,0x47,0x25,0xbf,0x15,0x45,0x50,0x1f,0x05,0x88,0x33,0x8c,0xd3,
+  0xb5,0xc2,0x15,0xc9,0x5a,0xe9,0x49,0x87,0x47,0x61,0xbc,0xc4,0x49,0xbb,0xe4,0x99,
+  0x28,0x32,0xa9,0xfc,0x30,0xc6,0xbd,0x49,0x0c,0x5d,0x9e,0xcc,0x66,0xae,0x5d,0x22,
+  0x51,0x05,0xb1,0x2d,0x27,0x27,0xd0,0x27,0x7a,0x70,0x8e,0x3a,0xc7,0x5d,0x4c,0x57,
+  0x04,0x96,0x3f,0x1d,0x1d,0x63,0x7a,0x47,0xdc,0xee,0x67,0xa7,0x87,0x6b,0x7c,0x11,
+  0x24,0xd3,0xf5,0x4a,0xc6,0x8a,0x47,0x22,0x4a,0xa6,0xbe,0x0a,0x93,0x98,0x2f,0x84,
+  0x6f,0xdd,0xaf,0x65,0xf6,0x7c,0x2d,0x23,0x39,0x55,0x49,0x66,0x4d,0xc2,0x38,0xa0,
+  0x3e,0xe3,0x89,0x58,0x50,0x82,0x6c,0xaf,0x08,0xe3,0x81,0xf8,0x31,0x59,0xe0,0xd8,
+  0x82,0x76,0x16,0xca,0x9c,0xa7,0x62,0x9b,0x6f,0x8e,0xaa,0x89,0xa1,0x6f,0x3d,0x66,
+  0xa1,0x92,0xd4,0x64,0x7c,0x8a,0x4a,0x73,0xc9,0xc4,0x30,0xc5,0xca,0x52,0xc9,0x35,
+  0x34,0xe2,0x39,0x45,0x45,0xde,0xca,0x20,0xab,0x32,0xa0,0xb8,0x50,0x35,0xad,0x95,
+  0x9f,0xea,0xe6,0x98,0x42,0xaf,0xcd,0x98,0xb5,0x48,0xc2,0x18,0x75,0x63,0x7c,0xbd,
+  0x3d,0x56,0xd3,0x3b,0xda,0xb2,0x8a,0x76,0xd9,0x9a,0xb3,0xad,0x34,0x3e,0xba,0xca,
+  0x8c,0xdf,0x69,0x29,0x19,0x4f,0x93,0x40,0xfe,0xf5,0xf3,0xdb,0x79,0xb2,0x4a,0x93,
+  0x18,0x6e,0x6a,0x57,0x26,0xfa,0x68,0x41,0xc7,0x55,0x72,0x47,0xb1,0xbf,0x92,0xc2,
+  0x2c,0xcc,0xd2,0x1b,0x33,0x3e,0xdf,0x7a,0x39,0xd1,0x5e,0x3e,0xf8,0xd1,0x5a,0x0a,
+  0xc9,0x9f,0xb6,0xbb,0xbb,0x46,0x55,0x46,0x32,0x33,0xde,0xa5,0xe8,0x34,0x8a,0xa0,
+  0xc4,0x24,0x55,0xac,0xe4,0xd7,0xef,0x55,0x46,0x8a,0x87,0x1e,0x94,0x02,0x2a,0x19,
+  0x33,0xad,0x5c,0xaa,0x53,0x85,0x14,0x4c,0xd6,0x48,0x0f,0x8e,0xa0,0x72,0xb9,0x55,
+  0x09,0xb4,0xed,0x4d,0x3c,0xe3,0x41,0x92,0xea,0x8a,0x18,0xb5,0x2f,0xf0,0x13,0xb8,
+  0x28,0x8d,0x7a,0x14,0x42,0x9e,0x90,0xbc,0x32,0x2f,0x03,0xe2,0x12,0x52,0x0e,0xf5,
+  0x81,0xed,0x95,0x83,0x56,0xad,0x36,0x1c,0xef,0x25,0xee,0xa1,0x32,0xc0,0x61,0x4d,
+  0x60,0xa9,0xef,0xae,0x32,0x60,0xa8,0xe7,0x54,0x0a,0x32,0xbd,0x93,0xd3,0xe5,0x24,
+  0x79,0x22,0x46,0x95,0x11,0xa2,0x53,0x42,0x76,0x66,0xa5,0xb6,0x49,0x55,0x03,0xfe,
+  0x69,0xa3,0x95,0xf0,0x9b,0xcd,0xb0,0x1c,0xf3,0x67,0x41,0x75,0xb8,0x3a,0x3b,0xa1,
+  0x88,0xe5,0xa3,0xf1,0x05,0x4d,0x72,0xe1,0x2b,0x9f,0x26,0x0c,0x5d,0x8d,0x58,0x42,
+  0x6b,0x8e,0xa8,0xab,0x2c,0xed,0x95,0x0b,0xa5,0xcd,0x64,0xb0,0x06,0xc4,0x36,0xe1,
+  0x9b,0xaf,0x92,0xdb,0xac,0x2f,0x2d,0x64,0xee,0xd2,0x47,0x8d,0x2b,0x55,0x24,0x0c,
+  0xe7,0x33,0x5a,0x5d,0xa2,0x6f,0xc8,0xd3,0x28,0x54,0x94,0x58,0x84,0xe1,0x8f,0xab,
+  0xff,0x92,0x9e,0xee,0xa4,0x79,0x57,0x0b,0xd5,0xfb,0x24,0xd0,0xf0,0xad,0x4f,0xaa,
+  0xb9,0x6e,0xc7,0xab,0xe4,0x51,0x66,0xe7,0x7e,0x2e,0xa9,0x76,0x27,0x8d,0x7c,0xf8,
+  0xd3,0x1a,0xb9,0x87,0x5e,0x6b,0xce,0x91,0xac,0x9d,0xee,0x9d,0xd6,0x9d,0xd1,0x35,
+  0x35,0x2d,0x4c,0xeb,0x38,0xb6,0x95,0xae,0x1a,0x43,0x90,0x94,0x34,0x25,0xd0,0x79,
+  0x8b,0x3e,0xe8,0x03,0xa1,0xeb,0x2c,0x36,0x42,0x2b,0x40,0x95,0x74,0xa5,0x19,0xcf,
+  0x4a,0xb8,0xd2,0xdf,0x36,0x52,0x26,0xec,0x7e,0x36,0x70,0x8e,0xfa,0xd9,0x96,0xb9,
+  0x62,0xa1,0xd9,0x29,0xfb,0x8d,0x9d,0xfa,0x1b,0x0f,0x42,0x50,0x17,0x22,0x3b,0xea,
+  0xf5,0x3a,0xbd,0xc6,0x6d,0xbd,0xae,0xe2,0x2b,0x77,0xc6,0x2a,0xb9,0x79,0xed,0xe9,
+  0xe8,0xb6,0x9e,0x32,0x4f,0x07,0x51,0xf2,0xfb,0x4d,0x13,0xfc,0x5a,0xab,0x7f,0xbe,
+  0x5f,0x7d,0x55,0x2a,0xfd,0x29,0xd1,0xd1,0xb9,0x82,0xa9,0x24,0x95,0x71,0x25,0x78,
+  0xe0,0xd4,0xb1,0x03,0xfd,0xba,0xaf,0x1f,0xab,0x2a,0x6f,0x79,0xc2,0xba,0xcb,0xe4,
+  0x4c,0x90,0xd6,0x11,0x4c,0x5d,0xd4,0x27,0xbb,0xad,0x0e,0xe1,0x37,0xef,0xb6,0x1c,
+  0xc2,0x97,0xef,0xb6,0x26,0x84,0x9f,0xd6,0x8d,0xe3,0x5b,0x93,0x24,0x78,0xb6,0xc2,
+  0x38,0x96,0xd9,0x8d,0x7c,0x42,0x22,0xff,0xf6,0x43,0x65,0xf4,0x72,0xcb,0xb2,0x08,
+  0x47,0x48,0x37,0xe1,0x4a,0x82,0x07,0xe9,0x0d,0xef,0xc9,0x0e,0x5c,0x39,0xab,0xf5,
+  0xee,0x29,0xf9,0xe3,0xf2,0x06,0x4c,0xdc,0xfa,0xec,0xa0,0xc9,0x4f,0x29,0x8e,0x5e,
+  0x74,0xbb,0x15,0xa6,0x95,0x66,0xf2,0x01,0xa0,0xbf,0x90,0x33,0x7f,0x1d,0x29,0xca,
+  0xfa,0x35,0x83,0x9f,0x66,0x99,0xff,0x6c,0xcd,0xb2,0x64,0x45,0x9f,0x51,0xef,0x0d,
+  0x7b,0x51,0xc6,0xe9,0x08,0x21,0x7b,0x1a,0x1a,0x66,0x81,0x4e,0x62,0xa5,0xd0,0xa3,
+  0x64,0xe5,0x0e,0x46,0x0d,0x14,0x02,0x16,0xff,0xfc,0x71,0x5d,0x99,0x24,0x5c,0x36,
+  0x49,0xe3,0xc5,0xb6,0x85,0xbd,0xb5,0x7d,0x2e,0x74,0x73,0x20,0xe5,0x4c,0xbf,0x38,
+  0x57,0x9a,0xa5,0xef,0xd7,0x21,0x5a,0xdc,0x3d,0xb0,0xcb,0x6d,0x43,0x3c,0xa1,0x71,
+  0xc3,0x94,0x70,0xed,0xe6,0x35,0xf2,0x5c,0x20,0xc8,0x2b,0xae,0x42,0x15,0x49,0x97,
+  0x3c,0x59,0xd5,0xbf,0xa1,0x59,0xd6,0x57,0x84,0xa7,0xbe,0x52,0x32,0x8b,0x5d,0x42,
+  0x69,0xbb,0x37,0xb2,0x0f,0x7b,0xde,0x2b,0x6d,0x63,0xec,0x7a,0xaf,0x0e,0x86,0xcf,
+  0xde,0xeb,0xc8,0xd1,0x5f,0x56,0x2d,0x18,0x1d,0x59,0x1e,0x3d,0x39,0x30,0xd9,0x2b,
+  0xb0,0x55,0x74,0x4b,0x52,0xb2,0x92,0x71,0x6d,0x31,0x4d,0x32,0xf5,0x9b,0x4d,0x80,
+  0xdf,0x25,0xf1,0x7a,0x35,0x91,0x19,0xe1,0x2b,0x3c,0x27,0x8e,0xcd,0x57,0xfe,0x93,
+  0x5b,0x35,0x58,0xa5,0xfa,0x86,0x44,0x29,0x86,0x73,0xb0,0x34,0x02,0x1c,0x21,0x4d,
+  0x9b,0x94,0x54,0x08,0xdc,0x03,0xe0,0x46,0x28,0xad,0x84,0x2a,0x32,0x06,0xaf,0x6e,
+  0x50,0x67,0x5a,0x18,0xf6,0x00,0x06,0x87,0xfd,0xc3,0x17,0x0f,0x1c,0x5e,0x79,0xac,
+  0xc1,0x66,0x36,0x5c,0x8d,0xb7,0x1d,0xc2,0xb6,0xd7,0xd2,0x5f,0x9a,0x96,0x76,0x40,
+  0x45,0x07,0xc2,0x3e,0x79,0xa0,0x1a,0x70,0x8a,0x77,0x81,0x41,0xb0,0x11,0xde,0x33,
+  0x84,0x16,0x42,0xb0,0x92,0x10,0xa2,0xf3,0xfa,0xba,0x99,0xb5,0x1b,0x0d,0x35,0xfc,
+  0x74,0x62,0xba,0x21,0x9e,0x37,0x8d,0x31,0xf5,0x1b,0xc6,0xf0,0xba,0xf9,0x1a,0xdb,
+  0x23,0x8d,0xaa,0x85,0xf7,0x9e,0x99,0xa8,0x39,0x18,0x1c,0xb3,0xa6,0x64,0xe0,0x27,
+  0x3c,0x7e,0x3e,0x1d,0x0f,0x6a,0xf6,0xdd,0x50,0x66,0x6a,0x16,0xaa,0x24,0xe0,0xc3,
+  0x4b,0x9a,0xf1,0x76,0x17,0x56,0x41,0xc4,0xb5,0xc4,0x70,0xac,0x69,0x04,0x0f,0x24,
+  0xf9,0x10,0x10,0x21,0x00,0x00,0x3f,0xbf,0x3b,0x19,0x0f,0x54,0x30,0xd4,0xe4,0x3a,
+  0x68,0x61,0x32,0xd6,0xfe,0x4f,0xab,0x6b,0xf7,0x88,0xb9,0x2e,0x8d,0x31,0x8d,0xfc,
+  0x3c,0x17,0xea,0x78,0x63,0x2a,0x34,0x8b,0xc5,0x8e,0x9e,0xc1,0xd5,0xfa,0x8d,0xef,
+  0x34,0x12,0x6c,0xa1,0x84,0xc2,0x36,0x50,0x41,0x51,0xed,0x0d,0x7f,0x75,0xb1,0xd6,
+  0xab,0x5c,0x8c,0x79,0xf5,0x13,0xa0,0x91,0xbc,0xf7,0xb2,0x9f,0xc3,0x03,0x95,0x0d,
+  0xb5,0x73,0x1f,0x10,0x52,0xd3,0xa9,0xfd,0xd3,0xeb,0xff,0x0d,0xf8,0x96,0x77,0x7e,
+  0x89,0xf7,0x4d,0xa3,0x8e,0xa5,0x56,0x58,0xbc,0x73,0x1b,0x99,0x5e,0xe8,0x4c,0x63,
+  0x6f,0xd3,0xe5,0x82,0x8c,0x1e,0x3f,0x5a,0x87,0x5e,0xe1,0x70,0xa7,0x87,0xed,0x2d,
+  0x7a,0x8c,0x0a,0x1c,0x82,0x38,0x86,0x4a,0x0c,0xa7,0x67,0xa0,0x0d,0x20,0x9e,0x73,
+  0xa3,0xce,0x0f,0x26,0x7e,0x1c,0x18,0x87,0x1f,0x6f,0x2d,0x23,0x4e,0x8c,0x3c,0x45,
+  0x7f,0xe5,0x44,0xa7,0x21,0x92,0xf1,0x5c,0xdd,0x09,0xa7,0xd7,0x7a,0xf3,0x49,0xbf,
+  0x58,0x7b,0x8b,0x60,0x7f,0x31,0xad,0x17,0x66,0x91,0xea,0x49,0x86,0x17,0x14,0x10,
+  0xc0,0x6f,0x1e,0x6b,0x86,0x87,0xa2,0x62,0xa7,0xaf,0x37,0xdf,0xaf,0xf6,0x39,0x24,
+  0xa0,0xe1,0x1e,0x75,0x3c,0x6c,0xa8,0x57,0xf2,0x73,0x6e,0xee,0x7e,0xb7,0x0c,0x5a,
+  0x93,0x6c,0x88,0x06,0x28,0x32,0xf7,0x8c,0xe7,0xee,0x0b,0x8f,0xdc,0x1b,0x1e,0xba,
+  0x8f,0x3c,0x75,0x2f,0xf8,0xbd,0xbb,0x2c,0x4b,0xf6,0x2f,0xff,0x7f,0xfa,0xb2,0x10,
+  0x0b,0x00,0x00,
+};
+#endif // OB_EEPROM_SUPPORT == 0
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
+
+#if BUILD_SUPPORT == MQTT_BUILD && HOME_ASSISTANT_SUPPORT == 1
+#if OB_EEPROM_SUPPORT == 0
+#if PCF8574_SUPPORT == 1
+// g_HtmlPagePCFIOControl: 1316 bytes compressed to 732
+static const unsigned char g_ScriptGzPCFIOControl[] = {
+  0x1f,0x8b,0x08,0x00,0x00,0x00,0x00,0x00,0x02,0xff,0x95,0x54,0x7f,0x4f,0xdb,0x30,
+  0x10,0xfd,0x2a,0x99,0x16,0xd5,0xb6,0xb0,0xdc,0x96,0x4a,0x20,0x95,0x3a,0x68,0x02,
+  0x26,0x90,0x36,0x31,0x51,0x90,0x26,0x21,0x44,0x5d,0xe7,0xd2,0x86,0xa5,0xb6,0xe7,
+  0x38,0x20,0x16,0xe5,0xbb,0xef,0xd2,0x92,0x52,0xb1,0x31,0x69,0xff,0xb4,0x3e,0xdf,
+  0xdd,0xbb,0x1f,0xef,0x39,0x8f,0xca,0x47,0xa5,0xa4,0x41,0x26,0x75,0x01,0x21,0x02,
+  0x99,0x5a,0x5d,0xad,0xc0,0x04,0xee,0x65,0x61,0xb5,0x0a,0xb9,0x35,0x3c,0x96,0x20,
+  0x7e,0x56,0xe0,0x9f,0xa7,0x50,0x80,0x0e,0xd6,0x8b,0x79,0x6e,0x52,0x0a,0x8c,0x1b,
+  0x19,0x53,0x92,0x59,0xbf,0x22,0x8c,0x2b,0x49,0x2f,0xe7,0x0f,0xe8,0x17,0x98,0xee,
+  0x73,0x28,0xb9,0x53,0xbe,0x84,0x0b,0x13,0x18,0x2f,0x25,0x56,0x00,0xf1,0xe4,0xf3,
+  0x00,0x14,0xed,0x25,0x96,0xe4,0xc0,0x64,0xa2,0xd0,0x12,0xc1,0x4e,0x31,0xc1,0x2c,
+  0xe8,0xf0,0x80,0x09,0xa7,0xd2,0x69,0x50,0x3e,0x50,0xe0,0x64,0x80,0xb0,0x45,0x9b,
+  0x1a,0xc4,0x4a,0xb9,0xb6,0xcb,0x25,0xe6,0xed,0x33,0x26,0x1e,0x6c,0x6e,0x28,0x41,
+  0x77,0xda,0xb9,0x83,0x5e,0xd2,0xbe,0xa8,0xf7,0x9b,0xfe,0x82,0x75,0xd1,0x88,0xce,
+  0x11,0x93,0x71,0xbb,0xae,0x6f,0xb4,0x4d,0xe1,0xe6,0xea,0xe2,0xc4,0xae,0x9c,0x35,
+  0xd8,0x65,0xdb,0x8a,0x93,0xb7,0x77,0x5c,0xb7,0x3f,0xd5,0xba,0x29,0xee,0xb1,0xad,
+  0xfa,0x11,0xf7,0x12,0x1f,0x79,0x08,0x95,0x37,0xb3,0x49,0xa1,0xe6,0x50,0x24,0x93,
+  0xdc,0xb8,0x2a,0x44,0xe1,0xd9,0x81,0xf4,0x2a,0xcd,0x6d,0x64,0xd4,0x0a,0xa4,0x8d,
+  0x6b,0x68,0xa2,0x47,0x55,0x54,0x20,0xe3,0x3a,0x34,0x51,0x5c,0x7b,0x29,0xc3,0x31,
+  0xd1,0x4b,0xd0,0x3f,0x20,0x25,0x63,0x42,0x9a,0x7e,0x12,0xd7,0x14,0xef,0xac,0x41,
+  0xd3,0x66,0x19,0x69,0xa7,0xbe,0x71,0x0e,0xfc,0x89,0x2a,0x81,0xb2,0x66,0xd2,0xdf,
+  0x14,0x99,0x35,0x3c,0x93,0x94,0x6d,0xf9,0x30,0xf0,0x14,0x7d,0xc6,0x05,0x9f,0xaa,
+  0xa0,0xa8,0x61,0x2f,0x2d,0x45,0x20,0x4a,0x08,0x94,0x9c,0x0f,0x06,0x84,0x17,0x34,
+  0xa5,0x41,0xe0,0x71,0x33,0x37,0x0e,0xe1,0xbb,0xfc,0x58,0x12,0x4b,0xf6,0x3c,0xf2,
+  0x04,0x62,0x81,0x09,0x31,0x9b,0x4c,0x0e,0x5f,0x31,0x52,0xe4,0x13,0x09,0x89,0x91,
+  0xc8,0x86,0xe1,0x9a,0xa0,0xe1,0xb9,0x6c,0xc1,0x16,0x08,0x76,0x3b,0xb8,0xeb,0x22,
+  0x87,0x07,0xbd,0xfc,0x98,0xea,0x6c,0x71,0xef,0xd4,0x02,0xd6,0xed,0x79,0xb1,0xf4,
+  0x90,0x49,0xd2,0x3f,0xd8,0x27,0xbc,0xf3,0xdc,0x3b,0x9d,0xfd,0xe1,0x65,0xe3,0xf7,
+  0x32,0x87,0xff,0xcc,0x1c,0x21,0xbb,0xb9,0xd5,0x7f,0x4b,0xc4,0xa1,0x3d,0x14,0x56,
+  0xa5,0xef,0xf4,0x53,0x56,0xf3,0x55,0x1e,0xee,0x5b,0x61,0xb6,0xc4,0xd7,0x41,0x38,
+  0x0f,0x8f,0x48,0xf8,0x29,0x64,0xaa,0x2a,0x02,0x65,0x47,0xaf,0xdb,0xfd,0xfe,0xf5,
+  0xcb,0x79,0x08,0xee,0x0a,0x50,0xe2,0x65,0xab,0xfb,0x4f,0xde,0xab,0x67,0x91,0x79,
+  0xbb,0xa2,0x19,0x65,0x9d,0x9a,0x29,0xe3,0xf4,0x16,0xf5,0x71,0x87,0xc5,0x66,0x71,
+  0x6d,0x51,0x3b,0x8d,0x6c,0xff,0x81,0x35,0xb3,0x4e,0x90,0x3d,0xc2,0x8e,0x40,0x58,
+  0x07,0x78,0xfe,0x76,0x39,0xbd,0x26,0x9c,0xf4,0x09,0xff,0x30,0xc4,0xd5,0x22,0x61,
+  0xf8,0x66,0xfc,0x1e,0xe9,0xfd,0x1a,0x0c,0x64,0xab,0xec,0x9d,0x11,0x50,0x00,0x7c,
+  0x4b,0x22,0xb6,0x7d,0xa6,0x50,0xcd,0x2f,0x4f,0xa4,0xa6,0xa3,0x5e,0x60,0x52,0x8e,
+  0x8e,0xb5,0x70,0x55,0xb9,0xa4,0xb3,0x49,0xf0,0xc9,0x24,0xa4,0xc9,0x65,0x15,0x5a,
+  0x41,0x7e,0x44,0x01,0xee,0x0d,0x0f,0x51,0x42,0x78,0x87,0xf7,0x91,0x2e,0x54,0x59,
+  0x4a,0x52,0xa2,0x1a,0x93,0xe4,0xb0,0x89,0xc2,0x88,0x24,0x6f,0x9c,0x1a,0xf5,0x58,
+  0xd1,0x21,0xca,0xbd,0x0d,0x61,0x4d,0x6b,0x0d,0xb6,0xd6,0x26,0xb8,0x8f,0x65,0x66,
+  0xc8,0xde,0xa6,0xfc,0xb0,0xd7,0x73,0x6f,0xea,0x5f,0x98,0xff,0x2e,0xdf,0xef,0x60,
+  0x1b,0xfc,0x28,0x50,0xb7,0x7d,0xc7,0xad,0xf5,0x82,0xbb,0x6c,0x43,0x96,0xaf,0x87,
+  0xb8,0xd6,0xa2,0x00,0xb3,0xc0,0xe3,0xe0,0x98,0xe0,0xf5,0x76,0x84,0xe9,0xd9,0xf5,
+  0x3a,0x62,0xfd,0xc2,0x5e,0x70,0x11,0x47,0xef,0xa0,0xd6,0xe5,0x78,0x47,0x0c,0xbc,
+  0x18,0xef,0x2c,0x9d,0xeb,0x71,0x27,0x3f,0xee,0xc6,0xbb,0x4a,0xe4,0xf9,0xb8,0x53,
+  0x5e,0xd3,0xb0,0xdf,0x85,0xb7,0x22,0x21,0x24,0x05,0x00,0x00,
+};
+#endif // PCF8574_SUPPORT == 1
+#endif // OB_EEPROM_SUPPORT == 0
+#endif // BUILD_SUPPORT == MQTT_BUILD && HOME_ASSISTANT_SUPPORT == 1
+
+#if BUILD_SUPPORT == MQTT_BUILD && HOME_ASSISTANT_SUPPORT == 1
+#if OB_EEPROM_SUPPORT == 0
+#if PCF8574_SUPPORT == 1
+// g_HtmlPagePCFConfiguration: 1342 bytes compressed to 808
+static const unsigned char g_ScriptGzPCFConfiguration[] = {
+  0x1f,0x8b,0x08,0x00,0x00,0x00,0x00,0x00,0x02,0xff,0x75,0x53,0x7f,0x6f,0xdb,0x36,
+  0x10,0xfd,0x2a,0x2e,0x6a,0x98,0x24,0x72,0xa0,0x65,0xbb,0xcd,0x36,0x39,0x74,0x50,
+  0xb4,0xdd,0x52,0x60,0x43,0x87,0x3a,0xc5,0x0a,0x14,0x41,0x4d,0x4b,0x67,0x5b,0x8e,
+  0x4c,0x6a,0x14,0xe5,0x34,0x53,0xf4,0xdd,0x77,0x94,0x6c,0xd7,0x0b,0xb0,0x7f,0x24,
+  0x92,0xf7,0xeb,0xdd,0xbd,0x77,0x7b,0xed,0x7a,0xa5,0xe2,0xa8,0x66,0x75,0x8e,0xbe,
+  0xe7,0x55,0x9d,0x66,0xa5,0x5e,0xe6,0x98,0xc6,0x11,0x64,0xa6,0xa8,0x7c,0x3c,0x02,
+  0x5b,0xf9,0x70,0x98,0x40,0x9e,0x99,0x7b,0xb2,0x8c,0x1b,0x30,0xaa,0x76,0xe8,0x75,
+  0x66,0xe2,0x9f,0xc1,0x9a,0x78,0x74,0x09,0x76,0xb5,0x8a,0xa3,0x06,0x9c,0x4a,0x6d,
+  0x52,0xed,0xd0,0x78,0xe8,0xab,0xdc,0x26,0xda,0x67,0xd6,0x40,0xaa,0x9c,0xfc,0xbb,
+  0x42,0xf7,0x38,0xc7,0x1c,0x13,0x6f,0x9d,0x5c,0x66,0x26,0xe5,0x4e,0x40,0xae,0x52,
+  0xce,0x56,0xd6,0xed,0x98,0x00,0xad,0x3e,0x2e,0xb7,0x64,0x96,0x14,0xed,0x32,0x2c,
+  0xc1,0xaa,0x42,0xbb,0x12,0x3f,0x50,0xb2,0x4c,0x11,0x46,0x27,0x1f,0x5c,0xe6,0x91,
+  0xa3,0x80,0x82,0x40,0x83,0x17,0x6a,0x66,0xe9,0x26,0xbd,0x9d,0x53,0x84,0x59,0xf3,
+  0xd1,0xa5,0x90,0x85,0x4e,0xe7,0x5e,0x3b,0xcf,0x3d,0xb0,0x88,0xd2,0x26,0x21,0x14,
+  0xe5,0x4e,0x17,0xa1,0x4f,0xfa,0xc0,0x58,0x08,0xb9,0xb5,0x99,0xe1,0x8c,0xcc,0xe5,
+  0xd1,0xec,0x93,0x0d,0x1f,0xca,0x7a,0xdc,0x0c,0xd7,0xe2,0xe8,0x4d,0xd9,0x81,0x72,
+  0x0a,0xa8,0x5a,0x2f,0x93,0xd8,0x14,0x3f,0x7f,0xfa,0xf0,0xd6,0xee,0x0a,0x6b,0x08,
+  0x66,0x80,0xb2,0x3a,0x42,0xd1,0x01,0xca,0x21,0x70,0x71,0x65,0x8b,0xd0,0x7a,0x6f,
+  0xaf,0xf3,0x0a,0x55,0xbf,0xc6,0xaf,0xa3,0xbb,0xa6,0xd7,0xfd,0x95,0xf2,0xd7,0xac,
+  0x6c,0x47,0x81,0x29,0x8b,0x19,0x6b,0x66,0xc1,0x10,0xdd,0x35,0x57,0xc3,0x2e,0x6c,
+  0xb6,0x38,0x43,0xb8,0x69,0x0b,0x80,0xa1,0xe1,0xd2,0x35,0xe4,0x6e,0x99,0xe9,0xf9,
+  0xc7,0x02,0x15,0x4b,0x36,0x98,0xdc,0x2f,0xed,0x77,0xd6,0x33,0x7a,0x47,0x77,0xca,
+  0xd4,0xb0,0x53,0x59,0x1f,0x6a,0x72,0x33,0x20,0x7c,0xa1,0x68,0xeb,0xfc,0xa3,0xa6,
+  0x6b,0x16,0xf0,0x4d,0x71,0x71,0xa2,0xdf,0xe0,0x43,0xef,0x57,0x62,0xe3,0x9d,0xf6,
+  0x9a,0xe7,0x82,0x78,0xa6,0x5e,0xbc,0x5c,0xa3,0x7f,0x93,0xe7,0x67,0xed,0x85,0xa9,
+  0x0b,0xe9,0x30,0xad,0x12,0xe4,0x87,0xf6,0xf1,0xc9,0x43,0x24,0xa6,0xa4,0x8b,0xca,
+  0x99,0x9e,0x97,0x25,0x7a,0xce,0x6e,0xa2,0x88,0x41,0xc2,0x4b,0x8e,0x92,0x8e,0x5d,
+  0x3c,0xf9,0xbb,0x63,0xc9,0xbe,0x62,0x05,0xbb,0x70,0xa4,0x10,0xc3,0xfb,0x67,0xc1,
+  0x29,0x4d,0x87,0x98,0xee,0x0b,0x48,0x1b,0x41,0xf3,0xf7,0x0d,0xdc,0x1c,0xc6,0x70,
+  0x0c,0x75,0x2d,0xda,0x2f,0x7f,0xfc,0x7e,0xe3,0x7d,0xf1,0x09,0x49,0x5f,0xa5,0x9f,
+  0x3a,0x69,0x0b,0x34,0xad,0xe3,0x8b,0x91,0x00,0x47,0x28,0x48,0x68,0x46,0x34,0xb0,
+  0x6c,0xfb,0xec,0xcb,0x8d,0xc3,0x95,0x62,0xc3,0x4b,0xc2,0xb5,0x7d,0xf6,0x34,0x62,
+  0x30,0x7f,0xf6,0x34,0x66,0xb0,0x7e,0xf6,0x34,0x61,0x70,0xdf,0xcd,0x8c,0x64,0x6c,
+  0xd3,0x47,0x99,0x19,0x83,0xee,0x16,0xbf,0x7b,0xc5,0xfe,0xd2,0x99,0xef,0xbd,0x2e,
+  0xa5,0x94,0x0c,0xa8,0xff,0xdb,0x6c,0x87,0xb4,0x3d,0x7c,0x0d,0xaf,0x71,0x42,0x18,
+  0xf6,0x5d,0xdc,0x0d,0x67,0xbf,0xbd,0xbf,0x65,0xc0,0x86,0xbf,0x8c,0x88,0xdf,0x7b,
+  0x4e,0xa6,0x87,0x30,0xe9,0x1a,0x65,0xe1,0x70,0x4f,0xc2,0x7a,0x87,0x2b,0x5d,0xe5,
+  0x9e,0x8b,0x69,0x47,0xcc,0x1b,0xe7,0xf4,0xa3,0x5c,0x39,0xbb,0xe3,0xdf,0xb8,0x38,
+  0x6e,0x08,0x17,0xc0,0xbf,0x52,0xaf,0x77,0x41,0x15,0xfd,0xba,0x22,0x56,0x1a,0x15,
+  0xfe,0x5e,0x34,0x27,0x05,0x0d,0x98,0x98,0x52,0xc5,0x3f,0x3f,0xce,0xdb,0x92,0x0c,
+  0xfc,0x05,0x1b,0xfc,0x13,0x45,0x2a,0x3a,0xd4,0x3e,0x4e,0xfd,0x44,0x12,0xed,0xe3,
+  0x7b,0x4d,0xdb,0x70,0x4e,0x54,0xaa,0xf8,0x64,0x80,0xe2,0x85,0x8a,0xae,0x37,0xbc,
+  0xe3,0xec,0x15,0xa0,0x20,0x21,0xd1,0x0e,0xb7,0x26,0xa5,0x26,0x4f,0x4f,0x87,0xd3,
+  0x78,0x30,0x70,0xb3,0xc9,0xf5,0xe2,0xaa,0x53,0xf9,0x41,0x9a,0x45,0x50,0x1c,0x23,
+  0xdd,0xad,0xb8,0x81,0xf1,0x2b,0xf2,0x24,0xc1,0x77,0x1e,0xb3,0x45,0xc8,0xa4,0x15,
+  0x7b,0x99,0x32,0xa5,0x68,0xd8,0xba,0xdc,0x50,0xb8,0x4f,0xc3,0x66,0x90,0x17,0x1d,
+  0x82,0xc7,0x34,0xe3,0xf4,0xe8,0x66,0xc1,0xf0,0x92,0xb2,0x5d,0x8c,0x7e,0xea,0x8c,
+  0xe1,0xe1,0x7f,0x8b,0x79,0x98,0xfc,0xa7,0xd6,0x29,0xa2,0x5f,0xa7,0xcd,0xd9,0x25,
+  0xef,0x2e,0xfd,0x5a,0x87,0x83,0xa3,0x25,0x6c,0x04,0xd4,0x2e,0xde,0x43,0x19,0x3f,
+  0x40,0x1e,0xaf,0x21,0x89,0xb7,0x90,0xc5,0x4b,0xd8,0xc6,0xf3,0xa6,0x11,0xff,0x02,
+  0xb8,0x3e,0x88,0xbf,0x3e,0x05,0x00,0x00,
+};
+#endif // PCF8574_SUPPORT == 1
+#endif // OB_EEPROM_SUPPORT == 0
+#endif // BUILD_SUPPORT == MQTT_BUILD && HOME_ASSISTANT_SUPPORT == 1
+
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
+#if OB_EEPROM_SUPPORT == 0
+#if PCF8574_SUPPORT == 1
+// g_HtmlPagePCFIOControl: 1501 bytes compressed to 842
+static const unsigned char g_ScriptGzPCFIOControl[] = {
+  0x1f,0x8b,0x08,0x00,0x00,0x00,0x00,0x00,0x02,0xff,0x9d,0x54,0x61,0x8b,0xdb,0x38,
+  0x10,0xfd,0x2b,0x2e,0x98,0x48,0xc2,0x42,0xb6,0x77,0x8f,0x2d,0x38,0x51,0xc2,0xd1,
+  0xf6,0xe8,0x86,0x3b,0x5a,0x9a,0x16,0x0e,0x42,0x48,0xb4,0xf6,0x38,0x71,0xe3,0x58,
+  0x3e,0x49,0xd9,0xb2,0x67,0xfc,0xdf,0x3b,0x4a,0xd6,0xd9,0x70,0xbd,0xde,0x87,0xfb,
+  0x92,0x68,0x24,0xcd,0xd3,0x9b,0x79,0x6f,0xfc,0xa8,0x4c,0x60,0x25,0x75,0x72,0xda,
+  0x95,0xda,0xd0,0x1a,0x5c,0xb0,0x0f,0xaa,0x26,0x70,0xac,0x2a,0xe9,0xab,0xfd,0x32,
+  0x5d,0xb1,0xce,0x6f,0x5a,0xe9,0x96,0xfb,0x15,0x6f,0xe4,0x7e,0x42,0x14,0x99,0xa5,
+  0x77,0x59,0xc2,0x4b,0x19,0x2f,0xab,0xfb,0x55,0x2c,0x1c,0x58,0x47,0xf7,0x6c,0xec,
+  0x11,0xc6,0x76,0xdc,0x44,0xd1,0x39,0xa9,0x96,0xe5,0xec,0x97,0x2c,0x8d,0x5a,0x65,
+  0x2c,0xdc,0x37,0x8e,0xda,0x65,0xb2,0xe2,0xe9,0x1d,0x1b,0x23,0x58,0x44,0x09,0x89,
+  0x1a,0x26,0x5a,0x55,0x2c,0x9c,0x32,0x8e,0xde,0x70,0x92,0x10,0xb6,0x92,0x56,0xd8,
+  0xba,0xca,0x81,0x96,0xb3,0x24,0x4b,0x79,0xcd,0xc6,0xf6,0xb2,0x55,0xb3,0xbe,0xf7,
+  0xc0,0x20,0x0b,0x9d,0x1f,0x0f,0xd0,0x38,0x6e,0x64,0xad,0x73,0xe5,0x2a,0xdd,0xf0,
+  0x50,0x82,0xf8,0xeb,0x08,0xe6,0x69,0x01,0x35,0xe4,0x4e,0x1b,0xf1,0x50,0x35,0x05,
+  0x05,0xc6,0x95,0x0c,0x29,0x41,0x76,0x07,0xc2,0xb0,0x04,0xfa,0xe1,0xe1,0x2b,0x9e,
+  0x0b,0x4c,0x37,0x15,0x58,0x3e,0xd0,0x63,0x1c,0xab,0x94,0x53,0x10,0xdf,0x4c,0xe5,
+  0x80,0x62,0x5c,0x60,0x67,0x38,0x30,0x39,0x6d,0x30,0x12,0x4e,0x2f,0x30,0xa1,0xd9,
+  0x52,0xac,0xe0,0x85,0x36,0x9c,0x68,0xf3,0x9d,0x4f,0x75,0xe2,0xa0,0x5a,0xdf,0xcc,
+  0x02,0xf3,0x6e,0x18,0x13,0x5f,0x75,0xd5,0x60,0x9d,0x8c,0xd7,0xc3,0xb1,0xcb,0x77,
+  0x34,0x16,0xdd,0x4d,0x1f,0x6f,0xd9,0x70,0x1b,0xd1,0x7d,0x57,0x18,0x5f,0x9f,0xde,
+  0x6f,0x72,0x5d,0xc0,0x97,0x4f,0xf7,0x6f,0xf4,0xa1,0xd5,0x0d,0xb2,0xf4,0x54,0xb4,
+  0x5c,0xae,0xf8,0xdc,0xff,0xb4,0x27,0x52,0xdc,0x20,0xad,0xee,0x11,0xe5,0x0b,0xc7,
+  0x06,0xdc,0xd1,0x34,0x9b,0x49,0xad,0x1e,0xa0,0x9e,0x4e,0xaa,0xa6,0x3d,0xba,0xc0,
+  0x3d,0xb5,0x20,0x8d,0x2a,0x2a,0x1d,0x34,0xea,0x00,0x52,0x87,0x1d,0xf4,0xc1,0xa3,
+  0xaa,0x8f,0x20,0xc3,0xce,0xf5,0x41,0xd8,0x19,0x29,0xdd,0x8c,0xe4,0x3b,0xc8,0xf7,
+  0x50,0x90,0x8c,0x90,0x3e,0x9e,0x86,0x1d,0xc5,0x3d,0xdd,0x60,0xa8,0xcb,0x92,0xf8,
+  0xaa,0xbf,0xb4,0x2d,0x98,0x37,0xca,0x02,0x65,0xfd,0x24,0x3e,0x3f,0xb2,0xe9,0x79,
+  0x2e,0xa9,0xa7,0x70,0xd6,0xa3,0x81,0x6f,0xc1,0x6f,0xd8,0xe0,0xb7,0xca,0x29,0xaa,
+  0xd8,0x33,0xa5,0x00,0x84,0x05,0x47,0xc9,0xfb,0x24,0x21,0x7c,0x47,0x6b,0xea,0x04,
+  0x2e,0xcf,0x75,0x63,0x11,0x66,0xc8,0x0f,0x25,0xd1,0x24,0x32,0xa8,0x13,0x88,0x2d,
+  0x26,0x84,0x6c,0x32,0x79,0xfd,0x82,0x51,0xa0,0x9e,0x28,0x48,0x88,0x42,0xf6,0x0c,
+  0xdb,0x04,0x3d,0x7a,0xcf,0x83,0x6d,0x11,0x0c,0x2d,0x35,0xdc,0x4c,0xef,0x46,0xe5,
+  0x8c,0xe6,0xe5,0x76,0xdd,0xaa,0x2d,0x9c,0xe8,0x19,0xb1,0x33,0x50,0x4a,0x12,0xdf,
+  0xdd,0x10,0x3e,0x9c,0xac,0xdb,0xbc,0xfc,0xe1,0x94,0x65,0x3f,0xcb,0x4c,0xff,0x33,
+  0xf3,0x16,0xd5,0xad,0x74,0xfe,0x6f,0x89,0x58,0xb4,0x81,0x5a,0xab,0xe2,0x27,0x7c,
+  0xec,0xf1,0xe1,0x50,0xb9,0xb5,0x37,0xa6,0x17,0xbe,0x73,0xa2,0x35,0xf0,0x88,0x82,
+  0xbf,0x85,0x52,0x1d,0x6b,0x47,0xd9,0xf8,0xa5,0xbb,0x7f,0xfe,0xf1,0xfb,0x7b,0xe7,
+  0xda,0x4f,0x80,0x16,0xb7,0xde,0xf7,0xbf,0x1a,0xa3,0x9e,0x44,0x69,0xf4,0x81,0xe6,
+  0x94,0x0d,0x6e,0xa6,0x8c,0xd3,0x25,0xfa,0x63,0x85,0x8f,0x6d,0xc2,0x6e,0x8d,0xde,
+  0xe9,0xa5,0xff,0x07,0xd6,0x6f,0x06,0x43,0x8e,0x08,0x1b,0x83,0xd0,0x2d,0xe0,0xfa,
+  0xe3,0x87,0xc5,0x67,0xc2,0x49,0x4c,0xf8,0xab,0x14,0x5b,0x8b,0x82,0xe1,0xcc,0x98,
+  0x88,0x8c,0xfe,0x4e,0x12,0xe9,0x9d,0x7d,0x55,0x02,0x1a,0x80,0x5f,0x44,0x44,0xda,
+  0xef,0x14,0xba,0x99,0x5e,0x7b,0x11,0x3f,0x13,0x64,0x4e,0x22,0x1c,0x91,0x08,0x31,
+  0xc8,0x8f,0xe3,0x3d,0xa6,0xb7,0x23,0x9c,0x28,0x79,0x3b,0x9b,0x8b,0xf6,0x68,0x77,
+  0x74,0x33,0x71,0x66,0x3a,0x71,0x05,0x3a,0x2f,0x44,0x7b,0xe1,0x02,0x83,0x20,0xaf,
+  0x95,0xb5,0x92,0x58,0x34,0xed,0x74,0xfa,0xba,0x0f,0xdc,0x2d,0x99,0xfe,0xe3,0x30,
+  0xc7,0x8c,0x96,0xa6,0xdc,0x70,0x7f,0x85,0xf5,0x3e,0x4a,0x2e,0xd1,0xf9,0x72,0x8c,
+  0xd8,0x1b,0x54,0xf6,0xfc,0x66,0x3a,0x1a,0xe9,0xff,0xfb,0x68,0x3c,0x80,0xf5,0xf8,
+  0x99,0xa0,0xfa,0x32,0xd9,0x3e,0x7a,0x46,0xdb,0xf9,0x2b,0xbb,0x97,0x45,0xd8,0xcd,
+  0x45,0x0d,0xcd,0x16,0x97,0xc9,0x8c,0xe0,0xf6,0x85,0xf8,0xe2,0xdd,0xe7,0xd3,0x8d,
+  0xd3,0xcc,0x3d,0xe3,0x22,0xce,0xfc,0x0a,0xb5,0xb3,0xd9,0x95,0x3d,0x78,0x9d,0x5d,
+  0xc9,0xc0,0xf3,0x6c,0x30,0x24,0x6f,0xb3,0x6b,0x6f,0xf2,0x2a,0x1b,0xbc,0xd8,0xf7,
+  0xec,0x3b,0x5a,0xa1,0x4c,0x7b,0xdd,0x05,0x00,0x00,
+};
+#endif // PCF8574_SUPPORT == 1
+#endif // OB_EEPROM_SUPPORT == 0
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
+
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
+#if OB_EEPROM_SUPPORT == 0
+#if PCF8574_SUPPORT == 1
+// g_HtmlPagePCFConfiguration: 2023 bytes compressed to 1183
+static const unsigned char g_ScriptGzPCFConfiguration[] = {
+  0x1f,0x8b,0x08,0x00,0x00,0x00,0x00,0x00,0x02,0xff,0x75,0x54,0x7f,0x6f,0xdb,0x36,
+  0x10,0xfd,0x2a,0x2a,0x2a,0x98,0x64,0x7d,0xa5,0x25,0xff,0x5a,0x2a,0x9b,0x36,0x8a,
+  0xb5,0x5b,0x1c,0x6c,0xe8,0xd0,0x74,0xd8,0x00,0xc3,0x90,0x69,0x89,0x8e,0x15,0xcb,
+  0x94,0x26,0xd1,0x69,0x32,0x55,0xdf,0x7d,0x47,0xc9,0x4e,0xd2,0x14,0xfb,0xc7,0x26,
+  0xa9,0x3b,0xde,0xbb,0x77,0xef,0xf1,0x4e,0x16,0x4e,0x29,0xa8,0x12,0xb3,0x6a,0x9b,
+  0x15,0x34,0x55,0xc6,0xd9,0x3b,0x89,0x76,0x14,0x4b,0xb6,0xf4,0xd5,0x7e,0xe9,0xaf,
+  0x58,0x65,0x0f,0x4b,0xa1,0x96,0xfb,0x15,0x68,0xb1,0x9f,0x12,0x49,0xe6,0xfe,0x38,
+  0xf0,0x60,0x2b,0x7a,0xcb,0x64,0xb1,0xea,0x71,0xa3,0x4a,0x43,0xf7,0x6c,0x62,0x6f,
+  0x98,0x94,0x13,0xdd,0xed,0xb6,0x49,0xa9,0xd8,0xce,0x87,0x81,0xdf,0xcd,0x65,0x51,
+  0xaa,0x85,0x36,0xb4,0x5c,0x7a,0x2b,0xf0,0xc7,0x6c,0x82,0x97,0x75,0x29,0x21,0x5d,
+  0xcd,0x78,0x2e,0xe3,0x6b,0x23,0x0b,0x43,0xfb,0x40,0x3c,0xc2,0x56,0xa2,0xe4,0x65,
+  0x9a,0x44,0x8a,0x6e,0xe7,0x5e,0xe0,0x43,0xca,0x26,0xe5,0xe3,0x51,0xca,0xea,0xda,
+  0x5e,0x6c,0x44,0x15,0x27,0xa5,0xdc,0xa4,0x2a,0x46,0x1c,0x89,0xce,0x8f,0x06,0x43,
+  0xb3,0xa3,0xb1,0x8b,0x01,0xa4,0x89,0xde,0xe3,0x97,0x7e,0x0d,0xae,0xa8,0x0a,0x65,
+  0x64,0xa2,0x83,0x0b,0xc8,0x74,0xe0,0x8f,0x21,0xdb,0x6e,0x03,0xaf,0x86,0x50,0x54,
+  0xc4,0xe3,0x7e,0x49,0x30,0x9f,0xd8,0x3f,0x7f,0x3c,0xb8,0x18,0xe2,0xf2,0x40,0x82,
+  0x41,0xff,0xa7,0xf1,0x05,0x2e,0x77,0x24,0x18,0xbe,0xf3,0x47,0x78,0x8d,0x16,0x71,
+  0x16,0x1d,0x0f,0x4a,0x1b,0x28,0x44,0x9a,0x45,0xd2,0x24,0x99,0x06,0x29,0x34,0xff,
+  0xe7,0xa8,0x8a,0x87,0x6b,0x95,0xaa,0xc8,0x64,0x05,0xdf,0x24,0x3a,0xa6,0x9a,0x41,
+  0x2c,0x24,0x25,0xc8,0xc6,0x81,0x30,0x48,0xc5,0xa7,0xcd,0x2d,0x7e,0xe6,0x98,0x5d,
+  0x24,0xaa,0x84,0x5c,0x9c,0xf9,0x00,0x64,0x55,0xcc,0x34,0xff,0x5a,0x24,0x46,0x51,
+  0xc5,0x20,0xc1,0x49,0x80,0x61,0x62,0x96,0xe3,0x8e,0x9b,0xec,0x1a,0x33,0xf4,0x0d,
+  0x45,0xc6,0x9e,0x68,0x32,0x0d,0x4d,0x10,0xd9,0x54,0xc5,0x0f,0x32,0xb7,0xc3,0x4b,
+  0x30,0xaf,0xcf,0x18,0xbf,0xcd,0x12,0x8d,0xbc,0x32,0xc8,0xce,0x9f,0x4d,0xb4,0xa3,
+  0x3d,0x5e,0xf5,0xeb,0xde,0x0d,0x3b,0x47,0xe3,0x8f,0x9d,0x02,0x83,0x45,0x13,0xa5,
+  0xa3,0x2c,0x56,0x7f,0x7e,0x5e,0xfc,0x9c,0x1d,0xf2,0x4c,0x23,0x4c,0x0b,0xe5,0x78,
+  0x86,0x92,0x5a,0x28,0xa7,0xc4,0xf5,0x34,0xcb,0x6d,0xeb,0xce,0x9d,0x4c,0x8f,0x4a,
+  0xb8,0x95,0x42,0x81,0xd4,0x4e,0xfb,0x2f,0x84,0x99,0x93,0xb2,0xa1,0x42,0xc5,0x24,
+  0x20,0xa4,0x9e,0xd9,0x0f,0xde,0xaa,0x9e,0xf6,0xda,0xb4,0xd9,0xfa,0x19,0xc2,0x6d,
+  0x53,0x00,0x5c,0x1c,0x05,0x6e,0xed,0xdd,0xcd,0x1c,0x1d,0xf3,0x90,0x2b,0x41,0xa2,
+  0x9d,0x8a,0xf6,0x9b,0xec,0x9e,0x38,0x5a,0x1e,0x70,0x8f,0x37,0xd5,0xe4,0xb1,0xac,
+  0xb1,0x35,0xa9,0xdb,0x41,0x7c,0xb6,0x68,0x13,0xfc,0x54,0x33,0xac,0xd7,0x70,0x25,
+  0x28,0xde,0x59,0xb5,0x62,0xd1,0xea,0xab,0xf3,0x0b,0x4e,0xe3,0x83,0x34,0x92,0xc6,
+  0x0c,0x55,0x81,0xbd,0x18,0x7e,0xa3,0xcc,0xfb,0xf4,0x79,0x7b,0x96,0x75,0xc6,0x0b,
+  0x15,0x1f,0x51,0x6b,0xa7,0xf6,0xd5,0x37,0x03,0x1e,0x9b,0x18,0x5e,0x2a,0x43,0xc9,
+  0xa5,0xe7,0x11,0x88,0x68,0x46,0x15,0xc7,0x65,0x9b,0x88,0x81,0xe1,0xb9,0x96,0x16,
+  0x24,0x27,0xdd,0x10,0x55,0xe2,0xa2,0x0e,0x26,0xa8,0xbd,0x63,0xa1,0x1d,0xc3,0x63,
+  0xa4,0x05,0x47,0x8c,0xd2,0x28,0x6a,0xc6,0x5a,0xa7,0xd8,0xf8,0x50,0xf8,0xe3,0x49,
+  0x38,0xed,0x0f,0x27,0xe1,0xd9,0x34,0x5a,0x58,0x63,0x84,0x3f,0x18,0xe3,0x0c,0x61,
+  0x81,0xae,0x81,0x84,0x8e,0x47,0xa3,0xc1,0xa8,0xe3,0xb6,0x7b,0x06,0x43,0xc6,0xea,
+  0x73,0xb5,0x1a,0x76,0x27,0x6e,0xcf,0xb0,0xc2,0x86,0x82,0xbf,0x7f,0xff,0xed,0xd2,
+  0x98,0xfc,0xb3,0x42,0xd1,0x96,0x66,0x12,0xf2,0x2c,0x57,0xba,0x09,0x7c,0xe5,0x33,
+  0x08,0xf1,0x7a,0x54,0xaf,0xcb,0x6a,0xb8,0x6f,0xc8,0x2b,0xf8,0xae,0x50,0x5b,0x41,
+  0x7a,0x63,0xec,0x79,0xf3,0xe2,0xc8,0x27,0x70,0xfd,0xe2,0xa8,0x4f,0xe0,0xee,0xc5,
+  0xd1,0x80,0xc0,0x65,0x3b,0x08,0xcd,0x37,0x59,0xfc,0xc0,0x13,0xad,0x55,0xf1,0x45,
+  0xdd,0x1b,0x41,0xfe,0x92,0x89,0x71,0x46,0x25,0xe7,0x9c,0x00,0x36,0xf6,0x25,0x39,
+  0x28,0x34,0x30,0xbd,0x83,0x91,0x1a,0x20,0x86,0x9b,0x36,0x6f,0x47,0xc9,0xaf,0x1f,
+  0xbf,0x10,0x20,0xbd,0x77,0x3e,0x8a,0xe6,0x92,0xe2,0xa7,0x5b,0x3b,0xbe,0x4a,0xf1,
+  0xbc,0x50,0x77,0xa8,0xd6,0x0f,0x6a,0x2b,0x8f,0xa9,0xa1,0x6c,0xd2,0x4e,0xfb,0x7d,
+  0x51,0xc8,0x07,0xbe,0x2d,0xb2,0x03,0xbd,0xa2,0xec,0x6c,0x3b,0xca,0x80,0x2e,0xb1,
+  0xd7,0x95,0x95,0x9a,0x5b,0x2d,0x70,0xd4,0xb5,0xb0,0xff,0x86,0xd5,0x8f,0xb2,0xec,
+  0x20,0xcd,0x58,0xf1,0x8f,0x4f,0xd7,0x4d,0x49,0x02,0xa6,0x4b,0x3a,0xff,0x7a,0x9e,
+  0xf0,0x4e,0xb5,0xcf,0x13,0x7d,0x14,0x00,0x0e,0xf2,0xa3,0x44,0x8b,0x51,0x7c,0x0e,
+  0xce,0x6c,0xa3,0xfb,0xbb,0xf8,0xd2,0xa4,0x82,0x0e,0x3a,0x9a,0xbd,0x12,0xde,0x7c,
+  0x4b,0xad,0x2c,0x24,0x0c,0x41,0x33,0x14,0x29,0x3e,0x01,0x27,0x75,0x35,0x11,0x42,
+  0x0c,0xbe,0x7d,0x3b,0xad,0xfa,0x9d,0x8e,0x9c,0x0d,0xe6,0x2a,0x30,0xf6,0x31,0x40,
+  0x21,0xc4,0x3f,0x08,0x01,0xad,0x9f,0x5b,0x05,0x2e,0xed,0xe8,0x93,0xd5,0x4b,0xc1,
+  0x52,0x35,0x9d,0x5e,0xb0,0xae,0x61,0x28,0x5b,0x34,0x78,0x4e,0xd7,0xd3,0xd6,0x94,
+  0x27,0x27,0xe5,0x6e,0x25,0x6b,0x82,0x36,0x39,0x52,0x17,0xfa,0x43,0xac,0x8a,0xfe,
+  0x6c,0x23,0x66,0x6b,0xb0,0xce,0xbc,0x12,0xe4,0x75,0x4c,0x84,0xc0,0x39,0xca,0x72,
+  0x37,0x5f,0x4f,0x4d,0x8c,0xe1,0x1a,0xc3,0x70,0xb1,0xb6,0xf8,0x77,0xcd,0xb5,0xcf,
+  0xfc,0xaa,0x8f,0x87,0x8d,0x2a,0x9c,0x28,0x95,0x65,0x29,0xcc,0xc5,0xa9,0xd4,0xc2,
+  0xad,0x92,0x47,0xd7,0xa2,0x85,0xed,0x1b,0x3b,0xe8,0x44,0x78,0x74,0x48,0xb4,0xf0,
+  0x9c,0x83,0xbc,0x17,0xcd,0xd9,0xec,0x7b,0x88,0x6d,0x5e,0x03,0x31,0x84,0xe6,0x09,
+  0xee,0x44,0x2f,0x51,0x4e,0x4a,0x44,0x60,0x8a,0x99,0x05,0xf7,0xda,0xad,0xe2,0xae,
+  0xdf,0xe2,0xb3,0xfb,0xff,0x6d,0xd8,0xc0,0xe0,0xbb,0x7e,0x9f,0x32,0xda,0x5e,0xda,
+  0x84,0xab,0x17,0xb0,0x91,0xe9,0x2b,0xcb,0x34,0x9e,0xe5,0xd2,0x18,0x55,0xa0,0xcb,
+  0x97,0x5f,0xdf,0xf0,0xb7,0xab,0xca,0x07,0x7f,0x84,0xc7,0x05,0x5a,0x2a,0xc1,0x31,
+  0x38,0x26,0x31,0x29,0xe6,0xf8,0x8e,0xc9,0x1c,0x7f,0xe4,0xa0,0x1a,0x30,0xbc,0x04,
+  0xa7,0xe5,0x07,0x17,0x52,0xc7,0xce,0xdb,0x37,0x21,0x77,0x74,0xe6,0x94,0xb9,0x8c,
+  0x54,0x49,0x2c,0x0d,0xa9,0xd2,0x37,0x66,0x27,0xfc,0x51,0xef,0x09,0x93,0x5b,0xa5,
+  0xf5,0xb3,0xcd,0xe2,0xf9,0x66,0xd7,0x6e,0xdc,0xea,0xca,0x2e,0x0a,0x7c,0x58,0x6b,
+  0x06,0x55,0x11,0xdc,0x40,0x19,0xdc,0x42,0x1a,0xdc,0x41,0x14,0x6c,0x20,0x09,0xee,
+  0xe1,0x36,0xb8,0xae,0x6b,0xf6,0x1f,0xc6,0xf7,0x88,0x26,0xe7,0x07,0x00,0x00,
+};
+#endif // PCF8574_SUPPORT == 1
+#endif // OB_EEPROM_SUPPORT == 0
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
+#endif // HTTPD_SCRIPT_GZIP == 1 && HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0
@@ -58,6 +58,20 @@ int32_t current;       // Current value (x1,000) reported by the INA226
 int32_t power;         // Power value (x1,000) reported by the INA226
 int32_t current_lsb;   // (x1,000,000)
 
+#if INA226_FAST_READ == 1
+uint8_t ina226_found;        // One bit per INA226 device (bit 0 = INA226_1)
+                             // set if the device returned the Mfg ID at boot
+uint16_t ina226_regs[5][3];  // Bus voltage, current and power registers last
+                             // read from each INA226 device
+
+static const uint8_t ina226_write_commands[5] = {
+  INA226_1_write,
+  INA226_2_write,
+  INA226_3_write,
+  INA226_4_write,
+  INA226_5_write };
+#endif // INA226_FAST_READ == 1
+
 extern uint8_t stored_shunt_res; // INA226 Shunt Resistance value stored in
                                  // EEPROM
 
@@ -90,9 +104,35 @@ void ina226_init_all()
   ina226_write_reg(INA226_3_write, INA226_REG_CONFIGURATION, INA226_CONFIGURATION__RST);
   ina226_write_reg(INA226_4_write, INA226_REG_CONFIGURATION, INA226_CONFIGURATION__RST);
   ina226_write_reg(INA226_5_write, INA226_REG_CONFIGURATION, INA226_CONFIGURATION__RST);
+#if INA226_FAST_READ == 1
+  ina226_detect_all();
+#endif // INA226_FAST_READ == 1
 }
 
 
+#if INA226_FAST_READ == 1
+void ina226_detect_all()
+{
+  // Check the Mfg ID of all five INA226 chips once so that
+  // ina226_read_measurements() does not have to check it on every read.
+  // The read command of each device is its write command with bit 0 set.
+  uint8_t i;
+  
+  ina226_found = 0;
+  for (i = 0; i < 5; i++) {
+    if (ina226_read_reg(ina226_write_commands[i],
+                        (uint8_t)(ina226_write_commands[i] | 0x01),
+			INA226_REG_MFG_ID) == INA226_MFG_ID) {
+      ina226_found |= (uint8_t)(1 << i);
+    }
+    ina226_regs[i][0] = 0;
+    ina226_regs[i][1] = 0;
+    ina226_regs[i][2] = 0;
+  }
+}
+#endif // INA226_FAST_READ == 1
+
+
 void ina226_calibrate_all()
 {
   int32_t shunt_resistance;
@@ -249,12 +289,24 @@ void ina226_read_measurements(uint8_t write_command, uint8_t read_command)
   //
   // Measurements are read only if the Mfg ID code is found. Otherwise all
   // values are set to 0.
+  //
+  // With INA226_FAST_READ the Mfg ID was checked at boot by
+  // ina226_detect_all(), and the measurement registers are only read if
+  // the Conversion Ready flag is set. Reading the Mask/Enable register
+  // clears the flag, so if it is not set the registers have not changed
+  // since they were last read and the saved copies are used.
   
   uint16_t voltage_reg;
   int16_t current_reg;
   int16_t power_reg;
+#if INA226_FAST_READ == 0
   uint16_t mfg_id_reg;
+#endif // INA226_FAST_READ == 0
+#if INA226_FAST_READ == 1
+  uint8_t device;
+#endif // INA226_FAST_READ == 1
 
+#if INA226_FAST_READ == 0
   // Read the Mfg ID
   mfg_id_reg = (uint16_t)(ina226_read_reg(write_command, read_command, INA226_REG_MFG_ID));
   
@@ -268,6 +320,26 @@ void ina226_read_measurements(uint8_t write_command, uint8_t read_command)
 
     // Read POWER register
     power_reg = (int16_t)(ina226_read_reg(write_command, read_command, INA226_REG_POWER));
+#endif // INA226_FAST_READ == 0
+
+#if INA226_FAST_READ == 1
+  // Convert the write_command to a device number 0 to 4. The write
+  // commands are 0x80, 0x82, 0x84, 0x88 and 0x8a.
+  device = (uint8_t)((write_command >> 1) & 0x07);
+  if (device > 3) device--;
+  
+  if (ina226_found & (uint8_t)(1 << device)) {
+    
+    if (ina226_read_reg(write_command, read_command, INA226_REG_MASK_ENABLE) & INA226_MASK_ENABLE__CVRF) {
+      // Read BUS voltage, current and POWER registers
+      ina226_regs[device][0] = ina226_read_reg(write_command, read_command, INA226_REG_BUS_VOLTAGE);
+      ina226_regs[device][1] = ina226_read_reg(write_command, read_command, INA226_REG_CURRENT);
+      ina226_regs[device][2] = ina226_read_reg(write_command, read_command, INA226_REG_POWER);
+    }
+    voltage_reg = ina226_regs[device][0];
+    current_reg = (int16_t)(ina226_regs[device][1]);
+    power_reg = (int16_t)(ina226_regs[device][2]);
+#endif // INA226_FAST_READ == 1
 
 
     // Convert to Volts
@@ -339,12 +411,16 @@ uint16_t ina226_read_reg(uint8_t write_command, uint8_t read_command, uint8_t re
   //   Write the I2C address with the Read/Write bit set to 1 (read).
   //   Read the register (2 bytes). The read function will issue a STOP after
   //     the second byte.
+  // With INA226_FAST_READ the STOP is left out so that the read address is
+  // sent with a repeated START.
   uint8_t buf[2];
   uint16_t rtn;
 
   I2C_control(write_command);       // Write I2C address with Write mode
   I2C_write_byte(register_address); // Write register_address
+#if INA226_FAST_READ == 0
   I2C_stop();
+#endif // INA226_FAST_READ == 0
   I2C_control(read_command);        // Write I2C address with Read mode
   buf[0] = I2C_read_byte(0);        // Read upper byte of register
   buf[1] = I2C_read_byte(1);        // Read lower byte of register followed by
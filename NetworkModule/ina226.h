@@ -74,6 +74,7 @@
 
 
 void ina226_init_all(void);
+void ina226_detect_all(void);
 void ina226_calibrate_all(void);
 // void ina226_calibrate(uint8_t write_command, float r_shunt, float max_current);
 void ina226_calibrate(uint8_t write_command, int32_t r_shunt, int32_t max_current);
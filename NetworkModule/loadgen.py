@@ -0,0 +1,428 @@
+#!/usr/bin/env python3
+#
+# Load and soak tests for a Network Module
+#
+# Runs one of the scenarios below against a real module and reports a
+# latency histogram for every HTTP request and MQTT publish, plus the
+# change in the module's own error counters over the run. The counters are
+# read from the Status Record at URL /96, so the module must be built with
+# HTTPD_STATUS_RECORD enabled. MQTT scenarios need the broker address and
+# the module's Device Name.
+#
+#   iocontrol  Five Browsers refreshing the IOControl page
+#   sstate     A script polling the Very Short Form IO States page at 2 Hz
+#   flood      Back to back Output commands by URL, and by MQTT if a
+#              broker is given
+#   discovery  The Home Assistant discovery burst after a broker restart
+#   soak       iocontrol, sstate and MQTT commands together for an hour
+#
+# For example:
+#   python3 loadgen.py --ip 192.168.1.4 iocontrol
+#   python3 loadgen.py --ip 192.168.1.4 --broker 192.168.1.10 \
+#     --name Relay4 soak --duration 7200
+#
+# Each scenario has pass/fail thresholds. The exit status is 0 if all of
+# them were met and 1 if not. There is no host build of the firmware, so
+# a real module is always needed.
+
+import argparse
+import http.client
+import socket
+import struct
+import sys
+import threading
+import time
+
+# Status Record field positions (see CopyHttpStatus() in httpd.c)
+STATUS_MQTT_RESP_TOUT = 14
+STATUS_MQTT_NOT_OK = 15
+STATUS_MQTT_BROKER_DIS = 16
+STATUS_DEBUG_BYTES = 17
+STATUS_SECONDS = 28
+STATUS_SYN_DROP = 29
+
+# Counters reported for every run, as (name, field, width in bits). The
+# link error statistics are debug_bytes[] in the Status Record.
+COUNTERS = [
+    ('MQTT_resp_tout_counter', STATUS_MQTT_RESP_TOUT, 8),
+    ('MQTT_not_OK_counter', STATUS_MQTT_NOT_OK, 8),
+    ('MQTT_broker_dis_counter', STATUS_MQTT_BROKER_DIS, 8),
+    ('TXERIF', STATUS_DEBUG_BYTES + 3, 8),
+    ('RXERIF', STATUS_DEBUG_BYTES + 4, 8),
+    ('syn_drop_counter', STATUS_SYN_DROP, 8),
+]
+
+# Histogram bucket upper limits in ms
+BUCKETS = [1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000]
+
+# Scenario definitions. "limits" are the pass/fail thresholds: p95 and
+# max latency in ms, the error ratio, and the largest allowed change of
+# each counter. Counters that are not listed must not change.
+SCENARIOS = {
+    'iocontrol': {
+        'duration': 300,
+        'http': [('/60', 5, 1.0)],
+        'limits': {'p95': 2000, 'max': 5000, 'errors': 0.01,
+                   'counters': {'RXERIF': 2, 'syn_drop_counter': 10}},
+    },
+    'sstate': {
+        'duration': 300,
+        'http': [('/98', 1, 0.5)],
+        'limits': {'p95': 200, 'max': 1000, 'errors': 0.0,
+                   'counters': {}},
+    },
+    'flood': {
+        'duration': 60,
+        'http': [('/01', 1, 0.0), ('/00', 1, 0.0)],
+        'mqtt': 0.0,
+        'limits': {'p95': 500, 'max': 2000, 'errors': 0.01,
+                   'counters': {'RXERIF': 5, 'syn_drop_counter': 50}},
+    },
+    'discovery': {
+        'duration': 120,
+        'discovery': True,
+        'limits': {'burst': 30000, 'counters':
+                   {'MQTT_broker_dis_counter': 1}},
+    },
+    'soak': {
+        'duration': 3600,
+        'http': [('/60', 5, 1.0), ('/98', 1, 0.5)],
+        'mqtt': 1.0,
+        'limits': {'p95': 2000, 'max': 5000, 'errors': 0.001,
+                   'counters': {'RXERIF': 10, 'syn_drop_counter': 50}},
+    },
+}
+
+
+class Histogram:
+    def __init__(self, name):
+        self.name = name
+        self.samples = []
+        self.errors = 0
+        self.lock = threading.Lock()
+
+    def add(self, ms):
+        with self.lock:
+            self.samples.append(ms)
+
+    def error(self):
+        with self.lock:
+            self.errors += 1
+
+    def percentile(self, p):
+        if not self.samples:
+            return 0.0
+        s = sorted(self.samples)
+        return s[min(len(s) - 1, int(len(s) * p / 100.0))]
+
+    def error_ratio(self):
+        total = len(self.samples) + self.errors
+        return self.errors / total if total else 0.0
+
+    def report(self):
+        n = len(self.samples)
+        print('%s: %d ok, %d errors' % (self.name, n, self.errors))
+        if not n:
+            return
+        print('  min %.1f  p50 %.1f  p95 %.1f  p99 %.1f  max %.1f ms' % (
+            min(self.samples), self.percentile(50), self.percentile(95),
+            self.percentile(99), max(self.samples)))
+        counts = [0] * (len(BUCKETS) + 1)
+        for ms in self.samples:
+            i = 0
+            while i < len(BUCKETS) and ms > BUCKETS[i]:
+                i += 1
+            counts[i] += 1
+        top = max(counts)
+        for i, c in enumerate(counts):
+            if not c:
+                continue
+            label = '<= %d' % BUCKETS[i] if i < len(BUCKETS) else '>  %d' % BUCKETS[-1]
+            print('  %8s ms %7d %s' % (label, c, '#' * max(1, c * 40 // top)))
+
+
+def http_get(host, port, path, timeout):
+    # One request per connection, as a Browser refresh does. Returns the
+    # latency to the last byte of the body in ms.
+    start = time.monotonic()
+    conn = http.client.HTTPConnection(host, port, timeout=timeout)
+    try:
+        conn.request('GET', path, headers={'Connection': 'close'})
+        resp = conn.getresponse()
+        resp.read()
+        if resp.status not in (200, 302, 304):
+            raise IOError('HTTP status %d' % resp.status)
+    finally:
+        conn.close()
+    return (time.monotonic() - start) * 1000.0
+
+
+def read_counters(args):
+    conn = http.client.HTTPConnection(args.ip, args.port, timeout=args.timeout)
+    try:
+        conn.request('GET', '/96', headers={'Connection': 'close'})
+        fields = conn.getresponse().read().decode('latin1').strip().split(',')
+    finally:
+        conn.close()
+    if len(fields) <= STATUS_SYN_DROP:
+        raise SystemExit('Unexpected Status Record: %s' % ','.join(fields))
+    values = {name: int(fields[i], 16) for name, i, _ in COUNTERS}
+    values['seconds'] = int(fields[STATUS_SECONDS], 16)
+    return values
+
+
+def counter_deltas(before, after):
+    deltas = {}
+    for name, _, bits in COUNTERS:
+        # The counters are 8 bit and saturate or wrap on the module
+        deltas[name] = (after[name] - before[name]) % (1 << bits)
+    return deltas
+
+
+class Mqtt:
+    # Minimal MQTT 3.1.1 client: QoS 0 publish and subscribe only, which
+    # is all the Network Module uses.
+    def __init__(self, host, port, on_message):
+        self.sock = socket.create_connection((host, port), timeout=10)
+        self.on_message = on_message
+        self.send_lock = threading.Lock()
+        self.running = True
+        client_id = ('loadgen%d' % (int(time.time()) % 100000)).encode()
+        body = self.string(b'MQTT') + bytes([4, 0x02]) + struct.pack('>H', 60)
+        self.packet(0x10, body + self.string(client_id))
+        header, _ = self.read_packet()
+        if header != 0x20:
+            raise SystemExit('MQTT broker refused the connection')
+        self.sock.settimeout(None)
+        threading.Thread(target=self.reader, daemon=True).start()
+        threading.Thread(target=self.pinger, daemon=True).start()
+
+    @staticmethod
+    def string(data):
+        return struct.pack('>H', len(data)) + data
+
+    def packet(self, header, body):
+        length = len(body)
+        encoded = b''
+        while True:
+            b = length & 0x7f
+            length >>= 7
+            encoded += bytes([b | 0x80 if length else b])
+            if not length:
+                break
+        with self.send_lock:
+            self.sock.sendall(bytes([header]) + encoded + body)
+
+    def read_exact(self, n):
+        data = b''
+        while len(data) < n:
+            chunk = self.sock.recv(n - len(data))
+            if not chunk:
+                raise IOError('MQTT connection closed')
+            data += chunk
+        return data
+
+    def read_packet(self):
+        header = self.read_exact(1)[0]
+        length, shift = 0, 0
+        while True:
+            b = self.read_exact(1)[0]
+            length |= (b & 0x7f) << shift
+            shift += 7
+            if not b & 0x80:
+                break
+        return header, self.read_exact(length)
+
+    def reader(self):
+        while self.running:
+            try:
+                header, body = self.read_packet()
+            except (IOError, OSError):
+                return
+            if header & 0xf0 == 0x30:
+                n = struct.unpack('>H', body[:2])[0]
+                start = 2 + n + (2 if header & 0x06 else 0)
+                self.on_message(body[2:2 + n].decode('latin1'), body[start:],
+                                header & 0x01, time.monotonic())
+
+    def pinger(self):
+        while self.running:
+            time.sleep(30)
+            try:
+                self.packet(0xc0, b'')
+            except OSError:
+                return
+
+    def subscribe(self, topic):
+        self.packet(0x82, struct.pack('>H', 1) + self.string(topic.encode()) + b'\0')
+
+    def publish(self, topic, payload):
+        self.packet(0x30, self.string(topic.encode()) + payload)
+
+    def close(self):
+        self.running = False
+        try:
+            self.packet(0xe0, b'')
+        except OSError:
+            pass
+        self.sock.close()
+
+
+def http_worker(args, path, interval, hist, stop):
+    while not stop.is_set():
+        start = time.monotonic()
+        try:
+            hist.add(http_get(args.ip, args.port, path, args.timeout))
+        except (IOError, OSError, http.client.HTTPException):
+            hist.error()
+        wait = interval - (time.monotonic() - start)
+        if wait > 0:
+            stop.wait(wait)
+
+
+def mqtt_worker(args, interval, hist, stop):
+    # Toggles Output 01 and times each command from the PUBLISH to the
+    # module's state PUBLISH for that Output.
+    base = 'NetworkModule/%s/output/01' % args.name
+    echo = threading.Event()
+    expect = [b'']
+
+    def on_message(topic, payload, retained, when):
+        if topic == base and payload == expect[0]:
+            echo.set()
+
+    client = Mqtt(args.broker, args.broker_port, on_message)
+    client.subscribe(base)
+    state = False
+    while not stop.is_set():
+        state = not state
+        expect[0] = b'ON' if state else b'OFF'
+        echo.clear()
+        start = time.monotonic()
+        client.publish(base + '/set', expect[0])
+        if echo.wait(args.timeout):
+            hist.add((time.monotonic() - start) * 1000.0)
+        else:
+            hist.error()
+        wait = interval - (time.monotonic() - start)
+        if wait > 0:
+            stop.wait(wait)
+    client.close()
+
+
+def run_discovery(args, scenario):
+    # Counts the discovery config messages that follow the module's
+    # "online" availability message. Restart the broker, or reboot the
+    # module with URL /91, once the tool is waiting.
+    seen = {}
+    first = [None]
+    last = [None]
+
+    def on_message(topic, payload, retained, when):
+        # Retained copies from the last connection are not part of the burst
+        if retained:
+            return
+        if topic.endswith('/availability') and payload == b'online':
+            first[0] = when
+        elif topic.startswith('homeassistant/') and payload:
+            seen[topic] = when
+            last[0] = when
+
+    client = Mqtt(args.broker, args.broker_port, on_message)
+    client.subscribe('NetworkModule/%s/availability' % args.name)
+    client.subscribe('homeassistant/#')
+    print('Waiting for the module to reconnect to the broker')
+    deadline = time.monotonic() + scenario['duration']
+    while time.monotonic() < deadline:
+        time.sleep(0.5)
+        if last[0] and time.monotonic() - last[0] > 5:
+            break
+    client.close()
+    if first[0] is None or last[0] is None:
+        print('No discovery burst seen')
+        return None
+    burst = (last[0] - first[0]) * 1000.0
+    print('Discovery burst: %d config messages in %.0f ms' % (len(seen), burst))
+    return burst
+
+
+def main():
+    p = argparse.ArgumentParser(description='Load and soak tests for a Network Module')
+    p.add_argument('scenario', choices=sorted(SCENARIOS))
+    p.add_argument('--ip', required=True, help='Network Module IP address')
+    p.add_argument('--port', type=int, default=80)
+    p.add_argument('--broker', help='MQTT broker IP address')
+    p.add_argument('--broker-port', type=int, default=1883)
+    p.add_argument('--name', help='Network Module Device Name (MQTT topics)')
+    p.add_argument('--duration', type=int, help='Run time in seconds')
+    p.add_argument('--timeout', type=float, default=5.0)
+    args = p.parse_args()
+
+    scenario = SCENARIOS[args.scenario]
+    if args.duration:
+        scenario['duration'] = args.duration
+    if ('mqtt' in scenario or 'discovery' in scenario) and not (args.broker and args.name):
+        if 'discovery' in scenario:
+            raise SystemExit('The %s scenario needs --broker and --name' % args.scenario)
+        del scenario['mqtt']
+
+    before = read_counters(args)
+    limits = scenario['limits']
+    failed = []
+    hists = []
+
+    if 'discovery' in scenario:
+        burst = run_discovery(args, scenario)
+        if burst is None or burst > limits['burst']:
+            failed.append('discovery burst')
+    else:
+        stop = threading.Event()
+        threads = []
+        for path, clients, interval in scenario['http']:
+            hist = Histogram('GET %s' % path)
+            hists.append(hist)
+            for _ in range(clients):
+                threads.append(threading.Thread(
+                    target=http_worker, args=(args, path, interval, hist, stop)))
+        if 'mqtt' in scenario:
+            hist = Histogram('MQTT output/01/set')
+            hists.append(hist)
+            threads.append(threading.Thread(
+                target=mqtt_worker, args=(args, scenario['mqtt'], hist, stop)))
+        print('Running %s for %d seconds' % (args.scenario, scenario['duration']))
+        for t in threads:
+            t.start()
+        try:
+            stop.wait(scenario['duration'])
+        except KeyboardInterrupt:
+            pass
+        stop.set()
+        for t in threads:
+            t.join()
+        for hist in hists:
+            hist.report()
+            if hist.percentile(95) > limits['p95'] or \
+               (hist.samples and max(hist.samples) > limits['max']) or \
+               hist.error_ratio() > limits['errors']:
+                failed.append(hist.name)
+
+    after = read_counters(args)
+    if after['seconds'] < before['seconds']:
+        print('The module restarted during the run, counters not compared')
+    else:
+        deltas = counter_deltas(before, after)
+        print('Counter changes:')
+        for name, _, _ in COUNTERS:
+            allowed = limits['counters'].get(name, 0)
+            print('  %-24s %3d (limit %d)' % (name, deltas[name], allowed))
+            if deltas[name] > allowed:
+                failed.append(name)
+
+    if failed:
+        print('FAIL: %s' % ', '.join(failed))
+        sys.exit(1)
+    print('PASS')
+
+
+if __name__ == '__main__':
+    main()
@@ -149,6 +149,7 @@
                                                        // = 384 bytes
 #define I2C_EEPROM_R1_FOUNDROM		0xff40 // 64 bytes
 #define I2C_EEPROM_R1_LOGIN_PASSPHRASE	0xff80 // 16 bytes
+#define I2C_EEPROM_R1_FLASH_TIMING	0xff90 // 3 bytes
 
 
 //---------------------------------------------------------------------------//
@@ -225,6 +226,7 @@
 #define MQTT_START_MQTT_INIT		4
 #define MQTT_START_UIP_CONNECT_CLEANUP1 5
 #define MQTT_START_UIP_CONNECT_CLEANUP2 6
+#define MQTT_START_RECONNECT_WAIT	7
 #define MQTT_START_QUEUE_CONNECT	10
 #define MQTT_START_VERIFY_CONNACK	11
 #define MQTT_START_QUEUE_SUBSCRIBE1	20
@@ -233,9 +235,13 @@
 #define MQTT_START_VERIFY_SUBSCRIBE2    23
 #define MQTT_START_QUEUE_SUBSCRIBE3	24
 #define MQTT_START_VERIFY_SUBSCRIBE3    25
+#define MQTT_START_QUEUE_SUBSCRIBE4	26
+#define MQTT_START_VERIFY_SUBSCRIBE4    27
+#define MQTT_START_VERIFY_FINGERPRINT	28
 #define MQTT_START_QUEUE_PUBLISH_ON	30
 #define MQTT_START_QUEUE_PUBLISH_AUTO   31
 #define MQTT_START_QUEUE_PUBLISH_PINS	32
+#define MQTT_START_QUEUE_PUBLISH_FINGERPRINT 33
 #define MQTT_START_COMPLETE		40
 
 // MQTT Start Status
@@ -249,6 +255,41 @@
 #define MQTT_START_TCP_CONNECT_GOOD	0x40
 #define MQTT_START_MQTT_CONNECT_GOOD	0x80
 
+// MQTT topic prefix
+// Size of "NetworkModule/" plus the longest devicename plus the '\0'
+#define TOPIC_PREFIX_SIZE		34
+
+// MQTT reconnect backoff
+// The first reconnect waits up to MQTT_BACKOFF_BASE seconds. The window
+// doubles with each failed attempt up to MQTT_BACKOFF_STEPS doublings
+// (4 seconds up to 256 seconds).
+#define MQTT_BACKOFF_BASE		4
+#define MQTT_BACKOFF_STEPS		6
+
+// Sensor publish deadbands (SENSOR_DEADBAND option)
+// A new reading is published when it moves by at least this much from the
+// last published reading, in the units of the raw readings.
+#define DS18B20_DEADBAND		8	// 0.5 degree C (1/16 C units)
+#define BME280_DEADBAND_TEMP		50	// 0.5 degree C (0.01 C units)
+#define BME280_DEADBAND_PRES		100	// 1 hPa (Pa units)
+#define BME280_DEADBAND_HUM		2048	// 2 % (1/1024 % units)
+
+// Inbound command rate limit (COMMAND_RATE_LIMIT option)
+// Each source may send COMMAND_RATE_BURST commands back to back, then one
+// command every COMMAND_RATE_REFILL x 100ms (5 per second).
+#define COMMAND_RATE_BURST		8
+#define COMMAND_RATE_REFILL		2
+
+// IO state word byte lanes (IO_BYTE_LANES option)
+// The byte of a 32 bit IO state word that holds the bit of IO pin i (0 to
+// 23). The STM8 is Big Endian, so pins 1 to 8 are in the last byte.
+#define IO_LANE(w, i)		(((uint8_t *)&(w))[3 - ((i) >> 3)])
+
+// Linked pin fast path (LINKED_FAST_PATH option)
+// Time in ms that further edges on a Linked Input are ignored after the
+// interrupt toggled its Output.
+#define LINKED_FAST_DEBOUNCE		30
+
 // MQTT Restart States
 #define MQTT_RESTART_IDLE		0
 #define MQTT_RESTART_BEGIN		1
@@ -258,6 +299,24 @@
 #define MQTT_RESTART_TCPCLOSE_WAIT	5
 #define MQTT_RESTART_SIGNAL_STARTUP	6
 
+// UDP log events (see UDP_LOG_SUPPORT)
+#define UDP_LOG_MQTT			0	// MQTT restart step entered
+#define UDP_LOG_RXERIF			1	// Receive buffer overflow
+#define UDP_LOG_TXRTS			2	// Transmit timeout
+#define UDP_LOG_STACK			3	// Stack guardband overwritten
+#define UDP_LOG_LOOP			4	// Slow main loop pass
+#define UDP_LOG_EVENTS			16	// Size of the event queue
+#define UDP_LOG_PORT			514	// syslog port
+#define UDP_LOG_SLOW_LOOP		50	// Slowest loop pass logged (ms)
+
+// Boot stages (see BOOT_PROFILE)
+#define BOOT_EEPROM			0	// EEPROM settings applied
+#define BOOT_PINS			1	// Relay and input pins set
+#define BOOT_NETWORK			2	// Main loop entered
+#define BOOT_SENSORS			3	// Sensor discovery done
+#define BOOT_STAGES			4
+#define FAST_BOOT_DEFER			250	// Main loop ms before sensor init
+
 // MQTT Auto Discovery States
 #define DEFINE_INPUTS			0
 #define DEFINE_OUTPUTS			1
@@ -265,6 +324,13 @@
 #define DEFINE_TEMP_SENSORS		3
 #define AUTO_COMPLETE			4
 
+// MQTT Auto Discovery placeholder message sizes
+// Largest placeholder PUBLISH (fixed header, topic and placeholder payload)
+// queued by send_IOT_msg() for a pin and for a sensor. Used by the
+// MQTT_DISCOVERY_BURST check for room in the mqtt_sendbuf.
+#define AUTO_PIN_MSG_SIZE		58
+#define AUTO_SENSOR_MSG_SIZE		71
+
 // MQTT Auto Discovery Sub-States
 #define STEP_NULL			0
 #define SEND_INPUT_DELETE		1
@@ -288,6 +354,74 @@
 #define STATE_REQUEST_RCVD		1
 #define STATE_REQUEST_RCVD24		2
 
+// MQTT pin state PUBLISH size
+// Largest pin state PUBLISH packet (fixed header, topic and payload). Used
+// by publish_outbound() to check for room in the mqtt_sendbuf. A QOS 1
+// PUBLISH is 2 bytes larger for the packet id.
+#if HOME_ASSISTANT_SUPPORT == 1 && MQTT_QOS1_PINSTATE == 0
+#define PUBLISH_PINSTATE_SIZE		52
+#endif // HOME_ASSISTANT_SUPPORT == 1 && MQTT_QOS1_PINSTATE == 0
+#if HOME_ASSISTANT_SUPPORT == 1 && MQTT_QOS1_PINSTATE == 1
+#define PUBLISH_PINSTATE_SIZE		54
+#endif // HOME_ASSISTANT_SUPPORT == 1 && MQTT_QOS1_PINSTATE == 1
+#if DOMOTICZ_SUPPORT == 1 && MQTT_QOS1_PINSTATE == 0
+#define PUBLISH_PINSTATE_SIZE		68
+#endif // DOMOTICZ_SUPPORT == 1 && MQTT_QOS1_PINSTATE == 0
+#if DOMOTICZ_SUPPORT == 1 && MQTT_QOS1_PINSTATE == 1
+#define PUBLISH_PINSTATE_SIZE		70
+#endif // DOMOTICZ_SUPPORT == 1 && MQTT_QOS1_PINSTATE == 1
+
+// Topic and application message buffer sizes of a pin state PUBLISH
+#if HOME_ASSISTANT_SUPPORT == 1
+#define PINSTATE_TOPIC_SIZE		55
+#define PINSTATE_MESSAGE_SIZE		4
+#endif // HOME_ASSISTANT_SUPPORT == 1
+#if DOMOTICZ_SUPPORT == 1
+#define PINSTATE_TOPIC_SIZE		12
+#define PINSTATE_MESSAGE_SIZE		60
+#endif // DOMOTICZ_SUPPORT == 1
+
+// MQTT direct publish queue
+// Number of pin state PUBLISH messages that can wait to be packed into the
+// uip_buf by direct_publish_send() (MQTT_DIRECT_PUBLISH).
+#define DIRECT_PUBLISH_SIZE		8
+
+struct direct_publish {
+  uint8_t direction;                  // 'I' = input, 'O' = output
+  uint8_t pin;                        // Pin number 1 to 24
+  uint8_t on;                         // 1 = ON, 0 = OFF
+};
+
+// Check used by publish_outbound() to stop publishing pin states when
+// there is no room for another pin state PUBLISH
+#if MQTT_DIRECT_PUBLISH == 0
+#define PINSTATE_QUEUE_FULL()	(mqttclient.mq.curr_sz < PUBLISH_PINSTATE_SIZE)
+#endif // MQTT_DIRECT_PUBLISH == 0
+#if MQTT_DIRECT_PUBLISH == 1
+#define PINSTATE_QUEUE_FULL()	(direct_publish_count >= DIRECT_PUBLISH_SIZE)
+#endif // MQTT_DIRECT_PUBLISH == 1
+
+// MQTT pin state PUBLISH flags
+#if MQTT_QOS1_PINSTATE == 0
+#define PINSTATE_PUBLISH_FLAGS		(MQTT_PUBLISH_QOS_0 | MQTT_PUBLISH_RETAIN)
+#endif // MQTT_QOS1_PINSTATE == 0
+#if MQTT_QOS1_PINSTATE == 1
+#define PINSTATE_PUBLISH_FLAGS		(MQTT_PUBLISH_QOS_1 | MQTT_PUBLISH_RETAIN)
+
+// MQTT QOS 1 pin state pending table
+// Number of pin state PUBLISH messages that can await a PUBACK, and the
+// number of seconds before an unacknowledged pin state is published again.
+#define PINSTATE_PENDING_SIZE		8
+#define PINSTATE_ACK_TIMEOUT		5
+
+struct pinstate_pending {
+  uint16_t packet_id;                 // Packet id of the PUBLISH
+  uint8_t pin;                        // Pin number 1 to 24, 0 = entry free
+  uint8_t time_sent;                  // Low byte of second_counter when
+                                      // the PUBLISH was queued
+};
+#endif // MQTT_QOS1_PINSTATE == 1
+
 // Restart State Machine Controls
 #define RESTART_REBOOT_IDLE		0
 #define RESTART_REBOOT_ARM		1
@@ -303,12 +437,39 @@
 #define UPDATE_OPTIONS1			2
 #define UPDATE_OPTIONS2			3
 
+// Benchmark results (BENCHMARK_SUPPORT). Each result is the total time in
+// us for the work described.
+#define BENCH_SPI_WRITE			0 // Write 1KB to the ENC28J60
+#define BENCH_SPI_READ			1 // Read 1KB from the ENC28J60
+#define BENCH_CHKSUM			2 // 100 x uip_chksum() over 500 bytes
+#define BENCH_ITOA			3 // 1000 x emb_itoa() of 6 digits
+#define BENCH_RENDER			4 // CopyHttpData() of the IOControl page
+#define BENCH_I2C_READ			5 // Read 256 bytes from the I2C EEPROM
+#define BENCH_DS18B20			6 // Read all DS18B20 and start conversion
+#define BENCH_NUM			7
+
 
 int main(void);
 void periodic_service(void);
+void periodic_conn(int i);
+void poll_conn_now(struct uip_conn *conn);
+void task_mqtt_timer(void);
+void task_100ms(void);
+void command_rate_tick(void);
+void mqtt_command_complete(void);
+void link_check(void);
+void task_arp(void);
+void task_DS18B20(void);
+void task_DS18B20_step(void);
+void task_BME280(void);
+uint8_t DS18B20_changed(void);
+uint8_t BME280_changed(void);
+void task_login(void);
+void task_runtime(void);
 void init_IWDG(void);
 void unlock_eeprom(void);
 void lock_eeprom(void);
+void commit_stored_pin_control(uint16_t dirty);
 void update_settings_options(uint8_t select, uint8_t value);
 void unlock_flash(void);
 void lock_flash(void);
@@ -321,9 +482,14 @@ uint8_t is_allowed_char(uint8_t character);
 uint8_t is_digit(uint8_t character);
 void update_mac_string(void);
 void check_runtime_changes(void);
+void stack_scan(void);
+uint32_t bench_us(uint32_t start);
+void bench_run(void);
 uint8_t chk_iotype(uint8_t pin_byte, int pin_index, uint8_t chk_mask);
 void read_input_pins(uint8_t init_flag);
 void encode_bit_registers(uint8_t sort_init);
+void encode_port_masks(void);
+void read_port_idr(void);
 void write_output_pins(void);
 void check_reset_button(void);
 void check_restart_reboot(void);
@@ -334,6 +500,20 @@ void fastflash(void);
 void debugflash(void);
 void restore_eeprom_debug_bytes(void);
 void update_debug_storage1(void);
+#if UDP_LOG_SUPPORT == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+void udp_log(uint8_t code, uint16_t value);
+void udp_log_flush(void);
+#define UDP_LOG(code, value) udp_log(code, value)
+#else
+#define UDP_LOG(code, value)
+#endif // UDP_LOG_SUPPORT == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+void sensor_init(void);
+#if BOOT_PROFILE == 1
+void boot_mark(uint8_t stage);
+#define BOOT_MARK(stage) boot_mark(stage)
+#else
+#define BOOT_MARK(stage)
+#endif // BOOT_PROFILE == 1
 void check_rst_sr(void);
 uint8_t off_board_EEPROM_detect(void);
 
@@ -347,14 +527,25 @@ void copy_code_uploader_to_EEPROM_R1(void);
 
 uint32_t calculate_timer(uint16_t timer_value);
 void decrement_pin_timers(void);
+void pin_timer_set(uint8_t pin, uint16_t value);
+void pin_timer_tick(uint8_t level);
 
 void mqtt_startup(void);
 void define_temp_sensors(void);
 void define_BME280_sensors(void);
 void send_IOT_msg(uint8_t IOT_ptr, uint8_t IOT, uint8_t DefOrDel);
+void calc_discovery_fingerprint(void);
 void mqtt_sanity_check(struct mqtt_client *client);
+void mqtt_reconnect_backoff(void);
+char *topic_prefix_copy(unsigned char *topic);
 void publish_callback(void** unused, struct mqtt_response_publish *published);
 void publish_outbound(void);
+void pinstate_track(uint8_t pin);
+void pinstate_puback(uint16_t packet_id);
+void pinstate_check_pending(void);
+int pinstate_message(unsigned char *topic_base, unsigned char *app_message, uint8_t direction, uint8_t pin, uint8_t on);
+void direct_publish_queue(uint8_t direction, uint8_t pin, uint8_t on);
+void direct_publish_send(struct mqtt_client *client);
 
 #if PCF8574_SUPPORT == 0 && DOMOTICZ_SUPPORT == 0
 void publish_pinstate(uint8_t direction, uint8_t pin, uint16_t value, uint16_t mask);
@@ -365,7 +556,11 @@ void publish_pinstate(uint8_t direction, uint8_t pin, uint32_t value, uint32_t m
 
 void publish_pinstate_all(uint8_t type);
 void publish_temperature(uint8_t sensor);
+void publish_profile(uint8_t stage);
+void publish_pagestats(uint8_t slot);
+void publish_stack(void);
 void publish_BME280(int8_t sensor);
+uint8_t publish_bulk_state(void);
 
 int8_t reverse_bit_order(uint8_t k);
 
@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+#
+# Builds the POST data for a provisioning POST
+#
+# The provisioning POST sets the whole Configuration of a Network Module in
+# one request. The configuration blob is built from the command line
+# options, split into 8 records of 16 bytes and followed by the CRC record.
+# The output can be sent with any HTTP client, for instance:
+#   python3 mkprovision.py --ip 192.168.1.4 --name Relay4 > post.txt
+#   curl --data-binary @post.txt http://192.168.1.4/
+#
+# Options that are not given are set to the Network Module defaults. See
+# PROVISION_SUPPORT in uipopt.h and provision_apply() in httpd.c for the
+# blob layout.
+#
+# With --sx-crc the script instead prints the CRC of the S3 data bytes of a
+# firmware .sx file. A BACKGROUND_UPLOAD POST carries it in the URL and the
+# Network Module only stages the image if its own CRC matches:
+#   curl -H 'Expect:' -F file1=@NetworkModule.sx \
+#     http://192.168.1.4/86?$(python3 mkprovision.py --sx-crc NetworkModule.sx)
+
+import argparse
+import struct
+import sys
+
+PROVISION_VERSION = 1
+PROVISION_RECORDS = 8
+
+
+def crc16(data):
+    # CRC-16 CCITT, initial value 0xffff
+    crc = 0xffff
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            if crc & 0x8000:
+                crc = ((crc << 1) ^ 0x1021) & 0xffff
+            else:
+                crc = (crc << 1) & 0xffff
+    return crc
+
+
+def sx_crc(path):
+    # CRC of the S3 record data bytes in file order, as computed by the
+    # Network Module while it parses a /86 POST. The address, count and
+    # checksum bytes are not included.
+    data = b''
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if line.startswith('S3'):
+                record = bytes.fromhex(line[2:])
+                data += record[5:-1]
+    return crc16(data)
+
+
+def ip(text):
+    return bytes(int(x) for x in text.split('.'))
+
+
+def mac(text):
+    return bytes.fromhex(text.replace(':', '').replace('-', ''))
+
+
+def string(text, size):
+    data = text.encode('latin1')
+    if len(data) > size - 1:
+        raise SystemExit('"%s" is longer than %d characters' % (text, size - 1))
+    return data.ljust(size, b'\0')
+
+
+def main():
+    p = argparse.ArgumentParser(description='Build a provisioning POST')
+    p.add_argument('--ip', default='192.168.1.4')
+    p.add_argument('--gateway', default='192.168.1.1')
+    p.add_argument('--netmask', default='255.255.255.0')
+    p.add_argument('--port', type=int, default=80)
+    p.add_argument('--mac', default='c2:4d:69:6b:65:00')
+    p.add_argument('--name', default='NewDevice000')
+    p.add_argument('--config', default='00', help='Config settings byte in hex')
+    p.add_argument('--mqtt-ip', default='0.0.0.0')
+    p.add_argument('--mqtt-port', type=int, default=1883)
+    p.add_argument('--mqtt-user', default='')
+    p.add_argument('--mqtt-password', default='')
+    p.add_argument('--pins', default='00' * 16,
+                   help='pin_control bytes for IO1 to IO16 as 32 hex characters')
+    p.add_argument('--timers', default='0000' * 16,
+                   help='IO_TIMER values for IO1 to IO16 as 64 hex characters')
+    p.add_argument('--sx-crc', metavar='FILE',
+                   help='Print the /86 upload CRC of a firmware .sx file and exit')
+    a = p.parse_args()
+
+    if a.sx_crc:
+        sys.stdout.write('%04x\n' % sx_crc(a.sx_crc))
+        return
+
+    blob = bytes([PROVISION_VERSION])
+    blob += ip(a.ip) + ip(a.gateway) + ip(a.netmask)
+    blob += struct.pack('>H', a.port)
+    blob += mac(a.mac)
+    blob += string(a.name, 20)
+    blob += bytes.fromhex(a.config)
+    blob += ip(a.mqtt_ip)
+    blob += struct.pack('>H', a.mqtt_port)
+    blob += string(a.mqtt_user, 11)
+    blob += string(a.mqtt_password, 11)
+    blob += bytes.fromhex(a.pins)
+    blob += bytes.fromhex(a.timers)
+    if len(blob) != 118:
+        raise SystemExit('Bad --mac, --config, --pins or --timers length')
+    blob = blob.ljust(PROVISION_RECORDS * 16, b'\0')
+
+    fields = []
+    for i in range(PROVISION_RECORDS):
+        fields.append('x%02d=%s' % (i, blob[i * 16:(i + 1) * 16].hex()))
+    fields.append('x99=%04x' % crc16(blob))
+    fields.append('z00=0')
+    sys.stdout.write('&'.join(fields))
+
+
+if __name__ == '__main__':
+    main()
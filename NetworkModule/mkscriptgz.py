@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+#
+# Generates httpd_script_gz.h from the webpage templates in httpd.c
+#
+# The page scripts in the IOControl and Configuration templates (the text
+# between the %S0x and %S99 markers) contain no markers, so they can be
+# sent pre-compressed. This script extracts each page script from httpd.c,
+# prefixes it with the "var s=" that the /9c to /9f resources start with,
+# compresses it with gzip and writes it to httpd_script_gz.h as a byte array.
+# Each array is wrapped in the same #if conditions as the template it came
+# from.
+#
+# Run from the NetworkModule directory after any change to a page script:
+#   python3 mkscriptgz.py
+#
+# See HTTPD_SCRIPT_GZIP in uipopt.h.
+
+import re
+import struct
+import zlib
+
+SOURCE = 'httpd.c'
+OUTPUT = 'httpd_script_gz.h'
+
+# Template name to array name
+ARRAYS = {
+    'g_HtmlPageIOControl':        'g_ScriptGzIOControl',
+    'g_HtmlPageConfiguration':    'g_ScriptGzConfiguration',
+    'g_HtmlPagePCFIOControl':     'g_ScriptGzPCFIOControl',
+    'g_HtmlPagePCFConfiguration': 'g_ScriptGzPCFConfiguration',
+}
+
+
+def c_string(literal):
+    # Decode the C escapes used in the templates
+    return bytes(literal, 'latin1').decode('unicode_escape').encode('latin1')
+
+
+def gzip_bytes(data):
+    # gzip member with a fixed header (no name, no time stamp) so the output
+    # only changes when the script changes
+    comp = zlib.compressobj(9, zlib.DEFLATED, -15, 9)
+    body = comp.compress(data) + comp.flush()
+    header = bytes([0x1f, 0x8b, 0x08, 0x00, 0, 0, 0, 0, 0x02, 0xff])
+    trailer = struct.pack('<II', zlib.crc32(data) & 0xffffffff, len(data) & 0xffffffff)
+    return header + body + trailer
+
+
+def find_scripts(lines):
+    # Returns (conditions, template name, script) for each template with a
+    # page script. conditions is the list of #if lines open at the template.
+    stack = []
+    scripts = []
+    i = 0
+    while i < len(lines):
+        line = lines[i].strip()
+        if line.startswith('#if'):
+            stack.append(line)
+        elif line.startswith('#else') or line.startswith('#elif'):
+            stack[-1] = None
+        elif line.startswith('#endif'):
+            stack.pop()
+        m = re.match(r'static const char (g_\w+)\[\] =$', line)
+        if m and m.group(1) in ARRAYS:
+            name = m.group(1)
+            conditions = list(stack)
+            text = b''
+            i += 1
+            # Collect the string literals up to the end of the template. The
+            # script text is only compiled when it is not sent compressed, so
+            # preprocessor lines inside the template are skipped.
+            while True:
+                line = lines[i].strip()
+                if not line.startswith('#'):
+                    for literal in re.findall(r'"((?:[^"\\]|\\.)*)"', line):
+                        text += c_string(literal)
+                if line.endswith(';'):
+                    break
+                i += 1
+            start = text.find(b'%S0')
+            if start >= 0:
+                if None in conditions:
+                    raise SystemExit('%s: page script inside an #else' % name)
+                end = text.find(b'%S99', start)
+                scripts.append((conditions, name, b'var s=' + text[start + 4:end]))
+        i += 1
+    return scripts
+
+
+def main():
+    with open(SOURCE, 'rb') as f:
+        lines = f.read().decode('latin1').replace('\r\n', '\n').split('\n')
+
+    out = []
+    out.append('/*')
+    out.append(' * Pre-compressed page scripts')
+    out.append(' *')
+    out.append(' * Generated by mkscriptgz.py from the webpage templates in httpd.c.')
+    out.append(' * Do not edit. Run mkscriptgz.py after any change to a page script.')
+    out.append(' */')
+    out.append('')
+    out.append('#if HTTPD_SCRIPT_GZIP == 1 && HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0')
+    for conditions, name, script in find_scripts(lines):
+        data = gzip_bytes(script)
+        out.append('')
+        for condition in conditions:
+            out.append(condition)
+        out.append('// %s: %d bytes compressed to %d' % (name, len(script), len(data)))
+        out.append('static const unsigned char %s[] = {' % ARRAYS[name])
+        for j in range(0, len(data), 16):
+            out.append('  ' + ','.join('0x%02x' % b for b in data[j:j + 16]) + ',')
+        out.append('};')
+        for condition in reversed(conditions):
+            out.append('#endif // ' + condition[4:])
+    out.append('#endif // HTTPD_SCRIPT_GZIP == 1 && HTTPD_SCRIPT_CACHE == 1 && OB_EEPROM_SUPPORT == 0')
+    out.append('')
+
+    with open(OUTPUT, 'wb') as f:
+        f.write('\r\n'.join(out).encode('latin1'))
+
+
+if __name__ == '__main__':
+    main()
@@ -56,9 +56,18 @@ uint8_t connack_received;         // Used to communicate CONNECT CONNACK
                                   // received from mqtt.c to main.c
 uint8_t suback_received;          // Used to communicate SUBSCRIBE SUBACK
                                   // received from mqtt.c to main.c
+#if MQTT_PERSISTENT_SESSION == 1
+uint8_t connack_session_present;  // Used to communicate the CONNACK Session
+                                  // Present flag from mqtt.c to main.c
+#endif // MQTT_PERSISTENT_SESSION == 1
 
 uint8_t mqtt_sendbuf[MQTT_SENDBUF_SIZE]; // Buffer to contain MQTT transmit
                                          // queue and data.
+#if MQTT_BATCH_PUBLISH == 1
+uint8_t mq_append_open;           // Indicates the message at the queue tail
+                                  // was built by mqtt_publish_append() and
+				  // more PUBLISH packets may be added to it.
+#endif // MQTT_BATCH_PUBLISH == 1
 extern uint8_t mqtt_start;        // Tracks the MQTT startup steps
 
 extern uint8_t OctetArray[14];    // Used in emb_itoa conversions and to
@@ -103,6 +112,9 @@ uint8_t mqtt_partial_buffer_length;	// Trackes the length of data in the
 uint8_t pbi;				// Partial Buffer Index - provides an
 					// index for writing and reading the
 					// MQTT partial buffer
+uint8_t mqtt_send_hold;			// Prevents mqtt_send() from writing
+					// to the uip_buf while mqtt_sync() is
+					// reading received messages from it
 
 
 
@@ -213,62 +225,82 @@ int16_t mqtt_sync(struct mqtt_client *client)
       // messages are less than 60 bytes in length (at least for the Home
       // Assistant environment).
       
-      // Capture a byte from the uip_buf
-      uip_buf[MQTT_PBUF + pbi++] = *msgBuffer;
-      mqtt_partial_buffer_length++;
-      msgBuffer++;
-      total_msg_length--;
-      
-      if (mqtt_partial_buffer_length == 2) {
-        // If mqtt_partial_buffer_length == 2 a new current_msg_length
-        // (Remaining Length) is in the second byte.
-        current_msg_length = uip_buf[MQTT_PBUF + 1];
+      if (mqtt_partial_buffer_length == 0
+       && total_msg_length >= 2
+       && (uint8_t)msgBuffer[1] < 0x80
+       && (uint16_t)((uint8_t)msgBuffer[1] + 2) <= total_msg_length) {
+        // The whole message is in this packet. It is parsed where it is
+        // in the uip_buf instead of being copied to the MQTT Partial
+        // Buffer one byte at a time. Only a message that is split
+        // between packets is collected in the MQTT Partial Buffer.
+        uint8_t nBytes;
+        nBytes = (uint8_t)((uint8_t)msgBuffer[1] + 2);
+        err = mqtt_recv(client, (uint8_t *)msgBuffer, nBytes);
+        msgBuffer += nBytes;
+        total_msg_length -= nBytes;
       }
+      else {
+        // Capture a byte from the uip_buf
+        uip_buf[MQTT_PBUF + pbi++] = *msgBuffer;
+        mqtt_partial_buffer_length++;
+        msgBuffer++;
+        total_msg_length--;
       
-      if (mqtt_partial_buffer_length > 2) {
-        // If mqtt_partial_buffer_length > 2 then the Control Byte and
-        // Remaining Length Byte have both been captured and we must 
-        // decrement the current_msg_length with each additional byte read.
-        current_msg_length--;
-      }
+        if (mqtt_partial_buffer_length == 2) {
+          // If mqtt_partial_buffer_length == 2 a new current_msg_length
+          // (Remaining Length) is in the second byte.
+          current_msg_length = uip_buf[MQTT_PBUF + 1];
+        }
       
-      if (mqtt_partial_buffer_length == 1) {
-        if (total_msg_length == 0) {
-          // Hit end of packet at first byte of new message. Leave _mqtt_sync
-          // to collect another packet.
-          return MQTT_OK;
+        if (mqtt_partial_buffer_length > 2) {
+          // If mqtt_partial_buffer_length > 2 then the Control Byte and
+          // Remaining Length Byte have both been captured and we must 
+          // decrement the current_msg_length with each additional byte read.
+          current_msg_length--;
         }
-        // If not at the end of the packet continue to loop to collect one
-        // byte (the Remaining Length) before further decisions.
-        continue;
-      }
       
-      if (current_msg_length == 0) {
+        if (mqtt_partial_buffer_length == 1) {
+          if (total_msg_length == 0) {
+            // Hit end of packet at first byte of new message. Leave _mqtt_sync
+            // to collect another packet.
+            return MQTT_OK;
+          }
+          // If not at the end of the packet continue to loop to collect one
+          // byte (the Remaining Length) before further decisions.
+          continue;
+        }
+      
+        if (current_msg_length != 0) continue;
         // Captured a complete message. Call mqtt_recv() then clear the
         // MQTT Partial Buffer handling variables in case there are more
         // MQTT messages in the uip_buf after this message.
-        err = mqtt_recv(client);
+        err = mqtt_recv(client, &uip_buf[MQTT_PBUF], mqtt_partial_buffer_length);
         mqtt_partial_buffer_length = 0;
         pbi = 0;
-        if (err != MQTT_OK) {
-          return err;
-        }
-        
-        // Call send
-        // If we run mqtt_recv() we need to follow that with a call to
-        // matt_send() so that each processed MQTT message finishes its
-        // recv/send process (mostly making sure the message state is updated
-        // correctly).
-        // mqtt_send() shouldn't actually transmit anything via the uip_buf
-        // at this point. It should only update the msg->state of messages
-        // as needed.
-        err = mqtt_send(client);
-        // Set global MQTT error flag so GUI can show status
-        if (err == MQTT_OK) MQTT_error_status = 1;
-        else MQTT_error_status = 0;
-        if (err != MQTT_OK) {
-          return err;
-        }
+      }
+
+      if (err != MQTT_OK) {
+        return err;
+      }
+      
+      // Call send
+      // If we run mqtt_recv() we need to follow that with a call to
+      // matt_send() so that each processed MQTT message finishes its
+      // recv/send process (mostly making sure the message state is updated
+      // correctly).
+      // mqtt_send() must not transmit anything via the uip_buf at this
+      // point as the rest of the received TCP packet may still be in it.
+      // mqtt_send_hold stops mqtt_send() from copying queued messages to
+      // the uip_buf. They are sent by the mqtt_send() call at the end of
+      // mqtt_sync().
+      mqtt_send_hold = 1;
+      err = mqtt_send(client);
+      mqtt_send_hold = 0;
+      // Set global MQTT error flag so GUI can show status
+      if (err == MQTT_OK) MQTT_error_status = 1;
+      else MQTT_error_status = 0;
+      if (err != MQTT_OK) {
+        return err;
       }
       
       // At this point if total_msg_length == 0 then the MQTT message just
@@ -874,7 +906,7 @@ UARTPrintf("\r\n");
 #endif // DEBUG_SUPPORT == 15
 */
 	
-        err = mqtt_recv(client);
+        err = mqtt_recv(client, &uip_buf[MQTT_PBUF], mqtt_partial_buffer_length);
         mqtt_partial_buffer_length = 0;
         pbi = 0;
 	remaining_length_captured_flag = 0;
@@ -887,10 +919,14 @@ UARTPrintf("\r\n");
         // mqtt_send() so that each processed MQTT message finishes its
         // recv/send process (mostly making sure the message state is updated
         // correctly).
-        // mqtt_send() shouldn't actually transmit anything via the uip_buf
-        // at this point. It should only update the msg->state of messages
-        // as needed.
+        // mqtt_send() must not transmit anything via the uip_buf at this
+        // point as the rest of the received TCP packet may still be in it.
+        // mqtt_send_hold stops mqtt_send() from copying queued messages to
+        // the uip_buf. They are sent by the mqtt_send() call at the end of
+        // mqtt_sync().
+        mqtt_send_hold = 1;
         err = mqtt_send(client);
+        mqtt_send_hold = 0;
         // Set global MQTT error flag so GUI can show status
         if (err == MQTT_OK) MQTT_error_status = 1;
         else MQTT_error_status = 0;
@@ -932,7 +968,7 @@ uint16_t mqtt_check_sendbuf(struct mqtt_client *client)
     // remaining size of the mqtt_sendbuf (the free space remaining in the
     // buffer).
     uint16_t rv;
-    if (!(client->mq.curr_sz > (MQTT_SENDBUF_SIZE - 15))) mqtt_mq_clean(&client->mq); 
+    if (!(client->mq.curr_sz > (MQTT_MQ_DATA_SIZE - 1))) mqtt_mq_clean(&client->mq); 
     rv = client->mq.curr_sz;
     return rv;
 }
@@ -948,15 +984,15 @@ uint16_t mqtt_next_pid(struct mqtt_client *client)
     //   https://en.wikipedia.org/wiki/Linear-feedback_shift_register
     
     do {
-        struct mqtt_queued_message *curr;
+        uint8_t i;
         unsigned lsb = client->pid_lfsr & 1;
         (client->pid_lfsr) >>= 1;
         if (lsb) client->pid_lfsr ^= 0xB400u;
 
         // check that the PID is unique
         pid_exists = 0;
-        for(curr = mqtt_mq_get(&(client->mq), 0); curr >= client->mq.queue_tail; --curr) {
-            if (curr->packet_id == client->pid_lfsr) {
+        for(i = 0; i < mqtt_mq_length(&(client->mq)); i++) {
+            if (mqtt_mq_get(&(client->mq), i)->packet_id == client->pid_lfsr) {
                 pid_exists = 1;
                 break;
             }
@@ -1047,6 +1083,8 @@ int16_t mqtt_connect(struct mqtt_client *client,
       client->error = rv;
       return rv;
     }
+    // The message didn't fit in the mqtt_sendbuf. It is not queued.
+    if (rv == 0) return MQTT_ERROR_SEND_BUFFER_IS_FULL;
     msg = mqtt_mq_register(&client->mq, rv);
     
     // save the control type of the message
@@ -1085,6 +1123,8 @@ int16_t mqtt_publish(struct mqtt_client *client,
       client->error = rv;
       return rv;
     }
+    // The message didn't fit in the mqtt_sendbuf. It is not queued.
+    if (rv == 0) return MQTT_ERROR_SEND_BUFFER_IS_FULL;
     msg = mqtt_mq_register(&client->mq, rv);
     
     // save the control type and packet id of the message
@@ -1095,6 +1135,65 @@ int16_t mqtt_publish(struct mqtt_client *client,
 }
 
 
+#if MQTT_BATCH_PUBLISH == 1
+int16_t mqtt_publish_append(struct mqtt_client *client,
+                            const char* topic_name,
+                            const void* application_message,
+                            uint16_t application_message_size,
+                            uint8_t publish_flags)
+{
+    struct mqtt_message_queue *mq;
+    int16_t rv;
+    uint16_t packet_id;
+
+    if (client->error < 0) {
+        return client->error;
+    }
+    mq = &client->mq;
+    mqtt_mq_clean(mq);
+
+    // The message at the queue tail can only be extended if it was built
+    // here and is still waiting in the queue. mqtt_mq_clean() never removes
+    // an unsent message, and any other registration clears mq_append_open.
+    if (mq_append_open && mqtt_mq_length(mq) > 0
+     && mq->queue_tail->state == MQTT_QUEUED_UNSENT
+     && mq->curr == mq->queue_tail->start + mq->queue_tail->size) {
+        // The packet id is not packed for QOS 0 so a new one isn't needed.
+        // A QOS 1 PUBLISH gets its own packet id for its PUBACK.
+        if (publish_flags & MQTT_PUBLISH_QOS_MASK) packet_id = mqtt_next_pid(client);
+        else packet_id = mq->queue_tail->packet_id;
+        rv = mqtt_pack_publish_request(
+                mq->curr, mq->curr_sz,
+                topic_name,
+                packet_id,
+                application_message,
+                application_message_size,
+                publish_flags
+                );
+        if (rv < 0) {
+          client->error = rv;
+          return rv;
+        }
+        if (rv > 0) {
+            // Grow the queued message to include the new PUBLISH packet
+            mq->queue_tail->size += rv;
+            mq->curr_sz = mqtt_mq_currsz(mq);
+            return MQTT_OK;
+        }
+        // else no room in the queued message. Start a new one.
+    }
+
+    rv = mqtt_publish(client,
+                      topic_name,
+                      application_message,
+                      application_message_size,
+                      publish_flags);
+    if (rv == MQTT_OK) mq_append_open = 1;
+    return rv;
+}
+#endif // MQTT_BATCH_PUBLISH == 1
+
+
 int16_t mqtt_subscribe(struct mqtt_client *client,
                        const char* topic_name,
 		       int max_qos_level)
@@ -1120,6 +1219,8 @@ int16_t mqtt_subscribe(struct mqtt_client *client,
       client->error = rv;
       return rv;
     }
+    // The message didn't fit in the mqtt_sendbuf. It is not queued.
+    if (rv == 0) return MQTT_ERROR_SEND_BUFFER_IS_FULL;
     msg = mqtt_mq_register(&client->mq, rv);
     
     // save the control type and packet id of the message
@@ -1147,6 +1248,8 @@ int16_t mqtt_ping(struct mqtt_client *client)
       client->error = rv;
       return rv;
     }
+    // The message didn't fit in the mqtt_sendbuf. It is not queued.
+    if (rv == 0) return MQTT_ERROR_SEND_BUFFER_IS_FULL;
     msg = mqtt_mq_register(&client->mq, rv);
     
     // save the control type and packet id of the message
@@ -1174,6 +1277,8 @@ int16_t mqtt_disconnect(struct mqtt_client *client)
       client->error = rv;
       return rv;
     }
+    // The message didn't fit in the mqtt_sendbuf. It is not queued.
+    if (rv == 0) return MQTT_ERROR_SEND_BUFFER_IS_FULL;
     msg = mqtt_mq_register(&client->mq, rv);
     
     // save the control type and packet id of the message
@@ -1188,11 +1293,12 @@ int16_t mqtt_send(struct mqtt_client *client)
     // Function to manage transfer of messages from the mqtt_sendbuf to the
     // uip_buf so that they will be transmitted on the ethernet.
     // This application must use the uip_buf for all outbound traffic, and the
-    // uip_buf is only serviced via calls in the main loop. Thus only one
-    // message at a time can be serviced by calls to mqtt_pall_sendall().
-    // As a result the loop below will terminate with a break if a message is
-    // transferred from the mqtt_sendbuf to the uip_buf. The code will be
-    // called again later to pick up the next message in the queue.
+    // uip_buf is only serviced via calls in the main loop. Each call to
+    // mqtt_pal_sendall() appends one message to the data already in the
+    // uip_buf, so the loop below copies as many queued messages as fit in
+    // one TCP segment. When a message doesn't fit mqtt_pal_sendall()
+    // returns 0 and the loop terminates. The code will be called again
+    // later (after the segment is ACKed) to pick up the rest of the queue.
     
     int16_t len;
     int16_t i = 0;
@@ -1204,15 +1310,16 @@ int16_t mqtt_send(struct mqtt_client *client)
     // Find the next unsent message in the queue. mqtt_mq_length returns the
     // number of messages in the message queue.
     len = mqtt_mq_length(&client->mq);
+    // While mqtt_sync() is still reading received messages from the uip_buf
+    // no messages are sent.
+    if (mqtt_send_hold) len = 0;
 
     for(; i < len; ++i) {
-      // Even though only one message can be sent each time this function
-      // is entered a for() loop is required in case a previously sent
-      // message is in state MQTT_QUEUED_AWAITING_ACK. This allows other
-      // messages in the queue to be sent even if one is still awaiting
-      // an ACK. Due to application timing this should never happen. Also
-      // note that a message could be resent if it times out in the queue.
-      // This should also never happen.
+      // Every unsent message is copied to the uip_buf until the TCP segment
+      // is full. Messages in state MQTT_QUEUED_AWAITING_ACK are skipped,
+      // which allows other messages in the queue to be sent even if one is
+      // still awaiting an ACK. Also note that a message could be resent if
+      // it times out in the queue. This should never happen.
       struct mqtt_queued_message *msg = mqtt_mq_get(&client->mq, i);
       int16_t resend = 0;
       if (msg->state == MQTT_QUEUED_UNSENT) {
@@ -1254,10 +1361,11 @@ int16_t mqtt_send(struct mqtt_client *client)
 	else {
           client->send_offset += tmp;
           if(client->send_offset < msg->size) {
-            // partial sent. Await additional calls
-	    // A PARTIAL SHOULD NEVER OCCUR AS ALL MQTT MESSAGES ARE SHORT
-	    // ENOUGH IN THIS APPLICATION THAT THEY WILL BE SENT IN ONE PASS.
-	    // THIS CODE COULD BE SIMPLIFIED.
+            // Not sent. mqtt_pal_sendall() returns 0 if the message does
+	    // not fit in the space left in the uip_buf. It is sent on the
+	    // next call when the uip_buf is empty. A partial send never
+	    // occurs as all MQTT messages are short enough in this
+	    // application to be sent in one pass.
             break;
           }
 	  else {
@@ -1292,7 +1400,9 @@ int16_t mqtt_send(struct mqtt_client *client)
         msg->state = MQTT_QUEUED_COMPLETE;
         break;
       case MQTT_CONTROL_PUBLISH:
-	// This application only sends messages at QOS 0
+	// PUBLISH messages are complete once sent. QOS 1 pin state messages
+	// are tracked by packet id in the application pending table (see
+	// pinstate_track()) rather than held in the mqtt_sendbuf.
 	msg->state = MQTT_QUEUED_COMPLETE;
         break;
       case MQTT_CONTROL_CONNECT:
@@ -1304,14 +1414,20 @@ int16_t mqtt_send(struct mqtt_client *client)
           client->error = MQTT_ERROR_MALFORMED_REQUEST;
           return MQTT_ERROR_MALFORMED_REQUEST;
       }
-      // Need to break here - we sent one message (we can only send one
-      // message each time this function is called).
-      break;
+      // Continue with the next message in the queue. It is appended to
+      // the same TCP segment if there is room.
     }
 
+#if BUILD_SUPPORT == MQTT_BUILD && MQTT_DIRECT_PUBLISH == 1
+    // Pin state PUBLISH messages are packed straight into the uip_buf after
+    // the queued messages.
+    if (mqtt_send_hold == 0) direct_publish_send(client);
+#endif // BUILD_SUPPORT == MQTT_BUILD && MQTT_DIRECT_PUBLISH == 1
+
     // check for keep-alive
     {
-      // At about 3/4 of the timeout period perform a ping. This calculation
+      // At about 3/4 of the timeout period (or at the full timeout period if
+      // MQTT_PING_DEFER is enabled) perform a ping. This calculation
       // uses integer arithmetic so it is only an approximation. It is
       // assumed that timeouts are not a small number (for instance, the
       // timeout should be at least 15 seconds).
@@ -1323,11 +1439,19 @@ int16_t mqtt_send(struct mqtt_client *client)
       uint32_t keep_alive_timeout;
       int16_t rv;
       
+#if MQTT_PING_DEFER == 0
       keep_alive_timeout = client->time_of_last_send + (uint32_t)((client->keep_alive * 3) / 4);
+#endif // MQTT_PING_DEFER == 0
+#if MQTT_PING_DEFER == 1
+      // The Broker allows 1.5 times the keep alive so the ping can wait
+      // for the full keep alive time without risking a disconnect.
+      keep_alive_timeout = client->time_of_last_send + (uint32_t)client->keep_alive;
+#endif // MQTT_PING_DEFER == 1
       
       if ((second_counter > keep_alive_timeout) && (mqtt_start == MQTT_START_COMPLETE)) {
         rv = mqtt_ping(client);
-        if (rv != MQTT_OK) {
+        // If the mqtt_sendbuf is full the ping is queued on a later call
+        if (rv != MQTT_OK && rv != MQTT_ERROR_SEND_BUFFER_IS_FULL) {
           client->error = rv;
           return rv;
         }
@@ -1338,7 +1462,7 @@ int16_t mqtt_send(struct mqtt_client *client)
 }
 
 
-int16_t mqtt_recv(struct mqtt_client *client)
+int16_t mqtt_recv(struct mqtt_client *client, const uint8_t *pMsg, uint16_t nBytes)
 {
     struct mqtt_response response;
     int16_t mqtt_recv_ret = MQTT_OK;
@@ -1357,15 +1481,18 @@ int16_t mqtt_recv(struct mqtt_client *client)
     // data from an OS host buffer into an MQTT dedicated receive buffer.
     // In this application that process is not needed and we only need to
     // check if there is any receive data in the uip_buf. To do this we
-    // only need to check if uip_len is > 0. If it is not we need to
+    // only need to check if nBytes is > 0. If it is not we need to
     // generate an error by setting rv = -1.
+    // pMsg points at one complete MQTT message. That is either the MQTT
+    // Partial Buffer or, when the message is wholly contained in the
+    // received packet, the message itself in the uip_buf.
 
     consumed = 0;
 
-    if (mqtt_partial_buffer_length > 0) rv = mqtt_partial_buffer_length;
+    if (nBytes > 0) rv = nBytes;
     else rv = -1;
     // Attempt to parse
-    consumed = mqtt_unpack_response(&response, &uip_buf[MQTT_PBUF], mqtt_partial_buffer_length);
+    consumed = mqtt_unpack_response(&response, pMsg, nBytes);
 
     if (consumed < 0) {
         client->error = consumed;
@@ -1384,9 +1511,8 @@ int16_t mqtt_recv(struct mqtt_client *client)
     // MQTT_CONTROL_PUBLISH:
     //     -> stage response, none if qos==0, PUBACK if qos==1, PUBREC if qos==2
     //     -> call publish callback
-    // MQTT_CONTROL_PUBACK: (not implemented as we always PUBLISH with qos==0 thus
-    //                       never receive a PUBACK)
-    //     -> release associated PUBLISH
+    // MQTT_CONTROL_PUBACK: (only received for QOS 1 pin state PUBLISH)
+    //     -> release associated pin state pending table entry
     // MQTT_CONTROL_PUBREC: (Not implemented - Only for qos 2)
     //     -> release PUBLISH
     //     -> stage PUBREL
@@ -1427,6 +1553,9 @@ int16_t mqtt_recv(struct mqtt_client *client)
                 }
                 break;
             }
+#if MQTT_PERSISTENT_SESSION == 1
+            connack_session_present = response.decoded.connack.session_present_flag;
+#endif // MQTT_PERSISTENT_SESSION == 1
             break;
 	    
         case MQTT_CONTROL_PUBLISH:
@@ -1444,6 +1573,14 @@ int16_t mqtt_recv(struct mqtt_client *client)
             client->publish_response_callback(&client->publish_response_callback_state, &response.decoded.publish);
             break;
 
+#if MQTT_QOS1_PINSTATE == 1
+        case MQTT_CONTROL_PUBACK:
+            // The PUBLISH was already released from the mqtt_sendbuf when it
+            // was sent. Free its entry in the pin state pending table.
+            pinstate_puback(response.decoded.puback.packet_id);
+            break;
+#endif // MQTT_QOS1_PINSTATE == 1
+
         case MQTT_CONTROL_SUBACK:
             // release associated SUBSCRIBE
             msg = mqtt_mq_find(&client->mq, MQTT_CONTROL_SUBSCRIBE, &response.decoded.suback.packet_id);
@@ -1861,6 +1998,9 @@ int16_t mqtt_pack_publish_request(uint8_t *buf, uint16_t bufsz,
     // calculate remaining length
     remaining_length = (uint32_t)(strlen(topic_name) + 2);
 
+    // add the packet id if qos is above 0
+    if (publish_flags & MQTT_PUBLISH_QOS_MASK) remaining_length += 2;
+
     remaining_length += (uint32_t)application_message_size;
     fixed_header.remaining_length = remaining_length;
 
@@ -1881,6 +2021,9 @@ int16_t mqtt_pack_publish_request(uint8_t *buf, uint16_t bufsz,
 
     // pack variable header
     buf += mqtt_pack_str(buf, topic_name);
+    if (publish_flags & MQTT_PUBLISH_QOS_MASK) {
+      buf += mqtt_pack_uint16(buf, packet_id);
+    }
     
     // pack payload
     memcpy(buf, application_message, application_message_size);
@@ -1953,6 +2096,24 @@ int16_t mqtt_unpack_suback_response (struct mqtt_response *mqtt_response, const
 }
 
 
+/* PUBACK */
+int16_t mqtt_unpack_puback_response(struct mqtt_response *mqtt_response, const uint8_t *buf)
+{
+    const uint8_t *const start = buf;
+
+    // assert remaining length is at least 2 (for packet id)
+    if (mqtt_response->fixed_header.remaining_length < 2) {
+      return MQTT_ERROR_MALFORMED_RESPONSE;
+    }
+
+    // unpack packet_id
+    mqtt_response->decoded.puback.packet_id = mqtt_unpack_uint16(buf);
+    buf += 2;
+
+    return buf - start;
+}
+
+
 /* SUBSCRIBE */
 int16_t mqtt_pack_subscribe_request(uint8_t *buf, uint16_t bufsz, uint16_t packet_id, char *topic, int max_qos_level)
 {
@@ -1988,29 +2149,83 @@ int16_t mqtt_pack_subscribe_request(uint8_t *buf, uint16_t bufsz, uint16_t packe
 
 
 /* MESSAGE QUEUE */
+// Compile time check that the largest CONNECT fits the message data area
+// of an empty mqtt_sendbuf.
+#if (MQTT_SENDBUF_SIZE - (MQTT_MQ_SLOTS * sizeof(struct mqtt_queued_message)) < MQTT_CONNECT_MAX_SIZE)
+  #error "mqtt_sendbuf is too small for the largest CONNECT"
+#endif
+
 void mqtt_mq_init(struct mqtt_message_queue *mq, void *buf, uint16_t bufsz) 
 {  
     if(buf != NULL)
     {
+        // The descriptor table occupies the end of the buffer
         mq->mem_start = buf;
-        mq->mem_end = (unsigned char*)buf + bufsz;
-        mq->curr = buf;
+        mq->mem_end = (unsigned char*)buf + bufsz - (MQTT_MQ_SLOTS * sizeof(struct mqtt_queued_message));
+        mq->head = 0;
+        mq->count = 0;
         mq->queue_tail = mq->mem_end;
         mq->curr_sz = mqtt_mq_currsz(mq);
     }
 }
 
 
+uint16_t mqtt_mq_currsz(struct mqtt_message_queue *mq)
+{
+    // Place curr and return the number of contiguous bytes available there.
+    // The result depends only on the queued messages, so it can be
+    // recalculated at any time.
+    uint8_t *first;
+    uint8_t *next;
+    uint16_t space_end;
+    uint16_t space_front;
+
+    if (mq->count == 0) {
+        // Queue is empty. Start packing at the start of the buffer.
+        mq->curr = mq->mem_start;
+        return (uint16_t)((uint8_t *)mq->mem_end - mq->curr);
+    }
+
+    // first is the data of the oldest message, next is the byte after the
+    // data of the newest message.
+    first = mqtt_mq_get(mq, 0)->start;
+    next = mq->queue_tail->start + mq->queue_tail->size;
+    mq->curr = next;
+
+    // No room left in the descriptor table
+    if (mq->count == MQTT_MQ_SLOTS) return 0;
+
+    // If the newest message starts before the oldest message the data has
+    // already wrapped to the start of the buffer, and the free space is
+    // between the newest and oldest messages.
+    if (mq->queue_tail->start < first) return (uint16_t)(first - next);
+
+    // Otherwise there is free space after the newest message and in front
+    // of the oldest message. Use the larger of the two.
+    space_end = (uint16_t)((uint8_t *)mq->mem_end - next);
+    space_front = (uint16_t)(first - (uint8_t *)mq->mem_start);
+    if (space_front > space_end) {
+        mq->curr = mq->mem_start;
+        return space_front;
+    }
+    return space_end;
+}
+
+
 struct mqtt_queued_message* mqtt_mq_register(struct mqtt_message_queue *mq, uint16_t nbytes)
 {
-    // make queued message header
-    --(mq->queue_tail);
+    // make queued message header in the next free descriptor. Callers never
+    // register when curr_sz is 0, so the descriptor table can't overflow.
+    mq->queue_tail = mqtt_mq_get(mq, mq->count);
+    mq->count++;
     mq->queue_tail->start = mq->curr;
     mq->queue_tail->size = nbytes;
     mq->queue_tail->state = MQTT_QUEUED_UNSENT;
+#if MQTT_BATCH_PUBLISH == 1
+    mq_append_open = 0;
+#endif // MQTT_BATCH_PUBLISH == 1
 
     // move curr and recalculate curr_sz
-    mq->curr += nbytes;
     mq->curr_sz = mqtt_mq_currsz(mq);
 
     return mq->queue_tail;
@@ -2018,43 +2233,11 @@ struct mqtt_queued_message* mqtt_mq_register(struct mqtt_message_queue *mq, uint
 
 
 void mqtt_mq_clean(struct mqtt_message_queue *mq) {
-    struct mqtt_queued_message *new_head;
-
-    for(new_head = mqtt_mq_get(mq, 0); new_head >= mq->queue_tail; --new_head) {
-        if (new_head->state != MQTT_QUEUED_COMPLETE) break;
-    }
-    
-    // check if everything can be removed
-    if (new_head < mq->queue_tail) {
-        mq->curr = mq->mem_start;
-        mq->queue_tail = mq->mem_end;
-        mq->curr_sz = mqtt_mq_currsz(mq);
-        return;
-    }
-    else if (new_head == mqtt_mq_get(mq, 0)) {
-        // do nothing
-        return;
-    }
-
-    // move buffered data
-    {
-        uint16_t n = mq->curr - new_head->start;
-        uint16_t removing = new_head->start - (uint8_t*) mq->mem_start;
-        memmove(mq->mem_start, new_head->start, n);
-        mq->curr = (unsigned char*)mq->mem_start + n;
-
-        // move queue
-        {
-            int16_t new_tail_idx = new_head - mq->queue_tail;
-            memmove(mqtt_mq_get(mq, new_tail_idx), mq->queue_tail, sizeof(struct mqtt_queued_message) * (new_tail_idx + 1));
-            mq->queue_tail = mqtt_mq_get(mq, new_tail_idx);
-          
-            {
-                // bump back start's
-                int16_t i = 0;
-                for(; i < new_tail_idx + 1; ++i) mqtt_mq_get(mq, i)->start -= removing;
-            }
-        }
+    // Remove the completed messages from the front of the queue. Only the
+    // head index moves, no message data is copied.
+    while (mq->count > 0 && mqtt_mq_get(mq, 0)->state == MQTT_QUEUED_COMPLETE) {
+        mq->head = (uint8_t)mqtt_mq_slot(mq->head + 1);
+        mq->count--;
     }
 
     // get curr_sz
@@ -2065,7 +2248,9 @@ void mqtt_mq_clean(struct mqtt_message_queue *mq) {
 struct mqtt_queued_message* mqtt_mq_find(struct mqtt_message_queue *mq, enum MQTTControlPacketType control_type, uint16_t *packet_id)
 {
     struct mqtt_queued_message *curr;
-    for(curr = mqtt_mq_get(mq, 0); curr >= mq->queue_tail; --curr) {
+    uint8_t i;
+    for(i = 0; i < mqtt_mq_length(mq); i++) {
+        curr = mqtt_mq_get(mq, i);
         if (curr->control_type == control_type) {
             if ((packet_id == NULL && curr->state != MQTT_QUEUED_COMPLETE) ||
                 (packet_id != NULL && *packet_id == curr->packet_id)) {
@@ -2099,6 +2284,9 @@ int16_t mqtt_unpack_response(struct mqtt_response* response, const uint8_t *buf,
         case MQTT_CONTROL_PUBLISH:
             rv = mqtt_unpack_publish_response(response, buf);
             break;
+        case MQTT_CONTROL_PUBACK:
+            rv = mqtt_unpack_puback_response(response, buf);
+            break;
         case MQTT_CONTROL_SUBACK:
             rv = mqtt_unpack_suback_response(response, buf);
             break;
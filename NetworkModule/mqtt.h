@@ -86,8 +86,8 @@ SOFTWARE.
  */
 
 
-// Size of the mqtt_sendbuf
-#define MQTT_SENDBUF_SIZE 160
+// Size of the mqtt_sendbuf. Set by RAM_PROFILE in uipopt.h (160 by default).
+#define MQTT_SENDBUF_SIZE RAM_SENDBUF_SIZE
 
 
 // Function reports the remaining size of the mqtt_sendbuf (the free space
@@ -313,6 +313,15 @@ struct mqtt_response_suback {
 };
 
 
+// The response to a QOS 1 PUBLISH.
+// see <a href="http://docs.oasis-open.org/mqtt/mqtt/v3.1.1/os/mqtt-v3.1.1-os.html#_Toc398718043">
+// MQTT v3.1.1: PUBACK - Publish Acknowledgement.
+struct mqtt_response_puback {
+    // The packet ID of the PUBLISH being acknowledged
+    uint16_t packet_id;
+};
+
+
 // The response to a ping request.
 // This response contains no members.
 // see <a href="http://docs.oasis-open.org/mqtt/mqtt/v3.1.1/os/mqtt-v3.1.1-os.html#_Toc398718086">
@@ -335,6 +344,7 @@ struct mqtt_response {
     union {
         struct mqtt_response_connack  connack;
         struct mqtt_response_publish  publish;
+        struct mqtt_response_puback   puback;
 //        struct mqtt_response_pubrel   pubrel;
         struct mqtt_response_suback   suback;
         struct mqtt_response_pingresp pingresp;
@@ -399,6 +409,18 @@ int16_t mqtt_unpack_publish_response (struct mqtt_response *mqtt_response, const
 int16_t mqtt_unpack_suback_response(struct mqtt_response *mqtt_response, const uint8_t *buf);
 
 
+// Deserialize a PUBACK packet from the broker.
+// mqtt_response must have a control type of MQTT_CONTROL_PUBACK.
+//
+// mqtt_response - the response that is initialized from the contents of buf.
+// buf - the buffer with the incoming data.
+// returns - The number of bytes that were consumed, or a negative value if
+// there was a protocol violation.
+//
+// see mqtt_response_puback
+int16_t mqtt_unpack_puback_response(struct mqtt_response *mqtt_response, const uint8_t *buf);
+
+
 // Deserialize a packet from the broker.
 // response - the mqtt_response that will be initialize from buf.
 // buf - the incoming data buffer.
@@ -604,16 +626,17 @@ struct mqtt_queued_message {
     // The number of bytes in the message
     uint16_t size;
 
-    // The state of the message
-    enum MQTTQueuedMessageState state;
+    // The state of the message (an MQTTQueuedMessageState). Stored in a
+    // byte to keep the descriptor table small.
+    uint8_t state;
 
     // The time at which the message was sent..
     // A timeout will only occur if the message is in
     // the MQTT_QUEUED_AWAITING_ACK state.
     uint32_t time_sent;
 
-    // The control type of the message.
-    enum MQTTControlPacketType control_type;
+    // The control type of the message (an MQTTControlPacketType).
+    uint8_t control_type;
 
     // The packet id of the message.
     // This field is only used if the associate control_type has a 
@@ -622,31 +645,67 @@ struct mqtt_queued_message {
 };
 
 
+// The number of entries in the message queue descriptor table. With pin
+// state PUBLISH messages packed together by mqtt_publish_append() no more
+// than 3 or 4 messages are ever queued, and a message that finds the table
+// full is queued on a later call. Each entry is 12 bytes, so 3 entries
+// leave room for the largest CONNECT in the 160 byte mqtt_sendbuf.
+#define MQTT_MQ_SLOTS	3
+
+// The number of message data bytes in the mqtt_sendbuf. The descriptor
+// table occupies the rest of the buffer, so this is the same whether one
+// or MQTT_MQ_SLOTS messages are queued.
+#define MQTT_MQ_DATA_SIZE (MQTT_SENDBUF_SIZE - (MQTT_MQ_SLOTS * sizeof(struct mqtt_queued_message)))
+
+// The largest CONNECT message built by mqtt_startup(). The data area must
+// hold it or the connection can never be established (see the check in
+// mqtt.c).
+// 2   Fixed header (the remaining length is less than 128)
+// 10  Variable header
+// 27  Client ID: "NetworkModule" plus the 12 character MAC
+// 48  Will topic: "NetworkModule/" plus a 19 character devicename plus
+//     "/availability"
+// 9   Will message: "offline"
+// 12  10 character User name
+// 12  10 character Password
+#define MQTT_CONNECT_MAX_SIZE	120
+
+
 // A message queue.
 // This struct is used internally to manage sending messages.
 // The only members the user should use are curr and curr_sz. 
+//
+// The message data is kept in a ring in the memory block from mem_start to
+// mem_end. The descriptor table is a fixed ring of MQTT_MQ_SLOTS entries
+// that follows the message data. Removing a sent message only advances
+// head, so no data is ever moved. Each message is contiguous: a new
+// message is packed after the newest message, or at mem_start if the space
+// in front of the oldest message is larger.
 struct mqtt_message_queue {
     // The start of the message queue's memory block. 
     // This member should not be manually changed.
     void *mem_start;
 
-    // The end of the message queue's memory block
+    // The end of the message data area. The descriptor table starts here.
     void *mem_end;
 
     // A pointer to the position in the buffer you can pack bytes at.
     // Immediately after packing bytes at curr you must call mqtt_mq_register.
     uint8_t *curr;
 
-    // The number of bytes that can be written to curr.
-    // curr_sz will decrease by more than the number of bytes you write to 
-    // curr. This is because the mqtt_queued_message structs share the 
-    // same memory (and thus, a mqtt_queued_message must be allocated in 
-    // the message queue's memory whenever a new message is registered).  
+    // The number of contiguous bytes that can be written to curr. This is
+    // 0 if the descriptor table is full.
     uint16_t curr_sz;
     
-    // The tail of the array of mqtt_queued_messages's.
+    // The newest message in the queue. Only valid if count is not 0.
     // This member should not be used manually.
     struct mqtt_queued_message *queue_tail;
+
+    // The descriptor table index of the oldest message in the queue.
+    uint8_t head;
+
+    // The number of messages in the queue.
+    uint8_t count;
 };
 
 
@@ -693,21 +752,25 @@ struct mqtt_queued_message* mqtt_mq_register(struct mqtt_message_queue *mq, uint
 struct mqtt_queued_message* mqtt_mq_find(struct mqtt_message_queue *mq, enum MQTTControlPacketType control_type, uint16_t *packet_id);
 
 
-// Returns the mqtt_queued_message at index.
+// Returns the mqtt_queued_message at index. Index 0 is the oldest message.
 // mq_ptr - A pointer to the message queue.
 // index - The index of the message. 
 // returns - The mqtt_queued_message at index.
-#define mqtt_mq_get(mq_ptr, index) (((struct mqtt_queued_message*) ((mq_ptr)->mem_end)) - 1 - index)
+// head is always less than MQTT_MQ_SLOTS and index is never more than
+// MQTT_MQ_SLOTS, so one subtraction wraps the sum into the table.
+#define mqtt_mq_slot(n) (((n) >= MQTT_MQ_SLOTS) ? ((n) - MQTT_MQ_SLOTS) : (n))
+#define mqtt_mq_get(mq_ptr, index) (((struct mqtt_queued_message*) ((mq_ptr)->mem_end)) + mqtt_mq_slot((mq_ptr)->head + (index)))
 
 
 // Returns the number of messages in the message queue, mq_ptr. This will
 // include messages that have already been sent if this call is not
 // immediately preceded by a mqtt_mq_clean().
-#define mqtt_mq_length(mq_ptr) (((struct mqtt_queued_message*) ((mq_ptr)->mem_end)) - (mq_ptr)->queue_tail)
+#define mqtt_mq_length(mq_ptr) ((mq_ptr)->count)
 
 
-// Used internally to recalculate the curr_sz.
-#define mqtt_mq_currsz(mq_ptr) (mq_ptr->curr >= (uint8_t*) ((mq_ptr)->queue_tail - 1)) ? 0 : ((uint8_t*) ((mq_ptr)->queue_tail - 1)) - (mq_ptr)->curr
+// Used internally to place curr and recalculate the curr_sz.
+// Returns the new curr_sz.
+uint16_t mqtt_mq_currsz(struct mqtt_message_queue *mq);
 
 
 
@@ -800,8 +863,10 @@ int16_t mqtt_send(struct mqtt_client *client);
 
 // Handles ingress client traffic.
 // client - The MQTT client.
+// pMsg - One complete MQTT message.
+// nBytes - The length of the message.
 // returns - MQTT_OK upon success, an MQTTErrors otherwise. 
-int16_t mqtt_recv(struct mqtt_client *client);
+int16_t mqtt_recv(struct mqtt_client *client, const uint8_t *pMsg, uint16_t nBytes);
 
 
 // Function that does the actual sending and receiving of traffic from the
@@ -917,6 +982,22 @@ int16_t mqtt_publish(struct mqtt_client *client,
                              uint8_t publish_flags);
 
 
+#if MQTT_BATCH_PUBLISH == 1
+// Publish an application message, appending it to the queued message built
+// by the previous call if that message has not been sent yet.
+// Multiple PUBLISH packets are then carried in one queued message and are
+// transmitted in one TCP segment. Only QOS 0 messages without an Auto
+// Discovery placeholder may be appended. If the previous message was sent
+// or there is no room left the message is queued with mqtt_publish().
+// Arguments and return value are the same as mqtt_publish().
+int16_t mqtt_publish_append(struct mqtt_client *client,
+                             const char* topic_name,
+                             const void* application_message,
+                             uint16_t application_message_size,
+                             uint8_t publish_flags);
+#endif // MQTT_BATCH_PUBLISH == 1
+
+
 // Acknowledge an incoming publish with QOS==1.
 //
 // client - The MQTT client.
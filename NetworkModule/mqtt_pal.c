@@ -332,10 +332,22 @@ int16_t mqtt_pal_sendall(const void* buf, uint16_t len)
       if (payload_buf[0] == '%') {
         // Found a marker - replace the existing payload with an auto
 	// discovery message.
+#if MQTT_DISCOVERY_BURST == 0
+	// An Auto Discovery message needs most of the TCP segment, so it is
+	// only built if no other MQTT message is in the uip_buf. Otherwise
+	// return 0 so mqtt_send() sends it on its next call.
+	if (uip_slen != 0) return 0;
+#endif // MQTT_DISCOVERY_BURST == 0
+#if MQTT_DISCOVERY_BURST == 1
+	// The Auto Discovery message is built after any MQTT messages already
+	// in the uip_buf. The headers copied below must fit before anything is
+	// written. The expanded size is checked once it is known.
+	if (uip_slen + len + 3 > UIP_TX_RAM_MSS) return 0;
+#endif // MQTT_DISCOVERY_BURST == 1
 	auto_found = 1;
-        // Set pointer to uip_appdata, which is the position in the uip_buf
-	// where transmit data is to be placed.
-        pBuffer = uip_appdata;
+        // Set pointer to uip_appdata plus uip_slen, which is the position in
+	// the uip_buf where transmit data is to be placed.
+        pBuffer = (char *)uip_appdata + uip_slen;
         // Copy the Fixed Header Byte 1 to the uip_buf
         *pBuffer++ = template_buf[0];
 	
@@ -424,6 +436,14 @@ int16_t mqtt_pal_sendall(const void* buf, uint16_t len)
 	if ((payload_buf[1] == 'T')
 	 || (payload_buf[1] == 'P')
 	 || (payload_buf[1] == 'H')) payload_size -= 10;
+
+	// If other MQTT messages are already in the uip_buf check that the
+	// expanded message fits in the rest of the TCP segment. If not return
+	// 0 so mqtt_send() sends it on its next call in an empty segment. The
+	// bytes written so far are not counted in uip_slen so they are ignored.
+	if (uip_slen != 0
+	 && (uip_slen + payload_size + 3 > uip_mss()
+	  || uip_slen + payload_size + 3 > UIP_TX_RAM_MSS)) return 0;
 	
 	// Note: The value "len" remains unchanged. It is the length of the
 	// "app_message" provided to this function, even if we are creating a
@@ -464,14 +484,14 @@ int16_t mqtt_pal_sendall(const void* buf, uint16_t len)
 	}
 	
         // Insert the new remaining length value in the uip_buf.
-        mBuffer = uip_appdata + 1;
+        mBuffer = (char *)uip_appdata + uip_slen + 1;
 	*((uint16_t*)mBuffer) = *((uint16_t*)&new_remaining[0]); // copy 2 bytes
 	
-	// Calculate uip_slen (it will be used later). It is the new remaining 
-	// length plus 3 (for the control byte and the two remaining length
-	// bytes). Remember that payload_size is currently equal to the new
-	// remaining length value.
-	uip_slen = payload_size + 3;
+	// Calculate uip_slen (it will be used later). It grows by the new
+	// remaining length plus 3 (for the control byte and the two remaining
+	// length bytes). Remember that payload_size is currently equal to the
+	// new remaining length value.
+	uip_slen += payload_size + 3;
     
         // Build the Auto Discovery payload and copy it to the uip_buf. The
 	// pBuffer pointer is already pointing to the the uip_buf location
@@ -740,9 +760,13 @@ int16_t mqtt_pal_sendall(const void* buf, uint16_t len)
   
   if (auto_found != 1) {
     // The payload did not require the replacement procedure, so simply copy
-    // the payload data into the uip_buf and set the uip_slen value.
-    memcpy(uip_appdata, buf, len);
-    uip_slen = len;
+    // the payload data into the uip_buf after any MQTT messages already
+    // placed there by mqtt_send() and update the uip_slen value. If there
+    // isn't room in the TCP segment return 0 so mqtt_send() sends the
+    // message on its next call.
+    if (uip_slen + len > uip_mss() || uip_slen + len > UIP_TX_RAM_MSS) return 0;
+    memcpy((uint8_t *)uip_appdata + uip_slen, buf, len);
+    uip_slen += len;
   }
 
 /*
@@ -823,9 +847,12 @@ int16_t mqtt_pal_sendall(const void* buf, uint16_t len) {
   //---------------------------------------------------------------------------//
   // This code only services a normal MQTT packet which is completely formed
   // external to this function. Simply copy the payload data into the uip_buf
-  // and set the uip_slen value.
-  memcpy(uip_appdata, buf, len);
-  uip_slen = len;
+  // after any MQTT messages already placed there by mqtt_send() and update
+  // the uip_slen value. If there isn't room in the TCP segment return 0 so
+  // mqtt_send() sends the message on its next call.
+  if (uip_slen + len > uip_mss() || uip_slen + len > UIP_TX_RAM_MSS) return 0;
+  memcpy((uint8_t *)uip_appdata + uip_slen, buf, len);
+  uip_slen += len;
 
 
 
@@ -2,6 +2,37 @@
  *	Copyright (c) 2008 by COSMIC Software
  */
 extern void _stext();		/* startup routine */
+#include "uipopt.h"
+#if LOW_POWER_IDLE == 1
+extern @far @interrupt void idle_exti_portc_isr(void);
+extern @far @interrupt void idle_tim4_isr(void);
+#define EXTI2_HANDLER	idle_exti_portc_isr
+#define TIM4_HANDLER	idle_tim4_isr
+#else // LOW_POWER_IDLE == 0
+#define EXTI2_HANDLER	0
+#define TIM4_HANDLER	0
+#endif // LOW_POWER_IDLE == 1
+#if PIN_CAPTURE_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD
+extern @far @interrupt void pin_capture_porta_isr(void);
+extern @far @interrupt void pin_capture_portc_isr(void);
+extern @far @interrupt void pin_capture_portd_isr(void);
+extern @far @interrupt void pin_capture_porte_isr(void);
+#define EXTI0_HANDLER	pin_capture_porta_isr
+#undef EXTI2_HANDLER
+#define EXTI2_HANDLER	pin_capture_portc_isr
+#define EXTI3_HANDLER	pin_capture_portd_isr
+#define EXTI4_HANDLER	pin_capture_porte_isr
+#else // PIN_CAPTURE_SUPPORT == 0
+#define EXTI0_HANDLER	0
+#define EXTI3_HANDLER	0
+#define EXTI4_HANDLER	0
+#endif // PIN_CAPTURE_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD
+#if DEBUG_SUPPORT == 15 && UART_TX_BUFFERED == 1
+extern @far @interrupt void uart2_tx_isr(void);
+#define UART2_TX_HANDLER	uart2_tx_isr
+#else // DEBUG_SUPPORT != 15 || UART_TX_BUFFERED == 0
+#define UART2_TX_HANDLER	0
+#endif // DEBUG_SUPPORT == 15 && UART_TX_BUFFERED == 1
 
 #pragma section const {vector}
 
@@ -11,11 +42,11 @@ void (* const @vector _vectab[32])() = {
 	0,			/* TLI         */
 	0,			/* AWU         */
 	0,			/* CLK         */
-	0,			/* EXTI0       */
+	EXTI0_HANDLER,		/* EXTI0       */
 	0,			/* EXTI1       */
-	0,			/* EXTI2       */
-	0,			/* EXTI3       */
-	0,			/* EXTI4       */
+	EXTI2_HANDLER,		/* EXTI2       */
+	EXTI3_HANDLER,		/* EXTI3       */
+	EXTI4_HANDLER,		/* EXTI4       */
 	0,0,			/* Reserved    */
 	0,			/* SPI         */
 	0,			/* TIMER 1 OVF */
@@ -26,10 +57,10 @@ void (* const @vector _vectab[32])() = {
 	0,			/* TIMER 3 CAP */
 	0,0,			/* Reserved    */
 	0,			/* I2C         */
-	0,			/* UART2 TX    */
+	UART2_TX_HANDLER,	/* UART2 TX    */
 	0,			/* UART2 RX    */
 	0,			/* ADC1        */
-	0,			/* TIMER 4 OVF */
+	TIM4_HANDLER,		/* TIMER 4 OVF */
 	0,			/* EEPROM ECC  */
 	0,0,0,0,0,		/* Reserved    */
 	};
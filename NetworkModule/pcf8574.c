@@ -33,6 +33,9 @@
 #if PCF8574_SUPPORT == 1
 
 extern uint8_t stored_options1;  // Additional options stored in EEPROM
+#if PCF8574_READ_GATE == 1
+extern uint8_t pin_control[24];  // Per pin configuration
+#endif // PCF8574_READ_GATE == 1
 
 extern uint8_t OctetArray[14];
 
@@ -189,4 +192,24 @@ uint8_t PCF8574_response_check()
   return error;
 }
 
+
+#if PCF8574_READ_GATE == 1
+uint8_t PCF8574_read_needed(void)
+{
+  // Function to check whether read_input_pins() needs to read the PCF8574.
+  // Returns 1 if a PCF8574 was found and at least one of its pins is an
+  // input (pins 17 to 24) or a linked input (pins 17 to 20), otherwise 0.
+  // The read value is only used for those pins, so the I2C transfer can be
+  // skipped in all other cases.
+  uint8_t i;
+
+  if (I2C_PCF8574_1_WRITE_CMD == 0x00) return 0;
+  for (i = 16; i < 24; i++) {
+    if ((pin_control[i] & 0x03) == 0x01) return 1;
+    if ((pin_control[i] & 0x03) == 0x02 && i < 20) return 1;
+  }
+  return 0;
+}
+#endif // PCF8574_READ_GATE == 1
+
 #endif // PCF8574_SUPPORT == 1
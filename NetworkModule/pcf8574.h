@@ -30,5 +30,6 @@ void PCF8574_init(void);
 void PCF8574_write(uint8_t byte);
 uint8_t PCF8574_read(void);
 uint8_t PCF8574_response_check(void);
+uint8_t PCF8574_read_needed(void);
 
 #endif /* __PCF8574_H__ */
@@ -38,6 +38,10 @@ uint32_t second_counter;      // MQTT timing: 1 second counter
 
 uint16_t ms_counter;          // Free running ms counter
 
+uint16_t clock_high;          // Upper 16 bits of the 32 bit TIM1 clock
+uint32_t timer_last;          // clock_ticks() value up to which time has been
+                              // added to the timers
+
 
 
 void clock_init(void)
@@ -145,7 +149,12 @@ void clock_init(void)
 #endif // DEBUG_SUPPORT
 
   //   CLK_PCKENR1 bit 0x04             // Bit location 0x04 is reserved
-  CLK_PCKENR1 &= (uint8_t)(~0x02);	// SPI clock disabled
+#if HW_SPI_SUPPORT == 0
+  CLK_PCKENR1 &= (uint8_t)(~0x02);	// SPI clock disabled unless the
+                                        // ENC28J60 is driven by the SPI
+					// peripheral (then we just leave
+					// it enabled)
+#endif // HW_SPI_SUPPORT == 0
   CLK_PCKENR1 &= (uint8_t)(~0x01);	// I2C clock disabled
   
   // CLK_PCKENR2 bit 0x80               // Bit location 0x80 is reserved
@@ -175,10 +184,10 @@ void clock_init(void)
   // Configure TIM1
   // TIM1 is being used as a simple counter, so most of its registers
   // are not used. This will configure TIM1 to increment at ~100KHz. The
-  // timer is stopped, reloaded, and restarted in the timer_update()
-  // function.
-  TIM1_ARRH = (uint8_t)(0xFA);  // Timing 640ms; Count to decimal
-  TIM1_ARRL = (uint8_t)(0x00);  //   64000 (0xFA00)
+  // timer runs freely and is never reloaded. clock_ticks() extends it to
+  // 32 bits with the update (overflow) flag.
+  TIM1_ARRH = (uint8_t)(0xFF);  // Timing 655.36ms; Count to decimal
+  TIM1_ARRL = (uint8_t)(0xFF);  //   65535 (0xFFFF)
   TIM1_PSCRH = (uint8_t)(0x00); // 16MHz / (1+159) = 100KHz
   TIM1_PSCRL = (uint8_t)(0x9F); //   10us period
   TIM1_EGR = (uint8_t)0x01;     // Set UG bit to load the PSCR. The
@@ -228,6 +237,58 @@ void clock_init(void)
   second_toggle = 0;         // Initialize toggle for seconds counter
   second_counter = 0;        // Initialize seconds counter
   ms_counter = 0;            // Initialize free running ms counter
+  clock_high = 0;            // Initialize the 32 bit clock
+  timer_last = 0;
+}
+
+
+void clock_poll(void)
+{
+  // Count a TIM1 wrap into clock_high. The TIM1 update interrupt is not
+  // used (most builds run with interrupts masked), so the TIM1 update flag
+  // is used as a one deep latch of the overflow instead. It only has to be
+  // checked at least once per TIM1 period (655ms). clock_ticks() and
+  // wait_timer() do so, which covers the main loop and the long busy waits
+  // (I2C EEPROM writes, BME280 and DS18B20 conversions).
+  if (TIM1_SR1 & 0x01) {
+    TIM1_SR1 = (uint8_t)(~0x01);  // Clear the UIF (update interrupt flag)
+    clock_high++;
+  }
+}
+
+
+uint32_t clock_ticks(void)
+{
+  // Return the 32 bit monotonic clock in TIM1 counts (10us units). It wraps
+  // after about 11.9 hours, so intervals are taken as the unsigned
+  // difference of two readings.
+  uint16_t low;
+  
+  low = read_TIM1();
+  if (TIM1_SR1 & 0x01) {
+    // TIM1 wrapped. The count read above may be from before or after the
+    // wrap, so it is read again after the wrap is counted.
+    clock_poll();
+    low = read_TIM1();
+  }
+  return ((uint32_t)clock_high << 16) | low;
+}
+
+
+uint32_t clock_us(void)
+{
+  // Return the 32 bit monotonic clock in microseconds (10us resolution). It
+  // wraps after about 71 minutes.
+  return clock_ticks() * 10;
+}
+
+
+static uint8_t timer_add8(uint8_t timer, uint16_t time_ms)
+{
+  // Add time_ms to an 8 bit ms timer, holding it at 255 rather than
+  // wrapping
+  if (time_ms > (uint16_t)(255 - timer)) return 255;
+  return (uint8_t)(timer + time_ms);
 }
 
 
@@ -251,70 +312,47 @@ void timer_update(void)
   // 'forever' and tracking elapsed time is the responsibility of the external
   // function using the counter.
   //
-  // The timers use TIM1 to track time. TIM1 increments at 100KHz (10us
-  // period).
-  //
-  // TIM1 is configured to count to 64000 (640ms) before it resets. It is
-  // assumed we NEVER take longer than 640ms before getting around to running
-  // timer_update().
-  // 
-  // If the counter does over-flow the time collected will be incorrect in
-  // 640ms increments. The external design needs to make sure this never
-  // happens.
+  // The timers use the clock_ticks() clock to track time. TIM1 increments
+  // at 100KHz (10us period) and is extended to 32 bits by clock_ticks().
   // 
   // timer_update() is called with every pass through the main.c loop, so it
   // is typically called about once per millisecond. However, there are some
   // functions which may delay the main.c loop for several milliseconds. The
-  // webpage servicing function may cause delays of 65ms or longer. To
-  // account for these delays the timer_update() function determines how many
+  // webpage servicing function may cause delays of 65ms or longer, and an
+  // I2C EEPROM erase or a BME280 read can take much longer. To account for
+  // these delays the timer_update() function determines how many
   // milliseconds have passed since the last call and adds that to all of the
-  // dependent time counters. The timer_update() function also forwards the
-  // time remainder to the next up-count so that fractions of a millisecond
-  // are not lost.
+  // dependent time counters. The part of a millisecond that remains is left
+  // in the clock so that fractions of a millisecond are not lost.
   //
-  // Note: Calls to the function can be spread out by up to 640ms. Measure-
-  // ments show the current gap in calls to timer_update() to be from less
-  // than 1ms, typically 1 to 2ms, and rare gaps of up to 65ms. The function
-  // will now add the correct number of milliseconds to the periodic_timer,
-  // mqtt_timer, arp_timer, 100ms_timer, and second_counter. TIM1 is used as
-  // the time base for the counters. TIM1 is configured to clock at 100KHz and
-  // the counter will count to 64000 (640ms) before it resets. It is assumed
-  // the main.c loop NEVER takes longer than 640ms before getting around to
-  // calling timer_update(). If the counter does over-flow the time collected
-  // can be in error in 640ms increments. The overall main loop design must
-  // guarantee that this does not happen.
+  // Note: TIM1 is never stopped or reloaded, so a gap in calls to
+  // timer_update() longer than the 655ms TIM1 period does not lose time as
+  // long as each TIM1 wrap is counted by clock_poll() (see clock_poll()). The
+  // 8 bit timers are held at 255 rather than wrapping after a gap longer
+  // than their range, so they expire on the next check.
 
   
-  uint16_t counter;
+  uint32_t elapsed;
   uint16_t time_ms;
-  uint16_t remainder;
   
-  // Read the counter. Must assure that the MAByte is read first followed by
-  // the LSByte.
-  counter = (uint16_t)(TIM1_CNTRH << 8);
-  nop(); // nop placed here to make sure the compiler doesn't optimize the
-         // read sequence.
-  counter = counter | TIM1_CNTRL;
-
-  // Check for how many milliseconds have passed since the counter was last
-  // read. The counter runs with a 10us period, so the number of milliseconds
-  // is counter / 100.
-  time_ms = counter / 100;
-  // Load the counter with the remainder of the count. This keeps the timer
-  // from being over-run, and prevents the loss of fractions of a millisecond
-  // that may remain each time the counter exceeds 1ms.
-  remainder = counter - (time_ms * 100);
-  TIM1_CR1 &= (uint8_t)(~0x01);		// Disable counter
-  TIM1_CNTRH = (uint8_t)(remainder >> 8);
-  TIM1_CNTRL = (uint8_t)(remainder & 0x00ff);
-  TIM1_CR1 |= (uint8_t)0x01;		// Enable counter
+  // Check for how many milliseconds have passed since the time was last
+  // added. The clock runs with a 10us period, so the number of milliseconds
+  // is elapsed / 100. The 32 bit division is only needed after a gap of
+  // more than 655ms.
+  elapsed = clock_ticks() - timer_last;
+  if (elapsed < 100) return;
+  if (elapsed < 65536) time_ms = (uint16_t)((uint16_t)elapsed / 100);
+  else if (elapsed < 6400000) time_ms = (uint16_t)(elapsed / 100);
+  else time_ms = 64000; // The rest is added on the next calls
+  timer_last += (uint32_t)time_ms * 100;
 
   // Increment the timers per the number of ms collected above. The timer's
   // respective "_expired" function calls will determine their timeout points.
-  periodic_timer = (uint8_t)(periodic_timer + time_ms);
-  mqtt_timer = (uint8_t)(mqtt_timer + time_ms);
-  arp_timer = (uint16_t)(arp_timer + time_ms);
-  t100ms_timer = (uint8_t)(t100ms_timer + time_ms);
+  periodic_timer = timer_add8(periodic_timer, time_ms);
+  mqtt_timer = timer_add8(mqtt_timer, time_ms);
+  if (time_ms > (uint16_t)(0xffff - arp_timer)) arp_timer = 0xffff;
+  else arp_timer = (uint16_t)(arp_timer + time_ms);
+  t100ms_timer = timer_add8(t100ms_timer, time_ms);
   
   // Update the free running millisecond counter. This counter counts time in
   // milliseconds and rolls over at 65535. Note that since timer_update() is
@@ -325,11 +363,10 @@ void timer_update(void)
   
   // Update the second_counter. The second_counter is a 32 bit unsigned
   // integer, so its lifetime is about 136 years if never power cycled - 
-  // essentially forever in this application.
-  if (second_toggle < 1000) {
-    second_toggle += time_ms;			// Increment second_toggle every 1ms
-  }
-  else {
+  // essentially forever in this application. All of the seconds in a long
+  // gap are counted.
+  second_toggle += time_ms;
+  while (second_toggle >= 1000) {
     second_toggle = second_toggle - 1000;
     second_counter ++;			// Increment second_counter every 1 sec
   }
@@ -410,6 +447,9 @@ void wait_timer(uint16_t wait)
   
   uint16_t counter;
 
+  // Count a TIM1 wrap so that long sequences of waits do not lose time
+  clock_poll();
+
   TIM3_CR1 &= (uint8_t)(~0x01);		// Disable counter
   TIM3_CNTRH = (uint8_t)0x00;		// Clear counter High
   TIM3_CNTRL = (uint8_t)0x00;		// Clear counter Low
@@ -430,3 +470,406 @@ void wait_timer(uint16_t wait)
 
   return;
 }
+
+
+uint16_t read_TIM1(void)
+{
+  // Read the TIM1 counter. Must assure that the MSByte is read first
+  // followed by the LSByte. This is the low 16 bits of clock_ticks().
+  uint16_t counter;
+  counter = (uint16_t)(TIM1_CNTRH << 8);
+  nop(); // nop placed here to make sure the compiler doesn't optimize the
+         // read sequence.
+  counter = counter | TIM1_CNTRL;
+  return counter;
+}
+
+
+#if TASK_SCHEDULER == 1 || PROFILE_SUPPORT == 1
+uint16_t clock_elapsed(uint32_t start)
+{
+  // Return the clock counts (10us units) since start was read with
+  // clock_ticks(), held at 65535 for run times of 655ms or more.
+  uint32_t elapsed;
+  elapsed = clock_ticks() - start;
+  if (elapsed > 0xffff) return 0xffff;
+  return (uint16_t)elapsed;
+}
+#endif // TASK_SCHEDULER == 1 || PROFILE_SUPPORT == 1
+
+
+#if TASK_SCHEDULER == 1
+//---------------------------------------------------------------------------//
+// Main loop task scheduler
+//
+// The tasks are listed in a const table (in Flash) provided by main.c. The
+// RAM part is a next run time (deadline) per task and a singly linked list
+// of the tasks sorted by deadline. sched_run() is called on every pass of
+// the main loop and only checks the task at the head of the list, so a pass
+// with no task due costs a single compare. If the head task is due it is
+// run, given its next deadline, and re-inserted in the list.
+//
+// Deadlines are in ms_counter time. ms_counter rolls over at 65535, so the
+// compares are done on the signed difference and task periods must be less
+// than 32768ms.
+//
+// The task run time is measured with clock_ticks() (10us per count). The
+// longest run time of each task is kept in sched_run_max[].
+
+const struct sched_task *sched_tasks;    // Task table
+uint16_t sched_due[SCHED_MAX_TASKS];     // Next run time of each task
+uint8_t sched_next[SCHED_MAX_TASKS];     // Deadline list links
+uint8_t sched_head;                      // Task with the nearest deadline
+uint16_t sched_run_max[SCHED_MAX_TASKS]; // Longest task run time in 10us
+                                         // units
+
+
+void sched_init(const struct sched_task *tasks, uint8_t num_tasks)
+{
+  // Set the first deadline of each task one period from now and build the
+  // deadline list. num_tasks must not exceed SCHED_MAX_TASKS.
+  uint8_t i;
+  
+  sched_tasks = tasks;
+  sched_head = SCHED_NONE;
+  for (i=0; i<num_tasks; i++) {
+    sched_due[i] = (uint16_t)(ms_counter + tasks[i].period);
+    sched_run_max[i] = 0;
+    sched_insert(i);
+  }
+}
+
+
+void sched_insert(uint8_t id)
+{
+  // Insert a task in the deadline list after any tasks with the same or an
+  // earlier deadline.
+  uint8_t *link;
+  
+  link = &sched_head;
+  while (*link != SCHED_NONE
+      && (int16_t)(sched_due[*link] - sched_due[id]) <= 0) {
+    link = &sched_next[*link];
+  }
+  sched_next[id] = *link;
+  *link = id;
+}
+
+
+void sched_run(void)
+{
+  // Run the task at the head of the deadline list if it is due.
+  uint8_t id;
+  uint32_t start;
+  uint16_t run_time;
+  
+  id = sched_head;
+  if ((int16_t)(ms_counter - sched_due[id]) < 0) return; // Nothing due
+  
+  sched_head = sched_next[id];
+  
+  start = clock_ticks();
+  sched_tasks[id].task();
+  run_time = clock_elapsed(start);
+  if (run_time > sched_run_max[id]) sched_run_max[id] = run_time;
+  
+  // Set the next deadline. If the task has fallen a full period behind
+  // (for instance after a long webpage transmission) the period restarts
+  // from now rather than running the task repeatedly to catch up.
+  sched_due[id] += sched_tasks[id].period;
+  if ((int16_t)(ms_counter - sched_due[id]) >= 0) {
+    sched_due[id] = (uint16_t)(ms_counter + sched_tasks[id].period);
+  }
+  sched_insert(id);
+}
+#endif // TASK_SCHEDULER == 1
+
+
+#if PROFILE_SUPPORT == 1
+//---------------------------------------------------------------------------//
+// Main loop stage profiling
+//
+// prof_begin() and prof_end() are placed around a stage of the main loop
+// (see the PROF_ defines in timer.h). The stage run time is measured with
+// clock_ticks() in 10us units, the same way sched_run() measures task run
+// times, and the call count, minimum, maximum and a sum for the average are
+// kept for each stage. If the call count reaches its limit the count and sum
+// are halved so the average keeps following recent behavior.
+
+uint32_t prof_start[PROF_NUM_STAGES];    // clock_ticks() at prof_begin()
+uint16_t prof_count[PROF_NUM_STAGES];    // Number of measurements
+uint16_t prof_min[PROF_NUM_STAGES];      // Shortest run time
+uint16_t prof_max[PROF_NUM_STAGES];      // Longest run time
+uint32_t prof_sum[PROF_NUM_STAGES];      // Sum of run times
+
+
+void prof_init(void)
+{
+  // Clear the profiling statistics
+  memset(prof_count, 0, sizeof(prof_count));
+  memset(prof_min, 0, sizeof(prof_min));
+  memset(prof_max, 0, sizeof(prof_max));
+  memset(prof_sum, 0, sizeof(prof_sum));
+}
+
+
+void prof_begin(uint8_t stage)
+{
+  prof_start[stage] = clock_ticks();
+}
+
+
+void prof_end(uint8_t stage)
+{
+  uint16_t run_time;
+  
+  run_time = clock_elapsed(prof_start[stage]);
+  
+  if (prof_count[stage] == 0xffff) {
+    prof_count[stage] >>= 1;
+    prof_sum[stage] >>= 1;
+  }
+  prof_count[stage]++;
+  prof_sum[stage] += run_time;
+  if (prof_count[stage] == 1 || run_time < prof_min[stage]) prof_min[stage] = run_time;
+  if (run_time > prof_max[stage]) prof_max[stage] = run_time;
+}
+
+
+uint8_t *prof_format(uint8_t stage, uint8_t *pBuffer)
+{
+  // Write the statistics of a stage to pBuffer as "count min avg max", each
+  // value 5 decimal digits (23 characters). Returns a pointer to the
+  // terminating NULL.
+  uint16_t avg;
+  
+  avg = 0;
+  if (prof_count[stage]) avg = (uint16_t)(prof_sum[stage] / prof_count[stage]);
+  
+  emb_itoa(prof_count[stage], pBuffer, 10, 5);
+  pBuffer[5] = ' ';
+  emb_itoa(prof_min[stage], pBuffer + 6, 10, 5);
+  pBuffer[11] = ' ';
+  emb_itoa(avg, pBuffer + 12, 10, 5);
+  pBuffer[17] = ' ';
+  emb_itoa(prof_max[stage], pBuffer + 18, 10, 5);
+  return pBuffer + 23;
+}
+#endif // PROFILE_SUPPORT == 1
+
+
+#if HW_PULSE_SUPPORT == 1
+//---------------------------------------------------------------------------//
+// Hardware pulse outputs
+//
+// TIM2 counts at 16MHz / 16384 = 976.5625Hz (one count is 1.024ms) and is
+// never reloaded, so a pulse is generated with a channel in output compare
+// mode: the channel output is forced to its active level, CCRx is set to
+// the counter value at the end of the pulse, and the channel is set to go
+// inactive on the match. The CCxP polarity bit selects the pin level of the
+// pulse. While CCxE is set the channel drives the pin instead of the ODR.
+
+#define HW_PULSE_MAX_MS		60000 // Longest pulse (58593 TIM2 counts)
+
+uint8_t hw_pulse_channel(uint8_t pin)
+{
+  // Return the TIM2 channel of an IO pin (0 to 15), or 0 if the pin is not
+  // a TIM2 channel pin
+  if (pin == 3) return 1;  // IO4 PD4 TIM2_CH1
+  if (pin == 11) return 2; // IO12 PD3 TIM2_CH2
+  if (pin == 0) return 3;  // IO1 PA3 TIM2_CH3
+  return 0;
+}
+
+
+uint8_t hw_pulse_start(uint8_t pin, uint16_t io_timer, uint8_t control)
+{
+  // Start a pulse of the length given by io_timer (IO_TIMER format) on a
+  // TIM2 channel pin. control is the pin_control byte with the pulse state
+  // of the pin. Returns 1 if the pulse was started, 0 if the pin or the
+  // timer value cannot be used.
+  uint8_t channel;
+  uint8_t polarity;
+  uint16_t compare;
+  uint32_t ms;
+
+  hw_pulse_stop(pin);
+  channel = hw_pulse_channel(pin);
+  if (channel == 0) return 0;
+  if ((io_timer & 0xc000) == 0x0000) ms = (uint32_t)(io_timer & 0x3fff) * 100;
+  else if ((io_timer & 0xc000) == 0x4000) ms = (uint32_t)(io_timer & 0x3fff) * 1000;
+  else return 0;
+  if (ms > HW_PULSE_MAX_MS) return 0;
+
+  // The pin level during the pulse is the ON/OFF bit flipped by the Invert
+  // bit. CCxP = 1 makes the active level low.
+  polarity = 0;
+  if ((((control >> 7) ^ (control >> 2)) & 0x01) == 0) polarity = 1;
+
+  // Read TIM2 high byte first. This latches the low byte.
+  compare = (uint16_t)(TIM2_CNTRH << 8);
+  compare |= TIM2_CNTRL;
+  compare += (uint16_t)((ms * 125) / 128); // ms to 1.024ms TIM2 counts
+
+  // Writing CCRxH disables the compare until CCRxL is written
+  switch (channel) {
+  case 1:
+    TIM2_CCMR1 = (uint8_t)0x50;		// OC1REF forced active
+    TIM2_CCER1 = (uint8_t)((TIM2_CCER1 & 0xf0) | (polarity << 1) | 0x01);
+    TIM2_CCR1H = (uint8_t)(compare >> 8);
+    TIM2_CCR1L = (uint8_t)(compare & 0x00ff);
+    TIM2_SR1 = (uint8_t)(~0x02);	// Clear CC1IF
+    TIM2_CCMR1 = (uint8_t)0x20;		// OC1REF inactive on match
+    break;
+  case 2:
+    TIM2_CCMR2 = (uint8_t)0x50;		// OC2REF forced active
+    TIM2_CCER1 = (uint8_t)((TIM2_CCER1 & 0x0f) | (polarity << 5) | 0x10);
+    TIM2_CCR2H = (uint8_t)(compare >> 8);
+    TIM2_CCR2L = (uint8_t)(compare & 0x00ff);
+    TIM2_SR1 = (uint8_t)(~0x04);	// Clear CC2IF
+    TIM2_CCMR2 = (uint8_t)0x20;		// OC2REF inactive on match
+    break;
+  default:
+    TIM2_CCMR3 = (uint8_t)0x50;		// OC3REF forced active
+    TIM2_CCER2 = (uint8_t)((polarity << 1) | 0x01);
+    TIM2_CCR3H = (uint8_t)(compare >> 8);
+    TIM2_CCR3L = (uint8_t)(compare & 0x00ff);
+    TIM2_SR1 = (uint8_t)(~0x08);	// Clear CC3IF
+    TIM2_CCMR3 = (uint8_t)0x20;		// OC3REF inactive on match
+    break;
+  }
+  return 1;
+}
+
+
+void hw_pulse_stop(uint8_t pin)
+{
+  // Return control of a TIM2 channel pin to the ODR. The ODR must already
+  // hold the level the pin should have.
+  switch (hw_pulse_channel(pin)) {
+  case 1:
+    TIM2_CCER1 &= (uint8_t)(~0x01);
+    TIM2_CCMR1 = (uint8_t)0x00;
+    break;
+  case 2:
+    TIM2_CCER1 &= (uint8_t)(~0x10);
+    TIM2_CCMR2 = (uint8_t)0x00;
+    break;
+  case 3:
+    TIM2_CCER2 &= (uint8_t)(~0x01);
+    TIM2_CCMR3 = (uint8_t)0x00;
+    break;
+  default:
+    break;
+  }
+}
+
+
+uint8_t hw_pulse_running(uint8_t pin)
+{
+  // Return 1 if a pulse started by hw_pulse_start() has not ended yet
+  switch (hw_pulse_channel(pin)) {
+  case 1:
+    return (uint8_t)((TIM2_CCER1 & 0x01) && (TIM2_SR1 & 0x02) == 0);
+  case 2:
+    return (uint8_t)((TIM2_CCER1 & 0x10) && (TIM2_SR1 & 0x04) == 0);
+  case 3:
+    return (uint8_t)((TIM2_CCER2 & 0x01) && (TIM2_SR1 & 0x08) == 0);
+  default:
+    return 0;
+  }
+}
+#endif // HW_PULSE_SUPPORT == 1
+
+
+#if LOW_POWER_IDLE == 1
+#if TASK_SCHEDULER == 0 || ENC28J60_INT_RECEIVE == 0
+  #error "LOW_POWER_IDLE requires TASK_SCHEDULER and ENC28J60_INT_RECEIVE"
+#endif // TASK_SCHEDULER == 0 || ENC28J60_INT_RECEIVE == 0
+//---------------------------------------------------------------------------//
+// Low power idle
+//
+// When the main loop has nothing to do idle_wait() puts the CPU in WAIT
+// mode (wfi) until one of these wake sources fires:
+//   TIM4 update every 1ms. ms_counter and the scheduler deadlines have 1ms
+//     resolution so no deadline is more than 1ms late.
+//   EXTI on Port C for a falling edge of the ENC28J60 -INT pin (PC5), so a
+//     received frame wakes the CPU at once.
+// All peripherals (including TIM1, TIM2 and TIM3) keep running in WAIT mode.
+//
+// In INTERRUPTS_ENABLED builds (PIN_CAPTURE_SUPPORT in the MQTT build, or
+// DEBUG_SUPPORT 15 with UART_TX_BUFFERED) the pin capture and UART TX
+// interrupts also wake the CPU.
+//
+// Other builds run with interrupts masked as they always have. Interrupts
+// are only enabled by the wfi instruction itself and are masked again as
+// soon as the CPU wakes, so the ISRs below never interrupt other code.
+// INTERRUPTS_ENABLED builds leave interrupts enabled after idle_wait() and
+// mask them around the sections that must not be interrupted (for instance
+// the Flash programming in copy_RAM_to_Flash()). The ISRs below do no more
+// than clear the TIM4 flag, and the -INT check in idle_wait() is made with
+// interrupts masked so a wake up cannot be missed.
+
+void idle_init(void)
+{
+  // Configure TIM4 for a 1ms update interrupt:
+  // 16MHz / 2^7 = 125KHz (8us period), count to 125 (ARR = 124)
+  CLK_PCKENR1 |= (uint8_t)0x10; // TIM4 clock enabled
+  TIM4_PSCR = (uint8_t)0x07;
+  TIM4_ARR = (uint8_t)124;
+  TIM4_EGR = (uint8_t)0x01;     // Set UG bit to load the PSCR
+  TIM4_SR = (uint8_t)0x00;      // Clear the UIF
+  TIM4_IER = (uint8_t)0x01;     // Update interrupt enabled
+  TIM4_CR1 = (uint8_t)0x01;     // Enable the counter
+  
+  // Configure the Port C external interrupt for falling edge only
+  // (EXTI_CR1 PCIS = 10) and enable the interrupt on PC5 (ENC28J60 -INT).
+  // EXTI_CR1 can only be written while interrupts are masked. With
+  // PIN_CAPTURE_SUPPORT pin_capture_init() has already set both edges,
+  // which also works for the wake up.
+#if PIN_CAPTURE_SUPPORT == 0 || BUILD_SUPPORT != MQTT_BUILD
+#if INTERRUPTS_ENABLED == 1
+  // Interrupts are already enabled for the UART TX interrupt
+  sim();
+#endif // INTERRUPTS_ENABLED == 1
+  EXTI_CR1 = (uint8_t)((EXTI_CR1 & 0xcf) | 0x20);
+#if INTERRUPTS_ENABLED == 1
+  rim();
+#endif // INTERRUPTS_ENABLED == 1
+#endif // PIN_CAPTURE_SUPPORT == 0 || BUILD_SUPPORT != MQTT_BUILD
+  PC_CR2 |= (uint8_t)0x20;
+}
+
+
+void idle_wait(void)
+{
+  // Enter WAIT mode if no scheduled task is due and the ENC28J60 has no
+  // frame waiting (-INT high). The -INT check is made with interrupts
+  // masked. If -INT falls after the check the EXTI request stays pending
+  // and wfi returns at once.
+  if ((int16_t)(ms_counter - sched_due[sched_head]) >= 0) return;
+  sim();
+  if (PC_IDR & 0x20) {
+    wfi();
+  }
+#if INTERRUPTS_ENABLED == 1
+  // Interrupts are left enabled for the pin capture and UART TX ISRs
+  rim();
+#else // INTERRUPTS_ENABLED == 0
+  sim();
+#endif // INTERRUPTS_ENABLED == 1
+}
+
+
+@far @interrupt void idle_tim4_isr(void)
+{
+  // TIM4 update. Clear UIF; the wake up is all that is needed.
+  TIM4_SR = (uint8_t)0x00;
+}
+
+
+@far @interrupt void idle_exti_portc_isr(void)
+{
+  // ENC28J60 -INT falling edge. The wake up is all that is needed.
+}
+#endif // LOW_POWER_IDLE == 1
@@ -27,6 +27,9 @@
 #define __TIMER_H__
 
 void clock_init(void);
+void clock_poll(void);
+uint32_t clock_ticks(void);
+uint32_t clock_us(void);
 void timer_update(void);
 uint8_t periodic_timer_expired(void);
 uint8_t arp_timer_expired(void);
@@ -34,5 +37,42 @@ uint8_t mqtt_timer_expired(void);
 uint8_t t100ms_timer_expired(void);
 void wait_timer(uint16_t wait);
 
+// Main loop task scheduler
+#define SCHED_MAX_TASKS		8    // Maximum number of tasks
+#define SCHED_NONE		0xff // End of the deadline list
+
+struct sched_task {
+  void (*task)(void);       // Task function
+  uint16_t period;          // Run interval in ms. Must be less than 32768.
+};
+
+uint16_t read_TIM1(void);
+void sched_init(const struct sched_task *tasks, uint8_t num_tasks);
+void sched_insert(uint8_t id);
+void sched_run(void);
+
+// Main loop profiling stages
+#define PROF_RECEIVE		0 // Enc28j60Receive()
+#define PROF_UIP_INPUT		1 // uip_input()
+#define PROF_HTTPD		2 // HttpDCall()
+#define PROF_PUBLISH		3 // publish_outbound()
+#define PROF_TEMPERATURE	4 // get_temperature()
+#define PROF_RUNTIME		5 // check_runtime_changes()
+#define PROF_NUM_STAGES		6
+
+uint16_t clock_elapsed(uint32_t start);
+void prof_init(void);
+void prof_begin(uint8_t stage);
+void prof_end(uint8_t stage);
+uint8_t *prof_format(uint8_t stage, uint8_t *pBuffer);
+
+void idle_init(void);
+void idle_wait(void);
+
+uint8_t hw_pulse_channel(uint8_t pin);
+uint8_t hw_pulse_start(uint8_t pin, uint16_t io_timer, uint8_t control);
+void hw_pulse_stop(uint8_t pin);
+uint8_t hw_pulse_running(uint8_t pin);
+
 #endif /* __TIMER_H__ */
 
@@ -111,6 +111,21 @@
 extern uint8_t OctetArray[14];      // Used in emb_itoa conversions and to
                                     // transfer short strings globally
 extern uint16_t ms_counter;         // Free running ms counter
+#if HTTPD_TX_WINDOW > 1 || UDP_STATUS_SUPPORT == 1
+extern uint16_t Port_Httpd;         // Only httpd connections get a transmit
+                                    // window of more than one segment. Also
+				    // the UDP status service port.
+#endif // HTTPD_TX_WINDOW > 1 || UDP_STATUS_SUPPORT == 1
+#if UDP_LOG_SUPPORT == 1
+extern uip_ipaddr_t udp_log_addr;   // Host the UDP log is sent to
+#endif // UDP_LOG_SUPPORT == 1
+#if UIP_CONN_RESERVE == 1
+extern uint8_t syn_drop_counter;    // Counts SYNs refused for lack of a slot
+#if BUILD_SUPPORT == MQTT_BUILD
+extern uint8_t mqtt_enabled;        // Used to signal use of MQTT functions
+extern uint16_t mqtt_local_port;    // MQTT local port number
+#endif // BUILD_SUPPORT == MQTT_BUILD
+#endif // UIP_CONN_RESERVE == 1
 
 
 /* The IP address of this host */
@@ -184,6 +199,10 @@ static uint8_t iss[4];                // The iss variable is used for the TCP
 uint8_t uip_acc32[4];
 static uint8_t c, opt;
 static uint16_t tmp16;
+#if HTTPD_TX_WINDOW > 1
+static uint16_t segoffset;            // Sequence offset of a new segment sent
+                                      // behind segments already in flight
+#endif // HTTPD_TX_WINDOW > 1
 
 /* Structures and definitions. */
 #define TCP_FIN 0x01
@@ -200,6 +219,18 @@ static uint16_t tmp16;
 
 #define TCP_OPT_MSS_LEN 4   /* Length of TCP MSS option. */
 
+// The retransmission timer of a connection counts UIP_RTX_TICK ms ticks.
+// UIP_RTO_TICKS is UIP_RTO in those ticks.
+#if UIP_FAST_RETRANSMIT == 0
+#define UIP_RTX_TICK    1000
+#define UIP_RTO_TICKS   UIP_RTO
+#endif // UIP_FAST_RETRANSMIT == 0
+#if UIP_FAST_RETRANSMIT == 1
+#define UIP_RTX_TICK    250
+#define UIP_RTO_TICKS   (UIP_RTO * (1000 / UIP_RTX_TICK))
+#define UIP_RTO_MIN     2   /* Smallest rto in ticks (500ms) */
+#endif // UIP_FAST_RETRANSMIT == 1
+
 #define ICMP_ECHO_REPLY 0
 #define ICMP_ECHO       8
 
@@ -217,6 +248,7 @@ static uint16_t tmp16;
 #define BUF ((struct uip_tcpip_hdr *)&uip_buf[UIP_LLH_LEN])
 #define FBUF ((struct uip_tcpip_hdr *)&uip_reassbuf[0])
 #define ICMPBUF ((struct uip_icmpip_hdr *)&uip_buf[UIP_LLH_LEN])
+#define UDPBUF ((struct uip_udpip_hdr *)&uip_buf[UIP_LLH_LEN])
 
 #if NETWORK_STATISTICS == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
 struct uip_stats uip_stat;
@@ -342,6 +374,32 @@ uint16_t uip_tcpchksum(void)
 {
   return upper_layer_chksum(UIP_PROTO_TCP);
 }
+
+
+#if UDP_STATUS_SUPPORT == 1
+//---------------------------------------------------------------------------//
+uint16_t uip_udpchksum(void)
+{
+  return upper_layer_chksum(UIP_PROTO_UDP);
+}
+#endif // UDP_STATUS_SUPPORT == 1
+
+
+#if ENC28J60_DMA_CHECKSUM == 1
+//---------------------------------------------------------------------------//
+uint16_t uip_tcppseudochksum(void)
+{
+  // Sum only the TCP pseudo header. The sum is placed in the TCP checksum
+  // field of an outgoing segment and the ENC28J60 DMA checksum engine then
+  // sums the TCP header and data (including this seed) to produce the
+  // final checksum. See Enc28j60Send().
+  uint16_t sum;
+
+  sum = (((uint16_t)(BUF->len[0]) << 8) + BUF->len[1]) - UIP_IPH_LEN + UIP_PROTO_TCP;
+  sum = chksum(sum, (uint8_t *)&BUF->srcipaddr[0], 2 * sizeof(uip_ipaddr_t));
+  return sum;
+}
+#endif // ENC28J60_DMA_CHECKSUM == 1
 #endif /* UIP_ARCH_CHKSUM */
 
 
@@ -403,13 +461,19 @@ uip_connect(uip_ipaddr_t *ripaddr, uint16_t rport, uint16_t lport)
   conn->snd_nxt[2] = iss[2];
   conn->snd_nxt[3] = iss[3];
   
-  conn->initialmss = conn->mss = UIP_TCP_MSS;
+  conn->initialmss = conn->mss = UIP_TX_MSS;
   
   conn->len = 1;   /* TCP length of the SYN is one. */
+#if HTTPD_TX_WINDOW > 1
+  conn->nseg = 0;
+#endif // HTTPD_TX_WINDOW > 1
   conn->nrtx = 0;
+#if UIP_FAST_RETRANSMIT == 1 && HTTPD_TX_WINDOW > 1
+  conn->dupacks = 0;
+#endif // UIP_FAST_RETRANSMIT == 1 && HTTPD_TX_WINDOW > 1
   conn->timer = 1; /* Send the SYN next time around. */
   conn->ms_tracker = ms_counter; // Time tracker
-  conn->rto = UIP_RTO;
+  conn->rto = UIP_RTO_TICKS;
   conn->sa = 0;
   conn->sv = 16;   /* Initial value of the RTT variance. */
   conn->lport = lport;
@@ -486,15 +550,15 @@ static void uip_add_rcv_nxt(uint16_t n)
 
 
 //---------------------------------------------------------------------------//
-uint8_t timer_check(uint16_t ms_tracker)
+uint8_t timer_check(uint16_t ms_tracker, uint16_t period)
 {
-  // Determine if 1 second has passed for a given connection
+  // Determine if period ms have passed for a given connection
   uint16_t delta_time;
   
   // First check if ms_counter rolled over.
   if (ms_counter < ms_tracker) delta_time = (uint16_t)(ms_counter + (uint16_t)(65535 - ms_tracker));
   else delta_time = (uint16_t)(ms_counter - ms_tracker);
-  if (delta_time > 1000) return 1;
+  if (delta_time > period) return 1;
   return 0;
 }
 
@@ -528,12 +592,29 @@ void uip_process(uint8_t flag)
   // connection. A UIP_POLL_REQUEST will occur without any receive data
   // present, so uip_len should be zero when it occurs.
   if (flag == UIP_POLL_REQUEST) {
+#if UIP_POLL_FAST_PATH == 1
+    // The poll can follow a received packet, so clear the lengths it left.
+    uip_len = 0;
+    uip_slen = 0;
+#endif // UIP_POLL_FAST_PATH == 1
     if ((uip_connr->tcpstateflags & UIP_TS_MASK) == UIP_ESTABLISHED && !uip_outstanding(uip_connr)) {
 // UARTPrintf("  uip.c: APPCALL due to POLL REQUEST\r\n");
       uip_flags = UIP_POLL;
       UIP_APPCALL(); // Check for any data to be sent
       goto appsend;
     }
+#if UIP_POLL_FAST_PATH == 1 && HTTPD_TX_WINDOW > 1
+    else if (uip_connr->lport == Port_Httpd
+          && uip_connr->nseg != 0
+          && uip_connr->nseg < HTTPD_TX_WINDOW
+	  && (uip_connr->tcpstateflags & UIP_TS_MASK) == UIP_ESTABLISHED) {
+      // Data segments are in flight but the transmit window has room for
+      // another one, as in the UIP_TIMER poll below.
+      uip_flags = UIP_POLL;
+      UIP_APPCALL(); // Check for new data to transmit
+      goto appsend;
+    }
+#endif // UIP_POLL_FAST_PATH == 1 && HTTPD_TX_WINDOW > 1
     goto drop;
   }
 
@@ -560,7 +641,7 @@ void uip_process(uint8_t flag)
     if (uip_connr->tcpstateflags == UIP_TIME_WAIT || uip_connr->tcpstateflags == UIP_FIN_WAIT_2) {
 //      ++(uip_connr->timer);
       // Increment the timer if 1 second has passed
-      if (timer_check(uip_connr->ms_tracker) == 1) {
+      if (timer_check(uip_connr->ms_tracker, 1000) == 1) {
         ++(uip_connr->timer);
 	uip_connr->ms_tracker = ms_counter;
       }
@@ -583,9 +664,12 @@ void uip_process(uint8_t flag)
       // UIP_MAXSYNRTX - The maximum number of times a SYN segment should be
       // retransmitted before the connection should be aborted.
 
-      // Increment the timer if 1 second has passed
-      if (timer_check(uip_connr->ms_tracker) == 1) {
-        uip_connr->timer--;
+      // Decrement the timer each time UIP_RTX_TICK ms have passed. The
+      // timer only runs while data is outstanding. That leaves it at rto
+      // for the next segment sent and keeps it from wrapping below zero.
+      if (!uip_outstanding(uip_connr)) uip_connr->ms_tracker = ms_counter;
+      else if (timer_check(uip_connr->ms_tracker, UIP_RTX_TICK) == 1) {
+        if (uip_connr->timer != 0) uip_connr->timer--;
 	uip_connr->ms_tracker = ms_counter;
       }
 
@@ -614,7 +698,7 @@ void uip_process(uint8_t flag)
 	  // backoff will cause it to take longer to get to zero if another
 	  // retransmit will be needed.
 	  if (uip_connr->nrtx > 4) uip_connr->nrtx = 4;
-	  uip_connr->timer = (uint8_t)(UIP_RTO << uip_connr->nrtx);
+	  uip_connr->timer = (uint8_t)(UIP_RTO_TICKS << uip_connr->nrtx);
 
 #if DEBUG_SUPPORT == 15
 // UARTPrintf("uip_connr->timer = ");
@@ -688,6 +772,20 @@ void uip_process(uint8_t flag)
 
           }
         }
+#if HTTPD_TX_WINDOW > 1
+        else if (uip_connr->lport == Port_Httpd
+              && uip_connr->nseg != 0
+              && uip_connr->nseg < HTTPD_TX_WINDOW
+	      && (uip_connr->tcpstateflags & UIP_TS_MASK) == UIP_ESTABLISHED) {
+          // Data segments are in flight but the transmit window has room for
+	  // another one. Poll the httpd for the next segment without waiting
+	  // for the earlier segments to be acknowledged.
+          uip_flags = UIP_POLL;
+          UIP_APPCALL(); // Check for new data to transmit. uip_len was
+	                 // cleared above.
+          goto appsend;
+        }
+#endif // HTTPD_TX_WINDOW > 1
       }
       else if ((uip_connr->tcpstateflags & UIP_TS_MASK) == UIP_ESTABLISHED) {
 // UARTPrintf("  uip.c: periodic APPCALL poll for new data\r\n");
@@ -768,6 +866,13 @@ void uip_process(uint8_t flag)
     goto tcp_input;
   }
 
+#if UDP_STATUS_SUPPORT == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+  if (BUF->proto == UIP_PROTO_UDP) {
+    // Check for UDP packet. If so, proceed with UDP input processing.
+    goto udp_input;
+  }
+#endif // UDP_STATUS_SUPPORT == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+
 
   // ICMPv4 processing code follows.
   if (BUF->proto != UIP_PROTO_ICMP) { // We only allow ICMP packets from here.
@@ -817,6 +922,48 @@ void uip_process(uint8_t flag)
   // End of IPv4 input header processing code.
 
 
+#if UDP_STATUS_SUPPORT == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+  // ----------------------------------------------------------------------- //
+  // UDP input processing. Only the UDP status service is supported, so a
+  // datagram is either answered with one reply datagram or dropped. There
+  // is no connection state.
+  udp_input:
+  {
+    uip_ipaddr_t ripaddr;
+
+    if (UDPBUF->destport != Port_Httpd
+     || UDPBUF->udplen < UIP_UDPH_LEN
+     || UDPBUF->udplen > (uip_len - UIP_IPH_LEN)) {
+      UIP_STAT(++uip_stat.ip.drop);
+      UIP_STAT(++uip_stat.ip.protoerr);
+      goto drop;
+    }
+    // The UDP checksum is optional in IPv4. A checksum of 0 means none was
+    // sent.
+    if (UDPBUF->udpchksum != 0 && uip_udpchksum() != 0xffff) {
+      UIP_STAT(++uip_stat.ip.drop);
+      UIP_STAT(++uip_stat.ip.chkerr);
+      goto drop;
+    }
+
+    uip_sappdata = uip_appdata = &uip_buf[UIP_IPUDPH_LEN + UIP_LLH_LEN];
+    uip_len = UDPBUF->udplen - UIP_UDPH_LEN;
+    uip_slen = 0;
+    udp_status_call();
+    if (uip_slen == 0) goto drop;
+
+    // Send the reply back to the port and address the request came from
+    uip_ipaddr_copy(ripaddr, BUF->srcipaddr);
+#if UDP_LOG_SUPPORT == 1
+    // The UDP log is sent to the last host that made a status request
+    uip_ipaddr_copy(udp_log_addr, ripaddr);
+#endif // UDP_LOG_SUPPORT == 1
+    uip_udp_send(ripaddr, UDPBUF->srcport, Port_Httpd, uip_slen);
+    goto send;
+  }
+#endif // UDP_STATUS_SUPPORT == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+
+
   // ----------------------------------------------------------------------- //
   // TCP input processing. At this point we've determined that incoming data
   // is for us.
@@ -937,26 +1084,50 @@ void uip_process(uint8_t flag)
     }
   }
 
+#if UIP_CONN_RESERVE == 1 && BUILD_SUPPORT == MQTT_BUILD
+  // Keep the last reclaimable slot for the MQTT connection if MQTT does not
+  // hold a slot now (for instance while it is reconnecting). Listening SYNs
+  // are never MQTT as the MQTT connection is always opened by this end.
+  if (uip_connr != 0 && mqtt_enabled) {
+    uint8_t nfree;
+    uint8_t mqtt_held;
+    nfree = 0;
+    mqtt_held = 0;
+    for (c = 0; c < UIP_CONNS; ++c) {
+      if (uip_conns[c].tcpstateflags == UIP_CLOSED
+       || uip_conns[c].tcpstateflags == UIP_TIME_WAIT) nfree++;
+      else if (uip_conns[c].lport == mqtt_local_port) mqtt_held = 1;
+    }
+    if (mqtt_held == 0 && nfree < 2) uip_connr = 0;
+  }
+#endif // UIP_CONN_RESERVE == 1 && BUILD_SUPPORT == MQTT_BUILD
+
   if (uip_connr == 0) {
     // All connections are used already, we drop packet and hope that the
     // remote end will retransmit the packet at a time when we have more spare
     // connections.
     UIP_STAT(++uip_stat.tcp.syndrop);
+#if UIP_CONN_RESERVE == 1
+    syn_drop_counter++;
+#endif // UIP_CONN_RESERVE == 1
     goto drop;
   }
   uip_conn = uip_connr;
 
   // Fill in the necessary fields for the new connection.
-  uip_connr->rto = uip_connr->timer = UIP_RTO;
-  // The "timer" should be tracking seconds, NOT the number of
-  // periodic_service() calls. Using a ms_counter (millisecond counter) and a
-  // ms_tracker (per connection) provides adequate resolution. ms_counter and
-  // ms_tracker are used to determine the passage of 1 second, at which point
-  // the timer value is incremented or decremented as needed.
+  uip_connr->rto = uip_connr->timer = UIP_RTO_TICKS;
+  // The "timer" should be tracking seconds (UIP_RTX_TICK ms ticks), NOT the
+  // number of periodic_service() calls. Using a ms_counter (millisecond
+  // counter) and a ms_tracker (per connection) provides adequate resolution.
+  // ms_counter and ms_tracker are used to determine the passage of a tick,
+  // at which point the timer value is incremented or decremented as needed.
   uip_connr->ms_tracker = ms_counter;
   uip_connr->sa = 0;
   uip_connr->sv = 4;
   uip_connr->nrtx = 0;
+#if UIP_FAST_RETRANSMIT == 1 && HTTPD_TX_WINDOW > 1
+  uip_connr->dupacks = 0;
+#endif // UIP_FAST_RETRANSMIT == 1 && HTTPD_TX_WINDOW > 1
   uip_connr->lport = BUF->destport;
   uip_connr->rport = BUF->srcport;
   uip_ipaddr_copy(uip_connr->ripaddr, BUF->srcipaddr);
@@ -967,6 +1138,9 @@ void uip_process(uint8_t flag)
   uip_connr->snd_nxt[2] = iss[2];
   uip_connr->snd_nxt[3] = iss[3];
   uip_connr->len = 1;
+#if HTTPD_TX_WINDOW > 1
+  uip_connr->nseg = 0;
+#endif // HTTPD_TX_WINDOW > 1
   
   // rcv_nxt should be the seqno from the incoming packet + 1.
   uip_connr->rcv_nxt[3] = BUF->seqno[3];
@@ -975,6 +1149,10 @@ void uip_process(uint8_t flag)
   uip_connr->rcv_nxt[0] = BUF->seqno[0];
   uip_add_rcv_nxt(1);
   
+  // Default transmit MSS in case the host does not send an MSS option. The
+  // TCP default is 536.
+  uip_connr->initialmss = uip_connr->mss = UIP_TX_MSS > 536 ? 536 : UIP_TX_MSS;
+  
   // Parse the TCP MSS option, if present. This is a received SYN, so we are
   // capturing the MSS of the host.
   if ((BUF->tcpoffset & 0xf0) > 0x50) {
@@ -998,13 +1176,12 @@ void uip_process(uint8_t flag)
 	// set the receive MSS and transmit MSS to be the same. So the smaller
 	// of the advertised MSS from the host or the UIP_TCP_MSS would get
 	// used for BOTH transmit and receive. This does not have to be the
-	// case. The host MSS can (and, for this application, always will) be
-	// larger than the application MSS because this application uses such
-	// a small transmit buffer, and hosts always have large buffers. Here
-	// the original code is commented out and replaced with code that
-	// maintains the UIP_TCP_MSS as the receive MSS.
-//        uip_connr->initialmss = uip_connr->mss = tmp16 > UIP_TCP_MSS ? UIP_TCP_MSS : tmp16;
-        uip_connr->initialmss = uip_connr->mss = UIP_TCP_MSS;
+	// case. The receive MSS is always UIP_TCP_MSS (it is what we advertise
+	// in the SYNACK). uip_connr->mss is the transmit MSS and is the
+	// smaller of the host MSS and UIP_TX_MSS, but not less than
+	// UIP_TX_MIN_MSS.
+        if (tmp16 < UIP_TX_MIN_MSS) tmp16 = UIP_TX_MIN_MSS;
+        uip_connr->initialmss = uip_connr->mss = tmp16 > UIP_TX_MSS ? UIP_TX_MSS : tmp16;
 
         // And we are done processing options.
         break;
@@ -1248,7 +1425,29 @@ void uip_process(uint8_t flag)
   // so, we update the sequence number, reset the length of the outstanding
   // data, calculate RTT estimations, and reset the retransmission timer.
   if ((BUF->flags & TCP_ACK) && uip_outstanding(uip_connr)) {
+#if HTTPD_TX_WINDOW > 1
+    // With more than one data segment in flight the ACK may acknowledge only
+    // the oldest segments. Try each segment boundary in turn, ending with
+    // all outstanding data. tmp16 is left at the number of bytes acknow-
+    // ledged and c at the number of segments acknowledged. A SYN or FIN has
+    // no segments and only the full length is tried.
+    tmp16 = 0;
+    c = 0;
+    do {
+      if (c < uip_connr->nseg) {
+        tmp16 += uip_connr->seglen[(uip_connr->seghead + c) % HTTPD_TX_WINDOW];
+      }
+      else tmp16 = uip_connr->len;
+      c++;
+      uip_add32(uip_connr->snd_nxt, tmp16);
+      if (BUF->ackno[0] == uip_acc32[0]
+        && BUF->ackno[1] == uip_acc32[1]
+        && BUF->ackno[2] == uip_acc32[2]
+        && BUF->ackno[3] == uip_acc32[3]) break;
+    } while (tmp16 < uip_connr->len);
+#else // HTTPD_TX_WINDOW == 1
     uip_add32(uip_connr->snd_nxt, uip_connr->len);
+#endif // HTTPD_TX_WINDOW > 1
     if (BUF->ackno[0] == uip_acc32[0]
       && BUF->ackno[1] == uip_acc32[1]
       && BUF->ackno[2] == uip_acc32[2]
@@ -1271,16 +1470,47 @@ void uip_process(uint8_t flag)
         m = (int8_t)(m - (uip_connr->sv >> 2));
         uip_connr->sv += m;
         uip_connr->rto = (uint8_t)((uip_connr->sa >> 3) + uip_connr->sv);
+#if UIP_FAST_RETRANSMIT == 1
+        if (uip_connr->rto < UIP_RTO_MIN) uip_connr->rto = UIP_RTO_MIN;
+#endif // UIP_FAST_RETRANSMIT == 1
       }
 
       // Set the acknowledged flag.
       uip_flags = UIP_ACKDATA;
       // Reset the retransmission timer.
       uip_connr->timer = uip_connr->rto;
-
+#if UIP_FAST_RETRANSMIT == 1 && HTTPD_TX_WINDOW > 1
+      uip_connr->dupacks = 0;
+#endif // UIP_FAST_RETRANSMIT == 1 && HTTPD_TX_WINDOW > 1
+
+#if HTTPD_TX_WINDOW > 1
+      // Remove the acknowledged segments from the outstanding data.
+      uip_connr->len -= tmp16;
+      if (c > uip_connr->nseg) c = uip_connr->nseg;
+      uip_connr->seghead = (uint8_t)((uip_connr->seghead + c) % HTTPD_TX_WINDOW);
+      uip_connr->nseg -= c;
+#else // HTTPD_TX_WINDOW == 1
       // Reset length of outstanding data.
       uip_connr->len = 0;
+#endif // HTTPD_TX_WINDOW > 1
     }
+#if UIP_FAST_RETRANSMIT == 1 && HTTPD_TX_WINDOW > 1
+    else if (uip_len == 0
+      && uip_connr->nseg > 1
+      && (BUF->flags & (TCP_SYN | TCP_FIN)) == 0
+      && BUF->ackno[0] == uip_connr->snd_nxt[0]
+      && BUF->ackno[1] == uip_connr->snd_nxt[1]
+      && BUF->ackno[2] == uip_connr->snd_nxt[2]
+      && BUF->ackno[3] == uip_connr->snd_nxt[3]) {
+      // A duplicate ACK while more than one segment is outstanding. After
+      // three of them the peer has received three segments after the
+      // oldest outstanding one, so that segment was lost. Expire the
+      // retransmission timer so the next uip_periodic() call resends it
+      // instead of waiting for rto. A single duplicate ACK may only be a
+      // window update or a delayed ACK.
+      if (++(uip_connr->dupacks) == 3) uip_connr->timer = 0;
+    }
+#endif // UIP_FAST_RETRANSMIT == 1 && HTTPD_TX_WINDOW > 1
   }
   
   // Do different things depending on in what state the connection is.
@@ -1343,14 +1573,12 @@ void uip_process(uint8_t flag)
 	      // would set the receive MSS and transmit MSS to be the same. So
 	      // the smaller of the advertised MSS from the host or the
 	      // UIP_TCP_MSS would get used for BOTH transmit and receive. This
-	      // does not have to be the case. The host MSS can (and, for this
-	      // application, always will) be larger than the application MSS
-	      // because this application uses such a small transmit buffer,
-	      // and hosts always have large buffers. Here the original code is
-	      // commented out and replaced with code that maintains the
-	      // UIP_TCP_MSS as the receive MSS.
-	      // uip_connr->initialmss = uip_connr->mss = tmp16 > UIP_TCP_MSS? UIP_TCP_MSS: tmp16;
-	      uip_connr->initialmss = uip_connr->mss = UIP_TCP_MSS;
+	      // does not have to be the case. The receive MSS is always
+	      // UIP_TCP_MSS (it is what we advertise in the SYN).
+	      // uip_connr->mss is the transmit MSS and is the smaller of the
+	      // host MSS and UIP_TX_MSS, but not less than UIP_TX_MIN_MSS.
+	      if (tmp16 < UIP_TX_MIN_MSS) tmp16 = UIP_TX_MIN_MSS;
+	      uip_connr->initialmss = uip_connr->mss = tmp16 > UIP_TX_MSS ? UIP_TX_MSS : tmp16;
 
 	      // And we are done processing options
 	      break;
@@ -1530,6 +1758,9 @@ void uip_process(uint8_t flag)
         if (uip_flags & UIP_CLOSE) {
           uip_slen = 0;
 	  uip_connr->len = 1;
+#if HTTPD_TX_WINDOW > 1
+	  uip_connr->nseg = 0;
+#endif // HTTPD_TX_WINDOW > 1
 	  uip_connr->tcpstateflags = UIP_FIN_WAIT_1;
 	  uip_connr->nrtx = 0;
 	  BUF->flags = TCP_FIN | TCP_ACK;
@@ -1541,6 +1772,35 @@ void uip_process(uint8_t flag)
 #if DEBUG_SUPPORT == 15
 // UARTPrintf("uip.c uip_slen > 0\r\n");
 #endif // DEBUG_SUPPORT == 15
+#if HTTPD_TX_WINDOW > 1
+          // The ACK processing above has already removed acknowledged
+	  // segments from the ->len variable. An httpd connection may add a
+	  // segment behind the segments already in transit as long as the
+	  // transmit window has room. The new segment is sent with a sequence
+	  // number offset by the data already in transit.
+	  if (uip_connr->len == 0
+	   || (uip_connr->lport == Port_Httpd
+	    && uip_connr->nseg != 0
+	    && uip_connr->nseg < HTTPD_TX_WINDOW)) {
+	    segoffset = uip_connr->len;
+	    uip_connr->seglen[(uip_connr->seghead + uip_connr->nseg) % HTTPD_TX_WINDOW] = uip_slen;
+	    uip_connr->nseg++;
+	    uip_connr->len += uip_slen;
+	  }
+	  else {
+	    // If the application already had unacknowledged data, we make
+	    // sure that the application does not send (i.e., retransmit) out
+	    // more than the oldest segment it previously sent out.
+	    uip_slen = uip_connr->seglen[uip_connr->seghead];
+	  }
+        }
+	// The retransmission count is restarted when data is acknowledged or
+	// no older segment is still in transit, but not when a segment is
+	// only added behind a segment that is being retransmitted.
+	if ((uip_flags & UIP_ACKDATA) || uip_connr->len == uip_slen) {
+	  uip_connr->nrtx = 0;
+	}
+#else // HTTPD_TX_WINDOW == 1
           // If the connection has acknowledged data, the contents of the
 	  // ->len variable should be discarded.
 	  if ((uip_flags & UIP_ACKDATA) != 0) {
@@ -1580,6 +1840,7 @@ void uip_process(uint8_t flag)
 	  }
         }
 	uip_connr->nrtx = 0;
+#endif // HTTPD_TX_WINDOW > 1
 
 
 
@@ -1590,8 +1851,18 @@ void uip_process(uint8_t flag)
 	// If the application has data to be sent, or if the incoming packet
 	// had new data in it, we must send out a packet.
 	if (uip_slen > 0 && uip_connr->len > 0) {
+#if HTTPD_TX_WINDOW > 1
+	  // A retransmit resends only the oldest segment in transit. Other
+	  // sends are the length of the new segment.
+	  if (uip_flags & UIP_REXMIT) {
+	    uip_slen = uip_connr->seglen[uip_connr->seghead];
+	  }
+	  // Add the length of the IP and TCP headers.
+	  uip_len = uip_slen + UIP_TCPIP_HLEN;
+#else // HTTPD_TX_WINDOW == 1
 	  // Add the length of the IP and TCP headers.
 	  uip_len = uip_connr->len + UIP_TCPIP_HLEN;
+#endif // HTTPD_TX_WINDOW > 1
 	  // We always set the ACK flag in response packets.
 	  BUF->flags = TCP_ACK | TCP_PSH;
 	  // Send the packet.
@@ -1754,10 +2025,20 @@ UARTPrintf("  uip.c: UIP_CLOSING\r\n");
   BUF->ackno[2] = uip_connr->rcv_nxt[2];
   BUF->ackno[3] = uip_connr->rcv_nxt[3];
 
+#if HTTPD_TX_WINDOW > 1
+  // A segment sent behind segments already in transit starts after them.
+  uip_add32(uip_connr->snd_nxt, segoffset);
+  segoffset = 0;
+  BUF->seqno[0] = uip_acc32[0];
+  BUF->seqno[1] = uip_acc32[1];
+  BUF->seqno[2] = uip_acc32[2];
+  BUF->seqno[3] = uip_acc32[3];
+#else // HTTPD_TX_WINDOW == 1
   BUF->seqno[0] = uip_connr->snd_nxt[0];
   BUF->seqno[1] = uip_connr->snd_nxt[1];
   BUF->seqno[2] = uip_connr->snd_nxt[2];
   BUF->seqno[3] = uip_connr->snd_nxt[3];
+#endif // HTTPD_TX_WINDOW > 1
 
   BUF->proto = UIP_PROTO_TCP;
   
@@ -1790,9 +2071,18 @@ UARTPrintf("  uip.c: UIP_CLOSING\r\n");
 
   BUF->urgp[0] = BUF->urgp[1] = 0;
 
+#if ENC28J60_DMA_CHECKSUM == 1
+  // Seed the TCP checksum with the pseudo header sum. The checksum over the
+  // TCP header and data is completed by the ENC28J60 when the frame is in
+  // its transmit buffer.
+  BUF->tcpchksum = uip_tcppseudochksum();
+#else // ENC28J60_DMA_CHECKSUM == 0
   // Calculate TCP checksum.
   BUF->tcpchksum = 0;
   BUF->tcpchksum = ~(uip_tcpchksum());
+#endif // ENC28J60_DMA_CHECKSUM == 1
+
+  UIP_STAT(++uip_stat.tcp.sent);
 
 
 
@@ -1809,8 +2099,6 @@ UARTPrintf("  uip.c: UIP_CLOSING\r\n");
   BUF->ipchksum = 0;
   BUF->ipchksum = ~(uip_ipchksum());
 
-  UIP_STAT(++uip_stat.tcp.sent);
-
 
 
 
@@ -1852,3 +2140,41 @@ void uip_send(const char *data, int len)
     }
   }
 }
+
+
+#if UDP_STATUS_SUPPORT == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+//---------------------------------------------------------------------------//
+void uip_udp_send(uint16_t *ripaddr, uint16_t rport, uint16_t lport, uint16_t len)
+{
+  // Build the IP and UDP headers for a datagram of len bytes already placed
+  // in the uip_buf after the headers (at &uip_buf[UIP_LLH_LEN +
+  // UIP_IPUDPH_LEN]). uip_len is set so the caller can do the uip_arp_out()
+  // and the transmission.
+  uip_len = len + UIP_IPUDPH_LEN;
+
+  BUF->vhl = 0x45;
+  BUF->tos = 0;
+  BUF->len[0] = (uint8_t)(uip_len >> 8);
+  BUF->len[1] = (uint8_t)(uip_len & 0xff);
+  ++ipid;
+  BUF->ipid[0] = (uint8_t)(ipid >> 8);
+  BUF->ipid[1] = (uint8_t)(ipid & 0xff);
+  BUF->ipoffset[0] = BUF->ipoffset[1] = 0;
+  BUF->ttl = UIP_TTL;
+  BUF->proto = UIP_PROTO_UDP;
+  // The destination is copied first as ripaddr may point at the source
+  // address of a received datagram
+  uip_ipaddr_copy(BUF->destipaddr, ripaddr);
+  uip_ipaddr_copy(BUF->srcipaddr, uip_hostaddr);
+  BUF->ipchksum = 0;
+  BUF->ipchksum = ~(uip_ipchksum());
+
+  UDPBUF->srcport = lport;
+  UDPBUF->destport = rport;
+  UDPBUF->udplen = len + UIP_UDPH_LEN;
+  UDPBUF->udpchksum = 0;
+  UDPBUF->udpchksum = ~(uip_udpchksum());
+  // A calculated checksum of 0 is sent as 0xffff as 0 means no checksum
+  if (UDPBUF->udpchksum == 0) UDPBUF->udpchksum = 0xffff;
+}
+#endif // UDP_STATUS_SUPPORT == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
@@ -434,6 +434,15 @@ struct uip_conn *uip_connect(uip_ipaddr_t *ripaddr, uint16_t rport, uint16_t lpo
 #define uip_outstanding(conn) ((conn)->len)
 
 
+/**
+ * Get the number of data segments the current connection has in flight and
+ * the seglen index of the oldest of them. Only available if HTTPD_TX_WINDOW
+ * is greater than 1.
+ */
+#define uip_segments()        (uip_conn->nseg)
+#define uip_oldest_segment()  (uip_conn->seghead)
+
+
 /**
  * Send data on the current connection.
  * This function is used to send out a single segment of TCP data. Only
@@ -912,6 +921,16 @@ struct uip_conn {
   uint16_t ms_tracker;   // Tracks time in milliseconds to service the retrans-
                          // nmission timer.
   uint8_t nrtx;          // The number of retransmissions for the last segment sent.
+#if UIP_FAST_RETRANSMIT == 1 && HTTPD_TX_WINDOW > 1
+  uint8_t dupacks;       // The number of duplicate ACKs for the oldest
+                         // outstanding segment.
+#endif // UIP_FAST_RETRANSMIT == 1 && HTTPD_TX_WINDOW > 1
+#if HTTPD_TX_WINDOW > 1
+  uint16_t seglen[HTTPD_TX_WINDOW]; // Lengths of the data segments in flight.
+  uint8_t seghead;       // Index in seglen of the oldest segment in flight.
+  uint8_t nseg;          // The number of data segments in flight. The sum of
+                         // their lengths is len.
+#endif // HTTPD_TX_WINDOW > 1
 
   /** The application state. */
   uip_tcp_appstate_t appstate;
@@ -1025,12 +1044,12 @@ extern uint8_t uip_flags;
 /* The connection has been aborted due to too many retransmissions. */
 
 
-/* uint8_t timer_check(uint16_t ms_tracker)
+/* uint8_t timer_check(uint16_t ms_tracker, uint16_t period)
 *
-* Determines if 1 second has passed for a given connection.
+* Determines if period ms have passed for a given connection.
 *
 */
-uint8_t timer_check(uint16_t ms_tracker);
+uint8_t timer_check(uint16_t ms_tracker, uint16_t period);
 
 
 /* uip_process(flag):
@@ -1117,6 +1136,28 @@ struct uip_icmpip_hdr {
 };
 
 
+/* The UDP and IP headers. */
+struct uip_udpip_hdr {
+  /* IPv4 header. */
+  uint8_t vhl,
+    tos,
+    len[2],
+    ipid[2],
+    ipoffset[2],
+    ttl,
+    proto;
+  uint16_t ipchksum;
+  uint16_t srcipaddr[2],
+    destipaddr[2];
+  
+  /* UDP header. */
+  uint16_t srcport,
+    destport;
+  uint16_t udplen;
+  uint16_t udpchksum;
+};
+
+
 /**
  * The buffer size available for user data in the uip_buf buffer.
  * This macro holds the available size for user data in the uip_buf buffer.
@@ -1140,6 +1181,8 @@ struct uip_icmpip_hdr {
 #define UIP_TCPH_LEN   20  /* Size of TCP header */
 #define UIP_IPTCPH_LEN (UIP_TCPH_LEN + UIP_IPH_LEN)  /* Size of IP + TCP header */
 #define UIP_TCPIP_HLEN UIP_IPTCPH_LEN
+#define UIP_UDPH_LEN   8   /* Size of UDP header */
+#define UIP_IPUDPH_LEN (UIP_UDPH_LEN + UIP_IPH_LEN)  /* Size of IP + UDP header */
 
 
 extern uip_ipaddr_t uip_hostaddr, uip_netmask, uip_draddr;
@@ -1181,5 +1224,24 @@ uint16_t uip_ipchksum(void);
  */
 uint16_t uip_tcpchksum(void);
 
+/**
+ * Calculate the UDP checksum of the datagram in uip_buf.
+ * The UDP checksum is calculated the same way as the TCP checksum, over the
+ * UDP header and data and the pseudo-header.
+ * return - The UDP checksum of the UDP datagram in uip_buf.
+ */
+uint16_t uip_udpchksum(void);
+
+/**
+ * Build the IP and UDP headers of a datagram.
+ * The len bytes of UDP data must already be in the uip_buf after the IP and
+ * UDP headers. uip_len is set to the length of the IP packet.
+ * ripaddr - Destination IP address.
+ * rport - Destination port.
+ * lport - Source port.
+ * len - Length of the UDP data.
+ */
+void uip_udp_send(uint16_t *ripaddr, uint16_t rport, uint16_t lport, uint16_t len);
+
 
 #endif /* __UIP_H__ */
@@ -60,6 +60,9 @@ extern uint16_t mqtt_local_port;
 extern struct mqtt_client mqttclient; // Pointer to MQTT client declared in main.c
 extern uint8_t mqtt_start;
 extern uint8_t mqtt_close_tcp;
+#if STACK_MONITOR == 1
+extern uint16_t mqtt_sendbuf_peak;    // Most mqtt_sendbuf message data in use
+#endif // STACK_MONITOR == 1
 #endif // BUILD_SUPPORT == MQTT_BUILD
 
 void uip_TcpAppHubCall(void)
@@ -79,7 +82,13 @@ void uip_TcpAppHubCall(void)
 
 // UARTPrintf("uip_tcpapphub Browser call\r\n");
 
+#if PROFILE_SUPPORT == 1
+    prof_begin(PROF_HTTPD);
+#endif // PROFILE_SUPPORT == 1
     HttpDCall(uip_appdata, uip_datalen(), &uip_conn->appstate.HttpDSocket);
+#if PROFILE_SUPPORT == 1
+    prof_end(PROF_HTTPD);
+#endif // PROFILE_SUPPORT == 1
   }
 
 #if BUILD_SUPPORT == MQTT_BUILD
@@ -99,6 +108,13 @@ void uip_TcpAppHubCall(void)
 
     if (mqtt_start > MQTT_START_QUEUE_CONNECT) {
       // Only call mqtt_sync if we know the client has been initialized
+#if STACK_MONITOR == 1
+      // Every queued message passes through here before it is sent, so
+      // this is where the mqtt_sendbuf is fullest.
+      if ((uint16_t)(MQTT_MQ_DATA_SIZE - mqttclient.mq.curr_sz) > mqtt_sendbuf_peak) {
+        mqtt_sendbuf_peak = (uint16_t)(MQTT_MQ_DATA_SIZE - mqttclient.mq.curr_sz);
+      }
+#endif // STACK_MONITOR == 1
       mqtt_sync(&mqttclient);
       // If mqtt_close_tcp == 1 we are forcing a TCP connection close on return
       // to the UIP code. Note that the uip_TcpAppHubCall() function can only
@@ -144,4 +144,14 @@ uint16_t uip_ipchksum(void);
  */
 uint16_t uip_tcpchksum(void);
 
+/**
+ * Calculate the sum of the TCP pseudo header of the packet in uip_buf.
+ *
+ * Used with ENC28J60_DMA_CHECKSUM to seed the TCP checksum field so that
+ * the ENC28J60 can complete the checksum over the TCP header and data.
+ *
+ * return - The (uncomplemented) one's complement sum of the pseudo header.
+ */
+uint16_t uip_tcppseudochksum(void);
+
 #endif /* __UIP_ARCH_H__ */
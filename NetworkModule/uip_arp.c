@@ -115,6 +115,9 @@ struct arp_entry {
   uint16_t ipaddr[2];
   struct uip_eth_addr ethaddr;
   uint8_t time;
+#if ARP_PINNED_ENTRIES == 1
+  uint8_t used; // arptime of the last lookup, for LRU replacement
+#endif // ARP_PINNED_ENTRIES == 1
 };
 
 static const struct uip_eth_addr broadcast_ethaddr =
@@ -128,9 +131,78 @@ static uint8_t i, c;
 static uint8_t arptime;
 static uint8_t tmpage;
 
+#if ARP_MISS_QUEUE == 1
+// Length of the frame parked in the ENC28J60 by uip_arp_out() (0 if none)
+// and the address of the ARP request sent in its place
+static uint16_t arp_parked_len;
+static uint16_t arp_parked_ipaddr[2];
+#endif // ARP_MISS_QUEUE == 1
+
 #define BUF   ((struct arp_hdr *)&uip_buf[0])
 #define IPBUF ((struct ethip_hdr *)&uip_buf[0])
 
+
+#if ARP_PINNED_ENTRIES == 1
+//---------------------------------------------------------------------------//
+static uint8_t
+arp_pinned(uint16_t *addr)
+{
+  // Returns 1 if the address is the default router or the MQTT Server. These
+  // entries carry all off-network and MQTT traffic so they are never evicted.
+  if(uip_ipaddr_cmp(addr, uip_draddr)) return 1;
+  if((uip_mqttserveraddr[0] | uip_mqttserveraddr[1]) != 0 &&
+     uip_ipaddr_cmp(addr, uip_mqttserveraddr)) return 1;
+  return 0;
+}
+
+
+//---------------------------------------------------------------------------//
+static void
+arp_refresh(struct arp_entry *tabptr)
+{
+  // Build a unicast ARP request to the MAC address already in the table
+  // entry so the entry is renewed by the reply before it ages out.
+  memcpy(BUF->ethhdr.dest.addr, tabptr->ethaddr.addr, 6);
+  memset(BUF->dhwaddr.addr, 0x00, 6);
+  memcpy(BUF->ethhdr.src.addr, uip_ethaddr.addr, 6);
+  memcpy(BUF->shwaddr.addr, uip_ethaddr.addr, 6);
+  uip_ipaddr_copy(BUF->dipaddr, tabptr->ipaddr);
+  uip_ipaddr_copy(BUF->sipaddr, uip_hostaddr);
+  BUF->opcode = ARP_REQUEST;
+  BUF->hwtype = ARP_HWTYPE_ETH;
+  BUF->protocol = UIP_ETHTYPE_IP;
+  BUF->hwlen = 6;
+  BUF->protolen = 4;
+  BUF->ethhdr.type = UIP_ETHTYPE_ARP;
+  uip_len = sizeof(struct arp_hdr);
+}
+#endif // ARP_PINNED_ENTRIES == 1
+
+#if PHY_LINK_MONITOR == 1
+//---------------------------------------------------------------------------//
+void
+uip_arp_announce(void)
+{
+  // Build a gratuitous ARP request, broadcast with our IP address as both
+  // sender and target, so the switch and the hosts on the network relearn
+  // our MAC address after the link comes back up.
+  memcpy(BUF->ethhdr.dest.addr, broadcast_ethaddr.addr, 6);
+  memset(BUF->dhwaddr.addr, 0x00, 6);
+  memcpy(BUF->ethhdr.src.addr, uip_ethaddr.addr, 6);
+  memcpy(BUF->shwaddr.addr, uip_ethaddr.addr, 6);
+  uip_ipaddr_copy(BUF->dipaddr, uip_hostaddr);
+  uip_ipaddr_copy(BUF->sipaddr, uip_hostaddr);
+  BUF->opcode = ARP_REQUEST;
+  BUF->hwtype = ARP_HWTYPE_ETH;
+  BUF->protocol = UIP_ETHTYPE_IP;
+  BUF->hwlen = 6;
+  BUF->protolen = 4;
+  BUF->ethhdr.type = UIP_ETHTYPE_ARP;
+  uip_len = sizeof(struct arp_hdr);
+}
+#endif // PHY_LINK_MONITOR == 1
+
+
 //---------------------------------------------------------------------------//
 /**
  * Initialize the ARP module.
@@ -157,6 +229,10 @@ uip_arp_init(void)
  * calls. Any entry that has exceeded the UIP_ARP_MAXAGE without being accessed is
  * cleared. UIP_ARP_MAXAGE is typically 20 minutes.
  *
+ * With ARP_PINNED_ENTRIES a unicast ARP request for a pinned entry that is
+ * within UIP_ARP_REFRESH of UIP_ARP_MAXAGE is left in uip_buf[]. When the
+ * function returns the caller should send the packet if uip_len > 0.
+ *
  */
 //---------------------------------------------------------------------------//
 void
@@ -165,8 +241,26 @@ uip_arp_timer(void)
   struct arp_entry *tabptr;
   
   ++arptime;
+#if ARP_PINNED_ENTRIES == 1
+  uip_len = 0;
+#endif // ARP_PINNED_ENTRIES == 1
+#if ARP_MISS_QUEUE == 1
+  // A parked frame whose ARP reply has not arrived by now is left to the
+  // uip retransmit.
+  arp_parked_len = 0;
+#endif // ARP_MISS_QUEUE == 1
   for(i = 0; i < UIP_ARPTAB_SIZE; ++i) {
     tabptr = &arp_table[i];
+#if ARP_PINNED_ENTRIES == 1
+    // Only one request fits in uip_buf, so a second pinned entry that is due
+    // is refreshed on the next tick.
+    if(uip_len == 0 &&
+       (tabptr->ipaddr[0] | tabptr->ipaddr[1]) != 0 &&
+       arptime - tabptr->time >= UIP_ARP_MAXAGE - UIP_ARP_REFRESH &&
+       arp_pinned(tabptr->ipaddr)) {
+      arp_refresh(tabptr);
+    }
+#endif // ARP_PINNED_ENTRIES == 1
     if((tabptr->ipaddr[0] | tabptr->ipaddr[1]) != 0 &&
        arptime - tabptr->time >= UIP_ARP_MAXAGE) {
       memset(tabptr->ipaddr, 0, 4);
@@ -198,6 +292,9 @@ uip_arp_update(uint16_t *ipaddr, struct uip_eth_addr *ethaddr)
 	/* An old entry found, update this and return. */
 	memcpy(tabptr->ethaddr.addr, ethaddr->addr, 6);
 	tabptr->time = arptime;
+#if ARP_PINNED_ENTRIES == 1
+	tabptr->used = arptime;
+#endif // ARP_PINNED_ENTRIES == 1
 
 	return;
       }
@@ -219,6 +316,7 @@ uip_arp_update(uint16_t *ipaddr, struct uip_eth_addr *ethaddr)
   /* If no unused entry is found, we try to find the oldest entry and
      throw it away. */
   if(i == UIP_ARPTAB_SIZE) {
+#if ARP_PINNED_ENTRIES == 0
     tmpage = 0;
     c = 0;
     for(i = 0; i < UIP_ARPTAB_SIZE; ++i) {
@@ -228,6 +326,22 @@ uip_arp_update(uint16_t *ipaddr, struct uip_eth_addr *ethaddr)
 	c = i;
       }
     }
+#endif // ARP_PINNED_ENTRIES == 0
+#if ARP_PINNED_ENTRIES == 1
+    // Throw away the least recently used entry that is not pinned. At most
+    // two entries are pinned so one is always found.
+    tmpage = 0;
+    c = UIP_ARPTAB_SIZE;
+    for(i = 0; i < UIP_ARPTAB_SIZE; ++i) {
+      tabptr = &arp_table[i];
+      if(arp_pinned(tabptr->ipaddr)) continue;
+      if(c == UIP_ARPTAB_SIZE || arptime - tabptr->used > tmpage) {
+	tmpage = (uint8_t)(arptime - tabptr->used);
+	c = i;
+      }
+    }
+    if(c == UIP_ARPTAB_SIZE) c = 0;
+#endif // ARP_PINNED_ENTRIES == 1
     i = c;
     tabptr = &arp_table[i];
   }
@@ -237,6 +351,9 @@ uip_arp_update(uint16_t *ipaddr, struct uip_eth_addr *ethaddr)
   memcpy(tabptr->ipaddr, ipaddr, 4);
   memcpy(tabptr->ethaddr.addr, ethaddr->addr, 6);
   tabptr->time = arptime;
+#if ARP_PINNED_ENTRIES == 1
+  tabptr->used = arptime;
+#endif // ARP_PINNED_ENTRIES == 1
 }
 
 
@@ -319,6 +436,20 @@ uip_arp_arpin(void)
        for us. */
     if(uip_ipaddr_cmp(BUF->dipaddr, uip_hostaddr)) {
       uip_arp_update(BUF->sipaddr, &BUF->shwaddr);
+#if ARP_MISS_QUEUE == 1
+      if(arp_parked_len != 0 && uip_ipaddr_cmp(BUF->sipaddr, arp_parked_ipaddr)) {
+        // This is the reply for the parked frame. Bring it back into the
+        // uip_buf, complete its Ethernet header and leave it for sending.
+        struct uip_eth_addr ethaddr;
+        memcpy(ethaddr.addr, BUF->shwaddr.addr, 6);
+        Enc28j60UnparkFrame(uip_buf, arp_parked_len);
+        memcpy(IPBUF->ethhdr.dest.addr, ethaddr.addr, 6);
+        memcpy(IPBUF->ethhdr.src.addr, uip_ethaddr.addr, 6);
+        IPBUF->ethhdr.type = UIP_ETHTYPE_IP;
+        uip_len = arp_parked_len;
+        arp_parked_len = 0;
+      }
+#endif // ARP_MISS_QUEUE == 1
     }
     break;
   }
@@ -392,6 +523,19 @@ uip_arp_out(void)
     if(i == UIP_ARPTAB_SIZE) {
       // The destination address was not in our ARP table, so we overwrite the
       // IP packet with an ARP request.
+#if ARP_MISS_QUEUE == 1
+      // Park the IP packet in the ENC28J60 first. It is sent by
+      // uip_arp_arpin() when the ARP reply arrives. The frame must fit both
+      // the park area and the uip_buf it is read back into. A larger frame
+      // (possible with HTTPD_TX_WRITE_THROUGH) is dropped as it would be
+      // without ARP_MISS_QUEUE, and TCP retransmits it later.
+      arp_parked_len = (uint16_t)(uip_len + sizeof(struct uip_eth_hdr));
+      if (arp_parked_len <= ENC28J60_PARKSIZE && arp_parked_len <= UIP_BUFSIZE) {
+        uip_ipaddr_copy(arp_parked_ipaddr, ipaddr);
+        Enc28j60ParkFrame(uip_buf, arp_parked_len);
+      }
+      else arp_parked_len = 0;
+#endif // ARP_MISS_QUEUE == 1
       
       memset(BUF->ethhdr.dest.addr, 0xff, 6);
       memset(BUF->dhwaddr.addr, 0x00, 6);
@@ -420,6 +564,10 @@ uip_arp_out(void)
       return;
     }
 
+#if ARP_PINNED_ENTRIES == 1
+    tabptr->used = arptime;
+#endif // ARP_PINNED_ENTRIES == 1
+
     /* Build an ethernet header. */
     memcpy(IPBUF->ethhdr.dest.addr, tabptr->ethaddr.addr, 6);
   }
@@ -114,14 +114,23 @@ void uip_arp_arpin(void);
    address (or the IP address of the default router) is present. If no
    such table entry is found, the IP packet is overwritten with an ARP
    request and we rely on TCP to retransmit the packet that was
-   overwritten. In any case, the uip_len variable holds the length of
+   overwritten. With ARP_MISS_QUEUE the packet is first parked in the
+   ENC28J60 and uip_arp_arpin() returns it for sending when the ARP
+   reply arrives. In any case, the uip_len variable holds the length of
    the Ethernet frame that should be transmitted. */
 void uip_arp_out(void);
 
 /* The uip_arp_timer() function should be called every ten seconds. It
-   is responsible for flushing old entries in the ARP table. */
+   is responsible for flushing old entries in the ARP table. With
+   ARP_PINNED_ENTRIES it may also leave a unicast ARP request in uip_buf
+   that should be sent out if uip_len is > 0. */
 void uip_arp_timer(void);
 
+/* The uip_arp_announce() function builds a gratuitous ARP request for
+   our own IP address in the uip_buf (PHY_LINK_MONITOR). The caller
+   should send it out on the Ethernet. */
+void uip_arp_announce(void);
+
 
 /**
  * Specifiy the Ethernet MAC address.
@@ -79,7 +79,6 @@
 
 #include "uip_types.h"
 #include "Enc28j60.h"
-#include "uip_TcpAppHub.h"
 #include "uipopt.h"
 
 
@@ -100,7 +99,8 @@
 // connections are statically allocated, turning this configuration knob down
 // results in less RAM used. Each TCP connection requires approximately 40
 // bytes of memory.
-#define UIP_CONNS       4
+//   Comment MN: Set by RAM_PROFILE.
+#define UIP_CONNS       RAM_CONNS
 
 
 // The maximum number of simultaneously listening TCP ports. Each listening
@@ -112,7 +112,7 @@
 //   listen ports table. It is handled separately. However, MQTT DOES require
 //   an entry in the uip_conns table. So, when MQTT is in use there can be a
 //   maximum of 3 Browser connections.
-#define UIP_LISTENPORTS 4
+#define UIP_LISTENPORTS RAM_CONNS
 
 
 // The initial retransmission timeout counted in seconds.
@@ -163,9 +163,41 @@
 #define UIP_TCP_MSS     (UIP_BUFSIZE - UIP_LLH_LEN - UIP_TCPIP_HLEN - 6 - MQTT_PBUF_SIZE)
 
 
+// The transmit Maximum Segment size. UIP_TCP_MSS above is the receive MSS
+// and is what we advertise to the remote host in our SYN / SYNACK. The
+// transmit direction does not need the same limit: the remote host always
+// has much larger buffers than we do, so the only limit on what we transmit
+// is the space left in the uip_buf after the headers. UIP_TX_MSS is the
+// largest TCP datagram this application will transmit in one packet. The
+// MSS the remote host advertises will reduce this if it is smaller.
+//
+// In MQTT builds the top of the uip_buf is the MQTT Partial Buffer and must
+// not be written by transmit data, so MQTT_PBUF_SIZE is subtracted in those
+// builds only. In Browser Only and Code Uploader builds the transmit MSS is
+// MQTT_PBUF_SIZE larger than the receive MSS.
+//
+// UIP_TX_RAM_MSS is the most transmit data that fits in the uip_buf. When
+// HTTPD_TX_WRITE_THROUGH is enabled the httpd writes its transmit data to
+// the ENC28J60 transmit buffer as it is generated, so the transmit MSS is
+// limited by the size of an ENC28J60 transmit slot instead.
+#define UIP_TX_RAM_MSS  (UIP_BUFSIZE - UIP_LLH_LEN - UIP_TCPIP_HLEN - 6 \
+                         - ((BUILD_SUPPORT == MQTT_BUILD) ? MQTT_PBUF_SIZE : 0))
+#define UIP_TX_MSS      ((HTTPD_TX_WRITE_THROUGH == 1) \
+                         ? (ENC28J60_TX_MAXFRAME - UIP_LLH_LEN - UIP_TCPIP_HLEN) \
+                         : UIP_TX_RAM_MSS)
+
+// The smallest transmit MSS that is taken from the remote host's MSS option.
+// The httpd subtracts fixed margins from the MSS when it fills a segment, so
+// a very small advertised MSS would wrap those calculations. 536 bytes is
+// the default MSS every host must accept (RFC 1122), so an advertised MSS
+// below it is raised to 536, or to UIP_TX_MSS if that is smaller.
+#define UIP_TX_MIN_MSS  ((UIP_TX_MSS < 536) ? UIP_TX_MSS : 536)
+
+
 // The starting point of the MQTT Partial Buffer within the uip_buf
 // See explantion in #define UIP_TCP_MSS
-#define MQTT_PBUF_SIZE	60
+// MQTT_PBUF_SIZE is set by RAM_PROFILE.
+#define MQTT_PBUF_SIZE	RAM_PBUF_SIZE
 #define MQTT_PBUF	(UIP_BUFSIZE - MQTT_PBUF_SIZE)
 
 
@@ -200,7 +232,9 @@
 // The size of the ARP table. This option should be set to a larger value if
 // this uIP node will have many connections from the local network.
 //   Comment MN: Experimentation shows each ARP table entry uses 11 bytes.
-#define UIP_ARPTAB_SIZE 4
+//   Two entries are added for the default router and MQTT Server entries
+//   pinned by ARP_PINNED_ENTRIES, leaving 4 for browser clients.
+#define UIP_ARPTAB_SIZE 6
 
 
 // The maxium age of ARP table entries measured in 10ths of seconds. A
@@ -208,6 +242,12 @@
 #define UIP_ARP_MAXAGE 120
 
 
+// The number of ARP timer ticks (10 seconds each) before UIP_ARP_MAXAGE at
+// which ARP_PINNED_ENTRIES starts refreshing a pinned entry. A UIP_ARP_REFRESH
+// of 6 gives the router or MQTT Server one minute to answer.
+#define UIP_ARP_REFRESH 6
+
+
 //---------------------------------------------------------------------------//
 //---------------------------------------------------------------------------//
 //---------------------------------------------------------------------------//
@@ -622,6 +662,197 @@
 #endif
 
 
+// Options common to all BUILD_TYPEs
+// The following are not part of the BUILD_TYPE tables above. They select
+// hardware and performance variations that can be applied to any of the
+// build types. Each is described with the other #defines further below.
+  #define HW_SPI_SUPPORT		0
+  #define RX_DRAIN_BUDGET		4
+  #define ENC28J60_RX_FILTER		1
+  #define ENC28J60_HEADER_PEEK		0
+  #define ENC28J60_ASYNC_TX		0
+  #define ENC28J60_TX_DOUBLE_BUFFER	0
+  #define ENC28J60_DMA_CHECKSUM		0
+  #define HTTPD_ZERO_COPY_POST		1
+  #define HTTPD_TX_WRITE_THROUGH	0
+  #define HTTPD_TX_WINDOW		1
+  #define HTTPD_CHUNKED_TRANSFER	0
+  #define HTTPD_STATUS_RECORD		1
+  #define HTTPD_KEEP_ALIVE		0
+  #define HTTPD_SCRIPT_CACHE		0
+  #define HTTPD_EEPROM_CACHE		1
+  #define I2C_STREAM_READ		1
+  #define I2C_ACK_POLL		1
+  #define FLASH_SKIP_IDENTICAL	1
+  #define FLASH_FAST_PROGRAM	1
+  #define FLASH_PROGRAM_TIMING	0
+  #define TASK_SCHEDULER		0
+  #define PROFILE_SUPPORT	0
+  #define ENC28J60_INT_RECEIVE	0
+  #define LOW_POWER_IDLE		0
+  #define PIN_CAPTURE_SUPPORT	0
+  #define MQTT_BATCH_PUBLISH	1
+  #define MQTT_DISCOVERY_BURST	1
+  #define MQTT_DISCOVERY_FINGERPRINT	1
+  #define MQTT_BULK_STATE	0
+  #define MQTT_QOS1_PINSTATE	0
+  #define MQTT_KEEP_ALIVE	60
+  #define MQTT_PING_DEFER	1
+  #define MQTT_RECONNECT_BACKOFF	1
+  #define MQTT_TOPIC_PREFIX	1
+  #define BME280_ASYNC_MEASURE	1
+  #define DS18B20_INCREMENTAL	1
+  #define DS18B20_SKIP_ROM_CONVERT	1
+  #define DS18B20_TIMED_SLOTS	1
+  #define DS18B20_SAMPLE_INTERVAL	30
+  #define BME280_SAMPLE_INTERVAL	300
+  #define SENSOR_DEADBAND	0
+  #define SENSOR_MAX_AGE	900
+  #define INA226_FAST_READ	1
+  #define GPIO_PORT_BATCH	1
+  #define RUNTIME_CHANGES_DIRTY	1
+  #define EEPROM_BATCH_COMMIT	1
+  #define UIP_POLL_FAST_PATH	1
+  #define ARP_PINNED_ENTRIES	1
+  #define ARP_MISS_QUEUE	0
+  #define UIP_CONN_RESERVE	1
+  #define RAM_PROFILE		0
+  #define STACK_MONITOR		1
+  #define UART_TX_BUFFERED	1
+  #define HTTPD_SCRIPT_GZIP	0
+  #define BENCHMARK_SUPPORT	1
+  #define PAGE_STATISTICS	0
+  #define PIN_TIMER_WHEEL	1
+  #define HW_PULSE_SUPPORT	0
+  #define PROVISION_SUPPORT	0
+  #define UDP_STATUS_SUPPORT	0
+  #define UDP_LOG_SUPPORT	0
+  #define MQTT_PERSISTENT_SESSION	0
+  #define UIP_FAST_RETRANSMIT	0
+  #define HTTPD_COALESCE_HEADER	0
+  #define BOOT_PROFILE		0
+  #define FAST_BOOT		0
+  #define PHY_LINK_MONITOR	0
+  #define I2C_FAST_MODE		0
+  #define HTTPD_LONG_POLL	0
+  #define PERIODIC_ROUND_ROBIN	0
+  #define HTTPD_PAGE_CACHE	0
+  #define MQTT_DIRECT_PUBLISH	0
+  #define SENSOR_STRING_CACHE	0
+  #define BME280_NORMAL_SAMPLING	0
+  #define PCF8574_READ_GATE	0
+  #define COMMAND_RATE_LIMIT	0
+  #define SCRATCH_ARENA		0
+  #define IO_BYTE_LANES		0
+  #define STRING_INDEX_CACHE	0
+  #define LINKED_FAST_PATH	0
+  #define BACKGROUND_UPLOAD	0
+
+
+// RAM budget profiles
+// Each RAM_PROFILE sets the uip_buf size (ENC28J60_MAXFRAME), the number of
+// connections (UIP_CONNS and UIP_LISTENPORTS), the MQTT Partial Buffer size
+// (MQTT_PBUF_SIZE) and the mqtt_sendbuf size (MQTT_SENDBUF_SIZE) together.
+#if RAM_PROFILE == 0
+  // Default: the sizes every build has been verified with
+  #define RAM_MAXFRAME		550
+  #define RAM_CONNS		4
+  #define RAM_PBUF_SIZE		60
+  #define RAM_SENDBUF_SIZE	160
+#endif // RAM_PROFILE == 0
+#if RAM_PROFILE == 1
+  // Browser heavy: a fifth connection paid for with a smaller uip_buf. With
+  // HTTPD_TX_WRITE_THROUGH the uip_buf only limits the receive MSS.
+  #define RAM_MAXFRAME		470
+  #define RAM_CONNS		5
+  #define RAM_PBUF_SIZE		60
+  #define RAM_SENDBUF_SIZE	160
+#endif // RAM_PROFILE == 1
+#if RAM_PROFILE == 2
+  // MQTT heavy: MQTT plus two Browser connections, a larger transmit queue
+  // and a larger Partial Buffer for received messages spanning packets
+  #define RAM_MAXFRAME		550
+  #define RAM_CONNS		3
+  #define RAM_PBUF_SIZE		80
+  #define RAM_SENDBUF_SIZE	240
+#endif // RAM_PROFILE == 2
+#if RAM_PROFILE == 3
+  // Sensor heavy: as MQTT heavy with a smaller transmit queue increase, the
+  // rest is left as stack headroom for the sensor code
+  #define RAM_MAXFRAME		550
+  #define RAM_CONNS		3
+  #define RAM_PBUF_SIZE		60
+  #define RAM_SENDBUF_SIZE	200
+#endif // RAM_PROFILE == 3
+
+// RAM budget check
+// The Default profile leaves the linker enough RAM for the other variables,
+// with the stack overflow guard bytes at 0x5fe intact, and leaves the stack
+// its 512 bytes. A profile may trade the buffers against each other but may
+// not use more RAM in total, so the variable and stack headroom of the
+// Default profile is kept. RAM_CONN_BYTES is an estimate of the RAM each
+// connection costs: the uip_conn with its httpd state, the tx_checkpoint
+// entries and the listen port.
+#define RAM_CONN_BYTES		80
+#define RAM_PROFILE_BYTES(frame, conns, sendbuf) \
+  ((frame) + ((conns) * RAM_CONN_BYTES) + ((BUILD_SUPPORT == MQTT_BUILD) ? (sendbuf) : 0))
+#if RAM_PROFILE_BYTES(RAM_MAXFRAME, RAM_CONNS, RAM_SENDBUF_SIZE) > RAM_PROFILE_BYTES(550, 4, 160)
+  #error "RAM_PROFILE uses more RAM than the Default profile"
+#endif
+#if SCRATCH_ARENA == 1 && OB_EEPROM_SUPPORT == 1 && HTTPD_EEPROM_CACHE == 1 && PROVISION_SUPPORT == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+  // The pre_buf and provision_buf share the scratch arena. The RAM freed
+  // by the provision_buf is added to the uip_buf (see Enc28j60.h).
+  #define SCRATCH_ARENA_SHARED	1
+  #define RAM_SCRATCH_CREDIT	128
+#else
+  #define SCRATCH_ARENA_SHARED	0
+  #define RAM_SCRATCH_CREDIT	0
+#endif
+#if BUILD_SUPPORT == MQTT_BUILD && RAM_MAXFRAME < 550
+  #error "MQTT builds need a 550 byte uip_buf for the Home Assistant config messages"
+#endif
+#if OB_EEPROM_SUPPORT == 1 && RAM_MAXFRAME < 512
+  #error "copy_I2C_EEPROM_to_Flash() needs a uip_buf of at least 512 bytes"
+#endif
+#if BUILD_SUPPORT == MQTT_BUILD && RAM_CONNS < 2
+  #error "MQTT builds need a connection for MQTT and one for the Browser"
+#endif
+#if HTTPD_SCRIPT_GZIP == 1 && HTTPD_SCRIPT_CACHE == 0
+  #error "HTTPD_SCRIPT_GZIP requires HTTPD_SCRIPT_CACHE"
+#endif
+#if UDP_LOG_SUPPORT == 1 && UDP_STATUS_SUPPORT == 0
+  #error "UDP_LOG_SUPPORT requires UDP_STATUS_SUPPORT"
+#endif
+#if BACKGROUND_UPLOAD == 1 && OB_EEPROM_SUPPORT == 0
+  #error "BACKGROUND_UPLOAD requires OB_EEPROM_SUPPORT"
+#endif
+#if BACKGROUND_UPLOAD == 1 && OB_EEPROM_SUPPORT == 1 && (BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD)
+  // A runtime build parses firmware file POSTs itself
+  #define RUNTIME_UPLOAD	1
+#else
+  #define RUNTIME_UPLOAD	0
+#endif
+#if BUILD_SUPPORT == CODE_UPLOADER_BUILD || RUNTIME_UPLOAD == 1
+  // The SREC file parser is compiled in
+  #define SREC_UPLOAD		1
+#else
+  #define SREC_UPLOAD		0
+#endif
+#if RUNTIME_UPLOAD == 1 && LOGIN_SUPPORT == 1
+  #error "BACKGROUND_UPLOAD would accept a firmware file without a Login"
+#endif
+#if UDP_STATUS_SUPPORT == 1 && LOGIN_SUPPORT == 1
+  #error "UDP_STATUS_SUPPORT would accept Output commands without a Login"
+#endif
+#if (PIN_CAPTURE_SUPPORT == 1 && BUILD_SUPPORT == MQTT_BUILD) || (DEBUG_SUPPORT == 15 && UART_TX_BUFFERED == 1)
+  // Interrupts are enabled after startup for the pin capture or UART TX
+  // ISRs. Otherwise the firmware runs with interrupts masked.
+  #define INTERRUPTS_ENABLED	1
+#else
+  #define INTERRUPTS_ENABLED	0
+#endif
+
+
 // APPROXIMATE sizes of various build options
 //  BUILD_SUPPORT == 15		600 to 900 bytes typical
 //  LINK_STATISTICS		456 bytes (82 are the webpage)
@@ -881,6 +1112,1032 @@
   // 0 = No support
   // 1 = Supported
 
+  // STM8S_ADC_SUPPORT
+  // Reserved. Must be 0 in all builds, there is no ADC code. None of the 16
+  // IO pins can be an analog input: the STM8S005C6 ADC1 inputs are AIN0 to
+  // AIN7 on Port B, AIN8 and AIN9 on Port E bits 7 and 6, and AIN12 on Port
+  // F bit 4, and the HW-584 routes none of these to the IO headers (see the
+  // io_map table in Gpio.c). A scan mode sampler would also need its own
+  // trigger timer. TIM1 is the free running 10us time base that
+  // clock_ticks() extends to 32 bits, so its TRGO can not be set to a
+  // configurable sample rate without breaking the timing code.
+  // 0 = No support
+
+  // HW_SPI_SUPPORT
+  // Determines if the ENC28J60 is driven by the STM8S SPI peripheral instead
+  // of the bit bang SPI in spi.c. The SPI peripheral runs at 8MHz and moves a
+  // full frame an order of magnitude faster than the bit bang code. This is
+  // only usable on hardware where the ENC28J60 is wired to the SPI peripheral
+  // pins:
+  //   Port C Bit 5 - Pin 30 - ENC28J60 SCK
+  //   Port C Bit 6 - Pin 33 - ENC28J60 SI
+  //   Port C Bit 7 - Pin 34 - ENC28J60 SO
+  // -CS remains on Port C Bit 1 and -RESET remains on Port E Bit 5. The stock
+  // HW-584 board does not route the ENC28J60 this way, and IO 8 and IO 16
+  // are lost to the SPI interface.
+  // If HW_SPI_SUPPORT is Supported:
+  //   Must Disable DS18B20_SUPPORT
+  // 0 = Bit bang SPI (HW-584 wiring)
+  // 1 = SPI peripheral
+
+  // RX_DRAIN_BUDGET
+  // The maximum number of received frames the main loop will pull from the
+  // ENC28J60 and process before moving on to the timer, MQTT and IO pin
+  // processing in the rest of the loop. The loop stops early when the
+  // ENC28J60 has no more packets waiting. A value of 1 gives the original
+  // one-packet-per-loop behavior. Larger values empty the ENC28J60 receive
+  // buffer faster during bursts (such as Home Assistant sending many
+  // PUBLISH messages) at the cost of delaying the rest of the main loop by
+  // up to that many frames.
+  // 1 to 255 = Frames processed per pass of the main loop
+
+  // ENC28J60_RX_FILTER
+  // Determines how the ENC28J60 receive filters are programmed. When enabled
+  // the ENC28J60 accepts only unicast frames addressed to our MAC and ARP
+  // broadcasts asking for our IP address (using the Pattern Match filter).
+  // All other broadcast and multicast traffic is discarded in the ENC28J60
+  // before it is read over SPI. This greatly reduces the SPI and main loop
+  // time wasted on busy network segments.
+  // 0 = Accept unicast for our MAC plus all broadcasts (original filter)
+  // 1 = Accept unicast for our MAC plus ARP broadcasts for our IP only
+
+  // ENC28J60_HEADER_PEEK
+  // Determines if Enc28j60Receive() reads the Ethernet, IP and TCP port
+  // headers of a frame first and discards uninteresting frames without
+  // reading the rest of the frame over SPI. Discarded frames are frames of
+  // other protocols, IP not addressed to us, and TCP to ports that are not
+  // listened on and not in use by an open connection. UDP is discarded
+  // unless it is to the HTTP Port number with UDP_STATUS_SUPPORT. These
+  // frames are dropped before uip sees them, so no TCP RST is sent for
+  // closed ports and they are not counted in the Network Statistics.
+  // 0 = Always read the full frame
+  // 1 = Read headers first and discard uninteresting frames in the ENC28J60
+
+  // ENC28J60_ASYNC_TX
+  // Determines if Enc28j60Send() waits for the ENC28J60 to finish sending a
+  // frame. When enabled Enc28j60Send() returns as soon as the transmission
+  // is started and the main loop keeps running while the frame is on the
+  // wire. Completion and collision error handling is done when the main
+  // loop sees the transmission has finished, or at the latest at the start
+  // of the next Enc28j60Send() (which has to wait only if the previous frame
+  // is still being sent).
+  // 0 = Wait for each transmission to complete
+  // 1 = Return as soon as the transmission is started
+
+  // ENC28J60_TX_DOUBLE_BUFFER
+  // Splits the 2KB ENC28J60 transmit buffer into two slots used alternately.
+  // The next frame is copied over SPI into one slot while the last frame is
+  // still being sent from the other slot, overlapping SPI and wire time for
+  // back to back frames (such as web page segments).
+  // If ENC28J60_TX_DOUBLE_BUFFER is Supported:
+  //   Must Enable ENC28J60_ASYNC_TX
+  // 0 = Single transmit buffer
+  // 1 = Two transmit slots
+
+  // ENC28J60_DMA_CHECKSUM
+  // Determines if the TCP checksum of outgoing segments is calculated in
+  // software by uip or by the ENC28J60 DMA checksum engine. When enabled uip
+  // only sums the pseudo header and Enc28j60Send() has the ENC28J60 sum the
+  // TCP header and data after the frame is copied to the transmit buffer.
+  // Incoming segments are still checked in software as they are already in
+  // the uip_buf by the time they are checked.
+  // 0 = Software TCP checksum
+  // 1 = ENC28J60 DMA TCP checksum for outgoing segments
+
+  // HTTPD_ZERO_COPY_POST
+  // Determines how POST data the user entered in the GUI is handed to the
+  // POST parser. When enabled complete POST components are parsed in place
+  // in the uip_buf and a POST component split across packets is completed
+  // in the parse_tail. This removes the 300 byte local_buf from the stack.
+  // 0 = POST data is copied to a 300 byte local_buf before parsing
+  // 1 = POST data is parsed in place in the uip_buf
+
+  // HTTPD_TX_WRITE_THROUGH
+  // Determines where the httpd builds the web page data it transmits. When
+  // enabled CopyHttpData() stages the data in the uip_buf and writes it to
+  // the ENC28J60 transmit buffer as the staging area fills, and
+  // Enc28j60Send() then only copies the headers. Web page segments can then
+  // be as large as an ENC28J60 transmit slot (see UIP_TX_MSS) instead of
+  // being limited by the uip_buf.
+  // If HTTPD_TX_WRITE_THROUGH is Supported:
+  //   Must Enable ENC28J60_DMA_CHECKSUM (the TCP data is not in the uip_buf
+  //   for a software checksum)
+  // 0 = Web page data is built in the uip_buf
+  // 1 = Web page data is written through to the ENC28J60 transmit buffer
+
+  // HTTPD_TX_WINDOW
+  // Determines how many web page segments an httpd connection may have sent
+  // but not yet acknowledged. With a value of 1 the next segment is only
+  // sent when the previous one is acknowledged, so each segment costs a
+  // round trip plus the Browser delayed ACK time. With a larger value uip
+  // polls the httpd for the next segment while earlier segments are still
+  // in flight. The httpd does not keep copies of the segments. It keeps a
+  // small checkpoint of its template position for each segment in flight
+  // and regenerates the oldest segment from it if a retransmit is needed.
+  // MQTT connections always have a single segment in flight.
+  // 1 = One segment in flight
+  // 2 to 4 = Number of segments in flight
+
+  // HTTPD_CHUNKED_TRANSFER
+  // Determines how the httpd tells the Browser the length of a web page.
+  // Normally the 200 header contains a Content-Length calculated by
+  // adjust_template_size() before any of the page is sent. When enabled the
+  // header instead specifies chunked transfer encoding and each web page
+  // segment is sent as one chunk, so the size calculation (and the Flash
+  // for the page size table) is not needed. Each segment carries 7 to 12
+  // bytes of chunk framing.
+  // 0 = Content-Length header
+  // 1 = Chunked transfer encoding
+
+  // HTTPD_STATUS_RECORD
+  // Determines if the httpd responds to URL /96 with a fixed layout Status
+  // Record for machine polling. The record contains the IO pin states,
+  // sensor readings, MQTT status and link error statistics, and is sent in
+  // the same TCP segment as the header. Not available in the Code Uploader.
+  // loadgen.py reads the record to report the counter changes over a load
+  // test.
+  // 0 = No Status Record
+  // 1 = Status Record at URL /96
+
+  // HTTPD_KEEP_ALIVE
+  // Determines if the httpd uses HTTP/1.1 persistent connections. When
+  // enabled the connection is left open after the response to a GET so
+  // that a polling client can send its next request without a new TCP
+  // connection. The connection is closed if no request arrives within the
+  // number of seconds given. Responses to a POST, and to a GET that changes
+  // settings or causes a reboot, always close the connection.
+  // 0 = Close the connection after every response
+  // 1 to 255 = Seconds a persistent connection may be idle
+
+  // HTTPD_SCRIPT_CACHE
+  // Determines if the script in the IOControl and Configuration pages is
+  // sent as a separate resource that the Browser can cache. The script is
+  // sent with an ETag based on the code revision, and a request that
+  // includes that ETag is answered with "304 Not Modified". This reduces
+  // each page refresh by one to three KB. Ignored in upgradeable builds
+  // as their webpage templates are stored in I2C EEPROM.
+  // 0 = Script sent inline with every page
+  // 1 = Script sent as a cacheable resource at URL /9c to /9f
+
+  // HTTPD_EEPROM_CACHE
+  // Determines if the buffer that holds webpage template data read from the
+  // I2C EEPROM is kept between transmitted segments. When kept, a segment
+  // that starts inside the data already read does not repeat the I2C read.
+  // The buffer (230 bytes) moves from the stack to static RAM. Applies only
+  // to upgradeable builds.
+  // 0 = Template data read from I2C EEPROM for every segment
+  // 1 = Template data read ahead and kept between segments
+
+  // I2C_STREAM_READ
+  // Determines if the I2C driver uses the stream read functions. These keep
+  // the I2C EEPROM in sequential read mode and read each byte with an
+  // unrolled bit loop instead of the SCL / SDA helper functions. Block
+  // reads into RAM use them, and the I2C EEPROM to Flash copy reads the
+  // whole image with one address phase instead of one per 128 byte block.
+  // 0 = Original byte read functions
+  // 1 = Stream read functions
+
+  // I2C_ACK_POLL
+  // Determines how the code waits for the I2C EEPROM internal write cycle
+  // after a page write. With ACK polling the write Control Byte is re-sent
+  // until the I2C EEPROM ACKs it, so the wait ends as soon as the write cycle
+  // completes instead of after the worst case 5ms. This shortens the stall
+  // of the TCP connection for each page written during an SREC upload.
+  // 0 = Fixed 5ms wait
+  // 1 = ACK polling
+
+  // FLASH_SKIP_IDENTICAL
+  // Determines if copy_I2C_EEPROM_to_Flash() compares each 128 byte block
+  // of the new image with the current Flash content and skips programming
+  // of blocks that are identical. An upgrade between close revisions then
+  // only programs the blocks that changed, which shortens the time the
+  // module is offline and reduces Flash wear. The flash_update segment
+  // blocks are always programmed.
+  // 0 = Every block is programmed
+  // 1 = Identical blocks are skipped
+
+  // FLASH_FAST_PROGRAM
+  // Determines if copy_I2C_EEPROM_to_Flash() uses the STM8 fast block
+  // programming mode for Flash blocks that are already erased (all 0x00).
+  // Fast block programming skips the erase part of the program cycle, so an
+  // erased block is written in about half the time of a standard block
+  // program. Blocks that are not erased always use standard block
+  // programming (erase then program).
+  // 0 = Standard block programming for every block
+  // 1 = Fast block programming for erased blocks
+
+  // FLASH_PROGRAM_TIMING
+  // Determines if copy_I2C_EEPROM_to_Flash() measures the time taken to
+  // program the main program area of the Flash. The elapsed TIM2 count
+  // (about 1ms per count) and the number of blocks programmed are stored in
+  // I2C EEPROM Region 1 before the reboot, and are reported on the UART at
+  // the next boot if DEBUG_SUPPORT is 15.
+  // 0 = No timing
+  // 1 = Timing stored in I2C EEPROM
+
+  // TASK_SCHEDULER
+  // Determines how the main loop runs its timed functions (periodic_service,
+  // the MQTT timer, the 100ms timer, ARP aging, sensor reads, login timers
+  // and runtime change checks). With the scheduler the functions are tasks
+  // in task_table[] in main.c, kept in a list sorted by deadline. Each pass
+  // of the main loop only looks at the first task in the list and runs it
+  // if it is due, so at most one task runs between packet receive passes.
+  // The longest run time of each task is kept in sched_run_max[].
+  // 0 = Timer checks and function calls on every main loop pass
+  // 1 = Task scheduler
+
+  // PROFILE_SUPPORT
+  // Determines if the run time of the main loop stages (packet receive,
+  // uip_input, HttpDCall, publish_outbound, get_temperature and
+  // check_runtime_changes) is measured with TIM1. The call count and the
+  // minimum, average and maximum run time (10us units) of each stage are
+  // shown on the Link Error Statistics page (requires LINK_STATISTICS) and
+  // published on the <devicename>/profile/<n> MQTT topics once a minute.
+  // Uses about 72 bytes of RAM so it is off by default.
+  // There is deliberately no host (PC) build of uip.c, uip_arp.c, httpd.c,
+  // mqtt.c and mqtt_pal.c against a TAP or pcap backed Enc28j60Receive() /
+  // Enc28j60Send(). These modules use few STM8 registers directly (IWDG_KR
+  // for the watchdog, and FLASH_CR2 / FLASH_NCR2 in httpd.c), but they are
+  // not self contained. They use dozens of functions and variables from the
+  // rest of the firmware: the I2C EEPROM driver that holds the webpage
+  // templates of upgradeable builds, the Flash and EEPROM unlock and write
+  // code, the @eeprom settings in Main.c, the IO pin and sensor state and
+  // the timers. Each would need a host fake that acts like the hardware
+  // before a host measurement meant anything. The tree also has no build
+  // system other than the Cosmic project files, and cycle counts from a
+  // host CPU would not predict STM8 timing. PROFILE_SUPPORT measures the
+  // real code on the real part instead.
+  // 0 = No profiling
+  // 1 = Profiling
+
+  // ENC28J60_INT_RECEIVE
+  // Determines how Enc28j60Receive() checks for a received frame. The
+  // ENC28J60 -INT output is wired to PC5. With this option the ENC28J60 is
+  // set to drive -INT low while a frame is waiting (PKTIF) or a receive
+  // buffer overflow occurred (RXERIF), and Enc28j60Receive() reads the pin
+  // before doing any SPI transactions. With no frame waiting the receive
+  // check costs no SPI traffic. Because of the ENC28J60 errata on PKTIF the
+  // EIR and EPKTCNT registers are still read over SPI once every 256 idle
+  // calls. Cannot be used with HW_SPI_SUPPORT as PC5 is then the SPI clock.
+  // 0 = EIR and EPKTCNT read over SPI on every call
+  // 1 = -INT pin checked first
+
+  // LOW_POWER_IDLE
+  // Determines if the main loop puts the CPU in WAIT mode when no scheduled
+  // task is due and no frame is waiting in the ENC28J60. The CPU is woken
+  // by a 1ms TIM4 interrupt or by the ENC28J60 -INT pin, so timing and
+  // receive latency are not affected. Reduces supply current when the
+  // network is quiet. Builds with PIN_CAPTURE_SUPPORT or a buffered UART
+  // debug output (see INTERRUPTS_ENABLED) also wake on those interrupts.
+  // Requires TASK_SCHEDULER and ENC28J60_INT_RECEIVE.
+  // 0 = Main loop runs continuously
+  // 1 = WAIT mode when idle
+
+  // PIN_CAPTURE_SUPPORT
+  // Determines if edges on the Input pins are captured by the Port A, C, D
+  // and E external interrupts (MQTT builds only). read_input_pins() samples
+  // the pins once per main loop pass, so a pulse shorter than a pass (for
+  // instance while a webpage is being sent) is missed. With capture the
+  // edge is latched by the ISR and publish_outbound() publishes the pulse
+  // even if the pin is back at its old state: the opposite state is
+  // published first and then the current state. IO 7 and IO 15 are on Port
+  // G, which has no external interrupt, and are not captured.
+  // Interrupts are enabled globally for the ISRs, so they are masked around
+  // the DS18B20 timing and the Flash programming.
+  // 0 = Input pins polled only
+  // 1 = Input pin edges captured
+
+  // MQTT_BATCH_PUBLISH
+  // Determines how many pin state PUBLISH messages publish_outbound() can
+  // queue per call (MQTT builds only). Without batching one pin is
+  // published per call, so a change on all 16 pins takes 16 calls to
+  // report. With batching the PUBLISH packets for as many changed pins as
+  // fit in the mqtt_sendbuf are packed into a single queued message and go
+  // out in one TCP segment. The scan resumes at the first pin that did not
+  // fit, so frequently changing high pins cannot starve the low pins.
+  // 0 = One pin state PUBLISH per call
+  // 1 = Batched pin state PUBLISH
+
+  // MQTT_DISCOVERY_BURST
+  // Determines how Home Assistant Auto Discovery messages are paced during
+  // MQTT startup. Without burst mode one message is queued every 150ms and
+  // each expanded Auto Discovery payload is sent in its own TCP segment.
+  // With burst mode the next message is queued as soon as its placeholder
+  // fits in the mqtt_sendbuf, and mqtt_pal_sendall() expands a payload
+  // after the messages already in the uip_buf when the segment has room.
+  // A pin's delete and define messages then go out in one segment, paced
+  // only by the Broker's ACKs.
+  // 0 = One Auto Discovery message per 150ms
+  // 1 = Auto Discovery burst mode
+
+  // MQTT_DISCOVERY_FINGERPRINT
+  // Determines if Home Assistant Auto Discovery is skipped when the config
+  // retained on the Broker is already current. A 16 bit fingerprint of the
+  // pin types, sensor IDs, device name, MAC and code revision is published
+  // retained to NetworkModule/devicename/discovery after Auto Discovery
+  // completes. On the next MQTT startup the device subscribes to that topic
+  // and, if the retained fingerprint matches the current config, goes
+  // straight to the availability message. A Broker that lost its retained
+  // messages also lost the fingerprint, so Auto Discovery runs again.
+  // 0 = Auto Discovery on every MQTT startup
+  // 1 = Auto Discovery only when the config changed
+
+  // MQTT_BULK_STATE
+  // Determines how sensor values are published in Home Assistant builds.
+  // Normally each DS18B20 or BME280 value is a separate PUBLISH to its own
+  // topic. With bulk state each new sample is sent as one PUBLISH to
+  // NetworkModule/devicename/bulk carrying all sensor values and the pin
+  // states in a JSON payload, for example
+  //   {"p":1234,"t0":21.5,"t1":-3.1}
+  // Home Assistant sensors are then configured with a value_template such
+  // as {{ value_json.t0 }}. Auto Discovery does not define the sensors in
+  // this mode: a sensor config carrying the value_template does not fit in
+  // the TCP segment with a long devicename.
+  // 0 = One PUBLISH per sensor value
+  // 1 = Bulk state PUBLISH
+
+  // MQTT_QOS1_PINSTATE
+  // Determines the QOS level of the pin state PUBLISH messages (MQTT builds
+  // only). At QOS 0 a pin state lost on the way to the Broker is only
+  // repaired by the next state-req or MQTT restart. At QOS 1 each pin
+  // state PUBLISH is kept in a small pending table by packet id until the
+  // Broker returns its PUBACK. If the PUBACK does not arrive within a few
+  // seconds the current state of that pin alone is published again. The
+  // table holds the packet id, not the message, so the mqtt_sendbuf is
+  // not held up while PUBACKs are outstanding. When the table is full pin
+  // state changes wait until an entry is freed.
+  // 0 = Pin state PUBLISH at QOS 0
+  // 1 = Pin state PUBLISH at QOS 1
+
+  // MQTT_KEEP_ALIVE
+  // The MQTT keep alive time in seconds sent to the Broker in the CONNECT.
+  // The module sends a PINGREQ only when it has sent nothing else for most
+  // of this time, so a module that publishes regularly never pings. A
+  // longer time means fewer PINGREQ packets on an idle module but a slower
+  // detection of a lost Broker connection. Received traffic does not
+  // replace the PINGREQ: the Broker times the keep alive on packets it
+  // receives from the module.
+  // 15 to 65535 = Keep alive time in seconds
+
+  // MQTT_PING_DEFER
+  // Determines how long the module waits after its last transmission
+  // before sending a PINGREQ. The Broker allows one and a half times the
+  // keep alive time before it drops the connection.
+  // 0 = PINGREQ after 3/4 of the keep alive time
+  // 1 = PINGREQ after the full keep alive time
+
+  // MQTT_RECONNECT_BACKOFF
+  // Determines how the module retries a failed or lost MQTT connection. By
+  // default each attempt starts as soon as the previous one times out, so
+  // when a Broker restarts every module retries at the same moments. With
+  // backoff each retry waits a random delay in a window that doubles after
+  // each failed attempt (4 seconds up to about 4 minutes). The window goes
+  // back to the shortest once a connection completes.
+  // 0 = Retry immediately
+  // 1 = Retry with exponential backoff and random jitter
+
+  // MQTT_TOPIC_PREFIX
+  // Determines how the "NetworkModule/<devicename>" start of each MQTT
+  // topic is built. Without the option every PUBLISH and SUBSCRIBE builds
+  // it again from the flash constant and the devicename in EEPROM. With
+  // the option it is built once per MQTT connection into a 34 byte RAM
+  // table and each topic starts with a single copy from it. The topics on
+  // the wire are unchanged.
+  // 0 = Build the topic prefix for every message
+  // 1 = Copy the topic prefix from a RAM table
+
+  // BME280_ASYNC_MEASURE
+  // Determines how the periodic BME280 measurement waits for the sensor.
+  // A forced mode measurement takes 30 to 46ms. The blocking version polls
+  // the status register in a wait loop, stopping all network processing
+  // for that time. The asynchronous version starts the measurement in
+  // task_BME280() and collects the data on a later call once the status
+  // register shows it complete. The measurement at boot is still blocking
+  // so that values are ready for the first IOControl page.
+  // 0 = Blocking measurement
+  // 1 = Measurement started and collected on separate calls
+
+  // DS18B20_INCREMENTAL
+  // Determines how the 30 second DS18B20 temperature read is run. The
+  // blocking version reads and restarts the conversion of every sensor in
+  // one call, holding the main loop for about 20ms per sensor. The
+  // incremental version runs the same 1-Wire sequence as a state machine
+  // that performs one reset pulse or one byte per pass of the main loop,
+  // so packets are processed between the steps. In PIN_CAPTURE builds
+  // interrupts are masked for each bit slot instead of the whole read. The
+  // read at boot is still blocking.
+  // 0 = Blocking temperature read
+  // 1 = Temperature read one step per main loop pass
+
+  // DS18B20_SKIP_ROM_CONVERT
+  // Determines how a new temperature conversion is started after the
+  // sensors are read. Without the option each sensor is addressed with
+  // match_ROM and its 8 byte ROM code before its convert_temp command. With
+  // the option a single skip_ROM convert_temp starts the conversion in all
+  // sensors at once, removing a reset pulse and 10 of the 20 bytes sent per
+  // sensor. Only the 2 temperature bytes of each scratchpad are read in
+  // both cases.
+  // 0 = Convert command per sensor
+  // 1 = One broadcast convert command
+
+  // DS18B20_TIMED_SLOTS
+  // Determines how the 1-Wire reset, read and write slots are timed. The
+  // original code uses nop loops calibrated against the compiler output
+  // and wait_timer() calls whose own overhead adds to each wait. With the
+  // option every edge of a slot is placed on the TIM3 1us counter relative
+  // to the start of the slot, so the timing does not depend on the code
+  // generated. The slots are still generated by the CPU: IO 16 is not
+  // connected to a timer channel, so the timers cannot drive the pin.
+  // 0 = nop loop and wait_timer() slot timing
+  // 1 = TIM3 referenced slot timing
+
+  // DS18B20_SAMPLE_INTERVAL
+  // BME280_SAMPLE_INTERVAL
+  // The time in seconds between temperature reads of the DS18B20 sensors
+  // and between measurements of the BME280 sensor. The originals are 30
+  // seconds and 300 seconds.
+  // 5 to 65535 = Sample interval in seconds
+
+  // SENSOR_DEADBAND
+  // Determines when a new sensor reading is published in MQTT builds.
+  // Without the option every reading is published. With the option the
+  // DS18B20 readings are published only if at least one sensor moved by
+  // DS18B20_DEADBAND or more since the last publish, and the BME280
+  // readings only if the temperature, pressure or humidity moved by its
+  // BME280_DEADBAND_x value (see main.h). All readings of a sensor type are
+  // published together, and are published anyway once SENSOR_MAX_AGE
+  // seconds have passed since they were last published. The readings shown
+  // on the web pages are always the latest.
+  // 0 = Publish every reading
+  // 1 = Publish readings that changed or reached SENSOR_MAX_AGE
+
+  // SENSOR_MAX_AGE
+  // The time in seconds after which a sensor reading is published even if
+  // it did not move outside the SENSOR_DEADBAND.
+  // 60 to 65535 = Maximum publish age in seconds
+
+  // INA226_FAST_READ
+  // Determines how ina226_read_measurements() reads an INA226. The original
+  // code reads the Mfg ID, bus voltage, current and power registers on
+  // every call, with a STOP between each register pointer write and the
+  // register read. With the option the Mfg ID of each INA226 is checked
+  // once at boot, the measurement registers are read only when the
+  // Conversion Ready flag shows a new conversion (otherwise the values read
+  // last are reused), and each register read uses a repeated START after
+  // the pointer write. The INA226 does not auto-increment its register
+  // pointer, so each register is still a separate read. Costs 31 bytes of
+  // RAM.
+  // 0 = Read all registers on every call
+  // 1 = Mfg ID at boot, reads gated on Conversion Ready
+
+  // GPIO_PORT_BATCH
+  // Determines how the 16 STM8 IO pins are written and read. The original
+  // code looks up the PORT:BIT pair of each pin (through
+  // calc_PORT_BIT_index() in PINOUT_OPTION builds) and does a read-modify-
+  // write of the port ODR per pin on every write_output_pins() call, and
+  // reads the port IDR per pin in read_input_pins(). With the option
+  // encode_bit_registers() builds a set mask and a write mask for each port
+  // whenever the pin states are sorted, so write_output_pins() is one ODR
+  // write per port and the outputs on one port change at the same time.
+  // read_input_pins() reads each IDR once and takes all pins from that
+  // sample. Costs 21 bytes of RAM, plus 16 in PINOUT_OPTION builds.
+  // 0 = Per pin ODR and IDR access
+  // 1 = Per port ODR and IDR access
+
+  // RUNTIME_CHANGES_DIRTY
+  // Determines when check_runtime_changes() runs its validation steps (the
+  // Pinout Option, DS18B20, BME280, I2C, UART and Linked pin checks). These
+  // only correct the Pending_ values written by the web page, REST and MQTT
+  // parsers, and the I2C, UART and DS18B20 checks unlock and lock the
+  // EEPROM on every pass. With the option they run only on a pass where
+  // parse_complete or mqtt_parse_complete is set, which the parsers set
+  // when they change a Pending_ value and which is set once at boot. Input
+  // reads, Linked pin edges and Output pin Timers still run on every pass.
+  // 0 = Validate on every pass
+  // 1 = Validate only after a parse
+
+  // EEPROM_BATCH_COMMIT
+  // Determines how check_runtime_changes() saves changed STM8 pin_control
+  // bytes to stored_pin_control[] in EEPROM. The original code unlocks and
+  // programs the EEPROM one byte at a time as each pin is processed. With
+  // the option the pins to be saved are collected in a mask (pin_control[]
+  // is the RAM copy) and written by commit_stored_pin_control() in one
+  // unlock, using 4 byte word programming so that up to four changed bytes
+  // cost a single programming time. Words with no changed byte are not
+  // programmed. Also, in MQTT builds the boot time Rotation Pointer update
+  // in stored_options2 is only written if MQTT is enabled.
+  // 0 = Byte at a time saves
+  // 1 = Batched word saves
+
+  // UIP_POLL_FAST_PATH
+  // Determines how data queued for a connection outside of its own uip
+  // callback is sent. Without the option it waits for periodic_service()
+  // to run uip_periodic() over all UIP_CONNS, and task_mqtt_timer() runs
+  // that full sweep after every publish_outbound() call. With the option
+  // poll_conn_now() polls just the one connection: task_mqtt_timer() polls
+  // the MQTT connection after publish_outbound(), mqtt_startup() messages
+  // are polled out on the pass they are queued, and when a received packet
+  // leaves room in the HTTPD_TX_WINDOW the httpd connection is polled for
+  // its next segment on the same pass. Retransmissions and timeouts are
+  // still handled by periodic_service().
+  // 0 = Send on the periodic_service() sweep
+  // 1 = Poll the connection on the same main loop pass
+
+  // ARP_PINNED_ENTRIES
+  // Determines how ARP table entries are replaced. Without the option a full
+  // table throws away the oldest entry, which on a network with many browser
+  // clients can be the default router or MQTT Server entry, stalling MQTT
+  // traffic until ARP resolves again. With the option the default router and
+  // MQTT Server entries are never evicted, the other entries are replaced in
+  // least recently used order, and the pinned entries are refreshed with a
+  // unicast ARP request UIP_ARP_REFRESH ARP timer ticks before they would
+  // reach UIP_ARP_MAXAGE.
+  // 0 = Evict the oldest entry
+  // 1 = Pin router and MQTT Server entries, LRU for the rest
+
+  // ARP_MISS_QUEUE
+  // Determines what happens to an outgoing IP packet when uip_arp_out() finds
+  // no ARP table entry for it. Without the option the packet in the uip_buf is
+  // over-written with an ARP request and is lost until the uip retransmit
+  // timer sends it again, adding a retransmit timeout to the first response
+  // to a new browser client and after every ARP age out. With the option the
+  // packet is parked in ENC28J60 SRAM taken from the end of the receive
+  // buffer (ENC28J60_PARKSTART) and is sent as soon as the ARP reply arrives.
+  // Only one packet is parked. A newer miss replaces it, and it is discarded
+  // at the next ARP timer tick if no reply came. Packets larger than the 576
+  // byte park area or the uip_buf are dropped as without the option.
+  // 0 = Drop the packet and rely on retransmission
+  // 1 = Park the packet until the ARP reply arrives
+
+  // UIP_CONN_RESERVE
+  // Determines how the UIP_CONNS connection slots are shared between browser
+  // connections and the MQTT connection. A new SYN always takes a CLOSED slot
+  // first and then the oldest TIME_WAIT slot. Without the option a burst of
+  // browser or scraper connections can take every slot while MQTT is
+  // reconnecting, locking MQTT out until the slots time out. With the option
+  // an MQTT build that has MQTT enabled keeps the last reclaimable slot for
+  // the MQTT connection whenever MQTT does not already hold one, and SYNs
+  // refused for lack of a slot are counted in syn_drop_counter, which is
+  // reported in the Status Record and cleared with the Link Error Statistics.
+  // 0 = First come first served
+  // 1 = Reserve a slot for MQTT and count refused SYNs
+
+  // RAM_PROFILE
+  // Selects a set of buffer sizes from the RAM budget profiles that follow
+  // the options above. RAM is otherwise carved up by interacting #defines in
+  // uipopt.h, Enc28j60.h and mqtt.h, and changing one of them alone risks a
+  // stack overflow. Every profile is checked at compile time against the RAM
+  // used by the Default profile. The httpd local_buf sizes are not part of
+  // the profiles as they are set by the POST parsing.
+  // 0 = Default: 550 byte uip_buf, 4 connections, 160 byte mqtt_sendbuf
+  // 1 = Browser heavy: 470 byte uip_buf, 5 connections. Browser Only builds
+  //     without OB_EEPROM_SUPPORT only.
+  // 2 = MQTT heavy: 3 connections, 240 byte mqtt_sendbuf, 80 byte
+  //     MQTT_PBUF_SIZE
+  // 3 = Sensor heavy: 3 connections, 200 byte mqtt_sendbuf, 40 bytes more
+  //     stack headroom
+
+  // STACK_MONITOR
+  // Provides the data needed to tune RAM_PROFILE. At boot the unused stack
+  // (0x600 up to the main() frame) is painted with a fixed pattern, and
+  // the 100ms task scans for the deepest byte that was over-written to
+  // track the most stack used since boot. The largest frame held in the
+  // uip_buf and the most mqtt_sendbuf message data in use are tracked as
+  // well. The three peaks are shown as %e36 on the Link Error
+  // Statistics page and in MQTT builds are published once a minute to the
+  // "stack" topic as "stack uip_buf sendbuf" in bytes.
+  // 0 = No stack or buffer peak monitoring
+  // 1 = Track and report the peaks
+
+  // UART_TX_BUFFERED
+  // Only applies to DEBUG_SUPPORT == 15 builds. When enabled UARTPrintf()
+  // copies the message to a small RAM ring buffer and returns, and the
+  // UART2 TX interrupt moves the characters to the UART one at a time.
+  // When disabled UARTPrintf() busy-waits on the UART for every character,
+  // which at 115200 baud costs about 87us per character in the main loop.
+  // If the ring buffer fills the remainder of the message is discarded and
+  // counted in uart_tx_drop_counter. UARTFlush() sends what is left in
+  // the buffer by polling the UART, so it also works with interrupts
+  // masked, and should be called before any reboot so the last messages
+  // reach the terminal. Interrupts are enabled globally from
+  // InitializeUART() on (see INTERRUPTS_ENABLED).
+  // 0 = Blocking UART output
+  // 1 = Interrupt driven UART output
+
+  // HTTPD_SCRIPT_GZIP
+  // Requires HTTPD_SCRIPT_CACHE and only applies to builds that are not
+  // upgradeable (see HTTPD_SCRIPT_CACHE). The page scripts are
+  // stored in Flash gzip compressed (httpd_script_gz.h, generated from the
+  // templates by mkscriptgz.py) and the /9c to /9f resources are sent with
+  // "Content-Encoding: gzip". This roughly halves both the Flash used by the
+  // scripts and the number of segments needed to send them. The plain text
+  // of the scripts is then not compiled, so a Browser must accept gzip.
+  // The Accept-Encoding header of the request is not checked: every
+  // Browser able to run the page scripts accepts gzip, but a client such
+  // as curl gets the compressed bytes unless it asks for them (curl
+  // --compressed). Run mkscriptgz.py after any change to a page script.
+  // 0 = Page scripts stored and sent as plain text
+  // 1 = Page scripts stored and sent gzip compressed
+
+  // BENCHMARK_SUPPORT
+  // Only applies when DEVELOPMENT_TOOLS is enabled. URL command /d4 runs a
+  // set of timed code paths on the next pass of the main loop, and /d5
+  // returns the results as a fixed layout record (see WEBPAGE_BENCHMARK in
+  // httpd.c). The times are measured with TIM1 and reported in us so that
+  // builds and hardware revisions can be compared. The main loop is held
+  // while the benchmarks run (about 0.5 seconds).
+  // 0 = No benchmarks
+  // 1 = Benchmarks available with /d4 and /d5
+
+  // PAGE_STATISTICS
+  // Determines if the httpd keeps load statistics for the webpages it
+  // serves. The pages are counted in 5 groups (IOControl, Configuration,
+  // page scripts, short form pages and all others). For each group the
+  // number of requests, completed loads, segments, retransmits and bytes
+  // sent are counted, and the time from sending the header to the
+  // acknowledge of the last data (ms) is measured. The statistics are shown
+  // on the Link Error Statistics page (requires LINK_STATISTICS) and
+  // published on the <devicename>/pages/<n> MQTT topics once a minute.
+  // Uses about 100 bytes of RAM so it is off by default.
+  // 0 = No page statistics
+  // 1 = Page statistics
+
+  // PIN_TIMER_WHEEL
+  // Only applies to Browser Only builds. Determines how the Output pin
+  // timers (IO_TIMER) are decremented by the 100ms tick. With the wheel
+  // each running pin_timer is kept in an active pin mask for its
+  // resolution (0.1 second, 1 second, 1 minute or 1 hour), and each mask is
+  // only processed when a tick of its resolution is due. The tick then
+  // costs nothing when no timers run instead of decoding all 16 (or 24)
+  // pin_timers every 100ms. Minute and hour ticks are counted in whole
+  // seconds so a 1 minute unit is exactly 60 seconds.
+  // 0 = All pin_timers checked every 100ms
+  // 1 = Running pin_timers kept in per resolution masks
+
+  // HW_PULSE_SUPPORT
+  // Only applies to Browser Only builds. Determines if the timed pulse of an
+  // Output pin with an IO_TIMER is generated by TIM2 instead of the main
+  // loop. IO1 (PA3), IO4 (PD4) and IO12 (PD3) are the TIM2 channel 3, 1 and
+  // 2 pins. When one of these pins is switched to its active state and its
+  // IO_TIMER is in 0.1s or 1s units and no longer than 60 seconds, the
+  // channel takes over the pin and returns it to the idle state on a TIM2
+  // compare match. The pulse length then has 1ms resolution and does not
+  // jitter with main loop stalls (webpage transmission, DS18B20 reads). The
+  // pin state shown in the GUI follows on the next 100ms pin timer tick.
+  // TIM2 keeps running as the free running 1ms time base, so PWM (which
+  // needs its own timer period) is not supported, and TIM3 is not used as
+  // it is restarted by wait_timer() and the DS18B20 bit timing.
+  // 0 = Pulses timed by the pin_timers
+  // 1 = Pulses on IO1, IO4 and IO12 timed by TIM2
+
+  // PROVISION_SUPPORT
+  // Determines if the Configuration can be set with a single provisioning
+  // POST instead of the Configuration page form. The POST carries a 128
+  // byte configuration blob in 8 records of 16 hex encoded bytes followed
+  // by a CRC:
+  //   x00=<32 hex>&x01=<32 hex>& ... &x07=<32 hex>&x99=<4 hex CRC>&z00=0
+  // Nothing is changed until all 8 records are received and the version
+  // byte and CRC-16 (CCITT, initial value 0xffff) over the blob are valid.
+  // The whole blob is then applied at once, the same as a Save on the
+  // Configuration page. mkprovision.py builds the POST data. The blob
+  // layout is described with provision_apply() in httpd.c. Costs 129 bytes
+  // of RAM.
+  // 0 = Configuration page POST only
+  // 1 = Provisioning POST also accepted
+
+  // UDP_STATUS_SUPPORT
+  // Only applies to Browser Only and MQTT builds. Determines if uip accepts
+  // UDP datagrams for a status and command service on the HTTP Port
+  // number. A monitor sends one request datagram and gets one reply
+  // datagram, so a state query takes a single round trip and does not use
+  // one of the UIP_CONNS. All numbers are most significant byte first.
+  //   Request 'S'
+  //     Status query
+  //   Request 'C' nonce[2] mask[4] states[4] auth[8]
+  //     Set the Outputs with a 1 in mask to the matching bit in states.
+  //     nonce is the nonce from the last reply and auth is the first 8
+  //     bytes of the Chaskey-12 MAC (Mouha et al., 2014) of the first 11
+  //     bytes of the request. The MAC key is the MQTT Password padded to 16
+  //     bytes with zero bytes, and the key and MAC words are little endian.
+  //     The nonce changes after every command, accepted or not, so a
+  //     recorded command can not be replayed. Commands are refused when no
+  //     MQTT Password is set and for 2 seconds after a rejected command.
+  //     The MAC is only as strong as the MQTT Password (up to 10
+  //     characters), so use all 10.
+  //   Reply 'R' result nonce[2] pins[4] DS18B20[5x2] BME280[3x4]
+  //         INA226[3x4] MQTT status[5] Link Error Statistics[10]
+  //         TRANSMIT_counter[4] second_counter[4] syn_drop_counter[1]
+  //     result is 0 for a status query or accepted command, 1 if the nonce
+  //     or auth of a command was wrong, 2 for an unknown request and 3 if
+  //     the command was refused without being checked. The fields are the
+  //     same as the Status Record (see HTTPD_STATUS_RECORD).
+  //     The pin states returned with a command are the states before the
+  //     command is applied.
+  // The UDP checksum of a request is checked if present. Costs 6 bytes of
+  // RAM. Not available with LOGIN_SUPPORT.
+  // 0 = TCP and ICMP only
+  // 1 = UDP status and command service
+
+  // UDP_LOG_SUPPORT
+  // Only applies to Browser Only and MQTT builds and requires
+  // UDP_STATUS_SUPPORT. Determines if diagnostic events are sent as a
+  // syslog datagram to UDP port UDP_LOG_PORT of the host that made the last
+  // UDP status request, so field diagnostics do not need a DEBUG_SUPPORT
+  // build with a UART cable. Events are only queued in RAM (up to
+  // UDP_LOG_EVENTS of them) when they occur and are sent in one datagram
+  // once a second, so logging does not stall the code that reports the
+  // event. The datagram is
+  //   <134>devicename: name=value name=value ...
+  // with 4 digit hex values and these names:
+  //   mqtt   MQTT restart step entered (mqtt_restart_step)
+  //   rxerif ENC28J60 receive buffer overflow (RXERIF count)
+  //   txrts  ENC28J60 transmit timeout (0 = TXRTS stuck before a send,
+  //          1 = send did not complete)
+  //   stack  Stack overflow guardband overwritten
+  //   loop   Longest main loop pass of the last second in ms, if at least
+  //          UDP_LOG_SLOW_LOOP ms
+  //   drop   Events lost because the queue was full
+  // Events are kept until the first UDP status request, then dropped once
+  // the queue is full. Nothing is resent if the datagram is lost. Costs
+  // about 60 bytes of RAM.
+  // 0 = No UDP log
+  // 1 = Diagnostic events sent to the UDP status host
+
+  // MQTT_PERSISTENT_SESSION
+  // Only applies to Home Assistant MQTT builds. Determines if the CONNECT
+  // asks the Broker to keep the session (clean session off) and if the
+  // output/+/set, state-req and state-req24 SUBSCRIBEs are replaced by one
+  // SUBSCRIBE to the device wildcard NetworkModule/devicename/#. If the
+  // CONNACK reports that the Broker still has the session no SUBSCRIBE is
+  // sent at all, so a reconnect after a Broker or network hiccup goes from
+  // the CONNACK straight to publishing the pin states. The client ID is
+  // based on the MAC address so the Broker finds the same session on every
+  // connect. The wildcard also returns this device's own publishes (for
+  // instance output/xx and state), which publish_callback() ignores, so
+  // there is a little more receive traffic. Messages for an old
+  // devicename left in a kept session are ignored as well. The
+  // subscriptions are QOS 0 so the Broker does not queue messages while
+  // the module is disconnected. Costs 1 byte of RAM.
+  // 0 = Clean session with one SUBSCRIBE per topic
+  // 1 = Persistent session with a device wildcard SUBSCRIBE
+
+  // UIP_FAST_RETRANSMIT
+  // Determines if TCP loss recovery is tuned for lossy links. The
+  // retransmission timer of each uip_conn counts 250ms ticks instead of
+  // seconds, so the smoothed RTT estimate (rto) can follow a LAN round trip
+  // and a lost segment is resent after rto instead of after at least
+  // UIP_RTO seconds. rto is never less than 500ms so a peer using delayed
+  // ACKs is not retransmitted to needlessly. With HTTPD_TX_WINDOW above 1
+  // a pure ACK that acknowledges nothing while more than one segment is
+  // outstanding is a duplicate ACK, and the third one causes an immediate
+  // retransmit of the oldest unacknowledged segment. Three duplicate ACKs
+  // need three segments in flight after the lost one, so this part only
+  // has an effect with HTTPD_TX_WINDOW 4. Costs 1 byte of RAM per
+  // UIP_CONNS when HTTPD_TX_WINDOW is above 1.
+  // 0 = Retransmit on the 1 second timer only
+  // 1 = 250ms retransmit timer and duplicate ACK fast retransmit
+
+  // HTTPD_COALESCE_HEADER
+  // Only applies to Browser Only and MQTT builds. Determines if the first
+  // segment of a web page response carries the start of the page after the
+  // HTTP header. Otherwise the header goes out alone in the reply to the
+  // request and the page data follows in a second segment, after the
+  // Browser ACK if HTTPD_TX_WINDOW is 1. The first segment is regenerated
+  // the same way (header and data) if it is retransmitted, using the Header
+  // flag of the transmit checkpoints.
+  // 0 = Header sent in its own segment
+  // 1 = Header and the start of the page sent in one segment
+
+  // BOOT_PROFILE
+  // Determines if the time taken to boot is recorded. The TIM1 ms counter
+  // is read at the end of each boot stage (EEPROM settings applied, relay
+  // and input pins set, main loop entered, sensor discovery done) and the
+  // four values are shown in ms as line 37 of the Link Error Statistics
+  // page if LINK_STATISTICS is enabled. Costs 8 bytes of RAM.
+  // 0 = No boot profile
+  // 1 = Boot stage times recorded
+
+  // FAST_BOOT
+  // Determines if startup is shortened so the relays are set and the web and
+  // MQTT interfaces are reachable sooner after a power up. The startup wait
+  // is cut from 100ms to 20ms and the wait after the ENC28J60 reset from
+  // 10ms to 2ms (the errata asks for at least 1ms). BME280, DS18B20 and
+  // INA226 discovery is moved out of main() and run from the main loop
+  // after FAST_BOOT_DEFER ms, and MQTT startup holds the CONNECT until it is
+  // done so Auto Discovery still sees the sensors. The PCF8574 is probed
+  // before the network as before because it may drive relays.
+  // 0 = All devices initialized before the network is started
+  // 1 = Sensor discovery deferred to the main loop
+
+  // PHY_LINK_MONITOR
+  // Determines if the ENC28J60 PHY link state is watched. The PHY is set to
+  // latch a link change interrupt flag (LINKIF) which is checked every
+  // 100ms. On a link down the MQTT restart steps are started. On a link up a
+  // gratuitous ARP is broadcast and a pending MQTT connection attempt is
+  // started over without waiting for its ARP, TCP or backoff timeouts, so
+  // MQTT recovers within a few seconds of a switch reboot instead of after
+  // the response timeouts. Costs one SPI register read per 100ms.
+  // 0 = Link loss found by the MQTT response timeouts only
+  // 1 = Link changes acted on at once
+
+  // I2C_FAST_MODE
+  // Only applies if I2C_SUPPORT is enabled. Determines the bit timing of the
+  // I2C bus. IO 14 and IO 15 are not the STM8 I2C peripheral pins, so the
+  // bus is always driven by software. With this option the waits between bus
+  // phases are cut from about 5us to about 1.5us (about 250kHz) for the I2C
+  // EEPROM, BME280 and INA226. The PCF8574 only supports 100kHz and keeps
+  // the standard timing. The pull ups on IO 14 and IO 15 must be small
+  // enough (4.7Kohm or less with short wiring) for the faster edges.
+  // 0 = Standard timing for all devices
+  // 1 = Fast timing except for the PCF8574
+
+  // HTTPD_LONG_POLL
+  // Only applies to Browser Only and MQTT builds and requires
+  // HTTPD_STATUS_RECORD. Determines if the httpd responds to URL /95 with a
+  // long poll. The request is held open, and the Status Record (see URL
+  // /96) is sent as soon as an IO pin state or a sensor reading changes, or
+  // when the request has been held for the number of seconds given. A client
+  // watching the module then only receives data when there is something new.
+  // It does not need to reload the IOControl page or poll /96. Each held
+  // request uses one of the UIP_CONNS connections.
+  // 0 = No long poll
+  // 1 to 255 = Seconds a /95 request may be held
+
+  // PERIODIC_ROUND_ROBIN
+  // Determines the order in which periodic_service() sweeps the UIP_CONNS
+  // connections. Each connection can send at most one segment per sweep.
+  // Without this option connection 0 is always served first. With it the
+  // MQTT connection is served first, and the others in turn starting one
+  // connection further along on each sweep. A page download on one
+  // connection then does not always transmit ahead of the other Browsers
+  // or of MQTT publishes.
+  // 0 = Connections served in index order
+  // 1 = MQTT first, then rotating order
+
+  // HTTPD_PAGE_CACHE
+  // Determines whether the segments of a rendered Configuration page are
+  // kept in the ENC28J60 so that the page does not have to be rendered from
+  // its template again. The first load of the page is rendered as usual and
+  // each segment is copied from the transmit buffer to a cache area with the
+  // ENC28J60 DMA. Later loads copy the segments back to the transmit buffer
+  // with the DMA instead of running CopyHttpData(). The cache is emptied
+  // when a POST or GET changes the settings, when the sensors are found
+  // again, and when the MQTT status shown on the page changes. Retransmits
+  // are still rendered from their checkpoints. The cache area is the 3kb
+  // below the ARP_MISS_QUEUE park area, so the receive buffer is reduced to
+  // 2.5kb.
+  // If HTTPD_PAGE_CACHE is Supported:
+  //   Must Enable HTTPD_TX_WRITE_THROUGH (the segments are copied from the
+  //   ENC28J60 transmit buffer)
+  // 0 = Every page load is rendered from the template
+  // 1 = Configuration page segments are cached in the ENC28J60
+
+  // MQTT_DIRECT_PUBLISH
+  // Determines how pin state PUBLISH messages reach the uip_buf. Normally
+  // each one is packed into the mqtt_sendbuf by publish_pinstate() and then
+  // copied to the uip_buf by mqtt_send() when uip polls the MQTT connection.
+  // When enabled publish_pinstate() only queues a 3 byte descriptor (pin,
+  // direction and state), and during the poll mqtt_send() packs the waiting
+  // PUBLISH messages straight into the uip_buf after any queued messages.
+  // This removes the copy and the pin states no longer compete with other
+  // messages for mqtt_sendbuf space, so as many pin states as fit in a TCP
+  // segment go out in each poll. Other messages still use the mqtt_sendbuf.
+  // 0 = Pin state PUBLISH messages are queued in the mqtt_sendbuf
+  // 1 = Pin state PUBLISH messages are packed into the uip_buf at poll time
+
+  // SENSOR_STRING_CACHE
+  // Determines whether the DS18B20 and BME280 value strings are formatted
+  // once when the sensors are read instead of every time a web page or an
+  // MQTT publish uses them. The DS18B20 strings of all 5 sensors in degrees
+  // C and F (70 bytes of RAM) are formatted when a temperature read
+  // completes. The BME280 temperature, pressure and humidity strings (32
+  // bytes of RAM) are formatted when the sensor data is compensated and
+  // when the altitude setting changes.
+  // 0 = Sensor strings are formatted when used
+  // 1 = Sensor strings are formatted when the sensors are read
+
+  // BME280_NORMAL_SAMPLING
+  // Determines how the BME280 is sampled. In forced mode every sample
+  // reads the power mode and rewrites the oversampling and filter settings
+  // (a dozen I2C transactions), starts one measurement and waits for it to
+  // complete. In normal mode the settings
+  // are written once when the sensor is found and the sensor measures
+  // continuously every second with its IIR filter running, so each sample
+  // is just the single 8 byte burst read of the data registers (0xF7 to
+  // 0xFE) compensated with the calibration data read at boot. There is no
+  // wait loop and BME280_ASYNC_MEASURE has no effect. The sensor draws
+  // about 4uA more between measurements.
+  // 0 = Forced mode measurement for each sample
+  // 1 = Normal mode, each sample is one burst read
+
+  // PCF8574_READ_GATE
+  // Determines whether read_input_pins() reads the PCF8574 on every pass.
+  // The I2C read of the expander is the most expensive part of the input
+  // scan that runs about once per millisecond. When enabled the read is
+  // skipped if no PCF8574 was found, or if none of the PCF8574 pins (17 to
+  // 24) is configured as an input or linked input, since only those pins
+  // use the value read.
+  // 0 = PCF8574 read on every pass
+  // 1 = PCF8574 read only when a PCF8574 pin is an input
+
+  // COMMAND_RATE_LIMIT
+  // Determines whether inbound commands are rate limited with a token
+  // bucket per source. Each Browser IP address (the 4 most recently seen)
+  // and the MQTT session has a bucket of COMMAND_RATE_BURST tokens that is
+  // refilled by one token every COMMAND_RATE_REFILL x 100ms (see main.h).
+  // A Browser GET that finds its bucket empty gets the 429 response used
+  // when a GET is already being processed. An MQTT output command that
+  // finds the MQTT bucket empty still updates the requested pin state, but
+  // the state is applied by check_runtime_changes() when the next token is
+  // available, so a burst of commands is coalesced into the latest
+  // requested pin states instead of each being processed.
+  // 0 = No rate limit
+  // 1 = Token bucket rate limit per Browser and for MQTT
+
+  // SCRATCH_ARENA
+  // Determines whether the HTTPD_EEPROM_CACHE pre_buf and the
+  // PROVISION_SUPPORT provision_buf share one RAM scratch arena. Only one
+  // of them owns the arena at a time. Claiming the arena revokes the other
+  // owner: the pre_buf is re-read from the I2C EEPROM by the next
+  // CopyHttpData() call, and a provisioning POST in progress is rejected
+  // at its x99 record as if records were missing. The provision_buf size
+  // (128 bytes) is added to the uip_buf (ENC28J60_MAXFRAME), raising the
+  // MSS. The other large buffers (the POST local_buf, the CopyHttpData()
+  // FoundROM copy and the uncached pre_buf) are already on the stack and
+  // are overlaid by it.
+  // Only has an effect in upgradeable Browser and MQTT builds with both
+  // HTTPD_EEPROM_CACHE and PROVISION_SUPPORT enabled.
+  // 0 = Separate pre_buf and provision_buf
+  // 1 = pre_buf and provision_buf share a scratch arena
+
+  // IO_BYTE_LANES
+  // Determines how the 32 bit IO state words (ON_OFF_word, ON_OFF_word_new1,
+  // ON_OFF_word_new2 and Invert_word) of PCF8574 and Domoticz builds are
+  // handled by read_input_pins() and encode_bit_registers(). With byte
+  // lanes each word is accessed one byte (8 pins) at a time with IO_LANE()
+  // (see main.h), so the pin loops use 8 bit masks instead of 32 bit shifts,
+  // and read_input_pins() skips each byte of pins whose debounced state did
+  // not change. Has no effect in builds with 16 bit IO state words.
+  // 0 = 32 bit operations on the IO state words
+  // 1 = Byte lane operations on the IO state words
+
+  // STRING_INDEX_CACHE
+  // Determines how upgradeable Browser and MQTT builds find the webpage
+  // templates in the I2C EEPROM Strings region. With the cache the webpage
+  // address table and size table are each read with one block read at
+  // boot, and the addresses of the webpages used by the build are kept in
+  // RAM, so a webpage request does not read its address from the I2C
+  // EEPROM. The index is checked at boot: every webpage must lie between
+  // the tables and the PCF8574 variables. If it does not (no Strings file
+  // or one that is not from this build) every webpage request gets a
+  // "Strings Invalid" message instead of a page read from wrong addresses.
+  // 0 = Webpage address read from the I2C EEPROM for each webpage
+  // 1 = Webpage index read once at boot and checked
+
+  // LINKED_FAST_PATH
+  // Determines whether a Linked Output pin is toggled by the PIN_CAPTURE
+  // Port interrupt on an edge of its Linked Input pin instead of waiting
+  // for check_runtime_changes() in the main loop. The Linked pairs of STM8
+  // pins 1 to 8 and 9 to 16 found at boot are kept in a table. The first
+  // edge toggles the Output ODR in the interrupt, further edges are ignored
+  // for LINKED_FAST_DEBOUNCE ms (see main.h) and the Input is checked again
+  // when that time is up. The pin_control and ON_OFF_word states then
+  // follow through check_runtime_changes() as for any other Linked edge.
+  // Port G (IO 7 and IO 15) has no external interrupt and PCF8574 pins
+  // are on the I2C bus, so those Linked pairs keep the main loop path.
+  // Only has an effect in MQTT builds with PIN_CAPTURE_SUPPORT.
+  // 0 = Linked Outputs follow their Inputs from the main loop
+  // 1 = Linked Outputs toggled from the Input pin interrupt
+
+  // BACKGROUND_UPLOAD
+  // Determines whether a runtime build accepts a firmware file without
+  // first loading the Code Uploader. The .sx file is POSTed to /86 with
+  // the CRC of its S3 data bytes, for example with
+  //   curl -H 'Expect:' -F file1=@NetworkModule.sx \
+  //     http://IP/86?$(python3 mkprovision.py --sx-crc NetworkModule.sx)
+  // and parsed into I2C EEPROM Region 0 by the Code Uploader's SREC parser,
+  // one packet at a time, while MQTT, the IO pins and the other Browser
+  // connections keep running. Each SREC checksum and each 64 byte block
+  // written to the I2C EEPROM is checked as in the Code Uploader. The
+  // CRC-16 CCITT of the S3 data bytes in file order is compared with the
+  // 4 hex digits after /86? and the image is only staged if they match. A
+  // POST without them fails with a CRC error.
+  // Nothing is installed until a GET /87, which copies Region 0 to Flash
+  // and reboots. That copy is the only outage. Other POSTs get a 429
+  // response while an upload is in progress. An upload that has received
+  // nothing for 60 seconds is aborted when the next POST arrives.
+  // Notes:
+  // - The Region 0 erase at the start of the file blocks for about 1.5
+  //   seconds.
+  // - Region 0 also holds the image the Code Uploader Restore (/73) loads,
+  //   so an upload replaces it even if it is not installed.
+  // - Strings files write the live webpage region and still need the Code
+  //   Uploader. A Strings file POSTed to /86 fails as Invalid File Type.
+  // - Costs about 70 bytes of RAM and the Flash of the SREC parser.
+  // Requires OB_EEPROM_SUPPORT. Not available with LOGIN_SUPPORT.
+  // 0 = Firmware uploads only through the Code Uploader
+  // 1 = Firmware uploads staged in the background by a runtime build
+
 
 
 //---------------------------------------------------------------------------//
@@ -931,4 +2188,9 @@ typedef struct httpd_state uip_tcp_appstate_t
  * application state information.
  */
 
+// uip_TcpAppHub.h brings in the application structures (httpd.h). It is
+// included after the configuration options above because some structure
+// members only exist when their option is enabled.
+#include "uip_TcpAppHub.h"
+
 #endif /* __UIPOPT_H__ */